@@ -0,0 +1,318 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <cmath>
+
+#include "rtl/Algorithms.h"
+#include "rtl/test/Random.h"
+
+template<typename E, size_t N>
+static void BM_MunkresSolve(benchmark::State &state)
+{
+    auto gen = rtl::test::Random::uniformCallable<E>(0, 100);
+    rtl::Matrix<N, N, E> cost;
+    for (size_t r = 0; r < N; r++)
+        for (size_t c = 0; c < N; c++)
+            cost.setElement(r, c, gen());
+    for (auto _ : state)
+        benchmark::DoNotOptimize(rtl::Munkres<E, N>::solve(cost));
+}
+BENCHMARK_TEMPLATE(BM_MunkresSolve, float, 4);
+BENCHMARK_TEMPLATE(BM_MunkresSolve, double, 4);
+BENCHMARK_TEMPLATE(BM_MunkresSolve, float, 16);
+BENCHMARK_TEMPLATE(BM_MunkresSolve, double, 16);
+BENCHMARK_TEMPLATE(BM_MunkresSolve, float, 32);
+BENCHMARK_TEMPLATE(BM_MunkresSolve, double, 32);
+
+template<typename E>
+static void BM_MunkresDynamicSolve(benchmark::State &state)
+{
+    auto n = (size_t)state.range(0);
+    auto gen = rtl::test::Random::uniformCallable<E>(0, 100);
+    std::vector<E> cost(n * n);
+    for (auto &c : cost)
+        c = gen();
+    rtl::MunkresDynamic<E> munkres;
+    munkres.setWarmStart(state.range(1) != 0);
+    size_t frame = 0;
+    for (auto _ : state)
+    {
+        // Perturb a single row, as if one track moved between frames.
+        for (size_t c = 0; c < n; c++)
+            cost[(frame % n) * n + c] = gen();
+        frame++;
+        benchmark::DoNotOptimize(munkres.solve(cost, n, n));
+    }
+}
+BENCHMARK_TEMPLATE(BM_MunkresDynamicSolve, float)->ArgsProduct({{16, 64, 256}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_MunkresDynamicSolve, double)->ArgsProduct({{16, 64, 256}, {0, 1}});
+
+template<typename E>
+static void BM_MunkresKBestSolve(benchmark::State &state)
+{
+    auto n = (size_t)state.range(0);
+    auto k = (size_t)state.range(1);
+    auto gen = rtl::test::Random::uniformCallable<E>(0, 100);
+    std::vector<E> cost(n * n);
+    for (auto &c : cost)
+        c = gen();
+    rtl::MunkresKBest<E> munkres;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(munkres.solve(cost, n, n, k));
+}
+BENCHMARK_TEMPLATE(BM_MunkresKBestSolve, double)->ArgsProduct({{8, 32}, {10, 100}});
+
+template<typename E, size_t N>
+static void BM_MunkresJonkerVolgenantSolve(benchmark::State &state)
+{
+    auto gen = rtl::test::Random::uniformCallable<E>(0, 100);
+    rtl::Matrix<N, N, E> cost;
+    for (size_t r = 0; r < N; r++)
+        for (size_t c = 0; c < N; c++)
+            cost.setElement(r, c, gen());
+    for (auto _ : state)
+        benchmark::DoNotOptimize(rtl::Munkres<E, N, rtl::MunkresJonkerVolgenant>::solve(cost));
+}
+BENCHMARK_TEMPLATE(BM_MunkresJonkerVolgenantSolve, float, 4);
+BENCHMARK_TEMPLATE(BM_MunkresJonkerVolgenantSolve, double, 4);
+BENCHMARK_TEMPLATE(BM_MunkresJonkerVolgenantSolve, float, 16);
+BENCHMARK_TEMPLATE(BM_MunkresJonkerVolgenantSolve, double, 16);
+BENCHMARK_TEMPLATE(BM_MunkresJonkerVolgenantSolve, float, 32);
+BENCHMARK_TEMPLATE(BM_MunkresJonkerVolgenantSolve, double, 32);
+
+template<typename E, class Executor>
+static void BM_MunkresSparseSolve(benchmark::State &state)
+{
+    // Tracks and detections scattered in a plane of constant density, pairs farther than the gate are ruled out.
+    auto n = (size_t)state.range(0);
+    auto pos_gen = rtl::test::Random::uniformCallable<E>(0, E(10) * std::sqrt(E(n)));
+    std::vector<rtl::VectorND<2, E>> tracks, detections;
+    for (size_t i = 0; i < n; i++)
+    {
+        tracks.push_back(rtl::VectorND<2, E>::random(pos_gen));
+        detections.push_back(rtl::VectorND<2, E>::random(pos_gen));
+    }
+    std::vector<rtl::MunkresEdge<E>> edges;
+    for (size_t r = 0; r < n; r++)
+        for (size_t c = 0; c < n; c++)
+            if (E d = rtl::VectorND<2, E>::distance(tracks[r], detections[c]); d < E(5))
+                edges.emplace_back(r, c, d);
+
+    rtl::MunkresSparse<E, Executor> munkres;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(munkres.solve(edges, n, n));
+    state.counters["components"] = (double)munkres.componentNr();
+}
+BENCHMARK_TEMPLATE(BM_MunkresSparseSolve, float, rtl::SequentialExecutor)->Arg(64)->Arg(300)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_MunkresSparseSolve, double, rtl::SequentialExecutor)->Arg(64)->Arg(300)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_MunkresSparseSolve, double, rtl::ThreadExecutor)->Arg(64)->Arg(300)->Arg(1000);
+
+//! Constant velocity model in 2D shared by all track filters.
+template<typename E, class Filter>
+static void setupConstantVelocity(Filter &f)
+{
+    auto A = rtl::Matrix<4, 4, E>::identity();
+    A.setElement(0, 2, E(0.1));
+    A.setElement(1, 3, E(0.1));
+    auto H = rtl::Matrix<2, 4, E>::zeros();
+    H.setElement(0, 0, 1);
+    H.setElement(1, 1, 1);
+    f.set_transision_matrix(A);
+    f.set_measurement_matrix(H);
+}
+
+template<typename E>
+static void BM_KalmanSingles(benchmark::State &state)
+{
+    auto n = (size_t)state.range(0);
+    auto gen = rtl::test::Random::uniformCallable<E>(-10, 10);
+    std::vector<rtl::Kalman<E, 4, 2, 1>> filters(n, rtl::Kalman<E, 4, 2, 1>(E(0.01), E(0.1)));
+    std::vector<rtl::Matrix<2, 1, E>> z(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        setupConstantVelocity<E>(filters[i]);
+        z[i].setElement(0, 0, gen());
+        z[i].setElement(1, 0, gen());
+    }
+    auto u = rtl::Matrix<1, 1, E>::zeros();
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            filters[i].predict(u);
+            filters[i].correct(z[i]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_KalmanSingles, float)->RangeMultiplier(8)->Range(16, 2048);
+BENCHMARK_TEMPLATE(BM_KalmanSingles, double)->RangeMultiplier(8)->Range(16, 2048);
+
+template<typename E>
+static void BM_KalmanBank(benchmark::State &state)
+{
+    auto n = (size_t)state.range(0);
+    auto gen = rtl::test::Random::uniformCallable<E>(-10, 10);
+    rtl::KalmanBank<E, 4, 2, 1> bank(n, E(0.01), E(0.1));
+    setupConstantVelocity<E>(bank);
+    typename rtl::KalmanBank<E, 4, 2, 1>::MeasurementsType z(n, 2);
+    for (size_t i = 0; i < n; i++)
+    {
+        z(i, 0) = gen();
+        z(i, 1) = gen();
+    }
+    for (auto _ : state)
+    {
+        bank.predict();
+        bank.correct(z);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_KalmanBank, float)->RangeMultiplier(8)->Range(16, 2048);
+BENCHMARK_TEMPLATE(BM_KalmanBank, double)->RangeMultiplier(8)->Range(16, 2048);
+
+template<typename E, bool fused>
+static void BM_KalmanMultiSensor(benchmark::State &state)
+{
+    auto n = (size_t)state.range(0);
+    auto gen = rtl::test::Random::uniformCallable<E>(-10, 10);
+    rtl::Kalman<E, 4, 2, 1> filter(E(0.01), E(0.1));
+    setupConstantVelocity<E>(filter);
+    std::vector<rtl::Matrix<2, 1, E>> z(n);
+    for (auto &m : z)
+    {
+        m.setElement(0, 0, gen());
+        m.setElement(1, 0, gen());
+    }
+    auto u = rtl::Matrix<1, 1, E>::zeros();
+    for (auto _ : state)
+    {
+        filter.predict(u);
+        if constexpr (fused)
+            filter.fuse(z);
+        else
+            for (const auto &m : z)
+                filter.correct(m);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_KalmanMultiSensor, double, false)->Arg(20);
+BENCHMARK_TEMPLATE(BM_KalmanMultiSensor, double, true)->Arg(20);
+
+template<typename E, bool selected>
+static void BM_KalmanPositionFix(benchmark::State &state)
+{
+    auto gen = rtl::test::Random::uniformCallable<E>(-10, 10);
+    rtl::Kalman<E, 15, 3, 1> filter(E(0.01), E(0.1));
+    auto H = rtl::Matrix<3, 15, E>::zeros();
+    for (int i = 0; i < 3; i++)
+        H.setElement(i, i, 1);
+    filter.set_measurement_matrix(H);
+    auto z = rtl::Matrix<3, 1, E>::zeros();
+    for (int i = 0; i < 3; i++)
+        z.setElement(i, 0, gen());
+    for (auto _ : state)
+    {
+        filter.set_covariance_matrix(rtl::Matrix<15, 15, E>::identity());
+        if constexpr (selected)
+            filter.template correct_selected<0, 1, 2>(z);
+        else
+            filter.correct(z);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_TEMPLATE(BM_KalmanPositionFix, double, false);
+BENCHMARK_TEMPLATE(BM_KalmanPositionFix, double, true);
+
+template<class Executor>
+static void BM_ScanMatcherPointToLine2D(benchmark::State &state)
+{
+    // A regular polygon of segments as the reference, the scan samples it in a slightly shifted pose.
+    auto seg_nr = (size_t)state.range(0);
+    auto pt_nr = (size_t)state.range(1);
+    std::vector<rtl::LineSegmentND<2, float>> segments;
+    for (size_t i = 0; i < seg_nr; i++)
+    {
+        float a1 = 2.0f * rtl::C_PIf * (float)i / (float)seg_nr, a2 = 2.0f * rtl::C_PIf * (float)(i + 1) / (float)seg_nr;
+        segments.emplace_back(rtl::VectorND<2, float>(10.0f * std::cos(a1), 10.0f * std::sin(a1)), rtl::VectorND<2, float>(10.0f * std::cos(a2), 10.0f * std::sin(a2)));
+    }
+    auto inv = rtl::RigidTfND<2, float>(0.03f, 0.2f, -0.1f).inverted();
+    std::vector<rtl::VectorND<2, float>> pts;
+    for (size_t i = 0; i < pt_nr; i++)
+    {
+        const auto &s = segments[i % seg_nr];
+        float t = (float)(i / seg_nr + 1) / (float)(pt_nr / seg_nr + 2);
+        pts.push_back(inv(rtl::VectorND<2, float>(s.beg() + (s.end() - s.beg()) * t)));
+    }
+
+    rtl::ScanMatcherPointToLine2D<float, Executor> matcher;
+    matcher.setReference(segments);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(matcher(pts));
+    state.SetItemsProcessed((int64_t)(state.iterations() * pt_nr));
+}
+BENCHMARK_TEMPLATE(BM_ScanMatcherPointToLine2D, rtl::SequentialExecutor)->Args({100, 10000});
+BENCHMARK_TEMPLATE(BM_ScanMatcherPointToLine2D, rtl::ThreadExecutor)->Args({100, 10000});
+
+static void BM_LikelihoodField2D(benchmark::State &state)
+{
+    // Scores a batch of poses by a precomputed likelihood field of a regular polygon of segments.
+    auto beam_nr = (size_t)state.range(0);
+    std::vector<rtl::LineSegmentND<2, float>> segments;
+    for (size_t i = 0; i < 100; i++)
+    {
+        float a1 = 2.0f * rtl::C_PIf * (float)i / 100.0f, a2 = 2.0f * rtl::C_PIf * (float)(i + 1) / 100.0f;
+        segments.emplace_back(rtl::VectorND<2, float>(10.0f * std::cos(a1), 10.0f * std::sin(a1)), rtl::VectorND<2, float>(10.0f * std::cos(a2), 10.0f * std::sin(a2)));
+    }
+    rtl::LikelihoodField2D<float> field(0.05f, 0.2f, 1.0f);
+    field.build(segments);
+
+    std::vector<rtl::VectorND<2, float>> beams;
+    for (size_t i = 0; i < beam_nr; i++)
+    {
+        float a = 2.0f * rtl::C_PIf * (float)i / (float)beam_nr;
+        beams.emplace_back(9.0f * std::cos(a), 9.0f * std::sin(a));
+    }
+    std::vector<rtl::RigidTfND<2, float>> poses;
+    for (size_t i = 0; i < 1000; i++)
+        poses.emplace_back(0.001f * (float)i, 0.5f * std::cos((float)i), 0.5f * std::sin((float)i));
+    std::vector<double> log_weights(poses.size());
+
+    for (auto _ : state)
+    {
+        field.log_likelihood(rtl::Span<const rtl::RigidTfND<2, float>>(poses), [](const rtl::RigidTfND<2, float> &p) { return p; }, beams, log_weights);
+        benchmark::DoNotOptimize(log_weights.data());
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * poses.size() * beam_nr));
+}
+BENCHMARK(BM_LikelihoodField2D)->Arg(90)->Arg(360);
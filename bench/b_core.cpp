@@ -0,0 +1,556 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <benchmark/benchmark.h>
+
+#include "rtl/Core.h"
+#include "rtl/Transformation.h"
+#include "bench_data.h"
+
+template<typename E, int d>
+static void BM_VectorDotProduct(benchmark::State &state)
+{
+    auto pts = rtl::bench::randomPoints<d, E>((size_t)state.range(0));
+    for (auto _ : state)
+    {
+        E sum = 0;
+        for (size_t i = 1; i < pts.size(); i++)
+            sum += pts[i - 1].dot(pts[i]);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_VectorDotProduct, float, 3)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_VectorDotProduct, double, 3)->RangeMultiplier(8)->Range(64, 32768);
+
+template<typename E, int d>
+static void BM_LineSegmentPointDistance(benchmark::State &state)
+{
+    auto pts = rtl::bench::randomPoints<d, E>((size_t)state.range(0));
+    auto gen = rtl::test::Random::uniformCallable<E>(-10, 10);
+    auto ls = rtl::LineSegmentND<d, E>::random(gen);
+    for (auto _ : state)
+    {
+        E sum = 0;
+        for (const auto &p : pts)
+            sum += ls.distanceToPointSquared(p);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_LineSegmentPointDistance, float, 2)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_LineSegmentPointDistance, double, 2)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_LineSegmentPointDistance, float, 3)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_LineSegmentPointDistance, double, 3)->RangeMultiplier(8)->Range(64, 32768);
+
+template<typename E, int d>
+static void BM_VectorRigidTransform(benchmark::State &state)
+{
+    auto pts = rtl::bench::randomPoints<d, E>((size_t)state.range(0));
+    auto gen = rtl::test::Random::uniformCallable<E>(-10, 10);
+    auto tf = rtl::RigidTfND<d, E>::random(gen);
+    std::vector<rtl::VectorND<d, E>> out(pts.size());
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < pts.size(); i++)
+            out[i] = pts[i].transformed(tf);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_VectorRigidTransform, float, 3)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_VectorRigidTransform, double, 3)->RangeMultiplier(8)->Range(64, 32768);
+
+template<typename E, int d>
+static void BM_BoundingBoxAddPoints(benchmark::State &state)
+{
+    auto pts = rtl::bench::randomPoints<d, E>((size_t)state.range(0));
+    for (auto _ : state)
+    {
+        rtl::BoundingBoxND<d, E> bb(pts.front());
+        for (const auto &p : pts)
+            bb.addPoint(p);
+        benchmark::DoNotOptimize(bb);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_BoundingBoxAddPoints, float, 3)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_BoundingBoxAddPoints, double, 3)->RangeMultiplier(8)->Range(64, 32768);
+
+template<typename E, int d>
+static void BM_BoundingBoxFromPoints(benchmark::State &state)
+{
+    auto pts = rtl::bench::randomPoints<d, E>((size_t)state.range(0));
+    for (auto _ : state)
+    {
+        rtl::BoundingBoxND<d, E> bb(pts);
+        benchmark::DoNotOptimize(bb);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_BoundingBoxFromPoints, float, 3)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_BoundingBoxFromPoints, double, 3)->RangeMultiplier(8)->Range(64, 32768);
+
+template<typename E>
+static std::vector<rtl::BoundingBoxND<3, E>> obstacleBoxes(size_t n)
+{
+    auto pts = rtl::bench::randomPoints<3, E>(n);
+    std::vector<rtl::BoundingBoxND<3, E>> boxes;
+    for (const auto &p : pts)
+        boxes.emplace_back(p, p + rtl::VectorND<3, E>(1, 1, 1));
+    return boxes;
+}
+
+template<typename E>
+static void BM_BoundingBoxAllPairs(benchmark::State &state)
+{
+    auto boxes = obstacleBoxes<E>((size_t)state.range(0));
+    for (auto _ : state)
+    {
+        size_t cnt = 0;
+        for (size_t i = 0; i < boxes.size(); i++)
+            for (size_t j = i + 1; j < boxes.size(); j++)
+                cnt += boxes[i].intersects(boxes[j]);
+        benchmark::DoNotOptimize(cnt);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_BoundingBoxAllPairs, float)->RangeMultiplier(4)->Range(64, 4096);
+
+template<typename E>
+static void BM_BoundingVolumeHierarchySelfOverlaps(benchmark::State &state)
+{
+    auto boxes = obstacleBoxes<E>((size_t)state.range(0));
+    rtl::BoundingVolumeHierarchyND<3, E> bvh;
+    for (auto _ : state)
+    {
+        bvh.build(boxes, std::vector<size_t>(boxes.size()));
+        benchmark::DoNotOptimize(bvh.selfOverlaps());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_BoundingVolumeHierarchySelfOverlaps, float)->RangeMultiplier(4)->Range(64, 4096);
+
+template<typename E>
+static void BM_NearestBruteForce(benchmark::State &state)
+{
+    auto pts = rtl::bench::randomPoints<3, E>((size_t)state.range(0));
+    auto queries = rtl::bench::randomPoints<3, E>(256);
+    for (auto _ : state)
+        for (const auto &q : queries)
+        {
+            E best = std::numeric_limits<E>::max();
+            for (const auto &p : pts)
+                best = std::min(best, rtl::VectorND<3, E>::distanceSquared(q, p));
+            benchmark::DoNotOptimize(best);
+        }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK_TEMPLATE(BM_NearestBruteForce, float)->RangeMultiplier(8)->Range(512, 32768);
+
+template<typename E>
+static void BM_KdTreeNearest(benchmark::State &state)
+{
+    auto pts = rtl::bench::randomPoints<3, E>((size_t)state.range(0));
+    auto queries = rtl::bench::randomPoints<3, E>(256);
+    rtl::KdTreeND<3, E> tree(pts);
+    for (auto _ : state)
+        for (const auto &q : queries)
+            benchmark::DoNotOptimize(tree.nearest(q));
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK_TEMPLATE(BM_KdTreeNearest, float)->RangeMultiplier(8)->Range(512, 32768);
+
+template<typename E>
+static void BM_KdTreeBuild(benchmark::State &state)
+{
+    auto pts = rtl::bench::randomPoints<3, E>((size_t)state.range(0));
+    rtl::KdTreeND<3, E> tree;
+    for (auto _ : state)
+    {
+        tree.build(pts);
+        benchmark::DoNotOptimize(tree.treeNr());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_KdTreeBuild, float)->RangeMultiplier(8)->Range(512, 32768);
+
+template<typename E>
+static void BM_BoundingBoxIoUPairs(benchmark::State &state)
+{
+    auto boxes = obstacleBoxes<E>((size_t)state.range(0));
+    std::vector<E> iou(boxes.size() * boxes.size());
+    for (auto _ : state)
+    {
+        for (size_t r = 0; r < boxes.size(); r++)
+            for (size_t c = 0; c < boxes.size(); c++)
+                iou[r * boxes.size() + c] = boxes[r].intersectionOverUnion(boxes[c]);
+        benchmark::DoNotOptimize(iou.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_BoundingBoxIoUPairs, float)->RangeMultiplier(4)->Range(16, 256);
+
+template<typename E>
+static void BM_BoundingBoxIoUMatrix(benchmark::State &state)
+{
+    auto boxes = obstacleBoxes<E>((size_t)state.range(0));
+    rtl::Matrix<Eigen::Dynamic, Eigen::Dynamic, E> iou;
+    for (auto _ : state)
+    {
+        rtl::BoundingBoxND<3, E>::iouMatrix(boxes, boxes, iou);
+        benchmark::DoNotOptimize(iou.data().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_BoundingBoxIoUMatrix, float)->RangeMultiplier(4)->Range(16, 256);
+
+template<typename E>
+static rtl::Frustum3D<E> benchFrustum()
+{
+    using V = rtl::VectorND<3, E>;
+    return rtl::Frustum3D<E>(V(0, 0, 0), V(1, 1, 1), V(1, -1, 1), V(1, 1, -1), V(1, -1, -1), E(9));
+}
+
+template<typename E>
+static void BM_FrustumContains(benchmark::State &state)
+{
+    auto pts = rtl::bench::randomPoints<3, E>((size_t)state.range(0));
+    auto frustum = benchFrustum<E>();
+    std::vector<uint64_t> mask;
+    for (auto _ : state)
+    {
+        frustum.contains(pts, mask);
+        benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_FrustumContains, float)->RangeMultiplier(32)->Range(1024, 1 << 20);
+
+template<typename E>
+static void BM_FrustumContainsPointCloud(benchmark::State &state)
+{
+    rtl::PointCloudND<3, E> pc(rtl::bench::randomPoints<3, E>((size_t)state.range(0)));
+    auto frustum = benchFrustum<E>();
+    std::vector<uint64_t> mask;
+    for (auto _ : state)
+    {
+        frustum.contains(pc, mask);
+        benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_FrustumContainsPointCloud, float)->RangeMultiplier(32)->Range(1024, 1 << 20);
+
+template<typename E>
+static std::vector<rtl::Quaternion<E>> benchRotations(size_t nr)
+{
+    auto pts = rtl::bench::randomPoints<4, E>(nr);
+    std::vector<rtl::Quaternion<E>> ret;
+    for (const auto &p : pts)
+        ret.push_back(rtl::Quaternion<E>(p[0], p[1], p[2], p[3]).normalized());
+    return ret;
+}
+
+template<typename E>
+static void BM_QuaternionSlerp(benchmark::State &state)
+{
+    auto qs1 = benchRotations<E>((size_t)state.range(0)), qs2 = benchRotations<E>((size_t)state.range(0));
+    std::vector<rtl::Quaternion<E>> out(qs1.size());
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < qs1.size(); i++)
+            out[i] = qs1[i].slerp(qs2[i], E(0.3));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_QuaternionSlerp, float)->Range(1024, 1 << 16);
+
+template<typename E, bool fast>
+static void BM_QuaternionArrayInterpolation(benchmark::State &state)
+{
+    rtl::QuaternionArray<E> qa1(benchRotations<E>((size_t)state.range(0))), qa2(benchRotations<E>((size_t)state.range(0))), out;
+    for (auto _ : state)
+    {
+        if (fast)
+            rtl::QuaternionArray<E>::nlerp(qa1, qa2, E(0.3), out);
+        else
+            rtl::QuaternionArray<E>::slerp(qa1, qa2, E(0.3), out);
+        benchmark::DoNotOptimize(out.coeffData(0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_QuaternionArrayInterpolation, float, false)->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_QuaternionArrayInterpolation, float, true)->Range(1024, 1 << 16);
+
+template<typename E>
+static void BM_QuaternionMultiply(benchmark::State &state)
+{
+    auto qs1 = benchRotations<E>((size_t)state.range(0)), qs2 = benchRotations<E>((size_t)state.range(0));
+    std::vector<rtl::Quaternion<E>> out(qs1.size());
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < qs1.size(); i++)
+            out[i] = qs1[i] * qs2[i];
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_QuaternionMultiply, float)->Range(1024, 1 << 16);
+
+template<typename E>
+static void BM_QuaternionArrayMultiply(benchmark::State &state)
+{
+    rtl::QuaternionArray<E> qa1(benchRotations<E>((size_t)state.range(0))), qa2(benchRotations<E>((size_t)state.range(0))), out;
+    for (auto _ : state)
+    {
+        rtl::QuaternionArray<E>::multiply(qa1, qa2, out);
+        benchmark::DoNotOptimize(out.coeffData(0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_QuaternionArrayMultiply, float)->Range(1024, 1 << 16);
+
+template<typename E>
+static void BM_QuaternionArrayRotate(benchmark::State &state)
+{
+    rtl::QuaternionArray<E> qa(benchRotations<E>((size_t)state.range(0)));
+    rtl::PointCloudND<3, E> pc(rtl::bench::randomPoints<3, E>((size_t)state.range(0))), out;
+    for (auto _ : state)
+    {
+        qa.rotate(pc, out);
+        benchmark::DoNotOptimize(out.coordData(0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_QuaternionArrayRotate, float)->Range(1024, 1 << 16);
+
+template<typename E>
+static std::vector<rtl::LineSegmentND<3, E>> benchSegments(size_t n)
+{
+    auto beg = rtl::bench::randomPoints<3, E>(n), off = rtl::bench::randomPoints<3, E>(n);
+    std::vector<rtl::LineSegmentND<3, E>> ret;
+    ret.reserve(n);
+    for (size_t i = 0; i < n; i++)
+        ret.emplace_back(beg[i] * (E)100, beg[i] * (E)100 + off[i]);
+    return ret;
+}
+
+template<typename E>
+static void BM_LineSegmentClosestLoop(benchmark::State &state)
+{
+    auto segments = benchSegments<E>((size_t)state.range(0));
+    auto queries = rtl::bench::randomPoints<3, E>(64);
+    for (auto _ : state)
+        for (auto &q : queries)
+        {
+            E best = std::numeric_limits<E>::max();
+            for (auto &s : segments)
+                best = std::min(best, s.distanceToPoint(q));
+            benchmark::DoNotOptimize(best);
+        }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 64);
+}
+BENCHMARK_TEMPLATE(BM_LineSegmentClosestLoop, float)->Range(1024, 1 << 16);
+
+template<typename E, bool indexed>
+static void BM_LineSegmentArrayClosest(benchmark::State &state)
+{
+    rtl::LineSegmentArrayND<3, E> lsa(benchSegments<E>((size_t)state.range(0)));
+    if (indexed)
+        lsa.buildIndex();
+    auto queries = rtl::bench::randomPoints<3, E>(64);
+    for (auto &q : queries)
+        q *= (E)100;
+    for (auto _ : state)
+    {
+        auto res = indexed ? lsa.closestSegments(queries, (E)5) : lsa.closestSegments(queries);
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 64);
+}
+BENCHMARK_TEMPLATE(BM_LineSegmentArrayClosest, float, false)->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_LineSegmentArrayClosest, float, true)->Range(1024, 1 << 16);
+
+template<typename E>
+static void BM_LineSegmentCropLoop(benchmark::State &state)
+{
+    auto segments = benchSegments<E>((size_t)state.range(0));
+    rtl::VectorND<3, E> c1(-50, -50, -50), c2(50, 50, 50);
+    std::vector<size_t> indices;
+    std::vector<E> beg_t, end_t;
+    for (auto _ : state)
+    {
+        indices.clear();
+        beg_t.clear();
+        end_t.clear();
+        for (size_t i = 0; i < segments.size(); i++)
+        {
+            E b, e;
+            if (segments[i].cropByHyperRect(c1, c2, b, e))
+            {
+                indices.push_back(i);
+                beg_t.push_back(b);
+                end_t.push_back(e);
+            }
+        }
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_LineSegmentCropLoop, float)->RangeMultiplier(32)->Range(1024, 1 << 20);
+
+template<typename E>
+static void BM_LineSegmentArrayCrop(benchmark::State &state)
+{
+    rtl::LineSegmentArrayND<3, E> lsa(benchSegments<E>((size_t)state.range(0)));
+    rtl::VectorND<3, E> c1(-50, -50, -50), c2(50, 50, 50);
+    std::vector<size_t> indices;
+    std::vector<E> beg_t, end_t;
+    for (auto _ : state)
+    {
+        lsa.cropByHyperRect(c1, c2, indices, beg_t, end_t);
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_LineSegmentArrayCrop, float)->RangeMultiplier(32)->Range(1024, 1 << 20);
+
+template<typename E, bool indexed>
+static void BM_Polygon2DContains(benchmark::State &state)
+{
+    rtl::Polygon2D<E> poly;
+    auto radii = rtl::bench::randomPoints<2, E>((size_t)state.range(0));
+    for (size_t i = 0; i < radii.size(); i++)
+    {
+        E a = 2 * rtl::C_PI<E> * (E)i / (E)radii.size();
+        poly.addPoint(rtl::VectorND<2, E>(std::cos(a), std::sin(a)) * (2 + std::abs(radii[i].x())));
+    }
+    if (indexed)
+        poly.buildIndex();
+    auto pts = rtl::bench::randomPoints<2, E>(4096);
+    std::vector<uint64_t> mask;
+    for (auto _ : state)
+    {
+        poly.contains(pts, mask);
+        benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)pts.size());
+}
+BENCHMARK_TEMPLATE(BM_Polygon2DContains, float, false)->RangeMultiplier(8)->Range(16, 4096);
+BENCHMARK_TEMPLATE(BM_Polygon2DContains, float, true)->RangeMultiplier(8)->Range(16, 4096);
+
+template<typename E>
+static std::vector<rtl::LineSegmentND<2, E>> segmentMap(size_t n)
+{
+    // short segments scattered over the map, like vectorized walls of a building
+    auto beg = rtl::bench::randomPoints<2, E>(n);
+    auto dir = rtl::bench::randomPoints<2, E>(n);
+    std::vector<rtl::LineSegmentND<2, E>> segments;
+    for (size_t i = 0; i < n; i++)
+        segments.emplace_back(beg[i] * E(10), beg[i] * E(10) + dir[i] * E(0.2));
+    return segments;
+}
+
+template<typename E, bool grid>
+static void BM_SegmentMapNearest(benchmark::State &state)
+{
+    auto segments = segmentMap<E>((size_t)state.range(0));
+    auto queries = rtl::bench::randomPoints<2, E>(1024);
+    rtl::LineSegmentGrid2D<E> index(segments);
+    for (auto _ : state)
+        for (const auto &q : queries)
+        {
+            if constexpr (grid)
+                benchmark::DoNotOptimize(index.nearest(q * E(10)));
+            else
+            {
+                E best = std::numeric_limits<E>::max();
+                for (const auto &s : segments)
+                    best = std::min(best, s.segmentDistanceToPointSquared(q * E(10)));
+                benchmark::DoNotOptimize(best);
+            }
+        }
+    state.SetItemsProcessed(state.iterations() * (int64_t)queries.size());
+}
+BENCHMARK_TEMPLATE(BM_SegmentMapNearest, float, false)->RangeMultiplier(8)->Range(128, 8192);
+BENCHMARK_TEMPLATE(BM_SegmentMapNearest, float, true)->RangeMultiplier(8)->Range(128, 8192);
+
+template<typename E>
+static void BM_LineSegmentGridBuild(benchmark::State &state)
+{
+    auto segments = segmentMap<E>((size_t)state.range(0));
+    rtl::LineSegmentGrid2D<E> index;
+    for (auto _ : state)
+    {
+        index.build(segments);
+        benchmark::DoNotOptimize(index.cellsX());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_LineSegmentGridBuild, float)->RangeMultiplier(8)->Range(128, 8192);
+
+template<typename E, int d, bool bulk>
+static void BM_RandomVectors(benchmark::State &state)
+{
+    std::vector<rtl::VectorND<d, E>> pts((size_t)state.range(0));
+    auto gen = rtl::test::Random::uniformCallable<E>(-10, 10);
+    for (auto _ : state)
+    {
+        if constexpr (bulk)
+            rtl::test::Random::vectorArray(rtl::Span<rtl::VectorND<d, E>>(pts), E(-10), E(10));
+        else
+            for (auto &p : pts)
+                p = rtl::VectorND<d, E>::random(gen);
+        benchmark::DoNotOptimize(pts.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_RandomVectors, float, 3, false)->RangeMultiplier(8)->Range(512, 32768);
+BENCHMARK_TEMPLATE(BM_RandomVectors, float, 3, true)->RangeMultiplier(8)->Range(512, 32768);
+BENCHMARK_TEMPLATE(BM_RandomVectors, double, 3, false)->RangeMultiplier(8)->Range(512, 32768);
+BENCHMARK_TEMPLATE(BM_RandomVectors, double, 3, true)->RangeMultiplier(8)->Range(512, 32768);
+
+template<typename E, bool bulk>
+static void BM_RandomRigidTf3D(benchmark::State &state)
+{
+    std::vector<rtl::RigidTfND<3, E>> tfs((size_t)state.range(0));
+    auto gen = rtl::test::Random::uniformCallable<E>(-1, 1);
+    for (auto _ : state)
+    {
+        if constexpr (bulk)
+            rtl::test::Random::rigidTfArray(rtl::Span<rtl::RigidTfND<3, E>>(tfs), E(-1), E(1));
+        else
+            for (auto &tf : tfs)
+                tf = rtl::RigidTfND<3, E>::random(gen);
+        benchmark::DoNotOptimize(tfs.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_RandomRigidTf3D, float, false)->RangeMultiplier(8)->Range(512, 32768);
+BENCHMARK_TEMPLATE(BM_RandomRigidTf3D, float, true)->RangeMultiplier(8)->Range(512, 32768);
@@ -0,0 +1,201 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "rtl/Transformation.h"
+#include "bench_data.h"
+
+template<typename E, int d>
+static void BM_RigidTfApply(benchmark::State &state)
+{
+    auto pts = rtl::bench::randomPoints<d, E>((size_t)state.range(0));
+    auto gen = rtl::test::Random::uniformCallable<E>(-1, 1);
+    auto tf = rtl::RigidTfND<d, E>::random(gen);
+    std::vector<rtl::VectorND<d, E>> out(pts.size());
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < pts.size(); i++)
+            out[i] = tf(pts[i]);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_RigidTfApply, float, 2)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_RigidTfApply, double, 2)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_RigidTfApply, float, 3)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_RigidTfApply, double, 3)->RangeMultiplier(8)->Range(64, 32768);
+
+//! Builds a tree of two branches hanging from the root, each \p depth nodes deep, and returns it together with the keys of the two leaves.
+template<typename E, int d, template<typename, typename> class Tree = rtl::TfTree>
+static auto twoBranchTree(size_t depth)
+{
+    auto gen = rtl::test::Random::uniformCallable<E>(-1, 1);
+    Tree<int, rtl::RigidTfND<d, E>> tree(0);
+    int key = 1;
+    std::pair<int, int> leaves;
+    for (int *leaf : {&leaves.first, &leaves.second})
+    {
+        int parent = 0;
+        for (size_t i = 0; i < depth; i++, parent = key++)
+            tree.insert(key, rtl::RigidTfND<d, E>::random(gen), parent);
+        *leaf = parent;
+    }
+    return std::make_pair(tree, leaves);
+}
+
+template<typename E, int d>
+static void BM_TfTreeTf(benchmark::State &state)
+{
+    auto [tree, leaves] = twoBranchTree<E, d>((size_t)state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(tree.tf(leaves.first, leaves.second).squash());
+}
+BENCHMARK_TEMPLATE(BM_TfTreeTf, float, 3)->RangeMultiplier(2)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_TfTreeTf, double, 3)->RangeMultiplier(2)->Range(1, 64);
+
+template<typename E, int d>
+static void BM_TfTreeTfSquashed(benchmark::State &state)
+{
+    auto [tree, leaves] = twoBranchTree<E, d>((size_t)state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(tree.tfSquashed(leaves.first, leaves.second));
+}
+BENCHMARK_TEMPLATE(BM_TfTreeTfSquashed, float, 3)->RangeMultiplier(2)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_TfTreeTfSquashed, double, 3)->RangeMultiplier(2)->Range(1, 64);
+
+//! Chains from one leaf of a deep two-branch tree to every tenth node, in one bulk query or one by one.
+template<typename E, int d, bool bulk>
+static void BM_TfTreeTfMany(benchmark::State &state)
+{
+    auto [tree, leaves] = twoBranchTree<E, d>((size_t)state.range(0));
+    std::vector<int> targets;
+    for (int k = 0; k < (int)tree.size(); k += 10)
+        targets.push_back(k);
+    for (auto _ : state)
+    {
+        if constexpr (bulk)
+            benchmark::DoNotOptimize(tree.tf(leaves.first, targets));
+        else
+            for (auto t : targets)
+                benchmark::DoNotOptimize(tree.tf(leaves.first, t));
+    }
+    state.SetItemsProcessed(state.iterations() * targets.size());
+}
+BENCHMARK_TEMPLATE(BM_TfTreeTfMany, double, 3, false)->Arg(64);
+BENCHMARK_TEMPLATE(BM_TfTreeTfMany, double, 3, true)->Arg(64);
+
+template<typename E, int d>
+static void BM_FlatTfTreeTf(benchmark::State &state)
+{
+    auto [tree, leaves] = twoBranchTree<E, d, rtl::FlatTfTree>((size_t)state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(tree.tf(leaves.first, leaves.second).squash());
+}
+BENCHMARK_TEMPLATE(BM_FlatTfTreeTf, float, 3)->RangeMultiplier(2)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_FlatTfTreeTf, double, 3)->RangeMultiplier(2)->Range(1, 64);
+
+//! Camera -> imu -> base_link like chain of a translation, a rotation and a rigid transformation applied on a single vector.
+template<typename E, int d>
+static void BM_GeneralTfChainApply(benchmark::State &state)
+{
+    auto gen = rtl::test::Random::uniformCallable<E>(-1, 1);
+    using GenTf = rtl::GeneralTf<rtl::RigidTfND<d, E>, rtl::TranslationND<d, E>, rtl::RotationND<d, E>>;
+    rtl::TfChain<GenTf> chain(std::list<GenTf>{rtl::TranslationND<d, E>::random(gen), rtl::RotationND<d, E>::random(gen), rtl::RigidTfND<d, E>::random(gen)});
+    auto v = rtl::VectorND<d, E>::random(gen);
+    for (auto _ : state)
+        benchmark::DoNotOptimize((rtl::VectorND<d, E>)chain(v));
+}
+BENCHMARK_TEMPLATE(BM_GeneralTfChainApply, float, 3);
+BENCHMARK_TEMPLATE(BM_GeneralTfChainApply, double, 3);
+
+//! Four-link mixed chain applied on a whole point array, per object via operator() and in place via applyTo() resolving each GeneralTf once per block.
+template<typename E, int d, bool batch>
+static void BM_GeneralTfChainApplyArray(benchmark::State &state)
+{
+    auto gen = rtl::test::Random::uniformCallable<E>(-1, 1);
+    using GenTf = rtl::GeneralTf<rtl::RigidTfND<d, E>, rtl::TranslationND<d, E>, rtl::RotationND<d, E>>;
+    rtl::TfChain<GenTf> chain(std::list<GenTf>{rtl::TranslationND<d, E>::random(gen), rtl::RotationND<d, E>::random(gen), rtl::RigidTfND<d, E>::random(gen),
+                                               rtl::TranslationND<d, E>::random(gen)});
+    auto pts = rtl::bench::randomPoints<d, E>((size_t)state.range(0));
+    for (auto _ : state)
+    {
+        if constexpr (batch)
+            chain.applyTo(rtl::Span<rtl::VectorND<d, E>>(pts));
+        else
+            for (auto &p : pts)
+                p = (rtl::VectorND<d, E>)chain(p);
+        benchmark::DoNotOptimize(pts.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_GeneralTfChainApplyArray, float, 3, false)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_GeneralTfChainApplyArray, float, 3, true)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_GeneralTfChainApplyArray, double, 3, false)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_GeneralTfChainApplyArray, double, 3, true)->Arg(100000);
+
+template<typename E, typename Trig, bool batch>
+static void BM_Rotation2DFromAngles(benchmark::State &state)
+{
+    std::vector<E> angles((size_t)state.range(0));
+    for (auto &a : angles)
+        a = rtl::test::Random::uniformValue<E>(-10, 10);
+    std::vector<rtl::RotationND<2, E>> rots(angles.size());
+    for (auto _ : state)
+    {
+        if constexpr (batch)
+            rtl::RotationND<2, E>::template fromAngles<Trig>(angles, rots);
+        else
+            for (size_t i = 0; i < angles.size(); i++)
+                rots[i].template setAngle<Trig>(angles[i]);
+        benchmark::DoNotOptimize(rots.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_Rotation2DFromAngles, float, rtl::TrigStd, false)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Rotation2DFromAngles, float, rtl::TrigStd, true)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Rotation2DFromAngles, float, rtl::TrigFast, true)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Rotation2DFromAngles, double, rtl::TrigStd, false)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Rotation2DFromAngles, double, rtl::TrigStd, true)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Rotation2DFromAngles, double, rtl::TrigFast, true)->Arg(4096);
+
+template<typename E, int d>
+static void BM_StaticTfChainApply(benchmark::State &state)
+{
+    auto gen = rtl::test::Random::uniformCallable<E>(-1, 1);
+    rtl::StaticTfChain chain(rtl::TranslationND<d, E>::random(gen), rtl::RotationND<d, E>::random(gen), rtl::RigidTfND<d, E>::random(gen));
+    auto v = rtl::VectorND<d, E>::random(gen);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(chain(v));
+}
+BENCHMARK_TEMPLATE(BM_StaticTfChainApply, float, 3);
+BENCHMARK_TEMPLATE(BM_StaticTfChainApply, double, 3);
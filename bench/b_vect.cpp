@@ -0,0 +1,191 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <benchmark/benchmark.h>
+
+#include "rtl/Vectorization.h"
+#include "rtl/seg/CAR_Segmenter.h"
+#include "rtl/seg/MRA_Segmenter.h"
+#include "bench_data.h"
+
+template<typename Vectorizer, int d>
+static void BM_Vectorizer(benchmark::State &state)
+{
+    typedef typename Vectorizer::ElementType E;
+    auto pts = rtl::bench::noisyPolyline<d, E>((size_t)state.range(0));
+    Vectorizer vec;
+    vec.setSigma(E(0.02));
+    for (auto _ : state)
+    {
+        vec(pts);
+        benchmark::DoNotOptimize(vec.indices().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["segments"] = (double)vec.indices().size();
+}
+BENCHMARK_TEMPLATE(BM_Vectorizer, rtl::VectorizerITLSProjections2D<float, double>, 2)->RangeMultiplier(4)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_Vectorizer, rtl::VectorizerITLSProjections2D<double, double>, 2)->RangeMultiplier(4)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_Vectorizer, rtl::VectorizerFTLSPolyline2D<float, double>, 2)->RangeMultiplier(4)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_Vectorizer, rtl::VectorizerFTLSPolyline2D<double, double>, 2)->RangeMultiplier(4)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_Vectorizer, rtl::VectorizerITLSProjections3D<float, double>, 3)->RangeMultiplier(4)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_Vectorizer, rtl::VectorizerITLSProjections3D<double, double>, 3)->RangeMultiplier(4)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_Vectorizer, rtl::VectorizerFTLSProjections3D<float, double>, 3)->RangeMultiplier(4)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_Vectorizer, rtl::VectorizerFTLSProjections3D<double, double>, 3)->RangeMultiplier(4)->Range(64, 16384);
+
+template<typename PrecArray, int d, bool compensated, size_t blocks = 0>
+static void BM_PrecArrayPrecompute(benchmark::State &state)
+{
+    // Points are generated in single precision and converted, so compact storage types are fed with the same data.
+    std::vector<rtl::VectorND<d, typename PrecArray::ElementType>> pts;
+    for (const auto &p : rtl::bench::noisyPolyline<d, float>((size_t)state.range(0)))
+        pts.push_back(p.template cast<typename PrecArray::ElementType>());
+    PrecArray array;
+    array.setCompensatedSummation(compensated);
+    array.setCenteredBlocks(blocks);
+    for (auto _ : state)
+    {
+        array.precompute(pts);
+        benchmark::DoNotOptimize(array.array.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_PrecArrayPrecompute, rtl::PrecArray2D<float, double>, 2, false)->RangeMultiplier(16)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_PrecArrayPrecompute, rtl::PrecArray2D<float, double>, 2, true)->RangeMultiplier(16)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_PrecArrayPrecompute, rtl::PrecArray3D<float, double>, 3, false)->RangeMultiplier(16)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_PrecArrayPrecompute, rtl::PrecArray3D<float, double>, 3, true)->RangeMultiplier(16)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_PrecArrayPrecompute, rtl::PrecArray2D<float, float>, 2, false, 256)->RangeMultiplier(16)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_PrecArrayPrecompute, rtl::PrecArray3D<float, float>, 3, false, 256)->RangeMultiplier(16)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_PrecArrayPrecompute, rtl::PrecArray2D<rtl::Fixed16<10>, float>, 2, false, 256)->RangeMultiplier(16)->Range(64, 16384);
+BENCHMARK_TEMPLATE(BM_PrecArrayPrecompute, rtl::PrecArray3D<rtl::Fixed16<10>, float>, 3, false, 256)->RangeMultiplier(16)->Range(64, 16384);
+#ifdef RTL_HAS_FLOAT16
+BENCHMARK_TEMPLATE(BM_PrecArrayPrecompute, rtl::PrecArray2D<rtl::Half, float>, 2, false, 256)->RangeMultiplier(16)->Range(64, 16384);
+#endif
+
+template<typename E, class Executor>
+static void BM_DouglasPeucker(benchmark::State &state)
+{
+    auto pts = rtl::bench::noisyPolyline<2, E>((size_t)state.range(0));
+    rtl::VectorizerDouglasPeuckerND<2, E, Executor> dp(E(0.03));
+    std::vector<rtl::LineSegmentND<2, E>> output;
+    for (auto _ : state)
+    {
+        dp(pts, output);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["segments"] = (double)output.size();
+}
+BENCHMARK_TEMPLATE(BM_DouglasPeucker, float, rtl::SequentialExecutor)->RangeMultiplier(16)->Range(4096, 1 << 20);
+BENCHMARK_TEMPLATE(BM_DouglasPeucker, float, rtl::ThreadExecutor)->RangeMultiplier(16)->Range(4096, 1 << 20);
+
+template<typename Approximation>
+static void BM_ApproximationErrorSquared(benchmark::State &state)
+{
+    auto pts = rtl::bench::noisyPolyline<3, typename Approximation::ElementType>(4096);
+    rtl::PrecArray3D<typename Approximation::ElementType, typename Approximation::ComputeType> array;
+    array.precompute(pts);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Approximation::getErrorSquared(array.sums(i, i + 64)));
+        i = (i + 1) % (pts.size() - 64);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ApproximationErrorSquared, rtl::ApproximationTlsLine3D<float, double, rtl::EigenSolverIterative3D>);
+BENCHMARK_TEMPLATE(BM_ApproximationErrorSquared, rtl::ApproximationTlsLine3D<float, double, rtl::EigenSolverDirect3D>);
+BENCHMARK_TEMPLATE(BM_ApproximationErrorSquared, rtl::ApproximationTlsLine3D<float, double, rtl::EigenSolverTrigonometric3D>);
+BENCHMARK_TEMPLATE(BM_ApproximationErrorSquared, rtl::ApproximationTlsPlane3D<float, double, rtl::EigenSolverDirect3D>);
+BENCHMARK_TEMPLATE(BM_ApproximationErrorSquared, rtl::ApproximationTlsPlane3D<float, double, rtl::EigenSolverTrigonometric3D>);
+
+static void BM_QuadtreePlanes(benchmark::State &state)
+{
+    size_t rows = (size_t)state.range(0), cols = rows * 4 / 3;
+    std::mt19937 gen(3);
+    std::normal_distribution<float> noise(0.0f, 0.003f);
+    std::vector<rtl::Vector3f> pts;
+    pts.reserve(rows * cols);
+    for (size_t r = 0; r < rows; r++)
+        for (size_t c = 0; c < cols; c++)
+        {
+            float x = (float)c / (float)cols, y = (float)r / (float)rows;
+            pts.emplace_back(x, y, (x < 0.5f ? 0.2f * x : 0.2f - 0.3f * (x - 0.5f)) + noise(gen));
+        }
+    rtl::VectorizerQuadtreePlanes3D<float, double> vec;
+    vec.setSigma(0.01f);
+    for (auto _ : state)
+    {
+        vec(pts, rows, cols);
+        benchmark::DoNotOptimize(vec.polygons().data());
+    }
+    state.SetItemsProcessed(state.iterations() * rows * cols);
+    state.counters["planes"] = (double)vec.approximations().size();
+}
+BENCHMARK(BM_QuadtreePlanes)->Arg(240)->Arg(480);
+
+template<class Executor>
+static void BM_CarSegmenter(benchmark::State &state)
+{
+    auto pts = rtl::bench::noisyPolyline<2, float>((size_t)state.range(0));
+    rtl::CAR_Segmenter<rtl::Vector2f, Executor> seg(10, 0.05f, 0.5f);
+    for (auto _ : state)
+    {
+        seg.loadData(pts);
+        benchmark::DoNotOptimize(seg.clusteredPoints().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["clusters"] = (double)seg.clusterCount();
+}
+BENCHMARK_TEMPLATE(BM_CarSegmenter, rtl::SequentialExecutor)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_CarSegmenter, rtl::ThreadExecutor)->Arg(1000)->Arg(10000);
+
+template<class Executor>
+static void BM_MraSegmenter(benchmark::State &state)
+{
+    // 64-ring scan of a noisy cylindrical room with a few pillars
+    size_t rings = 64, cols = (size_t)state.range(0);
+    std::mt19937 gen(5);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    std::vector<rtl::Vector3f> pts;
+    pts.reserve(rings * cols);
+    for (size_t r = 0; r < rings; r++)
+        for (size_t c = 0; c < cols; c++)
+        {
+            float a = 2.0f * rtl::C_PIf * (float)c / (float)cols, d = (c * 16 / cols) % 4 == 0 && (c * 64 / cols) % 4 == 0 ? 4.0f : 8.0f;
+            pts.emplace_back((d + noise(gen)) * std::cos(a), (d + noise(gen)) * std::sin(a), 0.05f * (float)r);
+        }
+    rtl::MRA_Segmenter<rtl::Vector3f, Executor> seg(4, 0.05f, 0.5f);
+    for (auto _ : state)
+    {
+        seg.loadData(pts, rings);
+        benchmark::DoNotOptimize(seg.labels().data());
+    }
+    state.SetItemsProcessed(state.iterations() * rings * cols);
+    state.counters["clusters"] = (double)seg.clusterCount();
+}
+BENCHMARK_TEMPLATE(BM_MraSegmenter, rtl::SequentialExecutor)->Arg(1024)->Arg(2048);
+BENCHMARK_TEMPLATE(BM_MraSegmenter, rtl::ThreadExecutor)->Arg(1024)->Arg(2048);
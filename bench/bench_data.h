@@ -0,0 +1,131 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_BENCH_DATA_H
+#define ROBOTICTEMPLATELIBRARY_BENCH_DATA_H
+
+#include <vector>
+#include <random>
+#include <limits>
+
+#include "rtl/Core.h"
+#include "rtl/test/Random.h"
+
+namespace rtl::bench
+{
+    //! Ordered point cloud sampled along a random polyline with uniform noise, resembling a single 2D or 3D laser scan.
+    /*!
+     * @tparam d dimensionality of the points.
+     * @tparam E element type of the points.
+     * @param pts number of points to generate.
+     * @param pts_per_segment number of points sampled from one polyline segment.
+     * @param noise half-width of the uniform noise added to every coordinate.
+     * @return vector of generated points.
+     */
+    template<int d, typename E>
+    std::vector<VectorND<d, E>> noisyPolyline(size_t pts, size_t pts_per_segment = 50, E noise = E(0.01))
+    {
+        auto vertex_gen = test::Random::uniformCallable<E>(-10, 10);
+        auto noise_gen = test::Random::uniformCallable<E>(-noise, noise);
+        std::vector<VectorND<d, E>> ret;
+        ret.reserve(pts);
+        auto beg = VectorND<d, E>::random(vertex_gen), end = VectorND<d, E>::random(vertex_gen);
+        for (size_t i = 0; i < pts; i++)
+        {
+            if (i > 0 && i % pts_per_segment == 0)
+            {
+                beg = end;
+                end = VectorND<d, E>::random(vertex_gen);
+            }
+            E t = E(i % pts_per_segment) / E(pts_per_segment);
+            ret.push_back(beg + (end - beg) * t + VectorND<d, E>::random(noise_gen));
+        }
+        return ret;
+    }
+
+    //! Vector of uniformly distributed random points.
+    /*!
+     * @tparam d dimensionality of the points.
+     * @tparam E element type of the points.
+     * @param pts number of points to generate.
+     * @return vector of generated points.
+     */
+    template<int d, typename E>
+    std::vector<VectorND<d, E>> randomPoints(size_t pts)
+    {
+        std::vector<VectorND<d, E>> ret(pts);
+        test::Random::vectorArray(Span<VectorND<d, E>>(ret), E(-10), E(10));
+        return ret;
+    }
+
+    //! Simulated 360 degree 2D laser scan of a rectangular room with a box and a slanted wall.
+    /*!
+     * The room spans 12 x 8 meters and the sensor is placed off its center, so the scan contains long walls observed at grazing angles, short sides of the box
+     * and occlusion gaps, similar to the scans of indoor mobile robots.
+     * @tparam E element type of the points.
+     * @param beams number of beams evenly spread over the full circle.
+     * @param noise standard deviation of the Gaussian noise added to the measured ranges.
+     * @param seed seed of the noise generator.
+     * @return vector of the measured points ordered by the beam angle.
+     */
+    template<typename E>
+    std::vector<VectorND<2, E>> roomScan(size_t beams, E noise = E(0.01), uint64_t seed = 1)
+    {
+        typedef VectorND<2, E> V;
+        const std::vector<std::pair<V, V>> walls = {
+                {V(-6, -4), V(6, -4)}, {V(6, -4), V(6, 4)}, {V(6, 4), V(-6, 4)}, {V(-6, 4), V(-6, -4)},
+                {V(1, 1), V(2, 1)}, {V(2, 1), V(2, 2)}, {V(2, 2), V(1, 2)}, {V(1, 2), V(1, 1)},
+                {V(-4, -1), V(-2, 2)}};
+        const V origin(E(0.3), E(-0.5));
+        RandomStreams::EngineType engine(seed);
+        std::normal_distribution<E> range_noise(E(0), noise);
+        std::vector<V> ret;
+        ret.reserve(beams);
+        for (size_t b = 0; b < beams; b++)
+        {
+            E angle = C_PI<E> * E(2) * E(b) / E(beams);
+            V dir(std::cos(angle), std::sin(angle));
+            E range = std::numeric_limits<E>::infinity();
+            for (const auto &w : walls)
+            {
+                // origin + r * dir = w.first + t * (w.second - w.first)
+                V edge = w.second - w.first, rel = w.first - origin;
+                E den = dir.x() * edge.y() - dir.y() * edge.x();
+                if (den == E(0))
+                    continue;
+                E r = (rel.x() * edge.y() - rel.y() * edge.x()) / den;
+                E t = (rel.x() * dir.y() - rel.y() * dir.x()) / den;
+                if (r > E(0) && t >= E(0) && t <= E(1))
+                    range = std::min(range, r);
+            }
+            ret.push_back(origin + dir * (range + range_noise(engine)));
+        }
+        return ret;
+    }
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_BENCH_DATA_H
@@ -0,0 +1,280 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+// Accuracy versus throughput evaluation of the 2D vectorizers.
+//
+// Every vectorizer processes every scan of the evaluated corpora for each threshold of the sweep. The synthetic corpora (noisy random polylines and simulated
+// room scans) are always evaluated, binary logs given on the command line are added as recorded corpora, each of their 2D point records forming one scan.
+// The threshold is the permitted standard deviation sigma of the TLS vectorizers, Douglas-Peucker and Reumann-Witkam get epsilon = 3 * sigma as in
+// t_vectorization. Reported are the number of scans the vectorizer failed on, mean number of segments per successfully vectorized scan, RMS distance of their points
+// to the nearest output segment and processed points per second.
+//
+// Usage: h_vectorizers [--repeat N] [--delta D] [--latex FILE] [LOG...]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rtl/Vectorization.h"
+#include "rtl/core/LineSegmentGrid2D.h"
+#include "rtl/io/BinaryLog.h"
+#include "rtl/io/LaTeXTable.h"
+#include "bench_data.h"
+
+typedef rtl::Vector2f VectorType;
+typedef rtl::LineSegment2f SegmentType;
+typedef std::function<bool(rtl::Span<const VectorType>, std::vector<SegmentType> &)> VectorizerCall;
+
+struct Corpus
+{
+    std::string name;
+    std::vector<std::vector<VectorType>> scans;
+};
+
+struct Method
+{
+    std::string name;
+    std::function<VectorizerCall(float sigma)> configure;
+};
+
+struct Result
+{
+    std::string method;
+    float sigma;
+    size_t failed;
+    double segments, rms, pts_per_sec;
+};
+
+// the TLS vectorizers keep the output of the previous call on failure, so it is cleared here
+template<class Vectorizer>
+static bool output(Vectorizer &vec, rtl::Span<const VectorType> pts, std::vector<SegmentType> &out)
+{
+    bool success = vec(pts);
+    if (success)
+        out = vec.lineSegments();
+    else
+        out.clear();
+    return success;
+}
+
+static std::vector<Method> methods(float delta)
+{
+    // the vectorizers live as long as the returned calls, so their buffers are reused across scans and repetitions
+    return {
+            {"ITLS", [](float sigma) {
+                auto vec = std::make_shared<rtl::VectorizerITLSProjections2D<float, double>>();
+                vec->setSigma(sigma);
+                return VectorizerCall([vec](rtl::Span<const VectorType> pts, std::vector<SegmentType> &out) { return output(*vec, pts, out); });
+            }},
+            {"FTLS", [delta](float sigma) {
+                auto vec = std::make_shared<rtl::VectorizerFTLSPolyline2D<float, double>>();
+                vec->setSigma(sigma);
+                vec->setDelta(delta);
+                return VectorizerCall([vec](rtl::Span<const VectorType> pts, std::vector<SegmentType> &out) { return output(*vec, pts, out); });
+            }},
+            {"AFTLS", [delta](float sigma) {
+                auto vec = std::make_shared<rtl::VectorizerAFTLSPolyline2D<float, double>>();
+                vec->setSigma(sigma);
+                vec->setDelta(delta);
+                return VectorizerCall([vec](rtl::Span<const VectorType> pts, std::vector<SegmentType> &out) {
+                    vec->setSimplexShift(1 + pts.size() / 1000);
+                    return output(*vec, pts, out);
+                });
+            }},
+            {"DP", [](float sigma) {
+                auto vec = std::make_shared<rtl::VectorizerDouglasPeucker2f>(3.0f * sigma);
+                return VectorizerCall([vec](rtl::Span<const VectorType> pts, std::vector<SegmentType> &out) { (*vec)(pts, out); return true; });
+            }},
+            {"RW", [](float sigma) {
+                auto vec = std::make_shared<rtl::VectorizerReumannWitkam2f>(3.0f * sigma);
+                return VectorizerCall([vec](rtl::Span<const VectorType> pts, std::vector<SegmentType> &out) { (*vec)(pts, out); return true; });
+            }}};
+}
+
+static Result evaluate(const Corpus &corpus, const Method &method, float sigma, size_t repeat)
+{
+    auto vectorize = method.configure(sigma);
+    std::vector<std::vector<SegmentType>> outputs(corpus.scans.size());
+    std::vector<char> success(corpus.scans.size());
+
+    // the best of the repetitions suppresses the noise of other processes
+    double best = std::numeric_limits<double>::infinity();
+    for (size_t r = 0; r < repeat; r++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t s = 0; s < corpus.scans.size(); s++)
+            success[s] = vectorize(corpus.scans[s], outputs[s]);
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // failed scans count to the throughput, but not to the accuracy
+    Result res{method.name, sigma, 0, 0.0, std::numeric_limits<double>::quiet_NaN(), 0.0};
+    double sum_d2 = 0.0;
+    size_t points = 0, fitted = 0;
+    rtl::LineSegmentGrid2D<float> grid;
+    for (size_t s = 0; s < corpus.scans.size(); s++)
+    {
+        points += corpus.scans[s].size();
+        if (!success[s] || outputs[s].empty())
+        {
+            res.failed++;
+            continue;
+        }
+        res.segments += (double)outputs[s].size();
+        grid.build(outputs[s]);
+        for (const auto &pt : corpus.scans[s])
+        {
+            double d = grid.nearest(pt).second;
+            sum_d2 += d * d;
+        }
+        fitted += corpus.scans[s].size();
+    }
+    if (res.failed < corpus.scans.size())
+    {
+        res.segments /= (double)(corpus.scans.size() - res.failed);
+        res.rms = std::sqrt(sum_d2 / (double)fitted);
+    }
+    res.pts_per_sec = (double)points / best;
+    return res;
+}
+
+static std::vector<Corpus> syntheticCorpora()
+{
+    rtl::test::Random::seed(7);
+    Corpus polylines{"polyline 2k pts, noise 0.01", {}}, rooms{"room scan 1440 beams, noise 0.01", {}};
+    for (size_t i = 0; i < 16; i++)
+    {
+        polylines.scans.push_back(rtl::bench::noisyPolyline<2, float>(2000, 100, 0.01f));
+        rooms.scans.push_back(rtl::bench::roomScan<float>(1440, 0.01f, i + 1));
+    }
+    return {polylines, rooms};
+}
+
+static Corpus recordedCorpus(const std::string &file_name)
+{
+    Corpus corpus{file_name, {}};
+    rtl::BinaryLogReader reader(file_name);
+    for (const auto &rec : reader)
+    {
+        if (rec.type() != rtl::BinaryLogRecordType::points || rec.size() < 2)
+            continue;
+        if (rec.holds<2, float>())
+        {
+            auto pts = rec.points<2, float>();
+            corpus.scans.emplace_back(pts.begin(), pts.end());
+        }
+        else if (rec.holds<2, double>())
+        {
+            auto &scan = corpus.scans.emplace_back();
+            for (const auto &pt : rec.points<2, double>())
+                scan.emplace_back((float)pt.x(), (float)pt.y());
+        }
+    }
+    return corpus;
+}
+
+static std::string format(double value, const char *fmt)
+{
+    if (!std::isfinite(value))
+        return "--";
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), fmt, value);
+    return buf;
+}
+
+int main(int argc, char **argv)
+{
+    size_t repeat = 5;
+    float delta = 0.5f;
+    std::string latex_file;
+    std::vector<Corpus> corpora = syntheticCorpora();
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc)
+            repeat = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--delta" && i + 1 < argc)
+            delta = std::strtof(argv[++i], nullptr);
+        else if (arg == "--latex" && i + 1 < argc)
+            latex_file = argv[++i];
+        else
+        {
+            try
+            {
+                corpora.push_back(recordedCorpus(arg));
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << e.what() << std::endl;
+                return 1;
+            }
+            if (corpora.back().scans.empty())
+            {
+                std::cerr << "No 2D point records in '" << arg << "'." << std::endl;
+                corpora.pop_back();
+            }
+        }
+    }
+
+    const std::vector<float> sigmas = {0.005f, 0.01f, 0.02f, 0.05f, 0.1f};
+    std::ofstream latex;
+    if (!latex_file.empty())
+        latex.open(latex_file);
+
+    for (const auto &corpus : corpora)
+    {
+        std::vector<Result> results;
+        for (const auto &method : methods(delta))
+            for (auto sigma : sigmas)
+                results.push_back(evaluate(corpus, method, sigma, repeat));
+
+        std::printf("\n%s (%zu scans)\n", corpus.name.c_str(), corpus.scans.size());
+        std::printf("%-8s %8s %8s %10s %12s %14s\n", "method", "sigma", "failed", "segments", "RMS error", "points/s");
+        rtl::LaTeXTable table;
+        table.setColumnStyle("l|r|r|r|r|r");
+        table.setHeading({"Method", "$\\sigma$", "Failed", "Segments", "RMS error", "Points/s"});
+        table.addHLine();
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const auto &r = results[i];
+            std::printf("%-8s %8.3f %8zu %10.1f %12.5f %14.4g\n", r.method.c_str(), r.sigma, r.failed, r.segments, r.rms, r.pts_per_sec);
+            if (i > 0 && r.method != results[i - 1].method)
+                table.addHLine();
+            table.addRow({r.method, format(r.sigma, "%.3f"), std::to_string(r.failed), format(r.segments, "%.1f"), format(r.rms, "%.5f"), format(r.pts_per_sec, "%.3g")});
+        }
+        if (latex.is_open())
+            table.writeTable(latex, "Vectorizers on " + corpus.name + ", " + std::to_string(corpus.scans.size()) + " scans.");
+    }
+    return 0;
+}
@@ -28,13 +28,28 @@
 #define ROBOTICTEMPLATELIBRARY_ALGORITHMS_H
 
 #include "alg/kalman/Kalman.h"
+#include "alg/kalman/KalmanBank.h"
+#include "alg/kalman/KalmanSmoother.h"
+#include "alg/kalman/UnscentedKalman.h"
 
 #include "alg/munkres/Munkres.h"
+#include "alg/munkres/MunkresDynamic.h"
+#include "alg/munkres/MunkresBatch.h"
+#include "alg/munkres/MunkresKBest.h"
+#include "alg/munkres/MunkresSparse.h"
+#include "alg/munkres/MunkresIoU.h"
 
+#include "alg/particle_filter/Adaptation.h"
+#include "alg/particle_filter/LikelihoodField2D.h"
 #include "alg/particle_filter/ParticleFilter.h"
+#include "alg/particle_filter/Resampling.h"
 #include "alg/particle_filter/SimpleParticle.h"
 
 #include "alg/genetic/GeneticAlgorithm.h"
+#include "alg/genetic/GeneticAlgorithmDynamic.h"
+#include "alg/genetic/GeneticIslands.h"
 #include "alg/genetic/SimpleAgent.h"
 
+#include "alg/scan_matching/ScanMatcherPointToLine2D.h"
+
 #endif //ROBOTICTEMPLATELIBRARY_ALGORITHMS_H
@@ -29,14 +29,31 @@
 
 #include "rtl/core/Utility.h"
 #include "rtl/core/Constants.h"
+#include "rtl/core/Trigonometry.h"
+#include "rtl/core/Executor.h"
+#include "rtl/core/Pipeline.h"
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/RandomStream.h"
+#include "rtl/core/AlignedAllocator.h"
+#include "rtl/core/SmallVector.h"
+#include "rtl/core/CompactElement.h"
+#include "rtl/core/StaticTypes.h"
+#include "rtl/core/Span.h"
 #include "rtl/core/VectorND.h"
+#include "rtl/core/StridedSpan.h"
 #include "rtl/core/LineSegmentND.h"
 #include "rtl/core/Matrix.h"
 #include "rtl/core/BoundingBoxND.h"
+#include "rtl/core/BoundingVolumeHierarchyND.h"
 #include "rtl/core/Frustum3D.h"
+#include "rtl/core/KdTreeND.h"
+#include "rtl/core/LineSegmentArrayND.h"
+#include "rtl/core/LineSegmentGrid2D.h"
 #include "rtl/core/Quaternion.h"
+#include "rtl/core/QuaternionArray.h"
 #include "rtl/core/Polygon2D.h"
 #include "rtl/core/Polygon3D.h"
+#include "rtl/core/PointCloudND.h"
 
 namespace rtl
 {
@@ -67,6 +84,16 @@ namespace rtl
     using LineSegment3f = LineSegment3D<float>;                   //!< Full LineSegmentND specialization for three dimensions and float elements.
     using LineSegment3d = LineSegment3D<double>;                  //!< Full LineSegmentND specialization for three dimensions and double elements.
 
+    template<typename Element>
+    using LineSegmentArray2D = LineSegmentArrayND<2, Element>;    //!< Partial LineSegmentArrayND specialization for two dimensions.
+    using LineSegmentArray2f = LineSegmentArray2D<float>;         //!< Full LineSegmentArrayND specialization for two dimensions and float elements.
+    using LineSegmentArray2d = LineSegmentArray2D<double>;        //!< Full LineSegmentArrayND specialization for two dimensions and double elements.
+
+    template<typename Element>
+    using LineSegmentArray3D = LineSegmentArrayND<3, Element>;    //!< Partial LineSegmentArrayND specialization for three dimensions.
+    using LineSegmentArray3f = LineSegmentArray3D<float>;         //!< Full LineSegmentArrayND specialization for three dimensions and float elements.
+    using LineSegmentArray3d = LineSegmentArray3D<double>;        //!< Full LineSegmentArrayND specialization for three dimensions and double elements.
+
     template<typename Element>
     using BoundingBox2D = BoundingBoxND<2, Element>;              //!< Partial BoundingBoxND specialization for two dimensions.
     using BoundingBox2f = BoundingBoxND<2, float>;                //!< Full BoundingBoxND specialization for two dimensions and float elements.
@@ -77,17 +104,48 @@ namespace rtl
     using BoundingBox3f = BoundingBoxND<3, float>;                //!< Full BoundingBoxND specialization for three dimensions and float elements.
     using BoundingBox3d = BoundingBoxND<3, double>;               //!< Full BoundingBoxND specialization for three dimensions and double elements.
 
+    template<typename Element, typename Payload = size_t>
+    using BoundingVolumeHierarchy2D = BoundingVolumeHierarchyND<2, Element, Payload>;   //!< Partial BoundingVolumeHierarchyND specialization for two dimensions.
+    template<typename Element, typename Payload = size_t>
+    using BoundingVolumeHierarchy3D = BoundingVolumeHierarchyND<3, Element, Payload>;   //!< Partial BoundingVolumeHierarchyND specialization for three dimensions.
+
+    template<typename Element>
+    using KdTree2D = KdTreeND<2, Element>;                        //!< Partial KdTreeND specialization for two dimensions.
+    using KdTree2f = KdTree2D<float>;                             //!< Full KdTreeND specialization for two dimensions and float elements.
+    using KdTree2d = KdTree2D<double>;                            //!< Full KdTreeND specialization for two dimensions and double elements.
+
+    template<typename Element>
+    using KdTree3D = KdTreeND<3, Element>;                        //!< Partial KdTreeND specialization for three dimensions.
+    using KdTree3f = KdTree3D<float>;                             //!< Full KdTreeND specialization for three dimensions and float elements.
+    using KdTree3d = KdTree3D<double>;                            //!< Full KdTreeND specialization for three dimensions and double elements.
+
+    using LineSegmentGrid2f = LineSegmentGrid2D<float>;           //!< Full LineSegmentGrid2D specialization for float elements.
+    using LineSegmentGrid2d = LineSegmentGrid2D<double>;          //!< Full LineSegmentGrid2D specialization for double elements.
+
     using Frustum3f = Frustum3D<float>;                           //!< Full Frustum3D specialization for float elements.
     using Frustum3d = Frustum3D<double>;                          //!< Full Frustum3D specialization for double elements.
 
     using Quaternionf = Quaternion<float>;                        //!< Full Quaternion specialization for float elements.
     using Quaterniond = Quaternion<double>;                       //!< Full Quaternion specialization for double elements.
 
+    using QuaternionArrayf = QuaternionArray<float>;              //!< Full QuaternionArray specialization for float elements.
+    using QuaternionArrayd = QuaternionArray<double>;             //!< Full QuaternionArray specialization for double elements.
+
     using Polygon2Df = Polygon2D<float>;                          //!< Full Polygon2D specialization for two dimensions and float elements.
     using Polygon2Dd = Polygon2D<double>;                         //!< Full Polygon2D specialization for two dimensions and double elements.
 
     using Polygon3Df = Polygon3D<float>;                          //!< Full Polygon3D specialization for three dimensions and float elements.
     using Polygon3Dd = Polygon3D<double>;                         //!< Full Polygon3D specialization for three dimensions and double elements.
+
+    template<typename Element>
+    using PointCloud2D = PointCloudND<2, Element>;                //!< Partial PointCloudND specialization for two dimensions.
+    using PointCloud2f = PointCloud2D<float>;                     //!< Full PointCloudND specialization for two dimensions and float elements.
+    using PointCloud2d = PointCloud2D<double>;                    //!< Full PointCloudND specialization for two dimensions and double elements.
+
+    template<typename Element>
+    using PointCloud3D = PointCloudND<3, Element>;                //!< Partial PointCloudND specialization for three dimensions.
+    using PointCloud3f = PointCloud3D<float>;                     //!< Full PointCloudND specialization for three dimensions and float elements.
+    using PointCloud3d = PointCloud3D<double>;                    //!< Full PointCloudND specialization for three dimensions and double elements.
 }
 
 #endif //ROBOTICTEMPLATELIBRARY_CORE_H
@@ -30,8 +30,13 @@
 #include "rtl/tf/TranslationND.h"
 #include "rtl/tf/RotationND.h"
 #include "rtl/tf/RigidTfND.h"
+#include "rtl/tf/StaticRigidTfND.h"
 #include "rtl/tf/TfTree.h"
+#include "rtl/tf/FlatTfTree.h"
 #include "rtl/tf/TfChain.h"
+#include "rtl/tf/StaticTfChain.h"
+#include "rtl/tf/TfBuffer.h"
+#include "rtl/tf/ConcurrentTfTree.h"
 
 namespace rtl
 {
@@ -64,6 +69,16 @@ namespace rtl
     using RigidTf3D = RigidTfND<3, T>;
     using RigidTf3f = RigidTf3D<float>;
     using RigidTf3d = RigidTf3D<double>;
+
+    template<typename T>
+    using StaticRigidTf2D = StaticRigidTfND<2, T>;
+    using StaticRigidTf2f = StaticRigidTf2D<float>;
+    using StaticRigidTf2d = StaticRigidTf2D<double>;
+
+    template<typename T>
+    using StaticRigidTf3D = StaticRigidTfND<3, T>;
+    using StaticRigidTf3f = StaticRigidTf3D<float>;
+    using StaticRigidTf3d = StaticRigidTf3D<double>;
 }
 
 #endif //ROBOTICTEMPLATELIBRARY_TRANSFORMATION_H
@@ -43,13 +43,18 @@
 #include "rtl/vect/ApproximationTlsPlane3D.h"
 #include "rtl/vect/ExtractorChainFast.h"
 #include "rtl/vect/ExtractorChainIncremental.h"
+#include "rtl/vect/ExtractorPlaneQuadtree.h"
 #include "rtl/vect/OptimizerContinuity2D.h"
 #include "rtl/vect/OptimizerTotalError.h"
+#include "rtl/vect/PostprocessorGridOutline.h"
 #include "rtl/vect/PostprocessorPolyline2D.h"
 #include "rtl/vect/PostprocessorProjectEndpoints.h"
 #include "rtl/vect/PrecArray.h"
+#include "rtl/vect/PrecGrid.h"
 #include "rtl/vect/PrecSums.h"
+#include "rtl/vect/VectorizationStats.h"
 #include "rtl/vect/VectorizerPointElimination.h"
+#include "rtl/vect/VectorizerBatch.h"
 
 namespace rtl
 {
@@ -70,6 +75,38 @@ namespace rtl
         typedef ApproximationTlsLine2D<ElementType, ComputeType> ApproximationType;     //!< Approximation type.
         typedef std::pair<size_t, size_t> IndexType;        //!< Type holding a pair of indices to an array.
 
+        //! Buffers and results of a single vectorization, see operator()(Span<const VectorType>, Workspace &) const.
+        /*!
+         * The workspace holds all data modified by the vectorization, while the vectorizer itself keeps only the settings. A configured vectorizer can therefore be shared
+         * by many threads, each of them processing its inputs in its own workspace, and the buffers of the workspaces are reused by subsequent calls.
+         */
+        class Workspace
+        {
+        public:
+            //! Extracted approximations.
+            [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+
+            //! Extracted line segments.
+            [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return postprocessor.output(); }
+
+            //! Indices defining valid range for approximations() and the output objects.
+            [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+
+            //! Per-stage statistics of the last vectorization call.
+            [[nodiscard]] const VectorizationStats& stats() const { return int_stats; }
+
+        private:
+            friend class VectorizerITLSProjections2D;
+
+            ExtractorChainIncremental<ApproximationType> extractor;
+            PostprocessorProjectEndpoints<ApproximationType> postprocessor;
+
+            std::vector<ApproximationType> int_lines;
+            std::vector<IndexType> int_indices;
+            std::vector<VectorType> packed_pts;
+            VectorizationStats int_stats;
+        };
+
         //! Default constructor.
         VectorizerITLSProjections2D() = default;
 
@@ -81,48 +118,106 @@ namespace rtl
          *
          * @param sigma new standard deviation.
          */
-        void setSigma(ElementType sigma) { extractor.setSigma(sigma); }
+        void setSigma(ElementType sigma) { int_sigma = sigma; }
 
         //! Extracted line approximations.
         /*!
          *
          * @return reference to internal buffer of extracted approximations.
          */
-        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_workspace.approximations(); }
 
         //! Extracted line segments.
         /*!
          *
          * @return reference to internal buffer of extracted line segments.
          */
-        [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return postprocessor.output(); }
+        [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return int_workspace.lineSegments(); }
 
         //! Indices defining valid range for approximations() and lineSegments().
         /*!
          *
          * @return reference to internal buffer of valid range indices.
          */
-        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_workspace.indices(); }
+
+        //! Enables or disables collection of per-stage statistics.
+        /*!
+         * Disabled by default. The statistics are reset by every call, so they always describe the last processed point cloud.
+         * @param enabled true to fill stats() by the vectorization calls.
+         */
+        void setStatsEnabled(bool enabled) { stats_enabled = enabled; }
+
+        //! Per-stage statistics of the last vectorization call.
+        /*!
+         * All counters are zero unless enabled by setStatsEnabled().
+         * @return reference to internal statistics.
+         */
+        [[nodiscard]] const VectorizationStats& stats() const { return int_workspace.stats(); }
+
+        //! Functor call for vectorization of an ordered point cloud.
+        /*!
+         * Process \p pts and generates output into the internal workspace.
+         * @param pts ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(Span<const VectorType> pts) { return (*this)(pts, int_workspace); }
 
         //! Functor call for vectorization of an ordered point cloud.
         /*!
-         * Process \p pts and generates output into internal buffers.
+         * Process \p pts and generates output into \p ws. The vectorizer is not modified, so it can be called concurrently with different workspaces.
          * @param pts ordered point cloud.
+         * @param ws workspace receiving the results.
          * @return true on success, false otherwise.
          */
-        bool operator()(const std::vector<VectorType> &pts)
+        bool operator()(Span<const VectorType> pts, Workspace &ws) const
         {
-            if(!extractor(pts, int_lines, int_indices))
+            RTL_ZONE("rtl::VectorizerITLSProjections2D");
+            RTL_COUNT("rtl::VectorizerITLSProjections2D::points", pts.size());
+            VectorizationStats *stats = startStats(ws, pts.size());
+            configure(ws);
+            if(!ws.extractor(pts, ws.int_lines, ws.int_indices, stats))
                 return false;
-            return postprocessor(pts, int_lines, int_indices);
+            return ws.postprocessor(pts, ws.int_lines, ws.int_indices);
         }
 
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into an internal buffer first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts) { return (*this)(pts, int_workspace); }
+
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into a buffer of \p ws first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @param ws workspace receiving the results.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts, Workspace &ws) const { return (*this)(pts.span(ws.packed_pts), ws); }
+
     private:
-        ExtractorChainIncremental<ApproximationType> extractor;
-        PostprocessorProjectEndpoints<ApproximationType> postprocessor;
+        //! Resets the statistics of \p ws and returns them if enabled, nullptr otherwise.
+        VectorizationStats *startStats(Workspace &ws, size_t points) const
+        {
+            ws.int_stats.reset();
+            if (!stats_enabled)
+                return nullptr;
+            ws.int_stats.points = points;
+            return &ws.int_stats;
+        }
+
+        //! Applies the settings of *this to the processing stages of \p ws.
+        void configure(Workspace &ws) const
+        {
+            ws.extractor.setSigma(int_sigma);
+        }
 
-        std::vector<ApproximationType> int_lines;
-        std::vector<IndexType> int_indices;
+        Workspace int_workspace;
+        ElementType int_sigma{};
+        bool stats_enabled{false};
     };
 
     //! Fast two dimensional line extracting vectorizer.
@@ -143,6 +238,58 @@ namespace rtl
         typedef ApproximationTlsLine2D<ElementType, ComputeType> ApproximationType;     //!< Approximation type.
         typedef std::pair<size_t, size_t> IndexType;                //!< Type holding a pair of indices to an array.
 
+        //! Buffers and results of a single vectorization, see operator()(Span<const VectorType>, Workspace &) const.
+        /*!
+         * The workspace holds all data modified by the vectorization, while the vectorizer itself keeps only the settings. A configured vectorizer can therefore be shared
+         * by many threads, each of them processing its inputs in its own workspace, and the buffers of the workspaces are reused by subsequent calls.
+         */
+        class Workspace
+        {
+        public:
+            //! Extracted approximations.
+            [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+
+            //! Extracted line segments.
+            [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return postprocessor.lineSegments(); }
+
+            //! Indices defining valid range for approximations() and the output objects.
+            [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+
+            //! Per-stage statistics of the last vectorization call.
+            [[nodiscard]] const VectorizationStats& stats() const { return int_stats; }
+
+            //! Points of the current stream, see append().
+            [[nodiscard]] const std::vector<VectorType>& points() const { return stream_pts; }
+
+            //! Resizes the precomputed sums array to take required number of points to avoid unnecessary reallocation.
+            void setMaxSize(size_t size) { array.resize(size); }
+
+            //! Discards all data of the current stream and prepares the workspace for a new one.
+            void clear()
+            {
+                stream_pts.clear();
+                array.clear();
+                int_lines.clear();
+                int_indices.clear();
+                optimized_lines = 0;
+            }
+
+        private:
+            friend class VectorizerFTLSPolyline2D;
+
+            PrecArrayType array;
+            ExtractorChainFast<PrecArrayType, ApproximationType> extractor;
+            OptimizerContinuity2D<PrecArrayType, ApproximationType> optimizer_continuity;
+            PostprocessorPolyline2D<ApproximationType> postprocessor;
+
+            std::vector<ApproximationType> int_lines;
+            std::vector<IndexType> int_indices;
+            std::vector<VectorType> stream_pts;
+            std::vector<VectorType> packed_pts;
+            VectorizationStats int_stats;
+            size_t optimized_lines{0};
+        };
+
         //! Default constructor.
         VectorizerFTLSPolyline2D() = default;
 
@@ -154,7 +301,7 @@ namespace rtl
          *
          * @param sigma new standard deviation.
          */
-        void setSigma(ElementType sigma) { extractor.setSigma(sigma); }
+        void setSigma(ElementType sigma) { int_sigma = sigma; }
 
         //! Sets maximal permitted distance of intersection of the approximation lines from their neighbouring end points.
         /*!
@@ -162,60 +309,194 @@ namespace rtl
          * and maintain functionality of the optimization procedure.
          * @param delta new value of the maximal distance.
          */
-        void setDelta(ElementType delta) { optimizer_continuity.setDelta(delta); }
+        void setDelta(ElementType delta) { int_delta = delta; }
 
         //! Change size of the precomputed sums array.
         /*!
          * Resizes the array to take required number of points to avoid unnecessary reallocation.
          * @param size number of points.
          */
-        void setMaxSize(size_t size) { array.resize(size); }
+        void setMaxSize(size_t size) { int_workspace.setMaxSize(size); }
+
+        //! Enables or disables Kahan compensated summation in the precomputed sums array.
+        /*!
+         * Improves precision of long point clouds far from origin, especially with single precision ComputeType, see PrecArayBase::setCompensatedSummation().
+         * @param compensated true to enable compensated summation.
+         */
+        void setCompensatedSummation(bool compensated) { compensated_summation = compensated; }
+
+        //! Sets size of the locally centered blocks of the precomputed sums, zero disables them.
+        /*!
+         * Makes single precision ComputeType usable for point clouds far from origin, see PrecArayBase::setCenteredBlocks().
+         * @param block_size number of points in a block.
+         */
+        void setCenteredBlocks(size_t block_size) { centered_blocks = block_size; }
 
         //! Extracted line approximations.
         /*!
          *
          * @return reference to internal buffer of extracted approximations.
          */
-        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_workspace.approximations(); }
 
         //! Extracted line segments.
         /*!
          *
          * @return reference to internal buffer of extracted line segments.
          */
-        [[nodiscard]] std::vector<OutputType> lineSegments() const { return postprocessor.lineSegments(); }
+        [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return int_workspace.lineSegments(); }
 
         //! Indices defining valid range for approximations() and lineSegments().
         /*!
          *
          * @return reference to internal buffer of valid range indices.
          */
-        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_workspace.indices(); }
+
+        //! Enables or disables collection of per-stage statistics.
+        /*!
+         * Disabled by default. The statistics are reset by every call, so they always describe the last processed point cloud.
+         * @param enabled true to fill stats() by the vectorization calls.
+         */
+        void setStatsEnabled(bool enabled) { stats_enabled = enabled; }
+
+        //! Per-stage statistics of the last vectorization call.
+        /*!
+         * All counters are zero unless enabled by setStatsEnabled().
+         * @return reference to internal statistics.
+         */
+        [[nodiscard]] const VectorizationStats& stats() const { return int_workspace.stats(); }
+
+        //! Functor call for vectorization of an ordered point cloud.
+        /*!
+         * Process \p pts and generates output into the internal workspace.
+         * @param pts ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(Span<const VectorType> pts) { return (*this)(pts, int_workspace); }
 
         //! Functor call for vectorization of an ordered point cloud.
         /*!
-         * Process \p pts and generates output into internal buffers.
+         * Process \p pts and generates output into \p ws. The vectorizer is not modified, so it can be called concurrently with different workspaces.
          * @param pts ordered point cloud.
+         * @param ws workspace receiving the results.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(Span<const VectorType> pts, Workspace &ws) const
+        {
+            RTL_ZONE("rtl::VectorizerFTLSPolyline2D");
+            RTL_COUNT("rtl::VectorizerFTLSPolyline2D::points", pts.size());
+            VectorizationStats *stats = startStats(ws, pts.size());
+            configure(ws);
+            ws.optimized_lines = 0;
+            ws.array.precompute(pts);
+            if(!ws.extractor(ws.array, ws.int_lines, ws.int_indices, stats))
+                return false;
+            if(!ws.optimizer_continuity(pts, ws.array, ws.int_lines, ws.int_indices, stats))
+                return false;
+            return ws.postprocessor(pts, ws.int_lines, ws.int_indices);
+        }
+
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into an internal buffer first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts) { return (*this)(pts, int_workspace); }
+
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into a buffer of \p ws first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @param ws workspace receiving the results.
          * @return true on success, false otherwise.
          */
-        bool operator()(const std::vector<VectorType> &pts)
+        bool operator()(StridedSpan<const VectorType> pts, Workspace &ws) const { return (*this)(pts.span(ws.packed_pts), ws); }
+
+        //! Discards all data of the current stream and prepares the vectorizer for a new one.
+        void clear() { int_workspace.clear(); }
+
+        //! Points of the current stream.
+        /*!
+         *
+         * @return reference to internal buffer of all points added by append() since the last clear().
+         */
+        [[nodiscard]] const std::vector<VectorType>& points() const { return int_workspace.points(); }
+
+        //! Streaming vectorization of an ordered point cloud, which is obtained in chunks.
+        /*!
+         * Points of \p chunk are appended behind the points received since the last clear() and the precomputed sums are extended in place. All approximations but the last
+         * one are considered final and only the tail of the stream starting with the last approximation is re-extracted. Continuity optimization is applied to the break
+         * points of the re-extracted tail only and polyline generation follows as in the case of whole-cloud processing by operator(). Since the binary search of the extractor
+         * starts from different end points, the result might slightly differ from vectorization of the whole cloud at once.
+         * @param chunk new points in the stream.
+         * @return true on success, false otherwise (including the case with less than three points in the stream).
+         */
+        bool append(Span<const VectorType> chunk) { return append(chunk, int_workspace); }
+
+        //! Streaming vectorization of an ordered point cloud, which is obtained in chunks, in given workspace.
+        /*!
+         * Same as append(Span<const VectorType>), but the stream is kept in \p ws, so a single vectorizer can process many streams at once. Use Workspace::clear() to
+         * start a new stream.
+         * @param chunk new points in the stream.
+         * @param ws workspace of the stream.
+         * @return true on success, false otherwise (including the case with less than three points in the stream).
+         */
+        bool append(Span<const VectorType> chunk, Workspace &ws) const
         {
-            array.precompute(pts);
-            if(!extractor(array, int_lines, int_indices))
+            RTL_ZONE("rtl::VectorizerFTLSPolyline2D::append");
+            RTL_COUNT("rtl::VectorizerFTLSPolyline2D::append::points", chunk.size());
+            VectorizationStats *stats = startStats(ws, chunk.size());
+            configure(ws);
+            ws.stream_pts.insert(ws.stream_pts.end(), chunk.begin(), chunk.end());
+            ws.array.append(chunk);
+            if (ws.stream_pts.size() < 3)
+                return false;
+
+            size_t first_pt = 0;
+            if (!ws.int_indices.empty())
+            {
+                first_pt = ws.int_indices.back().first;
+                ws.int_lines.pop_back();
+                ws.int_indices.pop_back();
+            }
+            size_t first_line = std::min(ws.optimized_lines, ws.int_lines.size());
+            ws.optimized_lines = 0;
+            if(!ws.extractor(ws.array, ws.int_lines, ws.int_indices, first_pt, stats))
                 return false;
-            if(!optimizer_continuity(pts, array, int_lines, int_indices))
+            if(!ws.optimizer_continuity(ws.stream_pts, ws.array, ws.int_lines, ws.int_indices, first_line, stats))
                 return false;
-            return postprocessor(pts, int_lines, int_indices);
+            ws.optimized_lines = ws.int_lines.size();
+            return ws.postprocessor(ws.stream_pts, ws.int_lines, ws.int_indices);
         }
 
     private:
-        PrecArrayType array;
-        ExtractorChainFast<PrecArrayType, ApproximationType> extractor;
-        OptimizerContinuity2D<PrecArrayType, ApproximationType> optimizer_continuity;
-        PostprocessorPolyline2D<ApproximationType> postprocessor;
+        //! Resets the statistics of \p ws and returns them if enabled, nullptr otherwise.
+        VectorizationStats *startStats(Workspace &ws, size_t points) const
+        {
+            ws.int_stats.reset();
+            if (!stats_enabled)
+                return nullptr;
+            ws.int_stats.points = points;
+            return &ws.int_stats;
+        }
 
-        std::vector<ApproximationType> int_lines;
-        std::vector<IndexType> int_indices;
+        //! Applies the settings of *this to the processing stages of \p ws.
+        void configure(Workspace &ws) const
+        {
+            ws.extractor.setSigma(int_sigma);
+            ws.optimizer_continuity.setDelta(int_delta);
+            ws.array.setCompensatedSummation(compensated_summation);
+            ws.array.setCenteredBlocks(centered_blocks);
+        }
+
+        Workspace int_workspace;
+        ElementType int_sigma{};
+        ElementType int_delta{};
+        bool compensated_summation{false};
+        size_t centered_blocks{0};
+        bool stats_enabled{false};
     };
 
     //! Fast two dimensional line extracting vectorizer with global error optimization.
@@ -237,6 +518,44 @@ namespace rtl
         typedef ApproximationTlsLine2D<ElementType, ComputeType> ApproximationType;     //!< Approximation type.
         typedef std::pair<size_t, size_t> IndexType;                //!< Type holding a pair of indices to an array.
 
+        //! Buffers and results of a single vectorization, see operator()(Span<const VectorType>, Workspace &) const.
+        /*!
+         * The workspace holds all data modified by the vectorization, while the vectorizer itself keeps only the settings. A configured vectorizer can therefore be shared
+         * by many threads, each of them processing its inputs in its own workspace, and the buffers of the workspaces are reused by subsequent calls.
+         */
+        class Workspace
+        {
+        public:
+            //! Extracted approximations.
+            [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+
+            //! Extracted line segments.
+            [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return postprocessor.lineSegments(); }
+
+            //! Indices defining valid range for approximations() and the output objects.
+            [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+
+            //! Per-stage statistics of the last vectorization call.
+            [[nodiscard]] const VectorizationStats& stats() const { return int_stats; }
+
+            //! Resizes the precomputed sums array to take required number of points to avoid unnecessary reallocation.
+            void setMaxSize(size_t size) { array.resize(size); }
+
+        private:
+            friend class VectorizerAFTLSPolyline2D;
+
+            PrecArrayType array;
+            ExtractorChainFast<PrecArrayType, ApproximationType> extractor;
+            OptimizerTotalError<PrecArrayType, ApproximationType> optimizer_total_error;
+            OptimizerContinuity2D<PrecArrayType, ApproximationType> optimizer_continuity;
+            PostprocessorPolyline2D<ApproximationType> postprocessor;
+
+            std::vector<ApproximationType> int_lines;
+            std::vector<IndexType> int_indices;
+            std::vector<VectorType> packed_pts;
+            VectorizationStats int_stats;
+        };
+
         //! Default constructor.
         VectorizerAFTLSPolyline2D() = default;
 
@@ -248,28 +567,42 @@ namespace rtl
          * Resizes the array to take required number of points to avoid unnecessary reallocation.
          * @param size number of points.
          */
-        void setMaxSize(size_t size) { array.resize(size); }
+        void setMaxSize(size_t size) { int_workspace.setMaxSize(size); }
+
+        //! Enables or disables Kahan compensated summation in the precomputed sums array.
+        /*!
+         * Improves precision of long point clouds far from origin, especially with single precision ComputeType, see PrecArayBase::setCompensatedSummation().
+         * @param compensated true to enable compensated summation.
+         */
+        void setCompensatedSummation(bool compensated) { compensated_summation = compensated; }
+
+        //! Sets size of the locally centered blocks of the precomputed sums, zero disables them.
+        /*!
+         * Makes single precision ComputeType usable for point clouds far from origin, see PrecArayBase::setCenteredBlocks().
+         * @param block_size number of points in a block.
+         */
+        void setCenteredBlocks(size_t block_size) { centered_blocks = block_size; }
 
         //! Sets maximal permitted standard deviation of point-approximation distances.
         /*!
          *
          * @param sigma new standard deviation.
          */
-        void setSigma(ElementType sigma) { extractor.setSigma(sigma); }
+        void setSigma(ElementType sigma) { int_sigma = sigma; }
 
         //! Sets initial shift of Nelder-Mead simplex vertices in global error optimization.
         /*!
          * Optimal value is usually between \a N/50 and \a N/500, where \a N is the number of processed points. Must be at least one, which is enforced by the function itself.
          * @param simplex_shift new initial shift.
          */
-        void setSimplexShift(size_t simplex_shift) { optimizer_total_error.setSimplexShift(simplex_shift); }
+        void setSimplexShift(size_t simplex_shift) { int_simplex_shift = simplex_shift; }
 
         //! Sets maximal number of iterations of the global error optimization.
         /*!
          * Usually the optimization terminates much faster. This limit prevents rare endless loops in the program.
          * @param max_iterations new maximal number of iterations.
          */
-        void setMaxIterations(size_t max_iterations) { optimizer_total_error.setMaxIterations(max_iterations); }
+        void setMaxIterations(size_t max_iterations) { int_max_iterations = max_iterations; }
 
         //! Sets maximal permitted distance of intersection of the approximation lines from their neighbouring end points.
         /*!
@@ -277,56 +610,121 @@ namespace rtl
          * and maintain functionality of the optimization procedure.
          * @param delta new value of the maximal distance.
          */
-        void setDelta(ElementType delta) { optimizer_continuity.setDelta(delta); }
+        void setDelta(ElementType delta) { int_delta = delta; }
 
         //! Extracted line approximations.
         /*!
          *
          * @return reference to internal buffer of extracted approximations.
          */
-        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_workspace.approximations(); }
 
         //! Extracted line segments.
         /*!
          *
          * @return reference to internal buffer of extracted line segments.
          */
-        [[nodiscard]] std::vector<OutputType> lineSegments() const { return postprocessor.lineSegments(); }
+        [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return int_workspace.lineSegments(); }
 
         //! Indices defining valid range for approximations() and lineSegments().
         /*!
          *
          * @return reference to internal buffer of valid range indices.
          */
-        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_workspace.indices(); }
+
+        //! Enables or disables collection of per-stage statistics.
+        /*!
+         * Disabled by default. The statistics are reset by every call, so they always describe the last processed point cloud.
+         * @param enabled true to fill stats() by the vectorization calls.
+         */
+        void setStatsEnabled(bool enabled) { stats_enabled = enabled; }
+
+        //! Per-stage statistics of the last vectorization call.
+        /*!
+         * All counters are zero unless enabled by setStatsEnabled().
+         * @return reference to internal statistics.
+         */
+        [[nodiscard]] const VectorizationStats& stats() const { return int_workspace.stats(); }
+
+        //! Functor call for vectorization of an ordered point cloud.
+        /*!
+         * Process \p pts and generates output into the internal workspace.
+         * @param pts ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(Span<const VectorType> pts) { return (*this)(pts, int_workspace); }
 
         //! Functor call for vectorization of an ordered point cloud.
         /*!
-         * Process \p pts and generates output into internal buffers.
+         * Process \p pts and generates output into \p ws. The vectorizer is not modified, so it can be called concurrently with different workspaces.
          * @param pts ordered point cloud.
+         * @param ws workspace receiving the results.
          * @return true on success, false otherwise.
          */
-        bool operator()(const std::vector<VectorType> &pts)
+        bool operator()(Span<const VectorType> pts, Workspace &ws) const
         {
-            array.precompute(pts);
-            if(!extractor(array, int_lines, int_indices))
+            RTL_ZONE("rtl::VectorizerAFTLSPolyline2D");
+            RTL_COUNT("rtl::VectorizerAFTLSPolyline2D::points", pts.size());
+            VectorizationStats *stats = startStats(ws, pts.size());
+            configure(ws);
+            ws.array.precompute(pts);
+            if(!ws.extractor(ws.array, ws.int_lines, ws.int_indices, stats))
                 return false;
-            if(!optimizer_total_error(pts, array, int_lines, int_indices))
+            if(!ws.optimizer_total_error(pts, ws.array, ws.int_lines, ws.int_indices, stats))
                 return false;
-            if(!optimizer_continuity(pts, array, int_lines, int_indices))
+            if(!ws.optimizer_continuity(pts, ws.array, ws.int_lines, ws.int_indices, stats))
                 return false;
-            return postprocessor(pts, int_lines, int_indices);
+            return ws.postprocessor(pts, ws.int_lines, ws.int_indices);
         }
 
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into an internal buffer first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts) { return (*this)(pts, int_workspace); }
+
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into a buffer of \p ws first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @param ws workspace receiving the results.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts, Workspace &ws) const { return (*this)(pts.span(ws.packed_pts), ws); }
+
     private:
-        PrecArrayType array;
-        ExtractorChainFast<PrecArrayType, ApproximationType> extractor;
-        OptimizerTotalError<PrecArrayType, ApproximationType> optimizer_total_error;
-        OptimizerContinuity2D<PrecArrayType, ApproximationType> optimizer_continuity;
-        PostprocessorPolyline2D<ApproximationType> postprocessor;
-
-        std::vector<ApproximationType> int_lines;
-        std::vector<IndexType> int_indices;
+        //! Resets the statistics of \p ws and returns them if enabled, nullptr otherwise.
+        VectorizationStats *startStats(Workspace &ws, size_t points) const
+        {
+            ws.int_stats.reset();
+            if (!stats_enabled)
+                return nullptr;
+            ws.int_stats.points = points;
+            return &ws.int_stats;
+        }
+
+        //! Applies the settings of *this to the processing stages of \p ws.
+        void configure(Workspace &ws) const
+        {
+            ws.extractor.setSigma(int_sigma);
+            ws.optimizer_total_error.setSimplexShift(int_simplex_shift);
+            ws.optimizer_total_error.setMaxIterations(int_max_iterations);
+            ws.optimizer_continuity.setDelta(int_delta);
+            ws.array.setCompensatedSummation(compensated_summation);
+            ws.array.setCenteredBlocks(centered_blocks);
+        }
+
+        Workspace int_workspace;
+        ElementType int_sigma{};
+        ElementType int_delta{};
+        size_t int_simplex_shift{1};
+        size_t int_max_iterations{10000};
+        bool compensated_summation{false};
+        size_t centered_blocks{0};
+        bool stats_enabled{false};
     };
 
     //! Three dimensional line extracting vectorizer.
@@ -346,6 +744,38 @@ namespace rtl
         typedef ApproximationTlsLine3D<ElementType, ComputeType> ApproximationType; //!< Approximation type.
         typedef std::pair<size_t, size_t> IndexType;    //!< Type holding a pair of indices to an array.
 
+        //! Buffers and results of a single vectorization, see operator()(Span<const VectorType>, Workspace &) const.
+        /*!
+         * The workspace holds all data modified by the vectorization, while the vectorizer itself keeps only the settings. A configured vectorizer can therefore be shared
+         * by many threads, each of them processing its inputs in its own workspace, and the buffers of the workspaces are reused by subsequent calls.
+         */
+        class Workspace
+        {
+        public:
+            //! Extracted approximations.
+            [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+
+            //! Extracted line segments.
+            [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return postprocessor.output(); }
+
+            //! Indices defining valid range for approximations() and the output objects.
+            [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+
+            //! Per-stage statistics of the last vectorization call.
+            [[nodiscard]] const VectorizationStats& stats() const { return int_stats; }
+
+        private:
+            friend class VectorizerITLSProjections3D;
+
+            ExtractorChainIncremental<ApproximationType> extractor;
+            PostprocessorProjectEndpoints<ApproximationType> postprocessor;
+
+            std::vector<ApproximationType> int_lines;
+            std::vector<IndexType> int_indices;
+            std::vector<VectorType> packed_pts;
+            VectorizationStats int_stats;
+        };
+
         //! Default constructor.
         VectorizerITLSProjections3D() = default;
 
@@ -357,48 +787,106 @@ namespace rtl
          *
          * @param sigma new standard deviation.
          */
-        void setSigma(ElementType sigma) { extractor.setSigma(sigma); }
+        void setSigma(ElementType sigma) { int_sigma = sigma; }
 
         //! Extracted line approximations.
         /*!
          *
          * @return reference to internal buffer of extracted approximations.
          */
-        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_workspace.approximations(); }
 
         //! Extracted line segments.
         /*!
          *
          * @return reference to internal buffer of extracted line segments.
          */
-        [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return postprocessor.output(); }
+        [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return int_workspace.lineSegments(); }
 
         //! Indices defining valid range for approximations() and lineSegments().
         /*!
          *
          * @return reference to internal buffer of valid range indices.
          */
-        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_workspace.indices(); }
+
+        //! Enables or disables collection of per-stage statistics.
+        /*!
+         * Disabled by default. The statistics are reset by every call, so they always describe the last processed point cloud.
+         * @param enabled true to fill stats() by the vectorization calls.
+         */
+        void setStatsEnabled(bool enabled) { stats_enabled = enabled; }
+
+        //! Per-stage statistics of the last vectorization call.
+        /*!
+         * All counters are zero unless enabled by setStatsEnabled().
+         * @return reference to internal statistics.
+         */
+        [[nodiscard]] const VectorizationStats& stats() const { return int_workspace.stats(); }
+
+        //! Functor call for vectorization of an ordered point cloud.
+        /*!
+         * Process \p pts and generates output into the internal workspace.
+         * @param pts ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(Span<const VectorType> pts) { return (*this)(pts, int_workspace); }
 
         //! Functor call for vectorization of an ordered point cloud.
         /*!
-         * Process \p pts and generates output into internal buffers.
+         * Process \p pts and generates output into \p ws. The vectorizer is not modified, so it can be called concurrently with different workspaces.
          * @param pts ordered point cloud.
+         * @param ws workspace receiving the results.
          * @return true on success, false otherwise.
          */
-        bool operator()(const std::vector<VectorType> &pts)
+        bool operator()(Span<const VectorType> pts, Workspace &ws) const
         {
-            if(!extractor(pts, int_lines, int_indices))
+            RTL_ZONE("rtl::VectorizerITLSProjections3D");
+            RTL_COUNT("rtl::VectorizerITLSProjections3D::points", pts.size());
+            VectorizationStats *stats = startStats(ws, pts.size());
+            configure(ws);
+            if(!ws.extractor(pts, ws.int_lines, ws.int_indices, stats))
                 return false;
-            return postprocessor(pts, int_lines, int_indices);
+            return ws.postprocessor(pts, ws.int_lines, ws.int_indices);
         }
 
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into an internal buffer first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts) { return (*this)(pts, int_workspace); }
+
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into a buffer of \p ws first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @param ws workspace receiving the results.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts, Workspace &ws) const { return (*this)(pts.span(ws.packed_pts), ws); }
+
     private:
-        ExtractorChainIncremental<ApproximationType> extractor;
-        PostprocessorProjectEndpoints<ApproximationType> postprocessor;
+        //! Resets the statistics of \p ws and returns them if enabled, nullptr otherwise.
+        VectorizationStats *startStats(Workspace &ws, size_t points) const
+        {
+            ws.int_stats.reset();
+            if (!stats_enabled)
+                return nullptr;
+            ws.int_stats.points = points;
+            return &ws.int_stats;
+        }
 
-        std::vector<ApproximationType> int_lines;
-        std::vector<IndexType> int_indices;
+        //! Applies the settings of *this to the processing stages of \p ws.
+        void configure(Workspace &ws) const
+        {
+            ws.extractor.setSigma(int_sigma);
+        }
+
+        Workspace int_workspace;
+        ElementType int_sigma{};
+        bool stats_enabled{false};
     };
 
     //! Fast three dimensional line extracting vectorizer.
@@ -419,6 +907,42 @@ namespace rtl
         typedef ApproximationTlsLine3D<ElementType, ComputeType> ApproximationType;     //!< Approximation type.
         typedef std::pair<size_t, size_t> IndexType;                    //!< Type holding a pair of indices to an array.
 
+        //! Buffers and results of a single vectorization, see operator()(Span<const VectorType>, Workspace &) const.
+        /*!
+         * The workspace holds all data modified by the vectorization, while the vectorizer itself keeps only the settings. A configured vectorizer can therefore be shared
+         * by many threads, each of them processing its inputs in its own workspace, and the buffers of the workspaces are reused by subsequent calls.
+         */
+        class Workspace
+        {
+        public:
+            //! Extracted approximations.
+            [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+
+            //! Extracted line segments.
+            [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return postprocessor.output(); }
+
+            //! Indices defining valid range for approximations() and the output objects.
+            [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+
+            //! Per-stage statistics of the last vectorization call.
+            [[nodiscard]] const VectorizationStats& stats() const { return int_stats; }
+
+            //! Resizes the precomputed sums array to take required number of points to avoid unnecessary reallocation.
+            void setMaxSize(size_t size) { array.resize(size); }
+
+        private:
+            friend class VectorizerFTLSProjections3D;
+
+            PrecArrayType array;
+            ExtractorChainFast<PrecArrayType, ApproximationType> extractor;
+            PostprocessorProjectEndpoints<ApproximationType> postprocessor;
+
+            std::vector<ApproximationType> int_lines;
+            std::vector<IndexType> int_indices;
+            std::vector<VectorType> packed_pts;
+            VectorizationStats int_stats;
+        };
+
         //! Default constructor.
         VectorizerFTLSProjections3D() = default;
 
@@ -430,57 +954,132 @@ namespace rtl
          *
          * @param sigma new standard deviation.
          */
-        void setSigma(ElementType sigma) { extractor.setSigma(sigma); }
+        void setSigma(ElementType sigma) { int_sigma = sigma; }
 
         //! Change size of the precomputed sums array.
         /*!
          * Resizes the array to take required number of points to avoid unnecessary reallocation.
          * @param size number of points.
          */
-        void setMaxSize(size_t size) { array.resize(size); }
+        void setMaxSize(size_t size) { int_workspace.setMaxSize(size); }
+
+        //! Enables or disables Kahan compensated summation in the precomputed sums array.
+        /*!
+         * Improves precision of long point clouds far from origin, especially with single precision ComputeType, see PrecArayBase::setCompensatedSummation().
+         * @param compensated true to enable compensated summation.
+         */
+        void setCompensatedSummation(bool compensated) { compensated_summation = compensated; }
+
+        //! Sets size of the locally centered blocks of the precomputed sums, zero disables them.
+        /*!
+         * Makes single precision ComputeType usable for point clouds far from origin, see PrecArayBase::setCenteredBlocks().
+         * @param block_size number of points in a block.
+         */
+        void setCenteredBlocks(size_t block_size) { centered_blocks = block_size; }
 
         //! Extracted line approximations.
         /*!
          *
          * @return reference to internal buffer of extracted approximations.
          */
-        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_workspace.approximations(); }
 
         //! Extracted line segments.
         /*!
          *
          * @return reference to internal buffer of extracted line segments.
          */
-        [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return postprocessor.output(); }
+        [[nodiscard]] const std::vector<OutputType>& lineSegments() const { return int_workspace.lineSegments(); }
 
         //! Indices defining valid range for approximations() and lineSegments().
         /*!
          *
          * @return reference to internal buffer of valid range indices.
          */
-        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_workspace.indices(); }
+
+        //! Enables or disables collection of per-stage statistics.
+        /*!
+         * Disabled by default. The statistics are reset by every call, so they always describe the last processed point cloud.
+         * @param enabled true to fill stats() by the vectorization calls.
+         */
+        void setStatsEnabled(bool enabled) { stats_enabled = enabled; }
+
+        //! Per-stage statistics of the last vectorization call.
+        /*!
+         * All counters are zero unless enabled by setStatsEnabled().
+         * @return reference to internal statistics.
+         */
+        [[nodiscard]] const VectorizationStats& stats() const { return int_workspace.stats(); }
+
+        //! Functor call for vectorization of an ordered point cloud.
+        /*!
+         * Process \p pts and generates output into the internal workspace.
+         * @param pts ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(Span<const VectorType> pts) { return (*this)(pts, int_workspace); }
 
         //! Functor call for vectorization of an ordered point cloud.
         /*!
-         * Process \p pts and generates output into internal buffers.
+         * Process \p pts and generates output into \p ws. The vectorizer is not modified, so it can be called concurrently with different workspaces.
          * @param pts ordered point cloud.
+         * @param ws workspace receiving the results.
          * @return true on success, false otherwise.
          */
-        bool operator()(const std::vector<VectorType> &pts)
+        bool operator()(Span<const VectorType> pts, Workspace &ws) const
         {
-            array.precompute(pts);
-            if(!extractor(array, int_lines, int_indices))
+            RTL_ZONE("rtl::VectorizerFTLSProjections3D");
+            RTL_COUNT("rtl::VectorizerFTLSProjections3D::points", pts.size());
+            VectorizationStats *stats = startStats(ws, pts.size());
+            configure(ws);
+            ws.array.precompute(pts);
+            if(!ws.extractor(ws.array, ws.int_lines, ws.int_indices, stats))
                 return false;
-            return postprocessor(pts, int_lines, int_indices);
+            return ws.postprocessor(pts, ws.int_lines, ws.int_indices);
         }
 
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into an internal buffer first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts) { return (*this)(pts, int_workspace); }
+
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into a buffer of \p ws first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @param ws workspace receiving the results.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts, Workspace &ws) const { return (*this)(pts.span(ws.packed_pts), ws); }
+
     private:
-        PrecArrayType array;
-        ExtractorChainFast<PrecArrayType, ApproximationType> extractor;
-        PostprocessorProjectEndpoints<ApproximationType> postprocessor;
+        //! Resets the statistics of \p ws and returns them if enabled, nullptr otherwise.
+        VectorizationStats *startStats(Workspace &ws, size_t points) const
+        {
+            ws.int_stats.reset();
+            if (!stats_enabled)
+                return nullptr;
+            ws.int_stats.points = points;
+            return &ws.int_stats;
+        }
+
+        //! Applies the settings of *this to the processing stages of \p ws.
+        void configure(Workspace &ws) const
+        {
+            ws.extractor.setSigma(int_sigma);
+            ws.array.setCompensatedSummation(compensated_summation);
+            ws.array.setCenteredBlocks(centered_blocks);
+        }
 
-        std::vector<ApproximationType> int_lines;
-        std::vector<IndexType> int_indices;
+        Workspace int_workspace;
+        ElementType int_sigma{};
+        bool compensated_summation{false};
+        size_t centered_blocks{0};
+        bool stats_enabled{false};
     };
 
     //! Fast three dimensional line extracting vectorizer with global error optimization.
@@ -502,6 +1101,43 @@ namespace rtl
         typedef ApproximationTlsLine3D<ElementType, ComputeType> ApproximationType;     //!< Approximation type.
         typedef std::pair<size_t, size_t> IndexType;                //!< Type holding a pair of indices to an array.
 
+        //! Buffers and results of a single vectorization, see operator()(Span<const VectorType>, Workspace &) const.
+        /*!
+         * The workspace holds all data modified by the vectorization, while the vectorizer itself keeps only the settings. A configured vectorizer can therefore be shared
+         * by many threads, each of them processing its inputs in its own workspace, and the buffers of the workspaces are reused by subsequent calls.
+         */
+        class Workspace
+        {
+        public:
+            //! Extracted approximations.
+            [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+
+            //! Extracted line segments.
+            [[nodiscard]] const std::vector<LineSegmentType>& lineSegments() const { return postprocessor.output(); }
+
+            //! Indices defining valid range for approximations() and the output objects.
+            [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+
+            //! Per-stage statistics of the last vectorization call.
+            [[nodiscard]] const VectorizationStats& stats() const { return int_stats; }
+
+            //! Resizes the precomputed sums array to take required number of points to avoid unnecessary reallocation.
+            void setMaxSize(size_t size) { array.resize(size); }
+
+        private:
+            friend class VectorizerAFTLSProjections3D;
+
+            PrecArrayType array;
+            ExtractorChainFast<PrecArrayType, ApproximationType> extractor;
+            OptimizerTotalError<PrecArrayType, ApproximationType> optimizer_total_error;
+            PostprocessorProjectEndpoints<ApproximationType> postprocessor;
+
+            std::vector<ApproximationType> int_lines;
+            std::vector<IndexType> int_indices;
+            std::vector<VectorType> packed_pts;
+            VectorizationStats int_stats;
+        };
+
         //! Default constructor.
         VectorizerAFTLSProjections3D() = default;
 
@@ -513,74 +1149,152 @@ namespace rtl
          * Resizes the array to take required number of points to avoid unnecessary reallocation.
          * @param size number of points.
          */
-        void setMaxSize(size_t size) { array.resize(size); }
+        void setMaxSize(size_t size) { int_workspace.setMaxSize(size); }
+
+        //! Enables or disables Kahan compensated summation in the precomputed sums array.
+        /*!
+         * Improves precision of long point clouds far from origin, especially with single precision ComputeType, see PrecArayBase::setCompensatedSummation().
+         * @param compensated true to enable compensated summation.
+         */
+        void setCompensatedSummation(bool compensated) { compensated_summation = compensated; }
+
+        //! Sets size of the locally centered blocks of the precomputed sums, zero disables them.
+        /*!
+         * Makes single precision ComputeType usable for point clouds far from origin, see PrecArayBase::setCenteredBlocks().
+         * @param block_size number of points in a block.
+         */
+        void setCenteredBlocks(size_t block_size) { centered_blocks = block_size; }
 
         //! Sets maximal permitted standard deviation of point-approximation distances.
         /*!
          *
          * @param sigma new standard deviation.
          */
-        void setSigma(ElementType sigma) { extractor.setSigma(sigma); }
+        void setSigma(ElementType sigma) { int_sigma = sigma; }
 
         //! Sets initial shift of Nelder-Mead simplex vertices in global error optimization.
         /*!
          * Optimal value is usually between \a N/50 and \a N/500, where \a N is the number of processed points. Must be at least one, which is enforced by the function itself.
          * @param simplex_shift new initial shift.
          */
-        void setSimplexShift(size_t simplex_shift) { optimizer_total_error.setSimplexShift(simplex_shift); }
+        void setSimplexShift(size_t simplex_shift) { int_simplex_shift = simplex_shift; }
 
         //! Sets maximal number of iterations of the global error optimization.
         /*!
          * Usually the optimization terminates much faster. This limit prevents rare endless loops in the program.
          * @param max_iterations new maximal number of iterations.
          */
-        void setMaxIterations(size_t max_iterations) { optimizer_total_error.setMaxIterations(max_iterations); }
+        void setMaxIterations(size_t max_iterations) { int_max_iterations = max_iterations; }
 
         //! Extracted line approximations.
         /*!
          *
          * @return reference to internal buffer of extracted approximations.
          */
-        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_workspace.approximations(); }
 
         //! Extracted line segments.
         /*!
          *
          * @return reference to internal buffer of extracted line segments.
          */
-        [[nodiscard]] const std::vector<LineSegmentType>& lineSegments() const { return postprocessor.output(); }
+        [[nodiscard]] const std::vector<LineSegmentType>& lineSegments() const { return int_workspace.lineSegments(); }
 
         //! Indices defining valid range for approximations() and lineSegments().
         /*!
          *
          * @return reference to internal buffer of valid range indices.
          */
-        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_workspace.indices(); }
+
+        //! Enables or disables collection of per-stage statistics.
+        /*!
+         * Disabled by default. The statistics are reset by every call, so they always describe the last processed point cloud.
+         * @param enabled true to fill stats() by the vectorization calls.
+         */
+        void setStatsEnabled(bool enabled) { stats_enabled = enabled; }
+
+        //! Per-stage statistics of the last vectorization call.
+        /*!
+         * All counters are zero unless enabled by setStatsEnabled().
+         * @return reference to internal statistics.
+         */
+        [[nodiscard]] const VectorizationStats& stats() const { return int_workspace.stats(); }
+
+        //! Functor call for vectorization of an ordered point cloud.
+        /*!
+         * Process \p pts and generates output into the internal workspace.
+         * @param pts ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(Span<const VectorType> pts) { return (*this)(pts, int_workspace); }
 
         //! Functor call for vectorization of an ordered point cloud.
         /*!
-         * Process \p pts and generates output into internal buffers.
+         * Process \p pts and generates output into \p ws. The vectorizer is not modified, so it can be called concurrently with different workspaces.
          * @param pts ordered point cloud.
+         * @param ws workspace receiving the results.
          * @return true on success, false otherwise.
          */
-        bool operator()(const std::vector<VectorType> &pts)
+        bool operator()(Span<const VectorType> pts, Workspace &ws) const
         {
-            array.precompute(pts);
-            if(!extractor(array, int_lines, int_indices))
+            RTL_ZONE("rtl::VectorizerAFTLSProjections3D");
+            RTL_COUNT("rtl::VectorizerAFTLSProjections3D::points", pts.size());
+            VectorizationStats *stats = startStats(ws, pts.size());
+            configure(ws);
+            ws.array.precompute(pts);
+            if(!ws.extractor(ws.array, ws.int_lines, ws.int_indices, stats))
                 return false;
-            if(!optimizer_total_error(pts, array, int_lines, int_indices))
+            if(!ws.optimizer_total_error(pts, ws.array, ws.int_lines, ws.int_indices, stats))
                 return false;
-            return postprocessor(pts, int_lines, int_indices);
+            return ws.postprocessor(pts, ws.int_lines, ws.int_indices);
         }
 
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into an internal buffer first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts) { return (*this)(pts, int_workspace); }
+
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into a buffer of \p ws first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @param ws workspace receiving the results.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts, Workspace &ws) const { return (*this)(pts.span(ws.packed_pts), ws); }
+
     private:
-        PrecArrayType array;
-        ExtractorChainFast<PrecArrayType, ApproximationType> extractor;
-        OptimizerTotalError<PrecArrayType, ApproximationType> optimizer_total_error;
-        PostprocessorProjectEndpoints<ApproximationType> postprocessor;
+        //! Resets the statistics of \p ws and returns them if enabled, nullptr otherwise.
+        VectorizationStats *startStats(Workspace &ws, size_t points) const
+        {
+            ws.int_stats.reset();
+            if (!stats_enabled)
+                return nullptr;
+            ws.int_stats.points = points;
+            return &ws.int_stats;
+        }
+
+        //! Applies the settings of *this to the processing stages of \p ws.
+        void configure(Workspace &ws) const
+        {
+            ws.extractor.setSigma(int_sigma);
+            ws.optimizer_total_error.setSimplexShift(int_simplex_shift);
+            ws.optimizer_total_error.setMaxIterations(int_max_iterations);
+            ws.array.setCompensatedSummation(compensated_summation);
+            ws.array.setCenteredBlocks(centered_blocks);
+        }
 
-        std::vector<ApproximationType> int_lines;
-        std::vector<IndexType> int_indices;
+        Workspace int_workspace;
+        ElementType int_sigma{};
+        size_t int_simplex_shift{1};
+        size_t int_max_iterations{10000};
+        bool compensated_summation{false};
+        size_t centered_blocks{0};
+        bool stats_enabled{false};
     };
 
     //! Fast three dimensional plane extracting vectorizer with global error optimization.
@@ -602,6 +1316,43 @@ namespace rtl
         typedef ApproximationTlsPlane3D<ElementType, ComputeType> ApproximationType;     //!< Approximation type.
         typedef std::pair<size_t, size_t> IndexType;                //!< Type holding a pair of indices to an array.
 
+        //! Buffers and results of a single vectorization, see operator()(Span<const VectorType>, Workspace &) const.
+        /*!
+         * The workspace holds all data modified by the vectorization, while the vectorizer itself keeps only the settings. A configured vectorizer can therefore be shared
+         * by many threads, each of them processing its inputs in its own workspace, and the buffers of the workspaces are reused by subsequent calls.
+         */
+        class Workspace
+        {
+        public:
+            //! Extracted approximations.
+            [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+
+            //! Extracted polygons.
+            [[nodiscard]] const std::vector<OutputType>& polygons() const { return postprocessor.output(); }
+
+            //! Indices defining valid range for approximations() and the output objects.
+            [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+
+            //! Per-stage statistics of the last vectorization call.
+            [[nodiscard]] const VectorizationStats& stats() const { return int_stats; }
+
+            //! Resizes the precomputed sums array to take required number of points to avoid unnecessary reallocation.
+            void setMaxSize(size_t size) { array.resize(size); }
+
+        private:
+            friend class VectorizerAFTLSPlaneProjections3D;
+
+            PrecArrayType array;
+            ExtractorChainFast<PrecArrayType, ApproximationType> extractor;
+            OptimizerTotalError<PrecArrayType, ApproximationType> optimizer_total_error;
+            PostprocessorProjectEndpoints<ApproximationType> postprocessor;
+
+            std::vector<ApproximationType> int_lines;
+            std::vector<IndexType> int_indices;
+            std::vector<VectorType> packed_pts;
+            VectorizationStats int_stats;
+        };
+
         //! Default constructor.
         VectorizerAFTLSPlaneProjections3D() = default;
 
@@ -613,74 +1364,346 @@ namespace rtl
          * Resizes the array to take required number of points to avoid unnecessary reallocation.
          * @param size number of points.
          */
-        void setMaxSize(size_t size) { array.resize(size); }
+        void setMaxSize(size_t size) { int_workspace.setMaxSize(size); }
+
+        //! Enables or disables Kahan compensated summation in the precomputed sums array.
+        /*!
+         * Improves precision of long point clouds far from origin, especially with single precision ComputeType, see PrecArayBase::setCompensatedSummation().
+         * @param compensated true to enable compensated summation.
+         */
+        void setCompensatedSummation(bool compensated) { compensated_summation = compensated; }
+
+        //! Sets size of the locally centered blocks of the precomputed sums, zero disables them.
+        /*!
+         * Makes single precision ComputeType usable for point clouds far from origin, see PrecArayBase::setCenteredBlocks().
+         * @param block_size number of points in a block.
+         */
+        void setCenteredBlocks(size_t block_size) { centered_blocks = block_size; }
 
         //! Sets maximal permitted standard deviation of point-approximation distances.
         /*!
          *
          * @param sigma new standard deviation.
          */
-        void setSigma(ElementType sigma) { extractor.setSigma(sigma); }
+        void setSigma(ElementType sigma) { int_sigma = sigma; }
 
         //! Sets initial shift of Nelder-Mead simplex vertices in global error optimization.
         /*!
          * Optimal value is usually between \a N/50 and \a N/500, where \a N is the number of processed points. Must be at least one, which is enforced by the function itself.
          * @param simplex_shift new initial shift.
          */
-        void setSimplexShift(size_t simplex_shift) { optimizer_total_error.setSimplexShift(simplex_shift); }
+        void setSimplexShift(size_t simplex_shift) { int_simplex_shift = simplex_shift; }
 
         //! Sets maximal number of iterations of the global error optimization.
         /*!
          * Usually the optimization terminates much faster. This limit prevents rare endless loops in the program.
          * @param max_iterations new maximal number of iterations.
          */
-        void setMaxIterations(size_t max_iterations) { optimizer_total_error.setMaxIterations(max_iterations); }
+        void setMaxIterations(size_t max_iterations) { int_max_iterations = max_iterations; }
 
         //! Extracted line approximations.
         /*!
          *
          * @return reference to internal buffer of extracted approximations.
          */
-        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_lines; }
+        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_workspace.approximations(); }
 
         //! Extracted polygons.
         /*!
          *
          * @return reference to internal buffer of extracted polygons.
          */
-        [[nodiscard]] const std::vector<OutputType>& polygons() const { return postprocessor.output(); }
+        [[nodiscard]] const std::vector<OutputType>& polygons() const { return int_workspace.polygons(); }
 
         //! Indices defining valid range for approximations() and polygons().
         /*!
          *
          * @return reference to internal buffer of valid range indices.
          */
-        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_indices; }
+        [[nodiscard]] const std::vector<IndexType>& indices() const { return int_workspace.indices(); }
+
+        //! Enables or disables collection of per-stage statistics.
+        /*!
+         * Disabled by default. The statistics are reset by every call, so they always describe the last processed point cloud.
+         * @param enabled true to fill stats() by the vectorization calls.
+         */
+        void setStatsEnabled(bool enabled) { stats_enabled = enabled; }
+
+        //! Per-stage statistics of the last vectorization call.
+        /*!
+         * All counters are zero unless enabled by setStatsEnabled().
+         * @return reference to internal statistics.
+         */
+        [[nodiscard]] const VectorizationStats& stats() const { return int_workspace.stats(); }
+
+        //! Functor call for vectorization of an ordered point cloud.
+        /*!
+         * Process \p pts and generates output into the internal workspace.
+         * @param pts ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(Span<const VectorType> pts) { return (*this)(pts, int_workspace); }
 
         //! Functor call for vectorization of an ordered point cloud.
         /*!
-         * Process \p pts and generates output into internal buffers.
+         * Process \p pts and generates output into \p ws. The vectorizer is not modified, so it can be called concurrently with different workspaces.
          * @param pts ordered point cloud.
+         * @param ws workspace receiving the results.
          * @return true on success, false otherwise.
          */
-        bool operator()(const std::vector<VectorType> &pts)
+        bool operator()(Span<const VectorType> pts, Workspace &ws) const
         {
-            array.precompute(pts);
-            if(!extractor(array, int_lines, int_indices))
+            RTL_ZONE("rtl::VectorizerAFTLSPlaneProjections3D");
+            RTL_COUNT("rtl::VectorizerAFTLSPlaneProjections3D::points", pts.size());
+            VectorizationStats *stats = startStats(ws, pts.size());
+            configure(ws);
+            ws.array.precompute(pts);
+            if(!ws.extractor(ws.array, ws.int_lines, ws.int_indices, stats))
                 return false;
-            if(!optimizer_total_error(pts, array, int_lines, int_indices))
+            if(!ws.optimizer_total_error(pts, ws.array, ws.int_lines, ws.int_indices, stats))
                 return false;
-            return postprocessor(pts, int_lines, int_indices);
+            return ws.postprocessor(pts, ws.int_lines, ws.int_indices);
         }
 
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into an internal buffer first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts) { return (*this)(pts, int_workspace); }
+
+        //! Functor call for vectorization of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into a buffer of \p ws first, see StridedSpan::span().
+         * @param pts view of the ordered point cloud.
+         * @param ws workspace receiving the results.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts, Workspace &ws) const { return (*this)(pts.span(ws.packed_pts), ws); }
+
     private:
-        PrecArrayType array;
-        ExtractorChainFast<PrecArrayType, ApproximationType> extractor;
-        OptimizerTotalError<PrecArrayType, ApproximationType> optimizer_total_error;
-        PostprocessorProjectEndpoints<ApproximationType> postprocessor;
+        //! Resets the statistics of \p ws and returns them if enabled, nullptr otherwise.
+        VectorizationStats *startStats(Workspace &ws, size_t points) const
+        {
+            ws.int_stats.reset();
+            if (!stats_enabled)
+                return nullptr;
+            ws.int_stats.points = points;
+            return &ws.int_stats;
+        }
+
+        //! Applies the settings of *this to the processing stages of \p ws.
+        void configure(Workspace &ws) const
+        {
+            ws.extractor.setSigma(int_sigma);
+            ws.optimizer_total_error.setSimplexShift(int_simplex_shift);
+            ws.optimizer_total_error.setMaxIterations(int_max_iterations);
+            ws.array.setCompensatedSummation(compensated_summation);
+            ws.array.setCenteredBlocks(centered_blocks);
+        }
+
+        Workspace int_workspace;
+        ElementType int_sigma{};
+        size_t int_simplex_shift{1};
+        size_t int_max_iterations{10000};
+        bool compensated_summation{false};
+        size_t centered_blocks{0};
+        bool stats_enabled{false};
+    };
+
+    //! Plane extracting vectorizer for organized point clouds.
+    /*!
+     * Vectorizer for extraction of total-least-squares plane approximations from organized (image-like) point clouds, such as depth images or lidar range images.
+     * The summed-area table of precomputed sums makes the plane fit of any rectangular patch or region constant in time, the quadtree extractor splits the grid
+     * into planar patches and merges them into regions, which are finally trimmed to polygons by their outlines.
+     * @tparam Element type for data element storage.
+     * @tparam Compute type for precise computations.
+     */
+    template <typename Element, typename Compute>
+    class VectorizerQuadtreePlanes3D
+    {
+    public:
+        typedef Element ElementType;                                //!< Type for data element storage.
+        typedef Compute ComputeType;                                //!< Type for precise computations.
+        typedef Vector3D<ElementType> VectorType;                   //!< VectorND specialization for internal data.
+        typedef Polygon3D<ElementType> OutputType;                  //!< Type of output geometrical object.
+        typedef PrecGrid3D<ElementType, ComputeType> PrecGridType;  //!< PrecGrid3D specialization.
+        typedef ApproximationTlsPlane3D<ElementType, ComputeType> ApproximationType;     //!< Approximation type.
+
+        //! Buffers and results of a single vectorization, see operator()(Span<const VectorType>, Workspace &) const.
+        /*!
+         * The workspace holds all data modified by the vectorization, while the vectorizer itself keeps only the settings. A configured vectorizer can therefore be shared
+         * by many threads, each of them processing its inputs in its own workspace, and the buffers of the workspaces are reused by subsequent calls.
+         */
+        class Workspace
+        {
+        public:
+            //! Extracted approximations.
+            [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_planes; }
+
+            //! Extracted polygons.
+            [[nodiscard]] const std::vector<OutputType>& polygons() const { return postprocessor.output(); }
+
+            //! Index of the extracted plane for each cell of the grid.
+            [[nodiscard]] const std::vector<size_t>& labels() const { return int_labels; }
+
+            //! Per-stage statistics of the last vectorization call.
+            [[nodiscard]] const VectorizationStats& stats() const { return int_stats; }
+
+        private:
+            friend class VectorizerQuadtreePlanes3D;
+
+            PrecGridType grid;
+            ExtractorPlaneQuadtree<PrecGridType, ApproximationType> extractor;
+            PostprocessorGridOutline<ApproximationType> postprocessor;
+
+            std::vector<ApproximationType> int_planes;
+            std::vector<size_t> int_labels;
+            std::vector<VectorType> packed_pts;
+            VectorizationStats int_stats;
+        };
+
+        //! Default constructor.
+        VectorizerQuadtreePlanes3D() = default;
+
+        //! Default destructor.
+        ~VectorizerQuadtreePlanes3D() = default;
+
+        //! Sets maximal permitted standard deviation of point-approximation distances.
+        /*!
+         *
+         * @param sigma new standard deviation.
+         */
+        void setSigma(ElementType sigma) { int_sigma = sigma; }
+
+        //! Sets the size of the smallest patches of the quadtree.
+        /*!
+         *
+         * @param side number of rows and columns of the smallest patch.
+         */
+        void setMinPatch(size_t side) { min_patch = side; }
+
+        //! Sets the minimal number of points of an extracted plane.
+        /*!
+         *
+         * @param pts number of valid points.
+         */
+        void setMinPoints(size_t pts) { min_points = pts; }
+
+        //! Extracted plane approximations.
+        /*!
+         *
+         * @return reference to internal buffer of extracted approximations.
+         */
+        [[nodiscard]] const std::vector<ApproximationType>& approximations() const { return int_workspace.approximations(); }
+
+        //! Extracted polygons.
+        /*!
+         *
+         * @return reference to internal buffer of extracted polygons.
+         */
+        [[nodiscard]] const std::vector<OutputType>& polygons() const { return int_workspace.polygons(); }
+
+        //! Index of the extracted plane for each cell of the grid.
+        /*!
+         *
+         * @return reference to internal buffer of row-major labels, ExtractorPlaneQuadtree::unassigned for cells outside all planes.
+         */
+        [[nodiscard]] const std::vector<size_t>& labels() const { return int_workspace.labels(); }
+
+        //! Enables or disables collection of per-stage statistics.
+        /*!
+         * Disabled by default. The statistics are reset by every call, so they always describe the last processed point cloud.
+         * @param enabled true to fill stats() by the vectorization calls.
+         */
+        void setStatsEnabled(bool enabled) { stats_enabled = enabled; }
+
+        //! Per-stage statistics of the last vectorization call.
+        /*!
+         * All counters are zero unless enabled by setStatsEnabled().
+         * @return reference to internal statistics.
+         */
+        [[nodiscard]] const VectorizationStats& stats() const { return int_workspace.stats(); }
+
+        //! Functor call for vectorization of an organized point cloud.
+        /*!
+         * Process \p pts and generates output into the internal workspace. Points with non-finite coordinates are treated as missing.
+         * @param pts row-major grid of points with \p rows * \p cols elements.
+         * @param rows number of rows of the grid.
+         * @param cols number of columns of the grid.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(Span<const VectorType> pts, size_t rows, size_t cols) { return (*this)(pts, rows, cols, int_workspace); }
+
+        //! Functor call for vectorization of an organized point cloud.
+        /*!
+         * Process \p pts and generates output into \p ws. The vectorizer is not modified, so it can be called concurrently with different workspaces. Points with non-finite coordinates are treated as missing.
+         * @param pts row-major grid of points with \p rows * \p cols elements.
+         * @param rows number of rows of the grid.
+         * @param cols number of columns of the grid.
+         * @param ws workspace receiving the results.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(Span<const VectorType> pts, size_t rows, size_t cols, Workspace &ws) const
+        {
+            RTL_ZONE("rtl::VectorizerQuadtreePlanes3D");
+            RTL_COUNT("rtl::VectorizerQuadtreePlanes3D::points", pts.size());
+            VectorizationStats *stats = startStats(ws, pts.size());
+            configure(ws);
+            if (pts.size() < rows * cols)
+                return false;
+            ws.grid.precompute(pts, rows, cols);
+            if (!ws.extractor(ws.grid, ws.int_planes, ws.int_labels, stats))
+                return false;
+            return ws.postprocessor(pts, rows, cols, ws.int_planes, ws.int_labels);
+        }
+
+        //! Functor call for vectorization of an organized point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into an internal buffer first, see StridedSpan::span().
+         * @param pts view of the row-major grid of points with \p rows * \p cols elements.
+         * @param rows number of rows of the grid.
+         * @param cols number of columns of the grid.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts, size_t rows, size_t cols) { return (*this)(pts, rows, cols, int_workspace); }
+
+        //! Functor call for vectorization of an organized point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into a buffer of \p ws first, see StridedSpan::span().
+         * @param pts view of the row-major grid of points with \p rows * \p cols elements.
+         * @param rows number of rows of the grid.
+         * @param cols number of columns of the grid.
+         * @param ws workspace receiving the results.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(StridedSpan<const VectorType> pts, size_t rows, size_t cols, Workspace &ws) const { return (*this)(pts.span(ws.packed_pts), rows, cols, ws); }
+
+    private:
+        //! Resets the statistics of \p ws and returns them if enabled, nullptr otherwise.
+        VectorizationStats *startStats(Workspace &ws, size_t points) const
+        {
+            ws.int_stats.reset();
+            if (!stats_enabled)
+                return nullptr;
+            ws.int_stats.points = points;
+            return &ws.int_stats;
+        }
+
+        //! Applies the settings of *this to the processing stages of \p ws.
+        void configure(Workspace &ws) const
+        {
+            ws.extractor.setSigma(int_sigma);
+            ws.extractor.setMinPatch(min_patch);
+            ws.extractor.setMinPoints(min_points);
+        }
 
-        std::vector<ApproximationType> int_lines;
-        std::vector<IndexType> int_indices;
+        Workspace int_workspace;
+        ElementType int_sigma{};
+        size_t min_patch{4};
+        size_t min_points{64};
+        bool stats_enabled{false};
     };
 
     using VectorizerDouglasPeucker2f = VectorizerDouglasPeuckerND<2, float>;
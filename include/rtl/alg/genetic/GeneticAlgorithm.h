@@ -27,6 +27,21 @@
 #ifndef ROBOTICTEMPLATELIBRARY_GENETICALGORITHM_H
 #define ROBOTICTEMPLATELIBRARY_GENETICALGORITHM_H
 
+#include <vector>
+#include <memory>
+#include <random>
+#include <cstddef>
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+#include <atomic>
+#include <mutex>
+#include <memory_resource>
+
+#include "rtl/core/Executor.h"
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/RandomStream.h"
+
 namespace rtl
 {
     //! Genetic Algorithm Implementation
@@ -41,6 +56,13 @@ namespace rtl
      * 6] Mutation. Select P agents and mutate them
      * 7] get results and go back to 2
      *
+     * The selection runs on an internal generator, which can be seeded by seed() for reproducible runs. If the AgentType provides
+     * static random(Engine&) and mutate(Engine&) taking a UniformRandomBitGenerator, they are fed by the same generator and the whole evolution is deterministic.
+     * The initial population is drawn by a single call of static random(Span<AgentType>, Engine&) if the AgentType is default constructible and provides it as well.
+     *
+     * Alternatively, iterate_steady_state() evolves the population without the epoch barrier: workers of the executor continuously breed, evaluate and insert
+     * individual offspring, so a slow evaluation of one agent does not stall the others.
+     *
      * The GA is specified by following arguments:
      *
      * @tparam AgentType data type of agent
@@ -48,15 +70,24 @@ namespace rtl
      * @tparam surviving_elites Number of best agents that survive epoch
      * @tparam surviving_total Number of agents that survives epoch (elites + randomly selected)
      * @tparam mutations_per_epoch Number of mutatons in epoch
+     * @tparam Executor execution policy of the agents evaluation, see rtl/core/Executor.h. AgentType::score() must be safe to call concurrently on different agents for parallel executors.
+     * @tparam Allocator allocator of the population buffers, rebound to their element types. Both buffers keep their capacity between epochs.
      */
-    template<typename AgentType, size_t agents_in_epoch, size_t surviving_elites, size_t surviving_total, size_t mutations_per_epoch>
+    template<typename AgentType, size_t agents_in_epoch, size_t surviving_elites, size_t surviving_total, size_t mutations_per_epoch, class Executor = SequentialExecutor,
+             class Allocator = std::allocator<std::byte>>
     class GeneticAlgorithm {
 
         static_assert(agents_in_epoch > surviving_total);
         static_assert(surviving_elites < surviving_total);
 
+        using AgentAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<AgentType>;
+        using ScoreAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<float>;
+        using IndexAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<size_t>;
+
     public:
 
+        typedef RandomStreams::EngineType EngineType;
+
         /*!
          * Generates the initial random population
          */
@@ -64,10 +95,43 @@ namespace rtl
             init();
         }
 
+        /*!
+         * Generates the initial random population, agents are evaluated by the given executor
+         *
+         * @param executor Executor used for parallel evaluation of agents.
+         */
+        explicit GeneticAlgorithm(Executor executor) : executor_{std::move(executor)} {
+            init();
+        }
+
+        /*!
+         * Generates the initial random population, agents are evaluated by the given executor and stored in buffers obtained from the given allocator
+         *
+         * @param executor Executor used for parallel evaluation of agents.
+         * @param alloc Allocator of the population buffers.
+         */
+        GeneticAlgorithm(Executor executor, const Allocator& alloc)
+                : agents_(AgentAllocator(alloc)), next_epoch_agents_(AgentAllocator(alloc)), scores_(ScoreAllocator(alloc)), order_(IndexAllocator(alloc)), executor_{std::move(executor)} {
+            init();
+        }
+
+        /*!
+         * Seeds the internal generator and generates a new initial population from it
+         *
+         * @param seed - common seed of the random streams
+         * @param stream - index of the random stream used by this instance, distinct instances running in parallel should use distinct streams
+         */
+        void seed(uint64_t seed, size_t stream = 0) {
+            engine_ = RandomStreams(seed).stream(stream);
+            agents_.clear();
+            generate_agents();
+        }
+
         /*!
          * Iterates entire epoch evaluation-selection-reproduction-mutation
          */
         void iterate_epoch() {
+            RTL_ZONE("rtl::GeneticAlgorithm::iterate_epoch");
             next_epoch_agents_.clear();
             next_epoch_agents_.reserve(agents_in_epoch);
 
@@ -76,7 +140,39 @@ namespace rtl
             reproduction();
             mutation();
 
-            agents_ = next_epoch_agents_;
+            agents_.swap(next_epoch_agents_);
+        }
+
+        /*!
+         * Steady-state evolution without the epoch barrier
+         *
+         * Each worker of the executor repeatedly selects two parents by tournaments, crosses them over, mutates the child with probability
+         * mutations_per_epoch / agents_in_epoch, evaluates it and lets it replace the loser of a reverse tournament if the child is not worse. The population
+         * slots are locked individually only for copying the parents and for the replacement, evaluation runs unlocked, so workers do not wait for each other.
+         * The best agent is never replaced by a worse one. The current population is evaluated at the beginning of each call.
+         * With a parallel executor the result depends on the timing of the workers, a sequential executor makes it reproducible by seed().
+         *
+         * @param evaluations - number of offspring evaluated (and possibly inserted) in total by all workers
+         * @param tournament_size - number of randomly drawn agents in each tournament, higher values increase the selection pressure
+         */
+        void iterate_steady_state(size_t evaluations, size_t tournament_size = 2) {
+            RTL_ZONE("rtl::GeneticAlgorithm::iterate_steady_state");
+            tournament_size = std::max<size_t>(tournament_size, 1);
+            executor_(0, agents_.size(), [this](size_t begin, size_t end) {
+                for (size_t i = begin ; i < end ; i++) {
+                    scores_[i] = agents_[i].score();
+                }
+            });
+
+            size_t workers = std::max<size_t>(executor_.concurrency(), 1);
+            RandomStreams(engine_()).streams(workers, worker_engines_);
+            std::atomic<size_t> started{0};
+
+            executor_(0, workers, [&](size_t begin, size_t end) {
+                for (size_t w = begin ; w < end ; w++) {
+                    steady_state_worker(worker_engines_[w], started, evaluations, tournament_size);
+                }
+            });
         }
 
         /*!
@@ -86,8 +182,42 @@ namespace rtl
          */
         AgentType best_agent(size_t n = 0) {
             agents_evaluation();
-            sort_agents();
-            return agents_.at(n).first;
+            sort_agents(n + 1);
+            return agents_.at(order_.at(n));
+        }
+
+        /*!
+         * Returns N best agents from the current epoch, ordered from the best one
+         *
+         * @param n - number of agents
+         */
+        std::vector<AgentType> best_agents(size_t n) {
+            n = std::min(n, agents_.size());
+            agents_evaluation();
+            sort_agents(n);
+            std::vector<AgentType> output;
+            output.reserve(n);
+            for (size_t i = 0 ; i < n ; i++) {
+                output.push_back(agents_[order_[i]]);
+            }
+            return output;
+        }
+
+        /*!
+         * Replaces the worst agents of the current epoch by the given ones (e.g. migrants from another population)
+         *
+         * @param agents - new agents, at most agents_in_epoch - 1 of them are used
+         */
+        void replace_worst(const std::vector<AgentType>& agents) {
+            size_t n = std::min(agents.size(), agents_.size() - 1);
+            agents_evaluation();
+            order_.resize(agents_.size());
+            std::iota(order_.begin(), order_.end(), 0);
+            std::nth_element(order_.begin(), order_.end() - n, order_.end(), [this](size_t a, size_t b) { return better_agent(a, b); });
+            for (size_t i = 0 ; i < n ; i++) {
+                agents_[order_[order_.size() - n + i]] = agents[i];
+                scores_[order_[order_.size() - n + i]] = 0.0f;
+            }
         }
 
     private:
@@ -97,12 +227,31 @@ namespace rtl
          * */
         void init() {
             std::random_device r;
-            engine_ = std::default_random_engine(r());
+            engine_.seed(r());
             distribution_ = std::uniform_real_distribution<float>(0, 1);
+            next_epoch_agents_.reserve(agents_in_epoch);
+            order_.reserve(agents_in_epoch);
+            slot_mutexes_ = std::make_unique<std::mutex[]>(agents_in_epoch);
+            generate_agents();
+        }
 
+        /*!
+         * Fills the population by random agents, default constructible agents with bulk random() are overwritten in place by a single call
+         * */
+        void generate_agents() {
+            scores_.assign(agents_in_epoch, 0.0f);
+            if constexpr (has_seeded_random_v<AgentType, EngineType> && has_bulk_random_v<AgentType, EngineType> && std::is_default_constructible_v<AgentType>) {
+                agents_.resize(agents_in_epoch);
+                AgentType::random(Span<AgentType>(agents_.data(), agents_.size()), engine_);
+                return;
+            }
             agents_.reserve(agents_in_epoch);
             for (size_t i = 0 ; i < agents_in_epoch ; i++) {
-                agents_.push_back({AgentType::random(), 0.0f});
+                if constexpr (has_seeded_random_v<AgentType, EngineType>) {
+                    agents_.push_back(AgentType::random(engine_));
+                } else {
+                    agents_.push_back(AgentType::random());
+                }
             }
         }
 
@@ -110,15 +259,17 @@ namespace rtl
          * Evaluates current population, estimates score for each agent
          * */
         void agents_evaluation() {
-            float cum_sum = 0.0f;
+            RTL_ZONE("rtl::GeneticAlgorithm::agents_evaluation");
+            executor_(0, agents_.size(), [this](size_t begin, size_t end) {
+                for (size_t i = begin ; i < end ; i++) {
+                    scores_[i] = agents_[i].score();
+                }
+            });
 
-            for(auto& agent : agents_) {
-                float score = agent.first.score();
-                agent.second = score;
-                cum_sum += score;
-            }
+            float cum_sum = 0.0f;
+            for(float score : scores_) {cum_sum += score;}
 
-            for(auto& agent : agents_) {agent.second /= cum_sum;}
+            for(float& score : scores_) {score /= cum_sum;}
         }
 
         /*!
@@ -134,19 +285,27 @@ namespace rtl
          * Select N best agents from current population, that will survive to the next epoch
          * */
         void select_elites() {
-            sort_agents();
+            sort_agents(surviving_elites);
             for (size_t i = 0 ; i < surviving_elites ; i+=1) {
-                next_epoch_agents_.push_back(agents_.at(i));
+                next_epoch_agents_.push_back(agents_.at(order_.at(i)));
             }
         }
 
         /*!
-         * Sort agents w.r.t. their score
+         * Moves indices of N agents with the highest score to the front of order_, ordered w.r.t. their score. Order of the remaining indices is unspecified.
          * */
-        void sort_agents() {
-            sort(agents_.begin(), agents_.end(), [](const std::pair<AgentType, float>& a, const std::pair<AgentType, float>& b) -> bool {
-                return a.second > b.second;
-            });
+        void sort_agents(size_t n) {
+            order_.resize(agents_.size());
+            std::iota(order_.begin(), order_.end(), 0);
+            n = std::min(n, agents_.size());
+            if (n == 0) { return; }
+            auto better = [this](size_t a, size_t b) { return better_agent(a, b); };
+            std::nth_element(order_.begin(), order_.begin() + n - 1, order_.end(), better);
+            std::sort(order_.begin(), order_.begin() + n - 1, better);
+        }
+
+        bool better_agent(size_t a, size_t b) const {
+            return scores_[a] > scores_[b];
         }
 
         /*!
@@ -165,7 +324,12 @@ namespace rtl
         void mutation() {
             for (size_t i = 0 ; i < mutations_per_epoch ; i+=1) {
                 // do not mutate the best agent
-                next_epoch_agents_.at(get_random_index(next_epoch_agents_.size()-1)+1).first.mutate();
+                auto& agent = next_epoch_agents_.at(get_random_index(next_epoch_agents_.size()-1)+1);
+                if constexpr (has_seeded_mutate_v<AgentType, EngineType>) {
+                    agent.mutate(engine_);
+                } else {
+                    agent.mutate();
+                }
             }
         }
 
@@ -176,7 +340,64 @@ namespace rtl
             for (size_t i = next_epoch_agents_.size(); i < agents_in_epoch; i += 1) {
                 auto rand_index_1 = get_random_index(agents_.size());
                 auto rand_index_2 = get_random_index(agents_.size());
-                next_epoch_agents_.push_back({agents_.at(rand_index_1).first.crossover(agents_.at(rand_index_2).first), 0.0f});
+                next_epoch_agents_.push_back(agents_.at(rand_index_1).crossover(agents_.at(rand_index_2)));
+            }
+        }
+
+        /*!
+         * Breeds and inserts offspring until the shared counter of evaluations reaches the limit
+         * */
+        void steady_state_worker(EngineType& engine, std::atomic<size_t>& started, size_t evaluations, size_t tournament_size) {
+            std::uniform_int_distribution<size_t> index_distribution(0, agents_.size() - 1);
+            std::uniform_real_distribution<float> mutation_distribution(0, 1);
+            const float mutation_probability = static_cast<float>(mutations_per_epoch) / static_cast<float>(agents_in_epoch);
+
+            // sign of the score comparison selects the best (1) or the worst (-1) of the drawn agents
+            auto tournament = [&](float sign) {
+                size_t winner = index_distribution(engine);
+                float winner_score;
+                {
+                    std::lock_guard<std::mutex> lock(slot_mutexes_[winner]);
+                    winner_score = scores_[winner];
+                }
+                for (size_t t = 1 ; t < tournament_size ; t++) {
+                    size_t candidate = index_distribution(engine);
+                    float candidate_score;
+                    {
+                        std::lock_guard<std::mutex> lock(slot_mutexes_[candidate]);
+                        candidate_score = scores_[candidate];
+                    }
+                    if (sign * candidate_score > sign * winner_score) {
+                        winner = candidate;
+                        winner_score = candidate_score;
+                    }
+                }
+                return winner;
+            };
+            auto copy_agent = [&](size_t index) {
+                std::lock_guard<std::mutex> lock(slot_mutexes_[index]);
+                return agents_[index];
+            };
+
+            while (started.fetch_add(1, std::memory_order_relaxed) < evaluations) {
+                AgentType parent_1 = copy_agent(tournament(1.0f));
+                AgentType parent_2 = copy_agent(tournament(1.0f));
+                AgentType child = parent_1.crossover(parent_2);
+                if (mutation_distribution(engine) < mutation_probability) {
+                    if constexpr (has_seeded_mutate_v<AgentType, EngineType>) {
+                        child.mutate(engine);
+                    } else {
+                        child.mutate();
+                    }
+                }
+                float score = child.score();
+
+                size_t loser = tournament(-1.0f);
+                std::lock_guard<std::mutex> lock(slot_mutexes_[loser]);
+                if (score >= scores_[loser]) {
+                    agents_[loser] = std::move(child);
+                    scores_[loser] = score;
+                }
             }
         }
 
@@ -187,12 +408,24 @@ namespace rtl
             return static_cast<size_t>(distribution_(engine_) * static_cast<float>(range-1));
         }
 
-        std::vector<std::pair<AgentType, float>> agents_;
-        std::vector<std::pair<AgentType, float>> next_epoch_agents_;
+        std::vector<AgentType, AgentAllocator> agents_;
+        std::vector<AgentType, AgentAllocator> next_epoch_agents_;
+        std::vector<float, ScoreAllocator> scores_;
+        std::vector<size_t, IndexAllocator> order_;
+        std::unique_ptr<std::mutex[]> slot_mutexes_;
 
-        std::default_random_engine engine_;
+        EngineType engine_;
+        std::vector<EngineType> worker_engines_;
         std::uniform_real_distribution<float> distribution_;
+        Executor executor_;
     };
+
+    namespace pmr {
+        //! GeneticAlgorithm allocating its population buffers from a std::pmr::memory_resource.
+        template<typename AgentType, size_t agents_in_epoch, size_t surviving_elites, size_t surviving_total, size_t mutations_per_epoch, class Executor = SequentialExecutor>
+        using GeneticAlgorithm = rtl::GeneticAlgorithm<AgentType, agents_in_epoch, surviving_elites, surviving_total, mutations_per_epoch, Executor,
+                                                       std::pmr::polymorphic_allocator<std::byte>>;
+    }
 }
 
 #endif //ROBOTICTEMPLATELIBRARY_GENETICALGORITHM_H
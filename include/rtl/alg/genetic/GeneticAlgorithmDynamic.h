@@ -0,0 +1,403 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Adam Ligocki <adam.ligocki@vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_GENETICALGORITHMDYNAMIC_H
+#define ROBOTICTEMPLATELIBRARY_GENETICALGORITHMDYNAMIC_H
+
+#include <vector>
+#include <memory>
+#include <random>
+#include <cstddef>
+#include <numeric>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <memory_resource>
+#include <type_traits>
+#include <experimental/type_traits>
+
+#include "rtl/core/Executor.h"
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/RandomStream.h"
+
+namespace rtl
+{
+    template<typename T>
+    using InPlaceCrossoverResult = decltype(std::declval<const T &>().crossover(std::declval<const T &>(), std::declval<T &>()));
+
+    //! Tests whether the agent type \p T provides crossover(const T &mate, T &offspring) const writing the offspring into an existing agent.
+    template<typename T>
+    constexpr bool has_in_place_crossover_v = std::experimental::is_detected<InPlaceCrossoverResult, T>::value;
+
+    //! Genetic Algorithm with the population size and selection parameters given at runtime
+    /*!
+     * Runtime-sized counterpart of rtl::GeneticAlgorithm with the same phases of the epoch, the same agent interface and the same steady-state mode.
+     * The parameters can be changed by configure() without recompiling, e.g. while tuning the population size.
+     *
+     * The population lives in two buffers of agents_in_epoch agents allocated by configure(). An epoch writes the next generation over the agents of the second
+     * buffer and swaps the buffers afterwards, scores are kept in a separate array and the elites are tracked by sorting an array of indices, so no agent is moved
+     * around. If the AgentType provides crossover(const AgentType &mate, AgentType &offspring) const, the offspring is written in place as well, otherwise it is
+     * assigned from the returned agent. The steady-state workers breed into their own preallocated offspring and swap it into the population. With agents
+     * not allocating by themselves (e.g. SimpleAgent), the epochs and the steady-state evolution on a sequential executor do not allocate any memory.
+     *
+     * @tparam AgentType data type of agent, has to be copy-constructible.
+     * @tparam Executor execution policy of the agents evaluation, see rtl/core/Executor.h. AgentType::score() must be safe to call concurrently on different agents for parallel executors.
+     * @tparam Allocator allocator of the population buffers, rebound to their element types.
+     */
+    template<typename AgentType, class Executor = SequentialExecutor, class Allocator = std::allocator<std::byte>>
+    class GeneticAlgorithmDynamic {
+
+        using AgentAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<AgentType>;
+        using ScoreAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<float>;
+        using IndexAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<size_t>;
+
+    public:
+
+        typedef RandomStreams::EngineType EngineType;
+
+        /*!
+         * Generates the initial random population
+         *
+         * @param agents_in_epoch - number of agents at the beginning of each epoch
+         * @param surviving_elites - number of best agents that survive epoch
+         * @param surviving_total - number of agents that survives epoch (elites + randomly selected)
+         * @param mutations_per_epoch - number of mutations in epoch
+         * @param executor - executor used for parallel evaluation of agents
+         * @param alloc - allocator of the population buffers
+         */
+        GeneticAlgorithmDynamic(size_t agents_in_epoch, size_t surviving_elites, size_t surviving_total, size_t mutations_per_epoch, Executor executor = Executor(),
+                                const Allocator& alloc = Allocator())
+                : agents_(AgentAllocator(alloc)), next_agents_(AgentAllocator(alloc)), scores_(ScoreAllocator(alloc)), order_(IndexAllocator(alloc)),
+                  offspring_(AgentAllocator(alloc)), executor_{std::move(executor)} {
+            std::random_device r;
+            engine_.seed(r());
+            configure(agents_in_epoch, surviving_elites, surviving_total, mutations_per_epoch);
+        }
+
+        /*!
+         * Changes the parameters of the evolution and generates a new initial population, reallocates the buffers only if they grow
+         *
+         * @param agents_in_epoch - number of agents at the beginning of each epoch
+         * @param surviving_elites - number of best agents that survive epoch, lower than surviving_total
+         * @param surviving_total - number of agents that survives epoch (elites + randomly selected), lower than agents_in_epoch
+         * @param mutations_per_epoch - number of mutations in epoch
+         */
+        void configure(size_t agents_in_epoch, size_t surviving_elites, size_t surviving_total, size_t mutations_per_epoch) {
+            if (agents_in_epoch <= surviving_total || surviving_total <= surviving_elites) {
+                throw std::invalid_argument("GeneticAlgorithmDynamic: parameters must satisfy surviving_elites < surviving_total < agents_in_epoch.");
+            }
+            agents_in_epoch_ = agents_in_epoch;
+            surviving_elites_ = surviving_elites;
+            surviving_total_ = surviving_total;
+            mutations_per_epoch_ = mutations_per_epoch;
+            if (slot_mutexes_size_ < agents_in_epoch) {
+                slot_mutexes_ = std::make_unique<std::mutex[]>(agents_in_epoch);
+                slot_mutexes_size_ = agents_in_epoch;
+            }
+            generate_agents();
+        }
+
+        /*!
+         * Seeds the internal generator and generates a new initial population from it
+         *
+         * @param seed - common seed of the random streams
+         * @param stream - index of the random stream used by this instance, distinct instances running in parallel should use distinct streams
+         */
+        void seed(uint64_t seed, size_t stream = 0) {
+            engine_ = RandomStreams(seed).stream(stream);
+            generate_agents();
+        }
+
+        //! Number of agents at the beginning of each epoch.
+        [[nodiscard]] size_t agents_in_epoch() const { return agents_in_epoch_; }
+
+        //! Number of best agents that survive epoch.
+        [[nodiscard]] size_t surviving_elites() const { return surviving_elites_; }
+
+        //! Number of agents that survives epoch.
+        [[nodiscard]] size_t surviving_total() const { return surviving_total_; }
+
+        //! Number of mutations in epoch.
+        [[nodiscard]] size_t mutations_per_epoch() const { return mutations_per_epoch_; }
+
+        /*!
+         * Iterates entire epoch evaluation-selection-reproduction-mutation
+         */
+        void iterate_epoch() {
+            RTL_ZONE("rtl::GeneticAlgorithmDynamic::iterate_epoch");
+            agents_evaluation();
+            sort_agents(surviving_elites_);
+
+            std::uniform_int_distribution<size_t> index_distribution(0, agents_in_epoch_ - 1);
+            for (size_t i = 0 ; i < surviving_elites_ ; i++) {
+                next_agents_[i] = agents_[order_[i]];
+            }
+            for (size_t i = surviving_elites_ ; i < surviving_total_ ; i++) {
+                next_agents_[i] = agents_[index_distribution(engine_)];
+            }
+            for (size_t i = surviving_total_ ; i < agents_in_epoch_ ; i++) {
+                breed(agents_[index_distribution(engine_)], agents_[index_distribution(engine_)], next_agents_[i]);
+            }
+
+            // do not mutate the best agent
+            std::uniform_int_distribution<size_t> mutation_distribution(1, agents_in_epoch_ - 1);
+            for (size_t i = 0 ; i < mutations_per_epoch_ ; i++) {
+                mutate(next_agents_[mutation_distribution(engine_)], engine_);
+            }
+
+            agents_.swap(next_agents_);
+            evaluated_ = false;
+        }
+
+        /*!
+         * Steady-state evolution without the epoch barrier, see GeneticAlgorithm::iterate_steady_state()
+         *
+         * Unlike GeneticAlgorithm, the population is evaluated only if it changed by an epoch or a replacement since the last evaluation.
+         *
+         * @param evaluations - number of offspring evaluated (and possibly inserted) in total by all workers
+         * @param tournament_size - number of randomly drawn agents in each tournament, higher values increase the selection pressure
+         */
+        void iterate_steady_state(size_t evaluations, size_t tournament_size = 2) {
+            RTL_ZONE("rtl::GeneticAlgorithmDynamic::iterate_steady_state");
+            tournament_size = std::max<size_t>(tournament_size, 1);
+            agents_evaluation();
+
+            size_t workers = std::max<size_t>(executor_.concurrency(), 1);
+            RandomStreams(engine_()).streams(workers, worker_engines_);
+            if (offspring_.size() < workers) {
+                offspring_.resize(workers, agents_.front());
+            }
+            std::atomic<size_t> started{0};
+
+            executor_(0, workers, [&](size_t begin, size_t end) {
+                for (size_t w = begin ; w < end ; w++) {
+                    steady_state_worker(worker_engines_[w], offspring_[w], started, evaluations, tournament_size);
+                }
+            });
+        }
+
+        /*!
+         * Returns N-th best agent from the current epoch
+         *
+         * @param n - N-th best agent
+         */
+        AgentType best_agent(size_t n = 0) {
+            agents_evaluation();
+            sort_agents(n + 1);
+            return agents_.at(order_.at(n));
+        }
+
+        /*!
+         * Returns N best agents from the current epoch, ordered from the best one
+         *
+         * @param n - number of agents
+         */
+        std::vector<AgentType> best_agents(size_t n) {
+            n = std::min(n, agents_.size());
+            agents_evaluation();
+            sort_agents(n);
+            std::vector<AgentType> output;
+            output.reserve(n);
+            for (size_t i = 0 ; i < n ; i++) {
+                output.push_back(agents_[order_[i]]);
+            }
+            return output;
+        }
+
+        /*!
+         * Replaces the worst agents of the current epoch by the given ones (e.g. migrants from another population)
+         *
+         * @param agents - new agents, at most agents_in_epoch - 1 of them are used
+         */
+        void replace_worst(const std::vector<AgentType>& agents) {
+            size_t n = std::min(agents.size(), agents_.size() - 1);
+            agents_evaluation();
+            std::iota(order_.begin(), order_.end(), 0);
+            std::nth_element(order_.begin(), order_.end() - n, order_.end(), [this](size_t a, size_t b) { return scores_[a] > scores_[b]; });
+            for (size_t i = 0 ; i < n ; i++) {
+                agents_[order_[agents_.size() - n + i]] = agents[i];
+            }
+            evaluated_ = false;
+        }
+
+    private:
+
+        /*!
+         * Fills the population by random agents, both buffers get agents_in_epoch agents
+         * */
+        void generate_agents() {
+            agents_.clear();
+            if constexpr (has_seeded_random_v<AgentType, EngineType> && has_bulk_random_v<AgentType, EngineType> && std::is_default_constructible_v<AgentType>) {
+                agents_.resize(agents_in_epoch_);
+                AgentType::random(Span<AgentType>(agents_.data(), agents_.size()), engine_);
+            } else {
+                for (size_t i = 0 ; i < agents_in_epoch_ ; i++) {
+                    if constexpr (has_seeded_random_v<AgentType, EngineType>) {
+                        agents_.push_back(AgentType::random(engine_));
+                    } else {
+                        agents_.push_back(AgentType::random());
+                    }
+                }
+            }
+            next_agents_.clear();
+            next_agents_.resize(agents_in_epoch_, agents_.front());
+            offspring_.clear();
+            scores_.resize(agents_in_epoch_);
+            order_.resize(agents_in_epoch_);
+            evaluated_ = false;
+        }
+
+        /*!
+         * Evaluates current population unless it is already evaluated
+         * */
+        void agents_evaluation() {
+            if (evaluated_) { return; }
+            RTL_ZONE("rtl::GeneticAlgorithmDynamic::agents_evaluation");
+            executor_(0, agents_.size(), [this](size_t begin, size_t end) {
+                for (size_t i = begin ; i < end ; i++) {
+                    scores_[i] = agents_[i].score();
+                }
+            });
+            evaluated_ = true;
+        }
+
+        /*!
+         * Moves indices of N agents with the highest score to the front of the order, sorted w.r.t. their score. Order of the remaining indices is unspecified.
+         * */
+        void sort_agents(size_t n) {
+            n = std::min(n, agents_.size());
+            std::iota(order_.begin(), order_.end(), 0);
+            if (n == 0) { return; }
+            auto better = [this](size_t a, size_t b) { return scores_[a] > scores_[b]; };
+            std::nth_element(order_.begin(), order_.begin() + n - 1, order_.end(), better);
+            std::sort(order_.begin(), order_.begin() + n - 1, better);
+        }
+
+        /*!
+         * Crosses the parents over into the given offspring
+         * */
+        static void breed(const AgentType& parent_1, const AgentType& parent_2, AgentType& offspring) {
+            if constexpr (has_in_place_crossover_v<AgentType>) {
+                parent_1.crossover(parent_2, offspring);
+            } else {
+                AgentType parent = parent_1;
+                offspring = parent.crossover(parent_2);
+            }
+        }
+
+        static void mutate(AgentType& agent, EngineType& engine) {
+            if constexpr (has_seeded_mutate_v<AgentType, EngineType>) {
+                agent.mutate(engine);
+            } else {
+                agent.mutate();
+            }
+        }
+
+        /*!
+         * Breeds and inserts offspring until the shared counter of evaluations reaches the limit
+         * */
+        void steady_state_worker(EngineType& engine, AgentType& child, std::atomic<size_t>& started, size_t evaluations, size_t tournament_size) {
+            std::uniform_int_distribution<size_t> index_distribution(0, agents_in_epoch_ - 1);
+            std::uniform_real_distribution<float> mutation_distribution(0, 1);
+            const float mutation_probability = static_cast<float>(mutations_per_epoch_) / static_cast<float>(agents_in_epoch_);
+
+            // sign of the score comparison selects the best (1) or the worst (-1) of the drawn agents
+            auto tournament = [&](float sign) {
+                size_t winner = index_distribution(engine);
+                float winner_score;
+                {
+                    std::lock_guard<std::mutex> lock(slot_mutexes_[winner]);
+                    winner_score = scores_[winner];
+                }
+                for (size_t t = 1 ; t < tournament_size ; t++) {
+                    size_t candidate = index_distribution(engine);
+                    float candidate_score;
+                    {
+                        std::lock_guard<std::mutex> lock(slot_mutexes_[candidate]);
+                        candidate_score = scores_[candidate];
+                    }
+                    if (sign * candidate_score > sign * winner_score) {
+                        winner = candidate;
+                        winner_score = candidate_score;
+                    }
+                }
+                return winner;
+            };
+
+            while (started.fetch_add(1, std::memory_order_relaxed) < evaluations) {
+                size_t parent_1 = tournament(1.0f), parent_2 = tournament(1.0f);
+                {
+                    // the slots are locked in the order of their indices, so the workers cannot deadlock
+                    std::unique_lock<std::mutex> lock_1(slot_mutexes_[std::min(parent_1, parent_2)]);
+                    std::unique_lock<std::mutex> lock_2;
+                    if (parent_1 != parent_2) {
+                        lock_2 = std::unique_lock<std::mutex>(slot_mutexes_[std::max(parent_1, parent_2)]);
+                    }
+                    breed(agents_[parent_1], agents_[parent_2], child);
+                }
+                if (mutation_distribution(engine) < mutation_probability) {
+                    mutate(child, engine);
+                }
+                float score = child.score();
+
+                size_t loser = tournament(-1.0f);
+                std::lock_guard<std::mutex> lock(slot_mutexes_[loser]);
+                if (score >= scores_[loser]) {
+                    std::swap(agents_[loser], child);
+                    scores_[loser] = score;
+                }
+            }
+        }
+
+        size_t agents_in_epoch_{0};
+        size_t surviving_elites_{0};
+        size_t surviving_total_{0};
+        size_t mutations_per_epoch_{0};
+
+        std::vector<AgentType, AgentAllocator> agents_;
+        std::vector<AgentType, AgentAllocator> next_agents_;
+        std::vector<float, ScoreAllocator> scores_;
+        std::vector<size_t, IndexAllocator> order_;
+        std::vector<AgentType, AgentAllocator> offspring_;
+        bool evaluated_{false};
+
+        std::unique_ptr<std::mutex[]> slot_mutexes_;
+        size_t slot_mutexes_size_{0};
+
+        EngineType engine_;
+        std::vector<EngineType> worker_engines_;
+        Executor executor_;
+    };
+
+    namespace pmr {
+        //! GeneticAlgorithmDynamic allocating its population buffers from a std::pmr::memory_resource.
+        template<typename AgentType, class Executor = SequentialExecutor>
+        using GeneticAlgorithmDynamic = rtl::GeneticAlgorithmDynamic<AgentType, Executor, std::pmr::polymorphic_allocator<std::byte>>;
+    }
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_GENETICALGORITHMDYNAMIC_H
@@ -0,0 +1,186 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Adam Ligocki <adam.ligocki@vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_GENETICISLANDS_H
+#define ROBOTICTEMPLATELIBRARY_GENETICISLANDS_H
+
+#include <vector>
+#include <algorithm>
+
+#include "rtl/core/Executor.h"
+#include "rtl/core/Instrumentation.h"
+#include "rtl/alg/genetic/GeneticAlgorithm.h"
+
+namespace rtl
+{
+    //! Island Model of Genetic Algorithm
+    /*!
+     * Several independent populations (islands) are evolved by GeneticAlgorithm, islands are processed in parallel
+     * by the given executor. After every migration interval, the best agents of each island replace the worst agents
+     * of the next island in a ring. Islands explore the search space independently in between, which keeps the
+     * diversity of the overall population higher than in a single large population.
+     *
+     * AgentType::random(), mutate(), crossover() and score() must be safe to call concurrently for parallel executors.
+     *
+     * @tparam AgentType data type of agent
+     * @tparam agents_in_epoch Number of agents at the beginning of each epoch on each island
+     * @tparam surviving_elites Number of best agents that survive epoch on each island
+     * @tparam surviving_total Number of agents that survives epoch on each island (elites + randomly selected)
+     * @tparam mutations_per_epoch Number of mutatons in epoch on each island
+     * @tparam Executor execution policy of the islands, see rtl/core/Executor.h.
+     */
+    template<typename AgentType, size_t agents_in_epoch, size_t surviving_elites, size_t surviving_total, size_t mutations_per_epoch, class Executor = SequentialExecutor>
+    class GeneticIslands {
+    public:
+
+        typedef GeneticAlgorithm<AgentType, agents_in_epoch, surviving_elites, surviving_total, mutations_per_epoch> IslandType;
+
+        /*!
+         * Generates initial random populations of all islands
+         *
+         * @param islands - number of islands
+         * @param migration_interval - number of epochs between migrations
+         * @param migrants - number of agents migrating from each island
+         * @param executor - executor used for parallel evolution of islands
+         */
+        GeneticIslands(size_t islands, size_t migration_interval, size_t migrants, Executor executor = Executor())
+                : islands_(std::max<size_t>(islands, 1)), migration_interval_{std::max<size_t>(migration_interval, 1)},
+                  migrants_{migrants}, executor_{std::move(executor)} {}
+
+        /*!
+         * Seeds all islands by independent random streams and generates new initial populations, the evolution is then reproducible regardless of the executor
+         *
+         * @param seed - common seed of all islands
+         */
+        void seed(uint64_t seed) {
+            for (size_t i = 0 ; i < islands_.size() ; i++) {
+                islands_[i].seed(seed, i);
+            }
+            epochs_since_migration_ = 0;
+        }
+
+        /*!
+         * Iterates given number of epochs on all islands, migrations are performed in between as scheduled
+         *
+         * @param epochs - number of epochs
+         */
+        void iterate_epochs(size_t epochs) {
+            while (epochs > 0) {
+                size_t step = std::min(epochs, migration_interval_ - epochs_since_migration_);
+                executor_(0, islands_.size(), [this, step](size_t begin, size_t end) {
+                    for (size_t i = begin ; i < end ; i++) {
+                        for (size_t e = 0 ; e < step ; e++) {
+                            islands_[i].iterate_epoch();
+                        }
+                    }
+                });
+                epochs -= step;
+                epochs_since_migration_ += step;
+                if (epochs_since_migration_ == migration_interval_) {
+                    migration();
+                    epochs_since_migration_ = 0;
+                }
+            }
+        }
+
+        /*!
+         * Iterates single epoch on all islands
+         */
+        void iterate_epoch() {
+            RTL_ZONE("rtl::GeneticIslands::iterate_epoch");
+            iterate_epochs(1);
+        }
+
+        /*!
+         * Returns the best agent over all islands
+         */
+        AgentType best_agent() {
+            std::vector<AgentType> candidates(islands_.size(), islands_.front().best_agent());
+            executor_(1, islands_.size(), [this, &candidates](size_t begin, size_t end) {
+                for (size_t i = begin ; i < end ; i++) {
+                    candidates[i] = islands_[i].best_agent();
+                }
+            });
+
+            size_t best = 0;
+            float best_score = candidates[0].score();
+            for (size_t i = 1 ; i < candidates.size() ; i++) {
+                float score = candidates[i].score();
+                if (score > best_score) {
+                    best_score = score;
+                    best = i;
+                }
+            }
+            return candidates[best];
+        }
+
+        /*!
+         * Returns number of islands
+         */
+        [[nodiscard]] size_t islands() const {
+            return islands_.size();
+        }
+
+        /*!
+         * Returns the i-th island
+         *
+         * @param i - index of the island
+         */
+        IslandType& island(size_t i) {
+            return islands_.at(i);
+        }
+
+    private:
+
+        /*!
+         * Best agents of each island replace the worst agents of the next island
+         * */
+        void migration() {
+            RTL_ZONE("rtl::GeneticIslands::migration");
+            if (islands_.size() < 2 || migrants_ == 0) { return; }
+
+            std::vector<std::vector<AgentType>> emigrants(islands_.size());
+            executor_(0, islands_.size(), [this, &emigrants](size_t begin, size_t end) {
+                for (size_t i = begin ; i < end ; i++) {
+                    emigrants[i] = islands_[i].best_agents(migrants_);
+                }
+            });
+            executor_(0, islands_.size(), [this, &emigrants](size_t begin, size_t end) {
+                for (size_t i = begin ; i < end ; i++) {
+                    islands_[(i + 1) % islands_.size()].replace_worst(emigrants[i]);
+                }
+            });
+        }
+
+        std::vector<IslandType> islands_;
+        size_t migration_interval_;
+        size_t migrants_;
+        size_t epochs_since_migration_ = 0;
+        Executor executor_;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_GENETICISLANDS_H
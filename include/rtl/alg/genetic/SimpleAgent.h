@@ -27,6 +27,9 @@
 #ifndef ROBOTICTEMPLATELIBRARY_SIMPLEAGENT_H
 #define ROBOTICTEMPLATELIBRARY_SIMPLEAGENT_H
 
+#include "rtl/core/Span.h"
+#include "rtl/core/RandomStream.h"
+
 namespace rtl {
 
     /*!
@@ -40,6 +43,14 @@ namespace rtl {
      *  - AgentType crossover(AgentType&)
      *  - mutate()
      *
+     * Optional methods making the evolution reproducible by GeneticAlgorithm::seed():
+     *  - template<class Engine> static AgentType random(Engine&)
+     *  - template<class Engine> mutate(Engine&)
+     *  - static void random(Span<AgentType>, Engine&) - fills the whole initial population at once, used only for default constructible agents
+     *
+     * Optional method avoiding temporary agents in GeneticAlgorithmDynamic:
+     *  - crossover(const AgentType& mate, AgentType& offspring) const - writes the offspring into an existing agent
+     *
      * one mandatory fit function:
      *  - std::function<float(AgentType)> fit_
      *
@@ -56,6 +67,11 @@ namespace rtl {
     class SimpleAgent {
     public:
 
+        /*!
+         * Default constructor, the value is zero
+         * */
+        SimpleAgent() : value_{}{}
+
         /*!
          * Value constructor
          * */
@@ -68,6 +84,33 @@ namespace rtl {
             return SimpleAgent(static_cast<T>(uniform_random_val(-100.0f, 100.0f)));
         }
 
+        /*!
+         * Generates agent that represents random value from -100 to 100 drawn from the given generator.
+         * @param engine UniformRandomBitGenerator, e.g. a stream from rtl::RandomStreams
+         * */
+        template<class Engine>
+        static SimpleAgent random(Engine& engine) {
+            return SimpleAgent(static_cast<T>(std::uniform_real_distribution<float>(-100.0f, 100.0f)(engine)));
+        }
+
+        /*!
+         * Overwrites all given agents by random values from -100 to 100 drawn by Xoshiro256PlusPlusBulk seeded from the given generator.
+         * @param agents agents to be overwritten
+         * @param engine stream of rtl::RandomStreams
+         * */
+        static void random(Span<SimpleAgent> agents, Xoshiro256PlusPlus& engine) {
+            constexpr size_t chunk = 256;
+            Xoshiro256PlusPlusBulk<> bulk(engine);
+            float values[chunk];
+            for (size_t beg = 0 ; beg < agents.size() ; beg += chunk) {
+                size_t n = std::min(chunk, agents.size() - beg);
+                bulk.uniform(Span<float>(values, n), -100.0f, 100.0f);
+                for (size_t i = 0 ; i < n ; i++) {
+                    agents[beg + i].value_ = static_cast<T>(values[i]);
+                }
+            }
+        }
+
         /*!
          * Evaluates agent and gives his score.
          * */
@@ -83,6 +126,15 @@ namespace rtl {
             return SimpleAgent((value_ + mate.value_) / 2);
         }
 
+        /*!
+         * Combines two agnets (parents) to an existing offspring.
+         * @param mate second parent
+         * @param offspring overwritten by the combination of the parents, may be one of them
+         * */
+        void crossover(const SimpleAgent<T>& mate, SimpleAgent<T>& offspring) const {
+            offspring.value_ = (value_ + mate.value_) / 2;
+        }
+
         /*!
          * Agent is mutated randomly.
          * */
@@ -90,6 +142,15 @@ namespace rtl {
             value_ += static_cast<T>(uniform_random_val(-1.0f, 1.0f));
         }
 
+        /*!
+         * Agent is mutated randomly by the given generator.
+         * @param engine UniformRandomBitGenerator, e.g. a stream from rtl::RandomStreams
+         * */
+        template<class Engine>
+        void mutate(Engine& engine) {
+            value_ += static_cast<T>(std::uniform_real_distribution<float>(-1.0f, 1.0f)(engine));
+        }
+
         /*!
          * Sets new fit function. Can be changed between epochs.
          * @param fn pointer to new fit function
@@ -108,11 +169,10 @@ namespace rtl {
     private:
 
         /*!
-         * Return random value from <min, max> interval with uniform distribution
+         * Return random value from <min, max> interval with uniform distribution. Each thread uses its own engine.
          * */
         static float uniform_random_val(float min, float max) {
-            static std::random_device r;
-            static auto engine = std::default_random_engine(r());
+            static thread_local auto engine = std::default_random_engine(std::random_device{}());
             std::uniform_real_distribution<float> distribution(min, max);
             return distribution(engine);
         }
@@ -28,11 +28,79 @@
 #define ROBOTICTEMPLATELIBRARY_KALMAN_H
 
 #include <iostream>
+#include <array>
+#include "rtl/core/Instrumentation.h"
 #include "rtl/core/Matrix.h"
+#include "rtl/core/Span.h"
 
 namespace rtl
 {
 
+    /*!
+     * Covariance update forms of the Kalman filter correction step. All of them solve the innovation covariance by LDLT
+     * decomposition instead of its explicit inversion.
+     *
+     * Standard: P = (I - K H) P, the cheapest form, but rounding errors may break symmetry and positive definiteness of P.
+     * Joseph: P = (I - K H) P (I - K H)^T + K R K^T, explicitly symmetrized, stays positive definite even in single precision.
+     * Sequential: measurements are processed one by one as scalars and P = P - (P h^T)(P h^T)^T / s is updated symmetrically
+     * without any decomposition at all. Only valid for diagonal measurement noise covariance, the off-diagonal elements are ignored.
+     */
+    enum class KalmanCorrection {
+        Standard,
+        Joseph,
+        Sequential
+    };
+
+    /*!
+     * Information-form accumulator of independent measurements for Kalman::correct_information().
+     * Each measurement z with model H and noise covariance R contributes H^T R^-1 H to the information matrix and H^T R^-1 z to the information vector.
+     * Measurements of different dimensions and models can be mixed. Independent accumulators may be filled concurrently and merged afterwards,
+     * so the correction cost depends on the state dimension only, not on the number of sensors.
+     *
+     * @tparam dtype Data type of values in the matrices
+     * @tparam state_dim Dimension of the state vector of the corrected filter
+     */
+    template <typename dtype, size_t state_dim>
+    class KalmanInformation {
+
+    public:
+
+        KalmanInformation() {
+            clear();
+        }
+
+        //! Adds a measurement \p z with model \p H and noise covariance \p R.
+        template<int measurement_dim>
+        void add(const Matrix<measurement_dim, 1, dtype>& z, const Matrix<measurement_dim, state_dim, dtype>& H,
+                 const Matrix<measurement_dim, measurement_dim, dtype>& R) {
+            Eigen::Matrix<dtype, measurement_dim, state_dim> RinvH = R.data().ldlt().solve(H.data());
+            information_matrix_.data().noalias() += H.data().transpose() * RinvH;
+            information_vector_.data().noalias() += RinvH.transpose() * z.data();
+        }
+
+        //! Adds contributions accumulated by \p other.
+        void merge(const KalmanInformation<dtype, state_dim>& other) {
+            information_matrix_.data() += other.information_matrix_.data();
+            information_vector_.data() += other.information_vector_.data();
+        }
+
+        //! Removes all contributions.
+        void clear() {
+            information_matrix_ = Matrix<state_dim, state_dim, dtype>::zeros();
+            information_vector_ = Matrix<state_dim, 1, dtype>::zeros();
+        }
+
+        const Matrix<state_dim, state_dim, dtype>& information_matrix() const {return information_matrix_;}
+        const Matrix<state_dim, 1, dtype>& information_vector() const {return information_vector_;}
+
+        Matrix<state_dim, state_dim, dtype>& information_matrix() {return information_matrix_;}
+        Matrix<state_dim, 1, dtype>& information_vector() {return information_vector_;}
+
+    private:
+        Matrix<state_dim, state_dim, dtype> information_matrix_;
+        Matrix<state_dim, 1, dtype> information_vector_;
+    };
+
     /*!
      * Simple implementation of Kalman Filter with strict typed input and output matrices.
      * Before using the KF, user has to manually specify the inner matrices of the filter.
@@ -60,35 +128,165 @@ namespace rtl
             R_measurement_noise_covariance_ = Matrix<measurement_dim, measurement_dim, dtype>::identity() * observation_noise_;
 
             I_ = Matrix<state_dim, state_dim, dtype>::identity();
+            K_kalman_gain_ = Matrix<state_dim, measurement_dim, dtype>::zeros();
+
+            // scratch buffers are initialized too, so copies of a fresh filter do not read indeterminate values
+            x_scratch_.setZero();
+            P_scratch_.setZero();
+            IKH_.setZero();
+            innovation_.setZero();
+            PHt_.setZero();
+            S_innovation_covariance_.setIdentity();
+            ldlt_.compute(S_innovation_covariance_);
+            llt_.compute(I_.data());
+            RinvH_.setZero();
+            z_sum_.setZero();
+        }
+
+        void predict(const Matrix<control_dim, 1, dtype>& control_input) {
+            predict(control_input.data());
+        }
+
+        //! Prediction step with the control input given by an Eigen expression, which is evaluated directly into the state.
+        template<typename Derived>
+        void predict(const Eigen::MatrixBase<Derived>& control_input) {
+            RTL_ZONE("rtl::Kalman::predict");
+            x_scratch_.noalias() = A_transition_matrix_.data() * x_states_.data();
+            x_scratch_.noalias() += B_control_matrix_.data() * control_input;
+            x_states_.data() = x_scratch_;
+            predict_covariance(A_transition_matrix_.data());
+        }
+
+        void extended_predict(const Matrix<state_dim, 1, dtype>& x_diff,
+                              const Matrix<state_dim, state_dim, dtype>& G_motion_jacobian) {
+            x_states_.data() += x_diff.data();
+            predict_covariance(G_motion_jacobian.data());
+        }
+
+        void correct(const Matrix<measurement_dim, 1, dtype>& z_measurement) {
+            correct(z_measurement.data());
         }
 
-        void predict(Matrix<control_dim, 1, dtype> control_input) {
-            x_states_ = A_transition_matrix_ * x_states_ + B_control_matrix_ * control_input;
-            P_covariance_ = A_transition_matrix_ * P_covariance_ * A_transition_matrix_.transposed() + Q_process_noise_covariance_;
+        //! Correction step with the measurement given by an Eigen expression, which is evaluated directly into the innovation.
+        template<typename Derived>
+        void correct(const Eigen::MatrixBase<Derived>& z_measurement) {
+            RTL_ZONE("rtl::Kalman::correct");
+            innovation_ = z_measurement;
+            innovation_.noalias() -= H_measurement_matrix_.data() * x_states_.data();
+            correct_innovation(H_measurement_matrix_.data());
         }
 
-        void extended_predict(Matrix<state_dim, 1, dtype>& x_diff,
-                              Matrix<state_dim, state_dim, dtype>& G_motion_jacobian) {
-            x_states_ += x_diff;
-            P_covariance_ = G_motion_jacobian * P_covariance_ * G_motion_jacobian.transposed() + Q_process_noise_covariance_;
+        /*!
+         * Correction step for a measurement matrix selecting state components, H(i, indices[i]) = 1 and zero elsewhere.
+         * The selector is given at compile time, so H P H^T reduces to extraction of a sub-block of P and P H^T to a gather of its columns.
+         * The result is equal to correct() with the corresponding dense measurement matrix, the stored measurement matrix is neither used nor changed.
+         * @tparam indices state components measured by the respective elements of the measurement vector
+         * @param z_measurement measured values of the selected state components
+         */
+        template<size_t... indices>
+        void correct_selected(const Matrix<measurement_dim, 1, dtype>& z_measurement) {
+            static_assert(sizeof...(indices) == measurement_dim, "Kalman::correct_selected(): one state index per measurement element is required.");
+            static_assert(((indices < state_dim) && ...), "Kalman::correct_selected(): state index out of range.");
+            RTL_ZONE("rtl::Kalman::correct_selected");
+            static constexpr std::array<int, measurement_dim> idx{static_cast<int>(indices)...};
+            auto& x = x_states_.data();
+            auto& P = P_covariance_.data();
+            auto& K = K_kalman_gain_.data();
+            const auto& R = R_measurement_noise_covariance_.data();
+            for (size_t i = 0 ; i < measurement_dim ; i++) {
+                innovation_(i) = z_measurement.data()(i) - x(idx[i]);
+            }
+
+            if (correction_ == KalmanCorrection::Sequential) {
+                x_scratch_ = x;
+                for (size_t i = 0 ; i < measurement_dim ; i++) {
+                    auto Pht = PHt_.col(i);
+                    Pht = P.col(idx[i]);
+                    dtype s = Pht(idx[i]) + R(i, i);
+                    K.col(i) = Pht / s;
+                    x += K.col(i) * (innovation_(i) - (x(idx[i]) - x_scratch_(idx[i])));
+                    P.noalias() -= (Pht * Pht.transpose()) / s;
+                }
+                return;
+            }
+
+            // gathers of columns and rows of P, written as loops to keep Eigen 3.3 compatibility (no indexed views)
+            for (size_t i = 0 ; i < measurement_dim ; i++) {
+                PHt_.col(i) = P.col(idx[i]);
+            }
+            for (size_t i = 0 ; i < measurement_dim ; i++) {
+                S_innovation_covariance_.row(i) = PHt_.row(idx[i]);
+            }
+            S_innovation_covariance_ += R;
+            ldlt_.compute(S_innovation_covariance_);
+            K.transpose() = ldlt_.solve(PHt_.transpose());
+            x.noalias() += K * innovation_;
+            if (correction_ == KalmanCorrection::Joseph) {
+                // (I - K H) P (I - K H)^T + K R K^T expanded to P - K H P - P H^T K^T + K S K^T
+                P.noalias() -= K * PHt_.transpose();
+                P.noalias() -= PHt_ * K.transpose();
+                PHt_.noalias() = K * S_innovation_covariance_;
+                P.noalias() += PHt_ * K.transpose();
+                P_scratch_ = P.transpose();
+                P = (P + P_scratch_) * dtype(0.5);
+            } else {
+                P.noalias() -= K * PHt_.transpose();
+            }
         }
 
-        void correct(Matrix<measurement_dim, 1, dtype> z_measurement) {
-            K_kalman_gain_ = P_covariance_ * H_measurement_matrix_.transposed() * (H_measurement_matrix_ * P_covariance_ * H_measurement_matrix_.transposed() + R_measurement_noise_covariance_).inverted();
-            x_states_ = x_states_ + K_kalman_gain_ * (z_measurement - H_measurement_matrix_ * x_states_);
-            P_covariance_ = (I_ - K_kalman_gain_ * H_measurement_matrix_) * P_covariance_;
+        void extended_correct(const Matrix<measurement_dim, 1, dtype>& z_diff,
+                              const Matrix<measurement_dim, state_dim, dtype>& H_measurement_jacobian) {
+            innovation_ = z_diff.data();
+            correct_innovation(H_measurement_jacobian.data());
         }
 
-        void extended_correct(Matrix<measurement_dim, 1, dtype> z_diff,
-                              Matrix<measurement_dim, state_dim, dtype> H_measurement_jacobian) {
-            K_kalman_gain_ = P_covariance_ * H_measurement_jacobian.transposed() * (H_measurement_jacobian * P_covariance_ * H_measurement_jacobian.transposed() + R_measurement_noise_covariance_).inverted();
-            x_states_ = x_states_ + K_kalman_gain_ * z_diff;
-            P_covariance_ = (I_ - K_kalman_gain_ * H_measurement_jacobian) * P_covariance_;
+        /*!
+         * Correction by many simultaneous measurements of the filter's own measurement model, fused in information form.
+         * The measurements are summed and the state is corrected by a single solve, which is equivalent to calling correct() for each of them.
+         * The Kalman gain is not updated.
+         * @param z_measurements measurements taken at the same time, assumed independent with the noise covariance of the filter
+         */
+        void fuse(Span<const Matrix<measurement_dim, 1, dtype>> z_measurements) {
+            RTL_ZONE("rtl::Kalman::fuse");
+            if (z_measurements.empty()) {
+                return;
+            }
+            const auto& H = H_measurement_matrix_.data();
+            RinvH_ = R_measurement_noise_covariance_.data().ldlt().solve(H);
+            z_sum_.setZero();
+            for (const auto& z : z_measurements) {
+                z_sum_ += z.data();
+            }
+            information_.information_matrix().data().noalias() = static_cast<dtype>(z_measurements.size()) * H.transpose() * RinvH_;
+            information_.information_vector().data().noalias() = RinvH_.transpose() * z_sum_;
+            correct_information(information_);
+        }
+
+        /*!
+         * Correction in information form: P' = (P^-1 + I)^-1 and x' = P' (P^-1 x + i), where I and i are the accumulated information matrix and vector.
+         * Two Cholesky factorizations of state size are needed regardless of the number of measurements. The Kalman gain is not updated.
+         * @param information contributions of independent measurements
+         */
+        void correct_information(const KalmanInformation<dtype, state_dim>& information) {
+            RTL_ZONE("rtl::Kalman::correct_information");
+            auto& x = x_states_.data();
+            auto& P = P_covariance_.data();
+            llt_.compute(P);
+            x_scratch_ = llt_.solve(x);
+            x_scratch_ += information.information_vector().data();
+            P_scratch_ = llt_.solve(I_.data());
+            P_scratch_ += information.information_matrix().data();
+            llt_.compute(P_scratch_);
+            x = llt_.solve(x_scratch_);
+            P_scratch_ = llt_.solve(I_.data());
+            P = (P_scratch_ + P_scratch_.transpose()) * dtype(0.5);
         }
 
         const Matrix<state_dim, 1, dtype>& states() const {return x_states_;}
         const Matrix<state_dim, state_dim, dtype>& covariance() const {return P_covariance_;}
         const Matrix<state_dim, measurement_dim, dtype>& kalman_gain() {return K_kalman_gain_;}
+        const Matrix<state_dim, state_dim, dtype>& transition_matrix() const {return A_transition_matrix_;}
+        KalmanCorrection correction() const {return correction_;}
 
         void set_states(const Matrix<state_dim, 1, dtype>& states) {x_states_ = states;}
         void set_transision_matrix(const Matrix<state_dim, state_dim, dtype>& transition_matrix) {A_transition_matrix_ = transition_matrix;}
@@ -98,8 +296,64 @@ namespace rtl
 
         void set_process_noise_covariance_matrix(const Matrix<state_dim, state_dim, dtype>& process_noise_covariance) {Q_process_noise_covariance_ = process_noise_covariance;}
         void set_measurement_noise_covariance_matrix(const Matrix<measurement_dim, measurement_dim, dtype>& measurement_noise_covariance) {R_measurement_noise_covariance_ = measurement_noise_covariance;}
+        void set_correction(KalmanCorrection correction) {correction_ = correction;}
 
     private:
+
+        typedef Eigen::Matrix<dtype, state_dim, 1> StateVector;
+        typedef Eigen::Matrix<dtype, measurement_dim, 1> MeasurementVector;
+        typedef Eigen::Matrix<dtype, state_dim, state_dim> StateMatrix;
+        typedef Eigen::Matrix<dtype, measurement_dim, state_dim> MeasurementMatrix;
+
+        //! P = G P G^T + Q evaluated through the preallocated scratch matrix.
+        void predict_covariance(const StateMatrix& G) {
+            P_scratch_.noalias() = G * P_covariance_.data();
+            P_covariance_.data().noalias() = P_scratch_ * G.transpose();
+            P_covariance_.data() += Q_process_noise_covariance_.data();
+        }
+
+        //! Correction by the innovation already stored in innovation_.
+        void correct_innovation(const MeasurementMatrix& H) {
+            auto& x = x_states_.data();
+            auto& P = P_covariance_.data();
+            auto& K = K_kalman_gain_.data();
+            const auto& R = R_measurement_noise_covariance_.data();
+
+            if (correction_ == KalmanCorrection::Sequential) {
+                // Innovation of each scalar measurement is linearly adjusted by the state change of the preceding ones.
+                x_scratch_ = x;
+                for (size_t i = 0 ; i < measurement_dim ; i++) {
+                    auto h = H.row(i);
+                    auto Pht = PHt_.col(i);
+                    Pht.noalias() = P * h.transpose();
+                    dtype s = h.dot(Pht) + R(i, i);
+                    K.col(i) = Pht / s;
+                    x += K.col(i) * (innovation_(i) - h.dot(x - x_scratch_));
+                    P.noalias() -= (Pht * Pht.transpose()) / s;
+                }
+                return;
+            }
+
+            PHt_.noalias() = P * H.transpose();
+            S_innovation_covariance_ = R;
+            S_innovation_covariance_.noalias() += H * PHt_;
+            ldlt_.compute(S_innovation_covariance_);
+            K.transpose() = ldlt_.solve(PHt_.transpose());
+            x.noalias() += K * innovation_;
+            if (correction_ == KalmanCorrection::Joseph) {
+                IKH_ = I_.data();
+                IKH_.noalias() -= K * H;
+                P_scratch_.noalias() = IKH_ * P;
+                P.noalias() = P_scratch_ * IKH_.transpose();
+                PHt_.noalias() = K * R;
+                P.noalias() += PHt_ * K.transpose();
+                P_scratch_ = P.transpose();
+                P = (P + P_scratch_) * dtype(0.5);
+            } else {
+                P.noalias() -= K * PHt_.transpose();
+            }
+        }
+
         dtype process_noise_;
         dtype observation_noise_;
 
@@ -113,6 +367,20 @@ namespace rtl
         Matrix<state_dim, state_dim, dtype> Q_process_noise_covariance_;
         Matrix<measurement_dim, measurement_dim, dtype> R_measurement_noise_covariance_;
         Matrix<state_dim, state_dim, dtype> I_;
+
+        KalmanCorrection correction_ = KalmanCorrection::Standard;
+
+        StateVector x_scratch_;
+        StateMatrix P_scratch_;
+        StateMatrix IKH_;
+        MeasurementVector innovation_;
+        Eigen::Matrix<dtype, state_dim, measurement_dim> PHt_;
+        Eigen::Matrix<dtype, measurement_dim, measurement_dim> S_innovation_covariance_;
+        Eigen::LDLT<Eigen::Matrix<dtype, measurement_dim, measurement_dim>> ldlt_;
+        Eigen::LLT<StateMatrix> llt_;
+        MeasurementMatrix RinvH_;
+        MeasurementVector z_sum_;
+        KalmanInformation<dtype, state_dim> information_;
     };
 }
 
@@ -0,0 +1,363 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_KALMANBANK_H
+#define ROBOTICTEMPLATELIBRARY_KALMANBANK_H
+
+#include <vector>
+#include <algorithm>
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/Matrix.h"
+
+namespace rtl
+{
+
+    /*!
+     * Bank of many Kalman filters sharing the transition, control, measurement and noise matrices, e.g. constant velocity
+     * models of all tracks in a multi-object tracker.
+     *
+     * States and covariances of all filters are kept in structure-of-arrays layout: one row per filter and one column per
+     * state element (covariances are stored column-wise vectorized). Each column is thus a contiguous array over all
+     * filters and both predict() and correct() are evaluated for the whole bank at once by element-wise operations over these
+     * arrays, which Eigen vectorizes. Zero elements of the shared matrices are skipped, the innovation covariances of all
+     * filters are solved by element-wise Cholesky decomposition, so no explicit matrix inversion is performed.
+     *
+     * @tparam dtype Data type of values in KF's matrices
+     * @tparam state_dim Dimension of inner state vector
+     * @tparam measurement_dim Dimension of measurement vector
+     * @tparam control_dim Dimension of control vector
+     */
+    template <typename dtype, size_t state_dim, size_t measurement_dim, size_t control_dim>
+    class KalmanBank {
+
+        static constexpr int S = state_dim;
+        static constexpr int M = measurement_dim;
+        static constexpr int C = control_dim;
+
+    public:
+
+        typedef Eigen::Matrix<dtype, Eigen::Dynamic, S> StatesType;              //!< States of all filters, one filter per row.
+        typedef Eigen::Matrix<dtype, Eigen::Dynamic, M> MeasurementsType;        //!< Measurements of all filters, one filter per row.
+        typedef Eigen::Matrix<dtype, Eigen::Dynamic, C> ControlsType;            //!< Control inputs of all filters, one filter per row.
+        typedef Eigen::Matrix<dtype, Eigen::Dynamic, S * S> CovariancesType;     //!< Column-wise vectorized covariances of all filters, one filter per row.
+
+        /*!
+         * Construction of the bank with \p filters filters with zero states and identity covariances.
+         *
+         * @param filters initial number of filters.
+         * @param process_noise diagonal of the process noise covariance.
+         * @param observation_noise diagonal of the measurement noise covariance.
+         */
+        KalmanBank(size_t filters, dtype process_noise, dtype observation_noise) {
+            A_transition_matrix_ = Matrix<state_dim, state_dim, dtype>::identity();
+            B_control_matrix_ = Matrix<state_dim, control_dim, dtype>::zeros();
+            H_measurement_matrix_ = Matrix<measurement_dim, state_dim, dtype>::zeros();
+            Q_process_noise_covariance_ = Matrix<state_dim, state_dim, dtype>::identity() * process_noise;
+            R_measurement_noise_covariance_ = Matrix<measurement_dim, measurement_dim, dtype>::identity() * observation_noise;
+            update_transition();
+            update_measurement();
+
+            x_states_ = StatesType::Zero(filters, S);
+            P_covariances_.resize(filters, S * S);
+            P_covariances_.rowwise() = vectorized(Matrix<state_dim, state_dim, dtype>::identity());
+        }
+
+        //! Number of filters in the bank.
+        [[nodiscard]] size_t size() const { return x_states_.rows(); }
+
+        /*!
+         * Appends a new filter at the end of the bank.
+         *
+         * @param states initial state of the filter.
+         * @param covariance initial covariance of the filter.
+         * @return index of the new filter.
+         */
+        size_t add_filter(const Matrix<state_dim, 1, dtype>& states, const Matrix<state_dim, state_dim, dtype>& covariance) {
+            size_t i = size();
+            x_states_.conservativeResize(i + 1, Eigen::NoChange);
+            P_covariances_.conservativeResize(i + 1, Eigen::NoChange);
+            set_states(i, states);
+            set_covariance(i, covariance);
+            return i;
+        }
+
+        /*!
+         * Removes the filter by moving the last filter of the bank to its place.
+         *
+         * @param i index of the filter to be removed.
+         */
+        void remove_filter(size_t i) {
+            size_t last = size() - 1;
+            if (i != last) {
+                x_states_.row(i) = x_states_.row(last);
+                P_covariances_.row(i) = P_covariances_.row(last);
+            }
+            x_states_.conservativeResize(last, Eigen::NoChange);
+            P_covariances_.conservativeResize(last, Eigen::NoChange);
+        }
+
+        //! Prediction step of all filters without control input.
+        void predict() {
+            RTL_ZONE("rtl::KalmanBank::predict");
+            tmp_states_.noalias() = x_states_ * A_transition_matrix_.data().transpose();
+            x_states_.swap(tmp_states_);
+            predict_covariances();
+        }
+
+        /*!
+         * Prediction step of all filters.
+         *
+         * @param control_inputs control inputs, one filter per row.
+         */
+        void predict(const ControlsType& control_inputs) {
+            RTL_ZONE("rtl::KalmanBank::predict");
+            tmp_states_.noalias() = x_states_ * A_transition_matrix_.data().transpose();
+            tmp_states_.noalias() += control_inputs * B_control_matrix_.data().transpose();
+            x_states_.swap(tmp_states_);
+            predict_covariances();
+        }
+
+        /*!
+         * Correction step of all filters.
+         *
+         * @param z_measurements measurements, one filter per row.
+         */
+        void correct(const MeasurementsType& z_measurements) {
+            correct_impl(z_measurements, nullptr);
+        }
+
+        /*!
+         * Correction step of the filters with \p active flag set, the remaining filters are left unchanged.
+         *
+         * @param z_measurements measurements, one filter per row. Rows of inactive filters are ignored.
+         * @param active flags of the filters to be corrected.
+         */
+        void correct(const MeasurementsType& z_measurements, const std::vector<bool>& active) {
+            mask_.resize(size());
+            for (size_t i = 0 ; i < size() ; i++) {
+                mask_(i) = active[i] ? dtype(1) : dtype(0);
+            }
+            correct_impl(z_measurements, &mask_);
+        }
+
+        const StatesType& states() const {return x_states_;}
+        const CovariancesType& covariances() const {return P_covariances_;}
+
+        Matrix<state_dim, 1, dtype> states(size_t i) const {
+            return Matrix<state_dim, 1, dtype>(x_states_.row(i).transpose());
+        }
+
+        Matrix<state_dim, state_dim, dtype> covariance(size_t i) const {
+            Eigen::Map<const Eigen::Matrix<dtype, S, S>, 0, Eigen::InnerStride<>> map(P_covariances_.data() + i, Eigen::InnerStride<>(P_covariances_.rows()));
+            return Matrix<state_dim, state_dim, dtype>(map);
+        }
+
+        void set_states(size_t i, const Matrix<state_dim, 1, dtype>& states) {x_states_.row(i) = states.data().transpose();}
+        void set_covariance(size_t i, const Matrix<state_dim, state_dim, dtype>& covariance) {P_covariances_.row(i) = vectorized(covariance);}
+
+        void set_transision_matrix(const Matrix<state_dim, state_dim, dtype>& transition_matrix) {A_transition_matrix_ = transition_matrix; update_transition();}
+        void set_control_matrix(const Matrix<state_dim, control_dim, dtype>& control_matrix) {B_control_matrix_ = control_matrix;}
+        void set_measurement_matrix(const Matrix<measurement_dim, state_dim, dtype>& measurement_matrix) {H_measurement_matrix_ = measurement_matrix; update_measurement();}
+
+        void set_process_noise_covariance_matrix(const Matrix<state_dim, state_dim, dtype>& process_noise_covariance) {Q_process_noise_covariance_ = process_noise_covariance; update_transition();}
+        void set_measurement_noise_covariance_matrix(const Matrix<measurement_dim, measurement_dim, dtype>& measurement_noise_covariance) {R_measurement_noise_covariance_ = measurement_noise_covariance; update_measurement();}
+
+    private:
+
+        template<int r, int c>
+        static Eigen::Matrix<dtype, 1, r * c> vectorized(const Matrix<r, c, dtype>& m) {
+            return Eigen::Map<const Eigen::Matrix<dtype, 1, r * c>>(m.data().data());
+        }
+
+        void update_transition() {
+            q_vec_ = vectorized(Q_process_noise_covariance_);
+        }
+
+        void update_measurement() {
+            r_vec_ = vectorized(R_measurement_noise_covariance_);
+        }
+
+        //! Filters are processed in blocks of this size, so the working set of one block stays in the L1 cache.
+        static constexpr Eigen::Index block_size = 128;
+
+        void predict_covariances() {
+            for (Eigen::Index begin = 0 ; begin < (Eigen::Index)size() ; begin += block_size) {
+                predict_block(begin, std::min<Eigen::Index>(block_size, size() - begin));
+            }
+        }
+
+        void correct_impl(const MeasurementsType& z_measurements, const Eigen::Matrix<dtype, Eigen::Dynamic, 1>* mask) {
+            RTL_ZONE("rtl::KalmanBank::correct");
+            for (Eigen::Index begin = 0 ; begin < (Eigen::Index)size() ; begin += block_size) {
+                correct_block(z_measurements, mask, begin, std::min<Eigen::Index>(block_size, size() - begin));
+            }
+        }
+
+        //! Column-wise P' = A P A^T + Q, zero elements of A (common in motion models) are skipped.
+        void predict_block(Eigen::Index begin, Eigen::Index len) {
+            const auto& A = A_transition_matrix_.data();
+            auto P = P_covariances_.middleRows(begin, len);
+            AP_.setZero(len, S * S);
+            for (int a = 0 ; a < S ; a++) {
+                for (int l = 0 ; l < S ; l++) {
+                    for (int b = 0 ; b < S ; b++) {
+                        if (A(l, b) != dtype(0)) {
+                            AP_.col(a + S * l) += A(l, b) * P.col(a + S * b);
+                        }
+                    }
+                }
+            }
+            for (int j = 0 ; j < S ; j++) {
+                for (int l = 0 ; l < S ; l++) {
+                    P.col(j + S * l).setConstant(q_vec_(j + S * l));
+                    for (int a = 0 ; a < S ; a++) {
+                        if (A(j, a) != dtype(0)) {
+                            P.col(j + S * l) += A(j, a) * AP_.col(a + S * l);
+                        }
+                    }
+                }
+            }
+        }
+
+        void correct_block(const MeasurementsType& z_measurements, const Eigen::Matrix<dtype, Eigen::Dynamic, 1>* mask, Eigen::Index begin, Eigen::Index len) {
+            const auto& H = H_measurement_matrix_.data();
+            auto P = P_covariances_.middleRows(begin, len);
+            auto x = x_states_.middleRows(begin, len);
+
+            PHt_.setZero(len, S * M);
+            for (int j = 0 ; j < S ; j++) {
+                for (int k = 0 ; k < M ; k++) {
+                    for (int b = 0 ; b < S ; b++) {
+                        if (H(k, b) != dtype(0)) {
+                            PHt_.col(j + S * k) += H(k, b) * P.col(j + S * b);
+                        }
+                    }
+                }
+            }
+            S_innovation_.resize(len, M * M);
+            for (int i = 0 ; i < M ; i++) {
+                for (int k = 0 ; k <= i ; k++) {
+                    S_innovation_.col(i + M * k).setConstant(r_vec_(i + M * k));
+                    for (int a = 0 ; a < S ; a++) {
+                        if (H(i, a) != dtype(0)) {
+                            S_innovation_.col(i + M * k) += H(i, a) * PHt_.col(a + S * k);
+                        }
+                    }
+                }
+            }
+
+            // Right hand sides of the innovation covariance solve: innovation followed by the rows of P H^T.
+            rhs_.resize(len, M * (S + 1));
+            rhs_.leftCols(M) = z_measurements.middleRows(begin, len);
+            rhs_.leftCols(M).noalias() -= x * H_measurement_matrix_.data().transpose();
+            for (int j = 0 ; j < S ; j++) {
+                for (int k = 0 ; k < M ; k++) {
+                    rhs_.col(M * (j + 1) + k) = PHt_.col(j + S * k);
+                }
+            }
+
+            cholesky_solve(len);
+            if (mask) {
+                rhs_.array().colwise() *= mask->segment(begin, len).array();
+            }
+
+            // x += P H^T S^-1 y,  P -= P H^T S^-1 H P
+            for (int j = 0 ; j < S ; j++) {
+                for (int k = 0 ; k < M ; k++) {
+                    x.col(j).array() += PHt_.col(j + S * k).array() * rhs_.col(k).array();
+                }
+            }
+            for (int j = 0 ; j < S ; j++) {
+                for (int l = 0 ; l < S ; l++) {
+                    for (int k = 0 ; k < M ; k++) {
+                        P.col(j + S * l).array() -= PHt_.col(j + S * k).array() * rhs_.col(M * (l + 1) + k).array();
+                    }
+                }
+            }
+        }
+
+        //! Element-wise Cholesky decomposition S = L L^T of the innovation covariances in the lower triangle followed by in-place solution of all right hand sides.
+        void cholesky_solve(Eigen::Index len) {
+            L_.resize(len, M * M);
+            inv_diag_.resize(len, M);
+            for (int i = 0 ; i < M ; i++) {
+                for (int k = 0 ; k <= i ; k++) {
+                    acc_ = S_innovation_.col(i + M * k).array();
+                    for (int p = 0 ; p < k ; p++) {
+                        acc_ -= L_.col(i + M * p).array() * L_.col(k + M * p).array();
+                    }
+                    if (i == k) {
+                        L_.col(i + M * i).array() = acc_.sqrt();
+                        inv_diag_.col(i).array() = L_.col(i + M * i).array().inverse();
+                    } else {
+                        L_.col(i + M * k).array() = acc_ * inv_diag_.col(k).array();
+                    }
+                }
+            }
+
+            for (int r = 0 ; r <= S ; r++) {
+                auto b = rhs_.middleCols(M * r, M);
+                for (int i = 0 ; i < M ; i++) {
+                    for (int p = 0 ; p < i ; p++) {
+                        b.col(i).array() -= L_.col(i + M * p).array() * b.col(p).array();
+                    }
+                    b.col(i).array() *= inv_diag_.col(i).array();
+                }
+                for (int i = M - 1 ; i >= 0 ; i--) {
+                    for (int p = i + 1 ; p < M ; p++) {
+                        b.col(i).array() -= L_.col(p + M * i).array() * b.col(p).array();
+                    }
+                    b.col(i).array() *= inv_diag_.col(i).array();
+                }
+            }
+        }
+
+        Matrix<state_dim, state_dim, dtype> A_transition_matrix_;
+        Matrix<state_dim, control_dim, dtype> B_control_matrix_;
+        Matrix<measurement_dim, state_dim, dtype> H_measurement_matrix_;
+        Matrix<state_dim, state_dim, dtype> Q_process_noise_covariance_;
+        Matrix<measurement_dim, measurement_dim, dtype> R_measurement_noise_covariance_;
+
+        Eigen::Matrix<dtype, 1, S * S> q_vec_;
+        Eigen::Matrix<dtype, 1, M * M> r_vec_;
+
+        StatesType x_states_;
+        CovariancesType P_covariances_;
+
+        StatesType tmp_states_;
+        CovariancesType AP_;
+        Eigen::Matrix<dtype, Eigen::Dynamic, S * M> PHt_;
+        Eigen::Matrix<dtype, Eigen::Dynamic, M * M> S_innovation_;
+        Eigen::Matrix<dtype, Eigen::Dynamic, M * M> L_;
+        Eigen::Matrix<dtype, Eigen::Dynamic, M> inv_diag_;
+        Eigen::Matrix<dtype, Eigen::Dynamic, Eigen::Dynamic> rhs_;
+        Eigen::Matrix<dtype, Eigen::Dynamic, 1> mask_;
+        Eigen::Array<dtype, Eigen::Dynamic, 1> acc_;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_KALMANBANK_H
@@ -0,0 +1,202 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Adam Ligocki <adam.ligocki@vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_KALMANSMOOTHER_H
+#define ROBOTICTEMPLATELIBRARY_KALMANSMOOTHER_H
+
+#include <array>
+#include <stdexcept>
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/Matrix.h"
+#include "rtl/alg/kalman/Kalman.h"
+
+namespace rtl
+{
+
+    /*!
+     * Fixed-lag Rauch-Tung-Striebel smoother on top of the Kalman filter.
+     * The smoother owns a Kalman filter and forwards the prediction and correction steps to it. After each step, the filtered and predicted states and
+     * covariances and the transition matrix are stored in a ring buffer of lag + 1 entries allocated with the smoother, so the memory is bounded.
+     * The smoother gain of each step is computed once, when the following prediction is known, and the backward pass over the window runs lazily
+     * when a smoothed value is requested, so the cost per step is O(lag) regardless of the length of the trajectory.
+     *
+     * @tparam dtype Data type of values in KF's matrices
+     * @tparam state_dim Dimension of inner state vector
+     * @tparam measurement_dim Dimension of measurement vector
+     * @tparam control_dim Dimension of control vector
+     * @tparam lag Number of steps the oldest stored state lags behind the newest one
+     */
+    template <typename dtype, size_t state_dim, size_t measurement_dim, size_t control_dim, size_t lag>
+    class KalmanSmoother {
+
+    public:
+
+        typedef Kalman<dtype, state_dim, measurement_dim, control_dim> FilterType;
+
+        KalmanSmoother(dtype process_noise, dtype observation_noise) : filter_(process_noise, observation_noise) {}
+
+        //! The underlying filter, which is to be configured before the first step.
+        FilterType& filter() {return filter_;}
+        const FilterType& filter() const {return filter_;}
+
+        void predict(const Matrix<control_dim, 1, dtype>& control_input) {
+            filter_.predict(control_input);
+            push_prediction(filter_.transition_matrix());
+        }
+
+        void extended_predict(const Matrix<state_dim, 1, dtype>& x_diff, const Matrix<state_dim, state_dim, dtype>& G_motion_jacobian) {
+            filter_.extended_predict(x_diff, G_motion_jacobian);
+            push_prediction(G_motion_jacobian);
+        }
+
+        void correct(const Matrix<measurement_dim, 1, dtype>& z_measurement) {
+            filter_.correct(z_measurement);
+            store_correction();
+        }
+
+        void extended_correct(const Matrix<measurement_dim, 1, dtype>& z_diff, const Matrix<measurement_dim, state_dim, dtype>& H_measurement_jacobian) {
+            filter_.extended_correct(z_diff, H_measurement_jacobian);
+            store_correction();
+        }
+
+        //! Number of stored steps, at most lag + 1.
+        [[nodiscard]] size_t size() const {return size_;}
+
+        //! Forgets the stored steps, the filter is kept intact.
+        void clear() {
+            size_ = 0;
+            smoothed_ = false;
+        }
+
+        /*!
+         * Smoothed state of the step \p delay steps before the newest one, delay 0 gives the filtered state of the newest step.
+         * @param delay age of the requested step, less than size()
+         * @return smoothed state conditioned on all measurements up to the newest step
+         */
+        const Matrix<state_dim, 1, dtype>& smoothed_states(size_t delay) const {
+            return entry_smoothed(delay).x_smoothed;
+        }
+
+        /*!
+         * Smoothed covariance of the step \p delay steps before the newest one, delay 0 gives the filtered covariance of the newest step.
+         * @param delay age of the requested step, less than size()
+         * @return smoothed covariance conditioned on all measurements up to the newest step
+         */
+        const Matrix<state_dim, state_dim, dtype>& smoothed_covariance(size_t delay) const {
+            return entry_smoothed(delay).P_smoothed;
+        }
+
+    private:
+
+        typedef Eigen::Matrix<dtype, state_dim, state_dim> StateMatrix;
+
+        struct Entry {
+            Matrix<state_dim, 1, dtype> x_filtered;
+            Matrix<state_dim, state_dim, dtype> P_filtered;
+            Matrix<state_dim, 1, dtype> x_predicted;
+            Matrix<state_dim, state_dim, dtype> P_predicted;
+            Matrix<state_dim, state_dim, dtype> C_gain;         // smoother gain towards the following step
+            Matrix<state_dim, 1, dtype> x_smoothed;
+            Matrix<state_dim, state_dim, dtype> P_smoothed;
+        };
+
+        static constexpr size_t capacity = lag + 1;
+
+        Entry& entry(size_t delay) const {return buffer_[(newest_ + capacity - delay) % capacity];}
+
+        //! Stores the new prediction and completes the smoother gain of the preceding step: C = P_f A^T P_p^-1.
+        void push_prediction(const Matrix<state_dim, state_dim, dtype>& A) {
+            RTL_ZONE("rtl::KalmanSmoother::push_prediction");
+            if (size_ > 0) {
+                Entry& prev = entry(0);
+                llt_.compute(filter_.covariance().data());
+                scratch_.noalias() = A.data() * prev.P_filtered.data();
+                prev.C_gain.data().transpose() = llt_.solve(scratch_);
+            }
+            newest_ = (newest_ + 1) % capacity;
+            size_ = std::min(size_ + 1, capacity);
+            Entry& e = entry(0);
+            e.x_predicted = filter_.states();
+            e.P_predicted = filter_.covariance();
+            e.x_filtered = e.x_predicted;
+            e.P_filtered = e.P_predicted;
+            smoothed_ = false;
+        }
+
+        void store_correction() {
+            if (size_ == 0) {
+                return;
+            }
+            Entry& e = entry(0);
+            e.x_filtered = filter_.states();
+            e.P_filtered = filter_.covariance();
+            smoothed_ = false;
+        }
+
+        const Entry& entry_smoothed(size_t delay) const {
+            if (delay >= size_) {
+                throw std::out_of_range("KalmanSmoother: requested step is not stored.");
+            }
+            if (!smoothed_) {
+                backward_pass();
+            }
+            return entry(delay);
+        }
+
+        //! RTS recursion from the newest step backwards over the window.
+        void backward_pass() const {
+            RTL_ZONE("rtl::KalmanSmoother::backward_pass");
+            Entry& newest = entry(0);
+            newest.x_smoothed = newest.x_filtered;
+            newest.P_smoothed = newest.P_filtered;
+            for (size_t d = 1 ; d < size_ ; d++) {
+                Entry& e = entry(d);
+                const Entry& next = entry(d - 1);
+                const auto& C = e.C_gain.data();
+                e.x_smoothed.data() = e.x_filtered.data();
+                e.x_smoothed.data().noalias() += C * (next.x_smoothed.data() - next.x_predicted.data());
+                scratch_ = next.P_smoothed.data() - next.P_predicted.data();
+                scratch_2_.noalias() = C * scratch_;
+                e.P_smoothed.data() = e.P_filtered.data();
+                e.P_smoothed.data().noalias() += scratch_2_ * C.transpose();
+            }
+            smoothed_ = true;
+        }
+
+        FilterType filter_;
+        // smoothed values are evaluated lazily by the const accessors
+        mutable std::array<Entry, capacity> buffer_;
+        size_t newest_ = 0;
+        size_t size_ = 0;
+        mutable bool smoothed_ = false;
+        mutable StateMatrix scratch_;
+        mutable StateMatrix scratch_2_;
+        Eigen::LLT<StateMatrix> llt_;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_KALMANSMOOTHER_H
@@ -0,0 +1,222 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Adam Ligocki <adam.ligocki@vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_UNSCENTEDKALMAN_H
+#define ROBOTICTEMPLATELIBRARY_UNSCENTEDKALMAN_H
+
+#include <cmath>
+#include <stdexcept>
+#include "rtl/core/Executor.h"
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/Matrix.h"
+
+namespace rtl
+{
+
+    /*!
+     * Unscented Kalman filter with the matrix interface of rtl::Kalman. Instead of user-derived Jacobians, the nonlinear motion and measurement models
+     * are given as functors and the state distribution is propagated through them by 2n+1 sigma points (scaled unscented transform of Wan and van der Merwe).
+     *
+     * The motion functor is called as f(const Matrix<state_dim, 1, dtype>& x, const Matrix<control_dim, 1, dtype>& u) and the measurement functor as
+     * h(const Matrix<state_dim, 1, dtype>& x), they return Matrix<state_dim, 1, dtype> and Matrix<measurement_dim, 1, dtype> respectively. Sigma points
+     * are propagated by the Executor, so the functors must be safe to call concurrently when a parallel executor is used. Noise is additive.
+     *
+     * The Cholesky factor of the covariance is computed only when the covariance has changed since the last factorization. With
+     * set_reuse_propagated_sigma_points(true), the correction following a prediction uses the sigma points propagated by the motion model instead of
+     * redrawing them from the predicted covariance, so each predict-correct cycle needs a single factorization at the cost of ignoring the process noise
+     * in the measurement transform.
+     *
+     * @tparam dtype Data type of values in UKF's matrices
+     * @tparam state_dim Dimension of inner state vector
+     * @tparam measurement_dim Dimension of measurement vector
+     * @tparam control_dim Dimension of control vector
+     * @tparam Executor Execution policy for the sigma point propagation (see rtl/core/Executor.h)
+     */
+    template <typename dtype, size_t state_dim, size_t measurement_dim, size_t control_dim, class Executor = SequentialExecutor>
+    class UnscentedKalman {
+
+        static constexpr int sigma_count = 2 * static_cast<int>(state_dim) + 1;
+
+    public:
+
+        UnscentedKalman(dtype process_noise, dtype observation_noise, Executor executor = Executor()) : executor_{std::move(executor)} {
+            x_states_ = Matrix<state_dim, 1, dtype>::zeros();
+            P_covariance_ = Matrix<state_dim, state_dim, dtype>::identity();
+            Q_process_noise_covariance_ = Matrix<state_dim, state_dim, dtype>::identity() * process_noise;
+            R_measurement_noise_covariance_ = Matrix<measurement_dim, measurement_dim, dtype>::identity() * observation_noise;
+            set_sigma_parameters(dtype(1), dtype(2), dtype(0));
+        }
+
+        /*!
+         * Prediction step through the nonlinear motion model.
+         * @param control_input control vector passed to the motion model
+         * @param motion motion model functor, x' = f(x, u)
+         */
+        template<typename Motion>
+        void predict(const Matrix<control_dim, 1, dtype>& control_input, const Motion& motion) {
+            RTL_ZONE("rtl::UnscentedKalman::predict");
+            draw_sigma_points();
+            executor_(0, sigma_count, [&](size_t begin, size_t end){
+                for (size_t i = begin ; i < end ; i++) {
+                    Matrix<state_dim, 1, dtype> x(StateVector(sigma_points_.col(i)));
+                    propagated_.col(i) = motion(x, control_input).data();
+                }
+            });
+
+            auto& x = x_states_.data();
+            auto& P = P_covariance_.data();
+            x.noalias() = propagated_ * Wm_;
+            sigma_points_ = propagated_.colwise() - x;
+            P.noalias() = sigma_points_ * Wc_.asDiagonal() * sigma_points_.transpose();
+            P += Q_process_noise_covariance_.data();
+            // keep the propagated points for the correction, the factorization no longer matches the covariance
+            sigma_points_ = propagated_;
+            propagated_valid_ = true;
+            factorization_valid_ = false;
+        }
+
+        /*!
+         * Correction step through the nonlinear measurement model.
+         * @param z_measurement measured vector
+         * @param measurement measurement model functor, z = h(x)
+         */
+        template<typename Measurement>
+        void correct(const Matrix<measurement_dim, 1, dtype>& z_measurement, const Measurement& measurement) {
+            RTL_ZONE("rtl::UnscentedKalman::correct");
+            if (!(reuse_propagated_ && propagated_valid_)) {
+                draw_sigma_points();
+            }
+            executor_(0, sigma_count, [&](size_t begin, size_t end){
+                for (size_t i = begin ; i < end ; i++) {
+                    Matrix<state_dim, 1, dtype> x(StateVector(sigma_points_.col(i)));
+                    measured_.col(i) = measurement(x).data();
+                }
+            });
+
+            auto& x = x_states_.data();
+            auto& P = P_covariance_.data();
+            auto& K = K_kalman_gain_.data();
+            z_mean_.noalias() = measured_ * Wm_;
+            measured_.colwise() -= z_mean_;
+            sigma_points_.colwise() -= x;
+            S_innovation_covariance_.noalias() = measured_ * Wc_.asDiagonal() * measured_.transpose();
+            S_innovation_covariance_ += R_measurement_noise_covariance_.data();
+            Pxz_.noalias() = sigma_points_ * Wc_.asDiagonal() * measured_.transpose();
+
+            ldlt_.compute(S_innovation_covariance_);
+            K.transpose() = ldlt_.solve(Pxz_.transpose());
+            x.noalias() += K * (z_measurement.data() - z_mean_);
+            P.noalias() -= K * Pxz_.transpose();
+            propagated_valid_ = false;
+            factorization_valid_ = false;
+        }
+
+        const Matrix<state_dim, 1, dtype>& states() const {return x_states_;}
+        const Matrix<state_dim, state_dim, dtype>& covariance() const {return P_covariance_;}
+        const Matrix<state_dim, measurement_dim, dtype>& kalman_gain() {return K_kalman_gain_;}
+
+        void set_states(const Matrix<state_dim, 1, dtype>& states) {x_states_ = states; invalidate();}
+        void set_covariance_matrix(const Matrix<state_dim, state_dim, dtype>& covariance_matrix) {P_covariance_ = covariance_matrix; invalidate();}
+        void set_process_noise_covariance_matrix(const Matrix<state_dim, state_dim, dtype>& process_noise_covariance) {Q_process_noise_covariance_ = process_noise_covariance;}
+        void set_measurement_noise_covariance_matrix(const Matrix<measurement_dim, measurement_dim, dtype>& measurement_noise_covariance) {R_measurement_noise_covariance_ = measurement_noise_covariance;}
+        void set_reuse_propagated_sigma_points(bool reuse) {reuse_propagated_ = reuse;}
+
+        /*!
+         * Sets the scaling of the sigma points.
+         * @param alpha spread of the sigma points around the mean, 1 by default
+         * @param beta prior knowledge of the distribution, 2 is optimal for Gaussian distributions
+         * @param kappa secondary scaling parameter, 0 by default
+         */
+        void set_sigma_parameters(dtype alpha, dtype beta, dtype kappa) {
+            const auto n = static_cast<dtype>(state_dim);
+            const dtype lambda = alpha * alpha * (n + kappa) - n;
+            gamma_ = std::sqrt(n + lambda);
+            Wm_.setConstant(dtype(1) / (dtype(2) * (n + lambda)));
+            Wc_ = Wm_;
+            Wm_(0) = lambda / (n + lambda);
+            Wc_(0) = Wm_(0) + (dtype(1) - alpha * alpha + beta);
+            invalidate();
+        }
+
+    private:
+
+        typedef Eigen::Matrix<dtype, state_dim, 1> StateVector;
+        typedef Eigen::Matrix<dtype, measurement_dim, 1> MeasurementVector;
+        typedef Eigen::Matrix<dtype, state_dim, state_dim> StateMatrix;
+        typedef Eigen::Matrix<dtype, state_dim, sigma_count> StateSigmaMatrix;
+        typedef Eigen::Matrix<dtype, measurement_dim, sigma_count> MeasurementSigmaMatrix;
+        typedef Eigen::Matrix<dtype, sigma_count, 1> WeightVector;
+
+        void invalidate() {
+            propagated_valid_ = false;
+            factorization_valid_ = false;
+        }
+
+        //! Sigma points of the current state, the covariance is factorized only if it has changed since the last time.
+        void draw_sigma_points() {
+            if (!factorization_valid_) {
+                llt_.compute(P_covariance_.data());
+                if (llt_.info() != Eigen::Success) {
+                    throw std::runtime_error("UnscentedKalman: covariance matrix is not positive definite.");
+                }
+                factorization_valid_ = true;
+            }
+            const auto& x = x_states_.data();
+            sqrt_scratch_ = llt_.matrixL();
+            sqrt_scratch_ *= gamma_;
+            sigma_points_.col(0) = x;
+            sigma_points_.template middleCols<state_dim>(1) = sqrt_scratch_.colwise() + x;
+            sigma_points_.template rightCols<state_dim>() = (-sqrt_scratch_).colwise() + x;
+        }
+
+        Matrix<state_dim, 1, dtype> x_states_;
+        Matrix<state_dim, state_dim, dtype> P_covariance_;
+        Matrix<state_dim, measurement_dim, dtype> K_kalman_gain_;
+        Matrix<state_dim, state_dim, dtype> Q_process_noise_covariance_;
+        Matrix<measurement_dim, measurement_dim, dtype> R_measurement_noise_covariance_;
+
+        Executor executor_;
+        dtype gamma_;
+        WeightVector Wm_;
+        WeightVector Wc_;
+        bool reuse_propagated_ = false;
+        bool propagated_valid_ = false;
+        bool factorization_valid_ = false;
+
+        StateSigmaMatrix sigma_points_;
+        StateSigmaMatrix propagated_;
+        MeasurementSigmaMatrix measured_;
+        StateMatrix sqrt_scratch_;
+        MeasurementVector z_mean_;
+        Eigen::Matrix<dtype, state_dim, measurement_dim> Pxz_;
+        Eigen::Matrix<dtype, measurement_dim, measurement_dim> S_innovation_covariance_;
+        Eigen::LLT<StateMatrix> llt_;
+        Eigen::LDLT<Eigen::Matrix<dtype, measurement_dim, measurement_dim>> ldlt_;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_UNSCENTEDKALMAN_H
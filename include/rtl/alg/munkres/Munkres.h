@@ -28,12 +28,28 @@
 #ifndef ROBOTICTEMPLATELIBRARY_MUNKRES_H
 #define ROBOTICTEMPLATELIBRARY_MUNKRES_H
 
+#include <optional>
 #include <array>
+#include <vector>
+#include <limits>
 #include <algorithm>
+#include <type_traits>
+
+#include "rtl/core/Instrumentation.h"
 
 namespace rtl
 {
 
+    /*!
+     * Solver policies of the Munkres class.
+     *
+     * MunkresSteps is the textbook step machine of the Munkres algorithm, MunkresJonkerVolgenant is the O(N^3)
+     * shortest augmenting path algorithm of Jonker and Volgenant (LAPJV), which is considerably faster for larger
+     * problems, e.g. association of hundreds of tracks and detections.
+     */
+    struct MunkresSteps {};
+    struct MunkresJonkerVolgenant {};
+
     /*!
      * Implementation of the Munkres (Hungarian) algorithm. Also called assignment algorithm. Takes cost matrix at the
      * input (columns - workers, rows - tasks) and search for the combination with the smallest cost sum.
@@ -45,10 +61,14 @@ namespace rtl
      *
      * @tparam T Data type of values in the const matrix
      * @tparam N Dimension of the cost matrix (NxN)
+     * @tparam Solver solver policy, either MunkresSteps or MunkresJonkerVolgenant.
      * */
-    template <typename T, size_t N>
+    template <typename T, size_t N, typename Solver = MunkresSteps>
     class Munkres {
 
+    static_assert(std::is_same_v<Solver, MunkresSteps> || std::is_same_v<Solver, MunkresJonkerVolgenant>,
+                  "Unknown solver policy of the Munkres class.");
+
     enum class Step {
         STEP_ONE,
         STEP_TWO,
@@ -76,12 +96,17 @@ namespace rtl
          * @param max_cost If true, algorithm maximize sum of all costs (suitable for best IoU search)
          * */
         static std::array<Result, N> solve(Matrix<N, N, T> cost_matrix, bool max_cost = false) {
+            RTL_ZONE("rtl::Munkres::solve");
+            if constexpr (std::is_same_v<Solver, MunkresJonkerVolgenant>) {
+                return solve_jonker_volgenant(cost_matrix, max_cost);
+            }
 
             Step step = Step::STEP_ONE;
-            VectorND<N, bool> row_cover{};
-            VectorND<N, bool> col_cover{};
-            Matrix<N, N, uint8_t> mask{};
+            auto row_cover = VectorND<N, bool>::zeros();
+            auto col_cover = VectorND<N, bool>::zeros();
+            auto mask = Matrix<N, N, uint8_t>::zeros();
             std::optional<std::pair<size_t, size_t>> z0_row_col{};
+            ZeroLists zeros;
             Matrix<N, N, T> cost_matrix_backup = cost_matrix;
 
             if (max_cost) {
@@ -91,22 +116,22 @@ namespace rtl
             while(true) {
                 switch (step) {
                     case Step::STEP_ONE:
-                        step_one(cost_matrix, step);
+                        step_one(cost_matrix, zeros, step);
                         break;
                     case Step::STEP_TWO:
-                        step_two(cost_matrix, mask, step);
+                        step_two(zeros, mask, step);
                         break;
                     case Step::STEP_THREE:
                         step_three(mask, col_cover, step);
                         break;
                     case Step::STEP_FOUR:
-                        z0_row_col = step_four(cost_matrix, mask, row_cover, col_cover, step);
+                        z0_row_col = step_four(zeros, mask, row_cover, col_cover, step);
                         break;
                     case Step::STEP_FIVE:
                         step_five(mask, row_cover, col_cover, z0_row_col.value(), step);
                         break;
                     case Step::STEP_SIX:
-                        step_six(cost_matrix, row_cover, col_cover, step);
+                        step_six(cost_matrix, zeros, row_cover, col_cover, step);
                         break;
                     case Step::STEP_SEVEN:
                         return step_seven(cost_matrix_backup, mask);
@@ -116,52 +141,244 @@ namespace rtl
 
     protected:
 
-        static void flip_costs(Matrix<N, N, T>& cost_matrix) {
-            auto max = std::numeric_limits<T>::min();
-            for (int r = 0 ; r < cost_matrix.rowNr() ; r++) {
-                for (int c = 0 ; c < cost_matrix.colNr() ; c++) {
-                    if (cost_matrix.getElement(r, c) > max) { max = cost_matrix.getElement(r, c); }
+        //! Signed type of the column prices and reduced costs. Integral costs are widened.
+        typedef std::conditional_t<std::is_floating_point_v<T>, T, long long> PriceType;
+
+        //! Per-row lists of columns with zero reduced cost, rebuilt whenever the costs change, so that zeros are not searched for in the whole matrix.
+        struct ZeroLists {
+            std::conditional_t<(N <= 64), std::array<size_t, N * N>, std::vector<size_t>> cols = make_storage();
+            std::array<size_t, N> count{};
+
+            static auto make_storage() {
+                if constexpr (N <= 64) {
+                    return std::array<size_t, N * N>{};
+                } else {
+                    return std::vector<size_t>(N * N);
                 }
             }
 
-            for (int r = 0 ; r < cost_matrix.rowNr() ; r++) {
-                for (int c = 0 ; c < cost_matrix.colNr() ; c++) {
-                    cost_matrix.setElement(r, c, -(cost_matrix.getElement(r,c) - max) );
+            void rebuild(const Matrix<N, N, T>& cost_matrix) {
+                count.fill(0);
+                const T* column = cost_matrix.data().data();
+                for (size_t c = 0 ; c < N ; c++, column += N) {
+                    for (size_t r = 0 ; r < N ; r++) {
+                        if (column[r] == 0) {
+                            cols[r * N + count[r]++] = c;
+                        }
+                    }
                 }
             }
-        }
+        };
 
+        static std::array<Result, N> solve_jonker_volgenant(Matrix<N, N, T> cost_matrix, bool max_cost) {
+            RTL_ZONE("rtl::Munkres::solve_jonker_volgenant");
+            const Matrix<N, N, T> cost_matrix_backup = cost_matrix;
+            if (max_cost) {
+                flip_costs(cost_matrix);
+            }
+            auto cost = [&cost_matrix](long r, long c) { return static_cast<PriceType>(cost_matrix.getElement(r, c)); };
 
-        static void step_one(Matrix<N, N, T>& cost_matrix, Step& step) {
-            for (int r = 0 ; r < cost_matrix.rowNr() ; r++) {
-                T row_min = std::numeric_limits<T>::max();
+            constexpr long n = N;
+            std::array<long, N> row_sol{}, col_sol{}, free_rows{}, pred{}, col_list{};
+            std::array<unsigned, N> matches{};
+            std::array<PriceType, N> v{}, d{};
+
+            if constexpr (N == 1) {
+                row_sol[0] = 0;
+            } else {
+                // Column reduction, each column is assigned to its minimal row if that row is not taken yet.
+                for (long j = n - 1 ; j >= 0 ; j--) {
+                    long i_min = 0;
+                    PriceType min = cost(0, j);
+                    for (long i = 1 ; i < n ; i++) {
+                        if (cost(i, j) < min) {
+                            min = cost(i, j);
+                            i_min = i;
+                        }
+                    }
+                    v[j] = min;
+                    if (++matches[i_min] == 1) {
+                        row_sol[i_min] = j;
+                        col_sol[j] = i_min;
+                    } else {
+                        col_sol[j] = -1;
+                    }
+                }
+
+                // Reduction transfer from the assigned rows, unassigned rows are collected.
+                long free_nr = 0;
+                for (long i = 0 ; i < n ; i++) {
+                    if (matches[i] == 0) {
+                        free_rows[free_nr++] = i;
+                    } else if (matches[i] == 1) {
+                        long j1 = row_sol[i];
+                        PriceType min = std::numeric_limits<PriceType>::max();
+                        for (long j = 0 ; j < n ; j++) {
+                            if (j != j1 && cost(i, j) - v[j] < min) {
+                                min = cost(i, j) - v[j];
+                            }
+                        }
+                        v[j1] = v[j1] - min;
+                    }
+                }
+
+                // Augmenting row reduction, performed twice.
+                for (int loop = 0 ; loop < 2 ; loop++) {
+                    long k = 0, prev_free_nr = free_nr;
+                    free_nr = 0;
+                    while (k < prev_free_nr) {
+                        long i = free_rows[k++];
+                        PriceType u_min = cost(i, 0) - v[0], u_sub_min = std::numeric_limits<PriceType>::max();
+                        long j1 = 0, j2 = 0;
+                        for (long j = 1 ; j < n ; j++) {
+                            PriceType h = cost(i, j) - v[j];
+                            if (h < u_sub_min) {
+                                if (h >= u_min) {
+                                    u_sub_min = h;
+                                    j2 = j;
+                                } else {
+                                    u_sub_min = u_min;
+                                    u_min = h;
+                                    j2 = j1;
+                                    j1 = j;
+                                }
+                            }
+                        }
 
-                for (int c = 0 ; c < cost_matrix.colNr() ; c++) {
-                    if (cost_matrix.getElement(r, c) < row_min) {row_min = cost_matrix.getElement(r, c);}
+                        long i0 = col_sol[j1];
+                        if (u_min < u_sub_min) {
+                            v[j1] = v[j1] - (u_sub_min - u_min);
+                        } else if (i0 >= 0) {
+                            j1 = j2;
+                            i0 = col_sol[j2];
+                        }
+                        row_sol[i] = j1;
+                        col_sol[j1] = i;
+
+                        if (i0 >= 0) {
+                            if (u_min < u_sub_min) {
+                                free_rows[--k] = i0;
+                            } else {
+                                free_rows[free_nr++] = i0;
+                            }
+                        }
+                    }
                 }
 
-                for (int c = 0 ; c < cost_matrix.colNr() ; c++) {
-                    cost_matrix.setElement(r, c, cost_matrix.getElement(r, c) - row_min);
+                // Augmentation of the remaining free rows by Dijkstra-like shortest path search.
+                for (long f = 0 ; f < free_nr ; f++) {
+                    long free_row = free_rows[f];
+                    for (long j = 0 ; j < n ; j++) {
+                        d[j] = cost(free_row, j) - v[j];
+                        pred[j] = free_row;
+                        col_list[j] = j;
+                    }
+
+                    long low = 0, up = 0, last = 0, end_of_path = 0;
+                    PriceType min = 0;
+                    bool unassigned_found = false;
+                    do {
+                        if (up == low) {
+                            last = low - 1;
+                            min = d[col_list[up++]];
+                            for (long k = up ; k < n ; k++) {
+                                long j = col_list[k];
+                                PriceType h = d[j];
+                                if (h <= min) {
+                                    if (h < min) {
+                                        up = low;
+                                        min = h;
+                                    }
+                                    col_list[k] = col_list[up];
+                                    col_list[up++] = j;
+                                }
+                            }
+                            for (long k = low ; k < up ; k++) {
+                                if (col_sol[col_list[k]] < 0) {
+                                    end_of_path = col_list[k];
+                                    unassigned_found = true;
+                                    break;
+                                }
+                            }
+                        }
+
+                        if (!unassigned_found) {
+                            long j1 = col_list[low++];
+                            long i = col_sol[j1];
+                            PriceType u1 = cost(i, j1) - v[j1] - min;
+                            for (long k = up ; k < n ; k++) {
+                                long j = col_list[k];
+                                PriceType v2 = cost(i, j) - v[j] - u1;
+                                if (v2 < d[j]) {
+                                    pred[j] = i;
+                                    if (v2 == min) {
+                                        if (col_sol[j] < 0) {
+                                            end_of_path = j;
+                                            unassigned_found = true;
+                                            break;
+                                        } else {
+                                            col_list[k] = col_list[up];
+                                            col_list[up++] = j;
+                                        }
+                                    }
+                                    d[j] = v2;
+                                }
+                            }
+                        }
+                    } while (!unassigned_found);
+
+                    for (long k = 0 ; k <= last ; k++) {
+                        long j1 = col_list[k];
+                        v[j1] = v[j1] + d[j1] - min;
+                    }
+
+                    long i;
+                    do {
+                        i = pred[end_of_path];
+                        col_sol[end_of_path] = i;
+                        long j1 = end_of_path;
+                        end_of_path = row_sol[i];
+                        row_sol[i] = j1;
+                    } while (i != free_row);
                 }
             }
+
+            std::array<Result, N> output;
+            for (size_t r = 0 ; r < N ; r++) {
+                output.at(r) = Result(r, row_sol[r], cost_matrix_backup.getElement(r, row_sol[r]));
+            }
+            return output;
+        }
+
+        static void flip_costs(Matrix<N, N, T>& cost_matrix) {
+            auto& m = cost_matrix.data();
+            const T max = m.maxCoeff();
+            m = (max - m.array()).matrix();
+        }
+
+
+        static void step_one(Matrix<N, N, T>& cost_matrix, ZeroLists& zeros, Step& step) {
+            auto& m = cost_matrix.data();
+            const Eigen::Matrix<T, N, 1> row_min = m.rowwise().minCoeff();
+            m.colwise() -= row_min;
+            zeros.rebuild(cost_matrix);
             step = Step::STEP_TWO;
         }
 
 
-        static void step_two(Matrix<N, N, T>& cost_matrix,
+        static void step_two(const ZeroLists& zeros,
                              Matrix<N, N, uint8_t>& mask,
                              Step& step) {
 
-            auto row_cover = VectorND<N, bool>::zeros();
             auto col_cover = VectorND<N, bool>::zeros();
 
-            for (int r = 0 ; r < cost_matrix.rowNr() ; r++) {
-                for (int c = 0 ; c < cost_matrix.colNr() ; c++) {
-
-                    if (cost_matrix.getElement(r, c) == 0 && row_cover[r] == 0 && col_cover[c] == 0) {
+            for (size_t r = 0 ; r < N ; r++) {
+                for (size_t i = 0 ; i < zeros.count[r] ; i++) {
+                    size_t c = zeros.cols[r * N + i];
+                    if (col_cover[c] == 0) {
                         mask.setElement(r, c, 1);
-                        row_cover[r] = 1;
                         col_cover[c] = 1;
+                        break;
                     }
                 }
             }
@@ -191,7 +408,7 @@ namespace rtl
         }
 
 
-        static std::optional<std::pair<size_t, size_t>> step_four(Matrix<N, N, T>& cost_matrix,
+        static std::optional<std::pair<size_t, size_t>> step_four(const ZeroLists& zeros,
                                                                   Matrix<N, N, uint8_t>& mask,
                                                                   VectorND<N, bool>& row_cover,
                                                                   VectorND<N, bool>& col_cover,
@@ -199,21 +416,21 @@ namespace rtl
 
             while (true) {
 
-                auto row_col = find_uncovered_zero(cost_matrix, row_cover, col_cover);
+                auto zero_row_col = find_uncovered_zero(zeros, row_cover, col_cover);
 
-                if (row_col == std::nullopt) {
+                if (zero_row_col == std::nullopt) {
                     step = Step::STEP_SIX;
                     return std::nullopt;
                 } else {
-                    mask.setElement(row_col->first, row_col->second, 2);
-                    row_col = star_in_row(mask, row_col->first);
+                    mask.setElement(zero_row_col->first, zero_row_col->second, 2);
+                    auto star_row_col = star_in_row(mask, zero_row_col->first);
 
-                    if (row_col != std::nullopt) {
-                        row_cover.setElement(row_col->first, 1);
-                        col_cover.setElement(row_col->second, 0);
+                    if (star_row_col != std::nullopt) {
+                        row_cover.setElement(star_row_col->first, 1);
+                        col_cover.setElement(star_row_col->second, 0);
                     } else {
                         step = Step::STEP_FIVE;
-                        return std::make_optional<std::pair<size_t, size_t>>(row_col->first, row_col->second);
+                        return zero_row_col;
                     }
                 }
             }
@@ -258,21 +475,18 @@ namespace rtl
 
 
         static void step_six(Matrix<N, N, T>& cost_matrix,
+                             ZeroLists& zeros,
                              VectorND<N, bool>& row_cover,
                              VectorND<N, bool>& col_cover,
                              Step& step) {
 
             auto min_value = minimal_value(cost_matrix, row_cover, col_cover);
-            for (int r = 0 ; r < cost_matrix.rowNr() ; r++) {
-                for (int c = 0 ; c < cost_matrix.colNr() ; c++) {
-                    if (row_cover.getElement(r) == 1) {
-                        cost_matrix.setElement(r, c, cost_matrix.getElement(r, c) + min_value);
-                    }
-                    if (col_cover.getElement(c) == 0) {
-                        cost_matrix.setElement(r, c, cost_matrix.getElement(r, c) - min_value);
-                    }
-                }
-            }
+            auto& m = cost_matrix.data();
+            const Eigen::Matrix<T, N, 1> row_add = row_cover.data().template cast<T>() * min_value;
+            const Eigen::Matrix<T, N, 1> col_sub = (col_cover.data().array() == false).template cast<T>() * min_value;
+            m.colwise() += row_add;
+            m.rowwise() -= col_sub.transpose();
+            zeros.rebuild(cost_matrix);
             step = Step::STEP_FOUR;
         }
 
@@ -288,14 +502,17 @@ namespace rtl
         }
 
 
-        static std::optional<std::pair<size_t, size_t>> find_uncovered_zero(const Matrix<N, N, T>& cost_matrix,
+        static std::optional<std::pair<size_t, size_t>> find_uncovered_zero(const ZeroLists& zeros,
                                                                             const VectorND<N, bool>& row_cover,
                                                                             const VectorND<N, bool>& col_cover) {
 
-            for (int r = 0 ; r < cost_matrix.rowNr() ; r++) {
-                for (int c = 0 ; c < cost_matrix.colNr() ; c++) {
-                    if (cost_matrix.getElement(r, c) == 0 && row_cover.getElement(r) == 0 && col_cover.getElement(c) == 0) {
-                        return std::make_optional<std::pair<size_t, size_t>>(r, c);
+            for (size_t r = 0 ; r < N ; r++) {
+                if (row_cover.getElement(r) == 0) {
+                    for (size_t i = 0 ; i < zeros.count[r] ; i++) {
+                        size_t c = zeros.cols[r * N + i];
+                        if (col_cover.getElement(c) == 0) {
+                            return std::make_optional<std::pair<size_t, size_t>>(r, c);
+                        }
                     }
                 }
             }
@@ -355,8 +572,8 @@ namespace rtl
 
         static void clear_covers(VectorND<N, bool>& row_cover,
                                  VectorND<N, bool>& col_cover) {
-            for (int i = 0 ; i < row_cover.length() ; i++) { row_cover.setElement(i, 0);}
-            for (int i = 0 ; i < col_cover.length() ; i++) { col_cover.setElement(i, 0);}
+            for (int i = 0 ; i < row_cover.dimensionality() ; i++) { row_cover.setElement(i, 0);}
+            for (int i = 0 ; i < col_cover.dimensionality() ; i++) { col_cover.setElement(i, 0);}
         }
 
 
@@ -374,13 +591,11 @@ namespace rtl
                                const VectorND<N, bool>& col_cover) {
 
             auto min_value = std::numeric_limits<T>::max();
-            for (int r = 0 ; r < cost_matrix.rowNr() ; r++) {
-                for (int c = 0 ; c < cost_matrix.colNr() ; c++) {
-                    if (row_cover.getElement(r) == 0 && col_cover.getElement(c) == 0){
-                        if (min_value > cost_matrix.getElement(r, c)) {
-                            min_value = cost_matrix.getElement(r, c);
-                        }
-                    }
+            const auto& m = cost_matrix.data();
+            const auto& covered_rows = row_cover.data().array();
+            for (size_t c = 0 ; c < N ; c++) {
+                if (col_cover.getElement(c) == 0) {
+                    min_value = std::min(min_value, covered_rows.select(std::numeric_limits<T>::max(), m.col(c).array()).minCoeff());
                 }
             }
             return min_value;
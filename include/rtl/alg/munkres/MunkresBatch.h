@@ -0,0 +1,117 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_MUNKRESBATCH_H
+#define ROBOTICTEMPLATELIBRARY_MUNKRESBATCH_H
+
+#include <vector>
+#include <algorithm>
+
+#include "rtl/core/Executor.h"
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/Span.h"
+#include "rtl/alg/munkres/MunkresDynamic.h"
+
+namespace rtl
+{
+
+    //! Single assignment problem viewing its row-major cost matrix in an external buffer.
+    template <typename T>
+    struct MunkresProblem {
+        Span<const T> cost_matrix;      //!< row-major cost matrix with rows * cols elements.
+        size_t rows;                    //!< number of rows of the cost matrix.
+        size_t cols;                    //!< number of columns of the cost matrix.
+        bool max_cost = false;          //!< If true, the sum of costs is maximized.
+    };
+
+    /*!
+     * Batch solver of many small independent assignment problems, e.g. one per sensor pair and object class in every frame.
+     *
+     * Problems of arbitrary, possibly rectangular, sizes are distributed over the workers of the Executor. Each worker owns a MunkresDynamic
+     * solver, whose buffers serve as its scratch memory and keep their capacity between the problems and the calls. Problems are assigned to
+     * the workers in an interleaved order to balance the load if their sizes vary, results are returned in the order of the problems.
+     *
+     * @tparam T Data type of values in the cost matrices.
+     * @tparam Executor Execution policy distributing the problems (see rtl/core/Executor.h).
+     */
+    template <typename T, class Executor = SequentialExecutor>
+    class MunkresBatch {
+
+    public:
+
+        typedef typename MunkresDynamic<T>::Result Result;
+
+        typedef MunkresProblem<T> Problem;
+
+        /*!
+         * Constructor with a custom executor instance.
+         * @param executor Executor used for parallel solving of the problems
+         */
+        explicit MunkresBatch(Executor executor = Executor()) : executor_{std::move(executor)},
+                                                                solvers_(std::max<size_t>(1, executor_.concurrency())) {
+            for (auto& s : solvers_) {
+                s.setWarmStart(false);
+            }
+        }
+
+        /*!
+         * Solves all given problems.
+         * @param problems views of the problems to be solved
+         * @return assigned pairs of each problem sorted by rows, in the order of \p problems
+         */
+        std::vector<std::vector<Result>> solve(Span<const Problem> problems) {
+            std::vector<std::vector<Result>> results(problems.size());
+            solve(problems, results);
+            return results;
+        }
+
+        /*!
+         * Solves all given problems into a preallocated output.
+         * @param problems views of the problems to be solved
+         * @param results assigned pairs of each problem sorted by rows, resized to the number of the problems
+         */
+        void solve(Span<const Problem> problems, std::vector<std::vector<Result>>& results) {
+            RTL_ZONE("rtl::MunkresBatch::solve");
+            results.resize(problems.size());
+            const size_t workers = std::min(solvers_.size(), problems.size());
+            executor_(0, workers, [&](size_t w_begin, size_t w_end){
+                for (size_t w = w_begin ; w < w_end ; w++) {
+                    for (size_t i = w ; i < problems.size() ; i += workers) {
+                        const Problem& p = problems[i];
+                        results[i] = solvers_[w].solve(p.cost_matrix, p.rows, p.cols, p.max_cost);
+                    }
+                }
+            });
+        }
+
+    private:
+        Executor executor_;
+        std::vector<MunkresDynamic<T>> solvers_;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_MUNKRESBATCH_H
@@ -0,0 +1,275 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_MUNKRESDYNAMIC_H
+#define ROBOTICTEMPLATELIBRARY_MUNKRESDYNAMIC_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/Matrix.h"
+#include "rtl/core/Span.h"
+
+namespace rtl
+{
+
+    /*!
+     * Runtime-sized solver of the assignment problem, intended for multi-object tracking where the number of tracks
+     * and detections changes every frame.
+     *
+     * Rectangular cost matrices are implicitly padded by zero-cost dummy rows or columns to the square shape, rows or
+     * columns assigned to the dummies are left unassigned. The solver is a primal-dual Hungarian method, which keeps
+     * row and column potentials and grows the assignment by shortest augmenting paths over the reduced costs.
+     *
+     * The solver object is stateful: if warm start is enabled (default), column potentials and the assignment of the
+     * previous call are reused. Row potentials are recomputed from the new costs, so the duals stay feasible for any
+     * input, and previously assigned pairs which remain tight are kept. Only the remaining rows are then augmented,
+     * which makes solving of slowly changing problems considerably cheaper. Rows and columns are identified by their
+     * indices, the warm start is therefore most effective if the caller keeps the ordering of tracks and detections stable.
+     *
+     * @tparam T Data type of values in the cost matrix.
+     */
+    template <typename T>
+    class MunkresDynamic {
+
+    protected:
+
+        //! Internal type of the potentials and reduced costs. Integral costs are widened and made signed.
+        typedef std::conditional_t<std::is_floating_point_v<T>, T, long long> DualType;
+
+    public:
+
+        struct Result {
+            Result() : row{0}, col{0} {}
+            Result(size_t r, size_t c, T cst) : row{r}, col{c}, cost{cst} {};
+            size_t row;
+            size_t col;
+            T cost;
+        };
+
+        MunkresDynamic() = default;
+
+        /*!
+         * Solves assignment problem for given cost matrix.
+         *
+         * @param cost_matrix row-major cost matrix of a given problem (rows: workers, cols: jobs) with \p rows * \p cols elements.
+         * @param rows number of rows of the cost matrix.
+         * @param cols number of columns of the cost matrix.
+         * @param max_cost If true, algorithm maximize sum of all costs (suitable for best IoU search)
+         * @return assigned pairs sorted by rows, min(\p rows, \p cols) in total.
+         */
+        std::vector<Result> solve(const std::vector<T>& cost_matrix, size_t rows, size_t cols, bool max_cost = false) {
+            return solve(Span<const T>(cost_matrix), rows, cols, max_cost);
+        }
+
+        /*!
+         * Solves assignment problem for given cost matrix viewed in an external buffer.
+         *
+         * @param cost_matrix view of the row-major cost matrix of a given problem (rows: workers, cols: jobs) with \p rows * \p cols elements.
+         * @param rows number of rows of the cost matrix.
+         * @param cols number of columns of the cost matrix.
+         * @param max_cost If true, algorithm maximize sum of all costs (suitable for best IoU search)
+         * @return assigned pairs sorted by rows, min(\p rows, \p cols) in total.
+         */
+        std::vector<Result> solve(Span<const T> cost_matrix, size_t rows, size_t cols, bool max_cost = false) {
+            RTL_ZONE("rtl::MunkresDynamic::solve");
+            if (rows == 0 || cols == 0) {
+                reset();
+                return {};
+            }
+
+            load_costs(cost_matrix, rows, cols, max_cost);
+            init_duals();
+
+            for (size_t r = 1 ; r <= n_ ; r++) {
+                if (row_assigned_[r] == 0) {
+                    augment(r);
+                }
+            }
+
+            std::vector<Result> output;
+            output.reserve(std::min(rows, cols));
+            for (size_t c = 1 ; c <= cols ; c++) {
+                if (col_assigned_[c] != 0 && col_assigned_[c] <= rows) {
+                    size_t r = col_assigned_[c] - 1;
+                    output.emplace_back(r, c - 1, cost_matrix[r * cols + c - 1]);
+                }
+            }
+            std::sort(output.begin(), output.end(), [](const Result& a, const Result& b) { return a.row < b.row; });
+            return output;
+        }
+
+        /*!
+         * Solves assignment problem for given fixed-size, possibly rectangular, cost matrix.
+         *
+         * @param cost_matrix cost matrix of a given problem (rows: workers, cols: jobs).
+         * @param max_cost If true, algorithm maximize sum of all costs (suitable for best IoU search)
+         * @return assigned pairs sorted by rows, min(R, C) in total.
+         */
+        template<int R, int C>
+        std::vector<Result> solve(const Matrix<R, C, T>& cost_matrix, bool max_cost = false) {
+            std::vector<T> costs(R * C);
+            for (int r = 0 ; r < R ; r++) {
+                for (int c = 0 ; c < C ; c++) {
+                    costs[r * C + c] = cost_matrix.getElement(r, c);
+                }
+            }
+            return solve(costs, R, C, max_cost);
+        }
+
+        //! Drops potentials and assignment of the previous call, the next call of solve() starts from scratch.
+        void reset() {
+            n_ = 0;
+            u_.clear();
+            v_.clear();
+            row_assigned_.clear();
+            col_assigned_.clear();
+        }
+
+        //! Enables or disables reusing of the previous solution in subsequent calls of solve().
+        void setWarmStart(bool warm_start) { warm_start_ = warm_start; }
+
+        //! Returns true if the previous solution is reused in subsequent calls of solve().
+        [[nodiscard]] bool warmStart() const { return warm_start_; }
+
+    protected:
+
+        DualType cost(size_t r, size_t c) const { return cost_[(r - 1) * n_ + c - 1]; }
+
+        void load_costs(Span<const T> cost_matrix, size_t rows, size_t cols, bool max_cost) {
+            size_t n = std::max(rows, cols);
+            if (!warm_start_ || n != n_) {
+                if (!warm_start_) {
+                    reset();
+                }
+                n_ = n;
+                v_.resize(n_ + 1, 0);
+                col_assigned_.resize(n_ + 1, 0);
+                for (auto& r : col_assigned_) {
+                    if (r > n_) { r = 0; }
+                }
+            }
+            u_.assign(n_ + 1, 0);
+            row_assigned_.assign(n_ + 1, 0);
+
+            cost_.assign(n_ * n_, 0);
+            for (size_t r = 0 ; r < rows ; r++) {
+                for (size_t c = 0 ; c < cols ; c++) {
+                    auto val = static_cast<DualType>(cost_matrix[r * cols + c]);
+                    cost_[r * n_ + c] = max_cost ? -val : val;
+                }
+            }
+        }
+
+        void init_duals() {
+            for (size_t r = 1 ; r <= n_ ; r++) {
+                DualType row_min = std::numeric_limits<DualType>::max();
+                for (size_t c = 1 ; c <= n_ ; c++) {
+                    row_min = std::min(row_min, cost(r, c) - v_[c]);
+                }
+                u_[r] = row_min;
+            }
+
+            for (size_t c = 1 ; c <= n_ ; c++) {
+                size_t r = col_assigned_[c];
+                if (r != 0 && row_assigned_[r] == 0 && cost(r, c) - v_[c] == u_[r]) {
+                    row_assigned_[r] = c;
+                } else {
+                    col_assigned_[c] = 0;
+                }
+            }
+
+            for (size_t r = 1 ; r <= n_ ; r++) {
+                for (size_t c = 1 ; c <= n_ && row_assigned_[r] == 0 ; c++) {
+                    if (col_assigned_[c] == 0 && cost(r, c) - v_[c] == u_[r]) {
+                        row_assigned_[r] = c;
+                        col_assigned_[c] = r;
+                    }
+                }
+            }
+        }
+
+        void augment(size_t row) {
+            min_reduced_.assign(n_ + 1, std::numeric_limits<DualType>::max());
+            visited_.assign(n_ + 1, 0);
+            way_.assign(n_ + 1, 0);
+
+            col_assigned_[0] = row;
+            size_t c0 = 0;
+            do {
+                visited_[c0] = 1;
+                size_t r0 = col_assigned_[c0], c1 = 0;
+                DualType delta = std::numeric_limits<DualType>::max();
+                for (size_t c = 1 ; c <= n_ ; c++) {
+                    if (!visited_[c]) {
+                        DualType reduced = cost(r0, c) - u_[r0] - v_[c];
+                        if (reduced < min_reduced_[c]) {
+                            min_reduced_[c] = reduced;
+                            way_[c] = c0;
+                        }
+                        if (min_reduced_[c] < delta) {
+                            delta = min_reduced_[c];
+                            c1 = c;
+                        }
+                    }
+                }
+                for (size_t c = 0 ; c <= n_ ; c++) {
+                    if (visited_[c]) {
+                        u_[col_assigned_[c]] += delta;
+                        v_[c] -= delta;
+                    } else {
+                        min_reduced_[c] -= delta;
+                    }
+                }
+                c0 = c1;
+            } while (col_assigned_[c0] != 0);
+
+            do {
+                size_t c1 = way_[c0];
+                col_assigned_[c0] = col_assigned_[c1];
+                row_assigned_[col_assigned_[c0]] = c0;
+                c0 = c1;
+            } while (c0 != 0);
+            col_assigned_[0] = 0;
+            v_[0] = 0;
+        }
+
+        bool warm_start_ = true;
+        size_t n_ = 0;
+        std::vector<DualType> cost_;
+        std::vector<DualType> u_, v_;
+        std::vector<size_t> row_assigned_, col_assigned_;
+        std::vector<DualType> min_reduced_;
+        std::vector<uint8_t> visited_;
+        std::vector<size_t> way_;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_MUNKRESDYNAMIC_H
@@ -0,0 +1,111 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_MUNKRESIOU_H
+#define ROBOTICTEMPLATELIBRARY_MUNKRESIOU_H
+
+#include <vector>
+
+#include "rtl/core/BoundingBoxND.h"
+#include "rtl/core/Instrumentation.h"
+#include "rtl/alg/munkres/MunkresDynamic.h"
+
+namespace rtl
+{
+
+    /*!
+     * Association of tracks and detections given by bounding boxes, maximizing the sum of their intersection over union.
+     *
+     * Fuses BoundingBoxND::iouMatrix() with MunkresDynamic: the IoU matrix is computed in one batch directly into the layout of the solver's cost matrix, and
+     * both the matrix and the solver are kept between calls, so a tracker calling solve() every frame reuses the buffers and benefits from the warm start
+     * of the solver. Assigned pairs with IoU below the threshold are dropped from the result.
+     *
+     * @tparam dim dimensionality of the bounding boxes.
+     * @tparam Element type of the bounding box coordinates and the IoU.
+     */
+    template <int dim, typename Element>
+    class MunkresIoU {
+
+    public:
+
+        typedef typename MunkresDynamic<Element>::Result Result;
+
+        typedef BoundingBoxND<dim, Element> BoundingBoxType;
+
+        MunkresIoU() = default;
+
+        /*!
+         * Construction with given IoU threshold.
+         *
+         * @param min_iou minimal IoU of an accepted pair.
+         */
+        explicit MunkresIoU(Element min_iou) : min_iou_{min_iou} {}
+
+        //! Sets minimal IoU of an accepted pair, 0 by default, so just the overlapping pairs are accepted.
+        void setMinIoU(Element min_iou) { min_iou_ = min_iou; }
+
+        //! Minimal IoU of an accepted pair.
+        [[nodiscard]] Element minIoU() const { return min_iou_; }
+
+        /*!
+         * Assigns detections to tracks.
+         *
+         * @param tracks bounding boxes of the tracks (rows of the problem).
+         * @param detections bounding boxes of the detections (columns of the problem).
+         * @return assigned pairs sorted by rows, cost of a pair is its IoU. Only pairs with IoU greater than zero and at least minIoU() are listed.
+         */
+        std::vector<Result> solve(const std::vector<BoundingBoxType>& tracks, const std::vector<BoundingBoxType>& detections) {
+            RTL_ZONE("rtl::MunkresIoU::solve");
+            // column-major matrix of detections x tracks is the row-major matrix of tracks x detections expected by the solver
+            BoundingBoxType::iouMatrix(detections, tracks, iou_);
+            costs_.assign(iou_.data().data(), iou_.data().data() + iou_.data().size());
+
+            std::vector<Result> output;
+            for (const auto& r : solver_.solve(costs_, tracks.size(), detections.size(), true)) {
+                if (r.cost > 0 && r.cost >= min_iou_) {
+                    output.push_back(r);
+                }
+            }
+            return output;
+        }
+
+        //! IoU of the \p track -th track and \p detection -th detection from the last call of solve().
+        [[nodiscard]] Element iou(size_t track, size_t detection) const { return iou_.getElement(detection, track); }
+
+        //! The underlying solver, e.g. to disable its warm start.
+        MunkresDynamic<Element>& solver() { return solver_; }
+
+    protected:
+
+        Element min_iou_ = 0;
+        Matrix<Eigen::Dynamic, Eigen::Dynamic, Element> iou_;
+        std::vector<Element> costs_;
+        MunkresDynamic<Element> solver_;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_MUNKRESIOU_H
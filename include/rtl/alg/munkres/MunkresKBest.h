@@ -0,0 +1,327 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_MUNKRESKBEST_H
+#define ROBOTICTEMPLATELIBRARY_MUNKRESKBEST_H
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/Matrix.h"
+#include "rtl/core/Span.h"
+#include "rtl/alg/munkres/MunkresDynamic.h"
+
+namespace rtl
+{
+
+    /*!
+     * Enumerator of the k best solutions of the assignment problem (Murty's algorithm), intended for multi-hypothesis tracking.
+     *
+     * The best assignment is found by the MunkresDynamic solver, the others are obtained by repeated partitioning of the solution space.
+     * Each solution is partitioned row by row into subproblems, which fix the rows preceding the partitioning one and forbid the current
+     * assignment of the partitioning one. The subproblem inherits the dual variables and the assignment of its parent: forbidding an edge
+     * keeps the duals feasible and removing the forbidden pair leaves a single free row, therefore each subproblem is solved by a single
+     * shortest augmenting path in O(n^2) instead of a full O(n^3) solution from scratch. Solved subproblems wait in a priority queue
+     * ordered by their cost, the cheapest one is the next best solution.
+     *
+     * Rectangular cost matrices are handled as in MunkresDynamic. Solutions differing only in the assignment of dummy rows or columns are
+     * considered identical, the enumerated solutions are therefore distinct in the assigned pairs.
+     *
+     * @tparam T Data type of values in the cost matrix.
+     */
+    template <typename T>
+    class MunkresKBest : protected MunkresDynamic<T> {
+
+        typedef MunkresDynamic<T> Base;
+        typedef typename Base::DualType DualType;
+
+    public:
+
+        typedef typename Base::Result Result;
+
+        //! Single solution of the assignment problem.
+        struct Hypothesis {
+            std::vector<Result> assignment;     //!< Assigned pairs sorted by rows, min(rows, cols) in total.
+            T cost;                             //!< Sum of costs of the assigned pairs.
+        };
+
+        MunkresKBest() { Base::setWarmStart(false); }
+
+        /*!
+         * Finds up to \p k best solutions of the assignment problem for given cost matrix.
+         *
+         * @param cost_matrix row-major cost matrix of a given problem (rows: workers, cols: jobs) with \p rows * \p cols elements.
+         * @param rows number of rows of the cost matrix.
+         * @param cols number of columns of the cost matrix.
+         * @param k maximal number of solutions to be found.
+         * @param max_cost If true, solutions with the highest sum of costs are searched for.
+         * @return distinct solutions ordered from the best one, fewer than \p k if the problem has no more of them.
+         */
+        std::vector<Hypothesis> solve(const std::vector<T>& cost_matrix, size_t rows, size_t cols, size_t k, bool max_cost = false) {
+            return solve(Span<const T>(cost_matrix), rows, cols, k, max_cost);
+        }
+
+        /*!
+         * Finds up to \p k best solutions of the assignment problem for given cost matrix viewed in an external buffer.
+         *
+         * @param cost_matrix view of the row-major cost matrix of a given problem (rows: workers, cols: jobs) with \p rows * \p cols elements.
+         * @param rows number of rows of the cost matrix.
+         * @param cols number of columns of the cost matrix.
+         * @param k maximal number of solutions to be found.
+         * @param max_cost If true, solutions with the highest sum of costs are searched for.
+         * @return distinct solutions ordered from the best one, fewer than \p k if the problem has no more of them.
+         */
+        std::vector<Hypothesis> solve(Span<const T> cost_matrix, size_t rows, size_t cols, size_t k, bool max_cost = false) {
+            RTL_ZONE("rtl::MunkresKBest::solve");
+            std::vector<Hypothesis> output;
+            if (rows == 0 || cols == 0 || k == 0) {
+                return output;
+            }
+
+            // Only dummy columns are allowed, so that interchangeable dummies affect single rows.
+            transposed_ = cols > rows;
+            if (transposed_) {
+                transposed_costs_.resize(rows * cols);
+                for (size_t r = 0 ; r < rows ; r++) {
+                    for (size_t c = 0 ; c < cols ; c++) {
+                        transposed_costs_[c * rows + r] = cost_matrix[r * cols + c];
+                    }
+                }
+                Base::load_costs(Span<const T>(transposed_costs_), cols, rows, max_cost);
+                cols_ = rows;
+            } else {
+                Base::load_costs(cost_matrix, rows, cols, max_cost);
+                cols_ = cols;
+            }
+            Base::init_duals();
+            for (size_t r = 1 ; r <= n_ ; r++) {
+                if (row_assigned_[r] == 0) {
+                    Base::augment(r);
+                }
+            }
+
+            queue_.clear();
+            queue_.push_back(store_node({}, std::vector<uint8_t>(n_ + 1, 0)));
+            while (!queue_.empty()) {
+                std::pop_heap(queue_.begin(), queue_.end(), Node::worse);
+                Node node = std::move(queue_.back());
+                queue_.pop_back();
+
+                output.push_back(hypothesis(node, cost_matrix, cols));
+                if (output.size() == k) {
+                    break;
+                }
+                partition(node);
+            }
+            return output;
+        }
+
+        /*!
+         * Finds up to \p k best solutions of the assignment problem for given fixed-size, possibly rectangular, cost matrix.
+         *
+         * @param cost_matrix cost matrix of a given problem (rows: workers, cols: jobs).
+         * @param k maximal number of solutions to be found.
+         * @param max_cost If true, solutions with the highest sum of costs are searched for.
+         * @return distinct solutions ordered from the best one, fewer than \p k if the problem has no more of them.
+         */
+        template<int R, int C>
+        std::vector<Hypothesis> solve(const Matrix<R, C, T>& cost_matrix, size_t k, bool max_cost = false) {
+            std::vector<T> costs(R * C);
+            for (int r = 0 ; r < R ; r++) {
+                for (int c = 0 ; c < C ; c++) {
+                    costs[r * C + c] = cost_matrix.getElement(r, c);
+                }
+            }
+            return solve(costs, R, C, k, max_cost);
+        }
+
+    private:
+
+        using Base::n_;
+        using Base::u_;
+        using Base::v_;
+        using Base::row_assigned_;
+        using Base::col_assigned_;
+        using Base::min_reduced_;
+        using Base::visited_;
+        using Base::way_;
+
+        //! Solved subproblem with the constraints it was created from.
+        struct Node {
+            DualType cost;
+            std::vector<DualType> u, v;
+            std::vector<size_t> row_assigned;
+            std::vector<std::pair<size_t, size_t>> forbidden;   //!< Forbidden (row, col) pairs, any col > cols_ stands for all dummies.
+            std::vector<uint8_t> fixed;                         //!< Rows whose assignment must not change.
+
+            static bool worse(const Node& a, const Node& b) { return a.cost > b.cost; }
+        };
+
+        bool is_dummy(size_t c) const { return c > cols_; }
+
+        //! Creates a node from the current state of the solver.
+        Node store_node(std::vector<std::pair<size_t, size_t>> forbidden, std::vector<uint8_t> fixed) const {
+            DualType total = 0;
+            for (size_t r = 1 ; r <= n_ ; r++) {
+                total += Base::cost(r, row_assigned_[r]);
+            }
+            return Node{total, u_, v_, row_assigned_, std::move(forbidden), std::move(fixed)};
+        }
+
+        Hypothesis hypothesis(const Node& node, Span<const T> cost_matrix, size_t cols) const {
+            Hypothesis h{{}, T(0)};
+            h.assignment.reserve(cols_);
+            for (size_t r = 1 ; r <= n_ ; r++) {
+                size_t c = node.row_assigned[r];
+                if (!is_dummy(c)) {
+                    size_t row = transposed_ ? c - 1 : r - 1, col = transposed_ ? r - 1 : c - 1;
+                    h.assignment.emplace_back(row, col, cost_matrix[row * cols + col]);
+                    h.cost += h.assignment.back().cost;
+                }
+            }
+            std::sort(h.assignment.begin(), h.assignment.end(), [](const Result& a, const Result& b) { return a.row < b.row; });
+            return h;
+        }
+
+        void set_forbidden(size_t r, size_t c, uint8_t val) {
+            if (is_dummy(c)) {
+                std::fill(forbidden_.begin() + (r - 1) * n_ + cols_, forbidden_.begin() + r * n_, val);
+            } else {
+                forbidden_[(r - 1) * n_ + c - 1] = val;
+            }
+        }
+
+        //! Pushes all solvable subproblems of the given solution into the queue.
+        void partition(const Node& node) {
+            forbidden_.assign(n_ * n_, 0);
+            for (const auto& [r, c] : node.forbidden) {
+                set_forbidden(r, c, 1);
+            }
+            excluded_.assign(n_ + 1, 0);
+            for (size_t r = 1 ; r <= n_ ; r++) {
+                if (node.fixed[r]) {
+                    excluded_[node.row_assigned[r]] = 1;
+                }
+            }
+
+            std::vector<uint8_t> fixed = node.fixed;
+            for (size_t r = 1 ; r <= n_ ; r++) {
+                if (fixed[r]) {
+                    continue;
+                }
+                size_t c = node.row_assigned[r];
+
+                u_ = node.u;
+                v_ = node.v;
+                row_assigned_ = node.row_assigned;
+                col_assigned_.assign(n_ + 1, 0);
+                for (size_t row = 1 ; row <= n_ ; row++) {
+                    col_assigned_[row_assigned_[row]] = row;
+                }
+                row_assigned_[r] = 0;
+                col_assigned_[c] = 0;
+
+                set_forbidden(r, c, 1);
+                if (augment_constrained(r)) {
+                    auto forbidden = node.forbidden;
+                    forbidden.emplace_back(r, c);
+                    queue_.push_back(store_node(std::move(forbidden), fixed));
+                    std::push_heap(queue_.begin(), queue_.end(), Node::worse);
+                }
+                set_forbidden(r, c, 0);
+
+                fixed[r] = 1;
+                excluded_[c] = 1;
+            }
+        }
+
+        //! Shortest augmenting path from the given row avoiding forbidden pairs and excluded columns.
+        bool augment_constrained(size_t row) {
+            constexpr DualType unreached = std::numeric_limits<DualType>::max();
+            min_reduced_.assign(n_ + 1, unreached);
+            visited_.assign(n_ + 1, 0);
+            way_.assign(n_ + 1, 0);
+
+            col_assigned_[0] = row;
+            size_t c0 = 0;
+            do {
+                visited_[c0] = 1;
+                size_t r0 = col_assigned_[c0], c1 = 0;
+                DualType delta = unreached;
+                const size_t row_offset = (r0 - 1) * n_ - 1;
+                for (size_t c = 1 ; c <= n_ ; c++) {
+                    if (!visited_[c] && !excluded_[c]) {
+                        if (!forbidden_[row_offset + c]) {
+                            DualType reduced = Base::cost(r0, c) - u_[r0] - v_[c];
+                            if (reduced < min_reduced_[c]) {
+                                min_reduced_[c] = reduced;
+                                way_[c] = c0;
+                            }
+                        }
+                        if (min_reduced_[c] < delta) {
+                            delta = min_reduced_[c];
+                            c1 = c;
+                        }
+                    }
+                }
+                if (c1 == 0) {
+                    return false;
+                }
+                for (size_t c = 0 ; c <= n_ ; c++) {
+                    if (visited_[c]) {
+                        u_[col_assigned_[c]] += delta;
+                        v_[c] -= delta;
+                    } else if (min_reduced_[c] != unreached) {
+                        min_reduced_[c] -= delta;
+                    }
+                }
+                c0 = c1;
+            } while (col_assigned_[c0] != 0);
+
+            do {
+                size_t c1 = way_[c0];
+                col_assigned_[c0] = col_assigned_[c1];
+                row_assigned_[col_assigned_[c0]] = c0;
+                c0 = c1;
+            } while (c0 != 0);
+            col_assigned_[0] = 0;
+            v_[0] = 0;
+            return true;
+        }
+
+        bool transposed_ = false;
+        size_t cols_ = 0;
+        std::vector<T> transposed_costs_;
+        std::vector<uint8_t> forbidden_, excluded_;
+        std::vector<Node> queue_;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_MUNKRESKBEST_H
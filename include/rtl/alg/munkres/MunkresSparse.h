@@ -0,0 +1,238 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_MUNKRESSPARSE_H
+#define ROBOTICTEMPLATELIBRARY_MUNKRESSPARSE_H
+
+#include <vector>
+#include <numeric>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+#include "rtl/core/Executor.h"
+#include "rtl/core/Instrumentation.h"
+#include "rtl/alg/munkres/MunkresDynamic.h"
+
+namespace rtl
+{
+
+    //! Admissible pair of row and column with its cost, an element of the sparse input of MunkresSparse.
+    template <typename T>
+    struct MunkresEdge {
+        MunkresEdge() : row{0}, col{0} {}
+        MunkresEdge(size_t r, size_t c, T cst) : row{r}, col{c}, cost{cst} {};
+        size_t row;
+        size_t col;
+        T cost;
+    };
+
+    /*!
+     * Solver of the gated assignment problem given by a sparse list of admissible row-column pairs.
+     *
+     * Pairs missing in the list are ruled out (e.g. by gating in a tracker) and are never assigned. The bipartite graph
+     * of the admissible pairs is split into connected components, which are solved independently by MunkresDynamic,
+     * possibly in parallel by the given executor. Within each component, the maximal number of pairs is assigned and
+     * among such assignments the one with the smallest (or largest) cost sum is chosen. Components with a single row
+     * or column are resolved directly without the solver.
+     *
+     * @tparam T Data type of the costs.
+     * @tparam Executor execution policy for the components, see rtl/core/Executor.h.
+     */
+    template <typename T, class Executor = SequentialExecutor>
+    class MunkresSparse {
+
+        //! Type of the costs in the components, integral costs are widened and made signed.
+        typedef std::conditional_t<std::is_floating_point_v<T>, T, long long> CostType;
+
+    public:
+
+        typedef typename MunkresDynamic<T>::Result Result;
+
+        typedef MunkresEdge<T> Edge;
+
+        MunkresSparse() = default;
+
+        /*!
+         * Construction with given executor.
+         *
+         * @param executor Executor used for parallel processing of the connected components.
+         */
+        explicit MunkresSparse(Executor executor) : executor_{std::move(executor)} {}
+
+        /*!
+         * Solves the gated assignment problem.
+         *
+         * @param edges admissible pairs of the problem (rows: workers, cols: jobs). If a pair is listed multiple times, the better cost is used.
+         * @param rows number of rows of the problem.
+         * @param cols number of columns of the problem.
+         * @param max_cost If true, algorithm maximize sum of all costs (suitable for best IoU search)
+         * @return assigned pairs sorted by rows.
+         */
+        std::vector<Result> solve(const std::vector<Edge>& edges, size_t rows, size_t cols, bool max_cost = false) {
+            RTL_ZONE("rtl::MunkresSparse::solve");
+            split_components(edges, rows, cols);
+
+            std::vector<std::vector<Result>> partial(componentNr());
+            executor_(0, partial.size(), [&](size_t begin, size_t end) {
+                MunkresDynamic<CostType> solver;
+                solver.setWarmStart(false);
+                for (size_t i = begin ; i < end ; i++) {
+                    partial[i] = solve_component(edges, i, solver, max_cost);
+                }
+            });
+
+            std::vector<Result> output;
+            for (const auto& p : partial) {
+                output.insert(output.end(), p.begin(), p.end());
+            }
+            std::sort(output.begin(), output.end(), [](const Result& a, const Result& b) { return a.row < b.row; });
+            return output;
+        }
+
+        //! Number of connected components of the last solved problem.
+        [[nodiscard]] size_t componentNr() const { return comp_edges_.empty() ? 0 : comp_edges_.size() - 1; }
+
+    protected:
+
+        size_t find_root(size_t n) {
+            while (parent_[n] != n) {
+                parent_[n] = parent_[parent_[n]];
+                n = parent_[n];
+            }
+            return n;
+        }
+
+        //! Labels rows and columns (shifted by the row count) by union-find and groups edge indices by components.
+        void split_components(const std::vector<Edge>& edges, size_t rows, size_t cols) {
+            parent_.resize(rows + cols);
+            std::iota(parent_.begin(), parent_.end(), 0);
+            for (const auto& e : edges) {
+                size_t a = find_root(e.row), b = find_root(rows + e.col);
+                if (a != b) {
+                    parent_[std::max(a, b)] = std::min(a, b);
+                }
+            }
+
+            comp_index_.assign(rows + cols, npos);
+            size_t comp_nr = 0;
+            for (const auto& e : edges) {
+                size_t root = find_root(e.row);
+                if (comp_index_[root] == npos) {
+                    comp_index_[root] = comp_nr++;
+                }
+            }
+
+            comp_edges_.assign(comp_nr + 1, 0);
+            for (const auto& e : edges) {
+                comp_edges_[comp_index_[find_root(e.row)] + 1]++;
+            }
+            for (size_t c = 1 ; c <= comp_nr ; c++) {
+                comp_edges_[c] += comp_edges_[c - 1];
+            }
+            std::vector<size_t> fill(comp_edges_.begin(), comp_edges_.end() - 1);
+            edge_order_.resize(edges.size());
+            for (size_t i = 0 ; i < edges.size() ; i++) {
+                edge_order_[fill[comp_index_[find_root(edges[i].row)]]++] = i;
+            }
+        }
+
+        std::vector<Result> solve_component(const std::vector<Edge>& edges, size_t comp, MunkresDynamic<CostType>& solver, bool max_cost) const {
+            auto first = edge_order_.begin() + comp_edges_[comp], last = edge_order_.begin() + comp_edges_[comp + 1];
+            auto better = [max_cost](T a, T b) { return max_cost ? a > b : a < b; };
+
+            std::vector<size_t> row_ids, col_ids;
+            for (auto it = first ; it != last ; it++) {
+                row_ids.push_back(edges[*it].row);
+                col_ids.push_back(edges[*it].col);
+            }
+            std::sort(row_ids.begin(), row_ids.end());
+            row_ids.erase(std::unique(row_ids.begin(), row_ids.end()), row_ids.end());
+            std::sort(col_ids.begin(), col_ids.end());
+            col_ids.erase(std::unique(col_ids.begin(), col_ids.end()), col_ids.end());
+
+            if (row_ids.size() == 1 || col_ids.size() == 1) {
+                const Edge* best = &edges[*first];
+                for (auto it = first ; it != last ; it++) {
+                    if (better(edges[*it].cost, best->cost)) { best = &edges[*it]; }
+                }
+                return {Result(best->row, best->col, best->cost)};
+            }
+
+            // Costs are shifted to be non-negative, non-admissible pairs get the cost higher than any admissible assignment.
+            size_t r_nr = row_ids.size(), c_nr = col_ids.size();
+            auto local = [](const std::vector<size_t>& ids, size_t id) { return std::lower_bound(ids.begin(), ids.end(), id) - ids.begin(); };
+            std::vector<size_t> edge_ids(r_nr * c_nr, npos);
+            for (auto it = first ; it != last ; it++) {
+                size_t& dst = edge_ids[local(row_ids, edges[*it].row) * c_nr + local(col_ids, edges[*it].col)];
+                if (dst == npos || better(edges[*it].cost, edges[dst].cost)) {
+                    dst = *it;
+                }
+            }
+
+            CostType min_cost = std::numeric_limits<CostType>::max();
+            for (auto it = first ; it != last ; it++) {
+                min_cost = std::min(min_cost, signed_cost(edges[*it].cost, max_cost));
+            }
+            CostType forbidden = 1;
+            std::vector<CostType> costs(r_nr * c_nr);
+            for (size_t i = 0 ; i < costs.size() ; i++) {
+                if (edge_ids[i] != npos) {
+                    costs[i] = signed_cost(edges[edge_ids[i]].cost, max_cost) - min_cost;
+                    forbidden += costs[i];
+                }
+            }
+            for (size_t i = 0 ; i < costs.size() ; i++) {
+                if (edge_ids[i] == npos) { costs[i] = forbidden; }
+            }
+
+            std::vector<Result> output;
+            for (const auto& r : solver.solve(costs, r_nr, c_nr)) {
+                size_t e = edge_ids[r.row * c_nr + r.col];
+                if (e != npos) {
+                    output.emplace_back(edges[e].row, edges[e].col, edges[e].cost);
+                }
+            }
+            return output;
+        }
+
+        static CostType signed_cost(T cost, bool max_cost) {
+            auto c = static_cast<CostType>(cost);
+            return max_cost ? -c : c;
+        }
+
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        Executor executor_;
+        std::vector<size_t> parent_;
+        std::vector<size_t> comp_index_;
+        std::vector<size_t> comp_edges_;
+        std::vector<size_t> edge_order_;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_MUNKRESSPARSE_H
@@ -0,0 +1,104 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Adam Ligocki <adam.ligocki@vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_ADAPTATION_H
+#define ROBOTICTEMPLATELIBRARY_ADAPTATION_H
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace rtl {
+
+    /*!
+     * Adaptation policies for the AdaptiveParticleFilter.
+     * Each policy is a callable object with the following signature:
+     *
+     *     template<typename Particles> size_t operator()(const Particles& survivors);
+     *
+     * where Particles is std::vector<ParticleType> holding the particles selected by the resampling, i.e. an unweighted sample of the posterior.
+     * The policy returns the number of posterior samples required for the next epoch, the filter scales it by the survivor ratio and clamps it to its bounds.
+     */
+
+    /*!
+     * KLD-sampling (Fox, 2003). The posterior is approximated by a histogram and the number of samples is chosen so that, with probability 1 - delta,
+     * the Kullback-Leibler divergence between the sample-based and the true posterior stays below epsilon. For k occupied bins the required number of samples is
+     *
+     *     n = (k - 1) / (2 epsilon) * (1 - 2 / (9 (k - 1)) + sqrt(2 / (9 (k - 1))) z)^3,
+     *
+     * where z is the upper 1 - delta quantile of the standard normal distribution. A spread posterior occupies many bins and demands many particles,
+     * a concentrated one only a few.
+     *
+     * The ParticleType has to provide `std::int64_t bin() const` returning the index of the histogram bin the particle falls into. Multi-dimensional particles
+     * combine their per-axis indices into a single key, the bin size controls the resolution of the adaptation.
+     */
+    class KldSampling {
+    public:
+
+        /*!
+         * Constructor with the error bounds
+         * @param epsilon Upper bound of the Kullback-Leibler divergence
+         * @param z Upper 1 - delta quantile of the standard normal distribution, the default 2.326 corresponds to delta = 0.01
+         */
+        explicit KldSampling(double epsilon = 0.05, double z = 2.326) : epsilon_{epsilon}, z_{z} {}
+
+        template<typename Particles>
+        size_t operator()(const Particles& survivors) {
+            bins_.clear();
+            bins_.reserve(survivors.capacity());
+            for (const auto& particle : survivors) {
+                bins_.push_back(particle.bin());
+            }
+            std::sort(bins_.begin(), bins_.end());
+            auto k = static_cast<size_t>(std::unique(bins_.begin(), bins_.end()) - bins_.begin());
+            return required_samples(k);
+        }
+
+        /*!
+         * Number of samples required for given number of occupied bins
+         * @param k Number of occupied histogram bins
+         * @return Required number of samples
+         */
+        [[nodiscard]] size_t required_samples(size_t k) const {
+            if (k <= 1) {
+                return 1;
+            }
+            double a = 2.0 / (9.0 * (k - 1));
+            double b = 1.0 - a + std::sqrt(a) * z_;
+            return static_cast<size_t>(std::ceil((k - 1) / (2.0 * epsilon_) * b * b * b));
+        }
+
+    private:
+        double epsilon_;
+        double z_;
+        std::vector<std::int64_t> bins_;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_ADAPTATION_H
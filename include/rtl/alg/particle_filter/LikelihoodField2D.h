@@ -0,0 +1,353 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Adam Ligocki <adam.ligocki@vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_LIKELIHOODFIELD2D_H
+#define ROBOTICTEMPLATELIBRARY_LIKELIHOODFIELD2D_H
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+#include <rtl/core/Span.h>
+#include <rtl/core/VectorND.h>
+#include <rtl/core/LineSegmentND.h>
+#include <rtl/tf/RigidTfND.h>
+#include "rtl/core/Instrumentation.h"
+
+namespace rtl {
+
+    /*!
+     * Likelihood-field sensor model for Monte Carlo localization in a 2D map.
+     *
+     * The map, given as line segments or points, is rasterized into a grid of square cells once and a distance transform assigns each cell the distance
+     * of its center to the nearest map primitive. The distance is clamped to max_distance and converted to the log-likelihood of a beam end-point
+     *   log(z_hit * exp(-d^2 / (2 * sigma^2)) + z_rand),
+     * which is stored per cell, so scoring a beam is a single table lookup. End-points outside the grid score as if they were max_distance away.
+     *
+     * The batch overload of log_likelihood() matches the static log_belief(Span<const ParticleType>, const Measurement&, Span<double>) of the particles,
+     * so a particle type holding a pose can forward its batch scoring to a shared field and ParticleFilter::correction() runs in O(particles * beams).
+     * All queries are const and can be called concurrently from the executor of the filter.
+     *
+     * @tparam Element Base type of the map coordinates
+     */
+    template<typename Element>
+    class LikelihoodField2D {
+    public:
+        using VectorType = VectorND<2, Element>;
+        using LineSegmentType = LineSegmentND<2, Element>;
+        using TransformationType = RigidTfND<2, Element>;
+
+        /*!
+         * Sets up the sensor model, the field is empty until build() is called
+         * @param resolution Length of the side of a grid cell
+         * @param sigma Standard deviation of the measurement noise
+         * @param max_distance Distance the likelihood is clamped at, also the margin of the grid around the map
+         * @param z_hit Weight of the Gaussian hit component
+         * @param z_rand Weight of the uniform component modeling random measurements
+         */
+        LikelihoodField2D(Element resolution, Element sigma, Element max_distance, Element z_hit = 0.95, Element z_rand = 0.05)
+                : resolution_{resolution}, sigma_{sigma}, max_distance_{max_distance}, z_hit_{z_hit}, z_rand_{z_rand} {
+            if (!(resolution > 0) || !(sigma > 0) || !(max_distance > 0)) {
+                throw std::invalid_argument("LikelihoodField2D: resolution, sigma and max_distance have to be positive.");
+            }
+            if (!(z_hit >= 0) || !(z_rand > 0)) {
+                throw std::invalid_argument("LikelihoodField2D: z_hit has to be non-negative and z_rand positive.");
+            }
+            inv_resolution_ = Element(1) / resolution_;
+            outside_ = log_likelihood_of(max_distance_);
+        }
+
+        /*!
+         * Precomputes the field from line segments. Distances are measured to the segments themselves, the nearest segment of each cell is found
+         * on their rasterization, so the distances are exact up to the resolution of the grid.
+         * @param segments Line segments of the map
+         */
+        void build(Span<const LineSegmentType> segments) {
+            RTL_ZONE("rtl::LikelihoodField2D::build");
+            std::vector<VectorType> corners;
+            corners.reserve(2 * segments.size());
+            for (const auto& s : segments) {
+                corners.push_back(s.beg());
+                corners.push_back(s.end());
+            }
+            if (!init_grid(corners)) {
+                return;
+            }
+            const Element step = resolution_ / 2;
+            for (size_t k = 0 ; k < segments.size() ; k++) {
+                const auto& s = segments[k];
+                const size_t samples = static_cast<size_t>(std::ceil(s.length() / step)) + 1;
+                for (size_t i = 0 ; i <= samples ; i++) {
+                    const Element t = static_cast<Element>(i) / static_cast<Element>(samples);
+                    seed(s.beg() + (s.end() - s.beg()) * t, k);
+                }
+            }
+            distance_transform([&](const VectorType& pt, size_t k) {
+                return segments[k].segmentDistanceToPointSquared(pt);
+            });
+        }
+
+        /*!
+         * Precomputes the field from points, e.g. an occupancy map or a registered point cloud.
+         * @param points Points of the map
+         */
+        void build(Span<const VectorType> points) {
+            RTL_ZONE("rtl::LikelihoodField2D::build");
+            if (!init_grid(points)) {
+                return;
+            }
+            for (size_t k = 0 ; k < points.size() ; k++) {
+                seed(points[k], k);
+            }
+            distance_transform([&](const VectorType& pt, size_t k) {
+                return (points[k] - pt).lengthSquared();
+            });
+        }
+
+        /*!
+         * Distance of the nearest map primitive to the center of the cell containing given point
+         * @param pt Point in the map frame
+         * @return Distance clamped to max_distance
+         */
+        [[nodiscard]] Element distance(const VectorType& pt) const {
+            const size_t c = cell(pt.x(), pt.y());
+            return c < distances_.size() ? distances_[c] : max_distance_;
+        }
+
+        /*!
+         * Log-likelihood of a single beam end-point
+         * @param pt Beam end-point in the map frame
+         * @return Log-likelihood of the end-point
+         */
+        [[nodiscard]] double log_likelihood(const VectorType& pt) const {
+            const size_t c = cell(pt.x(), pt.y());
+            return c < log_likelihoods_.size() ? log_likelihoods_[c] : outside_;
+        }
+
+        /*!
+         * Log-likelihood of a scan taken from given pose, the beams are scored independently and their log-likelihoods summed.
+         * The pose is applied by its cosine and sine directly and each beam costs a single lookup, so the loop does not branch on the map.
+         * @param pose Pose of the sensor in the map frame
+         * @param beams Beam end-points in the sensor frame
+         * @return Log-likelihood of the scan
+         */
+        [[nodiscard]] double log_likelihood(const TransformationType& pose, Span<const VectorType> beams) const {
+            const Element c = pose.rotCos(), s = pose.rotSin(), tx = pose.trVecX(), ty = pose.trVecY();
+            const size_t n = log_likelihoods_.size();
+            double sum = 0.0;
+            for (size_t i = 0 ; i < beams.size() ; i++) {
+                const Element x = c * beams[i].x() - s * beams[i].y() + tx;
+                const Element y = s * beams[i].x() + c * beams[i].y() + ty;
+                const size_t idx = cell(x, y);
+                sum += idx < n ? log_likelihoods_[idx] : outside_;
+            }
+            return sum;
+        }
+
+        /*!
+         * Log-likelihoods of a scan for a batch of particles, the counterpart of the static ParticleType::log_belief() batch scoring.
+         * @param particles Contiguous batch of particles
+         * @param pose_of Callable returning the sensor pose (TransformationType) of a particle
+         * @param beams Beam end-points in the sensor frame
+         * @param log_weights Output log-likelihoods, one per particle
+         */
+        template<typename ParticleType, typename PoseOf>
+        void log_likelihood(Span<const ParticleType> particles, PoseOf&& pose_of, Span<const VectorType> beams, Span<double> log_weights) const {
+            for (size_t i = 0 ; i < particles.size() ; i++) {
+                log_weights[i] = log_likelihood(pose_of(particles[i]), beams);
+            }
+        }
+
+        //! Length of the side of a grid cell
+        [[nodiscard]] Element resolution() const { return resolution_; }
+
+        //! Distance the likelihood is clamped at
+        [[nodiscard]] Element max_distance() const { return max_distance_; }
+
+        //! Number of the grid columns
+        [[nodiscard]] size_t cells_x() const { return cells_x_; }
+
+        //! Number of the grid rows
+        [[nodiscard]] size_t cells_y() const { return cells_y_; }
+
+    private:
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        /*!
+         * Sizes the grid to the bounding box of the map extended by max_distance on each side.
+         * @param pts Points spanning the map
+         * @return False if the map is empty and the field was cleared
+         */
+        bool init_grid(Span<const VectorType> pts) {
+            distances_.clear();
+            log_likelihoods_.clear();
+            cells_x_ = cells_y_ = 0;
+            if (pts.empty()) {
+                return false;
+            }
+            VectorType b_min = pts[0], b_max = pts[0];
+            for (const auto& p : pts) {
+                for (size_t i = 0 ; i < 2 ; i++) {
+                    b_min[i] = std::min(b_min[i], p[i]);
+                    b_max[i] = std::max(b_max[i], p[i]);
+                }
+            }
+            origin_x_ = b_min.x() - max_distance_;
+            origin_y_ = b_min.y() - max_distance_;
+            cells_x_ = static_cast<size_t>((b_max.x() - b_min.x() + 2 * max_distance_) * inv_resolution_) + 1;
+            cells_y_ = static_cast<size_t>((b_max.y() - b_min.y() + 2 * max_distance_) * inv_resolution_) + 1;
+            seeds_.assign(cells_x_ * cells_y_, npos);
+            return true;
+        }
+
+        /*!
+         * Linear index of the cell containing given point
+         * @return Index of the cell, or a value not smaller than the number of cells for points outside the grid
+         */
+        [[nodiscard]] size_t cell(Element x, Element y) const {
+            const Element fx = std::floor((x - origin_x_) * inv_resolution_), fy = std::floor((y - origin_y_) * inv_resolution_);
+            const bool inside = fx >= 0 && fy >= 0 && fx < static_cast<Element>(cells_x_) && fy < static_cast<Element>(cells_y_);
+            return inside ? static_cast<size_t>(fy) * cells_x_ + static_cast<size_t>(fx) : npos;
+        }
+
+        //! Marks the cell containing \p pt as occupied by map primitive \p k.
+        void seed(const VectorType& pt, size_t k) {
+            const size_t c = cell(pt.x(), pt.y());
+            if (c < seeds_.size()) {
+                seeds_[c] = k;
+            }
+        }
+
+        [[nodiscard]] double log_likelihood_of(Element d) const {
+            const double dd = static_cast<double>(std::min(d, max_distance_)) / sigma_;
+            return std::log(z_hit_ * std::exp(-0.5 * dd * dd) + z_rand_);
+        }
+
+        /*!
+         * Exact Euclidean distance transform of the seeded cells by Felzenszwalb and Huttenlocher. Columns are swept for the nearest seeded row first,
+         * the rows then take the lower envelope of the parabolas rooted in the columns. The winning seed of each cell is tracked, so the final distance
+         * is measured from the cell center to the map primitive itself.
+         * @param distance_squared Callable returning squared distance of a point to the k-th map primitive
+         */
+        template<typename DistanceSquared>
+        void distance_transform(DistanceSquared&& distance_squared) {
+            const size_t cx = cells_x_, cy = cells_y_;
+            nearest_row_.assign(cx * cy, npos);
+            for (size_t x = 0 ; x < cx ; x++) {
+                size_t last = npos;
+                for (size_t y = 0 ; y < cy ; y++) {
+                    if (seeds_[y * cx + x] != npos) {
+                        last = y;
+                    }
+                    nearest_row_[y * cx + x] = last;
+                }
+                last = npos;
+                for (size_t y = cy ; y-- > 0 ;) {
+                    if (seeds_[y * cx + x] != npos) {
+                        last = y;
+                    }
+                    size_t& row = nearest_row_[y * cx + x];
+                    if (last != npos && (row == npos || last - y < y - row)) {
+                        row = last;
+                    }
+                }
+            }
+
+            distances_.assign(cx * cy, max_distance_);
+            log_likelihoods_.assign(cx * cy, static_cast<float>(outside_));
+            f_.resize(cx);
+            v_.resize(cx);
+            z_.resize(cx + 1);
+            const double inf = std::numeric_limits<double>::infinity();
+            for (size_t y = 0 ; y < cy ; y++) {
+                for (size_t x = 0 ; x < cx ; x++) {
+                    const size_t row = nearest_row_[y * cx + x];
+                    const double dy = row == npos ? 0.0 : static_cast<double>(row) - static_cast<double>(y);
+                    f_[x] = row == npos ? inf : dy * dy;
+                }
+                size_t k = 0;
+                bool any = false;
+                for (size_t q = 0 ; q < cx ; q++) {
+                    if (f_[q] == inf) {
+                        continue;
+                    }
+                    if (!any) {
+                        v_[0] = q;
+                        z_[0] = -inf;
+                        z_[1] = inf;
+                        any = true;
+                        continue;
+                    }
+                    double s;
+                    while (true) {
+                        const double p = static_cast<double>(v_[k]), r = static_cast<double>(q);
+                        s = ((f_[q] + r * r) - (f_[v_[k]] + p * p)) / (2.0 * (r - p));
+                        if (k > 0 && s <= z_[k]) {
+                            k--;
+                        } else {
+                            break;
+                        }
+                    }
+                    k++;
+                    v_[k] = q;
+                    z_[k] = s;
+                    z_[k + 1] = inf;
+                }
+                if (!any) {
+                    continue;
+                }
+                k = 0;
+                for (size_t x = 0 ; x < cx ; x++) {
+                    while (z_[k + 1] < static_cast<double>(x)) {
+                        k++;
+                    }
+                    const size_t site = v_[k];
+                    const size_t primitive = seeds_[nearest_row_[y * cx + site] * cx + site];
+                    const VectorType center(origin_x_ + (static_cast<Element>(x) + Element(0.5)) * resolution_,
+                                            origin_y_ + (static_cast<Element>(y) + Element(0.5)) * resolution_);
+                    const Element d = std::min(static_cast<Element>(std::sqrt(distance_squared(center, primitive))), max_distance_);
+                    distances_[y * cx + x] = d;
+                    log_likelihoods_[y * cx + x] = static_cast<float>(log_likelihood_of(d));
+                }
+            }
+        }
+
+        Element resolution_, inv_resolution_, sigma_, max_distance_, z_hit_, z_rand_;
+        Element origin_x_{0}, origin_y_{0};
+        size_t cells_x_{0}, cells_y_{0};
+        double outside_;
+        std::vector<Element> distances_;
+        std::vector<float> log_likelihoods_;
+        std::vector<size_t> seeds_, nearest_row_, v_;
+        std::vector<double> f_, z_;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_LIKELIHOODFIELD2D_H
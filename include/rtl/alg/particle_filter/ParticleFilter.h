@@ -27,76 +27,192 @@
 #ifndef ROBOTICTEMPLATELIBRARY_PARTICLEFILTER_H
 #define ROBOTICTEMPLATELIBRARY_PARTICLEFILTER_H
 
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include <memory_resource>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <experimental/type_traits>
+
+#include <rtl/core/Executor.h>
+#include <rtl/core/Span.h>
+#include <rtl/core/RandomStream.h>
+#include <rtl/alg/particle_filter/Adaptation.h>
+#include <rtl/alg/particle_filter/Resampling.h>
 #include <rtl/alg/particle_filter/SimpleParticle.h>
 
+#include "rtl/core/Instrumentation.h"
+
 namespace rtl {
 
+    template<typename P, typename Measurement>
+    using BatchLogBeliefResult = decltype(P::log_belief(std::declval<Span<const P>>(), std::declval<const Measurement &>(), std::declval<Span<double>>()));
+
+    //! Tests whether particle type \p P provides static log_belief(Span<const P>, const Measurement &, Span<double>) scoring a batch of particles in log domain.
+    template<typename P, typename Measurement>
+    constexpr bool has_batch_log_belief_v = std::experimental::is_detected<BatchLogBeliefResult, P, Measurement>::value;
+
+    template<typename P, typename Measurement>
+    using LogBeliefResult = decltype(std::declval<P &>().log_belief(std::declval<const Measurement &>()));
+
+    //! Tests whether particle type \p P provides log_belief(const Measurement &) scoring a single particle in log domain.
+    template<typename P, typename Measurement>
+    constexpr bool has_log_belief_v = std::experimental::is_detected<LogBeliefResult, P, Measurement>::value;
+
+    template<typename P>
+    using SpanEvaluationResult = decltype(P::evaluation(std::declval<Span<const P>>()));
+
+    //! Tests whether particle type \p P provides static evaluation(Span<const P>) estimating the state from a view of the particles.
+    template<typename P>
+    constexpr bool has_span_evaluation_v = std::experimental::is_detected<SpanEvaluationResult, P>::value;
+
+    template<typename P>
+    using AccumulatorType = typename P::Accumulator;
+
+    //! Tests whether particle type \p P provides Accumulator type computing the weighted state estimate during the correction.
+    template<typename P>
+    constexpr bool has_accumulator_v = std::experimental::is_detected<AccumulatorType, P>::value;
+
 
     /*!
-     * Generic implementation of the particle filter with custom-implemented particle type.
-     * Particle filter implemnets following phases:
-     * 1] Particle initialization
-     * 2] Predict particle movement (control input)
-     * 3] Evaluate particles w.r.t. the measurement (correction)
-     * 4] Resampling - random selection of N particles and generating new, random ones
-     * 5] Evaluating result. From survived particles, estimate value.
-     * 6] Back to phase 2
+     * Non-constructable base of ParticleFilter and AdaptiveParticleFilter. Implements the phases shared by both filters on a population, whose size is set at run-time.
+     *
+     * Particles and their weights are stored in separate arrays. Weights are evaluated in log domain and normalized by the log-sum-exp trick, so products
+     * of small likelihoods do not underflow even for large populations. The particle is scored by the first of the following it provides:
+     *  - static void log_belief(Span<const ParticleType>, const Measurement&, Span<double>) - log-likelihoods of a contiguous batch of particles,
+     *    which lets simple particle types vectorize the scoring across particles,
+     *  - double log_belief(const Measurement&) - log-likelihood of a single particle,
+     *  - float belief(const Measurement&) - likelihood of a single particle, its logarithm is taken by the filter.
+     *
+     * If the ParticleType provides static random(Engine&), new particles are generated in parallel by the executor. Particles are split into fixed blocks, each
+     * of them drawing from its own stream of rtl::RandomStreams, so after seed() the filter produces the same results for any executor. If it also provides
+     * static random(Span<ParticleType>, Engine&), each block is filled by a single call, e.g. through Xoshiro256PlusPlusBulk seeded from the stream.
      *
      * @tparam ParticleType Custom data type of the particle
-     * @tparam no_of_particles Number of particles at the beginning of each epoch
-     * @tparam no_of_survivors Number of particles, that survives epoch
+     * @tparam Executor Execution policy for prediction and correction phases (see rtl/core/Executor.h)
+     * @tparam Resampling Resampling policy selecting the survivals (see rtl/alg/particle_filter/Resampling.h)
+     * @tparam Allocator Allocator of the particle buffers, rebound to their element types
      * */
-    template<typename ParticleType, size_t no_of_particles, size_t no_of_survivors>
-    class ParticleFilter {
-
-        using score_type = float;
-
+    template<typename ParticleType, class Executor, class Resampling, class Allocator>
+    class ParticleFilter_common {
     public:
 
         /*!
-         * Default constructor. Generates initial population
+         * Seeds random streams of the filter and generates new initial population from them
+         * @param seed Common seed of all random streams, randomized resampling policies with seed(uint64_t) are seeded as well
          * */
-        ParticleFilter() {
-            init();
-        }
-
-
-        /*!
-         * Iterates full single epoch
-         *
-         * @param action control input to all particles
-         * @param measurement measured states after the correction
-         * */
-        void iteration(const typename ParticleType::Action& action, const typename ParticleType::Measurement& measurement) {
-            prediction(action);
-            correction(measurement);
-            resampling();
+        void seed(uint64_t seed) {
+            RandomStreams streams(seed);
+            streams.streams(particle_blocks() + 1, streams_);
+            if constexpr (has_seed_v<Resampling>) {
+                resampling_.seed(streams_.back()());
+            }
+            particles_.clear();
+            init_particles();
         }
 
         /*!
          * Takes survivals form last epoch end returns state value estimated by the particle filter
+         * If ParticleType::evaluation() accepts Span<const ParticleType>, it views the survivors in place, otherwise they are copied into a vector first.
+         * Survivors come out of the resampling with equal weights, so no weights are passed.
          * @return Evaluated state value
          */
         typename ParticleType::Result evaluate() {
-            std::vector<ParticleType> evaluation_particles;
-            evaluation_particles.reserve(no_of_survivors);
+            if constexpr (has_span_evaluation_v<ParticleType>) {
+                return ParticleType::evaluation(Span<const ParticleType>(particles_.data(), std::min(survivors_, particles_.size())));
+            } else {
+                evaluation_particles_.clear();
+                evaluation_particles_.reserve(survivors_);
 
-            for (size_t i = 0 ; i < no_of_survivors ; i++) {
-                evaluation_particles.push_back(particles_.at(i).first);
+                for (size_t i = 0 ; i < survivors_ ; i++) {
+                    evaluation_particles_.push_back(particles_.at(i));
+                }
+                return ParticleType::evaluation(evaluation_particles_);
             }
-            return ParticleType::evaluation(evaluation_particles);
         }
 
-    private:
+        /*!
+         * Weighted state estimate of the population scored by the last correction, accumulated while the weights were evaluated.
+         * Requires ParticleType::Accumulator, which is default constructible and provides add(const ParticleType&, double weight),
+         * merge(const Accumulator&, double scale) and Result result() const. Weights passed to the accumulator are relative to the maximal weight.
+         * @return Estimated state value, unspecified before the first iteration
+         */
+        typename ParticleType::Result estimate() const {
+            static_assert(has_accumulator_v<ParticleType>, "ParticleFilter::estimate() requires ParticleType::Accumulator.");
+            return estimate_.result();
+        }
+
+        /*!
+         * Number of particles in the current population
+         * @return Size of the population
+         */
+        [[nodiscard]] size_t size() const {
+            return particles_.size();
+        }
+
+    protected:
+
+        using EngineType = RandomStreams::EngineType;
+        using ParticleAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<ParticleType>;
+        using ScoreAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<double>;
+        using Particles = std::vector<ParticleType, ParticleAllocator>;
+        using Weights = std::vector<double, ScoreAllocator>;
+        using Accumulator = std::experimental::detected_or_t<std::nullptr_t, AccumulatorType, ParticleType>;
+        using AccumulatorAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Accumulator>;
+
+        static constexpr size_t particle_block = 256;
+
+        /*!
+         * Allocates all buffers for given maximal population and generates the initial one
+         * @param capacity Maximal number of particles
+         * @param population Number of particles of the initial population
+         * @param survivors Number of particles, that survives the first epoch
+         * @param executor Executor used for parallel processing of the particles
+         * @param alloc Allocator of the particle buffers
+         */
+        ParticleFilter_common(size_t capacity, size_t population, size_t survivors, Executor executor, const Allocator& alloc)
+                : particles_(ParticleAllocator(alloc)), back_particles_(ParticleAllocator(alloc)), weights_(ScoreAllocator(alloc)),
+                  chunk_sums_(ScoreAllocator(alloc)), chunk_scales_(ScoreAllocator(alloc)), chunk_estimates_(AccumulatorAllocator(alloc)),
+                  executor_{std::move(executor)}, capacity_{capacity}, population_{population}, survivors_{survivors} {
+            init();
+        }
+
+        /*!
+         * Number of blocks of particles generated from a single random stream
+         * @return Number of blocks covering the maximal population
+         */
+        [[nodiscard]] size_t particle_blocks() const {
+            return (capacity_ + particle_block - 1) / particle_block;
+        }
 
         /*!
          * Generates random population for next epoch.
          */
         void init() {
-            particles_.reserve(no_of_particles);
-            for (size_t i = 0 ; i < no_of_particles ; i++) {
-                particles_.push_back(std::pair<ParticleType, score_type>{ParticleType::random(), 0.0});
+            RandomStreams().streams(particle_blocks() + 1, streams_);
+            back_particles_.reserve(capacity_);
+            weights_.reserve(capacity_);
+            chunk_sums_.reserve(std::max<size_t>(1, std::min(executor_.concurrency(), capacity_)) + 1);
+            chunk_scales_.reserve(chunk_sums_.capacity());
+            if constexpr (has_accumulator_v<ParticleType>) {
+                chunk_estimates_.reserve(chunk_sums_.capacity());
+            }
+            init_particles();
+        }
+
+        /*!
+         * Fills empty population by random particles.
+         */
+        void init_particles() {
+            particles_.reserve(capacity_);
+            if constexpr (has_seeded_random_v<ParticleType, EngineType>) {
+                particles_.push_back(ParticleType::random(streams_.back()));
             }
+            generate_new_particles(particles_);
         }
 
         /*!
@@ -104,85 +220,333 @@ namespace rtl {
          * @param action Control input
          */
         void prediction(const typename ParticleType::Action& action) {
-            std::for_each(particles_.begin(), particles_.end(), [&](auto& particle){
-                particle.first.move(action);
+            RTL_ZONE("rtl::ParticleFilter::prediction");
+            executor_(0, particles_.size(), [&](size_t begin, size_t end){
+                for (size_t i = begin ; i < end ; i++) {
+                    particles_[i].move(action);
+                }
             });
         }
 
         /*!
          * Estimate score for each particle based on the measurement.
+         * Particles are split into chunks processed by the executor. Each chunk evaluates log-weights of its particles and accumulates their exponentials
+         * relative to the chunk maximum. Chunk totals are then rescaled to the global maximum and summed sequentially, the resulting offsets are added
+         * to the chunks in parallel again.
          * @param measurement observed state of the modeled system
          * */
         void correction(const typename ParticleType::Measurement& measurement) {
-            double cum_sum = 0.0;
-            for (auto& particle_cum_score : particles_) {
-                auto particle_score = particle_cum_score.first.belief(measurement);
-                particle_cum_score.second = cum_sum + particle_score;
-                cum_sum += particle_score;
+            RTL_ZONE("rtl::ParticleFilter::correction");
+            const size_t chunks = std::max<size_t>(1, std::min(executor_.concurrency(), particles_.size()));
+            weights_.resize(particles_.size());
+            chunk_sums_.assign(chunks + 1, 0.0);
+            chunk_scales_.assign(chunks, -std::numeric_limits<double>::infinity());
+            if constexpr (has_accumulator_v<ParticleType>) {
+                chunk_estimates_.assign(chunks, Accumulator());
             }
 
-            normalize_score(cum_sum);
+            executor_(0, chunks, [&](size_t c_begin, size_t c_end){
+                for (size_t c = c_begin ; c < c_end ; c++) {
+                    const size_t begin = chunk_begin(c, chunks), end = chunk_begin(c + 1, chunks);
+                    log_belief(begin, end, measurement);
+                    double max = *std::max_element(weights_.begin() + begin, weights_.begin() + end);
+                    double cum_sum = 0.0;
+                    for (size_t i = begin ; i < end ; i++) {
+                        double weight = max == -std::numeric_limits<double>::infinity() ? 0.0 : std::exp(weights_[i] - max);
+                        if constexpr (has_accumulator_v<ParticleType>) {
+                            chunk_estimates_[c].add(particles_[i], weight);
+                        }
+                        cum_sum += weight;
+                        weights_[i] = cum_sum;
+                    }
+                    chunk_scales_[c] = max;
+                    chunk_sums_[c + 1] = cum_sum;
+                }
+            });
+
+            const double max = *std::max_element(chunk_scales_.begin(), chunk_scales_.end());
+            for (size_t c = 0 ; c < chunks ; c++) {
+                chunk_scales_[c] = chunk_sums_[c + 1] > 0.0 ? std::exp(chunk_scales_[c] - max) : 0.0;
+                chunk_sums_[c + 1] = chunk_sums_[c] + chunk_sums_[c + 1] * chunk_scales_[c];
+            }
+
+            if constexpr (has_accumulator_v<ParticleType>) {
+                estimate_ = Accumulator();
+                for (size_t c = 0 ; c < chunks ; c++) {
+                    estimate_.merge(chunk_estimates_[c], chunk_scales_[c]);
+                }
+            }
+
+            normalize_score(chunks);
+        }
+
+        /*!
+         * Evaluates log-weights of the particles in range [begin, end) into the weight buffer.
+         * @param begin index of the first particle
+         * @param end index behind the last particle
+         * @param measurement observed state of the modeled system
+         */
+        void log_belief(size_t begin, size_t end, const typename ParticleType::Measurement& measurement) {
+            using Measurement = typename ParticleType::Measurement;
+            if constexpr (has_batch_log_belief_v<ParticleType, Measurement>) {
+                ParticleType::log_belief(Span<const ParticleType>(particles_.data() + begin, end - begin), measurement, Span<double>(weights_.data() + begin, end - begin));
+            } else {
+                for (size_t i = begin ; i < end ; i++) {
+                    if constexpr (has_log_belief_v<ParticleType, Measurement>) {
+                        weights_[i] = particles_[i].log_belief(measurement);
+                    } else {
+                        weights_[i] = std::log(static_cast<double>(particles_[i].belief(measurement)));
+                    }
+                }
+            }
         }
 
         /*!
          * Normalize score of all particles, so cumulative sum for all particles is 1.0
-         * @param cum_sum
+         * If all particles have zero weight, uniform weights are used instead.
+         * @param chunks number of chunks the particles were split into during the correction
          */
-        void normalize_score(double cum_sum) {
-            std::for_each(particles_.begin(), particles_.end(), [&](auto& particle_score){
-                particle_score.second /= cum_sum;
+        void normalize_score(size_t chunks) {
+            const double cum_sum = chunk_sums_[chunks];
+            const double n = static_cast<double>(particles_.size());
+            executor_(0, chunks, [&](size_t c_begin, size_t c_end){
+                for (size_t c = c_begin ; c < c_end ; c++) {
+                    for (size_t i = chunk_begin(c, chunks) ; i < chunk_begin(c + 1, chunks) ; i++) {
+                        weights_[i] = cum_sum > 0.0 ? (chunk_sums_[c] + weights_[i] * chunk_scales_[c]) / cum_sum : (i + 1) / n;
+                    }
+                }
             });
         }
 
-
         /*!
-         * Select survivals for next epoch and generates new particles.
+         * First particle of the c-th chunk out of given number of chunks
+         * @param c index of the chunk
+         * @param chunks total number of chunks
+         * @return index of the first particle of the chunk
          */
-        void resampling() {
-            std::vector<std::pair<ParticleType, score_type>> new_particles;
-            new_particles.reserve(particles_.size());
+        [[nodiscard]] size_t chunk_begin(size_t c, size_t chunks) const {
+            return particles_.size() * c / chunks;
+        }
 
-            select_survivals(new_particles);
-            generate_new_particles(new_particles);
+        /*!
+         * Selects survivals for next epoch into the back buffer.
+         */
+        void select_survivors() {
+            RTL_ZONE("rtl::ParticleFilter::resampling");
+            back_particles_.clear();
+            back_particles_.reserve(capacity_);
+            resampling_(particles_, weights_, survivors_, back_particles_);
+        }
 
-            particles_ = new_particles;
+        /*!
+         * Fills the back buffer with new particles up to the population size and swaps it with the current population.
+         * Both buffers keep their capacity, so no allocation takes place after the first epoch.
+         */
+        void finish_resampling() {
+            generate_new_particles(back_particles_);
+            particles_.swap(back_particles_);
         }
 
         /*!
-         * Select survivals for next epoch. Bigger the particle's score, bigger chance to be selected.
+         * Generates particles form entire state-space, that is defined by the ParticleType
          * @param new_particles Vector of selected particles for the next epoch
          */
-        void select_survivals(std::vector<std::pair<ParticleType, score_type>>& new_particles) {
-            double step = 1.0 / (no_of_survivors+1);
-            double th = 0.0;
-
-            auto it = particles_.begin();
-            for (size_t n = 0 ; n < no_of_survivors ; n++) {
-                th += step;
-                while(true) {
-                    if (it->second > th) {
-                        new_particles.push_back(*it);
-                        break;
-                    } else {
-                        it++;
-                    }
+        void generate_new_particles(Particles& new_particles) {
+            if constexpr (has_seeded_random_v<ParticleType, EngineType>) {
+                if (!new_particles.empty()) {
+                    // particles are first copied to fill the slots, so the blocks can be overwritten concurrently
+                    size_t first = new_particles.size();
+                    new_particles.resize(population_, new_particles.front());
+                    size_t blocks = (population_ - first + particle_block - 1) / particle_block;
+                    executor_(0, blocks, [&](size_t b_begin, size_t b_end){
+                        for (size_t b = b_begin ; b < b_end ; b++) {
+                            size_t begin = first + b * particle_block;
+                            size_t end = std::min(begin + particle_block, population_);
+                            if constexpr (has_bulk_random_v<ParticleType, EngineType>) {
+                                ParticleType::random(Span<ParticleType>(new_particles.data() + begin, end - begin), streams_[b]);
+                            } else {
+                                for (size_t i = begin ; i < end ; i++) {
+                                    new_particles[i] = ParticleType::random(streams_[b]);
+                                }
+                            }
+                        }
+                    });
+                    return;
                 }
             }
+            while(new_particles.size() < population_) {
+                new_particles.push_back(ParticleType::random());
+            }
         }
 
+        Particles particles_;
+        Particles back_particles_;
+        Weights weights_;
+        Weights chunk_sums_;
+        Weights chunk_scales_;      // maxima of the chunk log-weights, turned into factors relative to the global maximum
+        std::vector<Accumulator, AccumulatorAllocator> chunk_estimates_;
+        Accumulator estimate_{};
+        std::vector<ParticleType> evaluation_particles_;
+        std::vector<EngineType> streams_;
+        Executor executor_;
+        Resampling resampling_;
+        size_t capacity_;
+        size_t population_;
+        size_t survivors_;
+    };
+
+
+    /*!
+     * Generic implementation of the particle filter with custom-implemented particle type.
+     * Particle filter implemnets following phases:
+     * 1] Particle initialization
+     * 2] Predict particle movement (control input)
+     * 3] Evaluate particles w.r.t. the measurement (correction)
+     * 4] Resampling - random selection of N particles and generating new, random ones
+     * 5] Evaluating result. From survived particles, estimate value.
+     * 6] Back to phase 2
+     *
+     * If the ParticleType provides static random(Engine&), new particles are generated in parallel by the executor. Particles are split into fixed blocks, each
+     * of them drawing from its own stream of rtl::RandomStreams, so after seed() the filter produces the same results for any executor. If it also provides
+     * static random(Span<ParticleType>, Engine&), each block is filled by a single call, e.g. through Xoshiro256PlusPlusBulk seeded from the stream.
+     *
+     * @tparam ParticleType Custom data type of the particle
+     * @tparam no_of_particles Number of particles at the beginning of each epoch
+     * @tparam no_of_survivors Number of particles, that survives epoch
+     * @tparam Executor Execution policy for prediction and correction phases (see rtl/core/Executor.h). ParticleType::move() and
+     *                  ParticleType::belief() must be safe to call concurrently on different particles when a parallel executor is used.
+     * @tparam Resampling Resampling policy selecting the survivals (see rtl/alg/particle_filter/Resampling.h)
+     * @tparam Allocator Allocator of the particle buffers, rebound to their element types. All buffers are allocated in the constructor and keep their capacity afterwards.
+     * */
+    template<typename ParticleType, size_t no_of_particles, size_t no_of_survivors, class Executor = SequentialExecutor, class Resampling = DeterministicResampling,
+             class Allocator = std::allocator<std::byte>>
+    class ParticleFilter : public ParticleFilter_common<ParticleType, Executor, Resampling, Allocator> {
+
+        using Common = ParticleFilter_common<ParticleType, Executor, Resampling, Allocator>;
+
+    public:
+
         /*!
-         * Generates particles form entire state-space, that is defined by the ParticleType
-         * @param new_particles Vector of selected particles for the next epoch
-         */
-        void generate_new_particles(std::vector<std::pair<ParticleType, score_type>>& new_particles) {
-            while(new_particles.size() < no_of_particles) {
-                new_particles.push_back(std::pair<ParticleType, score_type>{ParticleType::random(), 0.0});
+         * Default constructor. Generates initial population
+         * */
+        ParticleFilter() : Common(no_of_particles, no_of_particles, no_of_survivors, Executor(), Allocator()) {}
+
+        /*!
+         * Constructor with a custom executor instance. Generates initial population
+         * @param executor Executor used for parallel processing of the particles
+         * */
+        explicit ParticleFilter(Executor executor) : Common(no_of_particles, no_of_particles, no_of_survivors, std::move(executor), Allocator()) {}
+
+        /*!
+         * Constructor with a custom executor and allocator instances. Generates initial population
+         * @param executor Executor used for parallel processing of the particles
+         * @param alloc Allocator of the particle buffers
+         * */
+        ParticleFilter(Executor executor, const Allocator& alloc) : Common(no_of_particles, no_of_particles, no_of_survivors, std::move(executor), alloc) {}
+
+        /*!
+         * Iterates full single epoch
+         *
+         * @param action control input to all particles
+         * @param measurement measured states after the correction
+         * */
+        void iteration(const typename ParticleType::Action& action, const typename ParticleType::Measurement& measurement) {
+            RTL_ZONE("rtl::ParticleFilter::iteration");
+            this->prediction(action);
+            this->correction(measurement);
+            this->select_survivors();
+            this->finish_resampling();
+        }
+    };
+
+
+    /*!
+     * Particle filter with the population size adapted at run-time.
+     * The filter runs the same phases as ParticleFilter, but after the resampling the Adaptation policy (see rtl/alg/particle_filter/Adaptation.h) inspects
+     * the survivors and sets the size of the next population within the [min_particles, max_particles] range. The population starts at max_particles,
+     * so a global localization is covered densely, and shrinks as the posterior concentrates. The survivors always make survivor_ratio of the population,
+     * the rest is generated randomly. The population shrinks at most to the current number of survivors per epoch, growth is immediate.
+     *
+     * All buffers are allocated for max_particles in the constructor, so no allocation takes place after the first epoch.
+     *
+     * @tparam ParticleType Custom data type of the particle, it has to satisfy the requirements of the Adaptation policy
+     * @tparam Adaptation Policy computing the required number of samples from the survivors (see rtl/alg/particle_filter/Adaptation.h)
+     * @tparam Executor Execution policy for prediction and correction phases (see rtl/core/Executor.h)
+     * @tparam Resampling Resampling policy selecting the survivals (see rtl/alg/particle_filter/Resampling.h)
+     * @tparam Allocator Allocator of the particle buffers, rebound to their element types
+     * */
+    template<typename ParticleType, class Adaptation = KldSampling, class Executor = SequentialExecutor, class Resampling = DeterministicResampling,
+             class Allocator = std::allocator<std::byte>>
+    class AdaptiveParticleFilter : public ParticleFilter_common<ParticleType, Executor, Resampling, Allocator> {
+
+        using Common = ParticleFilter_common<ParticleType, Executor, Resampling, Allocator>;
+
+    public:
+
+        /*!
+         * Constructor with population bounds. Generates initial population of max_particles particles.
+         * An exception is thrown if the bounds are empty or the survivor ratio does not lie in (0, 1].
+         * @param min_particles Lower bound of the population size
+         * @param max_particles Upper bound of the population size
+         * @param survivor_ratio Fraction of the population, that survives the epoch
+         * @param executor Executor used for parallel processing of the particles
+         * @param adaptation Adaptation policy instance
+         * @param alloc Allocator of the particle buffers
+         * */
+        AdaptiveParticleFilter(size_t min_particles, size_t max_particles, double survivor_ratio, Executor executor = Executor(), Adaptation adaptation = Adaptation(),
+                               const Allocator& alloc = Allocator())
+                : Common(checked_bounds(min_particles, max_particles, survivor_ratio), max_particles, survivors(max_particles, survivor_ratio), std::move(executor), alloc),
+                  adaptation_{std::move(adaptation)}, min_particles_{min_particles}, survivor_ratio_{survivor_ratio} {}
+
+        /*!
+         * Iterates full single epoch and adapts the size of the next population
+         *
+         * @param action control input to all particles
+         * @param measurement measured states after the correction
+         * */
+        void iteration(const typename ParticleType::Action& action, const typename ParticleType::Measurement& measurement) {
+            RTL_ZONE("rtl::AdaptiveParticleFilter::iteration");
+            this->prediction(action);
+            this->correction(measurement);
+            this->select_survivors();
+
+            auto required = static_cast<size_t>(std::ceil(static_cast<double>(adaptation_(this->back_particles_)) / survivor_ratio_));
+            this->population_ = std::clamp(std::max(required, this->survivors_), min_particles_, this->capacity_);
+            this->finish_resampling();
+            this->survivors_ = survivors(this->population_, survivor_ratio_);
+        }
+
+    private:
+
+        static size_t checked_bounds(size_t min_particles, size_t max_particles, double survivor_ratio) {
+            if (min_particles == 0 || min_particles > max_particles) {
+                throw std::invalid_argument("AdaptiveParticleFilter: population bounds must satisfy 0 < min_particles <= max_particles.");
             }
+            if (!(survivor_ratio > 0.0 && survivor_ratio <= 1.0)) {
+                throw std::invalid_argument("AdaptiveParticleFilter: survivor ratio must lie in (0, 1].");
+            }
+            return max_particles;
+        }
+
+        static size_t survivors(size_t population, double survivor_ratio) {
+            return std::max<size_t>(1, static_cast<size_t>(population * survivor_ratio));
         }
 
-        std::vector<std::pair<ParticleType, score_type>> particles_;
+        Adaptation adaptation_;
+        size_t min_particles_;
+        double survivor_ratio_;
     };
 
+    namespace pmr {
+        //! ParticleFilter allocating its particle buffers from a std::pmr::memory_resource.
+        template<typename ParticleType, size_t no_of_particles, size_t no_of_survivors, class Executor = SequentialExecutor, class Resampling = DeterministicResampling>
+        using ParticleFilter = rtl::ParticleFilter<ParticleType, no_of_particles, no_of_survivors, Executor, Resampling, std::pmr::polymorphic_allocator<std::byte>>;
+
+        //! AdaptiveParticleFilter allocating its particle buffers from a std::pmr::memory_resource.
+        template<typename ParticleType, class Adaptation = KldSampling, class Executor = SequentialExecutor, class Resampling = DeterministicResampling>
+        using AdaptiveParticleFilter = rtl::AdaptiveParticleFilter<ParticleType, Adaptation, Executor, Resampling, std::pmr::polymorphic_allocator<std::byte>>;
+    }
+
 }
 
 #endif //ROBOTICTEMPLATELIBRARY_PARTICLEFILTER_H
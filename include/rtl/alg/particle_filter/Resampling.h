@@ -0,0 +1,181 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Adam Ligocki <adam.ligocki@vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_RESAMPLING_H
+#define ROBOTICTEMPLATELIBRARY_RESAMPLING_H
+
+#include <random>
+#include <cmath>
+#include <cstddef>
+
+#include <rtl/core/RandomStream.h>
+
+namespace rtl {
+
+    /*!
+     * Resampling policies for the ParticleFilter.
+     * Each policy is a callable object with the following signature:
+     *
+     *     template<typename Particles, typename Weights> void operator()(const Particles& particles, const Weights& weights, size_t n, Particles& selected);
+     *
+     * where Particles is std::vector<ParticleType> and Weights is std::vector<double> of the same size holding normalized cumulative weights of the particles,
+     * i.e. the weight of the last particle is 1.0.
+     * Exactly n particles are to be appended into selected, which is cleared by the caller beforehand and keeps its capacity between epochs.
+     * Randomized policies may provide seed(uint64_t), which is called by ParticleFilter::seed() for reproducible runs.
+     */
+
+    /*!
+     * Deterministic resampling. Particles are selected by n equidistant thresholds k/(n+1) without any random offset.
+     */
+    struct DeterministicResampling {
+
+        template<typename Particles, typename Weights>
+        void operator()(const Particles& particles, const Weights& weights, size_t n, Particles& selected) {
+            double step = 1.0 / (n + 1);
+            double th = 0.0;
+
+            size_t i = 0;
+            for (size_t k = 0 ; k < n ; k++) {
+                th += step;
+                while (weights[i] <= th && i + 1 != particles.size()) {
+                    i++;
+                }
+                selected.push_back(particles[i]);
+            }
+        }
+    };
+
+    /*!
+     * Systematic resampling. Particles are selected by n equidistant thresholds (k + u)/n sharing single random offset u from [0, 1).
+     */
+    class SystematicResampling {
+    public:
+
+        SystematicResampling() : engine_{std::random_device{}()} {}
+
+        void seed(uint64_t seed) { engine_.seed(seed); }
+
+        template<typename Particles, typename Weights>
+        void operator()(const Particles& particles, const Weights& weights, size_t n, Particles& selected) {
+            std::uniform_real_distribution<double> distribution(0.0, 1.0);
+            double u = distribution(engine_);
+
+            size_t i = 0;
+            for (size_t k = 0 ; k < n ; k++) {
+                double th = (k + u) / n;
+                while (weights[i] <= th && i + 1 != particles.size()) {
+                    i++;
+                }
+                selected.push_back(particles[i]);
+            }
+        }
+
+    private:
+        RandomStreams::EngineType engine_;
+    };
+
+    /*!
+     * Stratified resampling. Particles are selected by thresholds (k + u_k)/n with independent random offset u_k from [0, 1) for each stratum.
+     */
+    class StratifiedResampling {
+    public:
+
+        StratifiedResampling() : engine_{std::random_device{}()} {}
+
+        void seed(uint64_t seed) { engine_.seed(seed); }
+
+        template<typename Particles, typename Weights>
+        void operator()(const Particles& particles, const Weights& weights, size_t n, Particles& selected) {
+            std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+            size_t i = 0;
+            for (size_t k = 0 ; k < n ; k++) {
+                double th = (k + distribution(engine_)) / n;
+                while (weights[i] <= th && i + 1 != particles.size()) {
+                    i++;
+                }
+                selected.push_back(particles[i]);
+            }
+        }
+
+    private:
+        RandomStreams::EngineType engine_;
+    };
+
+    /*!
+     * Residual resampling. Each particle with normalized weight w is first copied floor(n * w) times deterministically,
+     * the remaining slots are then filled by systematic resampling of the residual weights.
+     */
+    class ResidualResampling {
+    public:
+
+        ResidualResampling() : engine_{std::random_device{}()} {}
+
+        void seed(uint64_t seed) { engine_.seed(seed); }
+
+        template<typename Particles, typename Weights>
+        void operator()(const Particles& particles, const Weights& weights, size_t n, Particles& selected) {
+            size_t copied = 0;
+            double prev_cum = 0.0;
+            for (size_t i = 0 ; i < particles.size() ; i++) {
+                auto copies = static_cast<size_t>(std::floor(n * (weights[i] - prev_cum)));
+                prev_cum = weights[i];
+                for (size_t c = 0 ; c < copies && copied < n ; c++, copied++) {
+                    selected.push_back(particles[i]);
+                }
+            }
+
+            size_t residual_n = n - copied;
+            if (residual_n == 0) {
+                return;
+            }
+
+            // residual weights are n * w - floor(n * w), their total equals residual_n
+            std::uniform_real_distribution<double> distribution(0.0, 1.0);
+            double u = distribution(engine_);
+            double residual_cum = 0.0;
+            prev_cum = 0.0;
+            size_t k = 0;
+            for (size_t i = 0 ; i < particles.size() && k < residual_n ; i++) {
+                double nw = n * (weights[i] - prev_cum);
+                prev_cum = weights[i];
+                residual_cum += nw - std::floor(nw);
+                while (k < residual_n && (k + u) < residual_cum) {
+                    selected.push_back(particles[i]);
+                    k++;
+                }
+            }
+            for ( ; k < residual_n ; k++) {
+                selected.push_back(particles.back());
+            }
+        }
+
+    private:
+        RandomStreams::EngineType engine_;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_RESAMPLING_H
@@ -29,6 +29,11 @@
 
 #include <random>
 #include <cmath>
+#include <algorithm>
+#include <cstdint>
+
+#include <rtl/core/Span.h>
+#include <rtl/core/RandomStream.h>
 
 namespace rtl {
 
@@ -39,7 +44,14 @@ namespace rtl {
      *  - static ParticleType random()
      *  - void move(Action)
      *  - scoretype[float] belief(Measurement)
-     *  - static Result evaluation()
+     *  - static Result evaluation(const std::vector<ParticleType>&) or static Result evaluation(Span<const ParticleType>), the latter avoids copying the survivors
+     *
+     * Optional Methods:
+     *  - template<class Engine> static ParticleType random(Engine&) - enables parallel and reproducible generation of particles
+     *  - static void random(Span<ParticleType>, Engine&) - fills a whole block of particles at once, used together with random(Engine&)
+     *  - static void log_belief(Span<const ParticleType>, const Measurement&, Span<double>) - log-likelihoods of a batch of particles, evaluated instead of belief()
+     *  - Accumulator - incremental weighted estimate filled during the correction, see ParticleFilter_common::estimate()
+     *  - std::int64_t bin() const - histogram bin of the particle, required by the KldSampling adaptation of AdaptiveParticleFilter
      *
      * Mandatory Data Types:
      *  - Action
@@ -82,6 +94,35 @@ namespace rtl {
         };
 
 
+        /*!
+         * Incremental weighted mean and standard deviation of the particle values
+         */
+        class Accumulator {
+        public:
+            void add(const SimpleParticle& particle, double weight) {
+                sum_w_ += weight;
+                sum_wx_ += weight * particle.value_;
+                sum_wx2_ += weight * particle.value_ * particle.value_;
+            }
+
+            void merge(const Accumulator& other, double scale) {
+                sum_w_ += scale * other.sum_w_;
+                sum_wx_ += scale * other.sum_wx_;
+                sum_wx2_ += scale * other.sum_wx2_;
+            }
+
+            [[nodiscard]] Result result() const {
+                double mean = sum_wx_ / sum_w_;
+                return Result(static_cast<T>(mean), static_cast<T>(std::sqrt(std::max(0.0, sum_wx2_ / sum_w_ - mean * mean))));
+            }
+
+        private:
+            double sum_w_{0.0};
+            double sum_wx_{0.0};
+            double sum_wx2_{0.0};
+        };
+
+
         /*!
          * Value constructor
          * @param val State value represented by particle
@@ -96,6 +137,34 @@ namespace rtl {
             return SimpleParticle(get_uniform_random_value(-100.0f, 100.0f));
         }
 
+        /*!
+         * Generates particle with random inner state value drawn from the given generator
+         * @param engine UniformRandomBitGenerator, e.g. a stream from rtl::RandomStreams
+         * @return Random particle
+         */
+        template<class Engine>
+        static SimpleParticle random(Engine& engine) {
+            return SimpleParticle(std::uniform_real_distribution<T>(-100.0f, 100.0f)(engine));
+        }
+
+        /*!
+         * Fills a block of particles with random inner state values, the values are drawn by Xoshiro256PlusPlusBulk seeded from the given generator
+         * @param particles Block of particles to be overwritten
+         * @param engine Stream of rtl::RandomStreams
+         */
+        static void random(Span<SimpleParticle> particles, Xoshiro256PlusPlus& engine) {
+            constexpr size_t chunk = 256;
+            Xoshiro256PlusPlusBulk<> bulk(engine);
+            T values[chunk];
+            for (size_t beg = 0 ; beg < particles.size() ; beg += chunk) {
+                size_t n = std::min(chunk, particles.size() - beg);
+                bulk.uniform(Span<T>(values, n), T(-100.0f), T(100.0f));
+                for (size_t i = 0 ; i < n ; i++) {
+                    particles[beg + i].value_ = values[i];
+                }
+            }
+        }
+
         /*!
          * Move particle's inner state by given control input
          * @param action Control input applied on each particle
@@ -113,12 +182,37 @@ namespace rtl {
             return gauss(cost(measurement));
         }
 
+        /*!
+         * Evaluates log-likelihoods of a batch of particles w.r.t. the measurement, the log-domain counterpart of belief()
+         * @param particles Contiguous batch of particles
+         * @param measurement States of the system modeled by particle filter
+         * @param log_weights Output log-likelihoods, one per particle
+         */
+        static void log_belief(Span<const SimpleParticle> particles, const SimpleParticle::Measurement& measurement, Span<double> log_weights) {
+            constexpr double std_dev = 10;
+            constexpr double variance = std_dev * std_dev;
+            const double log_a = -std::log(std_dev * 2.5066);
+            const double m = measurement.value();
+            for (size_t i = 0 ; i < particles.size() ; i++) {
+                double x = particles[i].value_ - m;
+                log_weights[i] = log_a - 0.5 * x * x / variance;
+            }
+        }
+
+        /*!
+         * Index of the histogram bin the particle falls into, bins are one unit wide
+         * @return Bin index
+         */
+        [[nodiscard]] std::int64_t bin() const {
+            return static_cast<std::int64_t>(std::floor(value_));
+        }
+
         /*!
          * Estimate system state based on the N selected particles (it can be mean, median, most common val, etc.)
-         * @param vec Vector of particles that are used to estimate state simulated by particle filter
+         * @param vec View of particles that are used to estimate state simulated by particle filter
          * @return Estimated state of modeled system
          */
-        [[nodiscard]] static Result evaluation(const std::vector<SimpleParticle>& vec) {
+        [[nodiscard]] static Result evaluation(Span<const SimpleParticle> vec) {
             T sum = 0.0;
             std::for_each(vec.begin(), vec.end(), [&](auto particle){
                 sum += particle.value_;
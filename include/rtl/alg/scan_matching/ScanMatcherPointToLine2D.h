@@ -0,0 +1,246 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+#ifndef ROBOTICTEMPLATELIBRARY_SCANMATCHERPOINTTOLINE2D_H
+#define ROBOTICTEMPLATELIBRARY_SCANMATCHERPOINTTOLINE2D_H
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <eigen3/Eigen/Dense>
+
+#include "rtl/core/Executor.h"
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/Span.h"
+#include "rtl/core/VectorND.h"
+#include "rtl/core/LineSegmentND.h"
+#include "rtl/core/BoundingBoxND.h"
+#include "rtl/core/BoundingVolumeHierarchyND.h"
+#include "rtl/tf/RigidTfND.h"
+
+namespace rtl
+{
+    //! Point-to-line iterative closest point registration of 2D scans against line segments.
+    /*!
+     * The reference scan or map is given as a set of line segments, e.g. the output of VectorizerFTLSPolyline2D, which is indexed by a BoundingVolumeHierarchyND
+     * of their bounding boxes. Each iteration transforms the raw points by the current estimate, finds the nearest reference segment of each point within
+     * the correspondence distance and solves the linearized point-to-line least squares problem for a small rotation and a translation in closed form
+     * (a 3x3 system of normal equations). The increment is composed with the estimate and the iterations stop when it falls below the tolerances.
+     *
+     * The correspondence search and accumulation of the normal equations are split into as many chunks as the executor runs concurrently, the partial systems
+     * are summed afterwards. Unobservable directions (e.g. a translation along a corridor) are left unchanged, since the minimum norm solution of the system
+     * is used.
+     * @tparam Element base type of the points, segments and the transformation.
+     * @tparam Executor execution policy of the correspondence search, see rtl/core/Executor.h.
+     */
+    template<typename Element, class Executor = SequentialExecutor>
+    class ScanMatcherPointToLine2D
+    {
+    public:
+        typedef Element ElementType;                            //!< Base type of the points, segments and the transformation.
+        typedef VectorND<2, Element> VectorType;                //!< Type of the registered points.
+        typedef LineSegmentND<2, Element> LineSegmentType;      //!< Type of the reference line segments.
+        typedef RigidTfND<2, Element> TransformationType;       //!< Type of the resulting transformation.
+
+        //! Default constructor.
+        ScanMatcherPointToLine2D() = default;
+
+        //! Construction with given executor for the correspondence search.
+        explicit ScanMatcherPointToLine2D(Executor exec) : executor(std::move(exec)) {}
+
+        //! Default destructor.
+        ~ScanMatcherPointToLine2D() = default;
+
+        //! Sets the maximal distance of a point from its corresponding reference segment, farther points are ignored as outliers.
+        void setMaxDistance(ElementType distance) { max_dist = distance; }
+
+        //! Sets the maximal number of iterations.
+        void setMaxIterations(size_t iterations) { max_iterations = iterations; }
+
+        //! Sets the minimal number of correspondences required in each iteration, at least 3.
+        void setMinCorrespondences(size_t correspondences) { min_correspondences = std::max<size_t>(correspondences, 3); }
+
+        //! Sets the convergence tolerances of the transformation increment.
+        /*!
+         *
+         * @param translation tolerance of the length of the translation increment.
+         * @param angle tolerance of the rotation increment in radians.
+         */
+        void setTolerance(ElementType translation, ElementType angle)
+        {
+            tol_translation = translation;
+            tol_angle = angle;
+        }
+
+        //! Sets the reference line segments and builds their spatial index.
+        /*!
+         *
+         * @param segments line segments of the reference scan or map.
+         */
+        void setReference(const std::vector<LineSegmentType> &segments)
+        {
+            RTL_ZONE("rtl::ScanMatcherPointToLine2D::setReference");
+            ref_segments = segments;
+            ref_normals.resize(segments.size());
+            ref_offsets.resize(segments.size());
+            std::vector<BoundingBoxND<2, Element>> boxes;
+            std::vector<size_t> payloads(segments.size());
+            boxes.reserve(segments.size());
+            for (size_t i = 0; i < segments.size(); i++)
+            {
+                ref_normals[i] = segments[i].normal();
+                ref_offsets[i] = ref_normals[i].dot(segments[i].beg());
+                boxes.emplace_back(segments[i].beg(), segments[i].end());
+                payloads[i] = i;
+            }
+            index.build(boxes, payloads);
+        }
+
+        //! Reference line segments.
+        [[nodiscard]] const std::vector<LineSegmentType> &reference() const { return ref_segments; }
+
+        //! Registers \p pts against the reference segments.
+        /*!
+         * The resulting transformation maps \p pts into the frame of the reference segments.
+         * @param pts raw points of the registered scan.
+         * @param initial initial estimate of the transformation.
+         * @return true if the registration converged, false if it ran out of iterations or correspondences. The last estimate is available in both cases.
+         */
+        bool operator()(Span<const VectorType> pts, const TransformationType &initial = TransformationType::identity())
+        {
+            RTL_ZONE("rtl::ScanMatcherPointToLine2D");
+            int_tf = initial;
+            int_iterations = 0;
+            int_correspondences = 0;
+            int_error = std::numeric_limits<ElementType>::infinity();
+            if (ref_segments.empty())
+                return false;
+
+            const size_t chunks = std::max<size_t>(1, std::min(executor.concurrency(), pts.size()));
+            partial.resize(chunks);
+            while (int_iterations < max_iterations)
+            {
+                int_iterations++;
+                const Eigen::Matrix<Element, 2, 2> rot = int_tf.rotMat().data();
+                const Eigen::Matrix<Element, 2, 1> tr = int_tf.trVec().data();
+                executor(0, chunks, [&](size_t c_begin, size_t c_end) {
+                    for (size_t c = c_begin; c < c_end; c++)
+                        accumulate(pts.subspan(pts.size() * c / chunks, pts.size() * (c + 1) / chunks - pts.size() * c / chunks), rot, tr, partial[c]);
+                });
+
+                NormalEquations sum;
+                for (const auto &p : partial)
+                {
+                    sum.ata += p.ata;
+                    sum.atb += p.atb;
+                    sum.err += p.err;
+                    sum.cnt += p.cnt;
+                }
+                int_correspondences = sum.cnt;
+                if (sum.cnt < min_correspondences)
+                    return false;
+                int_error = std::sqrt(sum.err / (ElementType)sum.cnt);
+
+                Eigen::Matrix<Element, 3, 3> ata = sum.ata.template selfadjointView<Eigen::Lower>();
+                Eigen::Matrix<Element, 3, 1> x = ata.completeOrthogonalDecomposition().solve(sum.atb);
+                if (!x.allFinite())
+                    return false;
+                int_tf.transform(TransformationType(x[0], x[1], x[2]));
+                if (std::abs(x[0]) < tol_angle && x.template tail<2>().norm() < tol_translation)
+                    return true;
+            }
+            return false;
+        }
+
+        //! Resulting transformation of the last registration.
+        [[nodiscard]] const TransformationType &transformation() const { return int_tf; }
+
+        //! Number of iterations of the last registration.
+        [[nodiscard]] size_t iterations() const { return int_iterations; }
+
+        //! Number of correspondences found in the last iteration.
+        [[nodiscard]] size_t correspondences() const { return int_correspondences; }
+
+        //! Root mean square point-to-line distance of the correspondences in the last iteration, measured before its increment was applied.
+        [[nodiscard]] ElementType error() const { return int_error; }
+
+    private:
+        //! Lower triangle of the normal equations of the linearized problem with unknown rotation angle and translation along x and y.
+        struct NormalEquations
+        {
+            Eigen::Matrix<Element, 3, 3> ata{Eigen::Matrix<Element, 3, 3>::Zero()};
+            Eigen::Matrix<Element, 3, 1> atb{Eigen::Matrix<Element, 3, 1>::Zero()};
+            Element err{};
+            size_t cnt{};
+        };
+
+        //! Finds correspondences of transformed \p pts and accumulates their contribution to the normal equations.
+        void accumulate(Span<const VectorType> pts, const Eigen::Matrix<Element, 2, 2> &rot, const Eigen::Matrix<Element, 2, 1> &tr, NormalEquations &ne) const
+        {
+            ne = NormalEquations();
+            const Element max_dist2 = max_dist * max_dist;
+            const VectorType reach(max_dist, max_dist);
+            for (const auto &p : pts)
+            {
+                VectorType q(Eigen::Matrix<Element, 2, 1>(rot * p.data() + tr));
+                size_t best = ref_segments.size();
+                Element best_dist2 = max_dist2;
+                index.overlapping(BoundingBoxND<2, Element>(q - reach, q + reach), [&](size_t i) {
+                    Element d2 = ref_segments[i].segmentDistanceToPointSquared(q);
+                    if (d2 < best_dist2)
+                    {
+                        best_dist2 = d2;
+                        best = i;
+                    }
+                });
+                if (best == ref_segments.size())
+                    continue;
+
+                // residual n . (q + angle * (-q_y, q_x) + t) - d linearized in the rotation angle
+                const VectorType &n = ref_normals[best];
+                Eigen::Matrix<Element, 3, 1> a(n.y() * q.x() - n.x() * q.y(), n.x(), n.y());
+                Element b = ref_offsets[best] - n.dot(q);
+                ne.ata.template triangularView<Eigen::Lower>() += a * a.transpose();
+                ne.atb += a * b;
+                ne.err += b * b;
+                ne.cnt++;
+            }
+        }
+
+        Executor executor;
+        BoundingVolumeHierarchyND<2, Element> index;
+        std::vector<LineSegmentType> ref_segments;
+        std::vector<VectorType> ref_normals;
+        std::vector<Element> ref_offsets;
+        std::vector<NormalEquations> partial;
+        TransformationType int_tf{TransformationType::identity()};
+        ElementType max_dist{1}, tol_translation{1e-4}, tol_angle{1e-4}, int_error{};
+        size_t max_iterations{30}, min_correspondences{3}, int_iterations{}, int_correspondences{};
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_SCANMATCHERPOINTTOLINE2D_H
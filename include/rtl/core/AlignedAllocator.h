@@ -0,0 +1,125 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_ALIGNEDALLOCATOR_H
+#define ROBOTICTEMPLATELIBRARY_ALIGNEDALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <limits>
+#include <type_traits>
+
+namespace rtl
+{
+    //! Alignment of SIMD-processed buffers in bytes, covers cache lines and all common vector register widths (up to AVX-512).
+    constexpr size_t C_SIMD_ALIGNMENT = 64;
+
+    //! Standard-compatible allocator returning memory aligned to \p alignment bytes.
+    /*!
+     * Containers using AlignedAllocator start their data at a cache line boundary, so structure-of-arrays buffers processed by vectorized loops do not need peeling of unaligned
+     * head elements and never share a cache line with unrelated data. Over-aligned element types (e.g. fixed-size vectorizable Eigen types) are aligned to the stricter of
+     * alignof(T) and \p alignment.
+     * @tparam T type of the allocated elements.
+     * @tparam alignment required alignment in bytes, a power of two.
+     */
+    template<typename T, size_t alignment = C_SIMD_ALIGNMENT>
+    class AlignedAllocator
+    {
+        static_assert((alignment & (alignment - 1)) == 0, "AlignedAllocator requires a power of two alignment.");
+    public:
+        typedef T value_type;   //!< Type of the allocated elements.
+
+        //! Rebinding to another element type with the same alignment.
+        template<typename U>
+        struct rebind
+        {
+            typedef AlignedAllocator<U, alignment> other;   //!< The rebound allocator.
+        };
+
+        //! Default constructor.
+        AlignedAllocator() noexcept = default;
+
+        //! Conversion from the allocator of another element type.
+        template<typename U>
+        explicit AlignedAllocator(const AlignedAllocator<U, alignment> &) noexcept {}
+
+        //! Allocates uninitialized memory for \p n elements.
+        /*!
+         *
+         * @param n number of elements.
+         * @return pointer to the aligned memory.
+         */
+        T *allocate(size_t n)
+        {
+            if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+                throw std::bad_array_new_length();
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(effective_alignment)));
+        }
+
+        //! Releases memory obtained from allocate().
+        void deallocate(T *p, size_t) noexcept
+        {
+            ::operator delete(p, std::align_val_t(effective_alignment));
+        }
+
+        //! Number of bytes the allocated memory is aligned to.
+        static constexpr size_t alignmentBytes() { return effective_alignment; }
+
+    private:
+        static constexpr size_t effective_alignment = alignof(T) > alignment ? alignof(T) : alignment;
+    };
+
+    //! All AlignedAllocator instances of the same alignment are interchangeable.
+    template<typename T, typename U, size_t alignment>
+    bool operator==(const AlignedAllocator<T, alignment> &, const AlignedAllocator<U, alignment> &) { return true; }
+
+    //! All AlignedAllocator instances of the same alignment are interchangeable.
+    template<typename T, typename U, size_t alignment>
+    bool operator!=(const AlignedAllocator<T, alignment> &, const AlignedAllocator<U, alignment> &) { return false; }
+
+    //! std::vector with the data aligned to C_SIMD_ALIGNMENT bytes.
+    template<typename T>
+    using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+    //! Rounds a number of elements of type \p T up, so that consecutive arrays of this length in one buffer keep the C_SIMD_ALIGNMENT of its start.
+    /*!
+     *
+     * @tparam T arithmetic type of the elements.
+     * @param n number of elements.
+     * @return the smallest count not lower than \p n, which spans a multiple of C_SIMD_ALIGNMENT bytes.
+     */
+    template<typename T>
+    constexpr size_t alignedCount(size_t n)
+    {
+        static_assert(std::is_arithmetic_v<T>, "alignedCount() is intended for arrays of arithmetic types.");
+        constexpr size_t step = sizeof(T) >= C_SIMD_ALIGNMENT ? 1 : C_SIMD_ALIGNMENT / sizeof(T);
+        return (n + step - 1) / step * step;
+    }
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_ALIGNEDALLOCATOR_H
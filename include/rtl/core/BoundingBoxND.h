@@ -28,9 +28,18 @@
 #define ROBOTICTEMPLATELIBRARY_BOUNDINGBOXND_H
 
 #include <vector>
+#include <array>
 #include <exception>
 #include <memory>
+#include <mutex>
+#include <algorithm>
+#include <limits>
+#include "rtl/core/AlignedAllocator.h"
+#include "rtl/core/Executor.h"
+#include "rtl/core/Span.h"
 #include "rtl/core/VectorND.h"
+#include "rtl/core/StridedSpan.h"
+#include "rtl/core/Matrix.h"
 
 namespace rtl
 {
@@ -70,6 +79,13 @@ namespace rtl
          */
         BoundingBoxND(const BoundingBoxND &bb) : b_min(bb.b_min), b_max(bb.b_max) {}
 
+        //! Copy assignment.
+        /*!
+         * @param bb bounding box to be copied.
+         * @return reference to *this.
+         */
+        BoundingBoxND &operator=(const BoundingBoxND &bb) = default;
+
         //! Initialization with a single point.
         /*!
          * In that case min() = max() and volume() returns zero.
@@ -91,16 +107,42 @@ namespace rtl
          * a std::invalid_argument exception is thrown.
          * @param vects points to be used for construction.
          */
-        explicit BoundingBoxND(const std::vector<VectorType> &vects)
+        explicit BoundingBoxND(const std::vector<VectorType> &vects) : BoundingBoxND(Span<const VectorType>(vects)) {}
+
+        //! Construction from a contiguous buffer of points.
+        /*!
+         * The resulting bounding box is the tightest axis aligned volume containing all points, they are reduced by the vectorized kernel of addPoints(). If the buffer is empty,
+         * a std::invalid_argument exception is thrown.
+         * @param pts points to be used for construction.
+         */
+        explicit BoundingBoxND(Span<const VectorType> pts)
         {
-            if (vects.empty())
+            if (pts.empty())
                 throw std::invalid_argument("Empty vector of points supplied to BoundingBoxND constructor.");
-            b_min = b_max = vects[0];
-            for (size_t i = 1; i < vects.size(); i++)
-            {
-                b_min = minPoint(b_min, vects[i]);
-                b_max = maxPoint(b_max, vects[i]);
-            }
+            b_min = b_max = pts[0];
+            addPoints(pts);
+        }
+
+        //! Construction from a fixed-size array of points, e.g. the result of allVertices().
+        /*!
+         * @param pts points to be used for construction.
+         */
+        template<size_t n>
+        explicit BoundingBoxND(const std::array<VectorType, n> &pts) : BoundingBoxND(Span<const VectorType>(pts.data(), n)) {}
+
+        //! Construction from points stored as structure of arrays, e.g. coordinate arrays of PointCloudND.
+        /*!
+         * If there are no points, a std::invalid_argument exception is thrown.
+         * @param coords pointers to the contiguous arrays of the individual coordinates.
+         * @param n number of points.
+         */
+        BoundingBoxND(const std::array<const Element *, dim> &coords, size_t n)
+        {
+            if (n == 0)
+                throw std::invalid_argument("Empty vector of points supplied to BoundingBoxND constructor.");
+            for (size_t i = 0; i < dim; i++)
+                b_min[i] = b_max[i] = coords[i][0];
+            addPoints(coords, n);
         }
 
         [[nodiscard]] VectorType min() const { return b_min; }  //!< Vector representing lower bounds of the bounding box in all dimensions.
@@ -124,13 +166,96 @@ namespace rtl
          */
         void addPoints(const std::vector<VectorType> &pts)
         {
-            for (const VectorType &p : pts)
+            addPoints(Span<const VectorType>(pts));
+        }
+
+        //! Adjusts the bounding box to cover all points in a contiguous buffer \p pts.
+        /*!
+         * Blocks of consecutive points are treated as one flat array of coordinates, which is reduced element-wise into a block of partial bounds. The inner loop
+         * therefore has no dependency on the dimension and is vectorized by the compiler, the partial bounds are folded into the box at the end.
+         * @param pts points to be examined.
+         */
+        void addPoints(Span<const VectorType> pts)
+        {
+            if constexpr (sizeof(VectorType) == dim * sizeof(Element))
+            {
+                Element lo[dim], hi[dim];
+                for (size_t i = 0; i < dim; i++)
+                {
+                    lo[i] = b_min[i];
+                    hi[i] = b_max[i];
+                }
+                reduceInterleaved(reinterpret_cast<const Element *>(pts.data()), pts.size(), lo, hi);
+                for (size_t i = 0; i < dim; i++)
+                {
+                    b_min[i] = lo[i];
+                    b_max[i] = hi[i];
+                }
+            }
+            else
+            {
+                for (const VectorType &p : pts)
+                    addPoint(p);
+            }
+        }
+
+        //! Adjusts the bounding box to cover all points in a contiguous buffer \p pts, the reduction is split among the workers of \p executor.
+        /*!
+         * Each worker reduces its sub-range by the vectorized kernel, the partial boxes are merged afterwards. Worth it for large clouds only, boxes of small clusters
+         * are better computed in parallel cluster by cluster.
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param pts points to be examined.
+         * @param executor executor splitting the range of points.
+         */
+        template<class Executor>
+        void addPoints(Span<const VectorType> pts, Executor executor)
+        {
+            std::mutex merge_mtx;
+            executor(0, pts.size(), [this, &pts, &merge_mtx](size_t begin, size_t end) {
+                BoundingBoxND part(pts[begin]);
+                part.addPoints(pts.subspan(begin + 1, end - begin - 1));
+                std::lock_guard<std::mutex> lock(merge_mtx);
+                addBoundingBox(part);
+            });
+        }
+
+        //! Adjusts the bounding box to cover all points viewed by \p pts.
+        /*!
+         * Works directly on external buffers, no intermediate container is needed. Densely packed views are reduced by the vectorized kernel.
+         * @param pts view of the points to be examined.
+         */
+        void addPoints(StridedSpan<const VectorType> pts)
+        {
+            if (pts.strideBytes() == sizeof(VectorType))
             {
+                addPoints(Span<const VectorType>(reinterpret_cast<const VectorType *>(pts.data()), pts.size()));
+                return;
+            }
+            for (size_t i = 0; i < pts.size(); i++)
+            {
+                VectorType p = pts[i];
                 b_min = minPoint(b_min, p);
                 b_max = maxPoint(b_max, p);
             }
         }
 
+        //! Adjusts the bounding box to cover all points stored as structure of arrays, e.g. coordinate arrays of PointCloudND.
+        /*!
+         * Each coordinate array is reduced independently by a vectorized loop.
+         * @param coords pointers to the contiguous arrays of the individual coordinates.
+         * @param n number of points.
+         */
+        void addPoints(const std::array<const Element *, dim> &coords, size_t n)
+        {
+            for (size_t i = 0; i < dim; i++)
+            {
+                Element lo = b_min[i], hi = b_max[i];
+                reduceInterleaved<1>(coords[i], n, &lo, &hi);
+                b_min[i] = lo;
+                b_max[i] = hi;
+            }
+        }
+
         //! Adjusts the bounding box to cover another bounding box \p bb as well.
         /*!
          * If \p bb is entirely covered then nothing happens. Otherwise the bounding box is expanded accordingly.
@@ -156,24 +281,24 @@ namespace rtl
             return true;
         }
 
-        //! From min() and max() vertices generates a std::vector of all vertices of the bounding box and applies \p func on them.
+        //! From min() and max() vertices generates a std::array of all vertices of the bounding box and applies \p func on them.
         /*!
-         * If called with default argument, no processing is applied to the vertices and std::vector containing them is returned.
+         * If called with default argument, no processing is applied to the vertices and std::array containing them is returned. The array has a fixed size of 2^dim,
+         * so no allocation takes place.
          * @tparam T type of invokable object (function, functor, lambda, ...) with VectorType parameter.
          * @param func the actual invokable object, identity by default.
          * @return all vertices of the bounding box processed by \p func.
          */
         template<typename T>
-        std::vector<typename std::invoke_result_t<T, VectorType>> allVertices(T &&func = identityFunc) const
+        std::array<typename std::invoke_result_t<T, VectorType>, (1u << dim)> allVertices(T &&func = identityFunc) const
         {
-            std::vector<typename std::invoke_result_t<T, VectorType>> vertices;
-            vertices.reserve(1u << dim);
+            std::array<typename std::invoke_result_t<T, VectorType>, (1u << dim)> vertices;
             VectorType v;
             for (size_t i = 0; i < (1u << dim); i++)
             {
                 for (size_t j = 0; j < dim; j++)
                     v[j] = (i & (1u << j)) ? b_min[j] : b_max[j];
-                vertices.push_back(func(v));
+                vertices[i] = func(v);
             }
             return vertices;
         }
@@ -246,6 +371,29 @@ namespace rtl
             b_max = tmp.b_max;
         }
 
+        //! Transforms a whole collection of bounding boxes in-place.
+        /*!
+         * Equivalent to transform() of each box, but instead of transforming all 2^dim vertices of every box, the centre is transformed and the half-extents are
+         * mapped by the element-wise absolute value of the rotation matrix, which is computed once for the whole collection.
+         * @param boxes the bounding boxes to be transformed.
+         * @param tf the transformation to be applied.
+         */
+        static void transform(Span<BoundingBoxND> boxes, const RigidTfND<dim, Element> &tf)
+        {
+            const auto &rot = tf.rotMat().data();
+            const auto abs_rot = rot.cwiseAbs().eval();
+            const auto &tr = tf.trVec().data();
+            for (auto &bb : boxes)
+            {
+                auto centre = ((bb.b_max.data() + bb.b_min.data()) / 2).eval();
+                auto extent = ((bb.b_max.data() - bb.b_min.data()) / 2).eval();
+                auto new_centre = (rot * centre + tr).eval();
+                auto new_extent = (abs_rot * extent).eval();
+                bb.b_min = VectorType(typename VectorType::EigenType(new_centre - new_extent));
+                bb.b_max = VectorType(typename VectorType::EigenType(new_centre + new_extent));
+            }
+        }
+
         //! Computes hyper-volume spanned by min() and max() vectors.
         /*!
          * @return hyper-volume of the bounding box.
@@ -267,6 +415,25 @@ namespace rtl
             return (b_min + b_max) / 2;
         }
 
+        //! Hyper-volume of the intersection with \p bb.
+        /*!
+         * Computed without construction of the intersection, so no allocation takes place.
+         * @param bb bounding box to test against.
+         * @return volume of the intersection, zero if the bounding boxes do not overlap or just touch.
+         */
+        Element intersectionVolume(const BoundingBoxND &bb) const
+        {
+            Element vol = 1;
+            for (size_t i = 0; i < dim; i++)
+            {
+                Element lo = std::max(b_min[i], bb.b_min[i]), hi = std::min(b_max[i], bb.b_max[i]);
+                if (!(lo < hi))
+                    return 0;
+                vol *= hi - lo;
+            }
+            return vol;
+        }
+
         //! Ratio of the volumes of intersection of the bounding boxes over their union.
         /*!
          * Parameter ranging from 0 for no overlap to 1 for perfect overlay.
@@ -275,14 +442,89 @@ namespace rtl
          */
         Element intersectionOverUnion(const BoundingBoxND &bb) const
         {
-            auto intersected = BoundingBoxND<dim, ElementType>::intersection(*this, bb);
-            if(intersected)
+            Element intersection_vol = intersectionVolume(bb);
+            if (intersection_vol > 0)
+                return intersection_vol / (volume() + bb.volume() - intersection_vol);
+            return 0.0;
+        }
+
+        //! Intersection over union of all pairs of bounding boxes from two sets.
+        /*!
+         * The first set is transposed into structure-of-arrays buffers, so the inner loop over its boxes uses only element-wise min/max and arithmetic and is
+         * vectorized by the compiler. The result is written in place into \p iou, which is resized only if its shape differs, so repeated calls (e.g. every
+         * frame of a tracker) do not allocate the output.
+         * @param bbs1 the first set of bounding boxes, rows of the result.
+         * @param bbs2 the second set of bounding boxes, columns of the result.
+         * @param iou output matrix with intersectionOverUnion() of \p bbs1[r] and \p bbs2[c] at (r, c).
+         */
+        static void iouMatrix(const std::vector<BoundingBoxND> &bbs1, const std::vector<BoundingBoxND> &bbs2, Matrix<Eigen::Dynamic, Eigen::Dynamic, Element> &iou)
+        {
+            const size_t n1 = bbs1.size(), n2 = bbs2.size();
+            if ((size_t) iou.data().rows() != n1 || (size_t) iou.data().cols() != n2)
+                iou.data().resize(n1, n2);
+            if (n1 == 0 || n2 == 0)
+                return;
+
+            // rows of soa: min in dimensions, max in dimensions, volume; each row starts aligned for full width vector loads
+            const size_t stride = alignedCount<Element>(n1);
+            AlignedVector<Element> soa((2 * dim + 1) * stride);
+            Element *vol1 = soa.data() + 2 * dim * stride;
+            const Element tiny = std::numeric_limits<Element>::min();
+            Element *soa_min[dim], *soa_max[dim];
+            for (size_t i = 0; i < dim; i++)
             {
-                Element intersection_vol = intersected->volume();
-                Element union_vol = volume() + bb.volume() - intersection_vol;
-                return intersection_vol / union_vol;
+                soa_min[i] = soa.data() + i * stride;
+                soa_max[i] = soa.data() + (dim + i) * stride;
+            }
+            for (size_t r = 0; r < n1; r++)
+            {
+                for (size_t i = 0; i < dim; i++)
+                {
+                    soa_min[i][r] = bbs1[r].b_min[i];
+                    soa_max[i][r] = bbs1[r].b_max[i];
+                }
+                vol1[r] = bbs1[r].volume();
+            }
+
+            for (size_t c = 0; c < n2; c++)
+            {
+                Element *out = iou.data().data() + c * n1;
+                Element min2[dim], max2[dim];
+                for (size_t i = 0; i < dim; i++)
+                {
+                    min2[i] = bbs2[c].b_min[i];
+                    max2[i] = bbs2[c].b_max[i];
+                }
+                Element vol2 = bbs2[c].volume();
+                for (size_t r = 0; r < n1; r++)
+                {
+                    Element inter = 1;
+                    for (size_t i = 0; i < dim; i++)
+                    {
+                        Element lo = soa_min[i][r], hi = soa_max[i][r];
+                        lo = lo > min2[i] ? lo : min2[i];
+                        hi = hi < max2[i] ? hi : max2[i];
+                        Element ext = hi - lo;
+                        inter *= ext > 0 ? ext : Element(0);
+                    }
+                    // the union is positive for overlapping pairs, the lower bound just prevents 0 / 0 for disjoint degenerate boxes without a branch
+                    Element uni = vol1[r] + vol2 - inter;
+                    out[r] = inter / (uni > tiny ? uni : tiny);
+                }
             }
-            return 0.0;
+        }
+
+        //! Intersection over union of all pairs of bounding boxes from two sets.
+        /*!
+         * @param bbs1 the first set of bounding boxes, rows of the result.
+         * @param bbs2 the second set of bounding boxes, columns of the result.
+         * @return matrix with intersectionOverUnion() of \p bbs1[r] and \p bbs2[c] at (r, c).
+         */
+        static Matrix<Eigen::Dynamic, Eigen::Dynamic, Element> iouMatrix(const std::vector<BoundingBoxND> &bbs1, const std::vector<BoundingBoxND> &bbs2)
+        {
+            Matrix<Eigen::Dynamic, Eigen::Dynamic, Element> iou;
+            iouMatrix(bbs1, bbs2, iou);
+            return iou;
         }
 
         //! Computes intersection of two bounding boxes if it exists.
@@ -308,6 +550,40 @@ namespace rtl
     private:
         static VectorType identityFunc(VectorType &&v) { return v; }
 
+        // Min/max of n interleaved tuples of width elements (points in AoS layout, or single values for width = 1), accumulated into lo and hi.
+        template<size_t width = dim>
+        static void reduceInterleaved(const Element *data, size_t n, Element *lo, Element *hi)
+        {
+            constexpr size_t block = 16 * width;
+            const size_t total = n * width;
+            size_t k = 0;
+            if (total >= block)
+            {
+                Element acc_lo[block], acc_hi[block];
+                for (size_t j = 0; j < block; j++)
+                    acc_lo[j] = acc_hi[j] = data[j];
+                for (k = block; k + block <= total; k += block)
+                {
+                    const Element *d = data + k;
+                    for (size_t j = 0; j < block; j++)
+                    {
+                        acc_lo[j] = d[j] < acc_lo[j] ? d[j] : acc_lo[j];
+                        acc_hi[j] = d[j] > acc_hi[j] ? d[j] : acc_hi[j];
+                    }
+                }
+                for (size_t j = 0; j < block; j++)
+                {
+                    lo[j % width] = std::min(lo[j % width], acc_lo[j]);
+                    hi[j % width] = std::max(hi[j % width], acc_hi[j]);
+                }
+            }
+            for (; k < total; k++)
+            {
+                lo[k % width] = std::min(lo[k % width], data[k]);
+                hi[k % width] = std::max(hi[k % width], data[k]);
+            }
+        }
+
         VectorType minPoint(const VectorType &v1, const VectorType &v2) const
         {
             return VectorType(v1.data().array().min(v2.data().array()).matrix());
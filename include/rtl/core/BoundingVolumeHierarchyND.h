@@ -0,0 +1,619 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_BOUNDINGVOLUMEHIERARCHYND_H
+#define ROBOTICTEMPLATELIBRARY_BOUNDINGVOLUMEHIERARCHYND_H
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+
+#include "rtl/core/BoundingBoxND.h"
+#include "rtl/core/SmallVector.h"
+#include "rtl/core/Executor.h"
+
+namespace rtl
+{
+    //! Bounding volume hierarchy of axis aligned bounding boxes - implementation for N-dimensional space.
+    /*!
+     * Spatial index over a set of objects, each represented by its BoundingBoxND and an arbitrary payload (e.g. an obstacle ID). The objects are identified by their
+     * index in the build() input. The tree is binary, built top-down with the surface area heuristic evaluated over a fixed number of centroid bins, so the build
+     * takes O(n log n) time. Nodes are stored in a flat array with siblings next to each other.
+     *
+     * Moving objects are handled by refitting: update() replaces the bounding box of a single object and enlarges or shrinks the boxes of its ancestors, setBox()
+     * with a subsequent refit() does the same for many objects at once in O(n). The topology of the tree is kept, so its query performance slowly degrades if
+     * the objects move far from their original positions and build() should be called again from time to time.
+     *
+     * Overlap tests follow BoundingBoxND::intersects(), i.e. touching boxes overlap. Queries are const and can be run concurrently, batched versions of the
+     * queries take an executor from rtl/core/Executor.h.
+     *
+     * @tparam dim dimensional space of the bounding boxes.
+     * @tparam Element type of the bounding box coordinates.
+     * @tparam Payload type of the data attached to each object.
+     */
+    template<int dim, typename Element, typename Payload = size_t>
+    class BoundingVolumeHierarchyND
+    {
+    public:
+        typedef Element ElementType;                                //!< Base data type.
+        typedef Payload PayloadType;                                //!< Type of the data attached to the objects.
+        typedef VectorND<dim, Element> VectorType;                  //!< Vector type of the query interface.
+        typedef BoundingBoxND<dim, Element> BoundingBoxType;        //!< Bounding box type of the objects and nodes.
+
+        //! Default constructor, creates an empty hierarchy.
+        BoundingVolumeHierarchyND() = default;
+
+        //! Construction from bounding boxes of the objects and their payloads, see build().
+        BoundingVolumeHierarchyND(const std::vector<BoundingBoxType> &boxes, const std::vector<Payload> &payloads)
+        {
+            build(boxes, payloads);
+        }
+
+        //! Sets maximal number of objects in a leaf node, 4 by default.
+        /*!
+         * Nodes with at most \p size objects are not split any further. The value is applied by the next build().
+         * @param size maximal number of objects in a leaf, at least 1.
+         */
+        void setMaxLeafSize(size_t size) { max_leaf = std::max<size_t>(size, 1); }
+
+        //! Maximal number of objects in a leaf node.
+        [[nodiscard]] size_t maxLeafSize() const { return max_leaf; }
+
+        //! Builds the hierarchy from scratch.
+        /*!
+         * If the sizes of \p boxes and \p payloads differ, std::invalid_argument exception is thrown.
+         * @param boxes bounding boxes of the objects.
+         * @param payloads data attached to the objects.
+         */
+        void build(const std::vector<BoundingBoxType> &boxes, const std::vector<Payload> &payloads)
+        {
+            if (boxes.size() != payloads.size())
+                throw std::invalid_argument("Different numbers of bounding boxes and payloads supplied to BoundingVolumeHierarchyND::build().");
+            obj_boxes = boxes;
+            obj_payloads = payloads;
+            nodes.clear();
+            parents.clear();
+            obj_leaves.assign(boxes.size(), 0);
+            order.resize(boxes.size());
+            std::iota(order.begin(), order.end(), 0);
+            if (boxes.empty())
+                return;
+
+            centroids.resize(boxes.size());
+            for (size_t i = 0; i < boxes.size(); i++)
+                centroids[i] = boxes[i].centroid();
+            nodes.reserve(2 * boxes.size());
+            parents.reserve(2 * boxes.size());
+            nodes.emplace_back(rangeBox(0, boxes.size()), 0, boxes.size());
+            parents.push_back(none);
+            split(0);
+        }
+
+        //! Number of objects in the hierarchy.
+        [[nodiscard]] size_t size() const { return obj_boxes.size(); }
+
+        //! Returns true if there are no objects in the hierarchy.
+        [[nodiscard]] bool empty() const { return obj_boxes.empty(); }
+
+        //! Number of nodes of the tree.
+        [[nodiscard]] size_t nodeNr() const { return nodes.size(); }
+
+        //! Bounding box of the \p i -th object.
+        [[nodiscard]] const BoundingBoxType &box(size_t i) const { return obj_boxes[i]; }
+
+        //! Payload of the \p i -th object.
+        [[nodiscard]] const Payload &payload(size_t i) const { return obj_payloads[i]; }
+
+        //! Payload of the \p i -th object.
+        [[nodiscard]] Payload &payload(size_t i) { return obj_payloads[i]; }
+
+        //! Bounding box of all objects, the hierarchy must not be empty.
+        [[nodiscard]] const BoundingBoxType &bounds() const { return nodes.front().box; }
+
+        //! Replaces the bounding box of the \p i -th object and refits all its ancestors.
+        /*!
+         * Costs O(depth) time, for updates of many objects use setBox() followed by refit().
+         * @param i index of the object.
+         * @param bb new bounding box of the object.
+         */
+        void update(size_t i, const BoundingBoxType &bb)
+        {
+            obj_boxes[i] = bb;
+            for (size_t n = obj_leaves[i]; n != none; n = parents[n])
+                refitNode(n);
+        }
+
+        //! Replaces the bounding box of the \p i -th object without refitting the tree, refit() has to be called before the next query.
+        /*!
+         * @param i index of the object.
+         * @param bb new bounding box of the object.
+         */
+        void setBox(size_t i, const BoundingBoxType &bb) { obj_boxes[i] = bb; }
+
+        //! Recomputes bounding boxes of all nodes bottom-up.
+        void refit()
+        {
+            // children are always stored behind their parents
+            for (size_t n = nodes.size(); n-- > 0;)
+                refitNode(n);
+        }
+
+        //! Invokes \p func for each object overlapping the bounding box \p query.
+        /*!
+         * @tparam Func type of the invokable object with a single size_t parameter.
+         * @param query the query bounding box.
+         * @param func invokable object receiving indices of the overlapping objects.
+         */
+        template<class Func>
+        void overlapping(const BoundingBoxType &query, Func &&func) const
+        {
+            if (nodes.empty())
+                return;
+            SmallVector<size_t, 64> stack;
+            stack.push_back(0);
+            while (!stack.empty())
+            {
+                const Node &node = nodes[stack.back()];
+                stack.pop_back();
+                if (!node.box.intersects(query))
+                    continue;
+                if (node.leaf())
+                {
+                    for (size_t k = node.first; k < node.first + node.count; k++)
+                        if (obj_boxes[order[k]].intersects(query))
+                            func(order[k]);
+                }
+                else
+                {
+                    stack.push_back(node.first + 1);
+                    stack.push_back(node.first);
+                }
+            }
+        }
+
+        //! Indices of all objects overlapping the bounding box \p query in ascending order.
+        [[nodiscard]] std::vector<size_t> overlapping(const BoundingBoxType &query) const
+        {
+            std::vector<size_t> ret;
+            overlapping(query, [&ret](size_t i) { ret.push_back(i); });
+            std::sort(ret.begin(), ret.end());
+            return ret;
+        }
+
+        //! Batched overlap query.
+        /*!
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param queries the query bounding boxes.
+         * @param executor executor used for parallel processing of the queries.
+         * @return pairs of query and object indices of all overlaps, sorted by both the query and the object index.
+         */
+        template<class Executor = SequentialExecutor>
+        [[nodiscard]] std::vector<std::pair<size_t, size_t>> overlapping(const std::vector<BoundingBoxType> &queries, Executor executor = Executor()) const
+        {
+            return collectPairs(queries.size(), executor, [this, &queries](size_t q, auto &&emit) { overlapping(queries[q], emit); });
+        }
+
+        //! All pairs of mutually overlapping objects of the hierarchy.
+        /*!
+         * Replaces the quadratic all-pairs test by a query of each object against the tree.
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param executor executor used for parallel processing.
+         * @return pairs of indices (i, j), i < j, of overlapping objects, sorted by both indices.
+         */
+        template<class Executor = SequentialExecutor>
+        [[nodiscard]] std::vector<std::pair<size_t, size_t>> selfOverlaps(Executor executor = Executor()) const
+        {
+            return collectPairs(obj_boxes.size(), executor, [this](size_t q, auto &&emit) {
+                overlapping(obj_boxes[q], [q, &emit](size_t i) {
+                    if (i > q)
+                        emit(i);
+                });
+            });
+        }
+
+        //! Invokes \p func for each object hit by a ray.
+        /*!
+         * The ray is given by origin and direction, points \p origin + t * \p direction for t from [0, \p max_t] are tested. The direction does not have to be
+         * normalized, t is then measured in its multiples. Objects are visited in no particular order.
+         * @tparam Func type of the invokable object with (size_t index, Element t) parameters.
+         * @param origin origin of the ray.
+         * @param direction direction of the ray.
+         * @param func invokable object receiving indices of the hit objects and the ray parameter of the entry point into their bounding boxes.
+         * @param max_t upper bound of the ray parameter.
+         */
+        template<class Func>
+        void raycast(const VectorType &origin, const VectorType &direction, Func &&func, Element max_t = std::numeric_limits<Element>::infinity()) const
+        {
+            Ray ray(origin, direction, max_t);
+            if (nodes.empty())
+                return;
+            SmallVector<size_t, 64> stack;
+            stack.push_back(0);
+            while (!stack.empty())
+            {
+                const Node &node = nodes[stack.back()];
+                stack.pop_back();
+                if (ray.entry(node.box) > ray.max_t)
+                    continue;
+                if (node.leaf())
+                {
+                    for (size_t k = node.first; k < node.first + node.count; k++)
+                    {
+                        Element t = ray.entry(obj_boxes[order[k]]);
+                        if (t <= ray.max_t)
+                            func(order[k], t);
+                    }
+                }
+                else
+                {
+                    stack.push_back(node.first + 1);
+                    stack.push_back(node.first);
+                }
+            }
+        }
+
+        //! The first object hit by a ray.
+        /*!
+         * Nodes are traversed front-to-back and the search range is shortened by every hit, so only a fraction of the tree is visited.
+         * @param origin origin of the ray.
+         * @param direction direction of the ray.
+         * @param max_t upper bound of the ray parameter.
+         * @return index of the object with the nearest entry point and the ray parameter of the entry point, or (size(), \p max_t) if no object is hit.
+         */
+        [[nodiscard]] std::pair<size_t, Element> firstHit(const VectorType &origin, const VectorType &direction, Element max_t = std::numeric_limits<Element>::infinity()) const
+        {
+            Ray ray(origin, direction, max_t);
+            std::pair<size_t, Element> best(obj_boxes.size(), max_t);
+            if (nodes.empty())
+                return best;
+            SmallVector<std::pair<size_t, Element>, 64> stack;
+            stack.emplace_back(0, ray.entry(nodes.front().box));
+            while (!stack.empty())
+            {
+                auto [n, t_node] = stack.back();
+                stack.pop_back();
+                if (t_node > ray.max_t)
+                    continue;
+                const Node &node = nodes[n];
+                if (node.leaf())
+                {
+                    for (size_t k = node.first; k < node.first + node.count; k++)
+                    {
+                        Element t = ray.entry(obj_boxes[order[k]]);
+                        if (t < ray.max_t || (t == ray.max_t && order[k] < best.first))
+                        {
+                            ray.max_t = t;
+                            best = {order[k], t};
+                        }
+                    }
+                }
+                else
+                {
+                    Element t_l = ray.entry(nodes[node.first].box), t_r = ray.entry(nodes[node.first + 1].box);
+                    if (t_l <= t_r)
+                    {
+                        stack.emplace_back(node.first + 1, t_r);
+                        stack.emplace_back(node.first, t_l);
+                    }
+                    else
+                    {
+                        stack.emplace_back(node.first, t_l);
+                        stack.emplace_back(node.first + 1, t_r);
+                    }
+                }
+            }
+            return best;
+        }
+
+        //! Batched first hit query.
+        /*!
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param origins origins of the rays.
+         * @param directions directions of the rays, the same number as \p origins.
+         * @param max_t upper bound of the ray parameter common for all rays.
+         * @param executor executor used for parallel processing of the rays.
+         * @return results of firstHit() for all rays.
+         */
+        template<class Executor = SequentialExecutor>
+        [[nodiscard]] std::vector<std::pair<size_t, Element>> firstHits(const std::vector<VectorType> &origins, const std::vector<VectorType> &directions,
+                                                                       Element max_t = std::numeric_limits<Element>::infinity(), Executor executor = Executor()) const
+        {
+            if (origins.size() != directions.size())
+                throw std::invalid_argument("Different numbers of ray origins and directions supplied to BoundingVolumeHierarchyND::firstHits().");
+            std::vector<std::pair<size_t, Element>> ret(origins.size());
+            executor(0, origins.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                    ret[i] = firstHit(origins[i], directions[i], max_t);
+            });
+            return ret;
+        }
+
+        //! Dimensionality of the hierarchy.
+        static constexpr int dimensionality() { return dim; }
+
+    private:
+        static constexpr size_t none = std::numeric_limits<size_t>::max();
+        static constexpr size_t bin_nr = 16;
+
+        //! Node of the tree, leaves hold order[first, first + count), inner nodes have children first and first + 1.
+        struct Node
+        {
+            Node(const BoundingBoxType &bb, size_t f, size_t c) : box(bb), first(f), count(c) {}
+            [[nodiscard]] bool leaf() const { return count != 0; }
+            BoundingBoxType box;
+            size_t first, count;
+        };
+
+        //! Ray with precomputed inverse direction for the slab test.
+        struct Ray
+        {
+            Ray(const VectorType &o, const VectorType &d, Element t) : origin(o), max_t(t)
+            {
+                for (size_t i = 0; i < dim; i++)
+                    inv_dir[i] = Element(1) / d[i];
+            }
+
+            //! Ray parameter of the entry point into \p bb, infinity if it is missed.
+            [[nodiscard]] Element entry(const BoundingBoxType &bb) const
+            {
+                Element t_min = 0, t_max = max_t;
+                VectorType b_min = bb.min(), b_max = bb.max();
+                for (size_t i = 0; i < dim; i++)
+                {
+                    if (std::isinf(inv_dir[i]))
+                    {
+                        // ray parallel to the slab, the product below might be NaN
+                        if (origin[i] < b_min[i] || origin[i] > b_max[i])
+                            return std::numeric_limits<Element>::infinity();
+                        continue;
+                    }
+                    Element t1 = (b_min[i] - origin[i]) * inv_dir[i], t2 = (b_max[i] - origin[i]) * inv_dir[i];
+                    t_min = std::max(t_min, std::min(t1, t2));
+                    t_max = std::min(t_max, std::max(t1, t2));
+                }
+                return t_min <= t_max ? t_min : std::numeric_limits<Element>::infinity();
+            }
+
+            VectorType origin, inv_dir;
+            Element max_t;
+        };
+
+        //! Half of the surface of \p bb, the SAH cost measure.
+        static Element halfArea(const VectorType &b_min, const VectorType &b_max)
+        {
+            if constexpr (dim == 1)
+                return Element(1);
+            Element area = 0;
+            for (size_t i = 0; i < dim; i++)
+            {
+                Element face = 1;
+                for (size_t j = 0; j < dim; j++)
+                    if (j != i)
+                        face *= b_max[j] - b_min[j];
+                area += face;
+            }
+            return area;
+        }
+
+        BoundingBoxType rangeBox(size_t first, size_t count) const
+        {
+            BoundingBoxType bb = obj_boxes[order[first]];
+            for (size_t k = first + 1; k < first + count; k++)
+                bb.addBoundingBox(obj_boxes[order[k]]);
+            return bb;
+        }
+
+        void refitNode(size_t n)
+        {
+            Node &node = nodes[n];
+            if (node.leaf())
+            {
+                node.box = rangeBox(node.first, node.count);
+            }
+            else
+            {
+                node.box = nodes[node.first].box;
+                node.box.addBoundingBox(nodes[node.first + 1].box);
+            }
+        }
+
+        //! Splits the n-th node recursively by the binned surface area heuristic.
+        void split(size_t n)
+        {
+            size_t first = nodes[n].first, count = nodes[n].count;
+            auto makeLeaf = [&]() {
+                for (size_t k = first; k < first + count; k++)
+                    obj_leaves[order[k]] = n;
+            };
+            if (count <= max_leaf)
+            {
+                makeLeaf();
+                return;
+            }
+
+            VectorType c_min = centroids[order[first]], c_max = c_min;
+            for (size_t k = first + 1; k < first + count; k++)
+            {
+                const VectorType &c = centroids[order[k]];
+                for (size_t i = 0; i < dim; i++)
+                {
+                    c_min[i] = std::min(c_min[i], c[i]);
+                    c_max[i] = std::max(c_max[i], c[i]);
+                }
+            }
+
+            Bin bins[dim][bin_nr];
+            for (size_t k = first; k < first + count; k++)
+            {
+                const VectorType &c = centroids[order[k]];
+                const BoundingBoxType &ob = obj_boxes[order[k]];
+                for (size_t axis = 0; axis < dim; axis++)
+                    if (c_max[axis] > c_min[axis])
+                        bins[axis][binIndex(c[axis], c_min[axis], c_max[axis] - c_min[axis])].add(ob);
+            }
+
+            // the best split over all axes, the cost of a child is its area times the number of its objects
+            Element best_cost = std::numeric_limits<Element>::infinity();
+            size_t best_axis = dim, best_bin = 0;
+            for (size_t axis = 0; axis < dim; axis++)
+            {
+                if (!(c_max[axis] > c_min[axis]))
+                    continue;
+
+                // sweep from the right stores costs of the right parts, sweep from the left evaluates the splits
+                Element right_cost[bin_nr];
+                Bin acc;
+                for (size_t b = bin_nr - 1; b > 0; b--)
+                {
+                    acc.add(bins[axis][b]);
+                    right_cost[b] = acc.cost();
+                }
+                acc = Bin();
+                for (size_t b = 1; b < bin_nr; b++)
+                {
+                    acc.add(bins[axis][b - 1]);
+                    Element cost = acc.cost() + right_cost[b];
+                    if (acc.count > 0 && acc.count < count && cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best_axis = axis;
+                        best_bin = b;
+                    }
+                }
+            }
+
+            size_t mid;
+            if (best_axis < dim)
+            {
+                Element extent = c_max[best_axis] - c_min[best_axis];
+                auto it = std::partition(order.begin() + first, order.begin() + first + count, [&](size_t o) {
+                    return binIndex(centroids[o][best_axis], c_min[best_axis], extent) < best_bin;
+                });
+                mid = it - order.begin();
+            }
+            else
+            {
+                // identical centroids, objects are split evenly in the input order
+                mid = first + count / 2;
+            }
+
+            size_t left = nodes.size();
+            nodes[n].first = left;
+            nodes[n].count = 0;
+            nodes.emplace_back(rangeBox(first, mid - first), first, mid - first);
+            nodes.emplace_back(rangeBox(mid, first + count - mid), mid, first + count - mid);
+            parents.push_back(n);
+            parents.push_back(n);
+            split(left);
+            split(left + 1);
+        }
+
+        static size_t binIndex(Element c, Element c_min, Element extent)
+        {
+            auto b = static_cast<size_t>(Element(bin_nr) * (c - c_min) / extent);
+            return std::min(b, bin_nr - 1);
+        }
+
+        //! Accumulator of object counts and bounds in a bin of the SAH build.
+        struct Bin
+        {
+            Bin()
+            {
+                for (size_t i = 0; i < dim; i++)
+                {
+                    b_min[i] = std::numeric_limits<Element>::infinity();
+                    b_max[i] = -std::numeric_limits<Element>::infinity();
+                }
+            }
+
+            void add(const BoundingBoxType &bb)
+            {
+                VectorType o_min = bb.min(), o_max = bb.max();
+                for (size_t i = 0; i < dim; i++)
+                {
+                    b_min[i] = std::min(b_min[i], o_min[i]);
+                    b_max[i] = std::max(b_max[i], o_max[i]);
+                }
+                count++;
+            }
+
+            void add(const Bin &bin)
+            {
+                for (size_t i = 0; i < dim; i++)
+                {
+                    b_min[i] = std::min(b_min[i], bin.b_min[i]);
+                    b_max[i] = std::max(b_max[i], bin.b_max[i]);
+                }
+                count += bin.count;
+            }
+
+            [[nodiscard]] Element cost() const { return count == 0 ? Element(0) : halfArea(b_min, b_max) * Element(count); }
+
+            VectorType b_min, b_max;
+            size_t count{0};
+        };
+
+        template<class Executor, class QueryFunc>
+        std::vector<std::pair<size_t, size_t>> collectPairs(size_t query_nr, Executor &executor, QueryFunc &&query) const
+        {
+            const size_t chunks = std::max<size_t>(1, std::min(executor.concurrency(), query_nr));
+            std::vector<std::vector<std::pair<size_t, size_t>>> partial(chunks);
+            executor(0, chunks, [&](size_t c_begin, size_t c_end) {
+                std::vector<size_t> hits;
+                for (size_t c = c_begin; c < c_end; c++)
+                    for (size_t q = query_nr * c / chunks; q < query_nr * (c + 1) / chunks; q++)
+                    {
+                        hits.clear();
+                        query(q, [&hits](size_t i) { hits.push_back(i); });
+                        std::sort(hits.begin(), hits.end());
+                        for (size_t i : hits)
+                            partial[c].emplace_back(q, i);
+                    }
+            });
+
+            std::vector<std::pair<size_t, size_t>> ret;
+            for (const auto &p : partial)
+                ret.insert(ret.end(), p.begin(), p.end());
+            return ret;
+        }
+
+        size_t max_leaf{4};
+        std::vector<Node> nodes;
+        std::vector<size_t> parents;
+        std::vector<size_t> order;
+        std::vector<size_t> obj_leaves;
+        std::vector<VectorType> centroids;
+        std::vector<BoundingBoxType> obj_boxes;
+        std::vector<Payload> obj_payloads;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_BOUNDINGVOLUMEHIERARCHYND_H
@@ -0,0 +1,236 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_COMPACTELEMENT_H
+#define ROBOTICTEMPLATELIBRARY_COMPACTELEMENT_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <eigen3/Eigen/Core>
+
+namespace rtl
+{
+    //! Fixed-point number for compact storage of coordinates.
+    /*!
+     * The value is stored as an integer of type \p Storage scaled by 2^fraction_bits, e.g. FixedPoint<std::int16_t, 10> spans (-32 m, 32 m) with approx. 1 mm resolution
+     * in two bytes. Conversions from floating-point values round to the nearest representable value and saturate at the ends of the range, NaN converts to zero.
+     * Conversion back is explicit, so mixed expressions do not silently lose precision.
+     *
+     * The type is meant for storage of large point sets, e.g. as VectorND<2, Fixed16<10>> or as the Element of PrecArray2D<Element, Compute>, which widens every point to
+     * its Compute type before it is used. Addition and subtraction operate on the raw values and saturate, multiplication and division round their floating-point results,
+     * so element-wise Eigen expressions work, but anything beyond them (norms, angles, ...) should be evaluated on a widened copy obtained by VectorND::cast().
+     * @tparam Storage integral type holding the raw value.
+     * @tparam fraction_bits number of fractional bits.
+     */
+    template<typename Storage, int fraction_bits>
+    class FixedPoint
+    {
+        static_assert(std::is_integral<Storage>::value, "FixedPoint requires an integral Storage type.");
+        static_assert(fraction_bits >= 0 && fraction_bits < 8 * (int)sizeof(Storage), "FixedPoint requires 0 <= fraction_bits < number of bits of the Storage type.");
+
+    public:
+        typedef Storage StorageType;    //!< Type of the raw value.
+
+        //! Default constructor, the value is zero.
+        constexpr FixedPoint() = default;
+
+        //! Construction from an arithmetic value, rounded to the nearest representable value and saturated.
+        template<typename T, typename = std::enable_if_t<std::is_convertible<T, double>::value>>
+        constexpr FixedPoint(T value) : raw_value(toRaw(static_cast<double>(value))) {}
+
+        //! Explicit conversion to an arithmetic type.
+        /*!
+         * The scale is a power of two, so floating-point types wide enough for the raw value are converted exactly by a single multiplication in the target type.
+         */
+        template<typename T, typename = std::enable_if_t<std::is_convertible<double, T>::value>>
+        constexpr explicit operator T() const
+        {
+            if constexpr (std::is_floating_point<T>::value && std::numeric_limits<T>::digits >= std::numeric_limits<Storage>::digits)
+                return static_cast<T>(raw_value) * static_cast<T>(resolution());
+            else
+                return static_cast<T>(static_cast<double>(raw_value) * resolution());
+        }
+
+        //! Construction from a raw value.
+        static constexpr FixedPoint fromRaw(Storage raw)
+        {
+            FixedPoint ret;
+            ret.raw_value = raw;
+            return ret;
+        }
+
+        //! Raw value of the number.
+        [[nodiscard]] constexpr Storage raw() const { return raw_value; }
+
+        //! Distance of two neighboring representable values.
+        static constexpr double resolution() { return 1.0 / (double)(std::int64_t(1) << fraction_bits); }
+
+        //! The lowest representable value.
+        static constexpr FixedPoint lowest() { return fromRaw(std::numeric_limits<Storage>::lowest()); }
+
+        //! The highest representable value.
+        static constexpr FixedPoint highest() { return fromRaw(std::numeric_limits<Storage>::max()); }
+
+        constexpr FixedPoint operator-() const { return fromRaw(saturate(-(std::int64_t)raw_value)); }
+        constexpr FixedPoint &operator+=(FixedPoint f) { raw_value = saturate((std::int64_t)raw_value + f.raw_value); return *this; }
+        constexpr FixedPoint &operator-=(FixedPoint f) { raw_value = saturate((std::int64_t)raw_value - f.raw_value); return *this; }
+        constexpr FixedPoint &operator*=(FixedPoint f) { return *this = FixedPoint((double)*this * (double)f); }
+        constexpr FixedPoint &operator/=(FixedPoint f) { return *this = FixedPoint((double)*this / (double)f); }
+
+        friend constexpr FixedPoint operator+(FixedPoint a, FixedPoint b) { return a += b; }
+        friend constexpr FixedPoint operator-(FixedPoint a, FixedPoint b) { return a -= b; }
+        friend constexpr FixedPoint operator*(FixedPoint a, FixedPoint b) { return a *= b; }
+        friend constexpr FixedPoint operator/(FixedPoint a, FixedPoint b) { return a /= b; }
+        friend constexpr bool operator==(FixedPoint a, FixedPoint b) { return a.raw_value == b.raw_value; }
+        friend constexpr bool operator!=(FixedPoint a, FixedPoint b) { return a.raw_value != b.raw_value; }
+        friend constexpr bool operator<(FixedPoint a, FixedPoint b) { return a.raw_value < b.raw_value; }
+        friend constexpr bool operator<=(FixedPoint a, FixedPoint b) { return a.raw_value <= b.raw_value; }
+        friend constexpr bool operator>(FixedPoint a, FixedPoint b) { return a.raw_value > b.raw_value; }
+        friend constexpr bool operator>=(FixedPoint a, FixedPoint b) { return a.raw_value >= b.raw_value; }
+
+    private:
+        static constexpr Storage saturate(std::int64_t raw)
+        {
+            return (Storage)std::clamp<std::int64_t>(raw, (std::int64_t)std::numeric_limits<Storage>::lowest(), (std::int64_t)std::numeric_limits<Storage>::max());
+        }
+
+        static constexpr Storage toRaw(double value)
+        {
+            if (!(value == value))
+                return 0;
+            double scaled = value / resolution();
+            scaled = std::clamp(scaled, (double)std::numeric_limits<Storage>::lowest(), (double)std::numeric_limits<Storage>::max());
+            return (Storage)(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+        }
+
+        Storage raw_value{0};
+    };
+
+    //! Signed 16-bit fixed-point number, e.g. Fixed16<10> for coordinates within 32 m with approx. 1 mm resolution.
+    template<int fraction_bits>
+    using Fixed16 = FixedPoint<std::int16_t, fraction_bits>;
+
+    //! Unsigned 16-bit fixed-point number, e.g. UFixed16<11> for ranges up to 32 m with approx. 0.5 mm resolution.
+    template<int fraction_bits>
+    using UFixed16 = FixedPoint<std::uint16_t, fraction_bits>;
+
+#if defined(__FLT16_MAX__)
+#define RTL_HAS_FLOAT16 1
+    typedef _Float16 Half;  //!< IEEE 754 half-precision type, available if the compiler provides _Float16 (see RTL_HAS_FLOAT16).
+#endif
+
+    //! Type the elements of type \p Element are widened to for computation.
+    /*!
+     * Compact storage types are widened to float (or double for wider fixed-point numbers), other types are computed in themselves. The trait gives the natural
+     * Compute type of PrecArray2D<Element, Compute> and the NewElement of VectorND::cast() for compact point data.
+     * @tparam Element storage type of the elements.
+     */
+    template<typename Element>
+    struct compute_type
+    {
+        typedef Element type; //!< Type for computation.
+    };
+
+    template<typename Storage, int fraction_bits>
+    struct compute_type<FixedPoint<Storage, fraction_bits>>
+    {
+        typedef std::conditional_t<(sizeof(Storage) <= 2), float, double> type;
+    };
+
+#ifdef RTL_HAS_FLOAT16
+    template<>
+    struct compute_type<Half>
+    {
+        typedef float type;
+    };
+#endif
+
+    //! Type of the compute_type trait.
+    template<typename Element>
+    using compute_type_t = typename compute_type<Element>::type;
+}
+
+namespace Eigen
+{
+    //! Eigen numeric traits of rtl::FixedPoint, required to use it as a scalar of Eigen matrices.
+    template<typename Storage, int fraction_bits>
+    struct NumTraits<rtl::FixedPoint<Storage, fraction_bits>> : GenericNumTraits<rtl::FixedPoint<Storage, fraction_bits>>
+    {
+        typedef rtl::FixedPoint<Storage, fraction_bits> Real;
+        typedef rtl::FixedPoint<Storage, fraction_bits> NonInteger;
+        typedef rtl::FixedPoint<Storage, fraction_bits> Literal;
+        typedef rtl::FixedPoint<Storage, fraction_bits> Nested;
+
+        enum
+        {
+            IsComplex = 0,
+            IsInteger = 0,
+            IsSigned = std::is_signed<Storage>::value,
+            RequireInitialization = 0,
+            ReadCost = 1,
+            AddCost = 1,
+            MulCost = 4
+        };
+
+        static inline Real epsilon() { return Real::fromRaw(1); }
+        static inline Real dummy_precision() { return Real::fromRaw(1); }
+        static inline Real highest() { return Real::highest(); }
+        static inline Real lowest() { return Real::lowest(); }
+        static inline int digits10() { return std::numeric_limits<Storage>::digits10; }
+        static inline int digits() { return std::numeric_limits<Storage>::digits; }
+    };
+
+#ifdef RTL_HAS_FLOAT16
+    //! Eigen numeric traits of _Float16, the generic ones rely on std::numeric_limits, which is not specialized for it by all standard libraries.
+    template<>
+    struct NumTraits<_Float16> : GenericNumTraits<_Float16>
+    {
+        enum
+        {
+            IsComplex = 0,
+            IsInteger = 0,
+            IsSigned = 1,
+            RequireInitialization = 0,
+            ReadCost = 1,
+            AddCost = 1,
+            MulCost = 1
+        };
+
+        static inline _Float16 epsilon() { return (_Float16)0.0009765625f; }
+        static inline _Float16 dummy_precision() { return (_Float16)1e-2f; }
+        static inline _Float16 highest() { return (_Float16)65504.0f; }
+        static inline _Float16 lowest() { return (_Float16)-65504.0f; }
+        static inline int digits10() { return __FLT16_DIG__; }
+        static inline int digits() { return __FLT16_MANT_DIG__; }
+    };
+#endif
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_COMPACTELEMENT_H
@@ -0,0 +1,247 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_EXECUTOR_H
+#define ROBOTICTEMPLATELIBRARY_EXECUTOR_H
+
+/*! \file
+ *  \brief Execution policies for data-parallel loops in RTL algorithms.
+ *
+ *  An executor is any copyable object providing concurrency() and a call operator taking a range of indices [begin, end) and an invokable object with
+ *  two size_t parameters. The executor splits the range into sub-ranges and invokes the object once for each of them, possibly concurrently. The call returns
+ *  after all sub-ranges are processed. User-supplied thread pools can be plugged into the algorithms by wrapping them into an object with the same interface.
+ */
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace rtl
+{
+    //! Executor processing the whole range at once in the calling thread.
+    struct SequentialExecutor
+    {
+        //! Number of sub-ranges processed concurrently.
+        [[nodiscard]] static constexpr size_t concurrency() { return 1; }
+
+        //! Invokes \p func on the whole range [\p begin, \p end).
+        /*!
+         *
+         * @tparam Func type of the invokable object.
+         * @param begin first index of the range.
+         * @param end one behind the last index of the range.
+         * @param func invokable object with (size_t begin, size_t end) parameters.
+         */
+        template<class Func>
+        void operator()(size_t begin, size_t end, Func &&func) const
+        {
+            if (begin < end)
+                func(begin, end);
+        }
+    };
+
+    //! Executor splitting the range evenly among std::thread workers.
+    /*!
+     * The calling thread processes the first sub-range itself, the remaining ones are processed by a pool of threads started on construction of the executor and shared by all its
+     * copies. Ranges smaller than the number of threads are processed by correspondingly fewer threads. The pool serves one call at a time; nested calls from within \a func and
+     * calls from other threads while the pool is busy process the same sub-ranges sequentially in the calling thread.
+     *
+     * If \a func throws, the remaining sub-ranges are still processed and the first exception (in order of the sub-ranges) is rethrown in the calling thread afterwards.
+     */
+    class ThreadExecutor
+    {
+    public:
+        //! Construction with given number of threads.
+        /*!
+         *
+         * @param threads number of concurrently processed sub-ranges, hardware concurrency by default.
+         */
+        explicit ThreadExecutor(size_t threads = std::thread::hardware_concurrency()) : thread_nr(std::max<size_t>(threads, 1))
+        {
+            if (thread_nr > 1)
+                int_pool = std::make_shared<Pool>(thread_nr - 1);
+        }
+
+        //! Number of sub-ranges processed concurrently.
+        [[nodiscard]] size_t concurrency() const { return thread_nr; }
+
+        //! Invokes \p func on evenly split sub-ranges of [\p begin, \p end) in parallel.
+        /*!
+         *
+         * @tparam Func type of the invokable object.
+         * @param begin first index of the range.
+         * @param end one behind the last index of the range.
+         * @param func invokable object with (size_t begin, size_t end) parameters.
+         */
+        template<class Func>
+        void operator()(size_t begin, size_t end, Func &&func) const
+        {
+            if (begin >= end)
+                return;
+            size_t len = end - begin;
+            size_t chunks = std::min(thread_nr, len);
+            if (chunks == 1)
+            {
+                func(begin, end);
+                return;
+            }
+
+            auto sub_range = [&func, begin, len, chunks](size_t c) { func(begin + len * c / chunks, begin + len * (c + 1) / chunks); };
+            std::unique_lock<std::mutex> call_lock(int_pool->call_mutex, std::try_to_lock);
+            if (!call_lock.owns_lock())
+            {
+                for (size_t c = 0; c < chunks; c++)
+                    sub_range(c);
+                return;
+            }
+
+            int_pool->start(chunks - 1, [](const void *task, size_t w) { (*static_cast<const decltype(sub_range) *>(task))(w + 1); }, &sub_range);
+            std::exception_ptr error;
+            try
+            {
+                sub_range(0);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            std::exception_ptr worker_error = int_pool->wait();
+            if (!error)
+                error = worker_error;
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+    private:
+        //! Persistent worker threads waiting for sub-ranges of the current call.
+        class Pool
+        {
+        public:
+            typedef void (*InvokeType)(const void *, size_t);
+
+            explicit Pool(size_t workers) : errors(workers)
+            {
+                threads.reserve(workers);
+                for (size_t w = 0; w < workers; w++)
+                    threads.emplace_back([this, w]() { run(w); });
+            }
+
+            Pool(const Pool &) = delete;
+            Pool &operator=(const Pool &) = delete;
+
+            ~Pool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stop = true;
+                }
+                start_cv.notify_all();
+                for (auto &t : threads)
+                    t.join();
+            }
+
+            //! Wakes the first \p workers threads to process \p task.
+            void start(size_t workers, InvokeType invoke, const void *task)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    int_invoke = invoke;
+                    int_task = task;
+                    active = workers;
+                    pending = workers;
+                    generation++;
+                }
+                start_cv.notify_all();
+            }
+
+            //! Waits for the active workers and returns the first exception they have thrown.
+            std::exception_ptr wait()
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                done_cv.wait(lock, [this]() { return pending == 0; });
+                std::exception_ptr first;
+                for (size_t w = 0; w < active; w++)
+                {
+                    if (!first)
+                        first = errors[w];
+                    errors[w] = nullptr;
+                }
+                return first;
+            }
+
+            std::mutex call_mutex;
+
+        private:
+            void run(size_t w)
+            {
+                size_t seen = 0;
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true)
+                {
+                    start_cv.wait(lock, [this, &seen]() { return stop || generation != seen; });
+                    if (stop)
+                        return;
+                    seen = generation;
+                    if (w >= active)
+                        continue;
+                    InvokeType invoke = int_invoke;
+                    const void *task = int_task;
+                    lock.unlock();
+                    try
+                    {
+                        invoke(task, w);
+                    }
+                    catch (...)
+                    {
+                        errors[w] = std::current_exception();
+                    }
+                    lock.lock();
+                    if (--pending == 0)
+                        done_cv.notify_one();
+                }
+            }
+
+            std::vector<std::thread> threads;
+            std::vector<std::exception_ptr> errors;
+            std::mutex mutex;
+            std::condition_variable start_cv, done_cv;
+            InvokeType int_invoke{nullptr};
+            const void *int_task{nullptr};
+            size_t active{0}, pending{0}, generation{0};
+            bool stop{false};
+        };
+
+        size_t thread_nr;
+        std::shared_ptr<Pool> int_pool;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_EXECUTOR_H
@@ -27,7 +27,13 @@
 #ifndef ROBOTICTEMPLATELIBRARY_FRUSTUM3D_H
 #define ROBOTICTEMPLATELIBRARY_FRUSTUM3D_H
 
+#include <vector>
+#include <cstdint>
+
 #include "rtl/core/VectorND.h"
+#include "rtl/core/BoundingBoxND.h"
+#include "rtl/core/PointCloudND.h"
+#include "rtl/core/Span.h"
 
 namespace rtl
 {
@@ -44,6 +50,10 @@ namespace rtl
     /*!
      * Fast implementation of a frustum object for storing detections from image data. The class does not perform any chcecks of data during construction, so it is possible to construct
      * an invalid frustum that way. On the other hand, the implementation is very fast and requires minimum computational overhead.
+     *
+     * Bounding planes of the frustum are precomputed on construction and transformation, so point and bounding box culling costs just a few dot products. Batch
+     * versions of the tests write results into bitmasks: bit i % 64 of word i / 64 belongs to the i-th query. They process blocks of 64 queries by branch-free loops,
+     * which the compiler vectorizes, the PointCloudND variant with contiguous coordinate arrays is the fastest one.
      * @tparam Element underlying type of numeric data.
      */
     template<typename Element>
@@ -67,12 +77,14 @@ namespace rtl
                   const VectorType &nearBottomLeft, const VectorType &nearBottomRight, Element depth) :
                   origin_{origin}, nearTopLeft_{nearTopLeft}, nearTopRight_{nearTopRight}, nearBottomLeft_{nearBottomLeft}, nearBottomRight_{nearBottomRight}, frustumDepth_{depth}
         {
+            updatePlanes();
         }
 
         //! Copy constructor.
         Frustum3D (const Frustum3D<Element>& f) : origin_{f.origin_}, nearTopLeft_{f.nearTopLeft_}, nearTopRight_{f.nearTopRight_},
                                                   nearBottomLeft_{f.nearBottomLeft_}, nearBottomRight_{f.nearBottomRight_}, frustumDepth_{f.frustumDepth_}
         {
+            updatePlanes();
         }
 
         //! Return origin (the virtual tip) of the frustum.
@@ -98,6 +110,72 @@ namespace rtl
         //! Returns distance between near and far plane.
         [[nodiscard]] ElementType getDepth() const { return frustumDepth_; }
 
+        //! Returns inward facing unit normal of the \p i -th bounding plane.
+        /*!
+         * The planes are ordered as near, far, left, right, top and bottom. A point \p p lies on the inner side of the plane if getPlaneNormal(i).dot(p) + getPlaneOffset(i) >= 0.
+         * @param i index of the plane from 0 to 5.
+         * @return the normal.
+         */
+        [[nodiscard]] VectorType getPlaneNormal(size_t i) const { return VectorType(planeNx_[i], planeNy_[i], planeNz_[i]); }
+        //! Returns offset of the \p i -th bounding plane, see getPlaneNormal().
+        [[nodiscard]] ElementType getPlaneOffset(size_t i) const { return planeOffset_[i]; }
+
+        //! Tests whether a point lies inside the frustum, points on its boundary are inside.
+        /*!
+         * @param p the point to be tested.
+         * @return true if \p p is inside, false otherwise.
+         */
+        [[nodiscard]] bool contains(const VectorType &p) const
+        {
+            return inside(p[0], p[1], p[2]);
+        }
+
+        //! Tests which points of \p pts lie inside the frustum.
+        /*!
+         * @param pts the points to be tested.
+         * @param mask output bitmask with (pts.size() + 63) / 64 words, bits of the inner points are set.
+         */
+        void contains(Span<const VectorType> pts, std::vector<uint64_t> &mask) const
+        {
+            const Element *data = pts.empty() ? nullptr : pts[0].data().data();
+            cullPoints(pts.size(), mask, data, data + 1, data + 2, 3);
+        }
+
+        //! Tests which points of \p pc lie inside the frustum.
+        /*!
+         * @param pc the points to be tested.
+         * @param mask output bitmask with (pc.size() + 63) / 64 words, bits of the inner points are set.
+         */
+        void contains(const PointCloudND<3, Element> &pc, std::vector<uint64_t> &mask) const
+        {
+            cullPoints(pc.size(), mask, pc.coordData(0), pc.coordData(1), pc.coordData(2), 1);
+        }
+
+        //! Tests whether a bounding box intersects the frustum.
+        /*!
+         * The test is conservative: a box is rejected only if it lies entirely on the outer side of one of the bounding planes. Boxes near the edges of the frustum
+         * might therefore be reported as intersecting even if they are outside, which is the usual trade-off of the culling tests.
+         * @param bb the bounding box to be tested.
+         * @return false if \p bb is certainly outside, true otherwise.
+         */
+        [[nodiscard]] bool intersects(const BoundingBoxND<3, Element> &bb) const
+        {
+            VectorType b_min = bb.min(), b_max = bb.max();
+            return boxInside(b_min[0], b_min[1], b_min[2], b_max[0], b_max[1], b_max[2]);
+        }
+
+        //! Tests which bounding boxes of \p bbs intersect the frustum, see intersects().
+        /*!
+         * @param bbs the bounding boxes to be tested.
+         * @param mask output bitmask with (bbs.size() + 63) / 64 words, bits of the intersecting boxes are set.
+         */
+        void intersects(const std::vector<BoundingBoxND<3, Element>> &bbs, std::vector<uint64_t> &mask) const
+        {
+            mask.assign((bbs.size() + 63) / 64, 0);
+            for (size_t i = 0; i < bbs.size(); i++)
+                mask[i / 64] |= uint64_t(intersects(bbs[i])) << (i % 64);
+        }
+
         //! Returns translated copy of the frustum.
         /*!
          * @param tr the translation to be applied.
@@ -120,6 +198,7 @@ namespace rtl
             nearTopRight_.transform(tr);
             nearBottomLeft_.transform(tr);
             nearBottomRight_.transform(tr);
+            updatePlanes();
         }
 
         //! Returns rotated copy of the frustum.
@@ -144,6 +223,7 @@ namespace rtl
             nearTopRight_.transform(rot);
             nearBottomLeft_.transform(rot);
             nearBottomRight_.transform(rot);
+            updatePlanes();
         }
 
         //! Returns transformed copy of the frustum.
@@ -168,6 +248,35 @@ namespace rtl
             nearTopRight_.transform(tf);
             nearBottomLeft_.transform(tf);
             nearBottomRight_.transform(tf);
+            updatePlanes();
+        }
+
+        //! Transforms a whole collection of frustums in-place.
+        /*!
+         * Since the transformation is rigid, the bounding planes are not recomputed from the corners as in transform(): the normals stored as structure of
+         * arrays are rotated directly and the offsets are shifted by the projection of the translation, which saves the cross products and normalizations.
+         * @param frustums the frustums to be transformed.
+         * @param tf the transformation to be applied.
+         */
+        static void transform(Span<Frustum3D<Element>> frustums, const RigidTfND<3, Element> &tf)
+        {
+            const auto &r = tf.rotMat().data();
+            const Element t0 = tf.trVec()[0], t1 = tf.trVec()[1], t2 = tf.trVec()[2];
+            for (auto &f : frustums)
+            {
+                for (VectorType *corner : {&f.origin_, &f.nearTopLeft_, &f.nearTopRight_, &f.nearBottomLeft_, &f.nearBottomRight_})
+                    tf.transformPoints(Span<VectorType>(corner, 1));
+                for (size_t j = 0; j < 6; j++)
+                {
+                    Element nx = r(0, 0) * f.planeNx_[j] + r(0, 1) * f.planeNy_[j] + r(0, 2) * f.planeNz_[j];
+                    Element ny = r(1, 0) * f.planeNx_[j] + r(1, 1) * f.planeNy_[j] + r(1, 2) * f.planeNz_[j];
+                    Element nz = r(2, 0) * f.planeNx_[j] + r(2, 1) * f.planeNy_[j] + r(2, 2) * f.planeNz_[j];
+                    f.planeNx_[j] = nx;
+                    f.planeNy_[j] = ny;
+                    f.planeNz_[j] = nz;
+                    f.planeOffset_[j] -= nx * t0 + ny * t1 + nz * t2;
+                }
+            }
         }
 
         //! Dimensionality of the frustum.
@@ -180,6 +289,70 @@ namespace rtl
         VectorType nearBottomLeft_;
         VectorType nearBottomRight_;
         Element frustumDepth_;
+        Element planeNx_[6], planeNy_[6], planeNz_[6], planeOffset_[6];
+
+        //! Recomputes the bounding planes from the corners, normals are oriented towards the centre of the frustum, so the winding of the corners does not matter.
+        void updatePlanes()
+        {
+            Element scale = ((getNearMidPoint() - origin_).length() + frustumDepth_) / (getNearMidPoint() - origin_).length();
+            VectorType centre = scalePoint(origin_, getNearMidPoint(), (1 + scale) / 2);
+            VectorType far_mid = scalePoint(origin_, getNearMidPoint(), scale);
+            VectorType near_normal = (nearTopRight_ - nearTopLeft_).cross(nearBottomLeft_ - nearTopLeft_);
+            setPlane(0, near_normal, nearTopLeft_, centre);
+            setPlane(1, near_normal, far_mid, centre);
+            setPlane(2, (nearTopLeft_ - origin_).cross(nearBottomLeft_ - origin_), origin_, centre);
+            setPlane(3, (nearTopRight_ - origin_).cross(nearBottomRight_ - origin_), origin_, centre);
+            setPlane(4, (nearTopLeft_ - origin_).cross(nearTopRight_ - origin_), origin_, centre);
+            setPlane(5, (nearBottomLeft_ - origin_).cross(nearBottomRight_ - origin_), origin_, centre);
+        }
+
+        void setPlane(size_t i, VectorType normal, const VectorType &on_plane, const VectorType &centre)
+        {
+            normal.normalize();
+            if (normal.dot(centre - on_plane) < 0)
+                normal = normal * Element(-1);
+            planeNx_[i] = normal[0];
+            planeNy_[i] = normal[1];
+            planeNz_[i] = normal[2];
+            planeOffset_[i] = -normal.dot(on_plane);
+        }
+
+        [[nodiscard]] bool inside(Element x, Element y, Element z) const
+        {
+            bool in = true;
+            for (size_t k = 0; k < 6; k++)
+                in &= planeNx_[k] * x + planeNy_[k] * y + planeNz_[k] * z + planeOffset_[k] >= 0;
+            return in;
+        }
+
+        //! The box is outside if its vertex furthest along the normal of some plane is outside.
+        [[nodiscard]] bool boxInside(Element x0, Element y0, Element z0, Element x1, Element y1, Element z1) const
+        {
+            bool in = true;
+            for (size_t k = 0; k < 6; k++)
+                in &= planeNx_[k] * (planeNx_[k] > 0 ? x1 : x0) + planeNy_[k] * (planeNy_[k] > 0 ? y1 : y0) + planeNz_[k] * (planeNz_[k] > 0 ? z1 : z0) + planeOffset_[k] >= 0;
+            return in;
+        }
+
+        //! Evaluates inside() for blocks of 64 points given by coordinate arrays with common \p stride and packs the results into \p mask.
+        void cullPoints(size_t n, std::vector<uint64_t> &mask, const Element *xs, const Element *ys, const Element *zs, size_t stride) const
+        {
+            mask.assign((n + 63) / 64, 0);
+            uint8_t flags[64];
+            for (size_t b = 0; b < n; b += 64)
+            {
+                size_t len = std::min<size_t>(64, n - b);
+                for (size_t r = 0; r < len; r++)
+                {
+                    size_t i = (b + r) * stride;
+                    flags[r] = inside(xs[i], ys[i], zs[i]);
+                }
+                uint64_t word = 0;
+                for (size_t r = 0; r < len; r++)
+                    word |= uint64_t(flags[r]) << r;
+                mask[b / 64] = word;
+            }
+        }
 
         static VectorType scalePoint(const VectorType& origin, const VectorType&direction, Element scale)
         {
@@ -0,0 +1,235 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_INSTRUMENTATION_H
+#define ROBOTICTEMPLATELIBRARY_INSTRUMENTATION_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+
+/*! \file
+ *  \brief Compile-time switchable instrumentation of the hot paths.
+ *
+ *  The algorithms mark their stages by RTL_ZONE("name") (a scoped timer covering the rest of the enclosing block) and report quantities by RTL_COUNT("name", value).
+ *  Unless RTL_INSTRUMENTATION is defined (e.g. by the ENABLE_INSTRUMENTATION CMake option), both macros expand to nothing and the instrumented code is identical
+ *  to the uninstrumented one.
+ *
+ *  With RTL_INSTRUMENTATION defined, the measurements go to the sink installed by rtl::instrumentation::setSink(). Without an installed sink, the timers skip reading
+ *  the clock and cost a single relaxed atomic load. HistogramSink provides simple aggregated statistics. External profilers can either be connected by implementing
+ *  the Sink interface, or by defining RTL_ZONE and RTL_COUNT before the first RTL header is included, e.g. \#define RTL_ZONE(name) ZoneScopedN(name) for Tracy.
+ */
+
+namespace rtl::instrumentation
+{
+    //! Receiver of the instrumentation events.
+    /*!
+     * Implementations are called concurrently from all threads running instrumented code and have to be thread-safe. Zone and counter names are string literals, so
+     * the pointers remain valid for the whole run of the program.
+     */
+    class Sink
+    {
+    public:
+        //! Virtual destructor.
+        virtual ~Sink() = default;
+
+        //! A scoped zone \p name finished after \p nanoseconds.
+        virtual void zone(const char *name, uint64_t nanoseconds) = 0;
+
+        //! Counter \p name reported \p value.
+        virtual void counter(const char *name, int64_t value) = 0;
+    };
+
+    //! Storage of the installed sink.
+    inline std::atomic<Sink *> installed_sink{nullptr};
+
+    //! Installs \p sink as the receiver of all instrumentation events, nullptr disables the reporting.
+    /*!
+     * The sink is not owned, it has to outlive all instrumented calls made while it is installed.
+     * @param sink new sink.
+     */
+    inline void setSink(Sink *sink)
+    {
+        installed_sink.store(sink, std::memory_order_release);
+    }
+
+    //! Currently installed sink, or nullptr.
+    inline Sink *sink()
+    {
+        return installed_sink.load(std::memory_order_acquire);
+    }
+
+    //! Reports \p value of counter \p name to the installed sink, if any.
+    inline void count(const char *name, int64_t value)
+    {
+        if (Sink *s = sink())
+            s->counter(name, value);
+    }
+
+    //! Timer reporting the duration of its lifetime as a zone to the installed sink.
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+        //! Starts the zone \p name, the clock is read only if a sink is installed.
+        explicit ScopedTimer(const char *name) : int_name(name), int_sink(sink())
+        {
+            if (int_sink != nullptr)
+                int_start = std::chrono::steady_clock::now();
+        }
+
+        //! Finishes the zone and reports it.
+        ~ScopedTimer()
+        {
+            if (int_sink != nullptr)
+                int_sink->zone(int_name, (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - int_start).count());
+        }
+
+    private:
+        const char *int_name;
+        Sink *int_sink;
+        std::chrono::steady_clock::time_point int_start;
+    };
+
+    //! Thread-safe sink aggregating the events into per-name statistics.
+    /*!
+     * Zones are collected into histograms with power-of-two buckets of the duration in nanoseconds, counters into their sum and extremes.
+     */
+    class HistogramSink : public Sink
+    {
+    public:
+        static constexpr size_t bucket_nr = 64;     //!< Number of histogram buckets, bucket i covers durations in [2^i, 2^(i+1)) ns.
+
+        //! Aggregated statistics of one zone or counter.
+        struct Stats
+        {
+            uint64_t calls{0};                                      //!< Number of events.
+            int64_t total{0};                                       //!< Total duration in ns for zones, sum of values for counters.
+            int64_t min{std::numeric_limits<int64_t>::max()};       //!< Shortest duration or minimal value.
+            int64_t max{std::numeric_limits<int64_t>::min()};       //!< Longest duration or maximal value.
+            uint64_t buckets[bucket_nr]{};                          //!< Duration histogram, zones only.
+
+            //! Mean duration or value.
+            [[nodiscard]] double mean() const { return calls > 0 ? (double) total / (double) calls : 0.0; }
+
+            //! Upper bound of the duration below which fraction \p q of the zone events finished, resolved to the bucket boundaries.
+            [[nodiscard]] int64_t quantile(double q) const
+            {
+                auto target = (uint64_t) (q * (double) calls);
+                uint64_t acc = 0;
+                for (size_t b = 0; b < bucket_nr; b++)
+                {
+                    acc += buckets[b];
+                    if (acc > target || acc == calls)
+                        return b + 1 < 63 ? (int64_t(1) << (b + 1)) : max;
+                }
+                return max;
+            }
+        };
+
+        void zone(const char *name, uint64_t nanoseconds) override
+        {
+            size_t bucket = 0;
+            while (bucket + 1 < bucket_nr && (nanoseconds >> (bucket + 1)) != 0)
+                bucket++;
+            std::lock_guard<std::mutex> lock(mutex);
+            Stats &s = add(zones[name], (int64_t) nanoseconds);
+            s.buckets[bucket]++;
+        }
+
+        void counter(const char *name, int64_t value) override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            add(counters[name], value);
+        }
+
+        //! Copy of the zone statistics indexed by zone names.
+        [[nodiscard]] std::map<std::string, Stats> zoneStats() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return zones;
+        }
+
+        //! Copy of the counter statistics indexed by counter names.
+        [[nodiscard]] std::map<std::string, Stats> counterStats() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return counters;
+        }
+
+        //! Discards all collected statistics.
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            zones.clear();
+            counters.clear();
+        }
+
+    private:
+        static Stats &add(Stats &s, int64_t value)
+        {
+            s.calls++;
+            s.total += value;
+            s.min = std::min(s.min, value);
+            s.max = std::max(s.max, value);
+            return s;
+        }
+
+        mutable std::mutex mutex;
+        std::map<std::string, Stats> zones, counters;
+    };
+}
+
+#define RTL_INSTRUMENTATION_CONCAT_IMPL(a, b) a##b
+#define RTL_INSTRUMENTATION_CONCAT(a, b) RTL_INSTRUMENTATION_CONCAT_IMPL(a, b)
+
+#ifndef RTL_ZONE
+#ifdef RTL_INSTRUMENTATION
+//! Scoped timer measuring the rest of the enclosing block as zone \p name.
+#define RTL_ZONE(name) ::rtl::instrumentation::ScopedTimer RTL_INSTRUMENTATION_CONCAT(rtl_zone_, __LINE__)(name)
+#else
+#define RTL_ZONE(name) do {} while (false)
+#endif
+#endif
+
+#ifndef RTL_COUNT
+#ifdef RTL_INSTRUMENTATION
+//! Reports \p value of counter \p name.
+#define RTL_COUNT(name, value) ::rtl::instrumentation::count(name, (int64_t) (value))
+#else
+#define RTL_COUNT(name, value) do {} while (false)
+#endif
+#endif
+
+#endif //ROBOTICTEMPLATELIBRARY_INSTRUMENTATION_H
@@ -0,0 +1,380 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_KDTREEND_H
+#define ROBOTICTEMPLATELIBRARY_KDTREEND_H
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <numeric>
+#include <algorithm>
+
+#include "rtl/core/VectorND.h"
+#include "rtl/core/Span.h"
+#include "rtl/core/Executor.h"
+
+namespace rtl
+{
+    //! KD-tree for nearest neighbour search in a cloud of VectorND points.
+    /*!
+     * The tree is array-backed: points are copied into a contiguous buffer permuted so that every node covers a contiguous range, nodes are stored in
+     * depth-first order with the left child next to its parent and leaves hold small buckets of points, which are scanned linearly. Splits are made at the median
+     * of the dimension with the largest spread, so the tree is balanced.
+     *
+     * Incremental insertion follows the logarithmic method: inserted points are collected in a small buffer, full buffers become new trees and trees of similar
+     * size are merged into one, so there are at most logarithmically many trees and an insertion costs O(log^2 n) amortized time. Queries search all trees.
+     *
+     * Points are identified by their index in the order of insertion (build() input first). Distances are Euclidean and returned squared to spare the square root.
+     * Queries are const and can be run concurrently, batched versions of the queries take an executor from rtl/core/Executor.h.
+     *
+     * @tparam dim dimensionality of the points.
+     * @tparam Element type of the point coordinates.
+     */
+    template<int dim, typename Element>
+    class KdTreeND
+    {
+    public:
+        typedef Element ElementType;                    //!< Base data type.
+        typedef VectorND<dim, Element> VectorType;      //!< Vector type of the points.
+        typedef std::pair<size_t, Element> ResultType;  //!< Index of a point with its squared distance to the query.
+
+        //! Default constructor, creates an empty tree.
+        KdTreeND() = default;
+
+        //! Construction from given points, see build().
+        explicit KdTreeND(Span<const VectorType> pts) { build(pts); }
+
+        //! Sets maximal number of points in a leaf, 8 by default.
+        /*!
+         * The value is applied to trees built after the call.
+         * @param size maximal number of points in a leaf, at least 1.
+         */
+        void setLeafSize(size_t size) { leaf_size = std::max<size_t>(size, 1); }
+
+        //! Maximal number of points in a leaf.
+        [[nodiscard]] size_t leafSize() const { return leaf_size; }
+
+        //! Drops all points and builds a new tree over \p pts.
+        /*!
+         * @param pts points to be indexed, they get indices from 0 to pts.size() - 1.
+         */
+        void build(Span<const VectorType> pts)
+        {
+            points.assign(pts.begin(), pts.end());
+            trees.clear();
+            pending = 0;
+            if (!points.empty())
+                trees.push_back(makeTree(0, points.size()));
+        }
+
+        //! Inserts a single point, its index is size() before the call.
+        void insert(const VectorType &pt)
+        {
+            points.push_back(pt);
+            if (++pending < leaf_size)
+                return;
+
+            // pending points become the smallest tree, trees of similar size are merged like in binary addition
+            size_t begin = points.size() - pending;
+            pending = 0;
+            while (!trees.empty() && trees.back().end - trees.back().begin <= points.size() - begin)
+            {
+                begin = trees.back().begin;
+                trees.pop_back();
+            }
+            trees.push_back(makeTree(begin, points.size()));
+        }
+
+        //! Inserts all points of \p pts.
+        void insert(Span<const VectorType> pts)
+        {
+            for (const auto &p : pts)
+                insert(p);
+        }
+
+        //! Number of indexed points.
+        [[nodiscard]] size_t size() const { return points.size(); }
+
+        //! Returns true if there are no points in the tree.
+        [[nodiscard]] bool empty() const { return points.empty(); }
+
+        //! The \p i -th point in the order of insertion.
+        [[nodiscard]] const VectorType &point(size_t i) const { return points[i]; }
+
+        //! Number of trees searched by queries, grows logarithmically with insertions after build().
+        [[nodiscard]] size_t treeNr() const { return trees.size(); }
+
+        //! The nearest point to \p query.
+        /*!
+         * @param query the query point.
+         * @return index of the nearest point and its squared distance to \p query, or (size(), infinity) if the tree is empty. Ties are resolved by the lower index.
+         */
+        [[nodiscard]] ResultType nearest(const VectorType &query) const
+        {
+            std::vector<ResultType> heap;
+            heap.reserve(1);
+            search(query, 1, heap);
+            return heap.empty() ? ResultType(points.size(), std::numeric_limits<Element>::infinity()) : heap.front();
+        }
+
+        //! The \p k nearest points to \p query.
+        /*!
+         * @param query the query point.
+         * @param k number of the neighbours.
+         * @return indices of min(k, size()) nearest points with their squared distances to \p query, sorted by the distance (and index for ties).
+         */
+        [[nodiscard]] std::vector<ResultType> kNearest(const VectorType &query, size_t k) const
+        {
+            std::vector<ResultType> heap;
+            heap.reserve(std::min(k, points.size()));
+            search(query, k, heap);
+            std::sort_heap(heap.begin(), heap.end(), closer);
+            return heap;
+        }
+
+        //! All points within distance \p radius from \p query.
+        /*!
+         * @param query the query point.
+         * @param radius the search radius, points exactly at the radius are included.
+         * @return indices of the points with their squared distances to \p query, sorted by the distance (and index for ties).
+         */
+        [[nodiscard]] std::vector<ResultType> radiusSearch(const VectorType &query, Element radius) const
+        {
+            std::vector<ResultType> ret;
+            Element r2 = radius * radius;
+            auto visit = [&ret, r2](size_t i, Element d2) {
+                if (d2 <= r2)
+                    ret.emplace_back(i, d2);
+                return r2;
+            };
+            for (const auto &t : trees)
+                searchTree(t, query, visit, r2);
+            scanPending(query, visit);
+            std::sort(ret.begin(), ret.end(), closer);
+            return ret;
+        }
+
+        //! Batched nearest neighbour query.
+        /*!
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param queries the query points.
+         * @param executor executor used for parallel processing of the queries.
+         * @return results of nearest() for all queries.
+         */
+        template<class Executor = SequentialExecutor>
+        [[nodiscard]] std::vector<ResultType> nearest(Span<const VectorType> queries, Executor executor = Executor()) const
+        {
+            std::vector<ResultType> ret(queries.size());
+            executor(0, queries.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                    ret[i] = nearest(queries[i]);
+            });
+            return ret;
+        }
+
+        //! Batched k nearest neighbours query.
+        /*!
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param queries the query points.
+         * @param k number of the neighbours.
+         * @param executor executor used for parallel processing of the queries.
+         * @return results of kNearest() for all queries.
+         */
+        template<class Executor = SequentialExecutor>
+        [[nodiscard]] std::vector<std::vector<ResultType>> kNearest(Span<const VectorType> queries, size_t k, Executor executor = Executor()) const
+        {
+            std::vector<std::vector<ResultType>> ret(queries.size());
+            executor(0, queries.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                    ret[i] = kNearest(queries[i], k);
+            });
+            return ret;
+        }
+
+        //! Batched radius search.
+        /*!
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param queries the query points.
+         * @param radius the search radius common for all queries.
+         * @param executor executor used for parallel processing of the queries.
+         * @return results of radiusSearch() for all queries.
+         */
+        template<class Executor = SequentialExecutor>
+        [[nodiscard]] std::vector<std::vector<ResultType>> radiusSearch(Span<const VectorType> queries, Element radius, Executor executor = Executor()) const
+        {
+            std::vector<std::vector<ResultType>> ret(queries.size());
+            executor(0, queries.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                    ret[i] = radiusSearch(queries[i], radius);
+            });
+            return ret;
+        }
+
+        //! Dimensionality of the indexed points.
+        static constexpr int dimensionality() { return dim; }
+
+    private:
+        //! Node of a tree, inner nodes have the left child right behind them.
+        struct Node
+        {
+            Element split;              //!< Split value of inner nodes.
+            int axis;                   //!< Split dimension of inner nodes, -1 for leaves.
+            size_t first, last;         //!< Range of Tree::pts covered by a leaf, index of the right child of an inner node in last.
+        };
+
+        //! Static tree over points[begin, end).
+        struct Tree
+        {
+            size_t begin, end;
+            std::vector<Node> nodes;
+            std::vector<VectorType> pts;    //!< Points in the order of leaves.
+            std::vector<size_t> ids;        //!< Indices of pts in points.
+        };
+
+        static bool closer(const ResultType &a, const ResultType &b)
+        {
+            return a.second < b.second || (a.second == b.second && a.first < b.first);
+        }
+
+        Tree makeTree(size_t begin, size_t end) const
+        {
+            // points are permuted together with their indices, so the build works on contiguous memory
+            std::vector<std::pair<VectorType, size_t>> items;
+            items.reserve(end - begin);
+            for (size_t i = begin; i < end; i++)
+                items.emplace_back(points[i], i);
+
+            Tree t;
+            t.begin = begin;
+            t.end = end;
+            t.nodes.reserve(2 * (end - begin) / leaf_size + 1);
+            buildNode(t, items, 0, items.size());
+            t.pts.reserve(items.size());
+            t.ids.reserve(items.size());
+            for (const auto &it : items)
+            {
+                t.pts.push_back(it.first);
+                t.ids.push_back(it.second);
+            }
+            return t;
+        }
+
+        void buildNode(Tree &t, std::vector<std::pair<VectorType, size_t>> &items, size_t first, size_t last) const
+        {
+            size_t n = t.nodes.size();
+            t.nodes.push_back({Element(0), -1, first, last});
+            if (last - first <= leaf_size)
+                return;
+
+            VectorType lo = items[first].first, hi = lo;
+            for (size_t i = first + 1; i < last; i++)
+            {
+                const VectorType &p = items[i].first;
+                for (size_t d = 0; d < dim; d++)
+                {
+                    lo[d] = std::min(lo[d], p[d]);
+                    hi[d] = std::max(hi[d], p[d]);
+                }
+            }
+            int axis = 0;
+            for (size_t d = 1; d < dim; d++)
+                if (hi[d] - lo[d] > hi[axis] - lo[axis])
+                    axis = (int) d;
+            if (!(hi[axis] > lo[axis]))
+                return;
+
+            size_t mid = first + (last - first) / 2;
+            std::nth_element(items.begin() + first, items.begin() + mid, items.begin() + last,
+                             [axis](const auto &a, const auto &b) { return a.first[axis] < b.first[axis]; });
+            t.nodes[n].axis = axis;
+            t.nodes[n].split = items[mid].first[axis];
+            buildNode(t, items, first, mid);
+            t.nodes[n].last = t.nodes.size();
+            buildNode(t, items, mid, last);
+        }
+
+        //! Depth-first search of a tree, \p visit receives candidate points and returns the current squared search radius, which is returned at the end.
+        template<class Visit>
+        Element searchTree(const Tree &t, const VectorType &query, Visit &&visit, Element bound, size_t n = 0) const
+        {
+            const Node &node = t.nodes[n];
+            if (node.axis < 0)
+            {
+                for (size_t i = node.first; i < node.last; i++)
+                    bound = visit(t.ids[i], VectorType::distanceSquared(query, t.pts[i]));
+                return bound;
+            }
+            Element diff = query[node.axis] - node.split;
+            size_t near = diff < 0 ? n + 1 : node.last, far = diff < 0 ? node.last : n + 1;
+            bound = searchTree(t, query, visit, bound, near);
+            if (diff * diff <= bound)
+                bound = searchTree(t, query, visit, bound, far);
+            return bound;
+        }
+
+        template<class Visit>
+        void scanPending(const VectorType &query, Visit &&visit) const
+        {
+            for (size_t i = points.size() - pending; i < points.size(); i++)
+                visit(i, VectorType::distanceSquared(query, points[i]));
+        }
+
+        //! k nearest neighbours search, \p heap is a max-heap with respect to closer().
+        void search(const VectorType &query, size_t k, std::vector<ResultType> &heap) const
+        {
+            if (k == 0)
+                return;
+            auto visit = [&heap, k](size_t i, Element d2) {
+                ResultType r(i, d2);
+                if (heap.size() < k)
+                {
+                    heap.push_back(r);
+                    std::push_heap(heap.begin(), heap.end(), closer);
+                }
+                else if (closer(r, heap.front()))
+                {
+                    std::pop_heap(heap.begin(), heap.end(), closer);
+                    heap.back() = r;
+                    std::push_heap(heap.begin(), heap.end(), closer);
+                }
+                return heap.size() < k ? std::numeric_limits<Element>::infinity() : heap.front().second;
+            };
+            Element bound = std::numeric_limits<Element>::infinity();
+            for (const auto &t : trees)
+                bound = searchTree(t, query, visit, bound);
+            scanPending(query, visit);
+        }
+
+        size_t leaf_size{8};
+        size_t pending{0};
+        std::vector<VectorType> points;
+        std::vector<Tree> trees;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_KDTREEND_H
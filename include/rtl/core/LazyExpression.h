@@ -0,0 +1,282 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_LAZYEXPRESSION_H
+#define ROBOTICTEMPLATELIBRARY_LAZYEXPRESSION_H
+
+#include <type_traits>
+#include <eigen3/Eigen/Dense>
+
+namespace rtl
+{
+    template<int dimensions, typename Element, template<int, typename> class ChildTemplate>
+    class VectorND_common;
+
+    template<int dimensions, typename Element>
+    class VectorND;
+
+    template<int rows, int cols, typename Element>
+    class Matrix;
+
+    //! Unevaluated arithmetic expression over VectorND and Matrix operands.
+    /*!
+     * Arithmetic operators of VectorND and Matrix return fully evaluated objects, so an expression like \a a + \a b * \a s - \a c creates a temporary for every operator. LazyExpression
+     * is an opt-in alternative: operands wrapped by rtl::lazy() combine into a single Eigen expression, which is evaluated in one fused pass only when the result is converted to
+     * VectorND (for single column expressions) or Matrix, e.g.
+     * \code
+     * rtl::Vector3f r = rtl::lazy(a) + b * s - c;
+     * \endcode
+     * Once one operand of +, - or * is a LazyExpression, the others may be plain VectorND or Matrix objects. Reductions (dot(), length(), lengthSquared()) are computed directly on
+     * the expression without materializing it.
+     *
+     * Like Eigen expressions, LazyExpression refers to its lvalue operands, it must not outlive them and should not be stored in \a auto variables past the end of the full expression.
+     * Temporary VectorND or Matrix operands (e.g. the result of an eager \a b * \a s) are copied into the expression, so they cannot leave dangling references.
+     * @tparam rows number of rows of the result.
+     * @tparam cols number of columns of the result, 1 for vectors.
+     * @tparam Element base type of the elements.
+     * @tparam Expr type of the underlying Eigen expression.
+     */
+    template<int rows, int cols, typename Element, class Expr>
+    class LazyExpression
+    {
+    public:
+        typedef Element ElementType;    //!< Base type of the elements.
+        typedef std::conditional_t<cols == 1, VectorND<rows, Element>, Matrix<rows, cols, Element>> ResultType; //!< Type of the evaluated expression.
+
+        //! Construction from an Eigen expression.
+        explicit LazyExpression(const Expr &expr) : int_expr(expr) {}
+
+        //! The underlying Eigen expression.
+        const Expr &expression() const { return int_expr; }
+
+        //! Evaluates the expression into a new VectorND or Matrix.
+        ResultType eval() const { return ResultType(typename ResultType::EigenType(int_expr)); }
+
+        //! Implicit evaluation on assignment or construction of VectorND or Matrix.
+        operator ResultType() const { return eval(); }
+
+        //! Evaluation of single column expressions into a single column Matrix.
+        template<int c = cols, typename std::enable_if_t<c == 1, int> = 0>
+        operator Matrix<rows, c, Element>() const { return Matrix<rows, c, Element>(typename Matrix<rows, c, Element>::EigenType(int_expr)); }
+
+        //! Dot product of two single column expressions.
+        /*!
+         * @tparam Other LazyExpression, VectorND or Matrix type with matching dimensions.
+         * @param other second operand.
+         * @return dot product computed without evaluation of the operands.
+         */
+        template<class Other>
+        Element dot(const Other &other) const;
+
+        //! Squared Euclidean (Frobenius for matrices) norm computed without evaluation of the expression.
+        Element lengthSquared() const { return int_expr.squaredNorm(); }
+
+        //! Euclidean (Frobenius for matrices) norm computed without evaluation of the expression.
+        Element length() const { return int_expr.norm(); }
+
+    private:
+        Expr int_expr;
+    };
+
+    //! Wraps Eigen expression \p expr into a LazyExpression of given shape.
+    template<int rows, int cols, typename Element, class Expr>
+    LazyExpression<rows, cols, Element, Expr> makeLazy(const Expr &expr)
+    {
+        return LazyExpression<rows, cols, Element, Expr>(expr);
+    }
+
+    //! Eigen nullary functor owning a copy of a plain matrix, used to keep temporary operands alive inside a lazy expression.
+    template<class Plain>
+    struct lazy_value
+    {
+        Plain value;    //!< The owned operand.
+
+        //! Element access for Eigen::CwiseNullaryOp.
+        typename Plain::Scalar operator()(Eigen::Index row, Eigen::Index col) const { return value(row, col); }
+    };
+
+    //! Wraps temporary Eigen matrix \p m into an expression owning its copy.
+    template<class Plain>
+    auto lazyValue(Plain &&m)
+    {
+        return Plain::NullaryExpr(m.rows(), m.cols(), lazy_value<Plain>{std::move(m)});
+    }
+
+    //! Tests whether type \p T can be an operand of LazyExpression arithmetic and provides its shape and lazy form.
+    /*!
+     *
+     * @tparam T type to be tested.
+     */
+    template<typename T>
+    struct lazy_operand
+    {
+        static constexpr bool value = false;        //!< true if \p T is LazyExpression, VectorND or Matrix.
+        static constexpr bool is_expression = false;    //!< true if \p T is a LazyExpression.
+    };
+
+    template<int rows, int cols, typename Element, class Expr>
+    struct lazy_operand<LazyExpression<rows, cols, Element, Expr>>
+    {
+        static constexpr bool value = true;
+        static constexpr bool is_expression = true;
+        static constexpr int row_nr = rows;
+        static constexpr int col_nr = cols;
+        typedef Element ElementType;
+        static const LazyExpression<rows, cols, Element, Expr> &wrap(const LazyExpression<rows, cols, Element, Expr> &e) { return e; }
+    };
+
+    template<int dimensions, typename Element, template<int, typename> class ChildTemplate>
+    struct lazy_operand<VectorND_common<dimensions, Element, ChildTemplate>>
+    {
+        static constexpr bool value = true;
+        static constexpr bool is_expression = false;
+        static constexpr int row_nr = dimensions;
+        static constexpr int col_nr = 1;
+        typedef Element ElementType;
+        static auto wrap(const VectorND_common<dimensions, Element, ChildTemplate> &v) { return lazy(v); }
+        static auto wrap(VectorND_common<dimensions, Element, ChildTemplate> &&v) { return makeLazy<row_nr, col_nr, Element>(lazyValue(std::move(v.data()))); }
+    };
+
+    template<int dimensions, typename Element>
+    struct lazy_operand<VectorND<dimensions, Element>>
+    {
+        static constexpr bool value = true;
+        static constexpr bool is_expression = false;
+        static constexpr int row_nr = dimensions;
+        static constexpr int col_nr = 1;
+        typedef Element ElementType;
+        static auto wrap(const VectorND<dimensions, Element> &v) { return lazy(v); }
+        static auto wrap(VectorND<dimensions, Element> &&v) { return makeLazy<row_nr, col_nr, Element>(lazyValue(std::move(v.data()))); }
+    };
+
+    template<int rows, int cols, typename Element>
+    struct lazy_operand<Matrix<rows, cols, Element>>
+    {
+        static constexpr bool value = true;
+        static constexpr bool is_expression = false;
+        static constexpr int row_nr = rows;
+        static constexpr int col_nr = cols;
+        typedef Element ElementType;
+        static auto wrap(const Matrix<rows, cols, Element> &m) { return lazy(m); }
+        static auto wrap(Matrix<rows, cols, Element> &&m) { return makeLazy<row_nr, col_nr, Element>(lazyValue(std::move(m.data()))); }
+    };
+
+    //! True if \p A and \p B can be combined by LazyExpression arithmetic and at least one of them is a LazyExpression.
+    template<typename A, typename B>
+    constexpr bool lazy_operands_v = lazy_operand<std::decay_t<A>>::value && lazy_operand<std::decay_t<B>>::value &&
+                                     (lazy_operand<std::decay_t<A>>::is_expression || lazy_operand<std::decay_t<B>>::is_expression);
+
+    //! Starts a lazy expression with a vector operand.
+    /*!
+     *
+     * @param v the vector, referenced by the expression.
+     * @return single column LazyExpression referring to \p v.
+     */
+    template<int dimensions, typename Element, template<int, typename> class ChildTemplate>
+    auto lazy(const VectorND_common<dimensions, Element, ChildTemplate> &v)
+    {
+        typedef typename VectorND_common<dimensions, Element, ChildTemplate>::EigenType EigenType;
+        return LazyExpression<dimensions, 1, Element, const EigenType &>(v.data());
+    }
+
+    //! Starts a lazy expression with a matrix operand.
+    /*!
+     *
+     * @param m the matrix, referenced by the expression.
+     * @return LazyExpression referring to \p m.
+     */
+    template<int rows, int cols, typename Element>
+    auto lazy(const Matrix<rows, cols, Element> &m)
+    {
+        return LazyExpression<rows, cols, Element, const typename Matrix<rows, cols, Element>::EigenType &>(m.data());
+    }
+
+    template<int rows, int cols, typename Element, class Expr>
+    template<class Other>
+    Element LazyExpression<rows, cols, Element, Expr>::dot(const Other &other) const
+    {
+        static_assert(cols == 1 && lazy_operand<Other>::col_nr == 1 && lazy_operand<Other>::row_nr == rows, "LazyExpression::dot() requires column vectors of the same size.");
+        return int_expr.dot(lazy_operand<Other>::wrap(other).expression());
+    }
+
+    //! Lazy sum, see LazyExpression.
+    template<typename A, typename B, typename std::enable_if_t<lazy_operands_v<A, B>, int> = 0>
+    auto operator+(A &&a, B &&b)
+    {
+        static_assert(lazy_operand<std::decay_t<A>>::row_nr == lazy_operand<std::decay_t<B>>::row_nr && lazy_operand<std::decay_t<A>>::col_nr == lazy_operand<std::decay_t<B>>::col_nr, "LazyExpression sum requires operands of the same size.");
+        return makeLazy<lazy_operand<std::decay_t<A>>::row_nr, lazy_operand<std::decay_t<A>>::col_nr, typename lazy_operand<std::decay_t<A>>::ElementType>(
+                lazy_operand<std::decay_t<A>>::wrap(std::forward<A>(a)).expression() + lazy_operand<std::decay_t<B>>::wrap(std::forward<B>(b)).expression());
+    }
+
+    //! Lazy difference, see LazyExpression.
+    template<typename A, typename B, typename std::enable_if_t<lazy_operands_v<A, B>, int> = 0>
+    auto operator-(A &&a, B &&b)
+    {
+        static_assert(lazy_operand<std::decay_t<A>>::row_nr == lazy_operand<std::decay_t<B>>::row_nr && lazy_operand<std::decay_t<A>>::col_nr == lazy_operand<std::decay_t<B>>::col_nr, "LazyExpression difference requires operands of the same size.");
+        return makeLazy<lazy_operand<std::decay_t<A>>::row_nr, lazy_operand<std::decay_t<A>>::col_nr, typename lazy_operand<std::decay_t<A>>::ElementType>(
+                lazy_operand<std::decay_t<A>>::wrap(std::forward<A>(a)).expression() - lazy_operand<std::decay_t<B>>::wrap(std::forward<B>(b)).expression());
+    }
+
+    //! Lazy matrix product, see LazyExpression.
+    template<typename A, typename B, typename std::enable_if_t<lazy_operands_v<A, B>, int> = 0>
+    auto operator*(A &&a, B &&b)
+    {
+        static_assert(lazy_operand<std::decay_t<A>>::col_nr == lazy_operand<std::decay_t<B>>::row_nr, "LazyExpression product requires matching inner dimensions.");
+        return makeLazy<lazy_operand<std::decay_t<A>>::row_nr, lazy_operand<std::decay_t<B>>::col_nr, typename lazy_operand<std::decay_t<A>>::ElementType>(
+                lazy_operand<std::decay_t<A>>::wrap(std::forward<A>(a)).expression() * lazy_operand<std::decay_t<B>>::wrap(std::forward<B>(b)).expression());
+    }
+
+    //! Lazy multiplication by a scalar from the right.
+    template<int rows, int cols, typename Element, class Expr>
+    auto operator*(const LazyExpression<rows, cols, Element, Expr> &e, typename LazyExpression<rows, cols, Element, Expr>::ElementType factor)
+    {
+        return makeLazy<rows, cols, Element>(e.expression() * factor);
+    }
+
+    //! Lazy multiplication by a scalar from the left.
+    template<int rows, int cols, typename Element, class Expr>
+    auto operator*(typename LazyExpression<rows, cols, Element, Expr>::ElementType factor, const LazyExpression<rows, cols, Element, Expr> &e)
+    {
+        return makeLazy<rows, cols, Element>(factor * e.expression());
+    }
+
+    //! Lazy division by a scalar.
+    template<int rows, int cols, typename Element, class Expr>
+    auto operator/(const LazyExpression<rows, cols, Element, Expr> &e, typename LazyExpression<rows, cols, Element, Expr>::ElementType divisor)
+    {
+        return makeLazy<rows, cols, Element>(e.expression() / divisor);
+    }
+
+    //! Lazy negation.
+    template<int rows, int cols, typename Element, class Expr>
+    auto operator-(const LazyExpression<rows, cols, Element, Expr> &e)
+    {
+        return makeLazy<rows, cols, Element>(-e.expression());
+    }
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_LAZYEXPRESSION_H
@@ -0,0 +1,576 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_LINESEGMENTARRAYND_H
+#define ROBOTICTEMPLATELIBRARY_LINESEGMENTARRAYND_H
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <eigen3/Eigen/Dense>
+
+#include "rtl/core/AlignedAllocator.h"
+#include "rtl/core/VectorND.h"
+#include "rtl/core/LineSegmentND.h"
+#include "rtl/core/BoundingBoxND.h"
+#include "rtl/core/BoundingVolumeHierarchyND.h"
+#include "rtl/core/Span.h"
+#include "rtl/core/Executor.h"
+
+namespace rtl
+{
+    //! Structure-of-arrays container of line segments with batched distance and closest-segment queries.
+    /*!
+     * Segments are kept in a single dynamic Eigen matrix with one row per segment and columns holding the begin point coordinates, the unit direction coordinates and the
+     * length. Column-major storage makes each of them one contiguous array, so the distance kernels run over all segments in branch-free loops, which the compiler vectorizes.
+     * The per-segment direction is computed once on insertion instead of in every query.
+     *
+     * Contrary to LineSegmentND::distanceToPoint(), which measures the distance to the line passing through the segment, all distances here are to the segments themselves
+     * (closest points are clamped to the end points) and are returned squared to spare the square root.
+     *
+     * Closest-segment queries scan all segments by default. For large maps, buildIndex() creates a BoundingVolumeHierarchyND over the segment bounding boxes, which is then
+     * used by the gated queries (with a search radius) to prune the candidates. Any modification of the segments drops the index. Queries are const and can be run
+     * concurrently, batched versions take an executor from rtl/core/Executor.h.
+     *
+     * Cropping by a hyperrectangle (cropByHyperRect(), fitToHyperRect()) is a batched Liang-Barsky clipping with compacted output, suited for viewport clipping or map tiling.
+     * @tparam dim dimensionality of the segments.
+     * @tparam Element base type of segment coordinates.
+     */
+    template<int dim, typename Element>
+    class LineSegmentArrayND
+    {
+        static_assert(dim > 0, "LineSegmentArrayND must have at least one dimension");
+    public:
+        typedef Element ElementType;                                            //!< Base type of segment coordinates.
+        typedef VectorND<dim, Element> VectorType;                              //!< Type of the points.
+        typedef LineSegmentND<dim, Element> LineSegmentType;                    //!< Type of a single segment of the array.
+        typedef Eigen::Matrix<Element, Eigen::Dynamic, 2 * dim + 1> EigenType;  //!< Type of the underlying Eigen storage.
+        typedef std::pair<size_t, Element> ResultType;                          //!< Index of a segment with its squared distance to the query.
+
+        //! Default constructor. The array contains no segments.
+        LineSegmentArrayND() : int_size(0) {}
+
+        //! Construction from std::vector of line segments.
+        /*!
+         *
+         * @param segments line segments to be copied into the array.
+         */
+        explicit LineSegmentArrayND(const std::vector<LineSegmentType> &segments) : int_size(0)
+        {
+            reserve(segments.size());
+            for (const auto &ls : segments)
+                addSegment(ls);
+        }
+
+        //! Default destructor.
+        ~LineSegmentArrayND() = default;
+
+        //! Number of segments in the array.
+        [[nodiscard]] size_t size() const { return int_size; }
+
+        //! Number of segments the array can hold without reallocation.
+        [[nodiscard]] size_t capacity() const { return int_segments.rows(); }
+
+        //! Tests whether the array contains any segments.
+        [[nodiscard]] bool empty() const { return int_size == 0; }
+
+        //! Removes all segments from the array. Allocated memory is kept for further use.
+        void clear()
+        {
+            int_size = 0;
+            int_indexed = false;
+        }
+
+        //! Ensures the capacity of the array is at least \p cap segments.
+        /*!
+         *
+         * @param cap required capacity.
+         */
+        void reserve(size_t cap)
+        {
+            if (cap > capacity())
+                int_segments.conservativeResize(alignedCount<Element>(cap), Eigen::NoChange);
+        }
+
+        //! Appends a segment at the end of the array.
+        /*!
+         *
+         * @param ls the segment to be added.
+         */
+        void addSegment(const LineSegmentType &ls)
+        {
+            if (int_size == capacity())
+                reserve(int_size == 0 ? 16 : 2 * int_size);
+            setSegment(int_size++, ls);
+        }
+
+        //! Returns a copy of the i-th segment.
+        /*!
+         *
+         * @param i index of the segment of interest.
+         * @return copy of the i-th segment.
+         */
+        LineSegmentType getSegment(size_t i) const
+        {
+            VectorType beg, dir;
+            for (int d = 0; d < dim; d++)
+            {
+                beg[d] = int_segments(i, d);
+                dir[d] = int_segments(i, dim + d);
+            }
+            return LineSegmentType(beg, beg + dir * int_segments(i, 2 * dim), dir);
+        }
+
+        //! Sets the i-th segment.
+        /*!
+         *
+         * @param i index of the segment to be set.
+         * @param ls new value of the segment.
+         */
+        void setSegment(size_t i, const LineSegmentType &ls)
+        {
+            VectorType dir = ls.end() - ls.beg();
+            Element len = dir.length();
+            if (len > 0)
+                dir /= len;
+            for (int d = 0; d < dim; d++)
+            {
+                int_segments(i, d) = ls.beg()[d];
+                int_segments(i, dim + d) = dir[d];
+            }
+            int_segments(i, 2 * dim) = len;
+            int_indexed = false;
+        }
+
+        //! Contiguous array of the \p d -th begin point coordinates of all segments.
+        const Element *begData(size_t d) const { return int_segments.col(d).data(); }
+
+        //! Contiguous array of the \p d -th unit direction coordinates of all segments.
+        const Element *dirData(size_t d) const { return int_segments.col(dim + d).data(); }
+
+        //! Contiguous array of lengths of all segments.
+        const Element *lengthData() const { return int_segments.col(2 * dim).data(); }
+
+        //! Builds a bounding volume hierarchy over the segments for the gated closest-segment queries.
+        /*!
+         *
+         * @param max_leaf maximal number of segments in a leaf of the hierarchy.
+         */
+        void buildIndex(size_t max_leaf = 4)
+        {
+            std::vector<BoundingBoxND<dim, Element>> boxes;
+            std::vector<size_t> ids(int_size);
+            boxes.reserve(int_size);
+            for (size_t i = 0; i < int_size; i++)
+            {
+                LineSegmentType ls = getSegment(i);
+                boxes.emplace_back(ls.beg(), ls.end());
+                ids[i] = i;
+            }
+            int_index.setMaxLeafSize(max_leaf);
+            int_index.build(boxes, ids);
+            int_indexed = true;
+        }
+
+        //! Tests whether the index for the gated queries is built and up to date.
+        [[nodiscard]] bool indexed() const { return int_indexed; }
+
+        //! Squared distances of \p point to all segments.
+        /*!
+         *
+         * @param point the query point.
+         * @param out output vector, resized to size() and filled with the squared distances in the order of the segments.
+         */
+        void distancesSquared(const VectorType &point, std::vector<Element> &out) const
+        {
+            out.resize(int_size);
+            pointKernel(point, 0, int_size, out.data());
+        }
+
+        //! Squared distances of the segment \p ls to all segments.
+        /*!
+         * Distance of two segments is the distance of their closest points, zero for intersecting segments.
+         * @param ls the query segment.
+         * @param out output vector, resized to size() and filled with the squared distances in the order of the segments.
+         */
+        void distancesSquared(const LineSegmentType &ls, std::vector<Element> &out) const
+        {
+            out.resize(int_size);
+            segmentKernel(Query(ls), 0, int_size, out.data());
+        }
+
+        //! The closest segment to \p point.
+        /*!
+         * Scans all segments.
+         * @param point the query point.
+         * @return index of the closest segment and its squared distance, or (size(), infinity) if the array is empty. Ties are resolved by the lower index.
+         */
+        [[nodiscard]] ResultType closestSegment(const VectorType &point) const { return closestScan(point); }
+
+        //! The closest segment to the segment \p ls.
+        /*!
+         * Scans all segments.
+         * @param ls the query segment.
+         * @return index of the closest segment and its squared distance, or (size(), infinity) if the array is empty. Ties are resolved by the lower index.
+         */
+        [[nodiscard]] ResultType closestSegment(const LineSegmentType &ls) const { return closestScan(Query(ls)); }
+
+        //! The closest segment to \p point not further than \p radius.
+        /*!
+         * Uses the index if it is built (see buildIndex()), scans all segments otherwise.
+         * @param point the query point.
+         * @param radius the search radius.
+         * @return index of the closest segment and its squared distance, or (size(), infinity) if there is no segment within \p radius.
+         */
+        [[nodiscard]] ResultType closestSegment(const VectorType &point, Element radius) const { return closestGated(point, BoundingBoxND<dim, Element>(point), radius); }
+
+        //! The closest segment to the segment \p ls not further than \p radius.
+        /*!
+         * Uses the index if it is built (see buildIndex()), scans all segments otherwise.
+         * @param ls the query segment.
+         * @param radius the search radius.
+         * @return index of the closest segment and its squared distance, or (size(), infinity) if there is no segment within \p radius.
+         */
+        [[nodiscard]] ResultType closestSegment(const LineSegmentType &ls, Element radius) const
+        {
+            return closestGated(Query(ls), BoundingBoxND<dim, Element>(ls.beg(), ls.end()), radius);
+        }
+
+        //! Batched closest-segment query for points.
+        /*!
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param points the query points.
+         * @param executor executor used for parallel processing of the queries.
+         * @return results of closestSegment() for all queries.
+         */
+        template<class Executor = SequentialExecutor>
+        [[nodiscard]] std::vector<ResultType> closestSegments(Span<const VectorType> points, Executor executor = Executor()) const
+        {
+            return batch(points, executor, [this](const VectorType &p) { return closestSegment(p); });
+        }
+
+        //! Batched closest-segment query for segments.
+        /*!
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param segments the query segments.
+         * @param executor executor used for parallel processing of the queries.
+         * @return results of closestSegment() for all queries.
+         */
+        template<class Executor = SequentialExecutor>
+        [[nodiscard]] std::vector<ResultType> closestSegments(Span<const LineSegmentType> segments, Executor executor = Executor()) const
+        {
+            return batch(segments, executor, [this](const LineSegmentType &ls) { return closestSegment(ls); });
+        }
+
+        //! Batched gated closest-segment query for points.
+        /*!
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param points the query points.
+         * @param radius the search radius common for all queries.
+         * @param executor executor used for parallel processing of the queries.
+         * @return results of closestSegment() for all queries.
+         */
+        template<class Executor = SequentialExecutor>
+        [[nodiscard]] std::vector<ResultType> closestSegments(Span<const VectorType> points, Element radius, Executor executor = Executor()) const
+        {
+            return batch(points, executor, [this, radius](const VectorType &p) { return closestSegment(p, radius); });
+        }
+
+        //! Batched gated closest-segment query for segments.
+        /*!
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param segments the query segments.
+         * @param radius the search radius common for all queries.
+         * @param executor executor used for parallel processing of the queries.
+         * @return results of closestSegment() for all queries.
+         */
+        template<class Executor = SequentialExecutor>
+        [[nodiscard]] std::vector<ResultType> closestSegments(Span<const LineSegmentType> segments, Element radius, Executor executor = Executor()) const
+        {
+            return batch(segments, executor, [this, radius](const LineSegmentType &ls) { return closestSegment(ls, radius); });
+        }
+
+        //! Crops all segments by a hyperrectangle.
+        /*!
+         * Batched Liang-Barsky clipping: each segment is clipped by the slabs of the hyperrectangle in a branch-free loop and the surviving segments are compacted
+         * into the output vectors in the same pass. Contrary to LineSegmentND::cropByHyperRect(), which crops the line passing through the segment, the parameters
+         * are limited to the segment itself, so the output always lies within [0, length] of the respective segment. Segments touching the hyperrectangle survive with
+         * \p beg_t equal to \p end_t.
+         * @param corner1 specifies one vertex of the hyperrectangle.
+         * @param corner2 specifies the second vertex of the hyperrectangle.
+         * @param indices output vector of indices of the segments intersecting the hyperrectangle in increasing order.
+         * @param beg_t output vector of parameters corresponding to the cropped begin points, the point itself is \a B + \p beg_t \a D.
+         * @param end_t output vector of parameters corresponding to the cropped end points, the point itself is \a B + \p end_t \a D.
+         * @return number of segments intersecting the hyperrectangle.
+         */
+        size_t cropByHyperRect(const VectorType &corner1, const VectorType &corner2, std::vector<size_t> &indices, std::vector<Element> &beg_t, std::vector<Element> &end_t) const
+        {
+            indices.resize(int_size);
+            beg_t.resize(int_size);
+            end_t.resize(int_size);
+            size_t cnt = 0;
+            Element t_in[block_size], t_out[block_size];
+            for (size_t first = 0; first < int_size; first += block_size)
+            {
+                size_t count = std::min(block_size, int_size - first);
+                cropKernel(corner1, corner2, first, count, t_in, t_out);
+                for (size_t i = 0; i < count; i++)
+                {
+                    indices[cnt] = first + i;
+                    beg_t[cnt] = t_in[i];
+                    end_t[cnt] = t_out[i];
+                    cnt += t_in[i] <= t_out[i];
+                }
+            }
+            indices.resize(cnt);
+            beg_t.resize(cnt);
+            end_t.resize(cnt);
+            return cnt;
+        }
+
+        //! Adjusts all segments to fit into a hyperrectangle.
+        /*!
+         * Segments are cropped as in cropByHyperRect(const VectorType &, const VectorType &, std::vector<size_t> &, std::vector<Element> &, std::vector<Element> &) const,
+         * segments not intersecting the hyperrectangle are removed and the remaining ones keep their relative order.
+         * @param corner1 specifies one vertex of the hyperrectangle.
+         * @param corner2 specifies the second vertex of the hyperrectangle.
+         * @return number of remaining segments.
+         */
+        size_t fitToHyperRect(const VectorType &corner1, const VectorType &corner2)
+        {
+            size_t cnt = 0;
+            Element t_in[block_size], t_out[block_size];
+            for (size_t first = 0; first < int_size; first += block_size)
+            {
+                size_t count = std::min(block_size, int_size - first);
+                cropKernel(corner1, corner2, first, count, t_in, t_out);
+                for (size_t i = 0; i < count; i++)
+                {
+                    size_t src = first + i;
+                    for (int d = 0; d < dim; d++)
+                    {
+                        int_segments(cnt, d) = int_segments(src, d) + t_in[i] * int_segments(src, dim + d);
+                        int_segments(cnt, dim + d) = int_segments(src, dim + d);
+                    }
+                    int_segments(cnt, 2 * dim) = t_out[i] - t_in[i];
+                    cnt += t_in[i] <= t_out[i];
+                }
+            }
+            int_size = cnt;
+            int_indexed = false;
+            return cnt;
+        }
+
+        //! Dimensionality of the segments.
+        static constexpr int dimensionality() { return dim; }
+
+    private:
+        //! Segment query with precomputed unit direction and length.
+        struct Query
+        {
+            explicit Query(const LineSegmentType &ls) : beg(ls.beg()), dir(ls.end() - ls.beg()), len(dir.length())
+            {
+                if (len > 0)
+                    dir /= len;
+            }
+
+            VectorType beg, dir;
+            Element len;
+        };
+
+        static constexpr size_t block_size = 64;
+
+        //! Squared distances of \p point to segments [first, first + count), closest points on the segments are clamped branch-free.
+        void pointKernel(const VectorType &point, size_t first, size_t count, Element *out) const
+        {
+            const Element *beg[dim], *dir[dim];
+            for (int d = 0; d < dim; d++)
+            {
+                beg[d] = begData(d) + first;
+                dir[d] = dirData(d) + first;
+            }
+            const Element *len = lengthData() + first;
+            for (size_t i = 0; i < count; i++)
+            {
+                Element t = 0;
+                for (int d = 0; d < dim; d++)
+                    t += (point[d] - beg[d][i]) * dir[d][i];
+                t = t > 0 ? t : Element(0);
+                t = t < len[i] ? t : len[i];
+                Element dist = 0;
+                for (int d = 0; d < dim; d++)
+                {
+                    Element diff = beg[d][i] + t * dir[d][i] - point[d];
+                    dist += diff * diff;
+                }
+                out[i] = dist;
+            }
+        }
+
+        //! Squared distances of the query segment to segments [first, first + count).
+        /*!
+         * Closest points of two segments with unit directions, after Ericson, Real-Time Collision Detection, 5.1.9. Parameters along the segments are clamped and the
+         * special cases (parallel segments, clamped query parameter) are resolved by selects, so the loop stays branch-free.
+         */
+        void segmentKernel(const Query &q, size_t first, size_t count, Element *out) const
+        {
+            const Element *beg[dim], *dir[dim];
+            for (int d = 0; d < dim; d++)
+            {
+                beg[d] = begData(d) + first;
+                dir[d] = dirData(d) + first;
+            }
+            const Element *len = lengthData() + first;
+            const Element parallel_eps = std::numeric_limits<Element>::epsilon() * 16;
+            for (size_t i = 0; i < count; i++)
+            {
+                Element b = 0, c = 0, f = 0;
+                for (int d = 0; d < dim; d++)
+                {
+                    Element r = beg[d][i] - q.beg[d];
+                    b += dir[d][i] * q.dir[d];
+                    c += dir[d][i] * r;
+                    f += q.dir[d] * r;
+                }
+                Element denom = 1 - b * b;
+                bool skew = denom > parallel_eps;
+                Element safe_denom = skew ? denom : Element(1);
+                Element s = (b * f - c) / safe_denom;
+                s = skew ? s : Element(0);
+                s = s > 0 ? s : Element(0);
+                s = s < len[i] ? s : len[i];
+                Element t = b * s + f;
+                Element t_clamped = t > 0 ? t : Element(0);
+                t_clamped = t_clamped < q.len ? t_clamped : q.len;
+                Element s_back = b * t_clamped - c;
+                s_back = s_back > 0 ? s_back : Element(0);
+                s_back = s_back < len[i] ? s_back : len[i];
+                s = t == t_clamped ? s : s_back;
+                Element dist = 0;
+                for (int d = 0; d < dim; d++)
+                {
+                    Element diff = beg[d][i] + s * dir[d][i] - q.beg[d] - t_clamped * q.dir[d];
+                    dist += diff * diff;
+                }
+                out[i] = dist;
+            }
+        }
+
+        //! Liang-Barsky parameters of segments [first, first + count) cropped by the hyperrectangle, the segment misses it if \p t_in > \p t_out.
+        void cropKernel(const VectorType &corner1, const VectorType &corner2, size_t first, size_t count, Element *t_in, Element *t_out) const
+        {
+            const Element *beg[dim], *dir[dim];
+            Element lo[dim], hi[dim];
+            for (int d = 0; d < dim; d++)
+            {
+                beg[d] = begData(d) + first;
+                dir[d] = dirData(d) + first;
+                lo[d] = std::min(corner1[d], corner2[d]);
+                hi[d] = std::max(corner1[d], corner2[d]);
+            }
+            const Element *len = lengthData() + first;
+            const Element lowest = std::numeric_limits<Element>::lowest(), highest = std::numeric_limits<Element>::max();
+            for (size_t i = 0; i < count; i++)
+            {
+                Element in = 0, out = len[i];
+                for (int d = 0; d < dim; d++)
+                {
+                    // slabs parallel to the segment either do not constrain it, or reject it completely
+                    bool parallel = dir[d][i] == 0;
+                    bool inside = (beg[d][i] >= lo[d]) & (beg[d][i] <= hi[d]);
+                    Element safe_dir = parallel ? Element(1) : dir[d][i];
+                    Element t1 = (lo[d] - beg[d][i]) / safe_dir, t2 = (hi[d] - beg[d][i]) / safe_dir;
+                    Element enter = parallel ? (inside ? lowest : highest) : (t1 < t2 ? t1 : t2);
+                    Element leave = parallel ? (inside ? highest : lowest) : (t1 < t2 ? t2 : t1);
+                    in = in > enter ? in : enter;
+                    out = out < leave ? out : leave;
+                }
+                t_in[i] = in;
+                t_out[i] = out;
+            }
+        }
+
+        void kernel(const VectorType &point, size_t first, size_t count, Element *out) const { pointKernel(point, first, count, out); }
+
+        void kernel(const Query &q, size_t first, size_t count, Element *out) const { segmentKernel(q, first, count, out); }
+
+        template<class T, class Executor, class Func>
+        static std::vector<ResultType> batch(Span<const T> queries, Executor &executor, Func &&func)
+        {
+            std::vector<ResultType> ret(queries.size());
+            executor(0, queries.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                    ret[i] = func(queries[i]);
+            });
+            return ret;
+        }
+
+        template<class Q>
+        ResultType closestScan(const Q &q) const
+        {
+            ResultType best(int_size, std::numeric_limits<Element>::infinity());
+            Element dists[block_size];
+            for (size_t first = 0; first < int_size; first += block_size)
+            {
+                size_t count = std::min(block_size, int_size - first);
+                kernel(q, first, count, dists);
+                for (size_t i = 0; i < count; i++)
+                    if (dists[i] < best.second)
+                        best = ResultType(first + i, dists[i]);
+            }
+            return best;
+        }
+
+        template<class Q>
+        ResultType closestGated(const Q &q, BoundingBoxND<dim, Element> box, Element radius) const
+        {
+            ResultType best(int_size, std::numeric_limits<Element>::infinity());
+            const Element radius_sq = radius * radius;
+            if (!int_indexed)
+            {
+                best = closestScan(q);
+                return best.second <= radius_sq ? best : ResultType(int_size, std::numeric_limits<Element>::infinity());
+            }
+            box = BoundingBoxND<dim, Element>(box.min() - VectorType::ones() * radius, box.max() + VectorType::ones() * radius);
+            int_index.overlapping(box, [&](size_t i) {
+                Element dist;
+                kernel(q, i, 1, &dist);
+                if (dist <= radius_sq && (dist < best.second || (dist == best.second && i < best.first)))
+                    best = ResultType(i, dist);
+            });
+            return best;
+        }
+
+        EigenType int_segments;
+        size_t int_size;
+        BoundingVolumeHierarchyND<dim, Element> int_index;
+        bool int_indexed = false;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_LINESEGMENTARRAYND_H
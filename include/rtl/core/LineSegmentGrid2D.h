@@ -0,0 +1,328 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_LINESEGMENTGRID2D_H
+#define ROBOTICTEMPLATELIBRARY_LINESEGMENTGRID2D_H
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+#include "rtl/core/VectorND.h"
+#include "rtl/core/LineSegmentND.h"
+#include "rtl/core/SmallVector.h"
+#include "rtl/core/Executor.h"
+
+namespace rtl
+{
+    //! Uniform grid spatial index over a set of 2D line segments.
+    /*!
+     * The grid covers the bounding box of all segments with square cells. Each segment is registered in the cells its bounding box overlaps and which
+     * LineSegmentND::cropByHyperRect() confirms to be actually crossed, so long diagonal segments do not fill whole rectangles of cells. Cell contents are stored
+     * in a compressed sparse row layout and the buffers are kept between builds, so rebuilding the index after a map update allocates nothing once the
+     * buffers have grown and takes time proportional to the number of occupied cells.
+     *
+     * Queries are const and can be run concurrently, batched versions of the queries take an executor from rtl/core/Executor.h. Segments are identified by their
+     * index in the build() input.
+     * @tparam Element base type of the segment coordinates.
+     */
+    template<typename Element>
+    class LineSegmentGrid2D
+    {
+    public:
+        typedef Element ElementType;                        //!< Base data type.
+        typedef VectorND<2, Element> VectorType;            //!< Vector type of the query interface.
+        typedef LineSegmentND<2, Element> LineSegmentType;  //!< Type of the indexed line segments.
+
+        //! Default constructor, creates an empty index.
+        LineSegmentGrid2D() = default;
+
+        //! Construction from line segments, see build().
+        explicit LineSegmentGrid2D(const std::vector<LineSegmentType> &segments, Element cell_size = 0) { build(segments, cell_size); }
+
+        //! Builds the index from scratch.
+        /*!
+         * If \p cell_size is not positive, the mean length of the segments is used. The cell size is enlarged if the grid would have more than four cells per
+         * segment (at least 1024 cells are always permitted).
+         * @param segments line segments to be indexed.
+         * @param cell_size length of the side of a cell.
+         */
+        void build(const std::vector<LineSegmentType> &segments, Element cell_size = 0)
+        {
+            segs = segments;
+            cells_x = cells_y = 0;
+            cell_offsets.assign(1, 0);
+            cell_items.clear();
+            if (segs.empty())
+                return;
+
+            VectorType b_min = segs.front().beg(), b_max = b_min;
+            Element length_sum = 0;
+            for (const auto &s : segs)
+            {
+                for (size_t i = 0; i < 2; i++)
+                {
+                    b_min[i] = std::min({b_min[i], s.beg()[i], s.end()[i]});
+                    b_max[i] = std::max({b_max[i], s.beg()[i], s.end()[i]});
+                }
+                length_sum += s.length();
+            }
+            if (!(cell_size > 0))
+                cell_size = length_sum / (Element)segs.size();
+            Element extent_x = b_max[0] - b_min[0], extent_y = b_max[1] - b_min[1];
+            Element max_cells = (Element)std::max<size_t>(4 * segs.size(), 1024);
+            if (!(cell_size > 0))
+                cell_size = std::max({extent_x, extent_y, Element(1)});
+            if ((extent_x / cell_size + 1) * (extent_y / cell_size + 1) > max_cells)
+                cell_size = std::max(extent_x, extent_y) / (std::sqrt(max_cells) - 1);
+            cell = cell_size;
+            origin = b_min;
+            cells_x = (size_t)(extent_x / cell) + 1;
+            cells_y = (size_t)(extent_y / cell) + 1;
+
+            // (cell, segment) pairs are sorted by the cell index by a counting sort
+            pairs.clear();
+            for (size_t k = 0; k < segs.size(); k++)
+            {
+                const auto &s = segs[k];
+                size_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+                cellRange(VectorType(std::min(s.beg().x(), s.end().x()), std::min(s.beg().y(), s.end().y())),
+                          VectorType(std::max(s.beg().x(), s.end().x()), std::max(s.beg().y(), s.end().y())), x0, y0, x1, y1);
+                const Element length = s.length();
+                for (size_t y = y0; y <= y1; y++)
+                    for (size_t x = x0; x <= x1; x++)
+                    {
+                        Element t_beg, t_end;
+                        VectorType c_min(origin.x() + (Element)x * cell, origin.y() + (Element)y * cell);
+                        VectorType c_max(c_min.x() + cell, c_min.y() + cell);
+                        if ((x0 == x1 && y0 == y1) || (s.cropByHyperRect(c_min, c_max, t_beg, t_end) && t_end >= 0 && t_beg <= length))
+                            pairs.emplace_back(y * cells_x + x, k);
+                    }
+            }
+            cell_offsets.assign(cells_x * cells_y + 1, 0);
+            for (const auto &p : pairs)
+                cell_offsets[p.first + 1]++;
+            for (size_t c = 1; c < cell_offsets.size(); c++)
+                cell_offsets[c] += cell_offsets[c - 1];
+            cell_items.resize(pairs.size());
+            cursor.assign(cell_offsets.begin(), cell_offsets.end() - 1);
+            for (const auto &p : pairs)
+                cell_items[cursor[p.first]++] = p.second;
+        }
+
+        //! Number of indexed segments.
+        [[nodiscard]] size_t size() const { return segs.size(); }
+
+        //! Indexed segments.
+        [[nodiscard]] const std::vector<LineSegmentType> &segments() const { return segs; }
+
+        //! Length of the side of a cell.
+        [[nodiscard]] Element cellSize() const { return cell; }
+
+        //! Number of cells along the x axis.
+        [[nodiscard]] size_t cellsX() const { return cells_x; }
+
+        //! Number of cells along the y axis.
+        [[nodiscard]] size_t cellsY() const { return cells_y; }
+
+        //! Invokes \p func for each segment closer than \p radius to \p pt.
+        /*!
+         * @tparam Func type of the invokable object with (size_t index, Element distance_squared) parameters.
+         * @param pt the query point.
+         * @param radius the query radius.
+         * @param func invokable object receiving indices of the segments in ascending order and their squared distances from \p pt.
+         */
+        template<class Func>
+        void inRadius(const VectorType &pt, Element radius, Func &&func) const
+        {
+            if (segs.empty() || !(radius >= 0))
+                return;
+            size_t x0, y0, x1, y1;
+            if (!cellRange(VectorType(pt.x() - radius, pt.y() - radius), VectorType(pt.x() + radius, pt.y() + radius), x0, y0, x1, y1))
+                return;
+            SmallVector<size_t, 64> candidates;
+            for (size_t y = y0; y <= y1; y++)
+                for (size_t c = y * cells_x + x0; c <= y * cells_x + x1; c++)
+                    for (size_t k = cell_offsets[c]; k < cell_offsets[c + 1]; k++)
+                        candidates.push_back(cell_items[k]);
+            std::sort(candidates.begin(), candidates.end());
+            const Element radius2 = radius * radius;
+            for (size_t i = 0; i < candidates.size(); i++)
+            {
+                if (i > 0 && candidates[i] == candidates[i - 1])
+                    continue;
+                Element d2 = segs[candidates[i]].segmentDistanceToPointSquared(pt);
+                if (d2 <= radius2)
+                    func(candidates[i], d2);
+            }
+        }
+
+        //! Indices of all segments closer than \p radius to \p pt in ascending order.
+        [[nodiscard]] std::vector<size_t> inRadius(const VectorType &pt, Element radius) const
+        {
+            std::vector<size_t> ret;
+            inRadius(pt, radius, [&ret](size_t i, Element) { ret.push_back(i); });
+            return ret;
+        }
+
+        //! Batched radius query.
+        /*!
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param pts the query points.
+         * @param radius the query radius common for all points.
+         * @param executor executor used for parallel processing of the queries.
+         * @return pairs of query and segment indices, sorted by both the query and the segment index.
+         */
+        template<class Executor = SequentialExecutor>
+        [[nodiscard]] std::vector<std::pair<size_t, size_t>> inRadius(const std::vector<VectorType> &pts, Element radius, Executor executor = Executor()) const
+        {
+            const size_t chunks = std::max<size_t>(1, std::min(executor.concurrency(), pts.size()));
+            std::vector<std::vector<std::pair<size_t, size_t>>> partial(chunks);
+            executor(0, chunks, [&](size_t c_begin, size_t c_end) {
+                for (size_t c = c_begin; c < c_end; c++)
+                    for (size_t q = pts.size() * c / chunks; q < pts.size() * (c + 1) / chunks; q++)
+                        inRadius(pts[q], radius, [&partial, c, q](size_t i, Element) { partial[c].emplace_back(q, i); });
+            });
+
+            std::vector<std::pair<size_t, size_t>> ret;
+            for (const auto &p : partial)
+                ret.insert(ret.end(), p.begin(), p.end());
+            return ret;
+        }
+
+        //! The segment nearest to \p pt.
+        /*!
+         * Cells are searched in square rings around the cell of \p pt and the search stops once the rings are farther than the best segment found so far.
+         * Segments registered in several cells of the same ring are evaluated repeatedly, which is cheaper than their deduplication.
+         * @param pt the query point.
+         * @param max_distance upper bound of the distance of the segment.
+         * @return index of the nearest segment and its distance from \p pt, or (size(), \p max_distance) if no segment is closer than \p max_distance.
+         * Ties are resolved in favour of the lower index.
+         */
+        [[nodiscard]] std::pair<size_t, Element> nearest(const VectorType &pt, Element max_distance = std::numeric_limits<Element>::infinity()) const
+        {
+            std::pair<size_t, Element> best(segs.size(), max_distance);
+            if (segs.empty())
+                return best;
+            Element best_d2 = max_distance * max_distance;
+            const Element fx = std::floor((pt.x() - origin.x()) / cell), fy = std::floor((pt.y() - origin.y()) / cell);
+            if (!std::isfinite(fx) || !std::isfinite(fy))
+                return best;
+
+            // the rings start at the first one touching the grid and end at the last one touching it
+            const long long cx = (long long)std::clamp(fx, Element(-1e15), Element(1e15)), cy = (long long)std::clamp(fy, Element(-1e15), Element(1e15));
+            const long long last_x = (long long)cells_x - 1, last_y = (long long)cells_y - 1;
+            const long long first_ring = std::max({-cx, cx - last_x, -cy, cy - last_y, 0LL});
+            const long long last_ring = std::max({cx, last_x - cx, cy, last_y - cy});
+            auto visit = [&](long long x, long long y) {
+                const size_t c = (size_t)y * cells_x + (size_t)x;
+                for (size_t k = cell_offsets[c]; k < cell_offsets[c + 1]; k++)
+                {
+                    size_t i = cell_items[k];
+                    Element d2 = segs[i].segmentDistanceToPointSquared(pt);
+                    if (d2 < best_d2 || (d2 == best_d2 && i < best.first))
+                    {
+                        best_d2 = d2;
+                        best.first = i;
+                    }
+                }
+            };
+            for (long long ring = first_ring; ring <= last_ring; ring++)
+            {
+                // every point of a cell in the ring is at least (ring - 1) cells away from pt
+                const Element gap = (Element)std::max(ring - 1, 0LL) * cell;
+                if (gap * gap > best_d2)
+                    break;
+                const long long x_lo = std::max(cx - ring, 0LL), x_hi = std::min(cx + ring, last_x);
+                const long long y_lo = std::max(cy - ring, 0LL), y_hi = std::min(cy + ring, last_y);
+                for (long long y = y_lo; y <= y_hi; y++)
+                {
+                    if (y == cy - ring || y == cy + ring)
+                    {
+                        for (long long x = x_lo; x <= x_hi; x++)
+                            visit(x, y);
+                        continue;
+                    }
+                    if (cx - ring >= 0 && cx - ring <= last_x)
+                        visit(cx - ring, y);
+                    if (ring > 0 && cx + ring >= 0 && cx + ring <= last_x)
+                        visit(cx + ring, y);
+                }
+            }
+            if (best.first < segs.size())
+                best.second = std::sqrt(best_d2);
+            return best;
+        }
+
+        //! Batched nearest segment query.
+        /*!
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param pts the query points.
+         * @param max_distance upper bound of the distance common for all points.
+         * @param executor executor used for parallel processing of the queries.
+         * @return results of nearest() for all points.
+         */
+        template<class Executor = SequentialExecutor>
+        [[nodiscard]] std::vector<std::pair<size_t, Element>> nearest(const std::vector<VectorType> &pts, Element max_distance = std::numeric_limits<Element>::infinity(),
+                                                                     Executor executor = Executor()) const
+        {
+            std::vector<std::pair<size_t, Element>> ret(pts.size());
+            executor(0, pts.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                    ret[i] = nearest(pts[i], max_distance);
+            });
+            return ret;
+        }
+
+    private:
+        //! Range of cells overlapping the box given by \p b_min and \p b_max, false if it misses the grid.
+        bool cellRange(const VectorType &b_min, const VectorType &b_max, size_t &x0, size_t &y0, size_t &x1, size_t &y1) const
+        {
+            Element lx = std::floor((b_min.x() - origin.x()) / cell), ly = std::floor((b_min.y() - origin.y()) / cell);
+            Element hx = std::floor((b_max.x() - origin.x()) / cell), hy = std::floor((b_max.y() - origin.y()) / cell);
+            if (!(hx >= 0 && hy >= 0 && lx < (Element)cells_x && ly < (Element)cells_y))
+                return false;
+            x0 = (size_t)std::max(lx, Element(0));
+            y0 = (size_t)std::max(ly, Element(0));
+            x1 = (size_t)std::min(hx, (Element)(cells_x - 1));
+            y1 = (size_t)std::min(hy, (Element)(cells_y - 1));
+            return true;
+        }
+
+        std::vector<LineSegmentType> segs;
+        std::vector<size_t> cell_offsets{0};
+        std::vector<size_t> cell_items;
+        std::vector<std::pair<size_t, size_t>> pairs;
+        std::vector<size_t> cursor;
+        VectorType origin;
+        Element cell{1};
+        size_t cells_x{0}, cells_y{0};
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_LINESEGMENTGRID2D_H
@@ -28,7 +28,9 @@
 #define ROBOTICTEMPLATELIBRARY_LINESEGMENTND_H
 
 #include <limits>
+#include <utility>
 #include "rtl/core/VectorND.h"
+#include "rtl/core/Span.h"
 
 namespace rtl
 {
@@ -135,6 +137,24 @@ namespace rtl
             int_dir.transform(tf.rot());
         }
 
+        //! Transforms a whole collection of line segments in-place.
+        /*!
+         * The transformation is loaded once for the whole collection, end-points are transformed and directions rotated by the in-place kernels of RigidTfND
+         * (see RigidTfND::transformPoints()), so no temporary line segments or vectors are created.
+         * @param segments the line segments to be transformed.
+         * @param tf the transformation to be applied.
+         */
+        static void transform(Span<ChildType> segments, const RigidTfND<dimensions, Element> &tf)
+        {
+            for (auto &s : segments)
+            {
+                LineSegmentND_common &ls = s;
+                tf.transformPoints(Span<VectorType>(&ls.int_beg, 1));
+                tf.transformPoints(Span<VectorType>(&ls.int_end, 1));
+                tf.rotateVectors(Span<VectorType>(&ls.int_dir, 1));
+            }
+        }
+
         //! Returns begin-point of the line segment.
         /*!
          *
@@ -172,7 +192,7 @@ namespace rtl
         typename VectorType::DistanceType distanceToPoint(const VectorType &point) const
         {
             VectorType dif = int_beg - point;
-            return (dif - (dif.dot(int_dir) * int_dir)).length();
+            return (lazy(dif) - lazy(int_dir) * dif.dot(int_dir)).length();
         }
 
         //! Returns the shortest squared Euclidean distance to given point.
@@ -183,7 +203,24 @@ namespace rtl
         typename VectorType::DistanceType distanceToPointSquared(const VectorType &point) const
         {
             VectorType dif = int_beg - point;
-            return (dif - (dif.dot(int_dir) * int_dir)).lengthSquared();
+            return (lazy(dif) - lazy(int_dir) * dif.dot(int_dir)).lengthSquared();
+        }
+
+        //! Returns the shortest squared Euclidean distance between given point and the line segment itself.
+        /*!
+         * Unlike distanceToPointSquared(), which measures the distance from the supporting line, the projection of \p point is clamped to the end points.
+         * @param point point of interest.
+         * @return the shortest squared Euclidean distance between \p point and the line segment.
+         */
+        typename VectorType::DistanceType segmentDistanceToPointSquared(const VectorType &point) const
+        {
+            VectorType dif = point - int_beg;
+            auto t = dif.dot(int_dir);
+            if (!(t > 0))   // also degenerate segments with undefined direction
+                return dif.lengthSquared();
+            if (t >= length())
+                return (point - int_end).lengthSquared();
+            return (lazy(dif) - lazy(int_dir) * t).lengthSquared();
         }
 
         //! Length of the line segment.
@@ -212,7 +249,7 @@ namespace rtl
          * New begin point corresponds to \a B + \p t (\a E - \a B).
          * @param t the multiplier.
          */
-        void moveBegin(Element t) { int_beg = int_beg + t * (int_end - int_beg); }
+        void moveBegin(Element t) { int_beg = lazy(int_beg) + (lazy(int_end) - int_beg) * t; }
 
         //! Set end point.
         /*!
@@ -230,14 +267,12 @@ namespace rtl
          * New end point corresponds to \a B + \p t (\a E - \a B).
          * @param t the multiplier.
          */
-        void moveEnd(Element t) { int_end = int_beg + t * (int_end - int_beg); }
+        void moveEnd(Element t) { int_end = lazy(int_beg) + (lazy(int_end) - int_beg) * t; }
 
         //! Swap endpoints of the line segment and reverse its direction.
         void swapEndpoints()
         {
-            VectorType tmp = int_beg;
-            int_beg = int_end;
-            int_end = tmp;
+            std::swap(int_beg, int_end);
             int_dir = -int_dir;
         }
 
@@ -271,7 +306,7 @@ namespace rtl
          */
         VectorType vectorProjection(const VectorType &point) const
         {
-            return int_beg + scalarProjectionUnit(point) * int_dir;
+            return lazy(int_beg) + lazy(int_dir) * scalarProjectionUnit(point);
         }
 
         //! Finds the closest point to another line segment.
@@ -409,8 +444,8 @@ namespace rtl
             bool ret = cropByHyperRect(corner1, corner2, l_beg, l_end);
             if (ret)
             {
-                segment_beg = int_beg + int_dir * l_beg;
-                segment_end = int_beg + int_dir * l_end;
+                segment_beg = lazy(int_beg) + lazy(int_dir) * l_beg;
+                segment_end = lazy(int_beg) + lazy(int_dir) * l_end;
             }
             return ret;
         }
@@ -428,8 +463,8 @@ namespace rtl
             bool ret = cropByHyperRect(corner1, corner2, l_beg, l_end);
             if (ret)
             {
-                int_end = int_beg + int_dir * l_end;
-                int_beg = int_beg + int_dir * l_beg;
+                int_end = lazy(int_beg) + lazy(int_dir) * l_end;
+                int_beg = lazy(int_beg) + lazy(int_dir) * l_beg;
             }
             return ret;
         }
@@ -515,7 +550,13 @@ namespace rtl
 
         LineSegmentND_common(const VectorType &beg, const VectorType &end, const VectorType dir) : int_beg{beg}, int_end{end}, int_dir{dir} {}
 
-        LineSegmentND_common(const LineSegmentND_common &ls) : int_beg{ls.int_beg}, int_end{ls.int_end}, int_dir{ls.int_dir} {}
+        LineSegmentND_common(const LineSegmentND_common &ls) = default;
+
+        LineSegmentND_common(LineSegmentND_common &&ls) noexcept = default;
+
+        LineSegmentND_common &operator=(const LineSegmentND_common &ls) = default;
+
+        LineSegmentND_common &operator=(LineSegmentND_common &&ls) noexcept = default;
 
         explicit LineSegmentND_common(const ChildType &ls) : int_beg{ls.int_beg}, int_end{ls.int_end}, int_dir{ls.int_dir} {}
 
@@ -544,7 +585,16 @@ namespace rtl
         LineSegmentND() = default;
 
         //! Copy constructor.
-        LineSegmentND(const LineSegmentND &ls) : LineSegmentND_common<dimensions, Element, LineSegmentND>(ls) {}
+        LineSegmentND(const LineSegmentND &ls) = default;
+
+        //! Move constructor.
+        LineSegmentND(LineSegmentND &&ls) noexcept = default;
+
+        //! Assignment operator.
+        LineSegmentND &operator=(const LineSegmentND &ls) = default;
+
+        //! Move assignment operator.
+        LineSegmentND &operator=(LineSegmentND &&ls) noexcept = default;
 
         //! Construction from two end points.
         /*!
@@ -581,7 +631,16 @@ namespace rtl
         LineSegmentND() = default;
 
         //! Copy constructor.
-        LineSegmentND(const LineSegmentND &ls) : LineSegmentND_common<2, Element, LineSegmentND>(ls) {}
+        LineSegmentND(const LineSegmentND &ls) = default;
+
+        //! Move constructor.
+        LineSegmentND(LineSegmentND &&ls) noexcept = default;
+
+        //! Assignment operator.
+        LineSegmentND &operator=(const LineSegmentND &ls) = default;
+
+        //! Move assignment operator.
+        LineSegmentND &operator=(LineSegmentND &&ls) noexcept = default;
 
         //! Construction from two end points.
         /*!
@@ -767,7 +826,16 @@ namespace rtl
         LineSegmentND() = default;
 
         //! Copy constructor.
-        LineSegmentND(const LineSegmentND<3, Element> &ls) : LineSegmentND_common<3, Element, LineSegmentND>(ls) {}
+        LineSegmentND(const LineSegmentND<3, Element> &ls) = default;
+
+        //! Move constructor.
+        LineSegmentND(LineSegmentND<3, Element> &&ls) noexcept = default;
+
+        //! Assignment operator.
+        LineSegmentND<3, Element> &operator=(const LineSegmentND<3, Element> &ls) = default;
+
+        //! Move assignment operator.
+        LineSegmentND<3, Element> &operator=(LineSegmentND<3, Element> &&ls) noexcept = default;
 
         //! Construction from two end points.
         /*!
@@ -29,6 +29,7 @@
 
 #include <type_traits>
 #include <complex>
+#include <utility>
 
 #include <eigen3/Eigen/Dense>
 #include <eigen3/Eigen/Eigenvalues>
@@ -70,16 +71,19 @@ namespace rtl
         }
 
         //! Copy  constructor.
-        Matrix(const Matrix<rows, cols, Element> &m)
-        {
-            int_matrix = m.int_matrix;
-        }
+        Matrix(const Matrix<rows, cols, Element> &m) = default;
+
+        //! Move constructor.
+        /*!
+         * For dynamic matrices the heap storage of \p m is taken over and \p m is left empty.
+         */
+        Matrix(Matrix<rows, cols, Element> &&m) = default;
 
         //! Construction from the underlying EigenType.
-        explicit Matrix(const EigenType &em)
-        {
-            int_matrix = em;
-        }
+        explicit Matrix(const EigenType &em) : int_matrix(em) {}
+
+        //! Construction from the underlying EigenType taking over its storage.
+        explicit Matrix(EigenType &&em) noexcept : int_matrix(std::move(em)) {}
 
         //! Default destructor.
         ~Matrix() = default;
@@ -215,11 +219,15 @@ namespace rtl
          * @param m the matrix with the data to be copied.
          * @return reference to *this.
          */
-        Matrix<rows, cols, Element> &operator=(const Matrix<rows, cols, Element> &m)
-        {
-            int_matrix = m.int_matrix;
-            return *this;
-        }
+        Matrix<rows, cols, Element> &operator=(const Matrix<rows, cols, Element> &m) = default;
+
+        //! Move assignment operator.
+        /*!
+         * Takes over the content of \p m.
+         * @param m the matrix to be moved from.
+         * @return reference to *this.
+         */
+        Matrix<rows, cols, Element> &operator=(Matrix<rows, cols, Element> &&m) = default;
 
         //! Assignment operator for underlying Eigen type.
         /*!
@@ -233,6 +241,18 @@ namespace rtl
             return *this;
         }
 
+        //! Move assignment operator for underlying Eigen type.
+        /*!
+         * Takes over the content of \p em.
+         * @param em the Eigen matrix to be moved from.
+         * @return reference to *this.
+         */
+        Matrix<rows, cols, Element> &operator=(EigenType &&em) noexcept
+        {
+            int_matrix = std::move(em);
+            return *this;
+        }
+
         //! Equality test operator.
         /*!
          *
@@ -0,0 +1,360 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_PIPELINE_H
+#define ROBOTICTEMPLATELIBRARY_PIPELINE_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <utility>
+#include <memory>
+
+namespace rtl
+{
+    //! Blocking first-in first-out queue with fixed capacity.
+    /*!
+     * The ring buffer is allocated on construction, so pushing and popping allocate nothing. push() blocks while the queue is full, pop() while it is empty. After close()
+     * no more items are accepted and pop() returns false once the remaining items are drained, which lets the consumers terminate.
+     * @tparam T type of the items, cheap to move (e.g. pointers or indices).
+     */
+    template<typename T>
+    class BoundedQueue
+    {
+    public:
+        //! Construction with given capacity.
+        /*!
+         *
+         * @param capacity maximal number of queued items, at least one.
+         */
+        explicit BoundedQueue(size_t capacity) : buffer(std::max<size_t>(capacity, 1)) {}
+
+        //! Appends \p item, blocks while the queue is full.
+        /*!
+         *
+         * @param item the appended item.
+         * @return true if the item was queued, false if the queue is closed.
+         */
+        bool push(T item)
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            not_full.wait(lock, [this]() { return count < buffer.size() || closed; });
+            if (closed)
+                return false;
+            buffer[(head + count) % buffer.size()] = std::move(item);
+            count++;
+            lock.unlock();
+            not_empty.notify_one();
+            return true;
+        }
+
+        //! Removes the oldest item, blocks while the queue is empty and open.
+        /*!
+         *
+         * @param item the removed item.
+         * @return true if an item was removed, false if the queue is closed and empty.
+         */
+        bool pop(T &item)
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            not_empty.wait(lock, [this]() { return count > 0 || closed; });
+            if (count == 0)
+                return false;
+            item = std::move(buffer[head]);
+            head = (head + 1) % buffer.size();
+            count--;
+            lock.unlock();
+            not_full.notify_one();
+            return true;
+        }
+
+        //! Rejects all further items and wakes up all waiting threads.
+        void close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                closed = true;
+            }
+            not_full.notify_all();
+            not_empty.notify_all();
+        }
+
+        //! Maximal number of queued items.
+        [[nodiscard]] size_t capacity() const { return buffer.size(); }
+
+    private:
+        std::mutex mtx;
+        std::condition_variable not_full, not_empty;
+        std::vector<T> buffer;
+        size_t head{0}, count{0};
+        bool closed{false};
+    };
+
+    //! Pipelined processing of a stream of frames by a sequence of stages.
+    /*!
+     * Each stage is a callable taking a reference to the frame and runs in its own thread, so while frame \a N is processed by the second stage (e.g. vectorized),
+     * frame \a N + 1 can be processed by the first one (e.g. segmented). Throughput is thereby limited by the slowest stage instead of the sum of all of them, while the
+     * latency of a frame stays the same, since it still passes the stages one after another and only the hand-over between the threads is added.
+     *
+     * The frames are user-defined structures holding all per-frame buffers (input points, clusters, line segments...). A fixed pool of them is created on construction as
+     * copies of a prototype and the frames circulate through bounded queues between the stages, so no allocation takes place once their buffers have grown. A stage usually
+     * wraps one of the existing functors (CAR_Segmenter, a vectorizer, VectorizerBatch...) and copies its results into the frame, the functor itself is used by a single thread
+     * and keeps its internal buffers between the frames. Frames leave the pipeline in the order they were submitted.
+     *
+     * The producer obtains a free frame by acquire(), fills it and passes it to the stages by submit(), the consumer takes the processed frames by retrieve() and returns them
+     * to the pool by release(). run() does both for a source and sink callable. An exception thrown by a stage is rethrown by retrieve() in place of the failing frame, frames submitted before it
+     * are still completed by all the stages, the following ones pass the pipeline unprocessed.
+     * @tparam Frame type of the processed frames, must be copy-constructible.
+     */
+    template<class Frame>
+    class Pipeline
+    {
+    public:
+        typedef Frame FrameType;                            //!< Type of the processed frames.
+        typedef std::function<void(Frame &)> StageType;     //!< Type of the stages.
+
+        //! Construction with given stages, starts one thread per stage.
+        /*!
+         *
+         * @param stages callables applied to each frame in the given order.
+         * @param frames_in_flight number of frames in the pool, i.e. the maximal number of frames processed or waiting at once, at least one.
+         * @param prototype frame copied to all frames of the pool, e.g. with reserved buffers.
+         */
+        explicit Pipeline(std::vector<StageType> stages, size_t frames_in_flight = 0, const Frame &prototype = Frame())
+                : int_stages(std::move(stages)), free_frames(poolSize(frames_in_flight, int_stages.size()))
+        {
+            size_t frames = free_frames.capacity();
+            pool.assign(frames, prototype);
+            sequence.assign(frames, 0);
+            for (auto &f : pool)
+                free_frames.push(&f);
+            queues.reserve(int_stages.size() + 1);
+            for (size_t s = 0; s <= int_stages.size(); s++)
+                queues.emplace_back(std::make_unique<BoundedQueue<Frame *>>(frames));
+            threads.reserve(int_stages.size());
+            for (size_t s = 0; s < int_stages.size(); s++)
+                threads.emplace_back([this, s]() { stageLoop(s); });
+        }
+
+        Pipeline(const Pipeline &) = delete;
+        Pipeline &operator=(const Pipeline &) = delete;
+
+        //! Closes the pipeline and waits for all stages to finish.
+        ~Pipeline()
+        {
+            close();
+            free_frames.close();
+            for (auto &t : threads)
+                t.join();
+        }
+
+        //! Number of stages.
+        [[nodiscard]] size_t stageCount() const { return int_stages.size(); }
+
+        //! Number of frames in the pool.
+        [[nodiscard]] size_t framesInFlight() const { return pool.size(); }
+
+        //! Obtains a free frame to be filled by the producer, blocks while all frames are in use.
+        /*!
+         *
+         * @return pointer to the frame, nullptr if the pipeline was closed by an error in run().
+         */
+        Frame *acquire()
+        {
+            Frame *frame = nullptr;
+            free_frames.pop(frame);
+            return frame;
+        }
+
+        //! Passes a filled frame to the first stage.
+        /*!
+         * If the pipeline is closed, the frame is returned to the pool.
+         * @param frame pointer obtained by acquire().
+         * @return true if the frame was submitted, false if the pipeline is closed.
+         */
+        bool submit(Frame *frame)
+        {
+            sequence[frame - pool.data()] = next_sequence++;
+            if (queues.front()->push(frame))
+                return true;
+            release(frame);
+            return false;
+        }
+
+        //! Takes the oldest processed frame, blocks until it passes all the stages.
+        /*!
+         * If any stage has thrown an exception, the frame is returned to the pool and the exception is rethrown.
+         * @return pointer to the frame, nullptr if the pipeline is closed and all frames were retrieved.
+         */
+        Frame *retrieve()
+        {
+            Frame *frame = nullptr;
+            if (!queues.back()->pop(frame))
+                return nullptr;
+            std::exception_ptr err;
+            {
+                // frames submitted before the failing one are still valid, the following ones passed the stages unprocessed
+                std::lock_guard<std::mutex> lock(error_mtx);
+                if (error && sequence[frame - pool.data()] >= failed_sequence)
+                    err = error;
+            }
+            if (err)
+            {
+                release(frame);
+                std::rethrow_exception(err);
+            }
+            return frame;
+        }
+
+        //! Returns a retrieved frame to the pool.
+        void release(Frame *frame) { free_frames.push(frame); }
+
+        //! Ends the stream, the submitted frames are still processed and can be retrieved.
+        void close() { queues.front()->close(); }
+
+        //! Processes a whole stream of frames.
+        /*!
+         * The \p source runs in a separate thread and fills frames until it returns false, the \p sink is called in the calling thread for each processed frame
+         * in the order of the source. The pipeline is closed afterwards. Exceptions thrown by the stages or the sink are rethrown after the source has stopped.
+         * @tparam Source callable with bool(Frame &) signature, returns false at the end of the stream.
+         * @tparam Sink callable with void(Frame &) signature.
+         * @param source producer of the frames.
+         * @param sink consumer of the frames.
+         * @return number of processed frames.
+         */
+        template<class Source, class Sink>
+        size_t run(Source &&source, Sink &&sink)
+        {
+            std::exception_ptr source_error;
+            std::thread producer([this, &source, &source_error]() {
+                try
+                {
+                    Frame *frame;
+                    while ((frame = acquire()) != nullptr)
+                    {
+                        if (!source(*frame))
+                        {
+                            release(frame);
+                            break;
+                        }
+                        if (!submit(frame))
+                            break;
+                    }
+                }
+                catch (...)
+                {
+                    source_error = std::current_exception();
+                }
+                close();
+            });
+
+            size_t processed = 0;
+            try
+            {
+                Frame *frame;
+                while ((frame = retrieve()) != nullptr)
+                {
+                    sink(*frame);
+                    release(frame);
+                    processed++;
+                }
+            }
+            catch (...)
+            {
+                // unblock the producer and drain the stages, so the frames are back in the pool
+                close();
+                free_frames.close();
+                producer.join();
+                Frame *frame;
+                while (queues.back()->pop(frame))
+                    ;
+                throw;
+            }
+            producer.join();
+            if (source_error)
+                std::rethrow_exception(source_error);
+            return processed;
+        }
+
+    private:
+        static size_t poolSize(size_t frames_in_flight, size_t stages)
+        {
+            // one frame per stage keeps all of them busy, one more is filled by the producer meanwhile
+            return frames_in_flight > 0 ? frames_in_flight : stages + 1;
+        }
+
+        void stageLoop(size_t s)
+        {
+            Frame *frame;
+            while (queues[s]->pop(frame))
+            {
+                size_t seq = sequence[frame - pool.data()];
+                bool failed;
+                {
+                    // only frames submitted after the failing one are skipped, the earlier ones are finished
+                    std::lock_guard<std::mutex> lock(error_mtx);
+                    failed = error && seq >= failed_sequence;
+                }
+                if (!failed)
+                {
+                    try
+                    {
+                        int_stages[s](*frame);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(error_mtx);
+                        if (!error || seq < failed_sequence)
+                        {
+                            error = std::current_exception();
+                            failed_sequence = seq;
+                        }
+                    }
+                }
+                queues[s + 1]->push(frame);
+            }
+            queues[s + 1]->close();
+        }
+
+        std::vector<StageType> int_stages;
+        std::vector<Frame> pool;
+        std::vector<size_t> sequence;
+        size_t next_sequence{0};
+        BoundedQueue<Frame *> free_frames;
+        std::vector<std::unique_ptr<BoundedQueue<Frame *>>> queues;
+        std::vector<std::thread> threads;
+        std::mutex error_mtx;
+        std::exception_ptr error;
+        size_t failed_sequence{0};
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_PIPELINE_H
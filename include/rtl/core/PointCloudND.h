@@ -0,0 +1,325 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_POINTCLOUDND_H
+#define ROBOTICTEMPLATELIBRARY_POINTCLOUDND_H
+
+#include <vector>
+#include <eigen3/Eigen/Dense>
+
+#include "rtl/core/AlignedAllocator.h"
+#include "rtl/core/BoundingBoxND.h"
+#include "rtl/core/VectorND.h"
+#include "rtl/core/StridedSpan.h"
+
+namespace rtl
+{
+    template<int, typename>
+    class TranslationND;
+
+    template<int, typename>
+    class RotationND;
+
+    template<int, typename>
+    class RigidTfND;
+
+    //! Structure-of-arrays container for large sets of N-dimensional points.
+    /*!
+     * Points are kept in a single dynamic Eigen matrix with one row per point and one column per coordinate. Since Eigen stores matrices in column-major order, all x
+     * coordinates form one contiguous aligned array, all y coordinates another and so on. Transformations of the whole cloud are therefore evaluated as a single matrix product,
+     * which Eigen fully vectorizes, instead of \p dimensions -strided per-point operations performed on std::vector<VectorND>.
+     *
+     * The storage grows geometrically when points are added one by one, reserve() can be used to prevent reallocations entirely if the final size is known beforehand. The capacity
+     * is padded to a multiple of C_SIMD_ALIGNMENT bytes per coordinate, so every coordinate array starts with the alignment of the whole buffer and its vectorized processing
+     * needs no unaligned head.
+     * @tparam dimensions dimensionality of the points.
+     * @tparam Element base type of point coordinates.
+     */
+    template<int dimensions, typename Element>
+    class PointCloudND
+    {
+        static_assert(dimensions > 0, "PointCloudND must have at least one dimension");
+    public:
+        typedef Element ElementType;                                            //!< Base type of point coordinates.
+        typedef VectorND<dimensions, Element> VectorType;                       //!< Type of a single point of the cloud.
+        typedef Eigen::Matrix<Element, Eigen::Dynamic, dimensions> EigenType;   //!< Type of the underlying Eigen storage.
+
+        //! Default constructor. The cloud contains no points.
+        PointCloudND() : int_size(0) {}
+
+        //! Construction of a cloud with \p size uninitialized points.
+        /*!
+         *
+         * @param size number of points.
+         */
+        explicit PointCloudND(size_t size) : int_points(alignedCount<Element>(size), dimensions), int_size(size) {}
+
+        //! Construction from std::vector of points.
+        /*!
+         *
+         * @param pts points to be copied into the cloud.
+         */
+        explicit PointCloudND(const std::vector<VectorType> &pts) : int_points(alignedCount<Element>(pts.size()), dimensions), int_size(pts.size())
+        {
+            for (size_t i = 0; i < int_size; i++)
+                int_points.row(i) = pts[i].data().transpose();
+        }
+
+        //! Construction from the underlying Eigen type.
+        /*!
+         *
+         * @param em matrix with one point per row.
+         */
+        explicit PointCloudND(const EigenType &em) : int_points(em), int_size(em.rows()) {}
+
+        //! Default destructor.
+        ~PointCloudND() = default;
+
+        //! Number of points in the cloud.
+        [[nodiscard]] size_t size() const { return int_size; }
+
+        //! Number of points the cloud can hold without reallocation.
+        [[nodiscard]] size_t capacity() const { return int_points.rows(); }
+
+        //! Tests whether the cloud contains any points.
+        [[nodiscard]] bool empty() const { return int_size == 0; }
+
+        //! Removes all points from the cloud. Allocated memory is kept for further use.
+        void clear() { int_size = 0; }
+
+        //! Ensures the capacity of the cloud is at least \p cap points.
+        /*!
+         *
+         * @param cap required capacity.
+         */
+        void reserve(size_t cap)
+        {
+            if (cap > capacity())
+                int_points.conservativeResize(alignedCount<Element>(cap), Eigen::NoChange);
+        }
+
+        //! Changes the number of points in the cloud.
+        /*!
+         * Points retained from the previous size keep their values, new points are uninitialized.
+         * @param size new number of points.
+         */
+        void resize(size_t size)
+        {
+            reserve(size);
+            int_size = size;
+        }
+
+        //! Appends a point at the end of the cloud.
+        /*!
+         *
+         * @param p the point to be added.
+         */
+        void addPoint(const VectorType &p)
+        {
+            if (int_size == capacity())
+                reserve(int_size == 0 ? 16 : 2 * int_size);
+            int_points.row(int_size++) = p.data().transpose();
+        }
+
+        //! Appends all points from \p pts at the end of the cloud.
+        /*!
+         *
+         * @param pts the points to be added.
+         */
+        void addPoints(const std::vector<VectorType> &pts)
+        {
+            reserve(int_size + pts.size());
+            for (const auto &p : pts)
+                int_points.row(int_size++) = p.data().transpose();
+        }
+
+        //! Appends all points viewed by \p pts at the end of the cloud.
+        /*!
+         * The points are transposed from the external buffer straight into the coordinate arrays, no intermediate VectorND objects are created.
+         * @param pts view of the points to be added.
+         */
+        void addPoints(StridedSpan<const VectorType> pts)
+        {
+            reserve(int_size + pts.size());
+            int_points.middleRows(int_size, pts.size()) = pts.map().transpose();
+            int_size += pts.size();
+        }
+
+        //! Returns a copy of the i-th point.
+        /*!
+         *
+         * @param i index of the point of interest.
+         * @return copy of the i-th point.
+         */
+        VectorType getPoint(size_t i) const
+        {
+            return VectorType(typename VectorType::EigenType(int_points.row(i).transpose()));
+        }
+
+        //! Sets the i-th point.
+        /*!
+         *
+         * @param i index of the point to be set.
+         * @param p new value of the point.
+         */
+        void setPoint(size_t i, const VectorType &p)
+        {
+            int_points.row(i) = p.data().transpose();
+        }
+
+        //! Reference to the \p d -th coordinate of the \p i -th point.
+        Element &operator()(size_t i, size_t d) { return int_points(i, d); }
+
+        //! Const reference to the \p d -th coordinate of the \p i -th point.
+        const Element &operator()(size_t i, size_t d) const { return int_points(i, d); }
+
+        //! Contiguous array of the \p d -th coordinates of all points.
+        /*!
+         *
+         * @param d index of the coordinate.
+         * @return pointer to the first element of the array of size() elements.
+         */
+        Element *coordData(size_t d) { return int_points.col(d).data(); }
+
+        //! Contiguous read-only array of the \p d -th coordinates of all points.
+        /*!
+         *
+         * @param d index of the coordinate.
+         * @return pointer to the first element of the array of size() elements.
+         */
+        const Element *coordData(size_t d) const { return int_points.col(d).data(); }
+
+        //! Writable Eigen block covering all valid points of the cloud (one per row).
+        auto data() { return int_points.topRows(int_size); }
+
+        //! Read-only Eigen block covering all valid points of the cloud (one per row).
+        auto data() const { return int_points.topRows(int_size); }
+
+        //! Axis aligned bounding box of all points.
+        /*!
+         * Each coordinate array is reduced by a vectorized loop. If the cloud is empty, a std::invalid_argument exception is thrown.
+         * @return the tightest bounding box covering the cloud.
+         */
+        BoundingBoxND<dimensions, Element> boundingBox() const
+        {
+            std::array<const Element *, dimensions> coords;
+            for (size_t d = 0; d < dimensions; d++)
+                coords[d] = coordData(d);
+            return BoundingBoxND<dimensions, Element>(coords, int_size);
+        }
+
+        //! Copies the points into a std::vector.
+        /*!
+         *
+         * @return std::vector of all points in the cloud.
+         */
+        std::vector<VectorType> toVector() const
+        {
+            std::vector<VectorType> ret;
+            ret.reserve(int_size);
+            for (size_t i = 0; i < int_size; i++)
+                ret.emplace_back(typename VectorType::EigenType(int_points.row(i).transpose()));
+            return ret;
+        }
+
+        //! Returns translated copy of the cloud.
+        /*!
+         * @param tr the translation to be applied.
+         * @return new cloud after translation.
+         */
+        PointCloudND<dimensions, Element> transformed(const TranslationND<dimensions, Element> &tr) const
+        {
+            PointCloudND<dimensions, Element> ret(*this);
+            ret.transform(tr);
+            return ret;
+        }
+
+        //! Translates all points of *this cloud in-place.
+        /*!
+         *
+         * @param tr the translation to be applied.
+         */
+        void transform(const TranslationND<dimensions, Element> &tr)
+        {
+            data().rowwise() += tr.trVec().data().transpose();
+        }
+
+        //! Returns rotated copy of the cloud.
+        /*!
+         * @param rot the rotation to be applied.
+         * @return new cloud after rotation.
+         */
+        PointCloudND<dimensions, Element> transformed(const RotationND<dimensions, Element> &rot) const
+        {
+            PointCloudND<dimensions, Element> ret(int_size);
+            ret.data().noalias() = data() * rot.rotMat().data().transpose();
+            return ret;
+        }
+
+        //! Rotates all points of *this cloud in-place.
+        /*!
+         * The rotation is performed as a single matrix product over the whole cloud.
+         * @param rot the rotation to be applied.
+         */
+        void transform(const RotationND<dimensions, Element> &rot)
+        {
+            data() = data() * rot.rotMat().data().transpose();
+        }
+
+        //! Returns copy of the cloud transformed by the rigid transformation \p tf.
+        /*!
+         * @param tf the transformation to be applied.
+         * @return new cloud after transformation.
+         */
+        PointCloudND<dimensions, Element> transformed(const RigidTfND<dimensions, Element> &tf) const
+        {
+            PointCloudND<dimensions, Element> ret(int_size);
+            ret.data().noalias() = data() * tf.rotMat().data().transpose();
+            ret.data().rowwise() += tf.trVec().data().transpose();
+            return ret;
+        }
+
+        //! Transforms all points of *this cloud in-place by the rigid transformation \p tf.
+        /*!
+         * The rotation is performed as a single matrix product over the whole cloud, followed by a vectorized translation of all coordinate arrays.
+         * @param tf the transformation to be applied.
+         */
+        void transform(const RigidTfND<dimensions, Element> &tf)
+        {
+            data() = data() * tf.rotMat().data().transpose();
+            data().rowwise() += tf.trVec().data().transpose();
+        }
+
+        //! Dimensionality of the points in the cloud.
+        static constexpr int dimensionality() { return dimensions; }
+
+    private:
+        EigenType int_points;
+        size_t int_size;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_POINTCLOUDND_H
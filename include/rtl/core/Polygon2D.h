@@ -28,8 +28,14 @@
 #define ROBOTICTEMPLATELIBRARY_POLYGON2D_H
 
 #include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
 
 #include "rtl/core/VectorND.h"
+#include "rtl/core/Span.h"
+#include "rtl/core/Executor.h"
 
 namespace rtl
 {
@@ -44,8 +50,12 @@ namespace rtl
 
     //! Two dimensional polygon class.
     /*!
-     * For now, it only aggregates points in std::vector and makes them available in a unified way with Polygon3D template.
-     * Extensions such as intersection with another polygon etc. are planned in the future.
+     * Aggregates points in std::vector and makes them available in a unified way with Polygon3D template. Besides the transformations, the polygon provides its area,
+     * point-in-polygon tests and clipping by a convex polygon.
+     *
+     * Point-in-polygon tests use the even-odd rule. Without further preparation, each test traverses all edges. For polygons tested against many points, buildIndex()
+     * precomputes an edge table split into horizontal slabs, so a test only traverses the edges overlapping the slab of the query point. The table is kept in
+     * structure-of-arrays layout and the crossing count is branch-free, which allows vectorization of the inner loop. Any modification of the vertices drops the index.
      * @tparam Element base type of underlying data.
      */
     template<typename Element>
@@ -61,6 +71,18 @@ namespace rtl
         //! Default destructor.
         ~Polygon2D() = default;
 
+        //! Copy constructor.
+        Polygon2D(const Polygon2D &) = default;
+
+        //! Move constructor.
+        Polygon2D(Polygon2D &&) = default;
+
+        //! Copy assignment.
+        Polygon2D &operator=(const Polygon2D &) = default;
+
+        //! Move assignment.
+        Polygon2D &operator=(Polygon2D &&) = default;
+
         //! Returns translated copy of the polygon.
         /*!
          * @param tr the translation to be applied.
@@ -83,6 +105,7 @@ namespace rtl
         {
             for (auto &p : int_pts)
                 p.transform(tr);
+            int_slab_offsets.clear();
         }
 
         //! Returns rotated copy of the polygon.
@@ -107,6 +130,7 @@ namespace rtl
         {
             for (auto &p : int_pts)
                 p.transform(rot);
+            int_slab_offsets.clear();
         }
 
         //! Returns transformed copy of the polygon.
@@ -131,6 +155,7 @@ namespace rtl
         {
             for (auto &p : int_pts)
                 p.transform(tf);
+            int_slab_offsets.clear();
         }
 
         //! Read only access to the vertices.
@@ -154,6 +179,24 @@ namespace rtl
         void addPoint(VectorType point)
         {
             int_pts.emplace_back(point);
+            int_slab_offsets.clear();
+        }
+
+        //! Adds another vertex to the buffer.
+        /*!
+         * Same as addPoint(), provided for unified interface with Polygon3D.
+         * @param point the new vertex of the polygon.
+         */
+        void addPointDirect(VectorType point)
+        {
+            addPoint(point);
+        }
+
+        //! Removes all vertices. Allocated memory is kept for further use.
+        void clear()
+        {
+            int_pts.clear();
+            int_slab_offsets.clear();
         }
 
         //! Adds vertices from an iterable object using iterators.
@@ -171,11 +214,218 @@ namespace rtl
                 addPoint(*it);
         }
 
+
+        //! Signed area of the polygon.
+        /*!
+         * The area is positive for counter-clockwise and negative for clockwise order of vertices. For self-intersecting polygons, the areas of the loops are summed
+         * with their respective signs.
+         * @return signed area of the polygon.
+         */
+        [[nodiscard]] ElementType signedArea() const
+        {
+            ElementType a = 0;
+            for (size_t j = int_pts.size() - 1, k = 0; k < int_pts.size(); j = k, k++)
+                a += int_pts[j].x() * int_pts[k].y() - int_pts[k].x() * int_pts[j].y();
+            return a / 2;
+        }
+
+        //! Area of the polygon.
+        [[nodiscard]] ElementType area() const { return std::abs(signedArea()); }
+
+        //! Builds the slab edge table accelerating the point-in-polygon tests.
+        /*!
+         * The bounding box of the polygon is split into \p slabs horizontal slabs of equal height and each slab stores the edges overlapping it.
+         * @param slabs number of slabs. If zero, the square root of the number of vertices is used.
+         */
+        void buildIndex(size_t slabs = 0)
+        {
+            int_slab_offsets.clear();
+            int_edge_y0.clear();
+            int_edge_y1.clear();
+            int_edge_x0.clear();
+            int_edge_slope.clear();
+            if (int_pts.empty())
+                return;
+            if (slabs == 0)
+                slabs = std::max<size_t>(1, (size_t) std::sqrt((double) int_pts.size()));
+
+            int_min = int_max = int_pts.front();
+            for (const auto &p : int_pts)
+                for (int d = 0; d < 2; d++)
+                {
+                    int_min[d] = std::min(int_min[d], p[d]);
+                    int_max[d] = std::max(int_max[d], p[d]);
+                }
+            ElementType height = int_max.y() - int_min.y();
+            int_slab_scale = height > 0 ? (ElementType) slabs / height : ElementType(0);
+
+            // count edges per slab, then fill them in place (counting sort)
+            int_slab_offsets.assign(slabs + 1, 0);
+            for (size_t j = int_pts.size() - 1, k = 0; k < int_pts.size(); j = k, k++)
+            {
+                auto [s0, s1] = slabRange(int_pts[j].y(), int_pts[k].y());
+                for (size_t s = s0; s <= s1; s++)
+                    int_slab_offsets[s + 1]++;
+            }
+            for (size_t s = 0; s < slabs; s++)
+                int_slab_offsets[s + 1] += int_slab_offsets[s];
+            size_t edges = int_slab_offsets.back();
+            int_edge_y0.resize(edges);
+            int_edge_y1.resize(edges);
+            int_edge_x0.resize(edges);
+            int_edge_slope.resize(edges);
+            std::vector<size_t> fill(int_slab_offsets.begin(), int_slab_offsets.end() - 1);
+            for (size_t j = int_pts.size() - 1, k = 0; k < int_pts.size(); j = k, k++)
+            {
+                const VectorType &a = int_pts[j], &b = int_pts[k];
+                ElementType dy = b.y() - a.y();
+                auto [s0, s1] = slabRange(a.y(), b.y());
+                for (size_t s = s0; s <= s1; s++)
+                {
+                    size_t e = fill[s]++;
+                    int_edge_y0[e] = a.y();
+                    int_edge_y1[e] = b.y();
+                    int_edge_x0[e] = a.x();
+                    int_edge_slope[e] = dy != 0 ? (b.x() - a.x()) / dy : ElementType(0);
+                }
+            }
+        }
+
+        //! Tests whether the slab edge table for point-in-polygon tests is built and up to date.
+        [[nodiscard]] bool indexed() const { return !int_slab_offsets.empty(); }
+
+        //! Tests whether \p point lies inside the polygon.
+        /*!
+         * Uses the even-odd rule, points exactly on the boundary may be classified either way. Uses the slab edge table if it is built, see buildIndex().
+         * @param point the point to be tested.
+         * @return true if \p point is inside, false otherwise.
+         */
+        [[nodiscard]] bool contains(const VectorType &point) const
+        {
+            if (!indexed())
+            {
+                bool in = false;
+                for (size_t j = int_pts.size() - 1, k = 0; k < int_pts.size(); j = k, k++)
+                {
+                    const VectorType &a = int_pts[j], &b = int_pts[k];
+                    if ((a.y() > point.y()) != (b.y() > point.y()) && point.x() < a.x() + (point.y() - a.y()) * ((b.x() - a.x()) / (b.y() - a.y())))
+                        in = !in;
+                }
+                return in;
+            }
+            if (point.x() < int_min.x() || point.x() > int_max.x() || point.y() < int_min.y() || point.y() > int_max.y())
+                return false;
+            auto slab = slabRange(point.y(), point.y()).first;
+            size_t crossings = 0;
+            for (size_t e = int_slab_offsets[slab]; e < int_slab_offsets[slab + 1]; e++)
+            {
+                bool straddles = (int_edge_y0[e] > point.y()) != (int_edge_y1[e] > point.y());
+                bool left = point.x() < int_edge_x0[e] + (point.y() - int_edge_y0[e]) * int_edge_slope[e];
+                crossings += straddles & left;
+            }
+            return crossings & 1u;
+        }
+
+        //! Tests which points of \p pts lie inside the polygon.
+        /*!
+         * Runs contains() for all points, so it is worth to build the index (see buildIndex()) beforehand.
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param pts the points to be tested.
+         * @param mask output bitmask with (pts.size() + 63) / 64 words, bits of the inner points are set.
+         * @param executor executor used for parallel processing of the blocks of 64 points.
+         */
+        template<class Executor = SequentialExecutor>
+        void contains(Span<const VectorType> pts, std::vector<uint64_t> &mask, Executor executor = Executor()) const
+        {
+            mask.assign((pts.size() + 63) / 64, 0);
+            executor(0, mask.size(), [&](size_t begin, size_t end) {
+                for (size_t w = begin; w < end; w++)
+                {
+                    uint64_t word = 0;
+                    size_t len = std::min<size_t>(64, pts.size() - w * 64);
+                    for (size_t r = 0; r < len; r++)
+                        word |= uint64_t(contains(pts[w * 64 + r])) << r;
+                    mask[w] = word;
+                }
+            });
+        }
+
+        //! Clips the polygon by a convex polygon.
+        /*!
+         * Sutherland-Hodgman clipping of *this polygon by the edges of \p convex. The vertices of \p convex are expected in counter-clockwise order. The result is
+         * written into \p out. Memory allocated by \p out and \p buffer is reused, so repeated clipping into the same objects does not allocate. If *this polygon is
+         * concave and the intersection consists of several parts, they are connected by degenerate edges running along the edges of \p convex.
+         * @param convex the convex clipping polygon.
+         * @param out output polygon, cleared before clipping.
+         * @param buffer working storage of the intermediate results.
+         */
+        void clip(const Polygon2D<ElementType> &convex, Polygon2D<ElementType> &out, std::vector<VectorType> &buffer) const
+        {
+            out.clear();
+            out.int_pts.insert(out.int_pts.end(), int_pts.begin(), int_pts.end());
+            for (size_t j = convex.int_pts.size() - 1, k = 0; k < convex.int_pts.size() && !out.int_pts.empty(); j = k, k++)
+            {
+                const VectorType &a = convex.int_pts[j], &b = convex.int_pts[k];
+                // inner side of the a-b edge is on the left
+                VectorType n(a.y() - b.y(), b.x() - a.x());
+                ElementType c = n.dot(a);
+                buffer.swap(out.int_pts);
+                clipByHalfPlane(buffer, n, c, out.int_pts);
+            }
+        }
+
+        //! Clips the polygon by a convex polygon.
+        /*!
+         * Convenience version of clip(const Polygon2D<ElementType> &, Polygon2D<ElementType> &, std::vector<VectorType> &) const allocating the working storage.
+         * @param convex the convex clipping polygon.
+         * @return the clipped polygon.
+         */
+        [[nodiscard]] Polygon2D<ElementType> clipped(const Polygon2D<ElementType> &convex) const
+        {
+            Polygon2D<ElementType> ret;
+            std::vector<VectorType> buffer;
+            clip(convex, ret, buffer);
+            return ret;
+        }
+
+        //! Sutherland-Hodgman clipping of a closed polyline \p in by the half-plane \p normal . x >= \p c, \p out is overwritten.
+        static void clipByHalfPlane(const std::vector<VectorType> &in, const VectorType &normal, ElementType c, std::vector<VectorType> &out)
+        {
+            out.clear();
+            if (in.empty())
+                return;
+            ElementType d_j = normal.dot(in.back()) - c;
+            for (size_t j = in.size() - 1, k = 0; k < in.size(); j = k, k++)
+            {
+                ElementType d_k = normal.dot(in[k]) - c;
+                if ((d_j >= 0) != (d_k >= 0))
+                    out.emplace_back(in[j] + (in[k] - in[j]) * (d_j / (d_j - d_k)));
+                if (d_k >= 0)
+                    out.emplace_back(in[k]);
+                d_j = d_k;
+            }
+        }
+
         //! Dimensionality of the polygon.
         static constexpr int dimensionality() { return 2; }
 
     private:
+        //! Range of slabs overlapped by the vertical span between \p y0 and \p y1.
+        [[nodiscard]] std::pair<size_t, size_t> slabRange(ElementType y0, ElementType y1) const
+        {
+            auto slab = [this](ElementType y) {
+                ElementType s = std::floor((y - int_min.y()) * int_slab_scale);
+                return (size_t) std::clamp(s, ElementType(0), ElementType(int_slab_offsets.size() - 2));
+            };
+            return {slab(std::min(y0, y1)), slab(std::max(y0, y1))};
+        }
+
         std::vector<VectorType> int_pts;
+
+        VectorType int_min, int_max;
+        ElementType int_slab_scale{};
+        std::vector<size_t> int_slab_offsets;
+        std::vector<ElementType> int_edge_y0, int_edge_y1, int_edge_x0, int_edge_slope;
     };
 }
 
@@ -28,7 +28,14 @@
 #define ROBOTICTEMPLATELIBRARY_POLYGON3D_H
 
 #include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
 #include "rtl/core/VectorND.h"
+#include "rtl/core/Polygon2D.h"
+#include "rtl/core/Span.h"
+#include "rtl/core/Executor.h"
 
 namespace rtl
 {
@@ -43,8 +50,12 @@ namespace rtl
 
     //! Three dimensional polygon class.
     /*!
-     * For now, it aggregates points in std::vector, stores data of the plane in which they lie and allow transformation by Transformation3D.
-     * Extensions such as intersection with another polygon etc. are planned in the future.
+     * Aggregates points in std::vector, stores data of the plane in which they lie and allows transformation by Transformation3D. Besides that, the polygon provides
+     * its area, point-in-polygon tests and clipping by a half-space.
+     *
+     * Point-in-polygon tests are evaluated in the coordinate plane onto which the polygon projects best, i.e. the one orthogonal to the dominant coordinate of
+     * normal(). For repeated tests, buildIndex() caches the projection as a Polygon2D with its slab edge table, see Polygon2D::buildIndex(). Any modification
+     * of the vertices drops the index.
      * @tparam Element base type of underlying data.
      */
     template<typename Element>
@@ -71,6 +82,18 @@ namespace rtl
         //! Default destructor.
         ~Polygon3D() = default;
 
+        //! Copy constructor.
+        Polygon3D(const Polygon3D &) = default;
+
+        //! Move constructor.
+        Polygon3D(Polygon3D &&) = default;
+
+        //! Copy assignment.
+        Polygon3D &operator=(const Polygon3D &) = default;
+
+        //! Move assignment.
+        Polygon3D &operator=(Polygon3D &&) = default;
+
         //! Unit normal vector of the polygon.
         /*!
          *
@@ -140,6 +163,7 @@ namespace rtl
             int_dist += tr.trVec().dot(int_normal);
             for (auto &p : int_pts)
                 p.transform(tr);
+            int_proj.clear();
         }
 
         //! Returns rotated copy of the polygon.
@@ -166,6 +190,7 @@ namespace rtl
             int_normal.transform(rot);
             for (auto &p : int_pts)
                 p.transform(rot);
+            int_proj.clear();
         }
 
         //! Returns transformed copy of the polygon.
@@ -191,9 +216,28 @@ namespace rtl
         void transform(const RigidTfND<3, Element> &tf)
         {
             int_normal.transform(tf.rot());
-            int_dist += tf.tr().dot(int_normal);
+            int_dist += tf.trVec().dot(int_normal);
             for (auto &p : int_pts)
                 p.transform(tf);
+            int_proj.clear();
+        }
+
+        //! Transforms a whole collection of polygons in-place.
+        /*!
+         * The vertex buffer of each polygon is transformed by the in-place kernel of RigidTfND (see RigidTfND::transformPoints()) without any temporary copies,
+         * the normal is rotated by the same kernel and the plane distance is updated from the rotated normal.
+         * @param polygons the polygons to be transformed.
+         * @param tf the transformation to be applied.
+         */
+        static void transform(Span<Polygon3D<ElementType>> polygons, const RigidTfND<3, Element> &tf)
+        {
+            for (auto &poly : polygons)
+            {
+                tf.rotateVectors(Span<VectorType>(&poly.int_normal, 1));
+                poly.int_dist += tf.trVec().dot(poly.int_normal);
+                tf.transformPoints(Span<VectorType>(poly.int_pts));
+                poly.int_proj.clear();
+            }
         }
 
         //! Reservation of the internal storage.
@@ -214,6 +258,7 @@ namespace rtl
         void addPoint(const VectorType &point)
         {
             int_pts.emplace_back(point - (VectorType::scalarProjectionOnUnit(point, int_normal) - int_dist) * int_normal);
+            int_proj.clear();
         }
 
         //! Adds projections of vertices from an iterable object using iterators.
@@ -232,6 +277,57 @@ namespace rtl
                 addPoint(*it);
         }
 
+        //! Adds projections of a contiguous sequence of vertices.
+        /*!
+         * Batch counterpart of addPoint(): the buffer is grown once and the projections are computed by a single loop over the coordinates, which the compiler vectorizes.
+         * @param pts new vertices to be added.
+         */
+        void addPoints(Span<const VectorType> pts)
+        {
+            size_t offset = int_pts.size();
+            int_pts.resize(offset + pts.size());
+            projectPoints(pts, int_pts.data() + offset);
+            int_proj.clear();
+        }
+
+        //! Adds projections of \p pts and reduces the vertices to their convex hull.
+        /*!
+         * The current vertices and the projections of \p pts are replaced by the vertices of their convex hull in the polygon plane, so the interior points of dense
+         * clusters (e.g. the inliers of ApproximationTlsPlane3D::trimConvex()) are not stored at all. The hull is computed by the monotone chain algorithm in the
+         * coordinate plane onto which the polygon projects best, which preserves convexity, and its vertices are ordered counter-clockwise in that projection.
+         * Collinear points on the hull boundary are dropped.
+         * @param pts new points, the hull covers them together with the current vertices.
+         */
+        void addPointsConvexHull(Span<const VectorType> pts)
+        {
+            addPoints(pts);
+            if (int_pts.size() < 3)
+                return;
+            auto [u, v] = projectionAxes();
+            std::sort(int_pts.begin(), int_pts.end(), [u = u, v = v](const VectorType &a, const VectorType &b) { return a[u] < b[u] || (a[u] == b[u] && a[v] < b[v]); });
+            auto turn = [u = u, v = v](const VectorType &o, const VectorType &a, const VectorType &b) {
+                return (a[u] - o[u]) * (b[v] - o[v]) - (a[v] - o[v]) * (b[u] - o[u]);
+            };
+
+            // lower and upper chains are built in place, the hull never has more vertices than the processed prefix
+            std::vector<VectorType> hull(2 * int_pts.size());
+            size_t k = 0;
+            for (size_t i = 0; i < int_pts.size(); i++)
+            {
+                while (k >= 2 && turn(hull[k - 2], hull[k - 1], int_pts[i]) <= 0)
+                    k--;
+                hull[k++] = int_pts[i];
+            }
+            for (size_t i = int_pts.size() - 1, lower = k + 1; i > 0; i--)
+            {
+                while (k >= lower && turn(hull[k - 2], hull[k - 1], int_pts[i - 1]) <= 0)
+                    k--;
+                hull[k++] = int_pts[i - 1];
+            }
+            hull.resize(k - 1);
+            int_pts.swap(hull);
+        }
+
         //! Adds \p point as another vertex to the buffer.
         /*!
          * No checks, whether \p point lies in the polygon plane are performed, so it is possible to make an invalid polygon that way.
@@ -241,6 +337,14 @@ namespace rtl
         void addPointDirect(VectorType point)
         {
             int_pts.emplace_back(point);
+            int_proj.clear();
+        }
+
+        //! Removes all vertices. Allocated memory is kept for further use.
+        void clear()
+        {
+            int_pts.clear();
+            int_proj.clear();
         }
 
         //! Adds vertices from an iterable object using iterators.
@@ -260,13 +364,152 @@ namespace rtl
                 addPointDirect(*it);
         }
 
+        //! Area of the polygon.
+        /*!
+         * For self-intersecting polygons, the areas of the loops are summed with signs given by their orientation.
+         * @return area of the polygon.
+         */
+        [[nodiscard]] ElementType area() const
+        {
+            VectorType sum = VectorType::zeros();
+            for (size_t j = int_pts.size() - 1, k = 0; k < int_pts.size(); j = k, k++)
+                sum += int_pts[j].cross(int_pts[k]);
+            return std::abs(sum.dot(int_normal)) / 2;
+        }
+
+        //! Caches the projection of the polygon with the slab edge table accelerating the point-in-polygon tests.
+        /*!
+         *
+         * @param slabs number of slabs of the edge table, see Polygon2D::buildIndex().
+         */
+        void buildIndex(size_t slabs = 0)
+        {
+            auto [u, v] = projectionAxes();
+            int_proj.clear();
+            int_proj.reservePoints(int_pts.size());
+            for (const auto &p : int_pts)
+                int_proj.addPoint(typename Polygon2D<ElementType>::VectorType(p[u], p[v]));
+            int_proj.buildIndex(slabs);
+        }
+
+        //! Tests whether the cached projection for point-in-polygon tests is built and up to date.
+        [[nodiscard]] bool indexed() const { return int_proj.indexed(); }
+
+        //! Tests whether the orthogonal projection of \p p onto the polygon plane lies inside the polygon.
+        /*!
+         * Uses the even-odd rule, points projected exactly on the boundary may be classified either way. Uses the cached projection if it is built, see buildIndex().
+         * @param p the point to be tested.
+         * @return true if the projection of \p p is inside, false otherwise.
+         */
+        [[nodiscard]] bool contains(const VectorType &p) const
+        {
+            auto [u, v] = projectionAxes();
+            VectorType point = p - (int_normal.dot(p) - int_dist) * int_normal;
+            if (indexed())
+                return int_proj.contains(typename Polygon2D<ElementType>::VectorType(point[u], point[v]));
+            bool in = false;
+            for (size_t j = int_pts.size() - 1, k = 0; k < int_pts.size(); j = k, k++)
+            {
+                const VectorType &a = int_pts[j], &b = int_pts[k];
+                if ((a[v] > point[v]) != (b[v] > point[v]) && point[u] < a[u] + (point[v] - a[v]) * ((b[u] - a[u]) / (b[v] - a[v])))
+                    in = !in;
+            }
+            return in;
+        }
+
+        //! Tests which points of \p pts project inside the polygon.
+        /*!
+         * Runs contains() for all points, so it is worth to build the index (see buildIndex()) beforehand.
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param pts the points to be tested.
+         * @param mask output bitmask with (pts.size() + 63) / 64 words, bits of the inner points are set.
+         * @param executor executor used for parallel processing of the blocks of 64 points.
+         */
+        template<class Executor = SequentialExecutor>
+        void contains(Span<const VectorType> pts, std::vector<uint64_t> &mask, Executor executor = Executor()) const
+        {
+            mask.assign((pts.size() + 63) / 64, 0);
+            executor(0, mask.size(), [&](size_t begin, size_t end) {
+                for (size_t w = begin; w < end; w++)
+                {
+                    uint64_t word = 0;
+                    size_t len = std::min<size_t>(64, pts.size() - w * 64);
+                    for (size_t r = 0; r < len; r++)
+                        word |= uint64_t(contains(pts[w * 64 + r])) << r;
+                    mask[w] = word;
+                }
+            });
+        }
+
+        //! Clips the polygon by a half-space.
+        /*!
+         * Sutherland-Hodgman clipping keeping the part of the polygon where \p normal . x >= \p distance. The result is written into \p out, whose allocated memory
+         * is reused. If *this polygon is concave and the intersection consists of several parts, they are connected by degenerate edges along the bounding plane.
+         * @param normal unit normal of the bounding plane pointing into the kept half-space.
+         * @param distance signed distance of the bounding plane from origin along \p normal.
+         * @param out output polygon, its plane is set to the plane of *this polygon.
+         */
+        void clip(const VectorType &normal, ElementType distance, Polygon3D<ElementType> &out) const
+        {
+            out.int_normal = int_normal;
+            out.int_dist = int_dist;
+            out.clear();
+            if (int_pts.empty())
+                return;
+            ElementType d_j = normal.dot(int_pts.back()) - distance;
+            for (size_t j = int_pts.size() - 1, k = 0; k < int_pts.size(); j = k, k++)
+            {
+                ElementType d_k = normal.dot(int_pts[k]) - distance;
+                if ((d_j >= 0) != (d_k >= 0))
+                    out.int_pts.emplace_back(int_pts[j] + (int_pts[k] - int_pts[j]) * (d_j / (d_j - d_k)));
+                if (d_k >= 0)
+                    out.int_pts.emplace_back(int_pts[k]);
+                d_j = d_k;
+            }
+        }
+
+        //! Splits the polygon by a plane.
+        /*!
+         * Clips the polygon by both half-spaces given by the plane, see clip().
+         * @param normal unit normal of the splitting plane.
+         * @param distance signed distance of the splitting plane from origin along \p normal.
+         * @param above output part of the polygon on the side \p normal points to.
+         * @param under output part of the polygon on the opposite side.
+         */
+        void split(const VectorType &normal, ElementType distance, Polygon3D<ElementType> &above, Polygon3D<ElementType> &under) const
+        {
+            clip(normal, distance, above);
+            clip(-normal, -distance, under);
+        }
+
         //! Dimensionality of the polygon.
         static constexpr int dimensionality() { return 3; }
 
     private:
+        //! Projections of \p pts to the polygon plane written to \p out.
+        void projectPoints(Span<const VectorType> pts, VectorType *out) const
+        {
+            const ElementType nx = int_normal[0], ny = int_normal[1], nz = int_normal[2], dist = int_dist;
+            for (size_t i = 0; i < pts.size(); i++)
+            {
+                const VectorType &p = pts[i];
+                ElementType d = nx * p[0] + ny * p[1] + nz * p[2] - dist;
+                out[i] = VectorType(p[0] - d * nx, p[1] - d * ny, p[2] - d * nz);
+            }
+        }
+
+        //! Coordinates spanning the plane onto which the polygon projects best (the dominant coordinate of the normal is dropped).
+        [[nodiscard]] std::pair<int, int> projectionAxes() const
+        {
+            int m = std::abs(int_normal[0]) > std::abs(int_normal[1]) ? 0 : 1;
+            m = std::abs(int_normal[m]) > std::abs(int_normal[2]) ? m : 2;
+            return {(m + 1) % 3, (m + 2) % 3};
+        }
+
         VectorType int_normal;
         ElementType int_dist{};
         std::vector<VectorType> int_pts;
+        Polygon2D<ElementType> int_proj;
     };
 }
 
@@ -0,0 +1,377 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_QUATERNIONARRAY_H
+#define ROBOTICTEMPLATELIBRARY_QUATERNIONARRAY_H
+
+#include <vector>
+#include <stdexcept>
+#include <eigen3/Eigen/Dense>
+
+#include "rtl/core/AlignedAllocator.h"
+#include "rtl/core/Span.h"
+#include "rtl/core/Quaternion.h"
+#include "rtl/core/PointCloudND.h"
+
+namespace rtl
+{
+    //! Structure-of-arrays container for large sets of quaternions with batch kernels.
+    /*!
+     * Quaternions are kept in a single dynamic Eigen matrix with one row per quaternion and columns \a w, \a x, \a y and \a z in this order. Since Eigen stores matrices in
+     * column-major order, each component forms one contiguous aligned array. All batch operations (composition, rotation of points, normalization and interpolation) are
+     * expressed as coefficient-wise Eigen array expressions over these columns, so they are evaluated with Eigen's SIMD packets instead of one Quaternion object at a time.
+     * This makes the container suitable for trajectory interpolation, IMU pre-integration and similar workloads over thousands of orientations. As in PointCloudND, the capacity is
+     * padded so that all component arrays share the alignment of the buffer.
+     *
+     * Binary operations require both operands to have the same size and throw std::invalid_argument otherwise. Output arguments may alias the inputs.
+     * @tparam Element base type of quaternion components.
+     */
+    template<typename Element>
+    class QuaternionArray
+    {
+    public:
+        typedef Element ElementType;                                    //!< Base type of quaternion components.
+        typedef Quaternion<Element> QuaternionType;                     //!< Type of a single quaternion of the array.
+        typedef Eigen::Matrix<Element, Eigen::Dynamic, 4> EigenType;    //!< Type of the underlying Eigen storage.
+
+        //! Default constructor. The array contains no quaternions.
+        QuaternionArray() : int_size(0) {}
+
+        //! Construction of an array with \p size uninitialized quaternions.
+        /*!
+         *
+         * @param size number of quaternions.
+         */
+        explicit QuaternionArray(size_t size) : int_quats(alignedCount<Element>(size), 4), int_size(size) {}
+
+        //! Construction from std::vector of quaternions.
+        /*!
+         *
+         * @param qs quaternions to be copied into the array.
+         */
+        explicit QuaternionArray(const std::vector<QuaternionType> &qs) : int_quats(alignedCount<Element>(qs.size()), 4), int_size(qs.size())
+        {
+            for (size_t i = 0; i < int_size; i++)
+                setQuaternion(i, qs[i]);
+        }
+
+        //! Default destructor.
+        ~QuaternionArray() = default;
+
+        //! Number of quaternions in the array.
+        [[nodiscard]] size_t size() const { return int_size; }
+
+        //! Number of quaternions the array can hold without reallocation.
+        [[nodiscard]] size_t capacity() const { return int_quats.rows(); }
+
+        //! Tests whether the array contains any quaternions.
+        [[nodiscard]] bool empty() const { return int_size == 0; }
+
+        //! Removes all quaternions from the array. Allocated memory is kept for further use.
+        void clear() { int_size = 0; }
+
+        //! Ensures the capacity of the array is at least \p cap quaternions.
+        /*!
+         *
+         * @param cap required capacity.
+         */
+        void reserve(size_t cap)
+        {
+            if (cap > capacity())
+                int_quats.conservativeResize(alignedCount<Element>(cap), Eigen::NoChange);
+        }
+
+        //! Changes the number of quaternions in the array.
+        /*!
+         * Quaternions retained from the previous size keep their values, new ones are uninitialized.
+         * @param size new number of quaternions.
+         */
+        void resize(size_t size)
+        {
+            reserve(size);
+            int_size = size;
+        }
+
+        //! Appends a quaternion at the end of the array.
+        /*!
+         *
+         * @param q the quaternion to be added.
+         */
+        void addQuaternion(const QuaternionType &q)
+        {
+            if (int_size == capacity())
+                reserve(int_size == 0 ? 16 : 2 * int_size);
+            setQuaternion(int_size++, q);
+        }
+
+        //! Returns a copy of the i-th quaternion.
+        /*!
+         *
+         * @param i index of the quaternion of interest.
+         * @return copy of the i-th quaternion.
+         */
+        QuaternionType getQuaternion(size_t i) const
+        {
+            return QuaternionType(int_quats(i, 0), int_quats(i, 1), int_quats(i, 2), int_quats(i, 3));
+        }
+
+        //! Sets the i-th quaternion.
+        /*!
+         *
+         * @param i index of the quaternion to be set.
+         * @param q new value of the quaternion.
+         */
+        void setQuaternion(size_t i, const QuaternionType &q)
+        {
+            int_quats(i, 0) = q.w();
+            int_quats(i, 1) = q.x();
+            int_quats(i, 2) = q.y();
+            int_quats(i, 3) = q.z();
+        }
+
+        //! Contiguous array of the \p c -th components (0 - \a w, 1 - \a x, 2 - \a y, 3 - \a z) of all quaternions.
+        Element *coeffData(size_t c) { return int_quats.col(c).data(); }
+
+        //! Contiguous read-only array of the \p c -th components (0 - \a w, 1 - \a x, 2 - \a y, 3 - \a z) of all quaternions.
+        const Element *coeffData(size_t c) const { return int_quats.col(c).data(); }
+
+        //! Writable Eigen block covering all valid quaternions of the array (one per row).
+        auto data() { return int_quats.topRows(int_size); }
+
+        //! Read-only Eigen block covering all valid quaternions of the array (one per row).
+        auto data() const { return int_quats.topRows(int_size); }
+
+        //! Copies the quaternions into a std::vector.
+        /*!
+         *
+         * @return std::vector of all quaternions in the array.
+         */
+        std::vector<QuaternionType> toVector() const
+        {
+            std::vector<QuaternionType> ret;
+            ret.reserve(int_size);
+            for (size_t i = 0; i < int_size; i++)
+                ret.push_back(getQuaternion(i));
+            return ret;
+        }
+
+        //! Normalizes all quaternions to a unit length in-place.
+        void normalize()
+        {
+            auto inv_norm = (coeffs(0).square() + coeffs(1).square() + coeffs(2).square() + coeffs(3).square()).rsqrt().eval();
+            data().array().colwise() *= inv_norm;
+        }
+
+        //! Returns a copy of the array with all quaternions normalized to a unit length.
+        [[nodiscard]] QuaternionArray normalized() const
+        {
+            QuaternionArray ret(*this);
+            ret.normalize();
+            return ret;
+        }
+
+        //! Conjugates all quaternions in-place.
+        void conjugate() { data().template rightCols<3>() *= Element(-1); }
+
+        //! Element-wise quaternion multiplication.
+        /*!
+         * Computes the Hamilton product \a out[i] = \p a[i] * \p b[i] for all \a i, i.e. composition of rotations \p b[i] followed by \p a[i].
+         * @param a left operands.
+         * @param b right operands.
+         * @param out products, resized to the size of the operands.
+         */
+        static void multiply(const QuaternionArray &a, const QuaternionArray &b, QuaternionArray &out)
+        {
+            checkSizes(a, b);
+            if (&out == &a || &out == &b)
+            {
+                QuaternionArray tmp;
+                multiply(a, b, tmp);
+                out = std::move(tmp);
+                return;
+            }
+            out.resize(a.size());
+            auto aw = a.coeffs(0), ax = a.coeffs(1), ay = a.coeffs(2), az = a.coeffs(3);
+            auto bw = b.coeffs(0), bx = b.coeffs(1), by = b.coeffs(2), bz = b.coeffs(3);
+            out.coeffs(0) = aw * bw - ax * bx - ay * by - az * bz;
+            out.coeffs(1) = aw * bx + ax * bw + ay * bz - az * by;
+            out.coeffs(2) = aw * by - ax * bz + ay * bw + az * bx;
+            out.coeffs(3) = aw * bz + ax * by - ay * bx + az * bw;
+        }
+
+        //! Element-wise quaternion multiplication.
+        /*!
+         *
+         * @param qa right operands.
+         * @return new array of products (*this)[i] * \p qa[i].
+         */
+        QuaternionArray operator*(const QuaternionArray &qa) const
+        {
+            QuaternionArray ret;
+            multiply(*this, qa, ret);
+            return ret;
+        }
+
+        //! Rotates each point of a cloud by the corresponding unit quaternion.
+        /*!
+         * Point \a i of \p in is rotated by the i-th quaternion of *this, which is required to be unit. The rotation is evaluated as \a v' = \a v + \a w \a t + \a q_v x \a t with
+         * \a t = 2 \a q_v x \a v, which needs fewer operations than conversion to rotation matrices. For rotation of a whole cloud by a single quaternion use PointCloudND::transform().
+         * @param in points to be rotated, one per quaternion.
+         * @param out rotated points, resized to the size of *this. May be the same object as \p in.
+         */
+        void rotate(const PointCloudND<3, Element> &in, PointCloudND<3, Element> &out) const
+        {
+            if (in.size() != int_size)
+                throw std::invalid_argument("QuaternionArray::rotate(): number of points does not match the number of quaternions.");
+            out.resize(int_size);
+            auto w = coeffs(0), qx = coeffs(1), qy = coeffs(2), qz = coeffs(3);
+            auto vx = cloudCoeffs(in, 0), vy = cloudCoeffs(in, 1), vz = cloudCoeffs(in, 2);
+            Eigen::Array<Element, Eigen::Dynamic, 1> tx = Element(2) * (qy * vz - qz * vy);
+            Eigen::Array<Element, Eigen::Dynamic, 1> ty = Element(2) * (qz * vx - qx * vz);
+            Eigen::Array<Element, Eigen::Dynamic, 1> tz = Element(2) * (qx * vy - qy * vx);
+            cloudCoeffs(out, 0) = vx + w * tx + qy * tz - qz * ty;
+            cloudCoeffs(out, 1) = vy + w * ty + qz * tx - qx * tz;
+            cloudCoeffs(out, 2) = vz + w * tz + qx * ty - qy * tx;
+        }
+
+        //! Element-wise spherical linear interpolation with a common parameter.
+        /*!
+         * Uniform interpolation between unit quaternions \p a[i] and \p b[i] along the shorter arc. Pairs closer than the numerical precision allows for the spherical formula fall back to
+         * the normalized linear interpolation.
+         * @param a unit quaternions at \p t = 0.
+         * @param b unit quaternions at \p t = 1.
+         * @param t interpolation parameter in the range [0; 1].
+         * @param out interpolated quaternions, resized to the size of the operands.
+         */
+        static void slerp(const QuaternionArray &a, const QuaternionArray &b, Element t, QuaternionArray &out) { slerpImpl(a, b, t, out); }
+
+        //! Element-wise spherical linear interpolation with individual parameters.
+        /*!
+         * Same as the common parameter version, but \p a[i] and \p b[i] are interpolated at \p t[i], e.g. at timestamps of measurements between two trajectory samples.
+         * @param a unit quaternions at \p t = 0.
+         * @param b unit quaternions at \p t = 1.
+         * @param t interpolation parameters in the range [0; 1], one per quaternion.
+         * @param out interpolated quaternions, resized to the size of the operands.
+         */
+        static void slerp(const QuaternionArray &a, const QuaternionArray &b, Span<const Element> t, QuaternionArray &out) { slerpImpl(a, b, params(a, t), out); }
+
+        //! Element-wise normalized linear interpolation with a common parameter.
+        /*!
+         * Fast approximation of slerp(): the quaternions are interpolated linearly along the shorter arc and normalized, which avoids all trigonometric functions. The result lies
+         * on the same great arc as the slerp() result, only the angular speed along the arc is not uniform. For endpoints differing by a rotation of angle \f$\theta \le \pi\f$, the
+         * interpolated rotation differs from the slerp() one by at most \f$\theta^3 / 216\f$ radians (e.g. 5e-7 rad for \f$\theta\f$ = 0.05 rad and 4e-6 rad for \f$\theta\f$ = 0.1 rad),
+         * the error vanishes at \p t = 0, 0.5 and 1. This is negligible for densely sampled trajectories.
+         * @param a unit quaternions at \p t = 0.
+         * @param b unit quaternions at \p t = 1.
+         * @param t interpolation parameter in the range [0; 1].
+         * @param out interpolated quaternions, resized to the size of the operands.
+         */
+        static void nlerp(const QuaternionArray &a, const QuaternionArray &b, Element t, QuaternionArray &out) { nlerpImpl(a, b, t, out); }
+
+        //! Element-wise normalized linear interpolation with individual parameters.
+        /*!
+         * Same as the common parameter version, but \p a[i] and \p b[i] are interpolated at \p t[i]. The error bound is the same as for the common parameter version.
+         * @param a unit quaternions at \p t = 0.
+         * @param b unit quaternions at \p t = 1.
+         * @param t interpolation parameters in the range [0; 1], one per quaternion.
+         * @param out interpolated quaternions, resized to the size of the operands.
+         */
+        static void nlerp(const QuaternionArray &a, const QuaternionArray &b, Span<const Element> t, QuaternionArray &out) { nlerpImpl(a, b, params(a, t), out); }
+
+    private:
+        typedef Eigen::Array<Element, Eigen::Dynamic, 1> ArrayType;
+
+        auto coeffs(Eigen::Index c) { return int_quats.col(c).head(int_size).array(); }
+
+        auto coeffs(Eigen::Index c) const { return int_quats.col(c).head(int_size).array(); }
+
+        static auto cloudCoeffs(PointCloudND<3, Element> &pc, Eigen::Index d) { return Eigen::Map<ArrayType>(pc.coordData(d), pc.size()); }
+
+        static auto cloudCoeffs(const PointCloudND<3, Element> &pc, Eigen::Index d) { return Eigen::Map<const ArrayType>(pc.coordData(d), pc.size()); }
+
+        static void checkSizes(const QuaternionArray &a, const QuaternionArray &b)
+        {
+            if (a.size() != b.size())
+                throw std::invalid_argument("QuaternionArray: operands differ in size.");
+        }
+
+        static Eigen::Map<const ArrayType> params(const QuaternionArray &a, Span<const Element> t)
+        {
+            if (t.size() != a.size())
+                throw std::invalid_argument("QuaternionArray: number of interpolation parameters does not match the number of quaternions.");
+            return Eigen::Map<const ArrayType>(t.data(), t.size());
+        }
+
+        //! Cosines of half angles between \p a[i] and \p b[i] and signs flipping \p b[i] to the shorter arc.
+        static void arcs(const QuaternionArray &a, const QuaternionArray &b, ArrayType &cos_half, ArrayType &sign)
+        {
+            checkSizes(a, b);
+            cos_half = a.coeffs(0) * b.coeffs(0) + a.coeffs(1) * b.coeffs(1) + a.coeffs(2) * b.coeffs(2) + a.coeffs(3) * b.coeffs(3);
+            sign = (cos_half < Element(0)).select(ArrayType::Constant(a.size(), Element(-1)), ArrayType::Constant(a.size(), Element(1)));
+            cos_half = cos_half.abs();
+        }
+
+        //! Writes \a wa[i] * \p a[i] + \a wb[i] * \p b[i] into \p out, weights of \p b are already sign-corrected.
+        static void blend(const QuaternionArray &a, const QuaternionArray &b, const ArrayType &wa, const ArrayType &wb, QuaternionArray &out)
+        {
+            out.resize(a.size());
+            for (Eigen::Index c = 0; c < 4; c++)
+                out.coeffs(c) = wa * a.coeffs(c) + wb * b.coeffs(c);
+        }
+
+        template<class Param>
+        static void slerpImpl(const QuaternionArray &a, const QuaternionArray &b, const Param &t, QuaternionArray &out)
+        {
+            ArrayType cos_half, sign;
+            arcs(a, b, cos_half, sign);
+            ArrayType half = cos_half.min(Element(1)).acos();
+            ArrayType sin_half = (Element(1) - cos_half.square()).max(Element(0)).sqrt();
+            auto linear = cos_half > Element(1) - Eigen::NumTraits<Element>::dummy_precision();
+            ArrayType inv_sin = linear.select(ArrayType::Ones(a.size()), sin_half.inverse());
+            ArrayType wa = linear.select(Element(1) - t, ((Element(1) - t) * half).sin() * inv_sin);
+            ArrayType wb = sign * linear.select(ArrayType::Zero(a.size()) + t, (t * half).sin() * inv_sin);
+            blend(a, b, wa, wb, out);
+            out.normalize();
+        }
+
+        template<class Param>
+        static void nlerpImpl(const QuaternionArray &a, const QuaternionArray &b, const Param &t, QuaternionArray &out)
+        {
+            ArrayType cos_half, sign;
+            arcs(a, b, cos_half, sign);
+            ArrayType wa = ArrayType::Zero(a.size()) + (Element(1) - t);
+            ArrayType wb = sign * t;
+            blend(a, b, wa, wb, out);
+            out.normalize();
+        }
+
+        EigenType int_quats;
+        size_t int_size;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_QUATERNIONARRAY_H
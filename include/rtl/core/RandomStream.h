@@ -0,0 +1,396 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_RANDOMSTREAM_H
+#define ROBOTICTEMPLATELIBRARY_RANDOMSTREAM_H
+
+/*! \file
+ *  \brief Seedable pseudo-random generator with independent streams for parallel RTL algorithms.
+ *
+ *  RandomStreams hands out generators which never overlap in their sequences, one for each worker or each fixed block of work. Given the same seed, every stream
+ *  produces the same numbers regardless of the thread it is used in, parallel randomized computations are therefore both fast and reproducible.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <experimental/type_traits>
+#include <eigen3/Eigen/Dense>
+
+#include "rtl/core/Span.h"
+
+namespace rtl
+{
+    template<size_t lanes>
+    class Xoshiro256PlusPlusBulk;
+
+    //! xoshiro256++ pseudo-random generator by D. Blackman and S. Vigna.
+    /*!
+     * Satisfies the UniformRandomBitGenerator requirements, so it can be used with all standard distributions. The state of 256 bits is initialized from a single
+     * 64-bit seed by splitmix64. The jump() function advances the state by 2^128 steps in constant time, which splits the period into non-overlapping streams.
+     */
+    class Xoshiro256PlusPlus
+    {
+    public:
+        typedef uint64_t result_type;   //!< Type of the generated values.
+
+        //! Construction with given seed.
+        /*!
+         *
+         * @param seed value the whole state is derived from.
+         */
+        explicit Xoshiro256PlusPlus(uint64_t seed = 0) { this->seed(seed); }
+
+        //! Reinitializes the state from given seed.
+        /*!
+         *
+         * @param seed value the whole state is derived from.
+         */
+        void seed(uint64_t seed)
+        {
+            for (auto &s : state)
+            {
+                uint64_t z = (seed += 0x9e3779b97f4a7c15);
+                z = (z ^ (z >> 30u)) * 0xbf58476d1ce4e5b9;
+                z = (z ^ (z >> 27u)) * 0x94d049bb133111eb;
+                s = z ^ (z >> 31u);
+            }
+        }
+
+        //! Smallest generated value.
+        static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+
+        //! Largest generated value.
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        //! Generates next value and advances the state.
+        result_type operator()()
+        {
+            const uint64_t result = rotl(state[0] + state[3], 23) + state[0];
+            const uint64_t t = state[1] << 17u;
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotl(state[3], 45);
+            return result;
+        }
+
+        //! Advances the state by \p z steps.
+        void discard(unsigned long long z)
+        {
+            for (; z > 0; z--)
+                (*this)();
+        }
+
+        //! Advances the state by 2^128 steps, equivalent to as many calls of operator().
+        void jump()
+        {
+            static constexpr uint64_t jump_poly[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+            uint64_t s[4] = {0, 0, 0, 0};
+            for (uint64_t p : jump_poly)
+                for (unsigned b = 0; b < 64; b++)
+                {
+                    if (p & (uint64_t(1) << b))
+                        for (size_t i = 0; i < 4; i++)
+                            s[i] ^= state[i];
+                    (*this)();
+                }
+            for (size_t i = 0; i < 4; i++)
+                state[i] = s[i];
+        }
+
+        //! Two generators are equal if they produce the same sequence.
+        bool operator==(const Xoshiro256PlusPlus &other) const
+        {
+            return state[0] == other.state[0] && state[1] == other.state[1] && state[2] == other.state[2] && state[3] == other.state[3];
+        }
+
+        //! Two generators are not equal if their sequences differ.
+        bool operator!=(const Xoshiro256PlusPlus &other) const { return !(*this == other); }
+
+    private:
+        template<size_t lanes>
+        friend class Xoshiro256PlusPlusBulk;
+
+        static constexpr uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+        uint64_t state[4]{};
+    };
+
+    //! Interleaved lanes of xoshiro256++ generators filling whole arrays of random numbers.
+    /*!
+     * The states of the lanes are stored word by word, so a single step advances all lanes by the same instructions and the loop over the lanes vectorizes.
+     * Too few lanes make the compiler unroll that loop completely instead, the default of 16 lanes keeps it vectorized for both SSE2 and AVX2 targets.
+     * Conversions to floating-point numbers build the mantissa from the upper bits of each value and are free of branches too.
+     * Generating arrays is therefore several times faster than drawing the values one by one through a standard distribution.
+     *
+     * Each lane is seeded by one output of a Xoshiro256PlusPlus, so a bulk generator derived from a stream of RandomStreams is as reproducible as the stream itself.
+     * Values are taken lane by lane in the order of the steps, a request not divisible by the number of lanes discards the rest of the last step.
+     * @tparam lanes number of generators advanced together.
+     */
+    template<size_t lanes = 16>
+    class Xoshiro256PlusPlusBulk
+    {
+        static_assert(lanes > 0, "Xoshiro256PlusPlusBulk requires at least one lane.");
+
+    public:
+        typedef uint64_t result_type;   //!< Type of the generated values.
+
+        //! Construction with given seed.
+        explicit Xoshiro256PlusPlusBulk(uint64_t seed = 0) { this->seed(seed); }
+
+        //! Construction seeded by outputs of \p engine, which is advanced by the number of lanes.
+        explicit Xoshiro256PlusPlusBulk(Xoshiro256PlusPlus &engine) { seed(engine); }
+
+        //! Reinitializes all lanes from given seed.
+        void seed(uint64_t seed)
+        {
+            Xoshiro256PlusPlus engine(seed);
+            this->seed(engine);
+        }
+
+        //! Reinitializes all lanes from outputs of \p engine, which is advanced by the number of lanes.
+        void seed(Xoshiro256PlusPlus &engine)
+        {
+            for (size_t l = 0; l < lanes; l++)
+            {
+                Xoshiro256PlusPlus lane(engine());
+                for (size_t w = 0; w < 4; w++)
+                    state[w][l] = lane.state[w];
+            }
+        }
+
+        //! Number of lanes.
+        static constexpr size_t laneNr() { return lanes; }
+
+        //! Fills \p out with uniformly distributed 64-bit values.
+        void fill(Span<uint64_t> out)
+        {
+            generate(out.size(), [&](size_t i, uint64_t v) { out[i] = v; });
+        }
+
+        //! Fills \p out with values uniformly distributed in [\p min, \p max).
+        /*!
+         * Values are drawn with the full precision of the mantissa of \p T, i.e. 24 bits for float and 52 bits for double.
+         * @tparam T floating point type of the values.
+         * @param out array to be filled.
+         * @param min lower bound of the range.
+         * @param max upper bound of the range.
+         */
+        template<typename T>
+        void uniform(Span<T> out, T min, T max)
+        {
+            static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "Xoshiro256PlusPlusBulk::uniform() supports float and double only.");
+            const T range = max - min;
+            generate(out.size(), [&](size_t i, uint64_t v) { out[i] = min + range * unit<T>(v); });
+        }
+
+        //! Fills \p out with normally distributed values.
+        /*!
+         * Pairs of uniform values are turned to pairs of normal ones by the Box-Muller transform evaluated on Eigen arrays, so the logarithm, square root, sine and
+         * cosine are vectorized as well.
+         * @tparam T floating point type of the values.
+         * @param out array to be filled.
+         * @param mean mean of the distribution.
+         * @param std_dev standard deviation of the distribution.
+         */
+        template<typename T>
+        void normal(Span<T> out, T mean, T std_dev)
+        {
+            static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "Xoshiro256PlusPlusBulk::normal() supports float and double only.");
+            constexpr size_t chunk = 256;
+            T u[2 * chunk];
+            for (size_t beg = 0; beg < out.size(); beg += 2 * chunk)
+            {
+                const size_t n = std::min(2 * chunk, out.size() - beg), pairs = (n + 1) / 2;
+                uniform(Span<T>(u, 2 * pairs), T(0), T(1));
+                Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>> u1(u, (Eigen::Index) pairs), u2(u + pairs, (Eigen::Index) pairs);
+                // 1 - u lies in (0, 1], so the logarithm is finite
+                Eigen::Array<T, Eigen::Dynamic, 1> r = ((T(1) - u1).log() * T(-2)).sqrt() * std_dev, a = u2 * T(2 * 3.14159265358979323846);
+                Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>>(u, (Eigen::Index) pairs) = r * a.cos() + mean;
+                Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>>(u + pairs, (Eigen::Index) pairs) = r * a.sin() + mean;
+                std::copy(u, u + n, out.data() + beg);
+            }
+        }
+
+    private:
+        template<typename T>
+        static T unit(uint64_t v)
+        {
+            // the upper bits form the mantissa of a number in [1, 2)
+            if constexpr (std::is_same_v<T, double>)
+            {
+                uint64_t bits = (v >> 12u) | 0x3ff0000000000000ull;
+                double d;
+                std::memcpy(&d, &bits, sizeof(d));
+                return d - 1.0;
+            }
+            else
+            {
+                uint32_t bits = (uint32_t) (v >> 41u) | 0x3f800000u;
+                float f;
+                std::memcpy(&f, &bits, sizeof(f));
+                return f - 1.0f;
+            }
+        }
+
+        template<typename Store>
+        void generate(size_t n, Store &&store)
+        {
+            // the states are advanced in local copies, which cannot alias the output, so the loops over the lanes vectorize
+            uint64_t s0[lanes], s1[lanes], s2[lanes], s3[lanes], block[lanes];
+            std::copy(state[0], state[0] + lanes, s0);
+            std::copy(state[1], state[1] + lanes, s1);
+            std::copy(state[2], state[2] + lanes, s2);
+            std::copy(state[3], state[3] + lanes, s3);
+            for (size_t i = 0; i < n; i += lanes)
+            {
+                for (size_t l = 0; l < lanes; l++)
+                {
+                    block[l] = Xoshiro256PlusPlus::rotl(s0[l] + s3[l], 23) + s0[l];
+                    const uint64_t t = s1[l] << 17u;
+                    s2[l] ^= s0[l];
+                    s3[l] ^= s1[l];
+                    s1[l] ^= s2[l];
+                    s0[l] ^= s3[l];
+                    s2[l] ^= t;
+                    s3[l] = Xoshiro256PlusPlus::rotl(s3[l], 45);
+                }
+                if (i + lanes <= n)
+                    for (size_t l = 0; l < lanes; l++)
+                        store(i + l, block[l]);
+                else
+                    for (size_t l = 0; l < n - i; l++)
+                        store(i + l, block[l]);
+            }
+            std::copy(s0, s0 + lanes, state[0]);
+            std::copy(s1, s1 + lanes, state[1]);
+            std::copy(s2, s2 + lanes, state[2]);
+            std::copy(s3, s3 + lanes, state[3]);
+        }
+
+        uint64_t state[4][lanes]{};
+    };
+
+    //! Source of independent random streams for parallel workers.
+    /*!
+     * The i-th stream is the generator seeded by the common seed and jumped i times, hence the streams never overlap in the first 2^128 values each.
+     * Streams should be bound to fixed pieces of work (e.g. blocks of particles) rather than to threads, the results then do not depend on the number of threads.
+     */
+    class RandomStreams
+    {
+    public:
+        typedef Xoshiro256PlusPlus EngineType;      //!< Type of the generator of a single stream.
+
+        //! Construction with a non-deterministic seed.
+        RandomStreams() : RandomStreams(std::random_device{}()) {}
+
+        //! Construction with given seed.
+        /*!
+         *
+         * @param seed common seed of all streams.
+         */
+        explicit RandomStreams(uint64_t seed) : base(seed) {}
+
+        //! Sets a new common seed of all streams.
+        /*!
+         *
+         * @param seed common seed of all streams.
+         */
+        void seed(uint64_t seed) { base.seed(seed); }
+
+        //! Returns the generator of the \p index -th stream.
+        /*!
+         * Cost is linear in \p index, use streams() to obtain many consecutive streams at once.
+         * @param index index of the stream.
+         * @return independent generator.
+         */
+        [[nodiscard]] EngineType stream(size_t index) const
+        {
+            EngineType e = base;
+            for (size_t i = 0; i < index; i++)
+                e.jump();
+            return e;
+        }
+
+        //! Fills \p out with generators of the first \p n streams.
+        /*!
+         *
+         * @param n number of streams.
+         * @param out container of the generators, resized to \p n.
+         */
+        void streams(size_t n, std::vector<EngineType> &out) const
+        {
+            out.clear();
+            out.reserve(n);
+            EngineType e = base;
+            for (size_t i = 0; i < n; i++)
+            {
+                out.push_back(e);
+                e.jump();
+            }
+        }
+
+    private:
+        EngineType base;
+    };
+
+    template<typename T, typename Engine>
+    using SeededRandomResult = decltype(T::random(std::declval<Engine &>()));
+
+    //! Tests whether type \p T provides static random(Engine &) generating a random instance from the given generator.
+    template<typename T, typename Engine>
+    constexpr bool has_seeded_random_v = std::experimental::is_detected<SeededRandomResult, T, Engine>::value;
+
+    template<typename T, typename Engine>
+    using BulkRandomResult = decltype(T::random(std::declval<Span<T>>(), std::declval<Engine &>()));
+
+    //! Tests whether type \p T provides static random(Span<T>, Engine &) filling a whole array of random instances from the given generator.
+    template<typename T, typename Engine>
+    constexpr bool has_bulk_random_v = std::experimental::is_detected<BulkRandomResult, T, Engine>::value;
+
+    template<typename T, typename Engine>
+    using SeededMutateResult = decltype(std::declval<T &>().mutate(std::declval<Engine &>()));
+
+    //! Tests whether type \p T provides mutate(Engine &) drawing its randomness from the given generator.
+    template<typename T, typename Engine>
+    constexpr bool has_seeded_mutate_v = std::experimental::is_detected<SeededMutateResult, T, Engine>::value;
+
+    template<typename T>
+    using SeedResult = decltype(std::declval<T &>().seed(std::declval<uint64_t>()));
+
+    //! Tests whether type \p T can be reseeded by seed(uint64_t).
+    template<typename T>
+    constexpr bool has_seed_v = std::experimental::is_detected<SeedResult, T>::value;
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_RANDOMSTREAM_H
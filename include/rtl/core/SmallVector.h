@@ -0,0 +1,357 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_SMALLVECTOR_H
+#define ROBOTICTEMPLATELIBRARY_SMALLVECTOR_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace rtl
+{
+    //! Contiguous sequence container with an inline buffer for the first few elements.
+    /*!
+     * SmallVector behaves as a reduced std::vector, but the first \p N elements are stored directly in the object, so short sequences are created, copied and traversed without
+     * touching the heap. When the inline capacity is exceeded, the elements are moved to a heap buffer growing geometrically. The container is intended for short-lived sequences
+     * of a typical, but not guaranteed, small length, such as transformation chains between nodes of a tree. Elements are properly aligned, including over-aligned Eigen types.
+     * @tparam T type of the elements.
+     * @tparam N number of elements stored inline.
+     */
+    template<typename T, size_t N>
+    class SmallVector
+    {
+        static_assert(N > 0, "SmallVector requires non-zero inline capacity.");
+    public:
+        typedef T value_type;                           //!< Type of the elements.
+        typedef size_t size_type;                       //!< Type for sizes and indices.
+        typedef T& reference;                           //!< Reference to an element.
+        typedef const T& const_reference;               //!< Constant reference to an element.
+        typedef T* iterator;                            //!< Random access iterator.
+        typedef const T* const_iterator;                //!< Constant random access iterator.
+
+        //! Default constructor. The container is empty and no memory is allocated.
+        SmallVector() : int_data(inlineData()), int_size(0), int_capacity(N) {}
+
+        //! Construction of a sequence of copies of \p value.
+        /*!
+         *
+         * @param count number of elements.
+         * @param value value of all elements.
+         */
+        SmallVector(size_t count, const T &value) : SmallVector()
+        {
+            reserve(count);
+            for (size_t i = 0; i < count; i++)
+                push_back(value);
+        }
+
+        //! Construction from an iterator range.
+        /*!
+         *
+         * @tparam InputIt type of the iterators.
+         * @param first first element of the range.
+         * @param last one behind the last element of the range.
+         */
+        template<class InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+        SmallVector(InputIt first, InputIt last) : SmallVector()
+        {
+            if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+                reserve(std::distance(first, last));
+            for (; first != last; ++first)
+                push_back(*first);
+        }
+
+        //! Construction from an initializer list.
+        /*!
+         *
+         * @param il list of the elements.
+         */
+        SmallVector(std::initializer_list<T> il) : SmallVector(il.begin(), il.end()) {}
+
+        //! Copy constructor.
+        /*!
+         *
+         * @param cp container to be copied.
+         */
+        SmallVector(const SmallVector &cp) : SmallVector(cp.begin(), cp.end()) {}
+
+        //! Move constructor.
+        /*!
+         * Heap buffer of \p mv is taken over directly, inline elements are moved one by one. \p mv is left empty.
+         * @param mv container to be moved.
+         */
+        SmallVector(SmallVector &&mv) noexcept : SmallVector()
+        {
+            takeOver(std::move(mv));
+        }
+
+        //! Destructor.
+        ~SmallVector()
+        {
+            clear();
+            releaseHeap();
+        }
+
+        //! Copy-assignment operator.
+        /*!
+         *
+         * @param cp container to be copied.
+         * @return reference to *this.
+         */
+        SmallVector &operator=(const SmallVector &cp)
+        {
+            if (this != &cp)
+            {
+                clear();
+                reserve(cp.size());
+                for (const auto &e : cp)
+                    push_back(e);
+            }
+            return *this;
+        }
+
+        //! Move-assignment operator.
+        /*!
+         *
+         * @param mv container to be moved.
+         * @return reference to *this.
+         */
+        SmallVector &operator=(SmallVector &&mv) noexcept
+        {
+            if (this != &mv)
+            {
+                clear();
+                releaseHeap();
+                takeOver(std::move(mv));
+            }
+            return *this;
+        }
+
+        //! Number of stored elements.
+        [[nodiscard]] size_t size() const { return int_size; }
+
+        //! Number of elements which can be stored without reallocation.
+        [[nodiscard]] size_t capacity() const { return int_capacity; }
+
+        //! Checks for an empty container.
+        [[nodiscard]] bool empty() const { return int_size == 0; }
+
+        //! Checks whether the elements are still kept in the inline buffer.
+        [[nodiscard]] bool isInline() const { return int_data == inlineData(); }
+
+        //! Pointer to the first element.
+        T *data() { return int_data; }
+
+        //! Pointer to the first element.
+        const T *data() const { return int_data; }
+
+        //! Iterator to the first element.
+        iterator begin() { return int_data; }
+
+        //! Iterator to the first element.
+        const_iterator begin() const { return int_data; }
+
+        //! Iterator behind the last element.
+        iterator end() { return int_data + int_size; }
+
+        //! Iterator behind the last element.
+        const_iterator end() const { return int_data + int_size; }
+
+        //! Reference to the first element.
+        T &front() { return int_data[0]; }
+
+        //! Reference to the first element.
+        const T &front() const { return int_data[0]; }
+
+        //! Reference to the last element.
+        T &back() { return int_data[int_size - 1]; }
+
+        //! Reference to the last element.
+        const T &back() const { return int_data[int_size - 1]; }
+
+        //! Unchecked element access.
+        T &operator[](size_t i) { return int_data[i]; }
+
+        //! Unchecked element access.
+        const T &operator[](size_t i) const { return int_data[i]; }
+
+        //! Checked element access.
+        /*!
+         * Throws std::out_of_range if \p i is not a valid index.
+         * @param i index of the element.
+         * @return reference to the element.
+         */
+        T &at(size_t i)
+        {
+            if (i >= int_size)
+                throw std::out_of_range("SmallVector index out of range.");
+            return int_data[i];
+        }
+
+        //! Checked element access.
+        /*!
+         * Throws std::out_of_range if \p i is not a valid index.
+         * @param i index of the element.
+         * @return reference to the element.
+         */
+        const T &at(size_t i) const
+        {
+            if (i >= int_size)
+                throw std::out_of_range("SmallVector index out of range.");
+            return int_data[i];
+        }
+
+        //! Makes sure at least \p new_cap elements can be stored without reallocation.
+        /*!
+         *
+         * @param new_cap required capacity.
+         */
+        void reserve(size_t new_cap)
+        {
+            if (new_cap <= int_capacity)
+                return;
+            T *new_data = allocator().allocate(new_cap);
+            for (size_t i = 0; i < int_size; i++)
+            {
+                ::new(static_cast<void*>(new_data + i)) T(std::move_if_noexcept(int_data[i]));
+                int_data[i].~T();
+            }
+            releaseHeap();
+            int_data = new_data;
+            int_capacity = new_cap;
+        }
+
+        //! Destroys all elements, capacity is kept.
+        void clear()
+        {
+            for (size_t i = 0; i < int_size; i++)
+                int_data[i].~T();
+            int_size = 0;
+        }
+
+        //! Constructs a new element in place behind the last one.
+        /*!
+         *
+         * @tparam Args types of the constructor arguments.
+         * @param args constructor arguments.
+         * @return reference to the new element.
+         */
+        template<typename... Args>
+        T &emplace_back(Args&&... args)
+        {
+            if (int_size == int_capacity)
+            {
+                T tmp(std::forward<Args>(args)...);     // args may refer to an element of *this
+                reserve(2 * int_capacity);
+                ::new(static_cast<void*>(int_data + int_size)) T(std::move(tmp));
+            }
+            else
+                ::new(static_cast<void*>(int_data + int_size)) T(std::forward<Args>(args)...);
+            return int_data[int_size++];
+        }
+
+        //! Appends a copy of \p value.
+        void push_back(const T &value) { emplace_back(value); }
+
+        //! Appends \p value by moving.
+        void push_back(T &&value) { emplace_back(std::move(value)); }
+
+        //! Destroys the last element.
+        void pop_back()
+        {
+            int_data[--int_size].~T();
+        }
+
+        //! Inserts \p value before \p pos.
+        /*!
+         *
+         * @param pos position of the insertion.
+         * @param value inserted value.
+         * @return iterator to the inserted element.
+         */
+        iterator insert(const_iterator pos, T value)
+        {
+            size_t idx = pos - int_data;
+            emplace_back(std::move(value));
+            for (size_t i = int_size - 1; i > idx; i--)
+                std::swap(int_data[i], int_data[i - 1]);
+            return int_data + idx;
+        }
+
+    private:
+        using Allocator = std::allocator<T>;
+
+        static Allocator allocator() { return Allocator(); }
+
+        T *inlineData() { return std::launder(reinterpret_cast<T*>(int_buffer)); }
+
+        const T *inlineData() const { return std::launder(reinterpret_cast<const T*>(int_buffer)); }
+
+        void releaseHeap()
+        {
+            if (!isInline())
+            {
+                allocator().deallocate(int_data, int_capacity);
+                int_data = inlineData();
+                int_capacity = N;
+            }
+        }
+
+        // Expects *this to be empty with the inline buffer active.
+        void takeOver(SmallVector &&mv) noexcept
+        {
+            if (mv.isInline())
+            {
+                for (size_t i = 0; i < mv.int_size; i++)
+                    ::new(static_cast<void*>(int_data + i)) T(std::move(mv.int_data[i]));
+                int_size = mv.int_size;
+                mv.clear();
+            }
+            else
+            {
+                int_data = mv.int_data;
+                int_size = mv.int_size;
+                int_capacity = mv.int_capacity;
+                mv.int_data = mv.inlineData();
+                mv.int_size = 0;
+                mv.int_capacity = N;
+            }
+        }
+
+        alignas(T) unsigned char int_buffer[N * sizeof(T)];
+        T *int_data;
+        size_t int_size, int_capacity;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_SMALLVECTOR_H
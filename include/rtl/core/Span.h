@@ -0,0 +1,136 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_SPAN_H
+#define ROBOTICTEMPLATELIBRARY_SPAN_H
+
+#include <cstddef>
+#include <vector>
+#include <type_traits>
+
+namespace rtl
+{
+    //! Non-owning view of a contiguous sequence of elements.
+    /*!
+     * A reduced counterpart of C++20 std::span with dynamic extent. It holds only a pointer and a size, so it is cheap to copy and pass by value. Span is used to pass parts
+     * of a larger buffer (e.g. clusters of a segmented scan) to the processing stages without copying the elements into separate containers. The viewed elements must outlive
+     * the span. Span<const T> is implicitly constructible from std::vector<T> and Span<T>, so it can replace const std::vector<T>& parameters transparently.
+     * @tparam T type of the elements, const qualified for read-only views.
+     */
+    template<typename T>
+    class Span
+    {
+    public:
+        typedef std::remove_cv_t<T> value_type;         //!< Type of the elements.
+        typedef T element_type;                         //!< Type of the elements including cv qualification.
+        typedef size_t size_type;                       //!< Type for sizes and indices.
+        typedef T& reference;                           //!< Reference to an element.
+        typedef T* iterator;                            //!< Random access iterator.
+
+        //! Default constructor. The span is empty.
+        constexpr Span() : int_data(nullptr), int_size(0) {}
+
+        //! Construction from a pointer and a number of elements.
+        /*!
+         *
+         * @param data pointer to the first element.
+         * @param size number of elements.
+         */
+        constexpr Span(T *data, size_t size) : int_data(data), int_size(size) {}
+
+        //! Construction from a pointer range.
+        /*!
+         *
+         * @param first pointer to the first element.
+         * @param last pointer one behind the last element.
+         */
+        constexpr Span(T *first, T *last) : int_data(first), int_size(last - first) {}
+
+        //! Construction from a std::vector, constant views accept constant vectors.
+        /*!
+         *
+         * @param vec viewed vector.
+         */
+        template<class Alloc, typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+        Span(const std::vector<value_type, Alloc> &vec) : int_data(vec.data()), int_size(vec.size()) {}
+
+        //! Construction from a mutable std::vector.
+        /*!
+         *
+         * @param vec viewed vector.
+         */
+        template<class Alloc>
+        Span(std::vector<value_type, Alloc> &vec) : int_data(vec.data()), int_size(vec.size()) {}
+
+        //! Conversion of a mutable view to a constant one.
+        /*!
+         *
+         * @param s mutable span.
+         */
+        template<typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+        constexpr Span(const Span<U> &s) : int_data(s.data()), int_size(s.size()) {}
+
+        //! Pointer to the first element.
+        [[nodiscard]] constexpr T* data() const { return int_data; }
+
+        //! Number of elements.
+        [[nodiscard]] constexpr size_t size() const { return int_size; }
+
+        //! Returns true if the span has no elements.
+        [[nodiscard]] constexpr bool empty() const { return int_size == 0; }
+
+        //! Iterator to the first element.
+        [[nodiscard]] constexpr iterator begin() const { return int_data; }
+
+        //! Iterator behind the last element.
+        [[nodiscard]] constexpr iterator end() const { return int_data + int_size; }
+
+        //! The first element, the span must not be empty.
+        [[nodiscard]] constexpr T& front() const { return int_data[0]; }
+
+        //! The last element, the span must not be empty.
+        [[nodiscard]] constexpr T& back() const { return int_data[int_size - 1]; }
+
+        //! Access to the \p i -th element without bounds checking.
+        constexpr T& operator[](size_t i) const { return int_data[i]; }
+
+        //! View of \p count elements starting at \p offset.
+        /*!
+         *
+         * @param offset index of the first element of the subspan.
+         * @param count number of elements of the subspan.
+         * @return new span.
+         */
+        [[nodiscard]] constexpr Span subspan(size_t offset, size_t count) const { return Span(int_data + offset, count); }
+
+    private:
+        T *int_data;
+        size_t int_size;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_SPAN_H
@@ -0,0 +1,459 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_STATICTYPES_H
+#define ROBOTICTEMPLATELIBRARY_STATICTYPES_H
+
+#include <cstddef>
+#include <type_traits>
+
+#include "rtl/core/Trigonometry.h"
+#include "rtl/core/VectorND.h"
+#include "rtl/core/Matrix.h"
+#include "rtl/core/Quaternion.h"
+
+namespace rtl
+{
+    //! Fixed-size vector usable in constant expressions.
+    /*!
+     * VectorND stores its elements in an Eigen matrix, whose operations are not constexpr. StaticVectorND keeps the elements in a plain array, so constants such as
+     * calibrated offsets can be computed at compile time and converted to VectorND by toVectorND() where the run-time interface is needed.
+     * @tparam dimensions dimensionality of the vector.
+     * @tparam Element base type of vector elements.
+     */
+    template<int dimensions, typename Element>
+    class StaticVectorND
+    {
+        static_assert(dimensions > 0, "StaticVectorND requires positive number of dimensions.");
+
+    public:
+        typedef Element ElementType;                            //!< Base type for vector elements.
+        typedef VectorND<dimensions, Element> RuntimeType;      //!< Run-time counterpart of the vector.
+
+        //! Default constructor, all elements are zero.
+        constexpr StaticVectorND() : elements{} {}
+
+        //! Construction from the individual elements.
+        template<typename... T, typename = std::enable_if_t<sizeof...(T) == dimensions && std::conjunction_v<std::is_convertible<T, Element>...>>>
+        constexpr StaticVectorND(T... values) : elements{static_cast<Element>(values)...} {}
+
+        //! Construction from the run-time counterpart.
+        explicit StaticVectorND(const RuntimeType &v) : elements{}
+        {
+            for (int i = 0; i < dimensions; i++)
+                elements[i] = v[i];
+        }
+
+        //! Dimensionality of the vector.
+        static constexpr int dimensionality() { return dimensions; }
+
+        //! Vector of zeros.
+        static constexpr StaticVectorND zeros() { return StaticVectorND(); }
+
+        //! Element access.
+        constexpr Element &operator[](size_t i) { return elements[i]; }
+
+        //! Element access.
+        constexpr const Element &operator[](size_t i) const { return elements[i]; }
+
+        //! The first element.
+        [[nodiscard]] constexpr Element x() const { return elements[0]; }
+
+        //! The second element.
+        [[nodiscard]] constexpr Element y() const
+        {
+            static_assert(dimensions >= 2, "StaticVectorND::y() requires at least two dimensions.");
+            return elements[1];
+        }
+
+        //! The third element.
+        [[nodiscard]] constexpr Element z() const
+        {
+            static_assert(dimensions >= 3, "StaticVectorND::z() requires at least three dimensions.");
+            return elements[2];
+        }
+
+        constexpr StaticVectorND &operator+=(const StaticVectorND &v)
+        {
+            for (int i = 0; i < dimensions; i++)
+                elements[i] += v.elements[i];
+            return *this;
+        }
+
+        constexpr StaticVectorND &operator-=(const StaticVectorND &v)
+        {
+            for (int i = 0; i < dimensions; i++)
+                elements[i] -= v.elements[i];
+            return *this;
+        }
+
+        constexpr StaticVectorND &operator*=(Element factor)
+        {
+            for (int i = 0; i < dimensions; i++)
+                elements[i] *= factor;
+            return *this;
+        }
+
+        constexpr StaticVectorND &operator/=(Element divisor)
+        {
+            for (int i = 0; i < dimensions; i++)
+                elements[i] /= divisor;
+            return *this;
+        }
+
+        friend constexpr StaticVectorND operator+(StaticVectorND a, const StaticVectorND &b) { return a += b; }
+        friend constexpr StaticVectorND operator-(StaticVectorND a, const StaticVectorND &b) { return a -= b; }
+        friend constexpr StaticVectorND operator*(StaticVectorND v, Element factor) { return v *= factor; }
+        friend constexpr StaticVectorND operator*(Element factor, StaticVectorND v) { return v *= factor; }
+        friend constexpr StaticVectorND operator/(StaticVectorND v, Element divisor) { return v /= divisor; }
+        friend constexpr StaticVectorND operator-(StaticVectorND v) { return v *= Element(-1); }
+
+        friend constexpr bool operator==(const StaticVectorND &a, const StaticVectorND &b)
+        {
+            for (int i = 0; i < dimensions; i++)
+                if (a.elements[i] != b.elements[i])
+                    return false;
+            return true;
+        }
+
+        friend constexpr bool operator!=(const StaticVectorND &a, const StaticVectorND &b) { return !(a == b); }
+
+        //! Dot product with \p v.
+        [[nodiscard]] constexpr Element dot(const StaticVectorND &v) const
+        {
+            Element ret = 0;
+            for (int i = 0; i < dimensions; i++)
+                ret += elements[i] * v.elements[i];
+            return ret;
+        }
+
+        //! Cross product with \p v, three dimensions only.
+        [[nodiscard]] constexpr StaticVectorND cross(const StaticVectorND &v) const
+        {
+            static_assert(dimensions == 3, "StaticVectorND::cross() requires three dimensions.");
+            return StaticVectorND(elements[1] * v.elements[2] - elements[2] * v.elements[1], elements[2] * v.elements[0] - elements[0] * v.elements[2],
+                                  elements[0] * v.elements[1] - elements[1] * v.elements[0]);
+        }
+
+        //! Squared Euclidean length of the vector.
+        [[nodiscard]] constexpr Element lengthSquared() const { return dot(*this); }
+
+        //! Euclidean length of the vector.
+        [[nodiscard]] constexpr Element length() const { return TrigConstexpr::sqrt(lengthSquared()); }
+
+        //! Unit vector of the same direction.
+        [[nodiscard]] constexpr StaticVectorND normalized() const { return *this / length(); }
+
+        //! Run-time counterpart of the vector.
+        [[nodiscard]] RuntimeType toVectorND() const
+        {
+            RuntimeType ret;
+            for (int i = 0; i < dimensions; i++)
+                ret[i] = elements[i];
+            return ret;
+        }
+
+    private:
+        Element elements[dimensions];
+    };
+
+    //! Fixed-size matrix usable in constant expressions.
+    /*!
+     * Small-matrix counterpart of Matrix with the elements stored row-major in a plain array, the products are evaluated by plain loops, which the compiler unrolls
+     * for the sizes of rotation matrices. Converted to Matrix by toMatrix().
+     * @tparam rows number of rows.
+     * @tparam cols number of columns.
+     * @tparam Element base type of matrix elements.
+     */
+    template<int rows, int cols, typename Element>
+    class StaticMatrix
+    {
+        static_assert(rows > 0 && cols > 0, "StaticMatrix requires positive dimensions.");
+
+    public:
+        typedef Element ElementType;                        //!< Base type for matrix elements.
+        typedef Matrix<rows, cols, Element> RuntimeType;    //!< Run-time counterpart of the matrix.
+
+        //! Default constructor, all elements are zero.
+        constexpr StaticMatrix() : elements{} {}
+
+        //! Construction from the elements in row-major order.
+        template<typename... T, typename = std::enable_if_t<sizeof...(T) == rows * cols && std::conjunction_v<std::is_convertible<T, Element>...>>>
+        constexpr StaticMatrix(T... values) : elements{static_cast<Element>(values)...} {}
+
+        //! Construction from the run-time counterpart.
+        explicit StaticMatrix(const RuntimeType &m) : elements{}
+        {
+            for (int r = 0; r < rows; r++)
+                for (int c = 0; c < cols; c++)
+                    elements[r * cols + c] = m.data()(r, c);
+        }
+
+        //! Number of rows.
+        static constexpr int rowNr() { return rows; }
+
+        //! Number of columns.
+        static constexpr int colNr() { return cols; }
+
+        //! Matrix of zeros.
+        static constexpr StaticMatrix zeros() { return StaticMatrix(); }
+
+        //! Identity matrix, ones on the main diagonal.
+        static constexpr StaticMatrix identity()
+        {
+            StaticMatrix ret;
+            for (int i = 0; i < (rows < cols ? rows : cols); i++)
+                ret(i, i) = Element(1);
+            return ret;
+        }
+
+        //! Element access.
+        constexpr Element &operator()(int r, int c) { return elements[r * cols + c]; }
+
+        //! Element access.
+        constexpr const Element &operator()(int r, int c) const { return elements[r * cols + c]; }
+
+        //! Transposed matrix.
+        [[nodiscard]] constexpr StaticMatrix<cols, rows, Element> transposed() const
+        {
+            StaticMatrix<cols, rows, Element> ret;
+            for (int r = 0; r < rows; r++)
+                for (int c = 0; c < cols; c++)
+                    ret(c, r) = (*this)(r, c);
+            return ret;
+        }
+
+        constexpr StaticMatrix &operator+=(const StaticMatrix &m)
+        {
+            for (int i = 0; i < rows * cols; i++)
+                elements[i] += m.elements[i];
+            return *this;
+        }
+
+        constexpr StaticMatrix &operator-=(const StaticMatrix &m)
+        {
+            for (int i = 0; i < rows * cols; i++)
+                elements[i] -= m.elements[i];
+            return *this;
+        }
+
+        constexpr StaticMatrix &operator*=(Element factor)
+        {
+            for (int i = 0; i < rows * cols; i++)
+                elements[i] *= factor;
+            return *this;
+        }
+
+        friend constexpr StaticMatrix operator+(StaticMatrix a, const StaticMatrix &b) { return a += b; }
+        friend constexpr StaticMatrix operator-(StaticMatrix a, const StaticMatrix &b) { return a -= b; }
+        friend constexpr StaticMatrix operator*(StaticMatrix m, Element factor) { return m *= factor; }
+        friend constexpr StaticMatrix operator*(Element factor, StaticMatrix m) { return m *= factor; }
+
+        //! Matrix product.
+        template<int cols2>
+        constexpr StaticMatrix<rows, cols2, Element> operator*(const StaticMatrix<cols, cols2, Element> &m) const
+        {
+            StaticMatrix<rows, cols2, Element> ret;
+            for (int r = 0; r < rows; r++)
+                for (int c = 0; c < cols2; c++)
+                {
+                    Element sum = 0;
+                    for (int k = 0; k < cols; k++)
+                        sum += (*this)(r, k) * m(k, c);
+                    ret(r, c) = sum;
+                }
+            return ret;
+        }
+
+        //! Product with a column vector.
+        constexpr StaticVectorND<rows, Element> operator*(const StaticVectorND<cols, Element> &v) const
+        {
+            StaticVectorND<rows, Element> ret;
+            for (int r = 0; r < rows; r++)
+            {
+                Element sum = 0;
+                for (int k = 0; k < cols; k++)
+                    sum += (*this)(r, k) * v[k];
+                ret[r] = sum;
+            }
+            return ret;
+        }
+
+        friend constexpr bool operator==(const StaticMatrix &a, const StaticMatrix &b)
+        {
+            for (int i = 0; i < rows * cols; i++)
+                if (a.elements[i] != b.elements[i])
+                    return false;
+            return true;
+        }
+
+        friend constexpr bool operator!=(const StaticMatrix &a, const StaticMatrix &b) { return !(a == b); }
+
+        //! Run-time counterpart of the matrix.
+        [[nodiscard]] RuntimeType toMatrix() const
+        {
+            typename RuntimeType::EigenType em;
+            for (int r = 0; r < rows; r++)
+                for (int c = 0; c < cols; c++)
+                    em(r, c) = (*this)(r, c);
+            return RuntimeType(em);
+        }
+
+    private:
+        Element elements[rows * cols];
+    };
+
+    //! Quaternion usable in constant expressions.
+    /*!
+     * Counterpart of Quaternion with the same conventions, in particular fromRPY() composes the elementary rotations in the same order as the roll-pitch-yaw
+     * constructor of Quaternion. The trigonometric functions are evaluated by TrigConstexpr. Converted to Quaternion by toQuaternion().
+     * @tparam Element base type of the quaternion elements.
+     */
+    template<typename Element>
+    class StaticQuaternion
+    {
+    public:
+        typedef Element ElementType;                        //!< Base type for quaternion elements.
+        typedef StaticVectorND<3, Element> VectorType;      //!< Type of the rotated vectors.
+        typedef StaticMatrix<3, 3, Element> MatrixType;     //!< Type of the rotation matrix.
+        typedef Quaternion<Element> RuntimeType;            //!< Run-time counterpart of the quaternion.
+
+        //! Default constructor, identity quaternion.
+        constexpr StaticQuaternion() : int_w(1), int_x(0), int_y(0), int_z(0) {}
+
+        //! Construction from the elements.
+        constexpr StaticQuaternion(Element w, Element x, Element y, Element z) : int_w(w), int_x(x), int_y(y), int_z(z) {}
+
+        //! Construction from the run-time counterpart.
+        explicit StaticQuaternion(const RuntimeType &q) : int_w(q.w()), int_x(q.x()), int_y(q.y()), int_z(q.z()) {}
+
+        //! Identity quaternion.
+        static constexpr StaticQuaternion identity() { return StaticQuaternion(); }
+
+        //! Rotation by \p angle around \p axis, which does not have to be normalized.
+        static constexpr StaticQuaternion fromAngleAxis(Element angle, const VectorType &axis)
+        {
+            Element s = 0, c = 0;
+            TrigConstexpr::sincos(angle / 2, s, c);
+            VectorType a = axis.normalized() * s;
+            return StaticQuaternion(c, a.x(), a.y(), a.z());
+        }
+
+        //! Rotation from roll, pitch and yaw angles, composed as in Quaternion(roll, pitch, yaw).
+        static constexpr StaticQuaternion fromRPY(Element roll, Element pitch, Element yaw)
+        {
+            return fromAngleAxis(roll, VectorType(1, 0, 0)) * fromAngleAxis(pitch, VectorType(0, 1, 0)) * fromAngleAxis(yaw, VectorType(0, 0, 1));
+        }
+
+        //! Rotation given by an orthonormal rotation matrix.
+        static constexpr StaticQuaternion fromRotMat(const MatrixType &m)
+        {
+            Element trace = m(0, 0) + m(1, 1) + m(2, 2);
+            if (trace > 0)
+            {
+                Element s = TrigConstexpr::sqrt(trace + Element(1)) * 2;
+                return StaticQuaternion(s / 4, (m(2, 1) - m(1, 2)) / s, (m(0, 2) - m(2, 0)) / s, (m(1, 0) - m(0, 1)) / s);
+            }
+            if (m(0, 0) > m(1, 1) && m(0, 0) > m(2, 2))
+            {
+                Element s = TrigConstexpr::sqrt(Element(1) + m(0, 0) - m(1, 1) - m(2, 2)) * 2;
+                return StaticQuaternion((m(2, 1) - m(1, 2)) / s, s / 4, (m(0, 1) + m(1, 0)) / s, (m(0, 2) + m(2, 0)) / s);
+            }
+            if (m(1, 1) > m(2, 2))
+            {
+                Element s = TrigConstexpr::sqrt(Element(1) + m(1, 1) - m(0, 0) - m(2, 2)) * 2;
+                return StaticQuaternion((m(0, 2) - m(2, 0)) / s, (m(0, 1) + m(1, 0)) / s, s / 4, (m(1, 2) + m(2, 1)) / s);
+            }
+            Element s = TrigConstexpr::sqrt(Element(1) + m(2, 2) - m(0, 0) - m(1, 1)) * 2;
+            return StaticQuaternion((m(1, 0) - m(0, 1)) / s, (m(0, 2) + m(2, 0)) / s, (m(1, 2) + m(2, 1)) / s, s / 4);
+        }
+
+        [[nodiscard]] constexpr Element w() const { return int_w; }     //!< The real component.
+        [[nodiscard]] constexpr Element x() const { return int_x; }     //!< The first imaginary component.
+        [[nodiscard]] constexpr Element y() const { return int_y; }     //!< The second imaginary component.
+        [[nodiscard]] constexpr Element z() const { return int_z; }     //!< The third imaginary component.
+
+        //! Hamilton product, the rotation \p q is applied first.
+        constexpr StaticQuaternion operator*(const StaticQuaternion &q) const
+        {
+            return StaticQuaternion(int_w * q.int_w - int_x * q.int_x - int_y * q.int_y - int_z * q.int_z,
+                                    int_w * q.int_x + int_x * q.int_w + int_y * q.int_z - int_z * q.int_y,
+                                    int_w * q.int_y - int_x * q.int_z + int_y * q.int_w + int_z * q.int_x,
+                                    int_w * q.int_z + int_x * q.int_y - int_y * q.int_x + int_z * q.int_w);
+        }
+
+        //! Squared norm of the quaternion.
+        [[nodiscard]] constexpr Element normSquared() const { return int_w * int_w + int_x * int_x + int_y * int_y + int_z * int_z; }
+
+        //! Norm of the quaternion.
+        [[nodiscard]] constexpr Element norm() const { return TrigConstexpr::sqrt(normSquared()); }
+
+        //! Unit quaternion of the same rotation.
+        [[nodiscard]] constexpr StaticQuaternion normalized() const
+        {
+            Element n = norm();
+            return StaticQuaternion(int_w / n, int_x / n, int_y / n, int_z / n);
+        }
+
+        //! Conjugated quaternion, the inverse rotation for unit quaternions.
+        [[nodiscard]] constexpr StaticQuaternion conjugate() const { return StaticQuaternion(int_w, -int_x, -int_y, -int_z); }
+
+        //! Inverse of the quaternion.
+        [[nodiscard]] constexpr StaticQuaternion inverted() const
+        {
+            Element n2 = normSquared();
+            return StaticQuaternion(int_w / n2, -int_x / n2, -int_y / n2, -int_z / n2);
+        }
+
+        //! Rotation matrix of the unit quaternion.
+        [[nodiscard]] constexpr MatrixType rotMat() const
+        {
+            Element xx = int_x * int_x, yy = int_y * int_y, zz = int_z * int_z;
+            Element xy = int_x * int_y, xz = int_x * int_z, yz = int_y * int_z;
+            Element wx = int_w * int_x, wy = int_w * int_y, wz = int_w * int_z;
+            return MatrixType(1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy),
+                              2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx),
+                              2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy));
+        }
+
+        //! Rotates vector \p v by the unit quaternion.
+        constexpr VectorType operator()(const VectorType &v) const
+        {
+            VectorType u(int_x, int_y, int_z);
+            VectorType t = u.cross(v) * Element(2);
+            return v + t * int_w + u.cross(t);
+        }
+
+        //! Run-time counterpart of the quaternion.
+        [[nodiscard]] RuntimeType toQuaternion() const { return RuntimeType(int_w, int_x, int_y, int_z); }
+
+    private:
+        Element int_w, int_x, int_y, int_z;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_STATICTYPES_H
@@ -0,0 +1,252 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_STRIDEDSPAN_H
+#define ROBOTICTEMPLATELIBRARY_STRIDEDSPAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <eigen3/Eigen/Dense>
+
+#include "rtl/core/Span.h"
+#include "rtl/core/VectorND.h"
+
+namespace rtl
+{
+    //! Non-owning view of points stored in an external buffer with a runtime stride.
+    /*!
+     * StridedSpan plays the role of Eigen::Map with a runtime outer stride for arrays of VectorND. The coordinates of each point have to be stored consecutively, but
+     * consecutive points may be separated by an arbitrary number of bytes, which is the case of interleaved driver buffers, ROS sensor_msgs/PointCloud2 messages or PCL
+     * clouds with padding and additional fields. Points are read and written by value, bulk operations use map() to process the whole buffer by Eigen expressions.
+     *
+     * StridedSpan<const V> is implicitly constructible from Span<const V> and Span<V>, so functions taking a StridedSpan accept tightly packed containers as well. For
+     * algorithms requiring a contiguous Span, span(scratch) returns a view of the original memory if the points are tightly packed and packs them into the reusable
+     * \p scratch buffer otherwise.
+     * @tparam T VectorND specialization, const qualified for read-only views.
+     */
+    template<typename T>
+    class StridedSpan
+    {
+    public:
+        typedef std::remove_cv_t<T> value_type;                         //!< Type of the viewed points.
+        typedef typename value_type::ElementType ElementType;           //!< Type of the coordinates.
+        typedef std::conditional_t<std::is_const_v<T>, const ElementType, ElementType> StoredElement;  //!< Coordinate type including cv qualification.
+        typedef std::conditional_t<std::is_const_v<T>, const unsigned char, unsigned char> ByteType;    //!< Byte type including cv qualification.
+        typedef Eigen::Matrix<ElementType, value_type::dimensionality(), Eigen::Dynamic> MatrixType;   //!< Matrix type with one point per column.
+        typedef Eigen::Map<std::conditional_t<std::is_const_v<T>, const MatrixType, MatrixType>, Eigen::Unaligned, Eigen::OuterStride<>> MapType;    //!< Eigen view of the points.
+
+        //! Random access iterator returning the points by value.
+        class iterator
+        {
+        public:
+            typedef std::random_access_iterator_tag iterator_category;  //!< Iterator category.
+            typedef typename StridedSpan::value_type value_type;        //!< Type of the points.
+            typedef std::ptrdiff_t difference_type;                     //!< Type of iterator differences.
+            typedef const value_type* pointer;                          //!< Pointer type, for compatibility only.
+            typedef value_type reference;                               //!< Dereferencing yields values.
+
+            iterator() = default;
+            iterator(const StridedSpan *s, size_t i) : span(s), index(i) {}
+            value_type operator*() const { return (*span)[index]; }
+            value_type operator[](difference_type n) const { return (*span)[index + n]; }
+            iterator &operator++() { index++; return *this; }
+            iterator operator++(int) { iterator ret = *this; index++; return ret; }
+            iterator &operator--() { index--; return *this; }
+            iterator operator--(int) { iterator ret = *this; index--; return ret; }
+            iterator &operator+=(difference_type n) { index += n; return *this; }
+            iterator &operator-=(difference_type n) { index -= n; return *this; }
+            iterator operator+(difference_type n) const { return iterator(span, index + n); }
+            iterator operator-(difference_type n) const { return iterator(span, index - n); }
+            difference_type operator-(const iterator &it) const { return (difference_type) index - (difference_type) it.index; }
+            bool operator==(const iterator &it) const { return index == it.index; }
+            bool operator!=(const iterator &it) const { return index != it.index; }
+            bool operator<(const iterator &it) const { return index < it.index; }
+            bool operator>(const iterator &it) const { return index > it.index; }
+            bool operator<=(const iterator &it) const { return index <= it.index; }
+            bool operator>=(const iterator &it) const { return index >= it.index; }
+
+        private:
+            const StridedSpan *span{nullptr};
+            size_t index{0};
+        };
+
+        //! Default constructor. The view is empty.
+        StridedSpan() : int_data(nullptr), int_size(0), int_stride(sizeof(value_type)) {}
+
+        //! Construction from a pointer to the first coordinate of the first point.
+        /*!
+         *
+         * @param first pointer to the first coordinate of the first point.
+         * @param size number of points.
+         * @param stride_bytes distance between the beginnings of consecutive points in bytes.
+         */
+        StridedSpan(StoredElement *first, size_t size, size_t stride_bytes) : int_data(reinterpret_cast<ByteType *>(first)), int_size(size), int_stride(stride_bytes)
+        {
+            checkLayout("StridedSpan::StridedSpan()");
+        }
+
+        //! Construction from a raw byte buffer with interleaved fields.
+        /*!
+         * Typical usage is wrapping of sensor_msgs/PointCloud2 data: StridedSpan<const Vector3f>(msg.data.data(), msg.width * msg.height, msg.point_step, x_field.offset).
+         * The coordinates have to be consecutive fields of ElementType. An exception is thrown if the stride or the offset break alignment of the coordinates.
+         * @param data pointer to the beginning of the buffer.
+         * @param size number of points.
+         * @param stride_bytes distance between the beginnings of consecutive points in bytes.
+         * @param offset_bytes offset of the first coordinate within each point.
+         */
+        StridedSpan(std::conditional_t<std::is_const_v<T>, const void, void> *data, size_t size, size_t stride_bytes, size_t offset_bytes)
+                : int_data(static_cast<ByteType *>(data) + offset_bytes), int_size(size), int_stride(stride_bytes)
+        {
+            checkLayout("StridedSpan::StridedSpan()");
+        }
+
+        //! Construction from a tightly packed Span.
+        /*!
+         *
+         * @param s viewed span.
+         */
+        template<typename U, typename = std::enable_if_t<std::is_same_v<U, T> || std::is_same_v<const U, T>>>
+        StridedSpan(Span<U> s) : int_data(reinterpret_cast<ByteType *>(s.data())), int_size(s.size()), int_stride(sizeof(value_type))
+        {
+            static_assert(sizeof(value_type) == value_type::dimensionality() * sizeof(ElementType), "StridedSpan: VectorND must be tightly packed.");
+        }
+
+        //! Conversion of a mutable view to a constant one.
+        /*!
+         *
+         * @param s mutable view.
+         */
+        template<typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+        StridedSpan(const StridedSpan<U> &s) : int_data(reinterpret_cast<ByteType *>(s.data())), int_size(s.size()), int_stride(s.strideBytes()) {}
+
+        //! Pointer to the first coordinate of the first point.
+        [[nodiscard]] StoredElement *data() const { return reinterpret_cast<StoredElement *>(int_data); }
+
+        //! Number of points.
+        [[nodiscard]] size_t size() const { return int_size; }
+
+        //! Returns true if there are no points in the view.
+        [[nodiscard]] bool empty() const { return int_size == 0; }
+
+        //! Distance between consecutive points in bytes.
+        [[nodiscard]] size_t strideBytes() const { return int_stride; }
+
+        //! Returns true if the points are tightly packed, so the buffer can be viewed as a Span of VectorND.
+        [[nodiscard]] bool contiguous() const { return int_stride == sizeof(value_type); }
+
+        //! Copy of the \p i -th point, no bounds checking.
+        value_type operator[](size_t i) const
+        {
+            return value_type(typename value_type::EigenType(Eigen::Map<const typename value_type::EigenType>(pointer(i))));
+        }
+
+        //! Copy of the first point, the view must not be empty.
+        [[nodiscard]] value_type front() const { return (*this)[0]; }
+
+        //! Copy of the last point, the view must not be empty.
+        [[nodiscard]] value_type back() const { return (*this)[int_size - 1]; }
+
+        //! Overwrites the \p i -th point in the external buffer, available for mutable views only.
+        void set(size_t i, const value_type &v) const
+        {
+            static_assert(!std::is_const_v<T>, "StridedSpan::set(): cannot write through a constant view.");
+            Eigen::Map<typename value_type::EigenType>(pointer(i)) = v.data();
+        }
+
+        //! Iterator to the first point.
+        [[nodiscard]] iterator begin() const { return iterator(this, 0); }
+
+        //! Iterator behind the last point.
+        [[nodiscard]] iterator end() const { return iterator(this, int_size); }
+
+        //! View of \p count points starting at \p offset.
+        [[nodiscard]] StridedSpan subspan(size_t offset, size_t count) const
+        {
+            StridedSpan ret(*this);
+            ret.int_data += offset * int_stride;
+            ret.int_size = count;
+            return ret;
+        }
+
+        //! Eigen view of the points as a matrix with one point per column.
+        [[nodiscard]] MapType map() const
+        {
+            return MapType(data(), value_type::dimensionality(), (Eigen::Index) int_size, Eigen::OuterStride<>((Eigen::Index) (int_stride / sizeof(ElementType))));
+        }
+
+        //! Span of the points, available only for contiguous() views.
+        /*!
+         * An exception is thrown if the points are not tightly packed.
+         * @return span of the viewed memory.
+         */
+        [[nodiscard]] Span<T> span() const
+        {
+            if (!contiguous())
+                throw std::invalid_argument("StridedSpan::span(): the points are not tightly packed.");
+            return Span<T>(reinterpret_cast<T *>(int_data), int_size);
+        }
+
+        //! Contiguous read-only span of the points, packing them into \p scratch only if necessary.
+        /*!
+         * Contiguous views are returned without copying, otherwise the points are copied into \p scratch, whose capacity is reused by subsequent calls.
+         * @param scratch buffer for packed points.
+         * @return span of the points.
+         */
+        Span<const value_type> span(std::vector<value_type> &scratch) const
+        {
+            if (contiguous())
+                return Span<const value_type>(reinterpret_cast<const value_type *>(int_data), int_size);
+            scratch.resize(int_size);
+            Eigen::Map<MatrixType>(scratch.data()->data().data(), value_type::dimensionality(), (Eigen::Index) int_size) = map();
+            return Span<const value_type>(scratch);
+        }
+
+    private:
+        StoredElement *pointer(size_t i) const { return reinterpret_cast<StoredElement *>(int_data + i * int_stride); }
+
+        void checkLayout(const char *method) const
+        {
+            static_assert(sizeof(value_type) == value_type::dimensionality() * sizeof(ElementType), "StridedSpan: VectorND must be tightly packed.");
+            if (int_stride % sizeof(ElementType) != 0 || int_stride < sizeof(value_type))
+                throw std::invalid_argument(std::string(method) + ": the stride must be a multiple of the element size and cover a whole point.");
+            if (reinterpret_cast<std::uintptr_t>(int_data) % alignof(ElementType) != 0)
+                throw std::invalid_argument(std::string(method) + ": misaligned coordinates.");
+        }
+
+        ByteType *int_data;
+        size_t int_size;
+        size_t int_stride;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_STRIDEDSPAN_H
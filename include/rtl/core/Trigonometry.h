@@ -0,0 +1,229 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_TRIGONOMETRY_H
+#define ROBOTICTEMPLATELIBRARY_TRIGONOMETRY_H
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <eigen3/Eigen/Dense>
+
+#include "rtl/core/Constants.h"
+#include "rtl/core/Span.h"
+
+namespace rtl
+{
+    //! Trigonometric policy using the standard library functions.
+    /*!
+     * Default policy of the angle-related functions of 2D rotations, see RotationND<2, Element>::setAngle(). Batch evaluation of single precision angles uses the vectorized sine and cosine of Eigen arrays.
+     */
+    struct TrigStd
+    {
+        //! Sine and cosine of \p angle.
+        template<typename E>
+        static void sincos(E angle, E &sin, E &cos)
+        {
+            sin = std::sin(angle);
+            cos = std::cos(angle);
+        }
+
+        //! Sines and cosines of all \p angles, \p sin and \p cos must point to arrays of the same size.
+        template<typename E>
+        static void sincos(Span<const E> angles, E *sin, E *cos)
+        {
+            if constexpr (std::is_same_v<E, float>)
+            {
+                Eigen::Map<const Eigen::Array<E, Eigen::Dynamic, 1>> a(angles.data(), (Eigen::Index) angles.size());
+                Eigen::Map<Eigen::Array<E, Eigen::Dynamic, 1>>(sin, (Eigen::Index) angles.size()) = a.sin();
+                Eigen::Map<Eigen::Array<E, Eigen::Dynamic, 1>>(cos, (Eigen::Index) angles.size()) = a.cos();
+            }
+            else
+            {
+                // Eigen has no packet sine and cosine for other types, the scalar loop lets the compiler fuse them into sincos
+                for (size_t i = 0; i < angles.size(); i++)
+                    sincos(angles[i], sin[i], cos[i]);
+            }
+        }
+
+        //! Four-quadrant arc tangent of \p y / \p x.
+        template<typename E>
+        static E atan2(E y, E x)
+        {
+            return std::atan2(y, x);
+        }
+    };
+
+    //! Trigonometric policy using branch-free polynomial approximations with bounded error.
+    /*!
+     * Sine and cosine reduce the angle to [-pi/4, pi/4] and evaluate minimax polynomials, their absolute error stays below sincos_max_error for angles up to 1e4 radians.
+     * The arc tangent is approximated on [0, 1] and extended to all quadrants, its absolute error stays below atan2_max_error. The batch version is free of control flow,
+     * so it vectorizes with -O3 and runs several times faster than the standard library. The policy is meant for motion models and similar workloads, where
+     * the approximation error is far below the modelled noise.
+     */
+    struct TrigFast
+    {
+        static constexpr double sincos_max_error = 1e-6;    //!< Upper bound of the absolute error of sincos() for floating point types.
+        static constexpr double atan2_max_error = 2e-6;     //!< Upper bound of the absolute error of atan2() in radians.
+
+        //! Approximate sine and cosine of \p angle.
+        template<typename E>
+        static void sincos(E angle, E &sin, E &cos)
+        {
+            // round to the nearest quadrant by truncation, std::floor does not vectorize without SSE4.1
+            int q = static_cast<int>(angle * C_2_PI<E> + std::copysign(E(0.5), angle));
+            E qe = static_cast<E>(q);
+            // Cody-Waite reduction by pi/2 split into parts exactly representable in single precision
+            E x = ((angle - qe * E(1.5703125)) - qe * E(4.837512969970703125e-4)) - qe * E(7.54978995489188216e-8);
+            E x2 = x * x;
+            E s = x + x * x2 * (E(-1.6666654611e-1) + x2 * (E(8.3321608736e-3) + x2 * E(-1.9515295891e-4)));
+            E c = E(1) - E(0.5) * x2 + x2 * x2 * (E(4.166664568298827e-2) + x2 * (E(-1.388731625493765e-3) + x2 * E(2.443315711809948e-5)));
+            // quadrant selection by arithmetic only, so that batch loops stay free of control flow
+            E swap = static_cast<E>(q & 1);
+            sin = (s + swap * (c - s)) * static_cast<E>(1 - (q & 2));
+            cos = (c + swap * (s - c)) * static_cast<E>(1 - ((q + 1) & 2));
+        }
+
+        //! Approximate sines and cosines of all \p angles, \p sin and \p cos must point to arrays of the same size.
+        template<typename E>
+        static void sincos(Span<const E> angles, E *sin, E *cos)
+        {
+            for (size_t i = 0; i < angles.size(); i++)
+                sincos(angles[i], sin[i], cos[i]);
+        }
+
+        //! Approximate four-quadrant arc tangent of \p y / \p x.
+        template<typename E>
+        static E atan2(E y, E x)
+        {
+            E ax = std::abs(x), ay = std::abs(y);
+            E mx = std::max(ax, ay), mn = std::min(ax, ay);
+            E t = mx == E(0) ? E(0) : mn / mx;
+            E t2 = t * t;
+            E r = t * (E(0.99997726) + t2 * (E(-0.33262347) + t2 * (E(0.19354346) + t2 * (E(-0.11643287) + t2 * (E(0.05265332) + t2 * E(-0.01172120))))));
+            if (ay > ax)
+                r = C_PI_2<E> - r;
+            if (x < E(0))
+                r = C_PI<E> - r;
+            return y < E(0) ? -r : r;
+        }
+    };
+
+    //! Trigonometric policy evaluable in constant expressions.
+    /*!
+     * The standard library functions are not constexpr in C++17, so this policy evaluates the functions by series in double precision. Sine and cosine reduce the angle
+     * to [-pi/4, pi/4] and sum the Taylor series, the arc tangent halves its argument twice before summing its series, and the square root iterates Newton's method. The absolute
+     * error is a few ulps of double for angles of moderate magnitude. The policy is meant for constants evaluated at compile time, e.g. the calibrations held by StaticRigidTfND,
+     * run-time code should prefer TrigStd.
+     */
+    struct TrigConstexpr
+    {
+        //! Sine and cosine of \p angle.
+        template<typename E>
+        static constexpr void sincos(E angle, E &sin, E &cos)
+        {
+            // Cody-Waite reduction, the leading part of pi/2 has 33 significant bits, so its product with the quadrant index is exact
+            constexpr double pi_2 = 1.57079632679489661923, pi_2_hi = 1.57079632673412561417, pi_2_lo = 6.07710050650619224932e-11;
+            double a = static_cast<double>(angle), quadrants = a / pi_2;
+            long long q = static_cast<long long>(quadrants < 0 ? quadrants - 0.5 : quadrants + 0.5);
+            double x = (a - static_cast<double>(q) * pi_2_hi) - static_cast<double>(q) * pi_2_lo, x2 = x * x;
+            double s = x, c = 1.0, term_s = x, term_c = 1.0;
+            for (int n = 1; n < 12; n++)
+            {
+                term_s *= -x2 / static_cast<double>((2 * n) * (2 * n + 1));
+                term_c *= -x2 / static_cast<double>((2 * n - 1) * (2 * n));
+                s += term_s;
+                c += term_c;
+            }
+            switch (((q % 4) + 4) % 4)
+            {
+                case 0: sin = static_cast<E>(s); cos = static_cast<E>(c); break;
+                case 1: sin = static_cast<E>(c); cos = static_cast<E>(-s); break;
+                case 2: sin = static_cast<E>(-s); cos = static_cast<E>(-c); break;
+                default: sin = static_cast<E>(-c); cos = static_cast<E>(s); break;
+            }
+        }
+
+        //! Sines and cosines of all \p angles, \p sin and \p cos must point to arrays of the same size.
+        template<typename E>
+        static constexpr void sincos(Span<const E> angles, E *sin, E *cos)
+        {
+            for (size_t i = 0; i < angles.size(); i++)
+                sincos(angles[i], sin[i], cos[i]);
+        }
+
+        //! Four-quadrant arc tangent of \p y / \p x.
+        template<typename E>
+        static constexpr E atan2(E y, E x)
+        {
+            constexpr double pi = 3.14159265358979323846;
+            double ax = x < E(0) ? -static_cast<double>(x) : static_cast<double>(x), ay = y < E(0) ? -static_cast<double>(y) : static_cast<double>(y);
+            double mx = ax > ay ? ax : ay, mn = ax > ay ? ay : ax;
+            if (mx == 0.0)
+                return E(0);
+            // atan(t) = 2 atan(t / (1 + sqrt(1 + t^2))), two halvings bring t below tan(pi / 16)
+            double t = mn / mx;
+            t = t / (1.0 + sqrt(1.0 + t * t));
+            t = t / (1.0 + sqrt(1.0 + t * t));
+            double t2 = t * t, term = t, r = t;
+            for (int n = 1; n < 20; n++)
+            {
+                term *= -t2;
+                r += term / static_cast<double>(2 * n + 1);
+            }
+            r *= 4.0;
+            if (ay > ax)
+                r = pi / 2 - r;
+            if (x < E(0))
+                r = pi - r;
+            return static_cast<E>(y < E(0) ? -r : r);
+        }
+
+        //! Square root of \p v, NaN for negative values.
+        template<typename E>
+        static constexpr E sqrt(E v)
+        {
+            double d = static_cast<double>(v);
+            if (!(d > 0.0))
+                return d == 0.0 ? E(0) : std::numeric_limits<E>::quiet_NaN();
+            if (d == std::numeric_limits<double>::infinity())
+                return v;
+            // Newton's iterations decrease monotonically from an initial guess above the root
+            double r = d > 1.0 ? d : 1.0;
+            while (true)
+            {
+                double next = 0.5 * (r + d / r);
+                if (next >= r)
+                    return static_cast<E>(r);
+                r = next;
+            }
+        }
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_TRIGONOMETRY_H
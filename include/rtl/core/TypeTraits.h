@@ -120,6 +120,19 @@ namespace rtl
     constexpr bool is_transformable_v = is_transformable<Obj, Tf>::value;
 
 
+    template<typename O, typename T>
+    using InPlaceTransformResult = decltype(std::declval<O &>().transform(std::declval<const T &>()));
+
+    //! Value of the trait testing if an object of type \p Obj can be transformed in-place by a transformation of type \p Tf.
+    /*!
+     * In-place transformation via Obj::transform() preserves the type of the object, which allows transforming whole arrays of objects without reallocation.
+     * @tparam Obj type of the object to be transformed.
+     * @tparam Tf type of the transformation applied.
+     */
+    template<typename Obj, typename Tf>
+    constexpr bool is_transformable_in_place_v = std::experimental::is_detected<InPlaceTransformResult, Obj, Tf>::value;
+
+
     template<typename T>
     using InvertedResult = decltype(std::declval<T &>().inverted());
 
@@ -31,6 +31,8 @@
 #include <type_traits>
 #include <eigen3/Eigen/Dense>
 
+#include "rtl/core/LazyExpression.h"
+
 namespace rtl
 {
     template<int rows, int cols, typename Element>
@@ -126,7 +128,7 @@ namespace rtl
          */
         ChildType transformed(const RigidTfND<dimensions, Element> &tf) const
         {
-            return ChildType(tf.rotMat() * (*this) + tf.trVec());
+            return lazy(tf.rotMat()) * (*this) + tf.trVec();
         }
 
         //! Transformed *this vector in-place by the rigid transformation \p tf.
@@ -136,7 +138,7 @@ namespace rtl
          */
         void transform(const RigidTfND<dimensions, Element> &tf)
         {
-            *this = tf.rotMat() * (*this) + tf.trVec();
+            *this = lazy(tf.rotMat()) * (*this) + tf.trVec();
         }
 
         //! Reference to underlying Eigen data.
@@ -552,20 +554,17 @@ namespace rtl
             initElement(args...);
         }
 
-        VectorND_common(const VectorND_common<dimensions, Element, ChildTemplate> &v)
-        {
-            elements = v.elements;
-        }
+        VectorND_common(const VectorND_common<dimensions, Element, ChildTemplate> &v) = default;
 
-        explicit VectorND_common(const ChildType &v)
-        {
-            elements = v.elements;
-        }
+        VectorND_common(VectorND_common<dimensions, Element, ChildTemplate> &&v) noexcept = default;
 
-        explicit VectorND_common(const EigenType &ev)
-        {
-            elements = ev;
-        }
+        explicit VectorND_common(const ChildType &v) : elements(v.elements) {}
+
+        explicit VectorND_common(const EigenType &ev) : elements(ev) {}
+
+        VectorND_common<dimensions, Element, ChildTemplate> &operator=(const VectorND_common<dimensions, Element, ChildTemplate> &v) = default;
+
+        VectorND_common<dimensions, Element, ChildTemplate> &operator=(VectorND_common<dimensions, Element, ChildTemplate> &&v) noexcept = default;
 
         template<typename... T>
         size_t initElement(Element e, T ...args)
@@ -587,12 +586,6 @@ namespace rtl
         }
 
     private:
-        VectorND_common<dimensions, Element, ChildTemplate> &operator=(const VectorND_common<dimensions, Element, ChildTemplate> &v)
-        {
-            elements = v.elements;
-            return *this;
-        }
-
         VectorND_common<dimensions, Element, ChildTemplate> &operator=(const EigenType &ev)
         {
             elements = ev;
@@ -636,7 +629,10 @@ namespace rtl
         VectorND()= default;
 
         //! Copy constructor.
-        VectorND(const VectorND<dimensions, Element> &v) : VectorND_common<dimensions, Element, VectorND>(v.elements) {}
+        VectorND(const VectorND<dimensions, Element> &v) = default;
+
+        //! Move constructor.
+        VectorND(VectorND<dimensions, Element> &&v) noexcept = default;
 
         //! Construction from the underlying EigenType.
         explicit VectorND(const EigenType &e) : VectorND_common<dimensions, Element, VectorND>(e) {}
@@ -646,11 +642,10 @@ namespace rtl
         explicit VectorND(T ...args) : VectorND_common<dimensions, Element, VectorND>(args...) {}
 
         //! Assignment operator.
-        VectorND<dimensions, Element> &operator=(const VectorND<dimensions, Element> &v)
-        {
-            this->elements = v.elements;
-            return *this;
-        }
+        VectorND<dimensions, Element> &operator=(const VectorND<dimensions, Element> &v) = default;
+
+        //! Move assignment operator.
+        VectorND<dimensions, Element> &operator=(VectorND<dimensions, Element> &&v) noexcept = default;
 
         //! Assigns the vector with the EigenType variable.
         VectorND<dimensions, Element> &operator=(const EigenType &ev)
@@ -681,7 +676,10 @@ namespace rtl
         VectorND()= default;
 
         //! Copy constructor.
-        VectorND(const VectorND<2, Element> &v) : VectorND_common<2, Element, VectorND>(v.elements) {}
+        VectorND(const VectorND<2, Element> &v) = default;
+
+        //! Move constructor.
+        VectorND(VectorND<2, Element> &&v) noexcept = default;
 
         //! Construction from the underlying EigenType.
         explicit VectorND(const EigenType &e) : VectorND_common<2, Element, VectorND>(e) {}
@@ -690,11 +688,10 @@ namespace rtl
         VectorND(ElementType x, ElementType y) : VectorND_common<2, Element, VectorND> (x, y) {}
 
         //! Assignment operator.
-        VectorND<2, Element> &operator=(const VectorND<2, Element> &v)
-        {
-            this->elements = v.elements;
-            return *this;
-        }
+        VectorND<2, Element> &operator=(const VectorND<2, Element> &v) = default;
+
+        //! Move assignment operator.
+        VectorND<2, Element> &operator=(VectorND<2, Element> &&v) noexcept = default;
 
         //! Assigns the vector with the EigenType variable.
         VectorND<2, Element> &operator=(const EigenType &ev)
@@ -793,7 +790,10 @@ namespace rtl
         VectorND()= default;
 
         //! Copy constructor.
-        VectorND(const VectorND<3, Element> &v) : VectorND_common<3, Element, VectorND>(v.elements) {}
+        VectorND(const VectorND<3, Element> &v) = default;
+
+        //! Move constructor.
+        VectorND(VectorND<3, Element> &&v) noexcept = default;
 
         //! Construction from the underlying EigenType.
         explicit VectorND(const EigenType &e) : VectorND_common<3, Element, VectorND>(e) {}
@@ -802,11 +802,10 @@ namespace rtl
         VectorND(Element x, Element y, Element z): VectorND_common<3, Element, VectorND>(x, y, z) {}
 
         //! Assignment operator.
-        VectorND<3, Element> &operator=(const VectorND<3, Element> &v)
-        {
-            this->elements = v.elements;
-            return *this;
-        }
+        VectorND<3, Element> &operator=(const VectorND<3, Element> &v) = default;
+
+        //! Move assignment operator.
+        VectorND<3, Element> &operator=(VectorND<3, Element> &&v) noexcept = default;
 
         //! Assigns the vector with the EigenType variable.
         VectorND<3, Element> &operator=(const EigenType &ev)
@@ -0,0 +1,689 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_IO_BINARYLOG_H
+#define ROBOTICTEMPLATELIBRARY_IO_BINARYLOG_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define RTL_BINARY_LOG_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "rtl/core/Span.h"
+#include "rtl/core/VectorND.h"
+#include "rtl/core/LineSegmentND.h"
+#include "rtl/tf/RigidTfND.h"
+#include "rtl/tf/TfTree.h"
+
+/*! \file
+ *  \brief Compact binary log format for recording and replaying point data, transformations and vectorization results.
+ *
+ *  A log file starts with a 16 byte header: the magic "RTLB", format version (uint16), header size (uint16) and two reserved uint32 words. The header is followed by
+ *  a sequence of records (chunks), each consisting of a 32 byte record header and a payload padded to 16 bytes:
+ *
+ *  | offset | type     | meaning                                                                              |
+ *  |--------|----------|--------------------------------------------------------------------------------------|
+ *  | 0      | uint16   | record type, see BinaryLogRecordType                                                 |
+ *  | 2      | uint8    | element type code (1 = float, 2 = double)                                            |
+ *  | 3      | uint8    | dimensionality of the stored vectors/transformations                                 |
+ *  | 4      | uint32   | auxiliary field, key encoding for TfTree snapshots                                   |
+ *  | 8      | uint64   | number of items in the record                                                        |
+ *  | 16     | int64    | time stamp in user defined units                                                     |
+ *  | 24     | uint64   | payload size in bytes (without padding)                                              |
+ *
+ *  All values are little-endian and all payloads start at 16 byte aligned offsets, so a memory-mapped file can be viewed directly as arrays of VectorND without any
+ *  parsing or copying. Records are independent, a log cut short by an interrupted recording remains readable up to the last complete record.
+ */
+
+namespace rtl
+{
+    //! Types of records stored in a binary log.
+    enum class BinaryLogRecordType : uint16_t
+    {
+        points = 1,         //!< Array of VectorND, payload is count * dim elements.
+        line_segments = 2,  //!< Array of LineSegmentND, payload is count pairs of beginning and end points.
+        transforms = 3,     //!< Array of RigidTfND, payload is count times the row-major rotation matrix followed by the translation vector.
+        tf_tree = 4         //!< TfTree snapshot with RigidTfND transformations, see BinaryLogWriter::writeTfTree().
+    };
+
+    namespace detail
+    {
+        constexpr char binary_log_magic[4] = {'R', 'T', 'L', 'B'};
+        constexpr uint16_t binary_log_version = 1;
+        constexpr size_t binary_log_header_size = 16;
+        constexpr size_t binary_log_record_header_size = 32;
+        constexpr size_t binary_log_alignment = 16;
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+        static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "BinaryLog: the binary log format maps the files directly and requires a little-endian host.");
+#endif
+
+        template<typename E>
+        struct BinaryLogElement
+        {
+            static_assert(std::is_same_v<E, float> || std::is_same_v<E, double>, "BinaryLog: only float and double elements are supported.");
+            static constexpr uint8_t code = std::is_same_v<E, float> ? 1 : 2;
+        };
+
+        //! Key encoding of TfTree snapshots: integral keys are stored as their raw bytes, std::string keys as their characters.
+        template<typename K, typename Enable = void>
+        struct BinaryLogKey
+        {
+            static_assert(std::is_integral_v<K>, "BinaryLog: TfTree keys must be integral types or std::string.");
+            static constexpr uint32_t code = 0x100u | (uint32_t) sizeof(K);
+
+            static void append(const K &key, std::vector<char> &blob)
+            {
+                const char *p = reinterpret_cast<const char *>(&key);
+                blob.insert(blob.end(), p, p + sizeof(K));
+            }
+
+            static K restore(const char *data, size_t size)
+            {
+                if (size != sizeof(K))
+                    throw std::invalid_argument("BinaryLogRecord::tfTree(): stored key size does not match the key type.");
+                K key;
+                std::memcpy(&key, data, sizeof(K));
+                return key;
+            }
+        };
+
+        template<typename Dummy>
+        struct BinaryLogKey<std::string, Dummy>
+        {
+            static constexpr uint32_t code = 0x200u;
+
+            static void append(const std::string &key, std::vector<char> &blob)
+            {
+                blob.insert(blob.end(), key.begin(), key.end());
+            }
+
+            static std::string restore(const char *data, size_t size)
+            {
+                return std::string(data, size);
+            }
+        };
+
+        //! Node table entry of a TfTree snapshot.
+        struct BinaryLogTreeNode
+        {
+            uint32_t parent;        //!< Index of the parent node, the root points to itself.
+            uint32_t key_size;      //!< Size of the key in bytes.
+            uint64_t key_offset;    //!< Offset of the key in the key blob.
+        };
+        static_assert(sizeof(BinaryLogTreeNode) == 16, "BinaryLog: unexpected padding of BinaryLogTreeNode.");
+
+        template<int dim, typename E>
+        void checkBinaryLogLayout()
+        {
+            static_assert(sizeof(VectorND<dim, E>) == dim * sizeof(E), "BinaryLog: VectorND must be tightly packed to be mapped directly.");
+            static_assert(std::is_standard_layout_v<VectorND<dim, E>>, "BinaryLog: VectorND must have standard layout to be mapped directly.");
+        }
+
+        inline size_t binaryLogPadded(size_t size)
+        {
+            return (size + binary_log_alignment - 1) / binary_log_alignment * binary_log_alignment;
+        }
+    }
+
+    //! Sequential writer of the binary log.
+    /*!
+     * Each write*() call appends one record to the file. The writer keeps a small staging buffer for data types whose in-memory layout differs from the stored one
+     * (line segments, transformations, trees), point arrays are written straight from the caller's memory. The records are written through a std::ofstream, call flush()
+     * to make them visible to concurrent readers.
+     */
+    class BinaryLogWriter
+    {
+    public:
+        BinaryLogWriter() = delete;
+        BinaryLogWriter(const BinaryLogWriter &) = delete;
+        BinaryLogWriter &operator=(const BinaryLogWriter &) = delete;
+
+        //! Opens \p file_name for writing, truncates its previous content and writes the file header.
+        /*!
+         * An exception is thrown if the file cannot be opened.
+         * @param file_name name of the log file.
+         */
+        explicit BinaryLogWriter(const std::string &file_name) : ofs(file_name, std::ios::binary | std::ios::trunc)
+        {
+            if (!ofs.is_open())
+                throw std::runtime_error("BinaryLogWriter::BinaryLogWriter(): cannot open file '" + file_name + "'.");
+            char header[detail::binary_log_header_size] = {};
+            std::memcpy(header, detail::binary_log_magic, 4);
+            uint16_t version = detail::binary_log_version, header_size = detail::binary_log_header_size;
+            std::memcpy(header + 4, &version, 2);
+            std::memcpy(header + 6, &header_size, 2);
+            ofs.write(header, sizeof(header));
+            if (!ofs)
+                throw std::runtime_error("BinaryLogWriter::BinaryLogWriter(): cannot write the header of '" + file_name + "'.");
+        }
+
+        //! Writes an array of points.
+        /*!
+         * @tparam Container contiguous container of VectorND, e.g. std::vector or Span.
+         * @param points the points to be written.
+         * @param timestamp time stamp of the record.
+         */
+        template<class Container>
+        void writePoints(const Container &points, int64_t timestamp = 0)
+        {
+            using V = std::remove_cv_t<typename Container::value_type>;
+            using E = typename V::ElementType;
+            detail::checkBinaryLogLayout<V::dimensionality(), E>();
+            writeRecord(BinaryLogRecordType::points, detail::BinaryLogElement<E>::code, V::dimensionality(), 0, points.size(), timestamp,
+                        reinterpret_cast<const char *>(points.data()), points.size() * sizeof(V));
+        }
+
+        //! Writes an array of line segments, typically the output of a vectorizer.
+        /*!
+         * @tparam Container container of LineSegmentND.
+         * @param segments the line segments to be written.
+         * @param timestamp time stamp of the record.
+         */
+        template<class Container>
+        void writeLineSegments(const Container &segments, int64_t timestamp = 0)
+        {
+            using L = std::remove_cv_t<typename Container::value_type>;
+            using E = typename L::ElementType;
+            constexpr int dim = L::VectorType::dimensionality();
+            detail::checkBinaryLogLayout<dim, E>();
+            std::vector<char> &stage = stagingBuffer(segments.size() * 2 * sizeof(VectorND<dim, E>));
+            auto *dst = reinterpret_cast<E *>(stage.data());
+            for (const auto &ls : segments)
+            {
+                for (int i = 0; i < dim; i++)
+                    *dst++ = ls.beg().getElement(i);
+                for (int i = 0; i < dim; i++)
+                    *dst++ = ls.end().getElement(i);
+            }
+            writeRecord(BinaryLogRecordType::line_segments, detail::BinaryLogElement<E>::code, dim, 0, segments.size(), timestamp, stage.data(), stage.size());
+        }
+
+        //! Writes an array of rigid transformations.
+        /*!
+         * Transformations are stored as their rotation matrices and translation vectors, so they are restored bit-exactly.
+         * @tparam Container container of RigidTfND.
+         * @param transforms the transformations to be written.
+         * @param timestamp time stamp of the record.
+         */
+        template<class Container>
+        void writeTransforms(const Container &transforms, int64_t timestamp = 0)
+        {
+            using T = std::remove_cv_t<typename Container::value_type>;
+            using E = typename T::ElementType;
+            constexpr int dim = T::VectorType::dimensionality();
+            std::vector<char> &stage = stagingBuffer(transforms.size() * (dim * dim + dim) * sizeof(E));
+            auto *dst = reinterpret_cast<E *>(stage.data());
+            for (const auto &tf : transforms)
+                dst = storeTf(tf, dst);
+            writeRecord(BinaryLogRecordType::transforms, detail::BinaryLogElement<E>::code, dim, 0, transforms.size(), timestamp, stage.data(), stage.size());
+        }
+
+        //! Writes a snapshot of a TfTree.
+        /*!
+         * The payload consists of a node table (parent index, key size and key offset per node), the transformations from parents (root first) and a blob of the keys.
+         * Nodes are stored in breadth-first order, so each parent precedes its children. Only the current transformations are stored, buffered history is not.
+         * @tparam K key type of the tree, integral types and std::string are supported.
+         * @tparam dim dimensionality of the transformations.
+         * @tparam E element type of the transformations.
+         * @tparam A allocator type of the tree.
+         * @param tree the tree to be written.
+         * @param timestamp time stamp of the record.
+         */
+        template<typename K, int dim, typename E, typename A>
+        void writeTfTree(const TfTree<K, RigidTfND<dim, E>, A> &tree, int64_t timestamp = 0)
+        {
+            using NodeType = typename TfTree<K, RigidTfND<dim, E>, A>::NodeType;
+            std::vector<const NodeType *> order{&tree.root()};
+            for (size_t i = 0; i < order.size(); i++)
+                for (auto c : order[i]->children())
+                    order.push_back(c);
+
+            std::vector<detail::BinaryLogTreeNode> table(order.size());
+            std::vector<char> keys;
+            std::unordered_map<const NodeType *, uint32_t> indices;
+            indices.reserve(order.size());
+            for (size_t i = 0; i < order.size(); i++)
+            {
+                table[i].key_offset = keys.size();
+                detail::BinaryLogKey<K>::append(order[i]->key(), keys);
+                table[i].key_size = (uint32_t) (keys.size() - table[i].key_offset);
+                table[i].parent = i == 0 ? 0 : indices.at(order[i]->parent());
+                indices.emplace(order[i], (uint32_t) i);
+            }
+
+            size_t table_bytes = table.size() * sizeof(detail::BinaryLogTreeNode), tf_bytes = order.size() * (dim * dim + dim) * sizeof(E);
+            std::vector<char> &stage = stagingBuffer(table_bytes + tf_bytes + keys.size());
+            std::memcpy(stage.data(), table.data(), table_bytes);
+            auto *dst = reinterpret_cast<E *>(stage.data() + table_bytes);
+            for (auto n : order)
+                dst = storeTf(n->tf(), dst);
+            std::memcpy(stage.data() + table_bytes + tf_bytes, keys.data(), keys.size());
+            writeRecord(BinaryLogRecordType::tf_tree, detail::BinaryLogElement<E>::code, dim, detail::BinaryLogKey<K>::code, order.size(), timestamp, stage.data(), stage.size());
+        }
+
+        //! Flushes the written records to the file, throws std::runtime_error if writing fails.
+        void flush()
+        {
+            ofs.flush();
+            if (!ofs)
+                throw std::runtime_error("BinaryLogWriter::flush(): writing the records failed, the log is truncated.");
+        }
+
+        //! Closes the file, no further records can be written. Throws std::runtime_error if writing of the buffered records fails.
+        void close()
+        {
+            ofs.close();
+            if (!ofs)
+                throw std::runtime_error("BinaryLogWriter::close(): writing the records failed, the log is truncated.");
+        }
+
+    private:
+        std::vector<char> &stagingBuffer(size_t size)
+        {
+            stage_buffer.resize(size);
+            return stage_buffer;
+        }
+
+        template<int dim, typename E>
+        static E *storeTf(const RigidTfND<dim, E> &tf, E *dst)
+        {
+            for (int r = 0; r < dim; r++)
+                for (int c = 0; c < dim; c++)
+                    *dst++ = tf.rotMat()(r, c);
+            for (int i = 0; i < dim; i++)
+                *dst++ = tf.trVec().getElement(i);
+            return dst;
+        }
+
+        void writeRecord(BinaryLogRecordType type, uint8_t element, int dim, uint32_t aux, uint64_t count, int64_t timestamp, const char *payload, uint64_t payload_size)
+        {
+            if (!ofs.is_open())
+                throw std::invalid_argument("BinaryLogWriter::writeRecord(): the log has already been closed.");
+            char header[detail::binary_log_record_header_size];
+            auto type_code = (uint16_t) type;
+            auto dim_code = (uint8_t) dim;
+            std::memcpy(header, &type_code, 2);
+            std::memcpy(header + 2, &element, 1);
+            std::memcpy(header + 3, &dim_code, 1);
+            std::memcpy(header + 4, &aux, 4);
+            std::memcpy(header + 8, &count, 8);
+            std::memcpy(header + 16, &timestamp, 8);
+            std::memcpy(header + 24, &payload_size, 8);
+            ofs.write(header, sizeof(header));
+            ofs.write(payload, (std::streamsize) payload_size);
+            static constexpr char padding[detail::binary_log_alignment] = {};
+            ofs.write(padding, (std::streamsize) (detail::binaryLogPadded(payload_size) - payload_size));
+            if (!ofs)
+                throw std::runtime_error("BinaryLogWriter::writeRecord(): writing the record failed, the log is truncated.");
+        }
+
+        std::ofstream ofs;
+        std::vector<char> stage_buffer;
+    };
+
+    //! A single record of a memory-mapped binary log.
+    /*!
+     * A lightweight view into the mapped file, valid as long as the originating BinaryLogReader exists. The typed accessors check that the requested dimensionality and
+     * element type match the stored ones and throw std::invalid_argument otherwise.
+     */
+    class BinaryLogRecord
+    {
+    public:
+        //! Type of the record.
+        [[nodiscard]] BinaryLogRecordType type() const { return int_type; }
+
+        //! Dimensionality of the stored vectors or transformations.
+        [[nodiscard]] int dimensionality() const { return int_dim; }
+
+        //! Number of stored items (points, segments, transformations or tree nodes).
+        [[nodiscard]] size_t size() const { return int_count; }
+
+        //! Time stamp of the record.
+        [[nodiscard]] int64_t timestamp() const { return int_timestamp; }
+
+        //! Raw payload of the record.
+        [[nodiscard]] Span<const char> payload() const { return int_payload; }
+
+        //! Checks whether the record stores data of given dimensionality and element type.
+        template<int dim, typename E>
+        [[nodiscard]] bool holds() const
+        {
+            return int_dim == dim && int_element == detail::BinaryLogElement<E>::code;
+        }
+
+        //! Points of a BinaryLogRecordType::points record, mapped directly from the file.
+        /*!
+         * The returned span can be passed to the vectorizers as is.
+         * @tparam dim dimensionality of the points.
+         * @tparam E element type of the points.
+         * @return span of the stored points.
+         */
+        template<int dim, typename E>
+        [[nodiscard]] Span<const VectorND<dim, E>> points() const
+        {
+            check<dim, E>(BinaryLogRecordType::points, dim * sizeof(E), "points");
+            return Span<const VectorND<dim, E>>(reinterpret_cast<const VectorND<dim, E> *>(int_payload.data()), int_count);
+        }
+
+        //! Endpoints of a BinaryLogRecordType::line_segments record, mapped directly from the file as beginning, end, beginning, end, ...
+        template<int dim, typename E>
+        [[nodiscard]] Span<const VectorND<dim, E>> lineSegmentEndpoints() const
+        {
+            check<dim, E>(BinaryLogRecordType::line_segments, 2 * dim * sizeof(E), "lineSegmentEndpoints");
+            return Span<const VectorND<dim, E>>(reinterpret_cast<const VectorND<dim, E> *>(int_payload.data()), 2 * int_count);
+        }
+
+        //! Line segments of a BinaryLogRecordType::line_segments record, appended to \p segments.
+        template<int dim, typename E>
+        void lineSegments(std::vector<LineSegmentND<dim, E>> &segments) const
+        {
+            auto pts = lineSegmentEndpoints<dim, E>();
+            segments.reserve(segments.size() + int_count);
+            for (size_t i = 0; i < int_count; i++)
+                segments.emplace_back(pts[2 * i], pts[2 * i + 1]);
+        }
+
+        //! Transformation \p index of a BinaryLogRecordType::transforms record.
+        template<int dim, typename E>
+        [[nodiscard]] RigidTfND<dim, E> transform(size_t index) const
+        {
+            check<dim, E>(BinaryLogRecordType::transforms, (dim * dim + dim) * sizeof(E), "transform");
+            if (index >= int_count)
+                throw std::out_of_range("BinaryLogRecord::transform(): index out of range.");
+            return restoreTf<dim, E>(reinterpret_cast<const E *>(int_payload.data()) + index * (dim * dim + dim));
+        }
+
+        //! All transformations of a BinaryLogRecordType::transforms record, appended to \p transforms.
+        template<int dim, typename E>
+        void transforms(std::vector<RigidTfND<dim, E>> &transforms) const
+        {
+            check<dim, E>(BinaryLogRecordType::transforms, (dim * dim + dim) * sizeof(E), "transforms");
+            transforms.reserve(transforms.size() + int_count);
+            auto src = reinterpret_cast<const E *>(int_payload.data());
+            for (size_t i = 0; i < int_count; i++, src += dim * dim + dim)
+                transforms.push_back(restoreTf<dim, E>(src));
+        }
+
+        //! Reconstructs the TfTree stored in a BinaryLogRecordType::tf_tree record.
+        /*!
+         * @tparam K key type of the tree, must match the stored one.
+         * @tparam dim dimensionality of the transformations.
+         * @tparam E element type of the transformations.
+         * @return the restored tree.
+         */
+        template<typename K, int dim, typename E>
+        [[nodiscard]] TfTree<K, RigidTfND<dim, E>> tfTree() const
+        {
+            check<dim, E>(BinaryLogRecordType::tf_tree, sizeof(detail::BinaryLogTreeNode) + (dim * dim + dim) * sizeof(E), "tfTree");
+            size_t table_bytes = int_count * sizeof(detail::BinaryLogTreeNode), tf_bytes = int_count * (dim * dim + dim) * sizeof(E);
+            if (int_aux != detail::BinaryLogKey<K>::code)
+                throw std::invalid_argument("BinaryLogRecord::tfTree(): stored key type does not match the requested one.");
+            if (int_count == 0)
+                throw std::invalid_argument("BinaryLogRecord::tfTree(): the snapshot contains no root node.");
+
+            const char *base = int_payload.data();
+            const char *key_blob = base + table_bytes + tf_bytes;
+            size_t key_blob_size = int_payload.size() - table_bytes - tf_bytes;
+            auto tfs = reinterpret_cast<const E *>(base + table_bytes);
+            std::vector<K> keys;
+            std::vector<uint32_t> parents;
+            keys.reserve(int_count);
+            parents.reserve(int_count);
+            for (size_t i = 0; i < int_count; i++)
+            {
+                detail::BinaryLogTreeNode node;
+                std::memcpy(&node, base + i * sizeof(node), sizeof(node));
+                if (node.key_offset > key_blob_size || node.key_size > key_blob_size - node.key_offset || (i > 0 && node.parent >= i))
+                    throw std::invalid_argument("BinaryLogRecord::tfTree(): corrupted node table.");
+                keys.push_back(detail::BinaryLogKey<K>::restore(key_blob + node.key_offset, node.key_size));
+                parents.push_back(node.parent);
+            }
+
+            TfTree<K, RigidTfND<dim, E>> tree(keys.front());
+            for (size_t i = 1; i < int_count; i++)
+                tree.insert(keys[i], restoreTf<dim, E>(tfs + i * (dim * dim + dim)), keys[parents[i]]);
+            return tree;
+        }
+
+    private:
+        friend class BinaryLogReader;
+
+        //! Checks the record type, layout and that the payload holds int_count items of \p item_size bytes, compared by division to avoid overflow of corrupted counts.
+        template<int dim, typename E>
+        void check(BinaryLogRecordType required, size_t item_size, const char *method) const
+        {
+            detail::checkBinaryLogLayout<dim, E>();
+            if (int_type != required)
+                throw std::invalid_argument(std::string("BinaryLogRecord::") + method + "(): record type mismatch.");
+            if (!holds<dim, E>())
+                throw std::invalid_argument(std::string("BinaryLogRecord::") + method + "(): stored dimensionality or element type does not match the requested one.");
+            if (int_count > int_payload.size() / item_size)
+                throw std::invalid_argument(std::string("BinaryLogRecord::") + method + "(): payload is shorter than the record header states.");
+        }
+
+        template<int dim, typename E>
+        static RigidTfND<dim, E> restoreTf(const E *src)
+        {
+            typename RigidTfND<dim, E>::MatrixType mat;
+            for (int r = 0; r < dim; r++)
+                for (int c = 0; c < dim; c++)
+                    mat(r, c) = *src++;
+            typename RigidTfND<dim, E>::RotationType rot;
+            rot.setRotMat(mat);
+            VectorND<dim, E> tr;
+            for (int i = 0; i < dim; i++)
+                tr.setElement(i, *src++);
+            return RigidTfND<dim, E>(rot, typename RigidTfND<dim, E>::TranslationType(tr));
+        }
+
+        BinaryLogRecordType int_type{};
+        uint8_t int_element{};
+        int int_dim{};
+        uint32_t int_aux{};
+        size_t int_count{};
+        int64_t int_timestamp{};
+        Span<const char> int_payload;
+    };
+
+    //! Memory-mapped reader of the binary log.
+    /*!
+     * The whole file is mapped into memory on construction (POSIX systems) or read into an aligned buffer (elsewhere) and the record headers are indexed. The records
+     * are then accessed as BinaryLogRecord views pointing directly into the mapping, so point data can be replayed without parsing or copying. A trailing record
+     * cut short (e.g. by an interrupted recording) is not indexed and truncated() reports it.
+     */
+    class BinaryLogReader
+    {
+    public:
+        typedef std::vector<BinaryLogRecord>::const_iterator const_iterator;   //!< Iterator over the records.
+
+        BinaryLogReader() = delete;
+        BinaryLogReader(const BinaryLogReader &) = delete;
+        BinaryLogReader &operator=(const BinaryLogReader &) = delete;
+
+        //! Maps \p file_name and indexes its records.
+        /*!
+         * An exception is thrown if the file cannot be opened or if it does not start with a valid header of a supported version.
+         * @param file_name name of the log file.
+         */
+        explicit BinaryLogReader(const std::string &file_name)
+        {
+            mapFile(file_name);
+            if (int_size < detail::binary_log_header_size || std::memcmp(int_data, detail::binary_log_magic, 4) != 0)
+            {
+                unmapFile();
+                throw std::invalid_argument("BinaryLogReader::BinaryLogReader(): '" + file_name + "' is not a binary log.");
+            }
+            uint16_t header_size;
+            std::memcpy(&int_version, int_data + 4, 2);
+            std::memcpy(&header_size, int_data + 6, 2);
+            if (int_version > detail::binary_log_version || header_size < detail::binary_log_header_size || header_size % detail::binary_log_alignment != 0)
+            {
+                unmapFile();
+                throw std::invalid_argument("BinaryLogReader::BinaryLogReader(): unsupported version of '" + file_name + "'.");
+            }
+            indexRecords(header_size);
+        }
+
+        //! Unmaps the file, all records obtained from *this become invalid.
+        ~BinaryLogReader()
+        {
+            unmapFile();
+        }
+
+        //! Format version of the file.
+        [[nodiscard]] uint16_t version() const { return int_version; }
+
+        //! Number of complete records in the file.
+        [[nodiscard]] size_t size() const { return records.size(); }
+
+        //! Returns true if the file ends with an incomplete record.
+        [[nodiscard]] bool truncated() const { return int_truncated; }
+
+        //! Access to the record at \p index.
+        const BinaryLogRecord &operator[](size_t index) const { return records[index]; }
+
+        //! Iterator to the first record.
+        [[nodiscard]] const_iterator begin() const { return records.begin(); }
+
+        //! Iterator past the last record.
+        [[nodiscard]] const_iterator end() const { return records.end(); }
+
+    private:
+        void indexRecords(size_t offset)
+        {
+            while (offset < int_size)
+            {
+                if (int_size - offset < detail::binary_log_record_header_size)
+                {
+                    int_truncated = true;
+                    break;
+                }
+                const char *header = int_data + offset;
+                BinaryLogRecord rec;
+                uint16_t type;
+                uint8_t dim;
+                uint64_t count, payload_size;
+                std::memcpy(&type, header, 2);
+                std::memcpy(&rec.int_element, header + 2, 1);
+                std::memcpy(&dim, header + 3, 1);
+                std::memcpy(&rec.int_aux, header + 4, 4);
+                std::memcpy(&count, header + 8, 8);
+                std::memcpy(&rec.int_timestamp, header + 16, 8);
+                std::memcpy(&payload_size, header + 24, 8);
+                offset += detail::binary_log_record_header_size;
+                if (payload_size > int_size - offset)
+                {
+                    int_truncated = true;
+                    break;
+                }
+                rec.int_type = (BinaryLogRecordType) type;
+                rec.int_dim = dim;
+                rec.int_count = count;
+                rec.int_payload = Span<const char>(int_data + offset, payload_size);
+                records.push_back(rec);
+                offset += std::min<size_t>(detail::binaryLogPadded(payload_size), int_size - offset);
+            }
+        }
+
+#ifdef RTL_BINARY_LOG_MMAP
+        void mapFile(const std::string &file_name)
+        {
+            int fd = ::open(file_name.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error("BinaryLogReader::BinaryLogReader(): cannot open file '" + file_name + "'.");
+            struct stat st{};
+            if (::fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                throw std::runtime_error("BinaryLogReader::BinaryLogReader(): cannot stat file '" + file_name + "'.");
+            }
+            int_size = (size_t) st.st_size;
+            if (int_size > 0)
+            {
+                void *addr = ::mmap(nullptr, int_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED)
+                {
+                    ::close(fd);
+                    throw std::runtime_error("BinaryLogReader::BinaryLogReader(): cannot map file '" + file_name + "'.");
+                }
+                ::madvise(addr, int_size, MADV_SEQUENTIAL);
+                int_data = static_cast<const char *>(addr);
+            }
+            ::close(fd);
+        }
+
+        void unmapFile()
+        {
+            if (int_data != nullptr)
+                ::munmap(const_cast<char *>(int_data), int_size);
+            int_data = nullptr;
+        }
+#else
+        void mapFile(const std::string &file_name)
+        {
+            std::ifstream ifs(file_name, std::ios::binary | std::ios::ate);
+            if (!ifs.is_open())
+                throw std::runtime_error("BinaryLogReader::BinaryLogReader(): cannot open file '" + file_name + "'.");
+            int_size = (size_t) ifs.tellg();
+            fallback_buffer.resize(detail::binaryLogPadded(int_size) / sizeof(std::max_align_t) + 1);
+            ifs.seekg(0);
+            ifs.read(reinterpret_cast<char *>(fallback_buffer.data()), (std::streamsize) int_size);
+            int_data = reinterpret_cast<const char *>(fallback_buffer.data());
+        }
+
+        void unmapFile()
+        {
+            fallback_buffer.clear();
+            int_data = nullptr;
+        }
+
+        std::vector<std::max_align_t> fallback_buffer;
+#endif
+
+        const char *int_data{nullptr};
+        size_t int_size{0};
+        uint16_t int_version{0};
+        bool int_truncated{false};
+        std::vector<BinaryLogRecord> records;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_IO_BINARYLOG_H
@@ -194,11 +194,39 @@ namespace rtl
             ofs << "\\end{figure}\n\n";
         }
 
+        //! Adds a table to the document.
+        /*!
+         *
+         * @param tab the table.
+         * @param desc caption of the table.
+         */
         void addTable(const LaTeXTable &tab, const std::string &desc)
         {
             tab.writeTable(ofs, desc);
         }
 
+        //! Starts a table streamed directly into the document.
+        /*!
+         * Rows added to \p tab until endTable() are written to the document immediately and not kept in memory, see LaTeXTable::beginStream(). No other content may be
+         * added to the document in between.
+         * @param tab the table with the column style and the heading already set.
+         */
+        void beginTable(LaTeXTable &tab)
+        {
+            tab.beginStream(ofs);
+        }
+
+        //! Finishes a table started by beginTable().
+        /*!
+         *
+         * @param tab the streamed table.
+         * @param desc caption of the table.
+         */
+        void endTable(LaTeXTable &tab, const std::string &desc)
+        {
+            tab.endStream(desc);
+        }
+
     private:
         LaTeXDoc()= default;
 
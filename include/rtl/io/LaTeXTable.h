@@ -29,13 +29,22 @@
 
 #include <string>
 #include <vector>
-#include <fstream>
+#include <ostream>
+#include <charconv>
+#include <type_traits>
+
+#include "rtl/core/Span.h"
+#include "rtl/io/LaTeXUtility.h"
 
 namespace rtl
 {
     //! Class for comfortable export of simple tables into LaTeXDoc.
     /*!
      * The API of this class is currently quite spare and for example does not allow merging of cells, multi-page tables etc., however simple layouts work well.
+     *
+     * Rows are formatted by LaTeX::TextWriter, numeric cells with std::to_chars, into a single buffer kept until writeTable(). For tables with many rows, e.g. reports of
+     * long benchmarks, the table can be streamed instead: after beginStream(), each row is written to the output stream as soon as it is added, so the memory footprint does
+     * not grow with the number of rows. endStream() then closes the table.
      */
     class LaTeXTable
     {
@@ -97,44 +106,184 @@ namespace rtl
         {
             if (row_cells.empty())
                 return;
-            std::string new_row = "\n\t" + row_cells.front();
+            LaTeX::TextWriter tw(rows, int_precision);
+            tw << "\n\t" << row_cells.front();
+            for (size_t i = 1; i != row_cells.size(); i++)
+                tw << " & " << row_cells[i];
+            tw << "\\\\";
+            tw.flush();
+            streamRow();
+        }
+
+        //! Adds a whole new row of numbers to the table.
+        /*!
+         * The numbers are formatted by std::to_chars, floating point ones in fixed notation with precision() decimal digits.
+         * @tparam T arithmetic type of the cells.
+         * @param row_cells the content of the cells.
+         */
+        template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+        void addRow(Span<const T> row_cells)
+        {
+            if (row_cells.empty())
+                return;
+            LaTeX::TextWriter tw(rows, int_precision);
+            tw << "\n\t";
+            writeCell(tw, row_cells[0]);
             for (size_t i = 1; i != row_cells.size(); i++)
-                new_row += " & " + row_cells[i];
-            new_row += "\\\\";
-            rows.push_back(new_row);
+            {
+                tw << " & ";
+                writeCell(tw, row_cells[i]);
+            }
+            tw << "\\\\";
+            tw.flush();
+            streamRow();
+        }
+
+        //! Adds a whole new row of numbers to the table.
+        /*!
+         * The numbers are formatted by std::to_chars, floating point ones in fixed notation with precision() decimal digits.
+         * @tparam T arithmetic type of the cells.
+         * @param row_cells the content of the cells.
+         */
+        template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+        void addRow(const std::vector<T> &row_cells)
+        {
+            addRow(Span<const T>(row_cells));
+        }
+
+        //! Adds a whole new row with cells of mixed types to the table.
+        /*!
+         * Each cell is either a string, or a number formatted by std::to_chars as in addRow() for numbers, e.g. addRowCells("method", 1024, 0.25).
+         * @tparam Cells types of the cells.
+         * @param cells the content of the cells.
+         */
+        template<typename... Cells>
+        void addRowCells(const Cells &... cells)
+        {
+            static_assert(sizeof...(Cells) > 0, "LaTeXTable: a row requires at least one cell.");
+            LaTeX::TextWriter tw(rows, int_precision);
+            tw << "\n\t";
+            bool first = true;
+            ((tw << (first ? "" : " & "), writeCell(tw, cells), first = false), ...);
+            tw << "\\\\";
+            tw.flush();
+            streamRow();
         }
 
         //! Adds a horizontal line to the table.
         void addHLine()
         {
-            rows.emplace_back("\n\t\\hline");
+            rows += "\n\t\\hline";
+            streamRow();
         }
 
+        //! Sets number of decimal digits of floating point cells added from now on.
+        /*!
+         *
+         * @param precision number of decimal digits, 6 by default.
+         */
+        void setPrecision(int precision) { int_precision = precision; }
+
+        //! Number of decimal digits of floating point cells.
+        [[nodiscard]] int precision() const { return int_precision; }
+
+        //! Removes all rows of the table, the heading and the column style are kept.
+        void clearRows() { rows.clear(); }
+
         //! Writes the table code to the output stream with given description.
+        /*!
+         * Writes the rows added so far, which does not include the rows already streamed.
+         * @param os output stream for the LaTeX code.
+         * @param desc caption of the table.
+         */
+        void writeTable(std::ostream &os, const std::string &desc) const
+        {
+            writeBegin(os);
+            os << rows;
+            writeEnd(os, desc);
+        }
+
+        //! Starts streaming of the table into given output stream.
+        /*!
+         * Writes the beginning of the table including the heading and all rows added so far. Each subsequently added row is written to \p os immediately and not kept in
+         * *this. The column style and the heading have to be set before the stream is started. The stream has to outlive the streaming, which is finished by endStream().
+         * @param os output stream for the LaTeX code.
+         */
+        void beginStream(std::ostream &os)
+        {
+            writeBegin(os);
+            os << rows;
+            rows.clear();
+            stream = &os;
+        }
+
+        //! Finishes streaming of the table started by beginStream().
         /*!
          *
-         * @param ofs output stream for the LaTeX code.
          * @param desc caption of the table.
          */
-        void writeTable(std::ofstream &ofs, const std::string &desc) const
+        void endStream(const std::string &desc)
         {
-            ofs << "\\begin{table}\n";
-            ofs << "\\begin{center}\n";
-            ofs << "\\begin{tabular}{" << column_style << "}\n";
-            ofs << heading;
-            for (const auto &r : rows)
-                ofs << r;
-            ofs << "\n";
-            ofs << "\\end{tabular}\n";
-            ofs << "\\end{center}\n";
-            if (!desc.empty())
-                ofs << "\\caption{" + desc + "}\n";
-            ofs << "\\end{table}\n\n";
+            if (stream == nullptr)
+                return;
+            writeEnd(*stream, desc);
+            stream = nullptr;
         }
 
+        //! Checks whether the table is being streamed.
+        /*!
+         *
+         * @return true between beginStream() and endStream(), false otherwise.
+         */
+        [[nodiscard]] bool streaming() const { return stream != nullptr; }
+
     private:
+        template<typename T>
+        static void writeCell(LaTeX::TextWriter &tw, const T &cell)
+        {
+            if constexpr (std::is_floating_point_v<T>)
+                tw << static_cast<double>(cell);
+            else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, char>)
+            {
+                char str[24];
+                auto res = std::to_chars(str, str + sizeof(str), cell);
+                tw.write(str, res.ptr - str);
+            }
+            else
+                tw << cell;
+        }
+
+        // In the streaming mode, the buffer holds only the last row, which is moved to the stream immediately, and its capacity is reused by the next row.
+        void streamRow()
+        {
+            if (stream == nullptr)
+                return;
+            stream->write(rows.data(), (std::streamsize) rows.size());
+            rows.clear();
+        }
+
+        void writeBegin(std::ostream &os) const
+        {
+            os << "\\begin{table}\n";
+            os << "\\begin{center}\n";
+            os << "\\begin{tabular}{" << column_style << "}\n";
+            os << heading;
+        }
+
+        static void writeEnd(std::ostream &os, const std::string &desc)
+        {
+            os << "\n";
+            os << "\\end{tabular}\n";
+            os << "\\end{center}\n";
+            if (!desc.empty())
+                os << "\\caption{" + desc + "}\n";
+            os << "\\end{table}\n\n";
+        }
+
         std::string heading, column_style;
-        std::vector<std::string> rows;
+        std::string rows;
+        std::ostream *stream{nullptr};
+        int int_precision{6};
 
     };
 }
@@ -33,9 +33,12 @@
 #include <map>
 #include <limits>
 #include <fstream>
+#include <unordered_set>
 
 #include "rtl/Core.h"
 #include "rtl/Transformation.h"
+#include "rtl/io/LaTeXUtility.h"
+#include "rtl/vect/VectorizerPointElimination.h"
 
 namespace rtl
 {
@@ -43,6 +46,13 @@ namespace rtl
     /*!
      * This class is used to aggregate graphic primitives to be rendered into a PDF format. The rendering order corresponds to the order in which the primitives are added,
      * with an exception of axes and grids, which are always in the bottom. The graphics is gradually built using add* functions and exported to TEX file when it is finished.
+     *
+     * The Tikz code of the primitives is formatted by LaTeX::TextWriter directly into a single buffer as they are added, so no intermediate strings are created even for
+     * plots with hundreds of thousands of points. Number of decimal digits of the coordinates can be reduced by setPrecision() to shrink the output.
+     *
+     * For huge plots, setLevelOfDetail() bounds the size of the output regardless of the number of points: polylines are simplified by the Douglas-Peucker algorithm
+     * to a tolerance given on the exported page and only one mark per occupied cell of the page is emitted. Since the scale of the page is known only when the
+     * picture is finished, such plots are kept as points and formatted in writeTEX().
      */
     class LaTeXTikz2D
     {
@@ -160,6 +170,28 @@ namespace rtl
             addY(p2_y);
         }
 
+        //! Sets number of decimal digits of coordinates in the Tikz code of subsequently added primitives.
+        /*!
+         * The default of 6 digits corresponds to std::to_string() formatting.
+         * @param digits number of decimal digits.
+         */
+        void setPrecision(unsigned int digits)
+        {
+            number_precision = (int) digits;
+        }
+
+        //! Sets level-of-detail simplification of subsequently added plots.
+        /*!
+         * Both limits are given in centimeters on the exported page, zero disables the respective simplification, which is the default.
+         * @param line_tolerance maximal distance of the plotted points from the simplified polyline.
+         * @param mark_cell size of square cells of the page, in which at most one mark of a plot is emitted. Use the size of a printed dot or a screen pixel.
+         */
+        void setLevelOfDetail(float line_tolerance, float mark_cell)
+        {
+            lod_line_tolerance = std::max(line_tolerance, 0.0f);
+            lod_mark_cell = std::max(mark_cell, 0.0f);
+        }
+
         //! Clears all settings as well as data in the exporter.
         void clearAll()
         {
@@ -171,6 +203,8 @@ namespace rtl
             export_border = 0.1f;
             clip_p1_x = clip_p1_y = clip_p2_x = clip_p2_y = 0.0f;
             is_clipped = false;
+            number_precision = 6;
+            lod_line_tolerance = lod_mark_cell = 0.0f;
         }
 
         //! Clears only data, while export settings are left unchanged.
@@ -179,7 +213,8 @@ namespace rtl
             styles.clear();
             marks.clear();
             colors.clear();
-            render_codes.clear();
+            render_code.clear();
+            lod_plots.clear();
 
             max_x = max_y = -std::numeric_limits<float>::max();
             min_x = min_y = std::numeric_limits<float>::max();
@@ -197,6 +232,19 @@ namespace rtl
          * @param file_name output file path.
          */
         void writeTEX(const std::string &file_name)
+        {
+            std::ofstream ofs;
+            ofs.open(file_name, std::ofstream::out | std::ofstream::trunc);
+            writeTEX(ofs);
+            ofs.close();
+        }
+
+        //! Writes internal data according to export settings into an output stream.
+        /*!
+         *
+         * @param ofs output stream receiving the .tex file content.
+         */
+        void writeTEX(std::ostream &ofs)
         {
             if (has_axis_x || has_grid_h)
             {
@@ -237,9 +285,6 @@ namespace rtl
                 output_scale_y = std::fmax(export_width / (max_x - min_x), export_height / (max_y - min_y)) * scale_y;
             }
 
-            std::ofstream ofs;
-            ofs.open(file_name, std::ofstream::out | std::ofstream::trunc);
-
             // export head
             ofs << "\\documentclass{minimal}\n"
                    "\\usepackage[rgb]{xcolor}\n"
@@ -614,16 +659,20 @@ namespace rtl
             }
             ofs << "\n";
 
-            // export render code
-            for (const auto & render_code : render_codes)
-                ofs << render_code << "\n";
+            // export render code, simplified plots are formatted at their positions in the order of primitives
+            size_t code_pos = 0;
+            for (const auto &plot : lod_plots)
+            {
+                ofs.write(render_code.data() + code_pos, (std::streamsize) (plot.code_offset - code_pos));
+                code_pos = plot.code_offset;
+                writeLodPlot(ofs, plot, output_scale_x, output_scale_y);
+            }
+            ofs.write(render_code.data() + code_pos, (std::streamsize) (render_code.size() - code_pos));
 
             // export finalization
             ofs << "\\end{tikzpicture}"
                    "\n"
                    "\\end{document}\n";
-
-            ofs.close();
         }
 
         //! Adds horizontal lines to the plot.
@@ -720,15 +769,27 @@ namespace rtl
             if (cnt != y.size())
                 return;
 
-            std::string code;
+            if (lod_line_tolerance > 0.0f || lod_mark_cell > 0.0f)
+            {
+                std::vector<Vector2f> v;
+                v.reserve(cnt);
+                for (size_t i = 0; i < cnt; i++)
+                    v.emplace_back(x[i], y[i]);
+                addPlot(v, line_style, mark_style, mark, mark_scale);
+                return;
+            }
+
+            LaTeX::TextWriter code(render_code, number_precision);
 
             if (!line_style.empty())
             {
                 std::string line_style_name = saveStyle(line_style);
-                for (size_t i = 0; i < cnt - 1; i++)
-                    code += "\t\\draw[" + line_style_name + "] (" + std::to_string(addX(x[i])) + "," +
-                            std::to_string(addY(y[i])) + ") -- (" + std::to_string(addX(x[i + 1])) + "," +
-                            std::to_string(addY(y[i + 1])) + ");\n";
+                for (size_t i = 0; i + 1 < cnt; i++)
+                {
+                    code << "\t\\draw[" << line_style_name << "] ";
+                    code.point(addX(x[i]), addY(y[i])) << " -- ";
+                    code.point(addX(x[i + 1]), addY(y[i + 1])) << ";\n";
+                }
             }
 
             if (!mark_style.empty() && !mark.empty())
@@ -752,12 +813,11 @@ namespace rtl
                         rot_2 = Vector2f::angleCcw(v1, v2) / 2.0f;
                         rot = (rot + rot_2) * 180.0f / rtl::C_PIf;
                     }
-                    code += "\t\\" + mark_name + "{" + std::to_string(addX(x[i])) + "}{" + std::to_string(addY(y[i])) +
-                            "}{" + std::to_string(rot) + "}\n";
+                    code << "\t\\" << mark_name << '{' << addX(x[i]) << "}{" << addY(y[i]) << "}{" << rot << "}\n";
                 }
             }
 
-            render_codes.push_back(code);
+            code << '\n';
         }
 
         //! Plots a set of points using given style.
@@ -772,16 +832,34 @@ namespace rtl
         void addPlot(const std::vector<Vector2f> &v, const std::string &line_style, const std::string &mark_style = "", const std::string &mark = LaTeXTikz2D::latex_mark_blank, float mark_scale = 1.0f)
         {
             size_t cnt = v.size();
-            std::string code;
+            if (lod_line_tolerance > 0.0f || lod_mark_cell > 0.0f)
+            {
+                LodPlot plot{render_code.size(), v, "", "", lod_line_tolerance, lod_mark_cell};
+                for (const auto &p : v)
+                {
+                    addX(p.x());
+                    addY(p.y());
+                }
+                if (!line_style.empty())
+                    plot.line_style_name = saveStyle(line_style);
+                if (!mark_style.empty() && !mark.empty())
+                    plot.mark_name = saveMark(saveStyle(mark_style), mark, mark_scale);
+                lod_plots.push_back(std::move(plot));
+                return;
+            }
+
+            LaTeX::TextWriter code(render_code, number_precision);
 
             if (!line_style.empty())
             {
                 std::string line_style_name = saveStyle(line_style);
 
-                for (size_t i = 0; i < cnt - 1; i++)
-                    code += "\t\\draw[" + line_style_name + "] (" + std::to_string(addX(v[i].x())) + "," +
-                            std::to_string(addY(v[i].y())) + ") -- (" + std::to_string(addX(v[i + 1].x())) + "," +
-                            std::to_string(addY(v[i + 1].y())) + ");\n";
+                for (size_t i = 0; i + 1 < cnt; i++)
+                {
+                    code << "\t\\draw[" << line_style_name << "] ";
+                    code.point(addX(v[i].x()), addY(v[i].y())) << " -- ";
+                    code.point(addX(v[i + 1].x()), addY(v[i + 1].y())) << ";\n";
+                }
             }
 
             if (!mark_style.empty() && !mark.empty())
@@ -789,31 +867,11 @@ namespace rtl
                 std::string mark_style_name = saveStyle(mark_style);
                 std::string mark_name = saveMark(mark_style_name, mark, mark_scale);
 
-                float rot, rot_2;
                 for (size_t i = 0; i < cnt; i++)
-                {
-                    if (cnt == 1)
-                        rot = 0.0f;
-                    else if (i == 0)
-                        rot = Vector2f(v[1].x() - v.front().x(), v[1].y() - v.front().y()).angleFromZero() * 180.0f /
-                              rtl::C_PIf;
-                    else if (i == cnt - 1)
-                        rot = Vector2f(v.back().x() - v[cnt - 2].x(), v.back().y() - v[cnt - 2].y()).angleFromZero() *
-                              180.0f / rtl::C_PIf;
-                    else
-                    {
-                        rot = Vector2f(v[i].x() - v[i - 1].x(), v[i].y() - v[i - 1].y()).angleFromZero();
-                        Vector2f v1(v[i].x() - v[i - 1].x(), v[i].y() - v[i - 1].y()), v2(v[i + 1].x() - v[i].x(),
-                                                                                          v[i + 1].y() - v[i].y());
-                        rot_2 = Vector2f::angleCcw(v1, v2) / 2.0f;
-                        rot = (rot + rot_2) * 180.0f / rtl::C_PIf;
-                    }
-                    code += "\t\\" + mark_name + "{" + std::to_string(addX(v[i].x())) + "}{" +
-                            std::to_string(addY(v[i].y())) + "}{" + std::to_string(rot) + "}\n";
-                }
+                    code << "\t\\" << mark_name << '{' << addX(v[i].x()) << "}{" << addY(v[i].y()) << "}{" << markRotation(v, i) << "}\n";
             }
 
-            render_codes.push_back(code);
+            code << '\n';
         }
 
         //! Plots a set of line segments or other compliant objects.
@@ -849,11 +907,11 @@ namespace rtl
         void addTriangle(const Vector2f &a, const Vector2f &b, const Vector2f &c, const std::string &style)
         {
             std::string style_name = saveStyle(style);
-            std::string code =
-                    "\\filldraw[" + style_name + "] (" + std::to_string(addX(a.x())) + "," + std::to_string(addY(a.y())) +
-                    ") -- (" + std::to_string(addX(b.x())) + "," + std::to_string(addY(b.y())) + ") -- (" +
-                    std::to_string(addX(c.x())) + "," + std::to_string(addY(c.y())) + ") -- cycle;";
-            render_codes.push_back(code);
+            LaTeX::TextWriter code(render_code, number_precision);
+            code << "\\filldraw[" << style_name << "] ";
+            code.point(addX(a.x()), addY(a.y())) << " -- ";
+            code.point(addX(b.x()), addY(b.y())) << " -- ";
+            code.point(addX(c.x()), addY(c.y())) << " -- cycle;\n";
         }
 
         //! Plots a rectangle using given style.
@@ -866,10 +924,8 @@ namespace rtl
         void addRectangle(const Vector2f &p1, const Vector2f &p2, const std::string &style)
         {
             std::string style_name = saveStyle(style);
-            std::string code = "\\filldraw[" + style_name + "] (" + std::to_string(addX(p1.x())) + ", " +
-                               std::to_string(addY(p1.y())) + ") rectangle (" + std::to_string(addX(p2.x())) + ", " +
-                               std::to_string(addY(p2.y())) + ");";
-            render_codes.push_back(code);
+            LaTeX::TextWriter code(render_code, number_precision);
+            code << "\\filldraw[" << style_name << "] (" << addX(p1.x()) << ", " << addY(p1.y()) << ") rectangle (" << addX(p2.x()) << ", " << addY(p2.y()) << ");\n";
         }
 
         //! Plots general quadrilateral using given style.
@@ -884,12 +940,12 @@ namespace rtl
         void addQuadrilateral(const Vector2f &a, const Vector2f &b, const Vector2f &c, const Vector2f &d, const std::string &style)
         {
             std::string style_name = saveStyle(style);
-            std::string code =
-                    "\\filldraw[" + style_name + "] (" + std::to_string(addX(a.x())) + "," + std::to_string(addY(a.y())) +
-                    ") -- (" + std::to_string(addX(b.x())) + "," + std::to_string(addY(b.y())) + ") -- (" +
-                    std::to_string(addX(c.x())) + "," + std::to_string(addY(c.y())) + ") -- (" +
-                    std::to_string(addX(d.x())) + "," + std::to_string(addY(d.y())) + ") -- cycle;";
-            render_codes.push_back(code);
+            LaTeX::TextWriter code(render_code, number_precision);
+            code << "\\filldraw[" << style_name << "] ";
+            code.point(addX(a.x()), addY(a.y())) << " -- ";
+            code.point(addX(b.x()), addY(b.y())) << " -- ";
+            code.point(addX(c.x()), addY(c.y())) << " -- ";
+            code.point(addX(d.x()), addY(d.y())) << " -- cycle;\n";
         }
 
         //! Plots a circle using given style.
@@ -902,9 +958,8 @@ namespace rtl
         void addCircle(const Vector2f &centre, float radius, const std::string &style)
         {
             std::string style_name = saveStyle(style);
-            std::string code = "\\filldraw[" + style_name + "] (" + std::to_string(addX(centre.x())) + ", " +
-                               std::to_string(addY(centre.y())) + ") circle [radius=" + std::to_string(radius) + "];";
-            render_codes.push_back(code);
+            LaTeX::TextWriter code(render_code, number_precision);
+            code << "\\filldraw[" << style_name << "] (" << addX(centre.x()) << ", " << addY(centre.y()) << ") circle [radius=" << radius << "];\n";
         }
 
         //! Plots an ellipse using given style.
@@ -919,11 +974,9 @@ namespace rtl
         void addEllipse(const Vector2f &centre, float x_radius, float y_radius, float rotation, const std::string &style)
         {
             std::string style_name = saveStyle(style);
-            std::string code = "\\filldraw[" + style_name + "] (" + std::to_string(addX(centre.x())) + ", " +
-                               std::to_string(addY(centre.y())) + ") circle [x radius=" + std::to_string(x_radius) +
-                               ", y radius=" + std::to_string(y_radius) + ", rotate=" +
-                               std::to_string(rotation / rtl::C_PIf * 180.0f) + "];";
-            render_codes.push_back(code);
+            LaTeX::TextWriter code(render_code, number_precision);
+            code << "\\filldraw[" << style_name << "] (" << addX(centre.x()) << ", " << addY(centre.y()) << ") circle [x radius=" << x_radius << ", y radius="
+                 << y_radius << ", rotate=" << rotation / rtl::C_PIf * 180.0f << "];\n";
         }
 
         //! Plots a pie using given style.
@@ -941,13 +994,10 @@ namespace rtl
             Vector2f arc_beg(radius, 0.0f);
             Rotation2f rot(angle_beg);
             arc_beg = centre + rot(arc_beg);
-            std::string code = "\\filldraw[" + style_name + "] (" + std::to_string(addX(centre.x())) + ", " +
-                               std::to_string(addY(centre.y())) + ") -- (" + std::to_string(addX(arc_beg.x())) + "," +
-                               std::to_string(addY(arc_beg.y())) + ") arc (" +
-                               std::to_string(angle_beg / rtl::C_PIf * 180.0f) + ":" +
-                               std::to_string(angle_end / rtl::C_PIf * 180.0f) + ":" + std::to_string(radius) +
-                               ") -- cycle;";
-            render_codes.push_back(code);
+            LaTeX::TextWriter code(render_code, number_precision);
+            code << "\\filldraw[" << style_name << "] (" << addX(centre.x()) << ", " << addY(centre.y()) << ") -- ";
+            code.point(addX(arc_beg.x()), addY(arc_beg.y())) << " arc (" << angle_beg / rtl::C_PIf * 180.0f << ':' << angle_end / rtl::C_PIf * 180.0f << ':' << radius
+                                                              << ") -- cycle;\n";
         }
 
         //! Plots line given by two points using given style.
@@ -960,10 +1010,8 @@ namespace rtl
         void addLine(const Vector2f &beg, const Vector2f &end, const std::string &style)
         {
             std::string style_name = saveStyle(style);
-            std::string code =
-                    "\\draw[" + style_name + "] (" + std::to_string(addX(beg.x())) + ", " + std::to_string(addY(beg.y())) +
-                    ") -- (" + std::to_string(addX(end.x())) + ", " + std::to_string(addY(end.y())) + ");";
-            render_codes.push_back(code);
+            LaTeX::TextWriter code(render_code, number_precision);
+            code << "\\draw[" << style_name << "] (" << addX(beg.x()) << ", " << addY(beg.y()) << ") -- (" << addX(end.x()) << ", " << addY(end.y()) << ");\n";
         }
 
         //! Plots a 2D line segment using given style.
@@ -999,9 +1047,9 @@ namespace rtl
         void addText(const std::string &text, const std::string &style, const Vector2f &position)
         {
             std::string style_name = saveStyle(style);
-            std::string code = "\\node[" + style_name + "] at (" + std::to_string(addX(position.x())) + "," +
-                               std::to_string(addY(position.y())) + ") {" + text + "};";
-            render_codes.push_back(code);
+            LaTeX::TextWriter code(render_code, number_precision);
+            code << "\\node[" << style_name << "] at ";
+            code.point(addX(position.x()), addY(position.y())) << " {" << text << "};\n";
         }
 
         //! Returns maximal \a x coordinate to be plotted.
@@ -1130,7 +1178,19 @@ namespace rtl
         std::map<std::string, std::string> styles;
         std::map<std::string, std::string> marks;
         std::map<std::string, std::string> colors;
-        std::vector<std::string> render_codes;
+        //! Plot with level-of-detail simplification, formatted in writeTEX() at \a code_offset of the render code.
+        struct LodPlot
+        {
+            size_t code_offset;
+            std::vector<Vector2f> points;
+            std::string line_style_name, mark_name;
+            float line_tolerance, mark_cell;
+        };
+
+        std::string render_code;
+        std::vector<LodPlot> lod_plots;
+        int number_precision{};
+        float lod_line_tolerance{}, lod_mark_cell{};
         float scale_x{}, scale_y{}, max_x{}, min_x{}, max_y{}, min_y{};
         float mark_radius{}, export_width{}, export_height{}, export_border{};
         bool is_clipped{};
@@ -1154,10 +1214,19 @@ namespace rtl
         std::string latex_style_axis_x;
         std::string latex_style_axis_y;
 
+        [[nodiscard]] float axisX(float x) const
+        {
+            return axis_type_x == LaTeXTikz2D::axis_type_log10 ? std::log10(x) : x;
+        }
+
+        [[nodiscard]] float axisY(float y) const
+        {
+            return axis_type_y == LaTeXTikz2D::axis_type_log10 ? std::log10(y) : y;
+        }
+
         float addX(float x)
         {
-            if (axis_type_x == LaTeXTikz2D::axis_type_log10)
-                x = std::log10(x);
+            x = axisX(x);
             //x /= 10;
             if (x < min_x)
                 min_x = x;
@@ -1168,8 +1237,7 @@ namespace rtl
 
         float addY(float y)
         {
-            if (axis_type_y == LaTeXTikz2D::axis_type_log10)
-                y = std::log10(y);
+            y = axisY(y);
             //y /= 10;
             if (y < min_y)
                 min_y = y;
@@ -1214,6 +1282,68 @@ namespace rtl
             }
         }
 
+        //! Rotation of the i-th mark of a plot in degrees, given by the direction of the polyline.
+        static float markRotation(const std::vector<Vector2f> &v, size_t i)
+        {
+            size_t cnt = v.size();
+            if (cnt == 1)
+                return 0.0f;
+            else if (i == 0)
+                return Vector2f(v[1].x() - v.front().x(), v[1].y() - v.front().y()).angleFromZero() * 180.0f / rtl::C_PIf;
+            else if (i == cnt - 1)
+                return Vector2f(v.back().x() - v[cnt - 2].x(), v.back().y() - v[cnt - 2].y()).angleFromZero() * 180.0f / rtl::C_PIf;
+            float rot = Vector2f(v[i].x() - v[i - 1].x(), v[i].y() - v[i - 1].y()).angleFromZero();
+            Vector2f v1(v[i].x() - v[i - 1].x(), v[i].y() - v[i - 1].y()), v2(v[i + 1].x() - v[i].x(), v[i + 1].y() - v[i].y());
+            float rot_2 = Vector2f::angleCcw(v1, v2) / 2.0f;
+            return (rot + rot_2) * 180.0f / rtl::C_PIf;
+        }
+
+        //! Formats a plot with level-of-detail simplification for the page scales \p sx and \p sy (centimeters per unit).
+        void writeLodPlot(std::ostream &os, const LodPlot &plot, float sx, float sy) const
+        {
+            LaTeX::TextWriter code(os, number_precision);
+            std::vector<Vector2f> page;
+            page.reserve(plot.points.size());
+            for (const auto &p : plot.points)
+                page.emplace_back(axisX(p.x()) * sx, axisY(p.y()) * sy);
+
+            if (!plot.line_style_name.empty())
+            {
+                std::vector<LineSegment2f> segments;
+                if (plot.line_tolerance > 0.0f)
+                {
+                    VectorizerDouglasPeuckerND<2, float> dp(plot.line_tolerance);
+                    dp(page, segments);
+                }
+                else
+                    for (size_t i = 0; i + 1 < page.size(); i++)
+                        segments.emplace_back(page[i], page[i + 1]);
+                for (const auto &ls : segments)
+                {
+                    code << "\t\\draw[" << plot.line_style_name << "] ";
+                    code.point(ls.beg().x() / sx, ls.beg().y() / sy) << " -- ";
+                    code.point(ls.end().x() / sx, ls.end().y() / sy) << ";\n";
+                }
+            }
+
+            if (!plot.mark_name.empty())
+            {
+                std::unordered_set<uint64_t> occupied;
+                for (size_t i = 0; i < page.size(); i++)
+                {
+                    if (plot.mark_cell > 0.0f)
+                    {
+                        auto cell_x = (int64_t) std::floor(page[i].x() / plot.mark_cell), cell_y = (int64_t) std::floor(page[i].y() / plot.mark_cell);
+                        if (!occupied.insert(((uint64_t) cell_x << 32u) ^ (uint64_t) (uint32_t) cell_y).second)
+                            continue;
+                    }
+                    code << "\t\\" << plot.mark_name << '{' << axisX(plot.points[i].x()) << "}{" << axisY(plot.points[i].y()) << "}{" << markRotation(plot.points, i) << "}\n";
+                }
+            }
+
+            code << '\n';
+        }
+
         static std::string digitsToLetters(size_t num)
         {
             char buffer[50];
@@ -1311,22 +1441,24 @@ namespace rtl
     {
         std::string style_name = saveStyle(style);
 
-        std::string code;
+        LaTeX::TextWriter code(render_code, number_precision);
         for (size_t i = 0; i < edges.size(); i++)
-            code += "\t\\draw[" + style_name + "] (" + std::to_string(addX(edges[i].beg().x())) + "," +
-                    std::to_string(addY(edges[i].beg().y())) + ") -- (" + std::to_string(addX(edges[i].end().x())) +
-                    "," + std::to_string(addY(edges[i].end().y())) + ");\n";
-
-        render_codes.push_back(code);
+        {
+            code << "\t\\draw[" << style_name << "] ";
+            code.point(addX(edges[i].beg().x()), addY(edges[i].beg().y())) << " -- ";
+            code.point(addX(edges[i].end().x()), addY(edges[i].end().y())) << ";\n";
+        }
+        code << '\n';
     }
 
     template<class T>
     inline void LaTeXTikz2D::addEdge(const T &edge, const std::string &style, unsigned int)
     {
         std::string style_name = saveStyle(style);
-        render_codes.push_back("\t\\draw[" + style_name + "] (" + std::to_string(addX(edge.beg().x())) + "," +
-                               std::to_string(addY(edge.beg().y())) + ") -- (" + std::to_string(addX(edge.end().x())) +
-                               "," + std::to_string(addY(edge.end().y())) + ");\n");
+        LaTeX::TextWriter code(render_code, number_precision);
+        code << "\t\\draw[" << style_name << "] ";
+        code.point(addX(edge.beg().x()), addY(edge.beg().y())) << " -- ";
+        code.point(addX(edge.end().x()), addY(edge.end().y())) << ";\n\n";
     }
 
 }
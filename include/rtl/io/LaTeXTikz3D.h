@@ -30,10 +30,16 @@
 #include <string>
 #include <map>
 #include <list>
+#include <limits>
+#include <vector>
+#include <numeric>
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <utility>
 #include <fstream>
+#include <unordered_map>
+#include <stdexcept>
 
 #include "rtl/Core.h"
 #include "rtl/Transformation.h"
@@ -43,15 +49,48 @@ namespace rtl
     //! LaTeX export of high quality vector graphics using the Tikz package - 3D scene rendering into 2D drawing.
     /*!
      * This class is used to aggregate graphic primitives to be rendered into a PDF format. The rendering order is determined using traditional visibility testing and do not require
-     * any input from the user side. View of the scene can be set using regular translation-rotation-projection scheme.
+     * any input from the user side. View of the scene can be set using regular translation-rotation-projection scheme. Polygons are ordered by a binary space partitioning tree
+     * and lines and marks are pushed down into its cells, so the drawing order is resolved in roughly N log N time for well-behaved scenes.
+     *
+     * The same scene can be exported from several cameras at once by writeTEX() taking a list of View objects. The scene is prepared only once and the views are rendered
+     * concurrently by a user-provided executor.
      *
      * More complicated intersections of polygonal faces may result in visual artifacts appearing as darker lines. This happens, when two polygons of the same color are next to
      * each other and is a rendering bug in many .pdf viewers caused by an antialiasing algorithm. If perfect results are desired, the vector graphics can be converted to raster
      * with a suitable software (e.g. Gimp), or the generated code can be manually edited to merge the neighbouring polygons of the same style.
+     *
+     * Scenes with huge numbers of marks can be simplified by setLevelOfDetail(), which keeps only the mark closest to the camera in each occupied cell of the exported
+     * page. The binning is performed after projection, so the output size is bounded by the page resolution for any view.
      */
     class LaTeXTikz3D
     {
     public:
+        //! Camera of a rendered view - transformation of the scene and focal length derived from the field of view, see setView().
+        struct View
+        {
+            //! Default constructor, identity orientation and zero focal length.
+            View() = default;
+
+            //! Construction from transformation of the whole scene and field of view of the camera.
+            /*!
+             *
+             * @param fov field of view in degrees.
+             * @param tf transformation applied on the scene before rendering.
+             */
+            View(float fov, const RigidTf3f &tf) : orientation{tf}, focal_length{1.0f / std::tan(fov / 180.0f * rtl::C_PIf / 2.0f)} {}
+
+            //! Construction from a direction from which the scene is observed and a field of view of the camera.
+            /*!
+             * Translation is computed during export to fit the scene into the view as well as possible.
+             * @param fov field of view in degrees.
+             * @param camera_dir direction vector from which the scene is observed.
+             */
+            View(float fov, const Vector3f &camera_dir) : View(fov, RigidTf3f(Quaternionf(-Vector3f::baseZ(), camera_dir), Vector3f::nan())) {}
+
+            RigidTf3f orientation;  //!< Transformation of the scene, NaN translation is fitted to the scene during export.
+            float focal_length{};   //!< Focal length of the camera.
+        };
+
         //! Default constructor with basic initialization of the exporter.
         LaTeXTikz3D()
         {
@@ -70,15 +109,13 @@ namespace rtl
             mark_primitives.swap(le.mark_primitives);
             line_primitives.swap(le.line_primitives);
             polygon_primitives.swap(le.polygon_primitives);
-            render_primitives.swap(render_primitives);
 
             epsilon = le.epsilon;
             export_width = le.export_width;
             export_height = le.export_height;
             export_border = le.export_border;
-            focal_length = le.focal_length;
 
-            view_orientation = le.view_orientation;
+            view = le.view;
             min_reg = std::move(le.min_reg);
             max_reg = std::move(le.max_reg);
             render_reg = std::move(le.render_reg);
@@ -86,6 +123,7 @@ namespace rtl
 
             overrun_type = le.overrun_type;
             overrun_magnitude = le.overrun_magnitude;
+            lod_mark_cell = le.lod_mark_cell;
 
         }
 
@@ -125,8 +163,7 @@ namespace rtl
          */
         void setView(float fov, const RigidTf3f &orientation)
         {
-            focal_length = 1.0f / std::tan(fov / 180.0f * rtl::C_PIf / 2.0f);
-            view_orientation = orientation;
+            view = View(fov, orientation);
         }
 
         //! Sets a direction from which the scene will be observed and a field of view of the camera.
@@ -137,8 +174,7 @@ namespace rtl
          */
         void setView(float fov, const Vector3f &camera_dir)
         {
-            focal_length = 1.0f / std::tan(fov / 180.0f * rtl::C_PIf / 2.0f);
-            view_orientation = RigidTf3f(Quaternionf(-Vector3f::baseZ(), camera_dir), Vector3f::nan());
+            view = View(fov, camera_dir);
         }
 
         //! Sets free space border around content of the picture.
@@ -195,10 +231,22 @@ namespace rtl
             min_reg = std::make_unique<BoundingBox3f>(p1, p2);
         }
 
+        //! Sets level-of-detail simplification of marks.
+        /*!
+         * Only the mark closest to the camera is rendered in each square cell of the exported page, the others would be hidden below it anyway when the cell is small
+         * compared to the mark size.
+         * @param mark_cell cell size in centimeters on the exported page. Use the size of a printed dot or a screen pixel, zero disables the simplification (default).
+         */
+        void setLevelOfDetail(float mark_cell)
+        {
+            lod_mark_cell = std::max(mark_cell, 0.0f);
+        }
+
         //! Clears all settings as well as data in the exporter.
         void clearAll()
         {
             clearData();
+            lod_mark_cell = 0.0f;
             export_width = export_height = 10.0f;
             export_border = 0.1f;
             min_reg = nullptr;
@@ -214,7 +262,9 @@ namespace rtl
             colors.clear();
             adapting_objects.clear();
             fixed_objects.clear();
-            render_primitives.clear();
+            mark_primitives.clear();
+            line_primitives.clear();
+            polygon_primitives.clear();
 
             overrun_type = LaTeXTikz3D::overrun_relative;
             overrun_magnitude = 5.0f;
@@ -230,260 +280,41 @@ namespace rtl
             if (!min_reg && fixed_objects.empty())
                 return;
 
+            prepareScene();
             std::ofstream ofs;
             ofs.open(file_name, std::ofstream::out | std::ofstream::trunc);
+            renderView(view, ofs);
+            ofs.close();
+        }
 
-            // export head
-            ofs << "\\documentclass{minimal}\n"
-                   "\\usepackage[rgb]{xcolor}\n"
-                   "\\usepackage{tikz}\n"
-                   "\\usepackage[active,tightpage]{preview}\n"
-                   "\\PreviewEnvironment{tikzpicture}\n"
-                   "\\setlength\\PreviewBorder{" << std::to_string(export_border) << "cm}\n"
-                                                                                     "\n"
-                                                                                     "\\begin{document}\n"
-                                                                                     "\n"
-                                                                                     "\\begin{tikzpicture}[\n";
-
-            // export styles
-            if (!styles.empty())
-            {
-                auto it_last = --styles.end();
-                for (auto it = styles.begin(); it != it_last; it++)
-                    ofs << "\t" << it->second << "/." << it->first << ",\n";
-                ofs << "\t" << it_last->second << "/." << it_last->first << "\n";
-            }
-            ofs << "\t]\n\n";
-
-            // export clip region
-            ofs << "\t\\clip (" + std::to_string(export_width / 2) + "," + std::to_string(export_height / 2) + ") rectangle (" +
-                   std::to_string(-export_width / 2) + "," + std::to_string(-export_height / 2) + ");\n\n";
-            if(!frame_style.empty())
-                ofs << "\t\\draw[" + frame_style + "] (" + std::to_string(export_width / 2) + "," + std::to_string(export_height / 2) + ") rectangle (" +
-                       std::to_string(-export_width / 2) + "," + std::to_string(-export_height / 2) + ");\n\n";
-
-            // export colors
-            for (auto &color : colors)
-                ofs << "\t" << "\\definecolor{" + color.second + "}" + color.first << "\n";
-            ofs << "\n";
-
-            // export marks
-            for (auto &mark : marks)
-                ofs << "\t" << "\\newcommand{\\" + mark.second + "}[4]{" << mark.first << "\n\t}\n";
-            ofs << "\n";
-
-            // compute total bounding box
-            if (min_reg)
-            {
-                render_reg = std::make_unique<BoundingBox3f>(*min_reg);
-                for (const auto &fo : fixed_objects)
-                    render_reg->addBoundingBox(fo->boundingBox());
-            }
-            else
-            {
-                auto fo_it = fixed_objects.begin();
-                render_reg = std::make_unique<BoundingBox3f>((*fo_it)->boundingBox());
-                for (fo_it++;fo_it != fixed_objects.end(); fo_it++)
-                    render_reg->addBoundingBox((*fo_it)->boundingBox());
-            }
-            if (max_reg)
-                render_reg = BoundingBox3f::intersection(*render_reg, *max_reg);
-
-            // if semi-automatic view orientation is used, compute it now
-            if (view_orientation.trVec().hasNaN())
-            {
-                auto render_reg_centre = view_orientation.rotMat() * render_reg->centroid();
-                view_orientation.setTrVec({-render_reg_centre.x(), -render_reg_centre.y(), 0});
-                float aspect_ratio = export_height / export_width;
-
-                auto z_shift_required = [this, &aspect_ratio](const Vector3f &v)
-                {
-                    auto v_proj = view_orientation(v);
-                    Vector2f z_to_edge;
-                    z_to_edge.setX(-focal_length * std::abs(v_proj.x()) - v_proj.z());
-                    z_to_edge.setY(-focal_length * std::abs(v_proj.y()) / aspect_ratio - v_proj.z());
-                    return z_to_edge;
-                };
-
-                BoundingBox2f z_shift_bounds(render_reg->allVertices(z_shift_required));
-                float z_shift = std::min(z_shift_bounds.min().x(), z_shift_bounds.min().y());
-                view_orientation.setTrVec({-render_reg_centre.x(), -render_reg_centre.y(), z_shift});
-            }
-
-            // resize adapting objects
-            for (auto &ao : adapting_objects)
-                ao->fitTo(*render_reg);
-
-            // extract render primitives
-            render_primitives.clear();
-            for (auto &fo : fixed_objects)
-                fo->primitives(mark_primitives, line_primitives, polygon_primitives);
-            for (auto &ao : adapting_objects)
-                ao->primitives(mark_primitives, line_primitives, polygon_primitives);
-
-            // project render primitives
-            for (auto &mp : mark_primitives)
-                mp->project(view_orientation, focal_length);
-            for (auto &lp : line_primitives)
-                lp->project(view_orientation, focal_length);
-            for (auto &pp : polygon_primitives)
-                pp->project(view_orientation, focal_length);
-
-            // split and sort polygons
-            struct BSPNode
-            {
-                std::list<std::unique_ptr<PolygonPrimitive>> primitives;
-                std::unique_ptr<BSPNode> under{nullptr}, above{nullptr};
-            };
-
-            auto lambda_polygon_split_and_sort = [this](std::unique_ptr<BSPNode> &node) -> void
-            {
-                // added second lambda for recursive calls with auto type, see: http://pedromelendez.com/blog/2015/07/16/recursive-lambdas-in-c14/
-                auto lambda_self_ref = [this](std::unique_ptr<BSPNode> &node, const auto &lambda_self_ref) -> void
-                {
-                    node->above = std::make_unique<BSPNode>();
-                    node->under = std::make_unique<BSPNode>();
-                    auto it = std::next(node->primitives.begin());
-                    while (it != node->primitives.end())
-                    {
-                        node->primitives.front().get()->splitSort(std::move(*it), node->under->primitives, node->above->primitives, focal_length, epsilon);
-                        it = node->primitives.erase(it);
-                    }
-
-                    if (node->above->primitives.empty())
-                        node->above.reset(nullptr);
-                    else if (node->above->primitives.size() > 1)
-                        lambda_self_ref(node->above, lambda_self_ref);
-
-                    if (node->under->primitives.empty())
-                        node->under.reset(nullptr);
-                    else if (node->under->primitives.size() > 1)
-                        lambda_self_ref(node->under, lambda_self_ref);
-                };
-                lambda_self_ref(node, lambda_self_ref);
-            };
-
-            std::unique_ptr<BSPNode> root(new BSPNode);
-            root->primitives.swap(polygon_primitives);
-            if (!root->primitives.empty())
-                lambda_polygon_split_and_sort(root);
-
-            auto lambda_render = [this](std::unique_ptr<BSPNode> &node) -> void
-            {
-                // added second lambda for recursive calls with auto type, see: http://pedromelendez.com/blog/2015/07/16/recursive-lambdas-in-c14/
-                auto lambda_self_ref = [this](std::unique_ptr<BSPNode> &node, const auto &lambda_self_ref) -> void
-                {
-                    if (node->primitives.front()->frontVisible())
-                    {
-                        if (node->under)
-                            lambda_self_ref(node->under, lambda_self_ref);
-                        render_primitives.push_back(std::move(node->primitives.front()));
-                        if (node->above)
-                            lambda_self_ref(node->above, lambda_self_ref);
-                    }
-                    else
-                    {
-                        if (node->above)
-                            lambda_self_ref(node->above, lambda_self_ref);
-                        render_primitives.push_back(std::move(node->primitives.front()));
-                        if (node->under)
-                            lambda_self_ref(node->under, lambda_self_ref);
-                    }
-                };
-                lambda_self_ref(node, lambda_self_ref);
-            };
-
-            if (!root->primitives.empty())
-                lambda_render(root);
-
-            // sort lines - temporary, buggy, FIX NEEDED!!!
-            auto lambda_line_order = [this](std::unique_ptr<LinePrimitive> &rp1, std::unique_ptr<LinePrimitive> &rp2)
-            {
-                std::unique_ptr<LinePrimitive> above, under;
-                rp1->splitSort(std::move(rp2), under, above, focal_length, epsilon);
-                if (under)
-                {
-                    rp1.swap(under);
-                    rp2.swap(under);
-                    return true;
-                }
-                else
-                {
-                    rp2.swap(above);
-                    return false;
-                }
-            };
-            line_primitives.sort(lambda_line_order);
-
-            // merge lines
-            std::unique_ptr<LinePrimitive> labove, lunder;
-            while (!line_primitives.empty())
-            {
-                auto lp = std::move(line_primitives.back());
-                line_primitives.pop_back();
-
-                auto rp_rit = render_primitives.rbegin();
-                while (rp_rit != render_primitives.rend())
-                {
-                    rp_rit->get()->splitSort(std::move(lp), lunder, labove, focal_length, epsilon);
-                    if (!rp_rit->get()->frontVisible())
-                        labove.swap(lunder);
-                    if (labove)
-                        render_primitives.insert(rp_rit.base(), std::move(labove));
-                    if (!lunder)
-                        goto new_line;
-                    else
-                    {
-                        lp = std::move(lunder);
-                        rp_rit++;
-                    }
-                }
-                render_primitives.push_front(std::move(lp));
-                new_line:;
-            }
-
-            // sort marks
-            mark_primitives.sort([](const std::unique_ptr<MarkPrimitive> &rp1, const std::unique_ptr<MarkPrimitive> &rp2){ return rp1->pos_3d.lengthSquared() > rp2->pos_3d.lengthSquared();});
+        //! Writes the scene observed from multiple views into separate .tex files.
+        /*!
+         * View-independent data (bounding region, adapted axes and extracted primitives) are prepared once and shared read-only by all views, which are then projected,
+         * sorted and written concurrently by the \p executor. The view set by setView() is not affected.
+         * @tparam Executor execution policy, see rtl/core/Executor.h.
+         * @param views cameras of the exported views.
+         * @param file_names output file paths, one for each view.
+         * @param executor executor distributing the views among threads.
+         */
+        template<class Executor = SequentialExecutor>
+        void writeTEX(const std::vector<View> &views, const std::vector<std::string> &file_names, Executor executor = Executor())
+        {
+            if (views.size() != file_names.size())
+                throw std::invalid_argument("LaTeXTikz3D::writeTEX(): number of views does not match the number of file names.");
+            if (!min_reg && fixed_objects.empty())
+                return;
 
-            // merge marks into render primitives
-            std::unique_ptr<MarkPrimitive> above, under;
-            while (!mark_primitives.empty())
+            prepareScene();
+            executor(0, views.size(), [this, &views, &file_names](size_t begin, size_t end)
             {
-                auto mp = std::move(mark_primitives.back());
-                mark_primitives.pop_back();
-
-                auto rp_rit = render_primitives.rbegin();
-                while (rp_rit != render_primitives.rend())
+                for (size_t i = begin; i < end; i++)
                 {
-                    rp_rit->get()->splitSort(std::move(mp), under, above, focal_length, epsilon);
-                    if (!rp_rit->get()->frontVisible())
-                        above.swap(under);
-                    if (above)
-                    {
-                        render_primitives.insert(rp_rit.base(), std::move(above));
-                        goto new_point;
-                    }
-                    else
-                    {
-                        mp = std::move(under);
-                        rp_rit++;
-                    }
+                    std::ofstream ofs;
+                    ofs.open(file_names[i], std::ofstream::out | std::ofstream::trunc);
+                    renderView(views[i], ofs);
+                    ofs.close();
                 }
-                render_primitives.push_front(std::move(mp));
-                new_point:;
-            }
-
-            // render code
-            float scale = std::max(export_width, export_height) / 2.0f;
-            for (const auto &rp : render_primitives)
-                ofs << rp->render(scale);
-
-            // export finalization
-            ofs << "\\end{tikzpicture}"
-                   "\n"
-                   "\\end{document}\n";
-
-            ofs.close();
+            });
         }
 
         //! Adds an axis to the rendering.
@@ -651,11 +482,6 @@ namespace rtl
             virtual std::string render(float scale) = 0;
             virtual RenderPrimitive* ptr() = 0;
             virtual bool frontVisible() = 0;
-
-            virtual void splitSort(std::unique_ptr<MarkPrimitive>, std::unique_ptr<MarkPrimitive> &, std::unique_ptr<MarkPrimitive> &, float, float) {}
-            virtual void splitSort(std::unique_ptr<LinePrimitive>, std::unique_ptr<LinePrimitive> &, std::unique_ptr<LinePrimitive> &, float, float) {}
-            virtual void splitSort(std::unique_ptr<PolygonPrimitive>, std::list<std::unique_ptr<PolygonPrimitive>> &, std::list<std::unique_ptr<PolygonPrimitive>> &, float, float) {}
-
         };
 
         struct MarkPrimitive : RenderPrimitive
@@ -676,14 +502,6 @@ namespace rtl
                 return "\t\\" + mark + "{" + std::to_string(proj_2d.x() * sc) + "}{" + std::to_string(proj_2d.y() * sc) + "}{" + std::to_string(rotation) + "}{" + std::to_string(scale * sc) + "}\n";
             }
 
-            void splitSort(std::unique_ptr<MarkPrimitive> mp, std::unique_ptr<MarkPrimitive> &under, std::unique_ptr<MarkPrimitive> &above, [[maybe_unused]]float fl, [[maybe_unused]]float eps) override
-            {
-                if (pos_3d.lengthSquared() > mp->pos_3d.lengthSquared())
-                    above = std::move(mp);
-                else
-                    under = std::move(mp);
-            }
-
             MarkPrimitive* ptr() override { return this; }
             bool frontVisible() override { return true; }
 
@@ -715,61 +533,6 @@ namespace rtl
             LinePrimitive* ptr() override { return this; }
             bool frontVisible() override { return true; }
 
-            void splitSort(std::unique_ptr<MarkPrimitive> mp, std::unique_ptr<MarkPrimitive> &under, std::unique_ptr<MarkPrimitive> &above, float fl, float eps) override
-            {
-                float d = ls_3d.direction().cross(mp->pos_3d - ls_3d.beg()).lengthSquared();
-                if (d < eps)
-                {
-                    above = std::move(mp);
-                    return;
-                }
-
-                if (proj_2d.distanceToPointSquared(mp->proj_2d) < std::pow(mp->radius * mp->scale, 2))
-                {
-                    auto t_z = (mp->pos_3d.z() - ls_3d.beg().z()) / (ls_3d.end().z() - ls_3d.beg().z());
-                    auto m_plane_intersection = -Vector2f(ls_3d.end().x() - ls_3d.beg().x(), ls_3d.end().y() - ls_3d.beg().y()) * t_z * fl / mp->pos_3d.z();
-                    auto i_on_l = proj_2d.scalarProjection(m_plane_intersection);
-                    auto m_on_l = proj_2d.scalarProjection(mp->proj_2d);
-                    if ((ls_3d.direction().z() > 0) ^ (i_on_l > m_on_l))
-                        under = std::move(mp);
-                    else
-                        above = std::move(mp);
-                }
-                else
-                    under = std::move(mp); // "does not matter" is correct in principle, just used "under" in bipolar decision scheme
-            }
-
-            void splitSort(std::unique_ptr<LinePrimitive> lp, std::unique_ptr<LinePrimitive> &under, std::unique_ptr<LinePrimitive> &above, [[maybe_unused]]float fl, float eps) override
-            {
-                float t1, t2;
-                LineSegment2f::getCrossing(proj_2d, lp->proj_2d, t1, t2);
-                if (t1 > eps && t1 < 1.0 - eps && t2 > eps && t2 < 1 - eps)
-                {
-                    Vector2f crossing(proj_2d.beg() + t1 * (proj_2d.end() - proj_2d.beg()));
-                    float l1, l2;
-                    t1 = crossing.x() * ls_3d.direction().z() - ls_3d.direction().x();
-                    t2 = crossing.y() * ls_3d.direction().z() - ls_3d.direction().y();
-                    if (std::abs(t1) > std::abs(t2))
-                        l1 = (ls_3d.beg() + ls_3d.direction() * (ls_3d.beg().x() - crossing.x() * ls_3d.beg().z()) / t1).lengthSquared();
-                    else
-                        l1 = (ls_3d.beg() + ls_3d.direction() * (ls_3d.beg().y() - crossing.y() * ls_3d.beg().z()) / t2).lengthSquared();
-
-                    t1 = crossing.x() * lp->ls_3d.direction().z() - lp->ls_3d.direction().x();
-                    t2 = crossing.y() * lp->ls_3d.direction().z() - lp->ls_3d.direction().y();
-                    if (std::abs(t1) > std::abs(t2))
-                        l2 = (lp->ls_3d.beg() + lp->ls_3d.direction() * (lp->ls_3d.beg().x() - crossing.x() * lp->ls_3d.beg().z()) / t1).lengthSquared();
-                    else
-                        l2 = (lp->ls_3d.beg() + lp->ls_3d.direction() * (lp->ls_3d.beg().y() - crossing.y() * lp->ls_3d.beg().z()) / t2).lengthSquared();
-
-                    if (l1 > l2)
-                        above = std::move(lp);
-                    else
-                        under = std::move(lp);
-                }
-                else
-                    under = std::move(lp);
-            }
-
             LineSegment3f ls_3d;
             LineSegment2f proj_2d;
             std::string style;
@@ -779,16 +542,15 @@ namespace rtl
         {
             PolygonPrimitive() = default;
             PolygonPrimitive(const Polygon3Df &poly, std::string front_st, std::string back_st) : poly_3d{poly}, front_style{std::move(front_st)}, back_style{std::move(back_st)} {}
-            PolygonPrimitive(const PolygonPrimitive &pp, bool with_points = true) : poly_3d{pp.poly_3d.normal(), pp.poly_3d.distance()}, front_style{pp.front_style}, back_style{pp.back_style}, front_visible{pp.front_visible}
-            {
-                if (with_points)
-                {
-                    poly_3d.addPointsDirect(pp.poly_3d.points().begin(), pp.poly_3d.points().end());
-                    proj_2d.addPoints(pp.proj_2d.points().begin(), pp.proj_2d.points().end());
-                }
-            }
+            PolygonPrimitive(const PolygonPrimitive &pp, bool with_points = true) : poly_3d{with_points ? pp.poly_3d : Polygon3Df(pp.poly_3d.normal(), pp.poly_3d.distance())},
+                                                                                   proj_2d{with_points ? pp.proj_2d : Polygon2Df()}, front_style{pp.front_style}, back_style{pp.back_style},
+                                                                                   front_visible{pp.front_visible} {}
+            PolygonPrimitive(PolygonPrimitive &&pp) noexcept : poly_3d{std::move(pp.poly_3d)}, proj_2d{std::move(pp.proj_2d)}, front_style{std::move(pp.front_style)},
+                                                             back_style{std::move(pp.back_style)}, front_visible{pp.front_visible} {}
             ~PolygonPrimitive() override = default;
 
+            PolygonPrimitive &operator=(PolygonPrimitive &&pp) = default;
+
             void project(const RigidTf3f &tr, float fl) override
             {
                 poly_3d = tr(poly_3d);
@@ -817,69 +579,67 @@ namespace rtl
             PolygonPrimitive* ptr() override { return this; }
             bool frontVisible() override { return front_visible; }
 
-            void splitSort(std::unique_ptr<MarkPrimitive> mp, std::unique_ptr<MarkPrimitive> &under, std::unique_ptr<MarkPrimitive> &above, [[maybe_unused]]float fl, float eps) override
+            //! Returns true if the point \p pt lies above the plane of *this (or within \p eps under it).
+            [[nodiscard]] bool pointAbove(const Vector3f &pt, float eps) const
             {
-                float d = poly_3d.normal().dot(mp->pos_3d) - poly_3d.distance();
-                if (d > -eps)
-                    above = std::move(mp);
-                else
-                    under = std::move(mp);
+                return poly_3d.normal().dot(pt) - poly_3d.distance() > -eps;
             }
 
-            void splitSort(std::unique_ptr<LinePrimitive> lp, std::unique_ptr<LinePrimitive> &under, std::unique_ptr<LinePrimitive> &above, float fl, float eps) override
+            //! Sorts the line \p lp with respect to the plane of *this: returns -1 if it lies under, 1 if above and 0 if it was split into \p under and \p above pieces.
+            int splitSort(const LinePrimitive &lp, LinePrimitive &under, LinePrimitive &above, float fl, float eps) const
             {
-                float nd = poly_3d.normal().dot(lp->ls_3d.direction());
+                // quick decision for lines clearly on one side
+                float d_beg = poly_3d.normal().dot(lp.ls_3d.beg()) - poly_3d.distance(), d_end = poly_3d.normal().dot(lp.ls_3d.end()) - poly_3d.distance();
+                if (d_beg > 0 && d_end > 0)
+                    return 1;
+                if (d_beg < -eps && d_end < -eps)
+                    return -1;
+
+                float nd = poly_3d.normal().dot(lp.ls_3d.direction());
                 if (std::abs(nd) < eps)
                 {
-                    float d = poly_3d.normal().dot((lp->ls_3d.beg() + lp->ls_3d.end()) / 2.0f) - poly_3d.distance();
-                    if (d > -eps)
-                        above = std::move(lp);
-                    else
-                        under = std::move(lp);
+                    float d = poly_3d.normal().dot((lp.ls_3d.beg() + lp.ls_3d.end()) / 2.0f) - poly_3d.distance();
+                    return d > -eps ? 1 : -1;
                 }
-                else
+
+                float t = - (poly_3d.normal().dot(lp.ls_3d.beg()) + poly_3d.d()) / nd;
+                if (t > eps && t < lp.ls_3d.length() - eps)
                 {
-                    float t = - (poly_3d.normal().dot(lp->ls_3d.beg()) + poly_3d.d()) / nd;
-                    if (t > eps && t < lp->ls_3d.length() - eps)
+                    Vector3f crossing = lp.ls_3d.beg() + t * lp.ls_3d.direction();
+                    LinePrimitive ls_beg(LineSegment3f(lp.ls_3d.beg(), crossing), lp.style);
+                    ls_beg.proj_2d = LineSegment2f(-Vector2f(ls_beg.ls_3d.beg().x(), ls_beg.ls_3d.beg().y()) * fl / ls_beg.ls_3d.beg().z(),
+                                                   -Vector2f(crossing.x(), crossing.y()) * fl / crossing.z());
+                    LinePrimitive ls_end(LineSegment3f(crossing, lp.ls_3d.end()), lp.style);
+                    ls_end.proj_2d = LineSegment2f(ls_beg.proj_2d.end(), -Vector2f(ls_end.ls_3d.end().x(), ls_end.ls_3d.end().y()) * fl / ls_end.ls_3d.end().z());
+
+                    if (poly_3d.normal().dot(lp.ls_3d.beg()) - poly_3d.distance() > 0)
                     {
-                        Vector3f crossing = lp->ls_3d.beg() + t * lp->ls_3d.direction();
-                        std::unique_ptr<LinePrimitive> ls_beg(new LinePrimitive(LineSegment3f(lp->ls_3d.beg(), crossing), lp->style));
-                        ls_beg->proj_2d = LineSegment2f(-Vector2f(ls_beg->ls_3d.beg().x(), ls_beg->ls_3d.beg().y()) * fl / ls_beg->ls_3d.beg().z(),
-                                                        -Vector2f(crossing.x(), crossing.y()) * fl / crossing.z());
-                        std::unique_ptr<LinePrimitive> ls_end(new LinePrimitive(LineSegment3f(crossing, lp->ls_3d.end()), lp->style));
-                        ls_end->proj_2d = LineSegment2f(ls_beg->proj_2d.end(), -Vector2f(ls_end->ls_3d.end().x(), ls_end->ls_3d.end().y()) * fl / ls_end->ls_3d.end().z());
-
-                        if (poly_3d.normal().dot(lp->ls_3d.beg()) - poly_3d.distance() > 0)
-                        {
-                            above = std::move(ls_beg);
-                            under = std::move(ls_end);
-                        }
-                        else
-                        {
-                            above = std::move(ls_end);
-                            under = std::move(ls_beg);
-                        }
+                        above = std::move(ls_beg);
+                        under = std::move(ls_end);
                     }
                     else
                     {
-                        float d = poly_3d.normal().dot((lp->ls_3d.beg() + lp->ls_3d.end()) / 2.0f) - poly_3d.distance();
-                        if (d > 0)
-                            above = std::move(lp);
-                        else
-                            under = std::move(lp);
+                        above = std::move(ls_end);
+                        under = std::move(ls_beg);
                     }
+                    return 0;
                 }
+
+                float d = poly_3d.normal().dot((lp.ls_3d.beg() + lp.ls_3d.end()) / 2.0f) - poly_3d.distance();
+                return d > 0 ? 1 : -1;
             }
 
-            void splitSort(std::unique_ptr<PolygonPrimitive> pp, std::list<std::unique_ptr<PolygonPrimitive>> &under, std::list<std::unique_ptr<PolygonPrimitive>> &above, float fl, float eps) override
+            //! Determines the side of the plane of *this the polygon \p pp lies on: -1 under, 1 above and 0 if \p pp crosses the plane and has to be split.
+            [[nodiscard]] int side(const PolygonPrimitive &pp, float eps) const
             {
-                bool p_on_front = false, intersects = false;
+                const auto &pts = pp.poly_3d.points();
+                bool p_on_front = false;
                 size_t i = 0;
 
                 // find a point of pp more distant than eps and determine, on which side of this polygon it lies
-                for (; i < pp->poly_3d.points().size(); i++)
+                for (; i < pts.size(); i++)
                 {
-                    float d = poly_3d.normal().dot(pp->poly_3d.points()[i]) - poly_3d.distance();
+                    float d = poly_3d.normal().dot(pts[i]) - poly_3d.distance();
                     if (std::abs(d) > eps)
                     {
                         p_on_front = d > 0;
@@ -887,47 +647,30 @@ namespace rtl
                     }
                 }
 
-                if (i == pp->poly_3d.points().size()) // if none distant enough point was found, take the mean and decide
+                if (i == pts.size()) // if none distant enough point was found, take the mean and decide
                 {
                     auto v_sum = Vector3f::zeros();
-                    for (const auto &pt : pp->poly_3d.points())
+                    for (const auto &pt : pts)
                         v_sum += pt;
-                    p_on_front = poly_3d.normal().dot(v_sum / pp->poly_3d.points().size()) - poly_3d.distance() > 0;
-                }
-                else // else search for intersections of planes
-                {
-                    if (p_on_front)
-                    {
-                        for (i++; i < pp->poly_3d.points().size(); i++)
-                        {
-                            if (poly_3d.normal().dot(pp->poly_3d.points()[i]) - poly_3d.distance() < -eps)
-                            {
-                                intersects = true;
-                                break;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        for (i++; i < pp->poly_3d.points().size(); i++)
-                        {
-                            if (poly_3d.normal().dot(pp->poly_3d.points()[i]) - poly_3d.distance() > eps)
-                            {
-                                intersects = true;
-                                break;
-                            }
-                        }
-                    }
+                    return poly_3d.normal().dot(v_sum / pts.size()) - poly_3d.distance() > 0 ? 1 : -1;
                 }
 
-                if (!intersects)
+                // else search for intersections of planes
+                for (i++; i < pts.size(); i++)
                 {
-                    if (p_on_front)
-                        above.push_back(std::move(pp));
-                    else
-                        under.push_back(std::move(pp));
-                    return;
+                    float d = poly_3d.normal().dot(pts[i]) - poly_3d.distance();
+                    if (p_on_front ? d < -eps : d > eps)
+                        return 0;
                 }
+                return p_on_front ? 1 : -1;
+            }
+
+            //! Sorts the polygon \p pp with respect to the plane of *this: returns -1 if it lies under, 1 if above and 0 if it was split into pieces appended to \p under and \p above.
+            int splitSort(const PolygonPrimitive &pp, std::vector<PolygonPrimitive> &under, std::vector<PolygonPrimitive> &above, float fl, float eps) const
+            {
+                int pp_side = side(pp, eps);
+                if (pp_side != 0)
+                    return pp_side;
                 else
                 {
                     struct BrPt
@@ -950,37 +693,37 @@ namespace rtl
                     std::map<float, std::list<BrPt>::iterator> br_pts;
                     BrPt end_br_pt, tmp_br_pt;
                     Vector3f br_pt_first_3d = Vector3f::nan();
-                    Vector3f il_d = poly_3d.normal().cross(pp->poly_3d.normal()).normalized();
+                    Vector3f il_d = poly_3d.normal().cross(pp.poly_3d.normal()).normalized();
 
-                    for (size_t j = pp->proj_2d.points().size() - 1, k = 0; k < pp->proj_2d.points().size(); j = k, k++)
+                    for (size_t j = pp.proj_2d.points().size() - 1, k = 0; k < pp.proj_2d.points().size(); j = k, k++)
                     {
                         // if a point of pp lies on *this, it lies on intersection line as well
-                        float j_to_il = poly_3d.normal().dot(pp->poly_3d.points()[j]) + poly_3d.d();
+                        float j_to_il = poly_3d.normal().dot(pp.poly_3d.points()[j]) + poly_3d.d();
 
                         // if j-th point of pp lies on the intersection line, add it as a break point
                         if (std::abs(j_to_il) < eps)
                         {
                             float t = 0.0f;
                             if (br_pt_first_3d.hasNaN())
-                                br_pt_first_3d = pp->poly_3d.points()[j];
+                                br_pt_first_3d = pp.poly_3d.points()[j];
                             else
-                                t = (pp->poly_3d.points()[j] - br_pt_first_3d).dot(il_d);
-                            with_br_pts.emplace_back(pp->poly_3d.points()[j], pp->proj_2d.points()[j], t);
+                                t = (pp.poly_3d.points()[j] - br_pt_first_3d).dot(il_d);
+                            with_br_pts.emplace_back(pp.poly_3d.points()[j], pp.proj_2d.points()[j], t);
                             br_pts[t] = --with_br_pts.end();
                         }
                         else
                         {
-                            with_br_pts.emplace_back(pp->poly_3d.points()[j], pp->proj_2d.points()[j], j_to_il > 0);
+                            with_br_pts.emplace_back(pp.poly_3d.points()[j], pp.proj_2d.points()[j], j_to_il > 0);
 
                             // if k-th point of pp is not on the intersection line, check if j-to-k line segment crosses il
-                            if(std::abs(poly_3d.normal().dot(pp->poly_3d.points()[k]) + poly_3d.d()) > eps)
+                            if(std::abs(poly_3d.normal().dot(pp.poly_3d.points()[k]) + poly_3d.d()) > eps)
                             {
-                                Vector3f tmp_v3d = pp->poly_3d.points()[k] - pp->poly_3d.points()[j];
-                                float t_ls_p = -(poly_3d.normal().dot(pp->poly_3d.points()[j]) + poly_3d.d()) / poly_3d.normal().dot(tmp_v3d);
+                                Vector3f tmp_v3d = pp.poly_3d.points()[k] - pp.poly_3d.points()[j];
+                                float t_ls_p = -(poly_3d.normal().dot(pp.poly_3d.points()[j]) + poly_3d.d()) / poly_3d.normal().dot(tmp_v3d);
 
                                 if (t_ls_p > 0.0f && t_ls_p < 1.0f)
                                 {
-                                    tmp_v3d = pp->poly_3d.points()[j] + tmp_v3d * t_ls_p;
+                                    tmp_v3d = pp.poly_3d.points()[j] + tmp_v3d * t_ls_p;
 
                                     float t = 0.0f;
                                     if (br_pt_first_3d.hasNaN())
@@ -1038,7 +781,7 @@ namespace rtl
                     {
                         if (bp.second->to_above || bp.second->to_under)
                         {
-                            std::unique_ptr<PolygonPrimitive> pp_new(new PolygonPrimitive(*pp, false));
+                            PolygonPrimitive pp_new(pp, false);
                             auto first_bp = bp.second;
                             auto first_bp_to_above = first_bp->to_above;
                             auto pt_to_add = first_bp;
@@ -1046,8 +789,8 @@ namespace rtl
 
                             do
                             {
-                                pp_new->proj_2d.addPoint(pt_to_add->pt2d);
-                                pp_new->poly_3d.addPointDirect(pt_to_add->pt3d);
+                                pp_new.proj_2d.addPoint(pt_to_add->pt2d);
+                                pp_new.poly_3d.addPointDirect(pt_to_add->pt3d);
 
                                 if (pt_to_add->isOnBrLine())
                                 {
@@ -1089,6 +832,7 @@ namespace rtl
                                 under.push_back(std::move(pp_new));
                         }
                     }
+                    return 0;
                 }
             }
 
@@ -1101,7 +845,7 @@ namespace rtl
         struct RenderObj
         {
             virtual ~RenderObj() = default;
-            virtual void primitives(std::list<std::unique_ptr<MarkPrimitive>> &mp, std::list<std::unique_ptr<LinePrimitive>> &lp, std::list<std::unique_ptr<PolygonPrimitive>> &pp) = 0;
+            virtual void primitives(std::vector<MarkPrimitive> &mp, std::vector<LinePrimitive> &lp, std::vector<PolygonPrimitive> &pp) = 0;
         };
 
         struct FixedObj : public RenderObj
@@ -1119,9 +863,9 @@ namespace rtl
             Vector3f position;
             float rotation, radius;
 
-            void primitives(std::list<std::unique_ptr<MarkPrimitive>> &mp, [[maybe_unused]]std::list<std::unique_ptr<LinePrimitive>> &lp, [[maybe_unused]]std::list<std::unique_ptr<PolygonPrimitive>> &pp) override
+            void primitives(std::vector<MarkPrimitive> &mp, [[maybe_unused]]std::vector<LinePrimitive> &lp, [[maybe_unused]]std::vector<PolygonPrimitive> &pp) override
             {
-                mp.emplace_back(std::make_unique<LaTeXTikz3D::MarkPrimitive>(position, mark_name, rotation, radius));
+                mp.emplace_back(position, mark_name, rotation, radius);
             }
 
             BoundingBox3f boundingBox() override
@@ -1139,9 +883,9 @@ namespace rtl
             std::string style_name;
             LineSegment3f axis;
 
-            void primitives([[maybe_unused]]std::list<std::unique_ptr<MarkPrimitive>> &mp, std::list<std::unique_ptr<LinePrimitive>> &lp, [[maybe_unused]]std::list<std::unique_ptr<PolygonPrimitive>> &pp) override
+            void primitives([[maybe_unused]]std::vector<MarkPrimitive> &mp, std::vector<LinePrimitive> &lp, [[maybe_unused]]std::vector<PolygonPrimitive> &pp) override
             {
-                lp.emplace_back(std::make_unique<LaTeXTikz3D::LinePrimitive>(axis, style_name));
+                lp.emplace_back(axis, style_name);
             }
 
             BoundingBox3f boundingBox() override
@@ -1159,15 +903,15 @@ namespace rtl
             std::string front_style_name, back_style_name, line_style_name;
             Polygon3Df polygon;
 
-            void primitives([[maybe_unused]]std::list<std::unique_ptr<MarkPrimitive>> &mp, std::list<std::unique_ptr<LinePrimitive>> &lp, std::list<std::unique_ptr<PolygonPrimitive>> &pp) override
+            void primitives([[maybe_unused]]std::vector<MarkPrimitive> &mp, std::vector<LinePrimitive> &lp, std::vector<PolygonPrimitive> &pp) override
             {
                 if (!front_style_name.empty() || !back_style_name.empty())
-                    pp.emplace_back(std::make_unique<LaTeXTikz3D::PolygonPrimitive>(polygon, front_style_name, back_style_name));
+                    pp.emplace_back(polygon, front_style_name, back_style_name);
                 if (!line_style_name.empty())
                 {
                     size_t pts_cnt = polygon.points().size();
                     for (size_t i = pts_cnt - 1, j = 0; j < pts_cnt; i = j, j++)
-                        lp.emplace_back(std::make_unique<LaTeXTikz3D::LinePrimitive>(LineSegment3f(polygon.points()[i], polygon.points()[j]), line_style_name));
+                        lp.emplace_back(LineSegment3f(polygon.points()[i], polygon.points()[j]), line_style_name);
                 }
             }
 
@@ -1194,7 +938,7 @@ namespace rtl
             size_t axis{};
             float tick{};
 
-            void primitives([[maybe_unused]]std::list<std::unique_ptr<MarkPrimitive>> &mp, [[maybe_unused]]std::list<std::unique_ptr<LinePrimitive>> &lp, [[maybe_unused]]std::list<std::unique_ptr<PolygonPrimitive>> &pp) override
+            void primitives([[maybe_unused]]std::vector<MarkPrimitive> &mp, [[maybe_unused]]std::vector<LinePrimitive> &lp, [[maybe_unused]]std::vector<PolygonPrimitive> &pp) override
             {
 
             }
@@ -1215,9 +959,9 @@ namespace rtl
             float tick;
             LineSegment3f axis;
 
-            void primitives([[maybe_unused]]std::list<std::unique_ptr<MarkPrimitive>> &mp, std::list<std::unique_ptr<LinePrimitive>> &lp, [[maybe_unused]]std::list<std::unique_ptr<PolygonPrimitive>> &pp) override
+            void primitives([[maybe_unused]]std::vector<MarkPrimitive> &mp, std::vector<LinePrimitive> &lp, [[maybe_unused]]std::vector<PolygonPrimitive> &pp) override
             {
-                lp.emplace_back(std::make_unique<LaTeXTikz3D::LinePrimitive>(axis, style_name));
+                lp.emplace_back(axis, style_name);
             }
 
             void fitTo(const BoundingBox3f &bb) override
@@ -1232,14 +976,33 @@ namespace rtl
         std::list<std::unique_ptr<AdaptingObj>> adapting_objects;
         std::list<std::unique_ptr<FixedObj>> fixed_objects;
 
-        std::list<std::unique_ptr<MarkPrimitive>> mark_primitives;
-        std::list<std::unique_ptr<LinePrimitive>> line_primitives;
-        std::list<std::unique_ptr<PolygonPrimitive>> polygon_primitives;
-        std::list<std::unique_ptr<RenderPrimitive>> render_primitives;
+        static constexpr size_t bsp_none = std::numeric_limits<size_t>::max();
+
+        // BSP tree over polygon_primitives, empty children are the convex cells holding lines and marks, bounds cover projections of the whole subtree
+        struct BSPNode
+        {
+            size_t polygon;
+            BoundingBox2f bounds;
+            size_t under{bsp_none}, above{bsp_none};
+        };
+
+        // line or mark assigned to a cell (2 * node + 1 above, 2 * node under), depth is the squared distance of its farthest point from the camera
+        struct BSPItem
+        {
+            size_t cell;
+            float depth;
+            size_t index;
+            bool mark;
+        };
+
+        std::vector<MarkPrimitive> mark_primitives;
+        std::vector<LinePrimitive> line_primitives;
+        std::vector<PolygonPrimitive> polygon_primitives;
 
         float epsilon{0.001f};
-        float export_width{}, export_height{}, export_border{}, focal_length{};
-        RigidTf3f view_orientation;
+        float export_width{}, export_height{}, export_border{};
+        float lod_mark_cell{};
+        View view;
         std::unique_ptr<BoundingBox3f> min_reg{nullptr}, max_reg{nullptr}, render_reg{nullptr};
         std::unique_ptr<BoundingBox2f> clipping{nullptr};
         std::string frame_style;
@@ -1248,6 +1011,388 @@ namespace rtl
         unsigned int overrun_type{};
         float overrun_magnitude{};
 
+        // per-view working copies of the primitives, which are projected in place and sorted by the BSP tree
+        struct ViewRenderer
+        {
+            std::vector<MarkPrimitive> mark_primitives;
+            std::vector<LinePrimitive> line_primitives;
+            std::vector<PolygonPrimitive> polygon_primitives;
+            std::vector<BSPNode> bsp_nodes;
+            std::vector<BSPItem> bsp_items;
+            float focal_length, epsilon;
+
+            //! Keeps only the mark closest to the camera in each cell, \p cells_per_unit converts the projected coordinates to cell indices.
+            void binMarks(float cells_per_unit)
+            {
+                std::unordered_map<uint64_t, size_t> occupied;
+                occupied.reserve(mark_primitives.size());
+                size_t kept = 0;
+                for (size_t i = 0; i < mark_primitives.size(); i++)
+                {
+                    auto cell_x = (int64_t) std::floor(mark_primitives[i].proj_2d.x() * cells_per_unit), cell_y = (int64_t) std::floor(mark_primitives[i].proj_2d.y() * cells_per_unit);
+                    auto [cell, inserted] = occupied.try_emplace(((uint64_t) cell_x << 32u) ^ (uint64_t) (uint32_t) cell_y, kept);
+                    if (inserted)
+                    {
+                        if (kept != i)
+                            mark_primitives[kept] = std::move(mark_primitives[i]);
+                        kept++;
+                    }
+                    else if (mark_primitives[i].pos_3d.lengthSquared() < mark_primitives[cell->second].pos_3d.lengthSquared())
+                        mark_primitives[cell->second] = std::move(mark_primitives[i]);
+                }
+                mark_primitives.resize(kept);
+            }
+
+            //! Picks the splitting polygon from \p indices[begin, end) with the lowest cost, which penalizes splits and unbalanced subtrees evaluated on a sample of the polygons.
+            [[nodiscard]] size_t bspSplitter(const std::vector<size_t> &indices, size_t begin, size_t end) const
+            {
+                constexpr size_t candidates = 5, samples = 64, split_cost = 8;
+                size_t cnt = end - begin, c_step = std::max<size_t>(cnt / candidates, 1), s_step = std::max<size_t>(cnt / samples, 1);
+                size_t best = begin, best_cost = std::numeric_limits<size_t>::max();
+                for (size_t c = begin; c < end && best_cost > 0; c += c_step)
+                {
+                    const auto &splitter = polygon_primitives[indices[c]];
+                    size_t splits = 0;
+                    long balance = 0;
+                    for (size_t i = begin; i < end; i += s_step)
+                    {
+                        if (i == c)
+                            continue;
+                        int pp_side = splitter.side(polygon_primitives[indices[i]], epsilon);
+                        splits += pp_side == 0;
+                        balance += pp_side;
+                    }
+                    size_t cost = split_cost * splits + (size_t) std::abs(balance);
+                    if (cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best = c;
+                    }
+                }
+                return best;
+            }
+
+            //! Builds the BSP tree of projected polygon_primitives, split pieces are appended to the same array.
+            void buildBSP()
+            {
+                bsp_nodes.clear();
+                if (polygon_primitives.empty())
+                    return;
+
+                // index lists of pending subtrees are stacked in a single buffer, the one processed next always occupies its end
+                struct Task
+                {
+                    size_t parent, begin, end;
+                    bool above;
+                };
+                std::vector<size_t> indices(polygon_primitives.size()), under, above;
+                std::iota(indices.begin(), indices.end(), 0);
+                std::vector<Task> tasks{{bsp_none, 0, indices.size(), false}};
+                std::vector<PolygonPrimitive> pieces_under, pieces_above;
+                bsp_nodes.reserve(polygon_primitives.size());
+
+                while (!tasks.empty())
+                {
+                    Task task = tasks.back();
+                    tasks.pop_back();
+                    indices.resize(task.end);
+                    std::swap(indices[task.begin], indices[bspSplitter(indices, task.begin, task.end)]);
+
+                    size_t node = bsp_nodes.size();
+                    bsp_nodes.push_back({indices[task.begin], BoundingBox2f(polygon_primitives[indices[task.begin]].proj_2d.points())});
+                    if (task.parent != bsp_none)
+                        (task.above ? bsp_nodes[task.parent].above : bsp_nodes[task.parent].under) = node;
+
+                    // only the plane of the splitter is needed, a copy without points keeps it valid while the pieces are appended
+                    PolygonPrimitive splitter(polygon_primitives[indices[task.begin]], false);
+                    under.clear();
+                    above.clear();
+                    for (size_t i = task.begin + 1; i < task.end; i++)
+                    {
+                        int pp_side = splitter.splitSort(polygon_primitives[indices[i]], pieces_under, pieces_above, focal_length, epsilon);
+                        if (pp_side < 0)
+                            under.push_back(indices[i]);
+                        else if (pp_side > 0)
+                            above.push_back(indices[i]);
+                        else
+                        {
+                            // the first piece takes the place of the split polygon, the others are appended
+                            size_t slot = indices[i];
+                            auto store = [this, &slot](PolygonPrimitive &pp)
+                            {
+                                if (slot == bsp_none)
+                                {
+                                    polygon_primitives.push_back(std::move(pp));
+                                    return polygon_primitives.size() - 1;
+                                }
+                                polygon_primitives[slot] = std::move(pp);
+                                return std::exchange(slot, bsp_none);
+                            };
+                            for (auto &pp : pieces_under)
+                                under.push_back(store(pp));
+                            for (auto &pp : pieces_above)
+                                above.push_back(store(pp));
+                            pieces_under.clear();
+                            pieces_above.clear();
+                        }
+                    }
+
+                    indices.resize(task.begin);
+                    if (!under.empty())
+                    {
+                        tasks.push_back({node, indices.size(), indices.size() + under.size(), false});
+                        indices.insert(indices.end(), under.begin(), under.end());
+                    }
+                    if (!above.empty())
+                    {
+                        tasks.push_back({node, indices.size(), indices.size() + above.size(), true});
+                        indices.insert(indices.end(), above.begin(), above.end());
+                    }
+                }
+
+                // children are always created after their parents
+                for (size_t i = bsp_nodes.size(); i-- > 0;)
+                {
+                    if (bsp_nodes[i].under != bsp_none)
+                        bsp_nodes[i].bounds.addBoundingBox(bsp_nodes[bsp_nodes[i].under].bounds);
+                    if (bsp_nodes[i].above != bsp_none)
+                        bsp_nodes[i].bounds.addBoundingBox(bsp_nodes[bsp_nodes[i].above].bounds);
+                }
+            }
+
+            //! Pushes line_primitives and mark_primitives down the BSP tree into its cells, lines are split by the planes they cross on the way, unless they cannot overlap the subtree in the drawing.
+            void distributeBSP()
+            {
+                bsp_items.clear();
+                bsp_items.reserve(line_primitives.size() + mark_primitives.size());
+
+                std::vector<std::pair<size_t, size_t>> pending; // line index, node index
+                auto route = [this, &pending](size_t li, size_t node, bool above)
+                {
+                    size_t child = above ? bsp_nodes[node].above : bsp_nodes[node].under;
+                    if (child != bsp_none)
+                        pending.emplace_back(li, child);
+                    else
+                        bsp_items.push_back({2 * node + above, std::max(line_primitives[li].ls_3d.beg().lengthSquared(), line_primitives[li].ls_3d.end().lengthSquared()), li, false});
+                };
+                for (size_t i = 0; i < line_primitives.size(); i++)
+                {
+                    if (bsp_nodes.empty())
+                        bsp_items.push_back({0, std::max(line_primitives[i].ls_3d.beg().lengthSquared(), line_primitives[i].ls_3d.end().lengthSquared()), i, false});
+                    else
+                        pending.emplace_back(i, 0);
+                }
+                LinePrimitive piece_under, piece_above;
+                while (!pending.empty())
+                {
+                    auto [li, node] = pending.back();
+                    pending.pop_back();
+                    const auto &lp = line_primitives[li];
+                    const auto &splitter = polygon_primitives[bsp_nodes[node].polygon];
+                    int lp_side;
+                    if (bsp_nodes[node].bounds.intersects(BoundingBox2f(lp.proj_2d.beg(), lp.proj_2d.end())))
+                        lp_side = splitter.splitSort(lp, piece_under, piece_above, focal_length, epsilon);
+                    else
+                        lp_side = splitter.pointAbove((lp.ls_3d.beg() + lp.ls_3d.end()) / 2.0f, 0.0f) ? 1 : -1;
+                    if (lp_side != 0)
+                        route(li, node, lp_side > 0);
+                    else
+                    {
+                        line_primitives[li] = std::move(piece_under);
+                        line_primitives.push_back(std::move(piece_above));
+                        route(li, node, false);
+                        route(line_primitives.size() - 1, node, true);
+                    }
+                }
+
+                for (size_t i = 0; i < mark_primitives.size(); i++)
+                {
+                    size_t cell = 0;
+                    for (size_t node = bsp_nodes.empty() ? bsp_none : 0; node != bsp_none;)
+                    {
+                        bool above = polygon_primitives[bsp_nodes[node].polygon].pointAbove(mark_primitives[i].pos_3d, epsilon);
+                        cell = 2 * node + above;
+                        node = above ? bsp_nodes[node].above : bsp_nodes[node].under;
+                    }
+                    bsp_items.push_back({cell, mark_primitives[i].pos_3d.lengthSquared(), i, true});
+                }
+            }
+
+            //! Writes all primitives in the back-to-front order given by the BSP tree, lines and marks within a cell are ordered by depth with marks on top of lines ending at the same point.
+            void renderBSP(std::ostream &ofs, float scale)
+            {
+                std::sort(bsp_items.begin(), bsp_items.end(), [](const BSPItem &i1, const BSPItem &i2)
+                {
+                    if (i1.cell != i2.cell)
+                        return i1.cell < i2.cell;
+                    if (i1.depth != i2.depth)
+                        return i1.depth > i2.depth;
+                    return i1.mark < i2.mark;
+                });
+
+                auto render_cell = [this, &ofs, scale](size_t cell)
+                {
+                    auto it = std::lower_bound(bsp_items.begin(), bsp_items.end(), cell, [](const BSPItem &item, size_t c){ return item.cell < c; });
+                    for (; it != bsp_items.end() && it->cell == cell; it++)
+                        ofs << (it->mark ? mark_primitives[it->index].render(scale) : line_primitives[it->index].render(scale));
+                };
+
+                if (bsp_nodes.empty())
+                {
+                    render_cell(0);
+                    return;
+                }
+
+                // steps are stacked in reverse order: the far side of a splitter is painted first, then the splitter itself and the near side last
+                enum class Step { node, cell, polygon };
+                std::vector<std::pair<size_t, Step>> steps{{0, Step::node}};
+                while (!steps.empty())
+                {
+                    auto [id, step] = steps.back();
+                    steps.pop_back();
+                    if (step == Step::polygon)
+                        ofs << polygon_primitives[bsp_nodes[id].polygon].render(scale);
+                    else if (step == Step::cell)
+                        render_cell(id);
+                    else
+                    {
+                        bool front = polygon_primitives[bsp_nodes[id].polygon].frontVisible();
+                        auto push_side = [this, &steps, id = id](bool above)
+                        {
+                            size_t child = above ? bsp_nodes[id].above : bsp_nodes[id].under;
+                            if (child != bsp_none)
+                                steps.emplace_back(child, Step::node);
+                            else
+                                steps.emplace_back(2 * id + above, Step::cell);
+                        };
+                        push_side(front);
+                        steps.emplace_back(id, Step::polygon);
+                        push_side(!front);
+                    }
+                }
+            }
+        };
+
+        //! Computes the rendered region, fits adapting objects into it and extracts primitives of all objects. The result is shared by all rendered views.
+        void prepareScene()
+        {
+            // compute total bounding box
+            if (min_reg)
+            {
+                render_reg = std::make_unique<BoundingBox3f>(*min_reg);
+                for (const auto &fo : fixed_objects)
+                    render_reg->addBoundingBox(fo->boundingBox());
+            }
+            else
+            {
+                auto fo_it = fixed_objects.begin();
+                render_reg = std::make_unique<BoundingBox3f>((*fo_it)->boundingBox());
+                for (fo_it++;fo_it != fixed_objects.end(); fo_it++)
+                    render_reg->addBoundingBox((*fo_it)->boundingBox());
+            }
+            if (max_reg)
+                render_reg = BoundingBox3f::intersection(*render_reg, *max_reg);
+
+            // resize adapting objects
+            for (auto &ao : adapting_objects)
+                ao->fitTo(*render_reg);
+
+            // extract render primitives
+            mark_primitives.clear();
+            line_primitives.clear();
+            polygon_primitives.clear();
+            for (auto &fo : fixed_objects)
+                fo->primitives(mark_primitives, line_primitives, polygon_primitives);
+            for (auto &ao : adapting_objects)
+                ao->primitives(mark_primitives, line_primitives, polygon_primitives);
+        }
+
+        //! Writes the prepared scene observed from view \p camera into \p ofs. Only reads the shared data, so multiple views can be rendered concurrently.
+        void renderView(const View &camera, std::ostream &ofs) const
+        {
+            // export head
+            ofs << "\\documentclass{minimal}\n"
+                   "\\usepackage[rgb]{xcolor}\n"
+                   "\\usepackage{tikz}\n"
+                   "\\usepackage[active,tightpage]{preview}\n"
+                   "\\PreviewEnvironment{tikzpicture}\n"
+                   "\\setlength\\PreviewBorder{" << std::to_string(export_border) << "cm}\n"
+                                                                                     "\n"
+                                                                                     "\\begin{document}\n"
+                                                                                     "\n"
+                                                                                     "\\begin{tikzpicture}[\n";
+
+            // export styles
+            if (!styles.empty())
+            {
+                auto it_last = --styles.end();
+                for (auto it = styles.begin(); it != it_last; it++)
+                    ofs << "\t" << it->second << "/." << it->first << ",\n";
+                ofs << "\t" << it_last->second << "/." << it_last->first << "\n";
+            }
+            ofs << "\t]\n\n";
+
+            // export clip region
+            ofs << "\t\\clip (" + std::to_string(export_width / 2) + "," + std::to_string(export_height / 2) + ") rectangle (" +
+                   std::to_string(-export_width / 2) + "," + std::to_string(-export_height / 2) + ");\n\n";
+            if(!frame_style.empty())
+                ofs << "\t\\draw[" + frame_style + "] (" + std::to_string(export_width / 2) + "," + std::to_string(export_height / 2) + ") rectangle (" +
+                       std::to_string(-export_width / 2) + "," + std::to_string(-export_height / 2) + ");\n\n";
+
+            // export colors
+            for (auto &color : colors)
+                ofs << "\t" << "\\definecolor{" + color.second + "}" + color.first << "\n";
+            ofs << "\n";
+
+            // export marks
+            for (auto &mark : marks)
+                ofs << "\t" << "\\newcommand{\\" + mark.second + "}[4]{" << mark.first << "\n\t}\n";
+            ofs << "\n";
+
+            // if semi-automatic view orientation is used, compute it now
+            RigidTf3f orientation = camera.orientation;
+            if (orientation.trVec().hasNaN())
+            {
+                auto render_reg_centre = orientation.rotMat() * render_reg->centroid();
+                orientation.setTrVec({-render_reg_centre.x(), -render_reg_centre.y(), 0});
+                float aspect_ratio = export_height / export_width;
+
+                auto z_shift_required = [&camera, &orientation, &aspect_ratio](const Vector3f &v)
+                {
+                    auto v_proj = orientation(v);
+                    Vector2f z_to_edge;
+                    z_to_edge.setX(-camera.focal_length * std::abs(v_proj.x()) - v_proj.z());
+                    z_to_edge.setY(-camera.focal_length * std::abs(v_proj.y()) / aspect_ratio - v_proj.z());
+                    return z_to_edge;
+                };
+
+                BoundingBox2f z_shift_bounds(render_reg->allVertices(z_shift_required));
+                float z_shift = std::min(z_shift_bounds.min().x(), z_shift_bounds.min().y());
+                orientation.setTrVec({-render_reg_centre.x(), -render_reg_centre.y(), z_shift});
+            }
+
+            // project render primitives
+            ViewRenderer vr{mark_primitives, line_primitives, polygon_primitives, {}, {}, camera.focal_length, epsilon};
+            for (auto &mp : vr.mark_primitives)
+                mp.project(orientation, camera.focal_length);
+            for (auto &lp : vr.line_primitives)
+                lp.project(orientation, camera.focal_length);
+            for (auto &pp : vr.polygon_primitives)
+                pp.project(orientation, camera.focal_length);
+            if (lod_mark_cell > 0.0f)
+                vr.binMarks(std::max(export_width, export_height) / 2.0f / lod_mark_cell);
+
+            // sort polygons into a BSP tree, place lines and marks into its cells and render them back to front
+            vr.buildBSP();
+            vr.distributeBSP();
+            vr.renderBSP(ofs, std::max(export_width, export_height) / 2.0f);
+
+            // export finalization
+            ofs << "\\end{tikzpicture}"
+                   "\n"
+                   "\\end{document}\n";
+        }
+
         std::string saveStyle(const std::string &style)
         {
             if (style.empty())
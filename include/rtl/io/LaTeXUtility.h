@@ -28,16 +28,128 @@
 #define ROBOTICTEMPLATELIBRARY_LATEXUTILITY_H
 
 #include <string>
+#include <ostream>
+#include <charconv>
+#include <algorithm>
 
 namespace rtl::LaTeX
 {
+    //! Buffered text writer formatting numbers with std::to_chars.
+    /*!
+     * The writer appends text and numbers either to a std::string, or to a std::ostream through an internal buffer, which is flushed when full and on destruction.
+     * Floating point numbers are written in fixed notation with given number of decimal digits, which for the default precision of 6 digits produces the same text
+     * as std::to_string(). No temporary strings are created, so it is suitable for exporting large amounts of primitives into TEX files.
+     */
+    class TextWriter
+    {
+    public:
+        //! Construction of a writer appending to a string.
+        /*!
+         *
+         * @param str the target string, the writer appends to its current content.
+         * @param precision number of decimal digits of floating point numbers.
+         */
+        explicit TextWriter(std::string &str, int precision = 6) : int_str(&str), int_os(nullptr), int_used(0) { setPrecision(precision); }
+
+        //! Construction of a writer streaming into a std::ostream.
+        /*!
+         *
+         * @param os the target stream.
+         * @param precision number of decimal digits of floating point numbers.
+         */
+        explicit TextWriter(std::ostream &os, int precision = 6) : int_str(nullptr), int_os(&os), int_used(0) { setPrecision(precision); }
+
+        TextWriter(const TextWriter &) = delete;
+        TextWriter &operator=(const TextWriter &) = delete;
+
+        //! Destructor flushing the buffered content.
+        ~TextWriter() { flush(); }
+
+        //! Sets number of decimal digits of floating point numbers.
+        void setPrecision(int precision) { int_precision = std::clamp(precision, 0, max_precision); }
+
+        //! Number of decimal digits of floating point numbers.
+        [[nodiscard]] int precision() const { return int_precision; }
+
+        //! Writes buffered content into the target stream. Has no effect for string targets.
+        void flush()
+        {
+            if (int_os != nullptr && int_used > 0)
+                int_os->write(int_buffer, (std::streamsize) int_used);
+            int_used = 0;
+        }
+
+        //! Writes \p len characters starting at \p str.
+        TextWriter &write(const char *str, size_t len)
+        {
+            if (int_str != nullptr)
+            {
+                int_str->append(str, len);
+                return *this;
+            }
+            if (len > buffer_size - int_used)
+                flush();
+            if (len > buffer_size)
+                int_os->write(str, (std::streamsize) len);
+            else
+            {
+                std::copy(str, str + len, int_buffer + int_used);
+                int_used += len;
+            }
+            return *this;
+        }
+
+        //! Writes a single character.
+        TextWriter &operator<<(char c) { return write(&c, 1); }
+
+        //! Writes a zero-terminated string.
+        TextWriter &operator<<(const char *str) { return write(str, std::char_traits<char>::length(str)); }
+
+        //! Writes a string.
+        TextWriter &operator<<(const std::string &str) { return write(str.data(), str.size()); }
+
+        //! Writes a floating point number in fixed notation.
+        TextWriter &operator<<(float num) { return writeNumber(num, std::chars_format::fixed, int_precision); }
+
+        //! Writes a floating point number in fixed notation.
+        TextWriter &operator<<(double num) { return writeNumber(num, std::chars_format::fixed, int_precision); }
+
+        //! Writes an integer.
+        TextWriter &operator<<(int num) { return writeNumber(num); }
+
+        //! Writes an unsigned integer.
+        TextWriter &operator<<(size_t num) { return writeNumber(num); }
+
+        //! Writes a Tikz coordinate "(x,y)".
+        TextWriter &point(float x, float y) { return *this << '(' << x << ',' << y << ')'; }
+
+    private:
+        static constexpr int max_precision = 32;
+        static constexpr size_t buffer_size = 1 << 14;
+
+        template<typename T, typename... Args>
+        TextWriter &writeNumber(T num, Args... args)
+        {
+            // enough for the longest fixed notation of double
+            char str[320 + max_precision];
+            auto res = std::to_chars(str, str + sizeof(str), num, args...);
+            return write(str, res.ec == std::errc() ? size_t(res.ptr - str) : 0);
+        }
+
+        std::string *int_str;
+        std::ostream *int_os;
+        int int_precision{};
+        size_t int_used;
+        char int_buffer[buffer_size];
+    };
+
     //! Escapes LaTeX special characters in a string.
     /*!
      *
      * @param str input string.
      * @return string with escaped special characters.
      */
-    std::string escapeLaTeXCharacters(const std::string &str)
+    inline std::string escapeLaTeXCharacters(const std::string &str)
     {
         std::string out;
         for (const char c : str)
@@ -29,6 +29,8 @@
 
 #include <string>
 #include <ostream>
+#include <vector>
+#include <algorithm>
 
 #include "rtl/core/VectorND.h"
 #include "rtl/core/LineSegmentND.h"
@@ -36,6 +38,7 @@
 #include "rtl/tf/GeneralTf.h"
 #include "rtl/tf/TfTree.h"
 #include "rtl/tf/TfTreeNode.h"
+#include "rtl/tf/FlatTfTree.h"
 
 /*! \file
  *  \brief RTL export to STL streams.
@@ -211,12 +214,13 @@ std::ostream & operator<<( std::ostream & os, const rtl::GeneralTf<T, Tfs...> &g
  *
  * @tparam K Type of the key used in the node.
  * @tparam T Type of the transformation used in the node.
+ * @tparam A Type of the allocator used in the node.
  * @param os output stream.
  * @param node node to be printed.
  * @return reference to /p os.
  */
-template<typename K, typename T>
-std::ostream & operator<<( std::ostream & os, const rtl::TfTreeNode<K, T> &node)
+template<typename K, typename T, typename A>
+std::ostream & operator<<( std::ostream & os, const rtl::TfTreeNode<K, T, A> &node)
 {
     os << node.key() << "   " << node.tf();
     return os;
@@ -227,16 +231,17 @@ std::ostream & operator<<( std::ostream & os, const rtl::TfTreeNode<K, T> &node)
  *
  * @tparam K Type of keys used int the tree.
  * @tparam T Type of transformation used in the tree.
+ * @tparam A Type of the allocator used in the tree.
  * @param os output stream.
  * @param tree tree to be printed.
  * @return reference to /p os.
  */
-template<typename K, typename T>
-std::ostream & operator<<( std::ostream & os, const rtl::TfTree<K, T> &tree)
+template<typename K, typename T, typename A>
+std::ostream & operator<<( std::ostream & os, const rtl::TfTree<K, T, A> &tree)
 {
-    auto print_with_childs = [](std::ostream & os, const typename rtl::TfTree<K, T>::NodeType& n) -> void
+    auto print_with_childs = [](std::ostream & os, const typename rtl::TfTree<K, T, A>::NodeType& n) -> void
             {
-                auto print_with_childs_impl=[](std::ostream & os, const typename rtl::TfTree<K, T>::NodeType& n, const auto& print_with_childs_ref) -> void
+                auto print_with_childs_impl=[](std::ostream & os, const typename rtl::TfTree<K, T, A>::NodeType& n, const auto& print_with_childs_ref) -> void
                         {
                             for (size_t i = 0; i < n.depth(); i++) os << "\t";
                             os << n << "\n";
@@ -253,6 +258,36 @@ std::ostream & operator<<( std::ostream & os, const rtl::TfTree<K, T> &tree)
     return os;
 }
 
+//! Flat transformation tree to std::ostream. The output has the same format as for rtl::TfTree.
+/*!
+ *
+ * @tparam K Type of keys used int the tree.
+ * @tparam T Type of transformation used in the tree.
+ * @param os output stream.
+ * @param tree tree to be printed.
+ * @return reference to /p os.
+ */
+template<typename K, typename T>
+std::ostream & operator<<( std::ostream & os, const rtl::FlatTfTree<K, T> &tree)
+{
+    using Handle = typename rtl::FlatTfTree<K, T>::HandleType;
+    std::vector<Handle> stack(tree.children(tree.root()).begin(), tree.children(tree.root()).end());
+    std::reverse(stack.begin(), stack.end());
+
+    os << tree.key(tree.root()) << "\n";
+    while (!stack.empty())
+    {
+        Handle h = stack.back();
+        stack.pop_back();
+        for (size_t i = 0; i < tree.depth(h); i++) os << "\t";
+        os << tree.key(h) << "   " << tree.at(tree.key(h)) << "\n";
+        auto children = tree.children(h);
+        for (auto it = children.end(); it != children.begin();)
+            stack.push_back(*--it);
+    }
+    return os;
+}
+
 //! Line segment to std::ostream operator.
 /*!
  *
@@ -0,0 +1,418 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_IO_TEXTPARSER_H
+#define ROBOTICTEMPLATELIBRARY_IO_TEXTPARSER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rtl/core/Executor.h"
+#include "rtl/core/VectorND.h"
+#include "rtl/core/Matrix.h"
+#include "rtl/core/Quaternion.h"
+#include "rtl/core/PointCloudND.h"
+#include "rtl/tf/TranslationND.h"
+#include "rtl/tf/RotationND.h"
+#include "rtl/tf/RigidTfND.h"
+
+/*! \file
+ *  \brief Locale-free text parsing of RTL types, the reverse of StdLib.h.
+ *
+ *  All parsers are built on std::from_chars, so they do not depend on the global locale and avoid the overhead of std::istream. The single-object parsers accept the output
+ *  of the StdLib.h stream operators and follow the std::from_chars convention: they return a pointer past the consumed characters and an error code. Point-cloud files
+ *  are parsed in chunks distributed by an executor (see Executor.h) directly into the columns of PointCloudND.
+ */
+
+namespace rtl::io
+{
+    namespace detail
+    {
+        inline bool isSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+        }
+
+        inline const char *skipSpace(const char *first, const char *last)
+        {
+            while (first != last && isSpace(*first))
+                first++;
+            return first;
+        }
+
+        inline std::from_chars_result failure(const char *ptr, std::errc ec = std::errc::invalid_argument)
+        {
+            return {ptr, ec};
+        }
+
+        //! Skips whitespace and an optional \p c, reports whether \p c was found.
+        inline const char *skipOptional(const char *first, const char *last, char c, bool &found)
+        {
+            first = skipSpace(first, last);
+            found = first != last && *first == c;
+            return found ? first + 1 : first;
+        }
+
+        //! Parses a single number, leading whitespace and an explicit '+' sign are accepted.
+        template<typename E>
+        std::from_chars_result parseNumber(const char *first, const char *last, E &value)
+        {
+            first = skipSpace(first, last);
+            if (first != last && *first == '+')
+                first++;
+            return std::from_chars(first, last, value);
+        }
+
+        //! Parses \p n numbers separated by \p separator or whitespace into \p dst.
+        template<typename E>
+        std::from_chars_result parseSequence(const char *first, const char *last, E *dst, int n, char separator)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                if (i > 0)
+                {
+                    bool found;
+                    first = skipOptional(first, last, separator, found);
+                }
+                auto res = parseNumber(first, last, dst[i]);
+                if (res.ec != std::errc())
+                    return res;
+                first = res.ptr;
+            }
+            return {first, std::errc()};
+        }
+
+        //! Skips text up to and including \p tag, fails if the tag is not found.
+        inline std::from_chars_result skipPast(const char *first, const char *last, std::string_view tag)
+        {
+            auto pos = std::string_view(first, last - first).find(tag);
+            if (pos == std::string_view::npos)
+                return failure(first);
+            return {first + pos + tag.size(), std::errc()};
+        }
+    }
+
+    //! Parses VectorND in the format "[x, y, ...]" written by the StdLib.h operator<<.
+    /*!
+     * The brackets are optional and whitespace may be used instead of the commas, so plain "x y z" is accepted as well.
+     * @tparam dim dimensionality of the vector.
+     * @tparam E element type of the vector.
+     * @param first beginning of the text.
+     * @param last end of the text.
+     * @param v the parsed vector, unchanged on failure.
+     * @return pointer past the parsed text and error code, as std::from_chars.
+     */
+    template<int dim, typename E>
+    std::from_chars_result fromChars(const char *first, const char *last, VectorND<dim, E> &v)
+    {
+        bool bracket, closed;
+        first = detail::skipOptional(first, last, '[', bracket);
+        E el[dim];
+        auto res = detail::parseSequence(first, last, el, dim, ',');
+        if (res.ec != std::errc())
+            return res;
+        first = res.ptr;
+        if (bracket && (first = detail::skipOptional(first, last, ']', closed), !closed))
+            return detail::failure(first);
+        for (int i = 0; i < dim; i++)
+            v.setElement(i, el[i]);
+        return {first, std::errc()};
+    }
+
+    //! Parses Matrix in the format "[a, b; c, d]" written by the StdLib.h operator<<.
+    /*!
+     * Elements are read row by row, rows are separated by semicolons. The brackets are optional and whitespace may replace the separators.
+     * @tparam rows number of rows.
+     * @tparam cols number of columns.
+     * @tparam E element type of the matrix.
+     * @param first beginning of the text.
+     * @param last end of the text.
+     * @param m the parsed matrix, unchanged on failure.
+     * @return pointer past the parsed text and error code, as std::from_chars.
+     */
+    template<int rows, int cols, typename E>
+    std::from_chars_result fromChars(const char *first, const char *last, Matrix<rows, cols, E> &m)
+    {
+        bool bracket, found;
+        first = detail::skipOptional(first, last, '[', bracket);
+        E el[rows * cols];
+        for (int r = 0; r < rows; r++)
+        {
+            if (r > 0)
+                first = detail::skipOptional(first, last, ';', found);
+            auto res = detail::parseSequence(first, last, el + r * cols, cols, ',');
+            if (res.ec != std::errc())
+                return res;
+            first = res.ptr;
+        }
+        if (bracket && (first = detail::skipOptional(first, last, ']', found), !found))
+            return detail::failure(first);
+        for (int r = 0; r < rows; r++)
+            for (int c = 0; c < cols; c++)
+                m(r, c) = el[r * cols + c];
+        return {first, std::errc()};
+    }
+
+    //! Parses Quaternion in the format "w + xi - yj + zk" written by the StdLib.h operator<<.
+    /*!
+     * @tparam E element type of the quaternion.
+     * @param first beginning of the text.
+     * @param last end of the text.
+     * @param q the parsed quaternion, unchanged on failure.
+     * @return pointer past the parsed text and error code, as std::from_chars.
+     */
+    template<typename E>
+    std::from_chars_result fromChars(const char *first, const char *last, Quaternion<E> &q)
+    {
+        E el[4];
+        auto res = detail::parseNumber(first, last, el[0]);
+        if (res.ec != std::errc())
+            return res;
+        first = res.ptr;
+        for (int i = 1; i < 4; i++)
+        {
+            first = detail::skipSpace(first, last);
+            if (first == last || (*first != '+' && *first != '-'))
+                return detail::failure(first);
+            E sign = *first == '-' ? E(-1) : E(1);
+            res = detail::parseNumber(first + 1, last, el[i]);
+            if (res.ec != std::errc())
+                return res;
+            first = res.ptr;
+            if (first == last || *first != "ijk"[i - 1])
+                return detail::failure(first);
+            el[i] *= sign;
+            first++;
+        }
+        q = Quaternion<E>(el[0], el[1], el[2], el[3]);
+        return {first, std::errc()};
+    }
+
+    //! Parses TranslationND in the format "t: [x, y, ...]" written by the StdLib.h operator<<, the "t:" prefix is optional.
+    template<int dim, typename E>
+    std::from_chars_result fromChars(const char *first, const char *last, TranslationND<dim, E> &tr)
+    {
+        first = detail::skipSpace(first, last);
+        if (last - first >= 2 && first[0] == 't' && first[1] == ':')
+            first += 2;
+        VectorND<dim, E> v;
+        auto res = fromChars(first, last, v);
+        if (res.ec == std::errc())
+            tr.setTrVec(v);
+        return res;
+    }
+
+    //! Parses RotationND in the format "R: [rotation matrix]" written by the StdLib.h operator<<, the "R:" prefix is optional.
+    /*!
+     * The rotation matrix is taken as is. Additional fields written for 3D rotations (axis and angle) are redundant and are not consumed.
+     */
+    template<int dim, typename E>
+    std::from_chars_result fromChars(const char *first, const char *last, RotationND<dim, E> &rot)
+    {
+        first = detail::skipSpace(first, last);
+        if (last - first >= 2 && first[0] == 'R' && first[1] == ':')
+            first += 2;
+        typename RotationND<dim, E>::MatrixType m;
+        auto res = fromChars(first, last, m);
+        if (res.ec == std::errc())
+            rot.setRotMat(m);
+        return res;
+    }
+
+    //! Parses RigidTfND in the format "R: [rotation matrix] ... t: [translation]" written by the StdLib.h operator<<.
+    /*!
+     * Anything between the rotation matrix and the "t:" tag (axis and angle of 3D rotations) is skipped.
+     * @tparam dim dimensionality of the transformation.
+     * @tparam E element type of the transformation.
+     * @param first beginning of the text.
+     * @param last end of the text.
+     * @param tf the parsed transformation, unchanged on failure.
+     * @return pointer past the parsed text and error code, as std::from_chars.
+     */
+    template<int dim, typename E>
+    std::from_chars_result fromChars(const char *first, const char *last, RigidTfND<dim, E> &tf)
+    {
+        typename RigidTfND<dim, E>::RotationType rot;
+        typename RigidTfND<dim, E>::TranslationType tr;
+        auto res = fromChars(first, last, rot);
+        if (res.ec != std::errc())
+            return res;
+        res = detail::skipPast(res.ptr, last, "t:");
+        if (res.ec != std::errc())
+            return res;
+        res = fromChars(res.ptr, last, tr);
+        if (res.ec == std::errc())
+            tf = RigidTfND<dim, E>(rot, tr);
+        return res;
+    }
+
+    //! Parses an object of type \p T from the whole \p str.
+    /*!
+     * Unlike fromChars(), trailing characters other than whitespace are treated as an error. Errors are reported by throwing std::invalid_argument.
+     * @tparam T type of the object to be parsed.
+     * @param str the text.
+     * @return the parsed object.
+     */
+    template<typename T>
+    T parse(std::string_view str)
+    {
+        T ret;
+        const char *last = str.data() + str.size();
+        auto res = fromChars(str.data(), last, ret);
+        if (res.ec != std::errc() || detail::skipSpace(res.ptr, last) != last)
+            throw std::invalid_argument("rtl::io::parse(): cannot parse '" + std::string(str) + "'.");
+        return ret;
+    }
+
+    //! Parses delimited point records from \p text and appends them to \p cloud.
+    /*!
+     * Each non-empty line not starting with '#' is one point. The first \p dim fields separated by \p delimiter (whitespace around the fields is ignored) are its coordinates,
+     * further fields are ignored. With \p delimiter set to a whitespace character, any run of whitespace separates the fields.
+     *
+     * The text is split at line boundaries into as many chunks as the \p executor runs concurrently. The records in each chunk are counted first, then the cloud is resized
+     * once and every chunk writes its coordinates straight into the columns of the cloud.
+     * @tparam dim dimensionality of the points.
+     * @tparam E element type of the points.
+     * @tparam Executor executor type, see Executor.h.
+     * @param text the text to be parsed.
+     * @param cloud the cloud to receive the points.
+     * @param delimiter field delimiter.
+     * @param skip_lines number of leading lines (e.g. column headers) to be skipped.
+     * @param executor executor distributing the chunks.
+     */
+    template<int dim, typename E, class Executor = SequentialExecutor>
+    void parsePointCloud(std::string_view text, PointCloudND<dim, E> &cloud, char delimiter = ',', size_t skip_lines = 0, Executor executor = Executor())
+    {
+        const char *first = text.data(), *last = text.data() + text.size();
+        for (size_t i = 0; i < skip_lines && first != last; i++)
+        {
+            auto nl = static_cast<const char *>(std::memchr(first, '\n', last - first));
+            first = nl == nullptr ? last : nl + 1;
+        }
+
+        size_t chunk_nr = std::max<size_t>(1, std::min<size_t>(executor.concurrency(), (last - first) / 4096 + 1));
+        std::vector<const char *> bounds(chunk_nr + 1, last);
+        bounds[0] = first;
+        for (size_t c = 1; c < chunk_nr; c++)
+        {
+            const char *b = std::max(bounds[c - 1], first + (last - first) * c / chunk_nr);
+            auto nl = static_cast<const char *>(std::memchr(b, '\n', last - b));
+            bounds[c] = nl == nullptr ? last : nl + 1;
+        }
+
+        auto next_record = [](const char *p, const char *end) {
+            while (p != end)
+            {
+                const char *line_end = static_cast<const char *>(std::memchr(p, '\n', end - p));
+                if (line_end == nullptr)
+                    line_end = end;
+                const char *s = detail::skipSpace(p, line_end);
+                if (s != line_end && *s != '#')
+                    return std::make_pair(s, line_end);
+                p = line_end == end ? end : line_end + 1;
+            }
+            return std::make_pair(end, end);
+        };
+
+        std::vector<size_t> offsets(chunk_nr + 1, 0);
+        executor(0, chunk_nr, [&](size_t b, size_t e) {
+            for (size_t c = b; c < e; c++)
+                for (auto rec = next_record(bounds[c], bounds[c + 1]); rec.first != bounds[c + 1]; rec = next_record(std::min(rec.second + 1, bounds[c + 1]), bounds[c + 1]))
+                    offsets[c + 1]++;
+        });
+        size_t base = cloud.size();
+        offsets[0] = base;
+        for (size_t c = 0; c < chunk_nr; c++)
+            offsets[c + 1] += offsets[c];
+        cloud.resize(offsets[chunk_nr]);
+
+        E *columns[dim];
+        for (int d = 0; d < dim; d++)
+            columns[d] = cloud.coordData(d);
+        std::vector<size_t> failed(chunk_nr, SIZE_MAX);
+        executor(0, chunk_nr, [&](size_t b, size_t e) {
+            for (size_t c = b; c < e; c++)
+            {
+                size_t i = offsets[c];
+                for (auto rec = next_record(bounds[c], bounds[c + 1]); rec.first != bounds[c + 1]; rec = next_record(std::min(rec.second + 1, bounds[c + 1]), bounds[c + 1]), i++)
+                {
+                    const char *p = rec.first;
+                    bool ok = true;
+                    for (int d = 0; d < dim && ok; d++)
+                    {
+                        if (d > 0 && !detail::isSpace(delimiter))
+                        {
+                            p = detail::skipSpace(p, rec.second);
+                            ok = p != rec.second && *p == delimiter;
+                            p += ok;
+                        }
+                        auto res = detail::parseNumber(p, rec.second, columns[d][i]);
+                        ok = ok && res.ec == std::errc();
+                        p = res.ptr;
+                    }
+                    if (!ok || (p != rec.second && !detail::isSpace(*p) && *p != delimiter))
+                    {
+                        failed[c] = i;
+                        break;
+                    }
+                }
+            }
+        });
+
+        for (size_t c = 0; c < chunk_nr; c++)
+            if (failed[c] != SIZE_MAX)
+            {
+                cloud.resize(base);
+                throw std::invalid_argument("rtl::io::parsePointCloud(): malformed record " + std::to_string(failed[c] - base) + ".");
+            }
+    }
+
+    //! Reads a delimited point-cloud file and appends its points to \p cloud.
+    /*!
+     * The whole file is loaded into memory and parsed by parsePointCloud(), see there for the format and parameters. Throws std::runtime_error if the file cannot be read.
+     */
+    template<int dim, typename E, class Executor = SequentialExecutor>
+    void readPointCloud(const std::string &file_name, PointCloudND<dim, E> &cloud, char delimiter = ',', size_t skip_lines = 0, Executor executor = Executor())
+    {
+        std::ifstream ifs(file_name, std::ios::binary | std::ios::ate);
+        if (!ifs.is_open())
+            throw std::runtime_error("rtl::io::readPointCloud(): cannot open file '" + file_name + "'.");
+        std::string text((size_t) ifs.tellg(), '\0');
+        ifs.seekg(0);
+        ifs.read(text.data(), (std::streamsize) text.size());
+        parsePointCloud(text, cloud, delimiter, skip_lines, executor);
+    }
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_IO_TEXTPARSER_H
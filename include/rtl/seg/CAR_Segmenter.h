@@ -29,9 +29,12 @@
 
 #include <list>
 #include <vector>
-#include <map>
+#include <utility>
+#include <algorithm>
+#include <numeric>
 
 #include "rtl/Core.h"
+#include "rtl/core/Executor.h"
 
 namespace rtl
 {
@@ -49,14 +52,26 @@ namespace rtl
      * \li If one point can belong to more clusters, the clusters are merged.
      * \li If the point does not have any close enough neighbour, a new cluster is created.
      *
+     * Coordinates of the input are copied into an internal column-wise buffer and distances to all examined neighbours of a point are evaluated by one vectorized Eigen expression.
+     *
+     * Clusters are the connected components of the proximity relation, they are tracked by a union-find structure. The scan is split into angular sectors, one per
+     * worker of the Executor, which are tested in parallel. Proximities crossing the sector seams and the wrap-around point are merged afterwards, the result is
+     * therefore independent of the number of sectors. Clusters are ordered by their first point, the points of a cluster closed across the beginning of the scan
+     * start behind the largest gap in the cluster.
+     *
+     * Found clusters are stored one after another in a single buffer accessible by clusteredPoints(), clusterRanges() or clusterOffsets() give their boundaries. Clusters can be therefore passed
+     * to further processing (e.g. vectorization) as views by cluster() without copying them into separate containers.
+     *
      * @tparam Vector base VectorND specialization.
+     * @tparam Executor execution policy for the sectors of the scan, see rtl/core/Executor.h.
      */
-    template <class Vector>
+    template <class Vector, class Executor = SequentialExecutor>
     class CAR_Segmenter
     {
     public:
         typedef typename Vector::ElementType ElementType;   //!< Base type for vector elements.
         typedef Vector VectorType;                          //!< Base VectorND specialization.
+        typedef std::pair<size_t, size_t> IndexType;        //!< Type holding a pair of indices to clusteredPoints().
 
         //! Default constructor.
         CAR_Segmenter() { cluster_counter = 1; }
@@ -75,6 +90,19 @@ namespace rtl
             u_bound2 = upper_bound * upper_bound;
         }
 
+        //! Parameterized constructor with a custom executor instance.
+        /*!
+         * Sets given parameters during construction.
+         * @param step number of points tested in the proximity test.
+         * @param lower_bound minimal value of the proximity threshold.
+         * @param upper_bound maximal value of the proximity threshold.
+         * @param exec executor processing the sectors of the scan in parallel.
+         */
+        CAR_Segmenter(size_t step, ElementType lower_bound, ElementType upper_bound, Executor exec) : CAR_Segmenter(step, lower_bound, upper_bound)
+        {
+            executor = std::move(exec);
+        }
+
         //! Default destructor.
         ~CAR_Segmenter() = default;
 
@@ -104,14 +132,59 @@ namespace rtl
          *
          * @param max_size maximal size of the input.
          */
-        void setMaxSize(size_t max_size) { cluster_pertinence.reserve(max_size); }
+        void setMaxSize(size_t max_size)
+        {
+            cluster_pertinence.reserve(max_size);
+            cluster_pts.reserve(max_size);
+            if ((size_t)coords.rows() < max_size)
+                coords.resize(max_size, Eigen::NoChange);
+        }
 
         //! Gives number of available clusters after the segmentation.
         /*!
          *
          * @return number of available clusters.
          */
-        size_t clustersAvailable() { return clusters.size(); }
+        size_t clustersAvailable() { return cluster_ranges.size() - grabbed_cnt; }
+
+        //! Gives number of all clusters found by the last segmentation, including the already grabbed ones.
+        /*!
+         *
+         * @return number of clusters.
+         */
+        [[nodiscard]] size_t clusterCount() const { return cluster_ranges.size(); }
+
+        //! Points of all clusters stored one cluster after another.
+        /*!
+         *
+         * @return read-only reference to the clustered points.
+         */
+        [[nodiscard]] const std::vector<VectorType>& clusteredPoints() const { return cluster_pts; }
+
+        //! Ranges of the clusters in clusteredPoints().
+        /*!
+         * Each range is given by the first point and one behind the last point of the cluster.
+         * @return read-only reference to the ranges.
+         */
+        [[nodiscard]] const std::vector<IndexType>& clusterRanges() const { return cluster_ranges; }
+
+        //! Offsets of the clusters in clusteredPoints() in compressed sparse row layout.
+        /*!
+         * The i-th cluster occupies [clusterOffsets()[i], clusterOffsets()[i + 1]), the last element equals the number of clustered points.
+         * @return read-only reference to clusterCount() + 1 offsets.
+         */
+        [[nodiscard]] const std::vector<size_t>& clusterOffsets() const { return csr_offsets; }
+
+        //! Returns a view of one ordered and continuous cluster of points.
+        /*!
+         * The view is valid until the next call of loadData().
+         * @param i index of the cluster, less than clusterCount().
+         * @return span of the cluster's points in clusteredPoints().
+         */
+        [[nodiscard]] Span<const VectorType> cluster(size_t i) const
+        {
+            return Span<const VectorType>(cluster_pts.data() + cluster_ranges[i].first, cluster_pts.data() + cluster_ranges[i].second);
+        }
 
         //! Loads and processes a new point cloud.
         /*!
@@ -119,133 +192,225 @@ namespace rtl
          * @param points the point cloud.
          * @param origin point from which the point cloud was obtained. VectorType::zero() by default.
          */
-        void loadData(const std::vector<VectorType> &points, const VectorType &origin = VectorType::zeros())
+        void loadData(Span<const VectorType> points, const VectorType &origin = VectorType::zeros())
+        {
+            loadData(StridedSpan<const VectorType>(points), origin);
+        }
+
+        //! Loads and processes a new point cloud viewed in an external buffer.
+        /*!
+         * Requires an ordered point cloud and will test for circular continuity. The points are read directly from the viewed buffer, only the points of non-empty
+         * clusters are copied into the internal cluster storage.
+         * @param points view of the point cloud.
+         * @param origin point from which the point cloud was obtained. VectorType::zero() by default.
+         */
+        void loadData(StridedSpan<const VectorType> points, const VectorType &origin = VectorType::zeros())
         {
             if (points.empty())
                 return;
 
-            cluster_counter = 0;
-            if(cluster_pertinence.capacity() >= points.size())
-                cluster_pertinence.clear();
-            else
-                cluster_pertinence.reserve(points.size());
-            clusters.clear();
-            bool has_cluster;
-            std::vector<size_t> first_occurence;
-            ElementType dist2, scale_factor = (ElementType)step_size * 2 * C_PI<ElementType> / points.size();
+            const size_t n = points.size();
+            cluster_pts.clear();
+            cluster_ranges.clear();
+            csr_offsets.assign(1, 0);
+            grabbed_cnt = 0;
+            ElementType dist2, scale_factor = (ElementType)step_size * 2 * C_PI<ElementType> / n;
             scale_factor *= scale_factor;
 
-            // cluster pertinence search
-            for (size_t i = 0; i < points.size(); i++)
+            // structure-of-arrays copy of the input for the vectorized proximity tests
+            if ((size_t)coords.rows() < n)
+                coords.resize(n, Eigen::NoChange);
+            coords.topRows(n) = points.map().transpose().array();
+
+            // cluster pertinence search, each sector links its own points and collects the proximities crossing its seam
+            cluster_pertinence.resize(n);
+            size_t sector_cnt = std::max<size_t>(1, std::min<size_t>(executor.concurrency(), n / std::max<size_t>(step_size, 1)));
+            sector_seams.resize(sector_cnt);
+            sector_dist2.resize(sector_cnt);
+            executor(0, sector_cnt, [&](size_t s_begin, size_t s_end) {
+                for (size_t s = s_begin; s < s_end; s++)
+                    segmentSector(points, origin, scale_factor, s * n / sector_cnt, (s + 1) * n / sector_cnt, sector_seams[s], sector_dist2[s]);
+            });
+            for (const auto &seams : sector_seams)
+                for (const auto &[i, j] : seams)
+                    unite(i, j);
+
+            // close the loop
+            wrapped_roots.clear();
+            for (size_t i = 0; i < step_size && i < n; i++)
             {
-                has_cluster = false;
-                for (size_t j = 1; j < step_size; j++)
+                dist2 = scale_factor * points[i].lengthSquared();
+                if (dist2 < l_bound2)
+                    dist2 = l_bound2;
+                if (dist2 > u_bound2)
+                    dist2 = u_bound2;
+                neighbourDistances(i, n - i, i, nb_dist2);
+
+                for (size_t j = n - 1; j > n - 1 - i; j--)
                 {
-                    if (j > i)
-                        break;
-
-                    dist2 = scale_factor * VectorType::distanceSquared(points[i], origin);
-                    if (dist2 < l_bound2)
-                        dist2 = l_bound2;
-                    if (dist2 > u_bound2)
-                        dist2 = u_bound2;
-                    if (VectorType::distanceSquared(points[i], points[i - j]) < dist2)
+                    if (nb_dist2(j - (n - i)) < dist2)
                     {
-                        if (!has_cluster)
-                        {
-                            has_cluster = true;
-                            cluster_pertinence.push_back(cluster_pertinence[i - j]);
-                        }
-                        else if (cluster_pertinence[i] != cluster_pertinence[i - j])
-                        {
-                            size_t merged_cluster = cluster_pertinence[i - j], stop = first_occurence[cluster_pertinence[i - j]];
-                            for (size_t k = i - j; k >= stop && k < cluster_pertinence.size(); k--)
-                            {
-                                if (cluster_pertinence[k] == merged_cluster)
-                                {
-                                    cluster_pertinence[k] = cluster_pertinence[i];
-                                    if (k < first_occurence[cluster_pertinence[i]])
-                                        first_occurence[cluster_pertinence[i]] = k;
-                                }
-                            }
-                        }
+                        unite(i, j);
+                        wrapped_roots.push_back(i);
                     }
                 }
-                if (!has_cluster)
+            }
+            for (auto &r : wrapped_roots)
+                r = find(r);
+
+            // roots are the first points of their clusters, the parents are therefore relabeled to cluster indices in a single pass
+            first_occurence.clear();
+            for (size_t i = 0; i < n; i++)
+            {
+                if (cluster_pertinence[i] == i)
                 {
-                    cluster_pertinence.push_back(cluster_counter);
+                    cluster_pertinence[i] = first_occurence.size();
                     first_occurence.push_back(i);
-                    cluster_counter++;
                 }
+                else
+                    cluster_pertinence[i] = cluster_pertinence[cluster_pertinence[i]];
             }
+            cluster_counter = first_occurence.size();
 
-            // close the loop
-            for (size_t i = 0; i < step_size; i++)
+            // clusters closed across the beginning of the scan start behind their largest gap
+            std::sort(wrapped_roots.begin(), wrapped_roots.end());
+            wrapped_roots.erase(std::unique(wrapped_roots.begin(), wrapped_roots.end()), wrapped_roots.end());
+            for (size_t root : wrapped_roots)
             {
-                for (size_t j = points.size() - 1; j > points.size() - 1 - i; j--)
+                size_t cl = cluster_pertinence[root], last = root;
+                for (size_t i = root + 1; i < n; i++)
+                    if (cluster_pertinence[i] == cl)
+                        last = i;
+                size_t max_gap = root + n - last, prev = root;
+                for (size_t i = root + 1; i <= last; i++)
                 {
-                    dist2 = scale_factor * points[i].lengthSquared();
-                    if (dist2 < l_bound2)
-                        dist2 = l_bound2;
-                    if (dist2 > u_bound2)
-                        dist2 = u_bound2;
-                    if (VectorType::distanceSquared(points[i], points[j]) < dist2 && cluster_pertinence[i] != cluster_pertinence[j])
+                    if (cluster_pertinence[i] == cl)
                     {
-                        size_t merged_cluster = cluster_pertinence[j], stop = first_occurence[cluster_pertinence[j]];
-                        for (size_t k = j; k >= stop && k < cluster_pertinence.size(); k--)
+                        if (i - prev > max_gap)
                         {
-                            if (cluster_pertinence[k] == merged_cluster)
-                            {
-                                cluster_pertinence[k] = cluster_pertinence[i];
-                                first_occurence[cluster_pertinence[i]] = k;
-                            }
+                            max_gap = i - prev;
+                            first_occurence[cl] = i;
                         }
+                        prev = i;
                     }
                 }
             }
 
-            // sort the points to clusters
-            std::map<size_t, std::vector<VectorType>> tmp_clusters;
+            // sort the points to clusters by counting - points preceding the first occurrence of their cluster wrapped around the end of the cloud and go behind the rest
+            cluster_offsets.assign(cluster_counter + 1, 0);
             for (size_t i = 0; i < cluster_pertinence.size(); i++)
+                if (!points[i].hasNaN()) // filtration of invalid points
+                    cluster_offsets[cluster_pertinence[i] + 1]++;
+            for (size_t c = 0; c < cluster_counter; c++)
             {
-                if (points[i].hasNaN()) // filtration of invalid points
-                    continue;
-                if (first_occurence[cluster_pertinence[i]] <= i)
-                    clusters[cluster_pertinence[i]].push_back(points[i]);
-                else
-                    tmp_clusters[cluster_pertinence[i]].push_back(points[i]);
-            }
-            for (auto & tmp_cluster : tmp_clusters)
-            {
-                if (!tmp_cluster.second.empty()) // filtration of empty clusters
-                    clusters[tmp_cluster.first].insert(clusters[tmp_cluster.first].end(), std::make_move_iterator(tmp_cluster.second.begin()), std::make_move_iterator(tmp_cluster.second.end()));
+                if (cluster_offsets[c + 1] > 0) // filtration of empty clusters
+                {
+                    cluster_ranges.emplace_back(cluster_offsets[c], cluster_offsets[c] + cluster_offsets[c + 1]);
+                    csr_offsets.push_back(cluster_ranges.back().second);
+                }
+                cluster_offsets[c + 1] += cluster_offsets[c];
             }
+            cluster_pts.resize(cluster_offsets.back(), points.front());
+            for (size_t wrapped = 0; wrapped < 2; wrapped++)
+                for (size_t i = 0; i < cluster_pertinence.size(); i++)
+                    if (!points[i].hasNaN() && (first_occurence[cluster_pertinence[i]] > i) == (wrapped == 1))
+                        cluster_pts[cluster_offsets[cluster_pertinence[i]]++] = points[i];
         }
 
         //! Returns one ordered and continuous cluster of points.
         /*!
-         * The points are moved in C++ sense, which makes grabbing of the cluster fast, but the points are removed from segmenter's buffer
-         * and clustersAvailable() will return a value reduced by one after grabbing.
-         * @return moved std::vector of points, or an empty vector, if no clusters are available.
+         * The points are copied out of the segmenter's buffer and clustersAvailable() will return a value reduced by one after grabbing.
+         * Use cluster() to access the points without copying.
+         * @return std::vector of points, or an empty vector, if no clusters are available.
          */
         std::vector<VectorType> grabCluster()
         {
-            if (!clusters.empty())
+            if (grabbed_cnt < cluster_ranges.size())
             {
-                auto it = clusters.begin();
-                auto vect = std::move(it->second);
-                clusters.erase(it);
-                return vect;
+                auto cl = cluster(grabbed_cnt++);
+                return std::vector<VectorType>(cl.begin(), cl.end());
             }
             else
                 return std::vector<VectorType>();
         }
 
     private:
+        typedef Eigen::Array<ElementType, Eigen::Dynamic, VectorType::dimensionality()> CoordArray;
+        typedef Eigen::Array<ElementType, Eigen::Dynamic, 1> DistArray;
+
+        // Squared distances of the point pt_i to cnt consecutive points starting at first are stored into the head of dist. The coordinates are
+        // kept column-wise, so the whole neighbourhood is processed by a single packet-wise expression instead of per-point scalar loops.
+        void neighbourDistances(size_t pt_i, size_t first, size_t cnt, DistArray &dist) const
+        {
+            if ((size_t)dist.size() < cnt)
+                dist.resize(cnt);
+            dist.head(cnt) = (coords.middleRows(first, cnt).rowwise() - coords.row(pt_i)).square().rowwise().sum();
+        }
+
+        // Proximity tests of the points in [begin, end) with their preceding neighbours. Points within the sector are linked directly, only the parents
+        // of the sector's own points are written, so the sectors may run concurrently. Proximities reaching to the preceding sectors are stored into seams.
+        void segmentSector(const StridedSpan<const VectorType> &points, const VectorType &origin, ElementType scale_factor, size_t begin, size_t end,
+                           std::vector<IndexType> &seams, DistArray &dist)
+        {
+            std::iota(cluster_pertinence.begin() + begin, cluster_pertinence.begin() + end, begin);
+            seams.clear();
+            for (size_t i = begin; i < end; i++)
+            {
+                size_t nb_cnt = step_size > 1 ? std::min(step_size - 1, i) : 0;
+                if (nb_cnt == 0)
+                    continue;
+                ElementType dist2 = scale_factor * VectorType::distanceSquared(points[i], origin);
+                if (dist2 < l_bound2)
+                    dist2 = l_bound2;
+                if (dist2 > u_bound2)
+                    dist2 = u_bound2;
+                neighbourDistances(i, i - nb_cnt, nb_cnt, dist);
+                for (size_t j = 1; j <= nb_cnt; j++)
+                {
+                    if (dist(nb_cnt - j) < dist2)
+                    {
+                        if (i - j >= begin)
+                            unite(i, i - j);
+                        else
+                            seams.emplace_back(i, i - j);
+                    }
+                }
+            }
+        }
+
+        // Union-find over cluster_pertinence. Parents always precede their children, so the root of each cluster is its first point.
+        size_t find(size_t i)
+        {
+            while (cluster_pertinence[i] != i)
+            {
+                cluster_pertinence[i] = cluster_pertinence[cluster_pertinence[i]];
+                i = cluster_pertinence[i];
+            }
+            return i;
+        }
+
+        void unite(size_t i, size_t j)
+        {
+            i = find(i);
+            j = find(j);
+            if (i < j)
+                cluster_pertinence[j] = i;
+            else if (j < i)
+                cluster_pertinence[i] = j;
+        }
+
         size_t cluster_counter{}, step_size{};
         ElementType l_bound2{}, u_bound2{};
-        std::vector<size_t> cluster_pertinence;
-        std::map<size_t, std::vector<VectorType>> clusters;
+        Executor executor;
+        CoordArray coords;
+        DistArray nb_dist2;
+        std::vector<DistArray> sector_dist2;
+        std::vector<std::vector<IndexType>> sector_seams;
+        std::vector<size_t> cluster_pertinence, cluster_offsets, first_occurence, wrapped_roots;
+        std::vector<size_t> csr_offsets{0};
+        std::vector<VectorType> cluster_pts;
+        std::vector<IndexType> cluster_ranges;
+        size_t grabbed_cnt{};
     };
 }
 
@@ -30,6 +30,10 @@
 #include <list>
 #include <vector>
 #include <map>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
 
 #include "rtl/Core.h"
 
@@ -49,6 +53,16 @@ namespace rtl
      * \li If the point does not have any close enough neighbour, a new alive cluster is created.
      * \li The cluster expanded with a new point the longest time ago is checked and is its last update happened setStep() points before, it is moved from alive clusters to closed clusters and cannot be expanded any more.
      *
+     * The last setStep() points are kept in a contiguous column-wise buffer, so distances from a new point to all of them are evaluated by one vectorized Eigen expression.
+     *
+     * By default, closed clusters are kept as separate vectors to be grabbed one by one. With setFlatOutput() enabled, closed clusters are appended one after another into
+     * a single buffer clusteredPoints() delimited by clusterOffsets() instead, which may be passed e.g. to the VectorizerBatch directly. The buffer keeps its capacity after
+     * clearClusters() and storage of the alive clusters is recycled, so no allocations take place once the buffers have grown to the size of a typical scan.
+     *
+     * For endless streams, setPool() switches the segmenter to a fixed-capacity pool mode. Points leaving the window are stored into preallocated slots of the pool, each closed
+     * cluster is handed to a callback as a view and its slots are recycled, so the memory use stays constant no matter how long the stream runs. If the pool runs out of slots,
+     * the stored part of the cluster being extended is handed to the callback prematurely and the cluster continues in the released slots.
+     *
      * @tparam Vector base VectorND specialization.
      */
     template <class Vector>
@@ -129,6 +143,110 @@ namespace rtl
          */
         const std::map<size_t , std::vector<VectorType>>& aliveClusters() const { return  clusters_alive; }
 
+        //! Switches between grabbing of separate closed clusters and the flat output of all closed clusters in a single buffer.
+        /*!
+         *
+         * @param flat if true, the following closed clusters are appended to clusteredPoints() instead of being available to grabCluster().
+         */
+        void setFlatOutput(bool flat) { flat_output = flat; }
+
+        //! Whether the closed clusters are appended into the flat output.
+        [[nodiscard]] bool flatOutput() const { return flat_output; }
+
+        //! Number of closed clusters in the flat output.
+        /*!
+         *
+         * @return number of clusters in clusteredPoints().
+         */
+        [[nodiscard]] size_t clusterCount() const { return csr_offsets.size() - 1; }
+
+        //! Points of the closed clusters in the flat output stored one cluster after another.
+        /*!
+         *
+         * @return read-only reference to the clustered points.
+         */
+        [[nodiscard]] const std::vector<VectorType>& clusteredPoints() const { return cluster_pts; }
+
+        //! Offsets of the clusters in clusteredPoints() in compressed sparse row layout.
+        /*!
+         * The i-th cluster occupies [clusterOffsets()[i], clusterOffsets()[i + 1]), the last element equals the number of clustered points.
+         * @return read-only reference to clusterCount() + 1 offsets.
+         */
+        [[nodiscard]] const std::vector<size_t>& clusterOffsets() const { return csr_offsets; }
+
+        //! Returns a view of one closed cluster in the flat output.
+        /*!
+         * The view is valid until the next call of addPoint() or clearClusters().
+         * @param i index of the cluster, less than clusterCount().
+         * @return span of the cluster's points in clusteredPoints().
+         */
+        [[nodiscard]] Span<const VectorType> cluster(size_t i) const
+        {
+            return Span<const VectorType>(cluster_pts.data() + csr_offsets[i], cluster_pts.data() + csr_offsets[i + 1]);
+        }
+
+        //! Removes all clusters from the flat output, the buffers keep their capacity.
+        void clearClusters()
+        {
+            cluster_pts.clear();
+            csr_offsets.resize(1);
+        }
+
+        //! Switches to the fixed-capacity pool mode, or back to the dynamic storage of clusters.
+        /*!
+         * Alive clusters are moved into the pool, closed clusters not yet grabbed remain available. Switching to the pool mode allocates all the memory the segmenter
+         * needs for the stream at once.
+         * @param capacity number of point slots of the pool, zero switches the pool mode off.
+         * @param callback invokable with Span<const VectorType> receiving closed clusters, the view is valid only during the call.
+         */
+        void setPool(size_t capacity, std::function<void(Span<const VectorType>)> callback)
+        {
+            if (capacity > 0 && !callback)
+                throw std::invalid_argument("IA_Segmenter: pool mode requires a callback.");
+            pool_callback = std::move(callback);
+
+            // stored points of the alive clusters are taken out of the old pool
+            while (!clusters_pooled.empty())
+            {
+                auto node = clusters_pooled.extract(clusters_pooled.begin());
+                auto &pts = clusters_alive[node.key()];
+                for (size_t slot = node.mapped().head; slot != npos; slot = pool_next[slot])
+                    pts.push_back(pool_pts[slot]);
+                node.mapped() = SlotChain();
+                chain_pool.push_back(std::move(node));
+            }
+
+            pool_pts.resize(capacity);
+            pool_next.resize(capacity);
+            pool_gather.reserve(capacity);
+            pool_free = npos;
+            for (size_t i = capacity; i-- > 0; )
+            {
+                pool_next[i] = pool_free;
+                pool_free = i;
+            }
+            if (capacity > 0)
+            {
+                auto alive = std::move(clusters_alive);
+                clusters_alive.clear();
+                for (const auto &[id, pts] : alive)
+                    for (const auto &p : pts)
+                        storePoint(id, p);
+            }
+
+            // the window is grown to its final size in advance
+            if ((size_t)win_pts.rows() < 2 * (step_size + 1))
+            {
+                win_pts.conservativeResize(2 * (step_size + 1), Eigen::NoChange);
+                win_pert.resize(win_pts.rows());
+            }
+            if ((size_t)win_dist2.size() < step_size + 1)
+                win_dist2.resize(step_size + 1);
+        }
+
+        //! Number of point slots of the pool, zero if the pool mode is off.
+        [[nodiscard]] size_t poolCapacity() const { return pool_pts.size(); }
+
         //! Processes a new point and adds it to appropriate cluster.
         /*!
          *
@@ -138,10 +256,10 @@ namespace rtl
         void addPoint(const VectorType &pt, const VectorType &origin = VectorType::zeros())
         {
             bool has_cluster = false;
-            size_t cl_p = -1;
+            size_t cl_p = -1, win_cnt = win_end - win_beg;
 
             // cluster pertinence search
-            for (auto it = points.begin(); it != points.end(); it++)
+            if (win_cnt > 0)
             {
                 ElementType  dist2 = scale_factor2 * VectorType::distanceSquared(pt, origin);
                 if (dist2 < l_bound2)
@@ -149,23 +267,39 @@ namespace rtl
                 if (dist2 > u_bound2)
                     dist2 = u_bound2;
 
-                if (VectorType::distanceSquared(pt, it->pt) < dist2)
+                if ((size_t)win_dist2.size() < win_cnt)
+                    win_dist2.resize(win_cnt);
+                win_dist2.head(win_cnt) = (win_pts.middleRows(win_beg, win_cnt).rowwise() - pt.data().transpose().array()).square().rowwise().sum();
+
+                for (size_t i = 0; i < win_cnt; i++)
                 {
-                    if (!has_cluster)
-                    {
-                        has_cluster = true;
-                        cl_p = it->pert;
-                    }
-                    else if (cl_p != it->pert)
+                    if (win_dist2(i) < dist2)
                     {
-                        for (auto merge_it = points.begin(); merge_it != points.end(); merge_it++)
+                        size_t it_pert = win_pert[win_beg + i];
+                        if (!has_cluster)
                         {
-                            if (merge_it->pert == cl_p)
+                            has_cluster = true;
+                            cl_p = it_pert;
+                        }
+                        else if (cl_p != it_pert)
+                        {
+                            // points of the window are moved to the other cluster, the already stored part of the emptied one is closed
+                            size_t moved = 0;
+                            for (size_t m = win_beg; m < win_end; m++)
                             {
-                                merge_it->pert = it->pert;
+                                if (win_pert[m] == cl_p)
+                                {
+                                    win_pert[m] = it_pert;
+                                    moved++;
+                                }
                             }
+                            pooledEntry(clusters_alive_refs, refs_pool, it_pert) += moved;
+                            auto &refs = pooledEntry(clusters_alive_refs, refs_pool, cl_p);
+                            refs -= moved;
+                            if (refs == 0)
+                                closeCluster(cl_p);
+                            cl_p = it_pert;
                         }
-                        cl_p = it->pert;
                     }
                 }
             }
@@ -175,24 +309,18 @@ namespace rtl
                 cl_p = cluster_counter++;
             }
 
-            PointPert pp;
-            pp.pt = pt;
-            pp.pert = cl_p;
-            points.emplace_back(pp);
-            clusters_alive_refs[cl_p]++;
+            pushPoint(pt, cl_p);
+            pooledEntry(clusters_alive_refs, refs_pool, cl_p)++;
 
-            if (points.size() > step_size)
+            if (win_end - win_beg > step_size)
             {
-                auto to_cl = points.front();
-                points.pop_front();
-                clusters_alive[to_cl.pert].push_back(to_cl.pt);
-                clusters_alive_refs[to_cl.pert]--;
+                size_t to_cl = win_pert[win_beg];
+                storePoint(to_cl, VectorType(typename VectorType::EigenType(win_pts.row(win_beg).transpose().matrix())));
+                win_beg++;
+                auto &refs = pooledEntry(clusters_alive_refs, refs_pool, to_cl);
 
-                if (clusters_alive_refs[to_cl.pert] == 0)
-                {
-                    auto closed_cl = clusters_alive.extract(to_cl.pert);
-                    clusters_closed.insert(std::move(closed_cl));
-                }
+                if (--refs == 0)
+                    closeCluster(to_cl);
             }
         }
 
@@ -215,18 +343,162 @@ namespace rtl
                 return std::vector<VectorType>();
         }
 
+        //! Returns a view of the cluster, which would be returned by grabCluster().
+        /*!
+         * Allows to process the cluster in place, e.g. by a vectorizer, and release it by popCluster() afterwards. The view is valid until the cluster is popped or grabbed.
+         * @return span of the cluster's points, or an empty span, if no clusters are available.
+         */
+        [[nodiscard]] Span<const VectorType> frontCluster() const
+        {
+            if (!clusters_closed.empty())
+                return Span<const VectorType>(clusters_closed.begin()->second);
+            else
+                return Span<const VectorType>();
+        }
+
+        //! Removes the cluster, which would be returned by grabCluster(), without returning it.
+        void popCluster()
+        {
+            if (!clusters_closed.empty())
+                clusters_closed.erase(clusters_closed.begin());
+        }
+
     private:
-        struct PointPert
+        typedef Eigen::Array<ElementType, Eigen::Dynamic, VectorType::dimensionality()> CoordArray;
+        typedef Eigen::Array<ElementType, Eigen::Dynamic, 1> DistArray;
+
+        // Appends a point behind the end of the window. The window occupies rows [win_beg, win_end) of a column-wise coordinate buffer, so the proximity test
+        // runs over one contiguous block. When the buffer end is reached, the window is moved back to its beginning, or the buffer grows if it is full.
+        void pushPoint(const VectorType &pt, size_t pert)
+        {
+            if (win_end == (size_t)win_pts.rows())
+            {
+                size_t win_cnt = win_end - win_beg;
+                if (win_beg > 0)
+                {
+                    win_pts.topRows(win_cnt) = win_pts.middleRows(win_beg, win_cnt).eval();
+                    std::copy(win_pert.begin() + win_beg, win_pert.begin() + win_end, win_pert.begin());
+                }
+                if (win_cnt == (size_t)win_pts.rows())
+                {
+                    size_t new_rows = std::max<size_t>(2 * win_pts.rows(), 2 * (step_size + 1));
+                    win_pts.conservativeResize(new_rows, Eigen::NoChange);
+                    win_pert.resize(new_rows);
+                }
+                win_beg = 0;
+                win_end = win_cnt;
+            }
+            win_pts.row(win_end) = pt.data().transpose().array();
+            win_pert[win_end] = pert;
+            win_end++;
+        }
+
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        //! Chain of pool slots holding the stored points of an alive cluster in the pool mode.
+        struct SlotChain
         {
-            VectorType pt;
-            size_t pert;
+            size_t head{npos}, tail{npos};
         };
 
+        // Stores a point leaving the window into the alive cluster it belongs to.
+        void storePoint(size_t cl, const VectorType &pt)
+        {
+            if (pool_pts.empty())
+            {
+                pooledEntry(clusters_alive, alive_pool, cl).push_back(pt);
+                return;
+            }
+            if (pool_free == npos)
+                emitChain(clusters_pooled.count(cl) > 0 ? cl : clusters_pooled.begin()->first);
+            size_t slot = pool_free;
+            pool_free = pool_next[slot];
+            pool_pts[slot] = pt;
+            pool_next[slot] = npos;
+            auto &chain = pooledEntry(clusters_pooled, chain_pool, cl);
+            if (chain.tail == npos)
+                chain.head = slot;
+            else
+                pool_next[chain.tail] = slot;
+            chain.tail = slot;
+        }
+
+        // Hands the stored points of the cluster in the pool to the callback and releases its slots.
+        void emitChain(size_t cl)
+        {
+            auto it = clusters_pooled.find(cl);
+            if (it == clusters_pooled.end())
+                return;
+            pool_gather.clear();
+            for (size_t slot = it->second.head; slot != npos; slot = pool_next[slot])
+                pool_gather.push_back(pool_pts[slot]);
+            pool_next[it->second.tail] = pool_free;
+            pool_free = it->second.head;
+            auto node = clusters_pooled.extract(it);
+            node.mapped() = SlotChain();
+            chain_pool.push_back(std::move(node));
+            pool_callback(Span<const VectorType>(pool_gather));
+        }
+
+        // Moves the cluster from alive to closed ones, according to the output mode.
+        void closeCluster(size_t cl)
+        {
+            auto refs_node = clusters_alive_refs.extract(cl);
+            if (!refs_node.empty())
+                refs_pool.push_back(std::move(refs_node));
+            if (!pool_pts.empty())
+            {
+                emitChain(cl);
+                return;
+            }
+            auto closed_cl = clusters_alive.extract(cl);
+            if (closed_cl.empty())
+                return;
+            if (flat_output)
+            {
+                cluster_pts.insert(cluster_pts.end(), closed_cl.mapped().begin(), closed_cl.mapped().end());
+                csr_offsets.push_back(cluster_pts.size());
+                closed_cl.mapped().clear();
+                alive_pool.push_back(std::move(closed_cl));
+            }
+            else
+                clusters_closed.insert(std::move(closed_cl));
+        }
+
+        // Returns the entry of the map with given key. A missing entry is created from a node released earlier, if there is any, so the map does not allocate.
+        template<class Map, class Pool>
+        static typename Map::mapped_type &pooledEntry(Map &map, Pool &pool, size_t key)
+        {
+            auto it = map.find(key);
+            if (it != map.end())
+                return it->second;
+            if (pool.empty())
+                return map[key];
+            auto node = std::move(pool.back());
+            pool.pop_back();
+            node.key() = key;
+            return map.insert(std::move(node)).position->second;
+        }
+
         size_t cluster_counter{}, step_size{};
         ElementType l_bound2{}, u_bound2{}, scale_factor2{};
-        std::list<PointPert> points;
+        CoordArray win_pts;
+        std::vector<size_t> win_pert;
+        size_t win_beg{}, win_end{};
+        DistArray win_dist2;
         std::map<size_t , std::vector<VectorType>> clusters_closed, clusters_alive;
         std::map<size_t , size_t> clusters_alive_refs;
+        std::vector<typename std::map<size_t , std::vector<VectorType>>::node_type> alive_pool;
+        std::vector<typename std::map<size_t , size_t>::node_type> refs_pool;
+        std::map<size_t , SlotChain> clusters_pooled;
+        std::vector<typename std::map<size_t , SlotChain>::node_type> chain_pool;
+        std::vector<VectorType> pool_pts, pool_gather;
+        std::vector<size_t> pool_next;
+        size_t pool_free{npos};
+        std::function<void(Span<const VectorType>)> pool_callback;
+        bool flat_output{false};
+        std::vector<VectorType> cluster_pts;
+        std::vector<size_t> csr_offsets{0};
     };
 }
 #endif // ROBOTICTEMPLATELIBRARY_SEG_IA_SEGMENTER_H
@@ -0,0 +1,264 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_SEG_MRA_SEGMENTER_H
+#define ROBOTICTEMPLATELIBRARY_SEG_MRA_SEGMENTER_H
+
+#include <vector>
+#include <utility>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+
+#include "rtl/Core.h"
+#include "rtl/core/Executor.h"
+
+namespace rtl
+{
+    //! Segmenter class for partitioning of organized multi-ring scans into continuous clusters.
+    /*!
+     * The abbreviation stands for:
+     * \li Multi-Ring - works on scans of rotating multi-beam sensors organized into a range image, one row per ring.
+     * \li Adaptive - point neighbourhood scales with distance from the origin.
+     *
+     * The MRA_Segmenter generalizes the CAR_Segmenter to whole 3D scans, so objects spanning several rings do not have to be merged from per-ring clusters. The
+     * criterion of continuity is the same proximity test:
+     * \li Distance threshold is computed - it is proportional to the number of neighbour points examined given by setStepSize() and a distance of the point of
+     * interest from origin (specified in loadData() third parameter).
+     * \li Distance threshold is clipped by the lower and upper bounds specified during construction or explicitly by setLowerBound() or setUpperBound().
+     * \li The preceding setStepSize() - 1 points of the same ring and the points of the preceding ring within setRingWindow() columns are examined. Rings are
+     * closed, so the first columns are tested against the last ones.
+     * \li If a point-neighbour distance is lower than the threshold, they are set to belong to the same cluster.
+     *
+     * Clusters are the connected components of the proximity relation, found by a union-find structure. The rings are split into blocks, one per worker of the
+     * Executor, which are processed in parallel. Proximities crossing the block borders are merged afterwards, so the result does not depend on the number of
+     * blocks. The result is a flat array of labels, one per point, with clusters numbered by their first point. Invalid points (containing NaN) are labeled by
+     * invalid_label and are not counted.
+     *
+     * @tparam Vector base VectorND specialization.
+     * @tparam Executor execution policy for the blocks of rings, see rtl/core/Executor.h.
+     */
+    template <class Vector, class Executor = SequentialExecutor>
+    class MRA_Segmenter
+    {
+    public:
+        typedef typename Vector::ElementType ElementType;   //!< Base type for vector elements.
+        typedef Vector VectorType;                          //!< Base VectorND specialization.
+
+        static constexpr size_t invalid_label = std::numeric_limits<size_t>::max();    //!< Label of invalid points.
+
+        //! Default constructor.
+        MRA_Segmenter() = default;
+
+        //! Parameterized constructor.
+        /*!
+         * Sets given parameters during construction.
+         * @param step number of points of the same ring tested in the proximity test.
+         * @param lower_bound minimal value of the proximity threshold.
+         * @param upper_bound maximal value of the proximity threshold.
+         * @param exec executor processing the blocks of rings in parallel.
+         */
+        MRA_Segmenter(size_t step, ElementType lower_bound, ElementType upper_bound, Executor exec = Executor()) : executor(std::move(exec))
+        {
+            (step == 0) ? step_size = 1 : step_size = step;
+            l_bound2 = lower_bound * lower_bound;
+            u_bound2 = upper_bound * upper_bound;
+        }
+
+        //! Default destructor.
+        ~MRA_Segmenter() = default;
+
+        //! Sets number of points of the same ring tested in the proximity test.
+        /*!
+         *
+         * @param step new number of tested points.
+         */
+        void setStepSize(size_t step) { step_size = step; }
+
+        //! Sets lower bound in the proximity test.
+        /*!
+         *
+         * @param lb new lower bound value.
+         */
+        void setLowerBound(ElementType lb) { l_bound2 = lb * lb; }
+
+        //! Sets upper bound in the proximity test.
+        /*!
+         *
+         * @param ub new upper bound value.
+         */
+        void setUpperBound(ElementType ub) { u_bound2 = ub * ub; }
+
+        //! Sets the number of columns on each side tested in the preceding ring.
+        /*!
+         *
+         * @param window new half-width of the tested window, 0 tests only the point in the same column.
+         */
+        void setRingWindow(size_t window) { ring_window = window; }
+
+        //! Gives number of clusters found by the last segmentation.
+        /*!
+         *
+         * @return number of clusters.
+         */
+        [[nodiscard]] size_t clusterCount() const { return cluster_counter; }
+
+        //! Labels of all points of the last segmentation.
+        /*!
+         * Labels are indices of the clusters in [0, clusterCount()) ordered by the first point of each cluster, or invalid_label for invalid points.
+         * @return read-only reference to the labels, stored in the same order as the input points.
+         */
+        [[nodiscard]] const std::vector<size_t>& labels() const { return point_labels; }
+
+        //! Loads and processes a new scan.
+        /*!
+         * @param points the scan organized ring by ring, each ring holds the same number of points ordered by the azimuth.
+         * @param rings number of rings in the scan.
+         * @param origin point from which the scan was obtained. VectorType::zero() by default.
+         */
+        void loadData(Span<const VectorType> points, size_t rings, const VectorType &origin = VectorType::zeros())
+        {
+            loadData(StridedSpan<const VectorType>(points), rings, origin);
+        }
+
+        //! Loads and processes a new scan viewed in an external buffer.
+        /*!
+         * @param points view of the scan organized ring by ring, each ring holds the same number of points ordered by the azimuth.
+         * @param rings number of rings in the scan.
+         * @param origin point from which the scan was obtained. VectorType::zero() by default.
+         */
+        void loadData(StridedSpan<const VectorType> points, size_t rings, const VectorType &origin = VectorType::zeros())
+        {
+            cluster_counter = 0;
+            point_labels.clear();
+            if (points.empty() || rings == 0)
+                return;
+
+            const size_t cols = points.size() / rings;
+            ElementType scale_factor = (ElementType)step_size * 2 * C_PI<ElementType> / cols;
+            scale_factor *= scale_factor;
+
+            // each block of rings links its own points and collects the proximities to the ring preceding the block
+            point_labels.resize(rings * cols);
+            size_t block_cnt = std::max<size_t>(1, std::min<size_t>(executor.concurrency(), rings));
+            block_seams.resize(block_cnt);
+            executor(0, block_cnt, [&](size_t b_begin, size_t b_end) {
+                for (size_t b = b_begin; b < b_end; b++)
+                    segmentBlock(points, origin, scale_factor, cols, b * rings / block_cnt, (b + 1) * rings / block_cnt, block_seams[b]);
+            });
+            for (const auto &seams : block_seams)
+                for (const auto &[i, j] : seams)
+                    unite(i, j);
+
+            // roots are the first points of their clusters, the parents are therefore relabeled to cluster indices in a single pass
+            for (size_t i = 0; i < point_labels.size(); i++)
+            {
+                if (points[i].hasNaN())
+                    point_labels[i] = invalid_label;
+                else if (point_labels[i] == i)
+                    point_labels[i] = cluster_counter++;
+                else
+                    point_labels[i] = point_labels[point_labels[i]];
+            }
+        }
+
+    private:
+        // Proximity tests of the points in rings [ring_begin, ring_end) with their preceding neighbours in the ring and with the preceding ring. Only parents
+        // of the block's own points are written, so the blocks may run concurrently. Proximities reaching to the preceding block are stored into seams.
+        void segmentBlock(const StridedSpan<const VectorType> &points, const VectorType &origin, ElementType scale_factor, size_t cols, size_t ring_begin,
+                          size_t ring_end, std::vector<std::pair<size_t, size_t>> &seams)
+        {
+            std::iota(point_labels.begin() + ring_begin * cols, point_labels.begin() + ring_end * cols, ring_begin * cols);
+            seams.clear();
+            const size_t nb_cnt = std::min(step_size > 1 ? step_size - 1 : 0, cols - 1);
+            const size_t window = std::min(ring_window, (cols - 1) / 2);
+            for (size_t r = ring_begin; r < ring_end; r++)
+            {
+                for (size_t c = 0; c < cols; c++)
+                {
+                    const size_t i = r * cols + c;
+                    if (points[i].hasNaN())
+                        continue;
+                    ElementType dist2 = scale_factor * VectorType::distanceSquared(points[i], origin);
+                    if (dist2 < l_bound2)
+                        dist2 = l_bound2;
+                    if (dist2 > u_bound2)
+                        dist2 = u_bound2;
+
+                    for (size_t j = 1; j <= nb_cnt; j++)
+                    {
+                        size_t k = r * cols + (c + cols - j) % cols;
+                        if (VectorType::distanceSquared(points[i], points[k]) < dist2)
+                            unite(i, k);
+                    }
+                    if (r == 0)
+                        continue;
+                    for (size_t j = 0; j <= 2 * window; j++)
+                    {
+                        size_t k = (r - 1) * cols + (c + cols + j - window) % cols;
+                        if (VectorType::distanceSquared(points[i], points[k]) < dist2)
+                        {
+                            if (r > ring_begin)
+                                unite(i, k);
+                            else
+                                seams.emplace_back(i, k);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Union-find over point_labels. Parents always precede their children, so the root of each cluster is its first point.
+        size_t find(size_t i)
+        {
+            while (point_labels[i] != i)
+            {
+                point_labels[i] = point_labels[point_labels[i]];
+                i = point_labels[i];
+            }
+            return i;
+        }
+
+        void unite(size_t i, size_t j)
+        {
+            i = find(i);
+            j = find(j);
+            if (i < j)
+                point_labels[j] = i;
+            else if (j < i)
+                point_labels[i] = j;
+        }
+
+        size_t cluster_counter{}, step_size{1}, ring_window{1};
+        ElementType l_bound2{}, u_bound2{};
+        Executor executor;
+        std::vector<size_t> point_labels;
+        std::vector<std::vector<std::pair<size_t, size_t>>> block_seams;
+    };
+}
+
+#endif // ROBOTICTEMPLATELIBRARY_SEG_MRA_SEGMENTER_H
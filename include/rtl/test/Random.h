@@ -30,6 +30,8 @@
 #include <random>
 #include <chrono>
 #include <type_traits>
+#include <thread>
+#include <functional>
 
 #include "rtl/Core.h"
 #include "rtl/Transformation.h"
@@ -37,16 +39,52 @@
 namespace rtl::test
 {
     //! Class for comfortable generation of random values of any integer or floating point type.
+    /*!
+     * Each thread draws from its own generator, so the class can be used from parallel tests. The generators are seeded by time unless seed() is called,
+     * all functions also have overloads taking an explicit generator, e.g. a stream from rtl::RandomStreams, for reproducible parallel generation.
+     *
+     * Whole arrays of values, vectors, quaternions, transformations or line segments are filled by the *Array() functions drawing from an interleaved
+     * Xoshiro256PlusPlusBulk generator, which is several times faster than invoking the random() factories of the geometric types with a callable per element.
+     */
     class Random
     {
+    public:
+        typedef Xoshiro256PlusPlusBulk<> BulkEngineType;    //!< Generator of the *Array() functions.
+
     private:
+        static uint64_t timeSeed()
+        {
+            return std::chrono::system_clock::now().time_since_epoch().count() ^ std::hash<std::thread::id>()(std::this_thread::get_id());
+        }
+
         static auto& generator()
         {
-            static auto generator = std::default_random_engine(std::chrono::system_clock::now().time_since_epoch().count());
+            static thread_local auto generator = RandomStreams::EngineType(timeSeed());
             return generator;
         }
 
+        static auto& bulkGenerator()
+        {
+            // seeded independently, so that its lazy creation does not advance generator()
+            static thread_local auto bulk_generator = BulkEngineType(~timeSeed());
+            return bulk_generator;
+        }
+
+        // the geometric arrays are generated through buffers of elements of this size
+        static constexpr size_t bulk_chunk = 256;
+
     public:
+        //! Seeds the generators of the calling thread.
+        /*!
+         *
+         * @param seed new seed of the generators.
+         */
+        static void seed(uint64_t seed)
+        {
+            generator().seed(seed);
+            bulkGenerator().seed(seed);
+        }
+
         //! Provides a random value in given range with uniform distribution.
         /*!
          *
@@ -57,16 +95,32 @@ namespace rtl::test
          */
         template<typename T>
         static T uniformValue(T min, T max)
+        {
+            return uniformValue(min, max, generator());
+        }
+
+        //! Provides a random value in given range with uniform distribution drawn from given generator.
+        /*!
+         *
+         * @tparam T type of the random value.
+         * @tparam Engine type of the UniformRandomBitGenerator.
+         * @param min lower bound of the range.
+         * @param max upper bound of the range.
+         * @param engine the generator.
+         * @return a random value.
+         */
+        template<typename T, class Engine>
+        static T uniformValue(T min, T max, Engine &engine)
         {
             if constexpr (std::is_integral<T>())
             {
                 std::uniform_int_distribution<T> dist(min, max);
-                return dist(generator());
+                return dist(engine);
             }
             else if constexpr (std::is_floating_point<T>())
             {
                 std::uniform_real_distribution<T> dist(min, max);
-                return dist(generator());
+                return dist(engine);
             }
             else
                     static_assert(sizeof(T) != sizeof(T), "Unsupported type.");
@@ -90,6 +144,255 @@ namespace rtl::test
             else
                     static_assert(sizeof(T) != sizeof(T), "Unsupported type.");
         }
+
+        //! Provides callable lambda which returns a random value in given range with uniform distribution drawn from given generator on invocation.
+        /*!
+         * The generator is captured by reference and must outlive the lambda.
+         * @tparam T type of the random value.
+         * @tparam Engine type of the UniformRandomBitGenerator.
+         * @param min lower bound of the range.
+         * @param max upper bound of the range.
+         * @param engine the generator.
+         * @return a random value.
+         */
+        template<typename T, class Engine>
+        static auto uniformCallable(T min, T max, Engine &engine)
+        {
+            return [min, max, &engine] () { return uniformValue(min, max, engine); };
+        }
+
+        //! Fills an array with random values in given range with uniform distribution.
+        /*!
+         *
+         * @tparam T floating point type of the values.
+         * @param out array to be filled.
+         * @param min lower bound of the range.
+         * @param max upper bound of the range.
+         */
+        template<typename T>
+        static void uniformArray(Span<T> out, T min, T max)
+        {
+            uniformArray(out, min, max, bulkGenerator());
+        }
+
+        //! Fills an array with random values in given range with uniform distribution drawn from given bulk generator.
+        /*!
+         *
+         * @tparam T floating point type of the values.
+         * @tparam lanes number of lanes of the generator.
+         * @param out array to be filled.
+         * @param min lower bound of the range.
+         * @param max upper bound of the range.
+         * @param engine the generator.
+         */
+        template<typename T, size_t lanes>
+        static void uniformArray(Span<T> out, T min, T max, Xoshiro256PlusPlusBulk<lanes> &engine)
+        {
+            engine.uniform(out, min, max);
+        }
+
+        //! Fills an array with normally distributed random values.
+        /*!
+         *
+         * @tparam T floating point type of the values.
+         * @param out array to be filled.
+         * @param mean mean of the distribution.
+         * @param std_dev standard deviation of the distribution.
+         */
+        template<typename T>
+        static void normalArray(Span<T> out, T mean, T std_dev)
+        {
+            normalArray(out, mean, std_dev, bulkGenerator());
+        }
+
+        //! Fills an array with normally distributed random values drawn from given bulk generator.
+        /*!
+         *
+         * @tparam T floating point type of the values.
+         * @tparam lanes number of lanes of the generator.
+         * @param out array to be filled.
+         * @param mean mean of the distribution.
+         * @param std_dev standard deviation of the distribution.
+         * @param engine the generator.
+         */
+        template<typename T, size_t lanes>
+        static void normalArray(Span<T> out, T mean, T std_dev, Xoshiro256PlusPlusBulk<lanes> &engine)
+        {
+            engine.normal(out, mean, std_dev);
+        }
+
+        //! Fills an array of vectors with elements uniformly distributed in given range.
+        /*!
+         * Bulk counterpart of VectorND::random() with uniformCallable(\p min, \p max).
+         * @tparam dim dimensionality of the vectors.
+         * @tparam E element type of the vectors.
+         * @param out array to be filled.
+         * @param min lower bound of the range.
+         * @param max upper bound of the range.
+         */
+        template<int dim, typename E>
+        static void vectorArray(Span<VectorND<dim, E>> out, E min, E max)
+        {
+            vectorArray(out, min, max, bulkGenerator());
+        }
+
+        //! Fills an array of vectors with elements uniformly distributed in given range drawn from given bulk generator.
+        /*!
+         *
+         * @tparam dim dimensionality of the vectors.
+         * @tparam E element type of the vectors.
+         * @tparam lanes number of lanes of the generator.
+         * @param out array to be filled.
+         * @param min lower bound of the range.
+         * @param max upper bound of the range.
+         * @param engine the generator.
+         */
+        template<int dim, typename E, size_t lanes>
+        static void vectorArray(Span<VectorND<dim, E>> out, E min, E max, Xoshiro256PlusPlusBulk<lanes> &engine)
+        {
+            E buf[dim * bulk_chunk];
+            for (size_t beg = 0; beg < out.size(); beg += bulk_chunk)
+            {
+                size_t n = std::min(bulk_chunk, out.size() - beg);
+                engine.uniform(Span<E>(buf, dim * n), min, max);
+                for (size_t i = 0; i < n; i++)
+                    out[beg + i] = VectorND<dim, E>(Eigen::Map<const typename VectorND<dim, E>::EigenType>(buf + dim * i));
+            }
+        }
+
+        //! Fills an array with unit quaternions of rotations uniformly distributed over SO(3).
+        /*!
+         * Unlike Quaternion::random(), which draws the elements independently, the quaternions are generated by the subgroup algorithm of K. Shoemake, so they are
+         * normalized and the rotations they represent are not biased to any direction.
+         * @tparam E element type of the quaternions.
+         * @param out array to be filled.
+         */
+        template<typename E>
+        static void quaternionArray(Span<Quaternion<E>> out)
+        {
+            quaternionArray(out, bulkGenerator());
+        }
+
+        //! Fills an array with unit quaternions of rotations uniformly distributed over SO(3) drawn from given bulk generator.
+        /*!
+         *
+         * @tparam E element type of the quaternions.
+         * @tparam lanes number of lanes of the generator.
+         * @param out array to be filled.
+         * @param engine the generator.
+         */
+        template<typename E, size_t lanes>
+        static void quaternionArray(Span<Quaternion<E>> out, Xoshiro256PlusPlusBulk<lanes> &engine)
+        {
+            E u[bulk_chunk], ang[2 * bulk_chunk], sin[2 * bulk_chunk], cos[2 * bulk_chunk];
+            for (size_t beg = 0; beg < out.size(); beg += bulk_chunk)
+            {
+                size_t n = std::min(bulk_chunk, out.size() - beg);
+                engine.uniform(Span<E>(u, n), E(0), E(1));
+                engine.uniform(Span<E>(ang, 2 * n), -C_PI<E>, C_PI<E>);
+                TrigStd::sincos(Span<const E>(ang, 2 * n), sin, cos);
+                for (size_t i = 0; i < n; i++)
+                {
+                    E a = std::sqrt(E(1) - u[i]), b = std::sqrt(u[i]);
+                    out[beg + i] = Quaternion<E>(b * cos[n + i], a * sin[i], a * cos[i], b * sin[n + i]);
+                }
+            }
+        }
+
+        //! Fills an array of rigid transformations with uniformly distributed rotations and translations.
+        /*!
+         * 2D rotations have angles uniform in [-pi, pi), 3D rotations are uniform over SO(3), see quaternionArray(). Elements of the translations are uniform in the given range.
+         * @tparam dim dimensionality of the transformations, 2 or 3.
+         * @tparam E element type of the transformations.
+         * @param out array to be filled.
+         * @param tr_min lower bound of the translation elements.
+         * @param tr_max upper bound of the translation elements.
+         */
+        template<int dim, typename E>
+        static void rigidTfArray(Span<RigidTfND<dim, E>> out, E tr_min, E tr_max)
+        {
+            rigidTfArray(out, tr_min, tr_max, bulkGenerator());
+        }
+
+        //! Fills an array of rigid transformations with uniformly distributed rotations and translations drawn from given bulk generator.
+        /*!
+         *
+         * @tparam dim dimensionality of the transformations, 2 or 3.
+         * @tparam E element type of the transformations.
+         * @tparam lanes number of lanes of the generator.
+         * @param out array to be filled.
+         * @param tr_min lower bound of the translation elements.
+         * @param tr_max upper bound of the translation elements.
+         * @param engine the generator.
+         */
+        template<int dim, typename E, size_t lanes>
+        static void rigidTfArray(Span<RigidTfND<dim, E>> out, E tr_min, E tr_max, Xoshiro256PlusPlusBulk<lanes> &engine)
+        {
+            static_assert(dim == 2 || dim == 3, "Random::rigidTfArray() supports 2D and 3D transformations only.");
+            if constexpr (dim == 2)
+            {
+                E ang[bulk_chunk], tr[2 * bulk_chunk];
+                for (size_t beg = 0; beg < out.size(); beg += bulk_chunk)
+                {
+                    size_t n = std::min(bulk_chunk, out.size() - beg);
+                    engine.uniform(Span<E>(ang, n), -C_PI<E>, C_PI<E>);
+                    engine.uniform(Span<E>(tr, 2 * n), tr_min, tr_max);
+                    RigidTfND<2, E>::fromAngles(Span<const E>(ang, n), Span<const E>(tr, n), Span<const E>(tr + n, n), out.subspan(beg, n));
+                }
+            }
+            else
+            {
+                Quaternion<E> quat[bulk_chunk];
+                VectorND<3, E> tr[bulk_chunk];
+                for (size_t beg = 0; beg < out.size(); beg += bulk_chunk)
+                {
+                    size_t n = std::min(bulk_chunk, out.size() - beg);
+                    quaternionArray(Span<Quaternion<E>>(quat, n), engine);
+                    vectorArray(Span<VectorND<3, E>>(tr, n), tr_min, tr_max, engine);
+                    for (size_t i = 0; i < n; i++)
+                        out[beg + i] = RigidTfND<3, E>(quat[i], tr[i]);
+                }
+            }
+        }
+
+        //! Fills an array of line segments with end-points uniformly distributed in given range.
+        /*!
+         * Bulk counterpart of LineSegmentND::random() with uniformCallable(\p min, \p max).
+         * @tparam dim dimensionality of the line segments.
+         * @tparam E element type of the line segments.
+         * @param out array to be filled.
+         * @param min lower bound of the end-point elements.
+         * @param max upper bound of the end-point elements.
+         */
+        template<int dim, typename E>
+        static void lineSegmentArray(Span<LineSegmentND<dim, E>> out, E min, E max)
+        {
+            lineSegmentArray(out, min, max, bulkGenerator());
+        }
+
+        //! Fills an array of line segments with end-points uniformly distributed in given range drawn from given bulk generator.
+        /*!
+         *
+         * @tparam dim dimensionality of the line segments.
+         * @tparam E element type of the line segments.
+         * @tparam lanes number of lanes of the generator.
+         * @param out array to be filled.
+         * @param min lower bound of the end-point elements.
+         * @param max upper bound of the end-point elements.
+         * @param engine the generator.
+         */
+        template<int dim, typename E, size_t lanes>
+        static void lineSegmentArray(Span<LineSegmentND<dim, E>> out, E min, E max, Xoshiro256PlusPlusBulk<lanes> &engine)
+        {
+            VectorND<dim, E> pts[2 * bulk_chunk];
+            for (size_t beg = 0; beg < out.size(); beg += bulk_chunk)
+            {
+                size_t n = std::min(bulk_chunk, out.size() - beg);
+                vectorArray(Span<VectorND<dim, E>>(pts, 2 * n), min, max, engine);
+                for (size_t i = 0; i < n; i++)
+                    out[beg + i] = LineSegmentND<dim, E>(pts[2 * i], pts[2 * i + 1]);
+            }
+        }
     };
 }
 
@@ -142,6 +142,14 @@ namespace rtl::test
         static std::string description() { return "rtl::LineSegmentND<" + std::to_string(d) + ", " + type<E>::description() + ">"; }
     };
 
+    //! Type details for rtl::PointCloudND specializations.
+    template<int d, typename E>
+    struct type<rtl::PointCloudND<d, E>>
+    {
+        //! Human readable name of given type returned as std::string.
+        static std::string description() { return "rtl::PointCloudND<" + std::to_string(d) + ", " + type<E>::description() + ">"; }
+    };
+
     //! Type details for rtl::BoundingBoxND specializations.
     template<int d, typename E>
     struct type<rtl::BoundingBoxND<d, E>>
@@ -0,0 +1,241 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_CONCURRENTTFTREE_H
+#define ROBOTICTEMPLATELIBRARY_CONCURRENTTFTREE_H
+
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <type_traits>
+
+#include "TfTree.h"
+
+namespace rtl
+{
+    /*!
+     * ConcurrentTfTree shares a TfTree between one or more writer threads and many reader threads using the read-copy-update scheme. The current state of the tree is an immutable
+     * snapshot held by std::shared_ptr. Readers atomically grab the pointer and query the snapshot, never waiting for writers. Writers are serialized by an internal mutex; each
+     * modification copies the current snapshot, applies the change to the copy, fills cached root-to-node transformations of all nodes and atomically publishes the copy as
+     * the new snapshot. Readers holding an older snapshot keep a consistent view of the tree until they release it.
+     *
+     * Since every modification copies the whole tree, the scheme suits trees of modest size updated at sensor rates and queried much more often than that. Several changes
+     * can be applied as one atomic update through modify().
+     * @tparam K Key type.
+     * @tparam T Transformation type.
+     */
+    template<typename K, typename T>
+    class ConcurrentTfTree
+    {
+    public:
+        typedef K KeyType;                                  //!< Type of the keys.
+        typedef T TransformationType;                       //!< Type of the transformations between nodes.
+        typedef TfTree<KeyType, TransformationType> TreeType;   //!< Type of the shared tree.
+        typedef std::shared_ptr<const TreeType> SnapshotType;   //!< Type of the read-only snapshot of the tree.
+
+        ConcurrentTfTree() = delete;
+
+        //! Base ConcurrentTfTree constructor.
+        /*!
+         *
+         * @param root_key key of the root node.
+         */
+        explicit ConcurrentTfTree(const KeyType &root_key)
+        {
+            auto cp = std::make_shared<TreeType>(root_key);
+            primeCaches(*cp);
+            int_snapshot = std::move(cp);
+        }
+
+        //! Construction from an existing tree.
+        /*!
+         *
+         * @param tree the tree to be shared.
+         */
+        explicit ConcurrentTfTree(const TreeType &tree)
+        {
+            auto cp = std::make_shared<TreeType>(tree);
+            primeCaches(*cp);
+            int_snapshot = std::move(cp);
+        }
+
+        ConcurrentTfTree(const ConcurrentTfTree &cp) = delete;
+        ConcurrentTfTree &operator=(const ConcurrentTfTree &cp) = delete;
+
+        //! Default destructor.
+        ~ConcurrentTfTree() = default;
+
+        //! Returns the current state of the tree.
+        /*!
+         * Never blocks on writers. The snapshot stays valid and unchanged for as long as the caller holds it, regardless of concurrent modifications.
+         * @return shared pointer to the read-only snapshot of the tree.
+         */
+        [[nodiscard]] SnapshotType snapshot() const
+        {
+            return std::atomic_load_explicit(&int_snapshot, std::memory_order_acquire);
+        }
+
+        //! Returns number of the nodes in the current snapshot.
+        [[nodiscard]] size_t size() const
+        {
+            return snapshot()->size();
+        }
+
+        //! Checks whether a node with given key exists in the current snapshot.
+        /*!
+         *
+         * @param key key of the node to be searched for.
+         * @return true if found, false otherwise.
+         */
+        [[nodiscard]] bool contains(const KeyType &key) const
+        {
+            return snapshot()->contains(key);
+        }
+
+        //! Returns a chain of transformations between nodes in the current snapshot.
+        /*!
+         *
+         * @param from starting node.
+         * @param to end node.
+         * @return chain of transformations between \p from and \p to.
+         */
+        TfChain<TransformationType> tf(const KeyType &from, const KeyType &to) const
+        {
+            return snapshot()->tf(from, to);
+        }
+
+        //! Returns a single transformation between nodes in the current snapshot.
+        /*!
+         * Cached root-to-node transformations are always valid in published snapshots, so the query costs one inversion and one composition.
+         * @param from starting node.
+         * @param to end node.
+         * @return transformation from \p from to \p to.
+         */
+        TransformationType tfSquashed(const KeyType &from, const KeyType &to) const
+        {
+            return snapshot()->tfSquashed(from, to);
+        }
+
+        //! Inserts a new node into the tree.
+        /*!
+         *
+         * @tparam Tf type of the transformation.
+         * @param key key of the new node.
+         * @param tf transformation from the parent node to the new node.
+         * @param parent key of the parent node.
+         * @return true on success, false otherwise.
+         */
+        template<typename Tf>
+        bool insert(const KeyType &key, Tf &&tf, const KeyType &parent)
+        {
+            return modify([&](TreeType &tree) { return tree.insert(key, std::forward<Tf>(tf), parent); });
+        }
+
+        //! Erases the node with given key and all its child-nodes recursively.
+        /*!
+         *
+         * @param key key of the node to be erased.
+         * @return true on success, false otherwise.
+         */
+        bool erase(const KeyType &key)
+        {
+            return modify([&](TreeType &tree) { return tree.erase(key); });
+        }
+
+        //! Replaces the transformation from the parent of the node with given key.
+        /*!
+         *
+         * @tparam Tf type of the transformation.
+         * @param key key of the node.
+         * @param tf new transformation from the parent node.
+         * @return true on success, false if the key does not exist.
+         */
+        template<typename Tf>
+        bool setTf(const KeyType &key, Tf &&tf)
+        {
+            return modify([&](TreeType &tree)
+                          {
+                              if (!tree.contains(key))
+                                  return false;
+                              tree.at(key).tf() = std::forward<Tf>(tf);
+                              return true;
+                          });
+        }
+
+        //! Applies an arbitrary modification to the tree as one atomic update.
+        /*!
+         * \p func is invoked on a private copy of the current snapshot. If it returns a value convertible to bool, the copy is published only when the value is true, otherwise
+         * the copy is always published. Readers observe either none or all of the changes made by \p func. If \p func throws, nothing is published.
+         * @tparam Func type of the invokable object.
+         * @param func invokable object taking TreeType& as the parameter.
+         * @return the value returned by \p func if convertible to bool, true otherwise.
+         */
+        template<typename Func>
+        bool modify(Func &&func)
+        {
+            std::lock_guard<std::mutex> lock(int_writer_mutex);
+            auto cp = std::make_shared<TreeType>(*std::atomic_load_explicit(&int_snapshot, std::memory_order_relaxed));
+            bool publish = true;
+            if constexpr (std::is_convertible_v<std::invoke_result_t<Func, TreeType&>, bool>)
+                publish = func(*cp);
+            else
+                func(*cp);
+            if (publish)
+            {
+                primeCaches(*cp);
+                std::atomic_store_explicit(&int_snapshot, SnapshotType(std::move(cp)), std::memory_order_release);
+            }
+            return publish;
+        }
+
+    private:
+        //! Fills cached root-to-node transformations and inversions of all nodes.
+        /*!
+         * Readers of a published snapshot would otherwise race on lazy cache updates in their const queries.
+         * @param tree the tree to be prepared for publishing.
+         */
+        static void primeCaches(const TreeType &tree)
+        {
+            primeSubtree(tree.root());
+        }
+
+        static void primeSubtree(const typename TreeType::NodeType &node)
+        {
+            [[maybe_unused]] const auto &rtf = node.rootTf();
+            [[maybe_unused]] const auto &rtf_inv = node.rootTfInverted();
+            if (node.depth() != 0)
+                [[maybe_unused]] const auto &tf_inv = node.tfInverted();
+            for (auto c : node.children())
+                primeSubtree(*c);
+        }
+
+        SnapshotType int_snapshot;
+        std::mutex int_writer_mutex;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_CONCURRENTTFTREE_H
@@ -0,0 +1,508 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_FLATTFTREE_H
+#define ROBOTICTEMPLATELIBRARY_FLATTFTREE_H
+
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "TfBuffer.h"
+#include "TfChain.h"
+#include "rtl/core/SmallVector.h"
+
+namespace rtl
+{
+    /*!
+     * FlatTfTree offers the key-based interface of TfTree with nodes kept in contiguous arrays instead of individually allocated TfTreeNode objects. Each node is identified
+     * by a dense integer handle indexing the arrays of keys, parents, depths, transformations and buffers. Keys are mapped to handles by a hash table, children of each node
+     * form a contiguous range of handles. Walking a path between two nodes therefore touches only a few densely packed arrays, which makes queries on large trees (robot
+     * models with hundreds of frames) considerably more cache-friendly than pointer chasing in TfTree.
+     *
+     * Parents always have lower handles than their children, which allows invalidation of the cached root-to-node transformations by a single linear pass. Handles are stable
+     * under insertion, erase() compacts the arrays and may change handles of the remaining nodes. The child ranges are rebuilt lazily on the first children() call after
+     * a structural change, concurrent const access is therefore safe only after the ranges and the rootTf() caches were built, as with TfTree.
+     *
+     * Unlike TfTree, the tree is trivially copyable and movable, since there are no pointers between nodes.
+     * @tparam K Key type, std::hash<K> has to be available.
+     * @tparam T Transformation type.
+     */
+    template<typename K, typename T>
+    class FlatTfTree
+    {
+    public:
+        typedef K KeyType;              //!< Type of the keys.
+        typedef T TransformationType;   //!< Type of the transformations between nodes.
+        typedef TfBuffer<T> BufferType; //!< Type of the time-stamped history of the transformations.
+        typedef typename BufferType::TimeType TimeType; //!< Type of the time stamps of buffered transformations.
+        typedef size_t HandleType;      //!< Type of the node handles.
+
+        static constexpr HandleType npos = std::numeric_limits<HandleType>::max();   //!< Handle value of a non-existing node.
+
+        //! Contiguous range of handles of the child nodes.
+        class ChildRange
+        {
+        public:
+            ChildRange(const HandleType *b, const HandleType *e) : int_begin(b), int_end(e) {}
+            [[nodiscard]] const HandleType *begin() const { return int_begin; }     //!< First child handle.
+            [[nodiscard]] const HandleType *end() const { return int_end; }         //!< One behind the last child handle.
+            [[nodiscard]] size_t size() const { return int_end - int_begin; }       //!< Number of children.
+            [[nodiscard]] bool empty() const { return int_begin == int_end; }       //!< True for leaf nodes.
+        private:
+            const HandleType *int_begin, *int_end;
+        };
+
+        FlatTfTree() = delete;
+
+        //! Base FlatTfTree constructor.
+        /*!
+         * FlatTfTree cannot be constructed without root, therefore the implicit constructor is disabled and the key of the root node has to be passed.
+         * @param root_key key of the root node.
+         */
+        explicit FlatTfTree(const KeyType &root_key)
+        {
+            appendNode(root_key, TransformationType::identity(), npos, 0);
+        }
+
+        //! Checks for an empty tree.
+        /*!
+         * Since there always is the root node, a valid tree is never empty.
+         * @return False if there are no nodes in the tree, true otherwise.
+         */
+        [[nodiscard]] bool empty() const
+        {
+            return int_keys.empty();
+        }
+
+        //! Returns number of the nodes in the tree.
+        [[nodiscard]] size_t size() const
+        {
+            return int_keys.size();
+        }
+
+        //! Reserves memory for \p n nodes.
+        void reserve(size_t n)
+        {
+            int_keys.reserve(n);
+            int_parents.reserve(n);
+            int_depths.reserve(n);
+            int_tfs.reserve(n);
+            int_buffers.reserve(n);
+            int_root_tfs.reserve(n);
+            int_root_tf_valid.reserve(n);
+            int_index.reserve(n);
+        }
+
+        //! Clears the tree leaving only the root unchanged.
+        void clear()
+        {
+            resizeNodes(1);
+            int_index.clear();
+            int_index.emplace(int_keys[0], 0);
+            int_topology_valid = false;
+        }
+
+        //! Inserts a new node into the tree.
+        /*!
+         *
+         * @tparam Tf type of the transformation.
+         * @param key key of the new node.
+         * @param tf transformation from the parent node to the new node.
+         * @param parent key of the parent node.
+         * @return true on success, false otherwise.
+         */
+        template<typename Tf>
+        bool insert(const KeyType &key, Tf &&tf, const KeyType &parent)
+        {
+            HandleType p = find(parent);
+            if (p == npos || int_index.find(key) != int_index.end())
+                return false;
+            appendNode(key, std::forward<Tf>(tf), p, int_depths[p] + 1);
+            return true;
+        }
+
+        //! Erases the node with given key and all its child-nodes.
+        /*!
+         * The root node cannot be erased. Handles of the remaining nodes may change.
+         * @param key key of the node to be erased.
+         * @return true on success, false otherwise.
+         */
+        bool erase(const KeyType &key)
+        {
+            HandleType h = find(key);
+            if (h == npos || h == root())
+                return false;
+
+            // parents precede children, so a single pass marks the whole subtree
+            std::vector<HandleType> remap(size(), 0);
+            remap[h] = npos;
+            for (HandleType i = h + 1; i < size(); i++)
+                if (remap[int_parents[i]] == npos)
+                    remap[i] = npos;
+
+            HandleType dst = 0;
+            for (HandleType i = 0; i < size(); i++)
+            {
+                if (remap[i] == npos)
+                {
+                    int_index.erase(int_keys[i]);
+                    continue;
+                }
+                remap[i] = dst;
+                if (dst != i)
+                {
+                    int_keys[dst] = std::move(int_keys[i]);
+                    int_parents[dst] = int_parents[i] == npos ? npos : remap[int_parents[i]];
+                    int_depths[dst] = int_depths[i];
+                    int_tfs[dst] = std::move(int_tfs[i]);
+                    int_buffers[dst] = std::move(int_buffers[i]);
+                    int_root_tfs[dst] = std::move(int_root_tfs[i]);
+                    int_root_tf_valid[dst] = int_root_tf_valid[i];
+                    int_index[int_keys[dst]] = dst;
+                }
+                dst++;
+            }
+            resizeNodes(dst);
+            int_topology_valid = false;
+            return true;
+        }
+
+        //! Checks whether a node with given key exists in the tree.
+        bool contains(const KeyType &key) const
+        {
+            return int_index.find(key) != int_index.end();
+        }
+
+        //! Handle of the node with given key, or npos if there is no such node.
+        [[nodiscard]] HandleType find(const KeyType &key) const
+        {
+            auto it = int_index.find(key);
+            return it == int_index.end() ? npos : it->second;
+        }
+
+        //! Handle of the node with given key.
+        /*!
+         * If there is no node with the \p key in the tree, an exception is thrown.
+         * @param key key of the node.
+         * @return handle of the node.
+         */
+        [[nodiscard]] HandleType handle(const KeyType &key) const
+        {
+            auto it = int_index.find(key);
+            if (it == int_index.end())
+                throw std::out_of_range("The key does not exist in given FlatTfTree.");
+            return it->second;
+        }
+
+        //! Handle of the root node.
+        [[nodiscard]] static constexpr HandleType root() { return 0; }
+
+        //! Key of the node with given handle.
+        [[nodiscard]] const KeyType &key(HandleType h) const { return int_keys[h]; }
+
+        //! Handle of the parent of the node with given handle, npos for the root.
+        [[nodiscard]] HandleType parent(HandleType h) const { return int_parents[h]; }
+
+        //! Depth of the node with given handle with respect to root.
+        [[nodiscard]] size_t depth(HandleType h) const { return int_depths[h]; }
+
+        //! Range of handles of the children of the node with given handle.
+        [[nodiscard]] ChildRange children(HandleType h) const
+        {
+            buildTopology();
+            return ChildRange(int_child_list.data() + int_child_begin[h], int_child_list.data() + int_child_begin[h + 1]);
+        }
+
+        //! Transformation from parent to the node with given key.
+        /*!
+         * If there is no node with the \p key in the tree, an exception is thrown.
+         * @param key key of the node.
+         * @return reference to the transformation.
+         */
+        [[nodiscard]] const TransformationType &at(const KeyType &key) const
+        {
+            return int_tfs[handle(key)];
+        }
+
+        //! Transformation from parent to the node with given key.
+        /*!
+         * Non-const access invalidates cached rootTf() of the node and the whole subtree below it. If there is no node with the \p key in the tree, an exception is thrown.
+         * @param key key of the node.
+         * @return reference to the transformation.
+         */
+        [[nodiscard]] TransformationType &at(const KeyType &key)
+        {
+            HandleType h = handle(key);
+            invalidateRootTf(h);
+            return int_tfs[h];
+        }
+
+        //! Time-stamped history of the transformation from parent to the node with given key.
+        /*!
+         * The buffer has zero capacity by default, use TfBuffer::setCapacity() to enable the history. If there is no node with the \p key in the tree, an exception is thrown.
+         * @param key key of the node.
+         * @return reference to the buffer.
+         */
+        [[nodiscard]] BufferType &tfBuffer(const KeyType &key)
+        {
+            return int_buffers[handle(key)];
+        }
+
+        //! Time-stamped history of the transformation from parent to the node with given key.
+        /*!
+         * If there is no node with the \p key in the tree, an exception is thrown.
+         * @param key key of the node.
+         * @return reference to the buffer.
+         */
+        [[nodiscard]] const BufferType &tfBuffer(const KeyType &key) const
+        {
+            return int_buffers[handle(key)];
+        }
+
+        //! Composed transformation from the root of the tree to the node with given handle.
+        /*!
+         * The result is cached and only recomputed after the transformation of the node or one of its ancestors was accessed for modification.
+         * @param h handle of the node.
+         * @return reference to the cached transformation.
+         */
+        [[nodiscard]] const TransformationType &rootTf(HandleType h) const
+        {
+            if (!int_root_tf_valid[h])
+            {
+                if (h == root())
+                    int_root_tfs[h] = TransformationType::identity();
+                else
+                    int_root_tfs[h] = rootTf(int_parents[h]).transformed(int_tfs[h]);
+                int_root_tf_valid[h] = 1;
+            }
+            return int_root_tfs[h];
+        }
+
+        //! Returns a chain of transformations between nodes.
+        /*!
+         *
+         * @param from starting node.
+         * @param to end node.
+         * @return chain of transformations between \p from and \p to.
+         */
+        TfChain<TransformationType> tf(const KeyType &from, const KeyType &to) const
+        {
+            return TfChain<TransformationType>(pathTfs(handle(from), handle(to), [this](HandleType h) -> const TransformationType & { return int_tfs[h]; }));
+        }
+
+        //! Returns a chain of transformations between nodes valid at given time instant.
+        /*!
+         * Transformations of the edges with non-empty TfBuffer are interpolated at \p time, the current transformations are used for the rest. Throws std::out_of_range if
+         * any of the non-empty buffers on the path does not cover \p time.
+         * @param from starting node.
+         * @param to end node.
+         * @param time the time instant.
+         * @return chain of transformations between \p from and \p to at \p time.
+         */
+        TfChain<TransformationType> tf(const KeyType &from, const KeyType &to, const TimeType &time) const
+        {
+            return TfChain<TransformationType>(pathTfs(handle(from), handle(to), [this, &time](HandleType h) { return tfAt(h, time); }));
+        }
+
+        //! Returns single transformations between nodes for a batch of time instants.
+        /*!
+         * The path between \p from and \p to is searched only once for the whole batch. Same restrictions as for tf(from, to, time) and TfChain::squash() apply.
+         * @param from starting node.
+         * @param to end node.
+         * @param times the time instants.
+         * @return transformations from \p from to \p to, one for each element of \p times.
+         */
+        std::vector<TransformationType> tfSquashed(const KeyType &from, const KeyType &to, const std::vector<TimeType> &times) const
+        {
+            auto path = pathTfs(handle(from), handle(to), [](HandleType h) { return PathEdge{h, false}; });
+            std::vector<TransformationType> ret;
+            ret.reserve(times.size());
+            for (const auto &t : times)
+            {
+                auto aggregation = TransformationType::identity();
+                for (const auto &edge : path)
+                {
+                    if (edge.inverted)
+                        aggregation.transform(tfAt(edge.node, t).inverted());
+                    else
+                        aggregation.transform(tfAt(edge.node, t));
+                }
+                ret.push_back(std::move(aggregation));
+            }
+            return ret;
+        }
+
+        //! Returns a single transformation between nodes composed from cached root-to-node transformations.
+        /*!
+         * The result is equivalent to tf(from, to).squash(), see TfTree::tfSquashed().
+         * @param from starting node.
+         * @param to end node.
+         * @return transformation from \p from to \p to.
+         */
+        TransformationType tfSquashed(const KeyType &from, const KeyType &to) const
+        {
+            return rootTf(handle(from)).inverted().transformed(rootTf(handle(to)));
+        }
+
+        //! Records a new time-stamped transformation from the parent of the node with given key.
+        /*!
+         * The transformation is inserted into the node's TfBuffer. If it is the newest one, it also becomes the current transformation.
+         * @param key key of the node.
+         * @param time time stamp of the transformation.
+         * @param tf the transformation.
+         * @return true if the node exists, false otherwise.
+         */
+        bool update(const KeyType &key, const TimeType &time, const TransformationType &tf)
+        {
+            HandleType h = find(key);
+            if (h == npos)
+                return false;
+            auto &buffer = int_buffers[h];
+            if (buffer.empty() || !(time < buffer.newestTime()))
+            {
+                invalidateRootTf(h);
+                int_tfs[h] = tf;
+            }
+            buffer.insert(time, tf);
+            return true;
+        }
+
+    private:
+        // Edge of a path between two nodes, inverted for the ascending part of the path.
+        struct PathEdge
+        {
+            HandleType node;
+            bool inverted;
+        };
+
+        //! Collects items describing edges on the path between two nodes in the order of application, see TfTree::pathTfs().
+        template<typename EdgeFunc>
+        auto pathTfs(HandleType from, HandleType to, EdgeFunc &&edge_func) const
+        {
+            using ItemType = std::decay_t<std::invoke_result_t<EdgeFunc, HandleType>>;
+            SmallVector<ItemType, 8> ret, down;    // down collects the descending part of the chain in reversed order
+            size_t common_depth = std::min(int_depths[from], int_depths[to]);
+
+            for (; int_depths[from] > common_depth; from = int_parents[from])
+                ret.push_back(invertedItem(edge_func(from)));
+            for (; int_depths[to] > common_depth; to = int_parents[to])
+                down.push_back(edge_func(to));
+
+            while (from != to)
+            {
+                ret.push_back(invertedItem(edge_func(from)));
+                down.push_back(edge_func(to));
+                from = int_parents[from];
+                to = int_parents[to];
+            }
+
+            ret.reserve(ret.size() + down.size());
+            for (auto it = down.end(); it != down.begin();)
+                ret.push_back(std::move(*--it));
+            return ret;
+        }
+
+        static PathEdge invertedItem(const PathEdge &edge) { return PathEdge{edge.node, !edge.inverted}; }
+
+        static TransformationType invertedItem(const TransformationType &tf) { return tf.inverted(); }
+
+        TransformationType tfAt(HandleType h, const TimeType &time) const
+        {
+            if (int_buffers[h].empty())
+                return int_tfs[h];
+            return int_buffers[h].at(time);
+        }
+
+        template<typename Tf>
+        void appendNode(const KeyType &key, Tf &&tf, HandleType parent, size_t depth)
+        {
+            int_index.emplace(key, int_keys.size());
+            int_keys.push_back(key);
+            int_parents.push_back(parent);
+            int_depths.push_back(depth);
+            int_tfs.emplace_back(std::forward<Tf>(tf));
+            int_buffers.emplace_back();
+            int_root_tfs.push_back(TransformationType::identity());
+            int_root_tf_valid.push_back(0);
+            int_topology_valid = false;
+        }
+
+        //! Drops all nodes behind the first \p n ones.
+        void resizeNodes(size_t n)
+        {
+            int_keys.erase(int_keys.begin() + n, int_keys.end());
+            int_parents.erase(int_parents.begin() + n, int_parents.end());
+            int_depths.erase(int_depths.begin() + n, int_depths.end());
+            int_tfs.erase(int_tfs.begin() + n, int_tfs.end());
+            int_buffers.erase(int_buffers.begin() + n, int_buffers.end());
+            int_root_tfs.erase(int_root_tfs.begin() + n, int_root_tfs.end());
+            int_root_tf_valid.erase(int_root_tf_valid.begin() + n, int_root_tf_valid.end());
+        }
+
+        //! Marks cached rootTf() of the node and its subtree stale. Parents precede children, so a single forward pass suffices.
+        void invalidateRootTf(HandleType h)
+        {
+            int_root_tf_valid[h] = 0;
+            for (HandleType i = h + 1; i < size(); i++)
+                if (!int_root_tf_valid[int_parents[i]])
+                    int_root_tf_valid[i] = 0;
+        }
+
+        //! Rebuilds the contiguous child ranges by counting sort of the nodes by their parents.
+        void buildTopology() const
+        {
+            if (int_topology_valid)
+                return;
+            int_child_begin.assign(size() + 1, 0);
+            for (HandleType i = 1; i < size(); i++)
+                int_child_begin[int_parents[i] + 1]++;
+            for (HandleType i = 1; i <= size(); i++)
+                int_child_begin[i] += int_child_begin[i - 1];
+            std::vector<size_t> fill(int_child_begin.begin(), int_child_begin.end() - 1);
+            int_child_list.resize(size() > 0 ? size() - 1 : 0);
+            for (HandleType i = 1; i < size(); i++)
+                int_child_list[fill[int_parents[i]]++] = i;
+            int_topology_valid = true;
+        }
+
+        std::vector<KeyType> int_keys;
+        std::vector<HandleType> int_parents;
+        std::vector<size_t> int_depths;
+        std::vector<TransformationType> int_tfs;
+        std::vector<BufferType> int_buffers;
+        mutable std::vector<TransformationType> int_root_tfs;
+        mutable std::vector<unsigned char> int_root_tf_valid;
+        std::unordered_map<KeyType, HandleType> int_index;
+        mutable std::vector<size_t> int_child_begin;
+        mutable std::vector<HandleType> int_child_list;
+        mutable bool int_topology_valid{false};
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_FLATTFTREE_H
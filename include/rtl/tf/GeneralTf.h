@@ -29,6 +29,7 @@
 
 #include <variant>
 #include <type_traits>
+#include "rtl/core/Span.h"
 #include "rtl/tf/VariantResult.h"
 
 namespace rtl
@@ -204,6 +205,33 @@ namespace rtl
             return gtf.transformed(*this);
         }
 
+        //! In-place transformation of \p obj by the active alternative.
+        /*!
+         * Unlike operator(), the transformed object keeps its type, therefore \p obj may also be a whole array of objects implementing transform() for the alternatives, such as
+         * rtl::PointCloudND. Throws std::bad_variant_access if the active alternative cannot transform \p obj in-place.
+         * @tparam Object type of the transformed object.
+         * @param obj the object to be transformed.
+         */
+        template<typename Object>
+        void applyTo(Object &obj) const
+        {
+            applyTo(Span<Object>(&obj, 1));
+        }
+
+        //! In-place transformation of a batch of objects by the active alternative.
+        /*!
+         * The variant is resolved only once for the whole batch and the concrete transformation is then applied on each object directly. Throws std::bad_variant_access if
+         * the active alternative cannot transform \p Object in-place.
+         * @tparam Object type of the transformed objects.
+         * @param objs view of the objects to be transformed.
+         */
+        template<typename Object>
+        void applyTo(Span<Object> objs) const
+        {
+            static_assert((is_transformable_in_place_v<Object, Tfs> || ...), "None of the GeneralTf alternatives can transform the object in-place.");
+            std::visit([objs](const auto &tf) { GeneralTf::applyAlternative(tf, objs); }, int_tf);
+        }
+
         //! Templated getter of the contained transformation.
         /*!
          * Throws std::bad_variant_access if wrong alternative was chosen.
@@ -315,6 +343,19 @@ namespace rtl
         }
 
     private:
+        //! Applies the resolved alternative \p tf on all objects in \p objs, see applyTo().
+        template<typename Alternative, typename Object>
+        static void applyAlternative(const Alternative &tf, Span<Object> objs)
+        {
+            if constexpr (is_transformable_in_place_v<Object, Alternative>)
+            {
+                for (auto &o : objs)
+                    o.transform(tf);
+            }
+            else
+                throw std::bad_variant_access();
+        }
+
         //! Function for generation of custom v-table of the operator().
         /*!
          * @tparam Output output type of the operator() invocation.
@@ -27,6 +27,10 @@
 #ifndef ROBOTICTEMPLATELIBRARY_RIGIDTFND_H
 #define ROBOTICTEMPLATELIBRARY_RIGIDTFND_H
 
+#include <stdexcept>
+
+#include "rtl/core/Span.h"
+#include "rtl/core/StridedSpan.h"
 #include "rtl/tf/TranslationND.h"
 #include "rtl/tf/RotationND.h"
 
@@ -162,6 +166,42 @@ namespace rtl
             return t.transformed(childThis());
         }
 
+        //! Transforms a batch of points viewed in external buffers.
+        /*!
+         * Each point is transformed in registers and written back before the next one is read, so \p in and \p out may view the same memory for an in-place
+         * transformation. An exception is thrown if the sizes of the views do not match.
+         * @param in view of the points to be transformed.
+         * @param out view of the memory receiving the transformed points.
+         */
+        void transformPoints(StridedSpan<const VectorType> in, StridedSpan<VectorType> out) const
+        {
+            if (in.size() != out.size())
+                throw std::invalid_argument("RigidTfND::transformPoints(): input and output sizes do not match.");
+            for (size_t i = 0; i < in.size(); i++)
+                out.set(i, VectorType(typename VectorType::EigenType(int_rotation.rotMat().data() * in[i].data() + int_translation.trVec().data())));
+        }
+
+        //! Transforms contiguous points in-place.
+        /*!
+         * The rotation matrix and the translation are loaded into scalars once and each point is processed by a fully unrolled loop without temporary vectors.
+         * Serves as the kernel of the collection-level transformations of geometric objects, e.g. Polygon3D::transform(Span<Polygon3D>, const RigidTfND &).
+         * @param pts the points to be transformed.
+         */
+        void transformPoints(Span<VectorType> pts) const
+        {
+            applyInPlace<true>(pts);
+        }
+
+        //! Rotates contiguous direction vectors in-place, the translation is not applied.
+        /*!
+         * Counterpart of transformPoints(Span<VectorType>) for directions and normals.
+         * @param vecs the vectors to be rotated.
+         */
+        void rotateVectors(Span<VectorType> vecs) const
+        {
+            applyInPlace<false>(vecs);
+        }
+
         //! Returns rigid transformation performing first transformation by *this and than translation by \p tr.
         /*!
          * @param tr the translation to be added.
@@ -224,6 +264,19 @@ namespace rtl
             int_translation.setTrVec(tf.rot()(int_translation.trVec()) + tf.trVec());
         }
 
+        //! Interpolation between *this and \p tf.
+        /*!
+         * Rotation and translation parts are interpolated independently, see RotationND::interpolated() and TranslationND::interpolated(). Available for dimensions,
+         * where the rotation interpolation is defined.
+         * @param tf the other rigid transformation.
+         * @param scale interpolation parameter in the range [0; 1], 0 returns *this, 1 returns \p tf.
+         * @return interpolated rigid transformation.
+         */
+        ChildType interpolated(const RigidTfND_common &tf, ElementType scale) const
+        {
+            return ChildType(int_rotation.interpolated(tf.int_rotation, scale), int_translation.interpolated(tf.int_translation, scale));
+        }
+
         //! Return a new transformation, which, when applied, leaves the transformed object as is.
         /*!
          *
@@ -250,14 +303,42 @@ namespace rtl
         //! Dimensionality of the rigid transformation.
         static constexpr int dimensionality() { return dimensions; }
 
+    private:
+        template<bool translate>
+        void applyInPlace(Span<VectorType> vecs) const
+        {
+            Element r[dimensions][dimensions], t[dimensions];
+            for (size_t i = 0; i < (size_t) dimensions; i++)
+            {
+                for (size_t j = 0; j < (size_t) dimensions; j++)
+                    r[i][j] = int_rotation.rotMat().data()(i, j);
+                t[i] = translate ? int_translation.trVec()[i] : Element(0);
+            }
+            for (auto &v : vecs)
+            {
+                Element *c = v.data().data(), in[dimensions];
+                for (size_t j = 0; j < (size_t) dimensions; j++)
+                    in[j] = c[j];
+                for (size_t i = 0; i < (size_t) dimensions; i++)
+                {
+                    Element acc = t[i];
+                    for (size_t j = 0; j < (size_t) dimensions; j++)
+                        acc += r[i][j] * in[j];
+                    c[i] = acc;
+                }
+            }
+        }
+
     protected:
         RigidTfND_common()= default;
 
-        RigidTfND_common(const RigidTfND_common<dimensions, Element, ChildTemplate> &tr)
-        {
-            int_translation = tr.int_translation;
-            int_rotation = tr.int_rotation;
-        }
+        RigidTfND_common(const RigidTfND_common<dimensions, Element, ChildTemplate> &tr) = default;
+
+        RigidTfND_common(RigidTfND_common<dimensions, Element, ChildTemplate> &&tr) noexcept = default;
+
+        RigidTfND_common<dimensions, Element, ChildTemplate> &operator=(const RigidTfND_common<dimensions, Element, ChildTemplate> &tr) = default;
+
+        RigidTfND_common<dimensions, Element, ChildTemplate> &operator=(RigidTfND_common<dimensions, Element, ChildTemplate> &&tr) noexcept = default;
 
         explicit RigidTfND_common(const TranslationType &tr)
         {
@@ -277,7 +358,7 @@ namespace rtl
             int_rotation = rot;
         }
 
-        RigidTfND_common(const VectorType &rot_from, const VectorType &rot_to, const VectorType tr) : int_rotation(rot_from, rot_to), int_translation(tr)
+        RigidTfND_common(const VectorType &rot_from, const VectorType &rot_to, const VectorType tr) : int_translation(tr), int_rotation(rot_from, rot_to)
         {
         }
 
@@ -296,12 +377,6 @@ namespace rtl
         RotationType int_rotation;
 
     private:
-        RigidTfND_common<dimensions, Element, ChildTemplate> &operator=(const RigidTfND_common<dimensions, Element, ChildTemplate> &tr)
-        {
-            int_translation = tr.int_translation;
-            return *this;
-        }
-
         ChildType &childThis() { return static_cast<ChildType &>(*this); }
         const ChildType &childThis() const { return static_cast<ChildType const &>(*this); }
     };
@@ -326,7 +401,10 @@ namespace rtl
         RigidTfND() = default;
 
         //! Copy constructor.
-        RigidTfND(const RigidTfND<dimensions, Element> &tr) : RigidTfND_common<dimensions, Element, RigidTfND>(tr) {}
+        RigidTfND(const RigidTfND<dimensions, Element> &tr) = default;
+
+        //! Move constructor.
+        RigidTfND(RigidTfND<dimensions, Element> &&tr) noexcept = default;
 
         //! From translation constructor. Rotation is initialized to identity.
         explicit RigidTfND(const TranslationType &tr) : RigidTfND_common<dimensions, Element, RigidTfND>(tr) {}
@@ -341,12 +419,10 @@ namespace rtl
         RigidTfND(const VectorType &rot_from, const VectorType &rot_to, const VectorType tr) : RigidTfND_common<dimensions, Element, RigidTfND>(rot_from, rot_to, tr) {}
 
         //! Assignment operator.
-        RigidTfND<dimensions, Element> &operator=(const RigidTfND<dimensions, Element> &tr)
-        {
-            this->int_translation = tr.int_translation;
-            this->int_rotation = tr.int_rotation;
-            return *this;
-        }
+        RigidTfND<dimensions, Element> &operator=(const RigidTfND<dimensions, Element> &tr) = default;
+
+        //! Move assignment operator.
+        RigidTfND<dimensions, Element> &operator=(RigidTfND<dimensions, Element> &&tr) noexcept = default;
     };
 
     //! Two dimensional specialization of TranslationND template.
@@ -367,7 +443,10 @@ namespace rtl
         RigidTfND() = default;
 
         //! Copy constructor.
-        RigidTfND(const RigidTfND<2, Element> &tr) : RigidTfND_common<2, Element, RigidTfND>(tr) {}
+        RigidTfND(const RigidTfND<2, Element> &tr) = default;
+
+        //! Move constructor.
+        RigidTfND(RigidTfND<2, Element> &&tr) noexcept = default;
 
         //! From translation constructor. Rotation is initialized to identity.
         explicit RigidTfND(const TranslationType &tr) : RigidTfND_common<2, Element, RigidTfND>(tr) {}
@@ -388,12 +467,10 @@ namespace rtl
         RigidTfND(Element angle, const VectorType &tr) : RigidTfND_common<2, Element, RigidTfND>(RotationType(angle), TranslationType(tr)) {}
 
         //! Assignment operator.
-        RigidTfND<2, Element> &operator=(const RigidTfND<2, Element> &tr)
-        {
-            this->int_translation = tr.int_translation;
-            this->int_rotation = tr.int_rotation;
-            return *this;
-        }
+        RigidTfND<2, Element> &operator=(const RigidTfND<2, Element> &tr) = default;
+
+        //! Move assignment operator.
+        RigidTfND<2, Element> &operator=(RigidTfND<2, Element> &&tr) noexcept = default;
 
         //! \a x element of the translation vector of the transformation.
         /*!
@@ -458,21 +535,51 @@ namespace rtl
         //! Rotation angle in counter-clockwise direction.
         /*!
          *
+         * @tparam Trig trigonometric policy, TrigStd or TrigFast.
          * @return rotation angle in radians.
          */
+        template<typename Trig = TrigStd>
         Element rotAngle() const
         {
-            return this->int_rotation.rotAngle();
+            return this->int_rotation.template rotAngle<Trig>();
         }
 
         //! Recalculate the rotation for given angle.
         /*!
          *
+         * @tparam Trig trigonometric policy, TrigStd or TrigFast.
          * @param angle rotation angle in the counter-clockwise direction.
          */
+        template<typename Trig = TrigStd>
         void setAngle(Element angle)
         {
-            this->int_rotation.setAngle(angle);
+            this->int_rotation.template setAngle<Trig>(angle);
+        }
+
+        //! Batch construction of transformations from arrays of angles and translations.
+        /*!
+         * Rotations are built block-wise by RotationND<2, Element>::fromAngles(), so the trigonometric policy may vectorize over the angles. An exception is thrown if the sizes
+         * of the views do not match.
+         * @tparam Trig trigonometric policy, TrigStd or TrigFast.
+         * @param angles rotation angles in the counter-clockwise direction in radians.
+         * @param tr_x translations along the \a x axis.
+         * @param tr_y translations along the \a y axis.
+         * @param out view of the transformations to be set.
+         */
+        template<typename Trig = TrigStd>
+        static void fromAngles(Span<const Element> angles, Span<const Element> tr_x, Span<const Element> tr_y, Span<RigidTfND<2, Element>> out)
+        {
+            if (angles.size() != out.size() || tr_x.size() != out.size() || tr_y.size() != out.size())
+                throw std::invalid_argument("RigidTfND::fromAngles(): input and output sizes do not match.");
+            constexpr size_t block_size = 256;
+            RotationType rot[block_size];
+            for (size_t beg = 0; beg < angles.size(); beg += block_size)
+            {
+                size_t n = std::min(block_size, angles.size() - beg);
+                RotationType::template fromAngles<Trig>(angles.subspan(beg, n), Span<RotationType>(rot, n));
+                for (size_t i = 0; i < n; i++)
+                    out[beg + i] = RigidTfND<2, Element>(rot[i], TranslationType(tr_x[beg + i], tr_y[beg + i]));
+            }
         }
     };
 
@@ -494,7 +601,10 @@ namespace rtl
         RigidTfND() = default;
 
         //! Copy constructor.
-        RigidTfND(const RigidTfND<3, Element> &tr) : RigidTfND_common<3, Element, RigidTfND>(tr) {}
+        RigidTfND(const RigidTfND<3, Element> &tr) = default;
+
+        //! Move constructor.
+        RigidTfND(RigidTfND<3, Element> &&tr) noexcept = default;
 
         //! From translation constructor. Rotation is initialized to identity.
         explicit RigidTfND(const TranslationType &tr) : RigidTfND_common<3, Element, RigidTfND>(tr) {}
@@ -518,12 +628,10 @@ namespace rtl
         RigidTfND(ElementType roll, ElementType pitch, ElementType yaw, const VectorType &tr) : RigidTfND_common<3, Element, RigidTfND>(RotationType(roll, pitch, yaw), TranslationType(tr)) {}
 
         //! Assignment operator.
-        RigidTfND<3, Element> &operator=(const RigidTfND<3, Element> &tr)
-        {
-            this->int_translation = tr.int_translation;
-            this->int_rotation = tr.int_rotation;
-            return *this;
-        }
+        RigidTfND<3, Element> &operator=(const RigidTfND<3, Element> &tr) = default;
+
+        //! Move assignment operator.
+        RigidTfND<3, Element> &operator=(RigidTfND<3, Element> &&tr) noexcept = default;
 
         //! \a x element of the translation vector of the transformation.
         /*!
@@ -27,6 +27,10 @@
 #ifndef ROBOTICTEMPLATELIBRARY_ROTATIONND_H
 #define ROBOTICTEMPLATELIBRARY_ROTATIONND_H
 
+#include <stdexcept>
+
+#include "rtl/core/Span.h"
+#include "rtl/core/Trigonometry.h"
 #include "rtl/core/VectorND.h"
 #include "rtl/core/Matrix.h"
 #include "rtl/core/Quaternion.h"
@@ -72,6 +76,17 @@ namespace rtl
             return int_rot_mat;
         }
 
+        //! Sets new rotation directly from a rotation matrix.
+        /*!
+         * The matrix is taken as is, no orthonormalization takes place. Intended for restoring previously stored rotations bit-exactly.
+         * @param mat new rotation matrix.
+         */
+        void setRotMat(const MatrixType &mat)
+        {
+            int_rot_mat = mat;
+            childThis().rotMatUpdated();
+        }
+
         //! Sets new rotation using two vectors.
         /*!
          *
@@ -210,10 +225,13 @@ namespace rtl
     protected:
         RotationND_common()= default;
 
-        RotationND_common(const RotationND_common<dimensions, Element, ChildTemplate> &tr)
-        {
-            int_rot_mat = tr.int_rot_mat;
-        }
+        RotationND_common(const RotationND_common<dimensions, Element, ChildTemplate> &tr) = default;
+
+        RotationND_common(RotationND_common<dimensions, Element, ChildTemplate> &&tr) noexcept = default;
+
+        RotationND_common<dimensions, Element, ChildTemplate> &operator=(const RotationND_common<dimensions, Element, ChildTemplate> &tr) = default;
+
+        RotationND_common<dimensions, Element, ChildTemplate> &operator=(RotationND_common<dimensions, Element, ChildTemplate> &&tr) noexcept = default;
 
         explicit RotationND_common(const ChildType &tr)
         {
@@ -236,12 +254,6 @@ namespace rtl
         MatrixType int_rot_mat;
 
     private:
-        RotationND_common<dimensions, Element, ChildTemplate> &operator=(const RotationND_common<dimensions, Element, ChildTemplate> &rot)
-        {
-            int_rot_mat = rot.int_rot_mat;
-            return *this;
-        }
-
         void rotMatUpdated() {}
         ChildType &childThis() { return static_cast<ChildType &>(*this); }
         const ChildType &childThis() const { return static_cast<ChildType const &>(*this); }
@@ -267,17 +279,19 @@ namespace rtl
         RotationND() = default;
 
         //! Copy constructor.
-        RotationND(const RotationND<dimensions, Element> &rot) : RotationND_common<dimensions, Element, RotationND>(rot) {}
+        RotationND(const RotationND<dimensions, Element> &rot) = default;
+
+        //! Move constructor.
+        RotationND(RotationND<dimensions, Element> &&rot) noexcept = default;
 
         //! Two vector construction.
         RotationND(const VectorType &v1, const VectorType &v2) : RotationND_common<dimensions, Element, RotationND>(v1, v2) {}
 
         //! Assignment operator.
-        RotationND<dimensions, Element> &operator=(const RotationND<dimensions, Element> &rot)
-        {
-            this->int_rot_mat = rot.int_rot_mat;
-            return *this;
-        }
+        RotationND<dimensions, Element> &operator=(const RotationND<dimensions, Element> &rot) = default;
+
+        //! Move assignment operator.
+        RotationND<dimensions, Element> &operator=(RotationND<dimensions, Element> &&rot) noexcept = default;
     };
 
     //! Two dimensional specialization of RotationND template.
@@ -297,7 +311,10 @@ namespace rtl
         RotationND() = default;
 
         //! Copy constructor.
-        RotationND(const RotationND<2, Element> &rot) : RotationND_common<2, Element, RotationND>(rot) {}
+        RotationND(const RotationND<2, Element> &rot) = default;
+
+        //! Move constructor.
+        RotationND(RotationND<2, Element> &&rot) noexcept = default;
 
         //! Two vector construction.
         RotationND(const VectorType &v1, const VectorType &v2) : RotationND_common<2, Element, RotationND>(v1, v2) {}
@@ -332,11 +349,10 @@ namespace rtl
         }
 
         //! Assignment operator.
-        RotationND<2, Element> &operator=(const RotationND<2, Element> &rot)
-        {
-            this->int_rot_mat = rot.int_rot_mat;
-            return *this;
-        }
+        RotationND<2, Element> &operator=(const RotationND<2, Element> &rot) = default;
+
+        //! Move assignment operator.
+        RotationND<2, Element> &operator=(RotationND<2, Element> &&rot) noexcept = default;
 
         //! Cosine of the angle of rotation.
         /*!
@@ -361,23 +377,73 @@ namespace rtl
         //! Rotation angle in counter-clockwise direction.
         /*!
          *
+         * @tparam Trig trigonometric policy, TrigStd or TrigFast.
          * @return rotation angle in radians.
          */
+        template<typename Trig = TrigStd>
         Element rotAngle() const
         {
-            return std::atan2(rotSin(), rotCos());
+            return Trig::atan2(rotSin(), rotCos());
         }
 
         //! Recalculate the rotation for given angle.
         /*!
          *
+         * @tparam Trig trigonometric policy, TrigStd or TrigFast.
          * @param angle rotation angle in the counter-clockwise direction in radians.
          */
+        template<typename Trig = TrigStd>
         void setAngle(Element angle)
         {
-            this->int_rot_mat(0, 0) = this->int_rot_mat(1, 1) = std::cos(angle);
-            this->int_rot_mat(1, 0) = std::sin(angle);
-            this->int_rot_mat(0, 1) = -this->int_rot_mat(1, 0);
+            Element sin_a, cos_a;
+            Trig::sincos(angle, sin_a, cos_a);
+            setSinCos(sin_a, cos_a);
+        }
+
+        //! Batch construction of rotations from an array of angles.
+        /*!
+         * Sines and cosines are evaluated block-wise over contiguous arrays, which lets the trigonometric policy vectorize them. An exception is thrown if the sizes of the views
+         * do not match.
+         * @tparam Trig trigonometric policy, TrigStd or TrigFast.
+         * @param angles rotation angles in the counter-clockwise direction in radians.
+         * @param out view of the rotations to be set.
+         */
+        template<typename Trig = TrigStd>
+        static void fromAngles(Span<const Element> angles, Span<RotationND<2, Element>> out)
+        {
+            if (angles.size() != out.size())
+                throw std::invalid_argument("RotationND::fromAngles(): input and output sizes do not match.");
+            constexpr size_t block_size = 256;
+            Element sin_a[block_size], cos_a[block_size];
+            for (size_t beg = 0; beg < angles.size(); beg += block_size)
+            {
+                size_t n = std::min(block_size, angles.size() - beg);
+                Trig::sincos(angles.subspan(beg, n), sin_a, cos_a);
+                for (size_t i = 0; i < n; i++)
+                    out[beg + i].setSinCos(sin_a[i], cos_a[i]);
+            }
+        }
+
+        //! Interpolation between *this and \p rot along the shorter arc.
+        /*!
+         *
+         * @param rot the other rotation.
+         * @param scale interpolation parameter in the range [0; 1], 0 returns *this, 1 returns \p rot.
+         * @return interpolated rotation.
+         */
+        RotationND<2, Element> interpolated(const RotationND<2, Element> &rot, Element scale) const
+        {
+            Element a = rotAngle();
+            Element diff = std::atan2(std::sin(rot.rotAngle() - a), std::cos(rot.rotAngle() - a));
+            return RotationND<2, Element>(a + diff * scale);
+        }
+
+    private:
+        void setSinCos(Element sin_a, Element cos_a)
+        {
+            this->int_rot_mat(0, 0) = this->int_rot_mat(1, 1) = cos_a;
+            this->int_rot_mat(1, 0) = sin_a;
+            this->int_rot_mat(0, 1) = -sin_a;
         }
     };
 
@@ -398,7 +464,10 @@ namespace rtl
         RotationND() = default;
 
         //! Copy constructor.
-        RotationND(const RotationND<3, Element> &rot) : RotationND_common<3, Element, RotationND>(rot), int_aa(rot.int_aa) {}
+        RotationND(const RotationND<3, Element> &rot) = default;
+
+        //! Move constructor.
+        RotationND(RotationND<3, Element> &&rot) noexcept = default;
 
         //! Two vector construction.
         RotationND(const VectorType &v1, const VectorType &v2)
@@ -422,12 +491,10 @@ namespace rtl
         RotationND(ElementType roll, ElementType pitch, ElementType yaw) : RotationND(Quaternion<ElementType>(roll, pitch, yaw)) {}
 
         //! Assignment operator.
-        RotationND<3, Element> &operator=(const RotationND<3, Element> &rot)
-        {
-            this->int_rot_mat = rot.int_rot_mat;
-            int_aa = rot.int_aa;
-            return *this;
-        }
+        RotationND<3, Element> &operator=(const RotationND<3, Element> &rot) = default;
+
+        //! Move assignment operator.
+        RotationND<3, Element> &operator=(RotationND<3, Element> &&rot) noexcept = default;
 
         //! Sets new rotation using two vectors.
         /*!
@@ -493,6 +560,18 @@ namespace rtl
             return Quaternion(q.w(), q.x(), q.y(), q.z());
         }
 
+        //! Spherical linear interpolation between *this and \p rot.
+        /*!
+         * Uses Quaternion::slerp(), the interpolation follows the shorter arc.
+         * @param rot the other rotation.
+         * @param scale interpolation parameter in the range [0; 1], 0 returns *this, 1 returns \p rot.
+         * @return interpolated rotation.
+         */
+        [[nodiscard]] RotationND<3, Element> interpolated(const RotationND<3, Element> &rot, Element scale) const
+        {
+            return RotationND<3, Element>(rotQuaternion().slerp(rot.rotQuaternion(), scale));
+        }
+
         //! Equivalent roll-pitch-yaw angles.
         /*!
          * Does not necessarily return RPY used for construction of the transformation, other valid combinations representing the same rotation are possible as well.
@@ -0,0 +1,155 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_STATICRIGIDTFND_H
+#define ROBOTICTEMPLATELIBRARY_STATICRIGIDTFND_H
+
+#include "rtl/core/Trigonometry.h"
+#include "rtl/core/StaticTypes.h"
+#include "rtl/tf/RigidTfND.h"
+
+namespace rtl
+{
+    //! Rigid transformation in 2D or 3D usable in constant expressions.
+    /*!
+     * Counterpart of RigidTfND for transformations known at compile time, such as extrinsic calibrations and static frames. The rotation is kept as a StaticMatrix and
+     * the translation as a StaticVectorND, so construction, composition, inversion and application to StaticVectorND points are all constexpr. Chains of constant
+     * transformations therefore fold into a single constant, either by transformed() or by a constexpr StaticTfChain, and are converted to RigidTfND by toRigidTf()
+     * once, where the run-time interface is needed.
+     *
+     * The semantics follows RigidTfND: a.transformed(b) applies \a a first and \a b second.
+     * @tparam dimensions dimensionality of the transformation, 2 or 3.
+     * @tparam Element base type of the transformation elements.
+     */
+    template<int dimensions, typename Element>
+    class StaticRigidTfND
+    {
+        static_assert(dimensions == 2 || dimensions == 3, "StaticRigidTfND is implemented for two and three dimensions only.");
+
+    public:
+        typedef Element ElementType;                                    //!< Base type for transformation elements.
+        typedef StaticVectorND<dimensions, Element> VectorType;         //!< Type of the translation vector and of the transformed points.
+        typedef StaticMatrix<dimensions, dimensions, Element> MatrixType; //!< Type of the rotation matrix.
+        typedef RigidTfND<dimensions, Element> RuntimeType;             //!< Run-time counterpart of the transformation.
+
+        //! Default constructor, identity transformation.
+        constexpr StaticRigidTfND() : int_rot(MatrixType::identity()), int_tr() {}
+
+        //! Construction from a rotation matrix and a translation vector.
+        constexpr StaticRigidTfND(const MatrixType &rot_mat, const VectorType &tr) : int_rot(rot_mat), int_tr(tr) {}
+
+        //! Construction from a rotation angle and translation, two dimensions only.
+        constexpr StaticRigidTfND(Element angle, Element tr_x, Element tr_y) : int_rot(), int_tr(tr_x, tr_y)
+        {
+            static_assert(dimensions == 2, "Angle construction requires two dimensions.");
+            Element s = 0, c = 0;
+            TrigConstexpr::sincos(angle, s, c);
+            int_rot = MatrixType(c, -s, s, c);
+        }
+
+        //! Construction from a rotation quaternion and a translation vector, three dimensions only.
+        constexpr StaticRigidTfND(const StaticQuaternion<Element> &quat, const VectorType &tr) : int_rot(quat.normalized().rotMat()), int_tr(tr)
+        {
+            static_assert(dimensions == 3, "Quaternion construction requires three dimensions.");
+        }
+
+        //! Construction from an angle-axis representation of the rotation and a translation vector, three dimensions only.
+        constexpr StaticRigidTfND(Element angle, const VectorType &axis, const VectorType &tr)
+                : StaticRigidTfND(StaticQuaternion<Element>::fromAngleAxis(angle, axis), tr) {}
+
+        //! Construction from roll-pitch-yaw format of rotation and a translation vector, three dimensions only.
+        constexpr StaticRigidTfND(Element roll, Element pitch, Element yaw, const VectorType &tr)
+                : StaticRigidTfND(StaticQuaternion<Element>::fromRPY(roll, pitch, yaw), tr) {}
+
+        //! Identity transformation.
+        static constexpr StaticRigidTfND identity() { return StaticRigidTfND(); }
+
+        //! Rotation matrix of the transformation.
+        [[nodiscard]] constexpr const MatrixType &rotMat() const { return int_rot; }
+
+        //! Translation vector of the transformation.
+        [[nodiscard]] constexpr const VectorType &trVec() const { return int_tr; }
+
+        //! Rotation angle, two dimensions only.
+        [[nodiscard]] constexpr Element rotAngle() const
+        {
+            static_assert(dimensions == 2, "StaticRigidTfND::rotAngle() requires two dimensions.");
+            return TrigConstexpr::atan2(int_rot(1, 0), int_rot(0, 0));
+        }
+
+        //! Rotation quaternion, three dimensions only.
+        [[nodiscard]] constexpr StaticQuaternion<Element> rotQuaternion() const
+        {
+            static_assert(dimensions == 3, "StaticRigidTfND::rotQuaternion() requires three dimensions.");
+            return StaticQuaternion<Element>::fromRotMat(int_rot);
+        }
+
+        //! Applies the transformation on point \p v.
+        constexpr VectorType operator()(const VectorType &v) const { return int_rot * v + int_tr; }
+
+        //! Applies the transformation on a run-time point \p v.
+        VectorND<dimensions, Element> operator()(const VectorND<dimensions, Element> &v) const { return operator()(VectorType(v)).toVectorND(); }
+
+        //! Composition with \p tf, *this is applied first and \p tf second.
+        [[nodiscard]] constexpr StaticRigidTfND transformed(const StaticRigidTfND &tf) const
+        {
+            return StaticRigidTfND(tf.int_rot * int_rot, tf.int_rot * int_tr + tf.int_tr);
+        }
+
+        //! In-place composition with \p tf, *this is applied first and \p tf second.
+        constexpr void transform(const StaticRigidTfND &tf) { *this = transformed(tf); }
+
+        //! Inverse transformation.
+        [[nodiscard]] constexpr StaticRigidTfND inverted() const
+        {
+            MatrixType rot_t = int_rot.transposed();
+            return StaticRigidTfND(rot_t, -(rot_t * int_tr));
+        }
+
+        //! In-place inversion.
+        constexpr void invert() { *this = inverted(); }
+
+        friend constexpr bool operator==(const StaticRigidTfND &a, const StaticRigidTfND &b) { return a.int_rot == b.int_rot && a.int_tr == b.int_tr; }
+        friend constexpr bool operator!=(const StaticRigidTfND &a, const StaticRigidTfND &b) { return !(a == b); }
+
+        //! Run-time counterpart of the transformation.
+        [[nodiscard]] RuntimeType toRigidTf() const
+        {
+            typename RuntimeType::VectorType tr = int_tr.toVectorND();
+            if constexpr (dimensions == 2)
+                return RuntimeType(typename RuntimeType::VectorType(1, 0), typename RuntimeType::VectorType(int_rot(0, 0), int_rot(1, 0)), tr);
+            else
+                return RuntimeType(rotQuaternion().toQuaternion(), tr);
+        }
+
+    private:
+        MatrixType int_rot;
+        VectorType int_tr;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_STATICRIGIDTFND_H
@@ -0,0 +1,148 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_STATICTFCHAIN_H
+#define ROBOTICTEMPLATELIBRARY_STATICTFCHAIN_H
+
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+namespace rtl
+{
+    /*!
+     * StaticTfChain is a chain of transformations with types fixed at compile time, suitable for chains which do not change their structure, e.g. camera -> imu -> base_link.
+     * The transformations are stored in a std::tuple, so no GeneralTf variant and no run-time dispatch is involved. The type of the squashed transformation is folded at
+     * compile time from the types in the chain (e.g. TranslationND followed by RotationND gives RigidTfND) and its value is composed once at construction and after each set().
+     * Applying the chain therefore costs a single transformation regardless of its length. With transformations usable in constant expressions, such as StaticRigidTfND,
+     * the whole chain can be declared constexpr and the squashed transformation is composed at compile time.
+     * @tparam Tfs types of the transformations in the order of application.
+     */
+    template<typename... Tfs>
+    class StaticTfChain
+    {
+        static_assert(sizeof...(Tfs) > 0, "StaticTfChain has to contain at least one transformation.");
+
+        template<typename Acc, typename... Rest>
+        struct SquashFold { using type = Acc; };
+
+        template<typename Acc, typename Next, typename... Rest>
+        struct SquashFold<Acc, Next, Rest...>
+        {
+            using type = typename SquashFold<decltype(std::declval<const Acc &>().transformed(std::declval<const Next &>())), Rest...>::type;
+        };
+
+    public:
+        using TupleType = std::tuple<Tfs...>;                           //!< Type of the internal storage of the transformations.
+        using SquashedType = typename SquashFold<Tfs...>::type;         //!< Type of the single transformation equivalent to the whole chain.
+
+        //! Construction from the transformations in the order of application.
+        /*!
+         *
+         * @param tfs the transformations.
+         */
+        constexpr explicit StaticTfChain(const Tfs &... tfs) : int_tfs(tfs...), int_squashed(squashTuple(std::index_sequence_for<Tfs...>{})) {}
+
+        //! Number of transformations in the chain.
+        static constexpr size_t size() { return sizeof...(Tfs); }
+
+        //! Read access to the \p I -th transformation.
+        template<size_t I>
+        [[nodiscard]] constexpr const auto &get() const
+        {
+            return std::get<I>(int_tfs);
+        }
+
+        //! Replaces the \p I -th transformation and recomposes the squashed transformation.
+        /*!
+         *
+         * @tparam I index of the transformation.
+         * @param tf new value of the transformation.
+         */
+        template<size_t I>
+        void set(const std::tuple_element_t<I, TupleType> &tf)
+        {
+            std::get<I>(int_tfs) = tf;
+            int_squashed = squashTuple(std::index_sequence_for<Tfs...>{});
+        }
+
+        //! All transformations of the chain.
+        [[nodiscard]] constexpr const TupleType &tuple() const
+        {
+            return int_tfs;
+        }
+
+        //! Single transformation equivalent to the whole chain.
+        /*!
+         *
+         * @return reference to the transformation composed at construction or the last set().
+         */
+        [[nodiscard]] constexpr const SquashedType &squash() const
+        {
+            return int_squashed;
+        }
+
+        //! Applies the whole chain on \p obj by a single transformation.
+        /*!
+         *
+         * @tparam Object type of the object to be transformed.
+         * @param obj the object to be transformed.
+         * @return a new transformed object.
+         */
+        template<typename Object>
+        constexpr auto operator()(const Object &obj) const
+        {
+            return int_squashed(obj);
+        }
+
+    private:
+        template<typename Acc>
+        static constexpr auto squashFold(const Acc &acc)
+        {
+            return acc;
+        }
+
+        template<typename Acc, typename Next, typename... Rest>
+        static constexpr auto squashFold(const Acc &acc, const Next &next, const Rest &... rest)
+        {
+            return squashFold(acc.transformed(next), rest...);
+        }
+
+        template<size_t... Is>
+        constexpr SquashedType squashTuple(std::index_sequence<Is...>) const
+        {
+            return squashFold(std::get<Is>(int_tfs)...);
+        }
+
+        TupleType int_tfs;
+        SquashedType int_squashed;
+    };
+
+    template<typename... Tfs>
+    StaticTfChain(const Tfs &...) -> StaticTfChain<Tfs...>;
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_STATICTFCHAIN_H
@@ -0,0 +1,243 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_TFBUFFER_H
+#define ROBOTICTEMPLATELIBRARY_TFBUFFER_H
+
+#include <vector>
+#include <stdexcept>
+#include <utility>
+
+namespace rtl
+{
+    /*!
+     * TfBuffer is a bounded, time-ordered history of a single transformation, such as the one between two adjacent nodes of the TfTree. The entries are kept in a ring buffer
+     * of fixed capacity, so the memory does not grow with the length of the history and inserting a new transformation drops the oldest one once the buffer is full.
+     * Transformations at arbitrary time instants between the oldest and the newest entry are obtained by binary search and interpolation between the two neighbouring entries
+     * using the interpolated() method of the transformation type (linear interpolation for translations, spherical linear interpolation for rotations).
+     * @tparam T type of the transformation.
+     * @tparam Time type of the time stamps.
+     */
+    template<typename T, typename Time = double>
+    class TfBuffer
+    {
+    public:
+        typedef T TransformationType;   //!< Type of the transformations in the buffer.
+        typedef Time TimeType;          //!< Type of the time stamps.
+
+        //! Default constructor. The buffer has zero capacity and ignores all insertions until setCapacity() is called.
+        TfBuffer() = default;
+
+        //! Construction of an empty buffer with given capacity.
+        /*!
+         *
+         * @param capacity maximal number of stored transformations.
+         */
+        explicit TfBuffer(size_t capacity) : int_entries(capacity) {}
+
+        //! Default destructor.
+        ~TfBuffer() = default;
+
+        //! Maximal number of stored transformations.
+        [[nodiscard]] size_t capacity() const { return int_entries.size(); }
+
+        //! Number of stored transformations.
+        [[nodiscard]] size_t size() const { return int_size; }
+
+        //! Checks for an empty buffer.
+        [[nodiscard]] bool empty() const { return int_size == 0; }
+
+        //! Removes all stored transformations, the capacity is kept.
+        void clear()
+        {
+            int_head = 0;
+            int_size = 0;
+        }
+
+        //! Changes capacity of the buffer.
+        /*!
+         * If the new capacity is lower than current size, the oldest entries are dropped.
+         * @param capacity new capacity.
+         */
+        void setCapacity(size_t capacity)
+        {
+            std::vector<Entry> entries;
+            entries.reserve(capacity);
+            for (size_t i = int_size > capacity ? int_size - capacity : 0; i < int_size; i++)
+                entries.push_back(entry(i));
+            int_size = entries.size();
+            entries.resize(capacity);
+            int_entries = std::move(entries);
+            int_head = 0;
+        }
+
+        //! Inserts a new time-stamped transformation.
+        /*!
+         * Transformations are expected to arrive in chronological order, but older entries are inserted into their proper position as well. An entry with the time stamp of
+         * an existing one replaces it. If the buffer is full, the oldest entry is dropped, entries older than all stored ones are not inserted into a full buffer at all.
+         * @param time time stamp of the transformation.
+         * @param tf the transformation.
+         * @return true if inserted, false otherwise.
+         */
+        bool insert(const TimeType &time, const TransformationType &tf)
+        {
+            if (capacity() == 0)
+                return false;
+
+            size_t pos = lowerBound(time);
+            if (pos < int_size && !(time < entry(pos).first))
+            {
+                entry(pos).second = tf;
+                return true;
+            }
+            if (int_size == capacity())
+            {
+                if (pos == 0)
+                    return false;
+                int_head = (int_head + 1) % capacity();     // drop the oldest entry
+                int_size--;
+                pos--;
+            }
+            int_size++;
+            for (size_t i = int_size - 1; i > pos; i--)
+                entry(i) = std::move(entry(i - 1));
+            entry(pos) = Entry(time, tf);
+            return true;
+        }
+
+        //! Time stamp of the oldest stored transformation.
+        /*!
+         * Throws std::out_of_range if the buffer is empty.
+         * @return the oldest time stamp.
+         */
+        [[nodiscard]] const TimeType &oldestTime() const
+        {
+            checkEmpty();
+            return entry(0).first;
+        }
+
+        //! Time stamp of the newest stored transformation.
+        /*!
+         * Throws std::out_of_range if the buffer is empty.
+         * @return the newest time stamp.
+         */
+        [[nodiscard]] const TimeType &newestTime() const
+        {
+            checkEmpty();
+            return entry(int_size - 1).first;
+        }
+
+        //! The newest stored transformation.
+        /*!
+         * Throws std::out_of_range if the buffer is empty.
+         * @return reference to the newest transformation.
+         */
+        [[nodiscard]] const TransformationType &newest() const
+        {
+            checkEmpty();
+            return entry(int_size - 1).second;
+        }
+
+        //! Access to stored entries in chronological order.
+        /*!
+         *
+         * @param i index of the entry, 0 corresponds to the oldest one.
+         * @return pair of the time stamp and the transformation.
+         */
+        const std::pair<TimeType, TransformationType> &operator[](size_t i) const
+        {
+            return entry(i);
+        }
+
+        //! Checks whether the transformation at time \p time can be obtained by interpolation.
+        /*!
+         *
+         * @param time the time instant.
+         * @return true if \p time lies between the oldest and the newest time stamps, false otherwise.
+         */
+        [[nodiscard]] bool covers(const TimeType &time) const
+        {
+            return int_size > 0 && !(time < entry(0).first) && !(entry(int_size - 1).first < time);
+        }
+
+        //! Transformation at given time instant.
+        /*!
+         * The two entries surrounding \p time are found by binary search and interpolated. Throws std::out_of_range if \p time is not covered by the buffer, see covers().
+         * @param time the time instant.
+         * @return interpolated transformation.
+         */
+        [[nodiscard]] TransformationType at(const TimeType &time) const
+        {
+            if (!covers(time))
+                throw std::out_of_range("The time instant is not covered by given TfBuffer.");
+
+            size_t pos = lowerBound(time);
+            const auto &e1 = entry(pos);
+            if (!(time < e1.first))
+                return e1.second;
+            const auto &e0 = entry(pos - 1);
+            auto scale = static_cast<typename TransformationType::ElementType>((time - e0.first) / (e1.first - e0.first));
+            return e0.second.interpolated(e1.second, scale);
+        }
+
+    private:
+        typedef std::pair<TimeType, TransformationType> Entry;
+
+        Entry &entry(size_t i) { return int_entries[(int_head + i) % int_entries.size()]; }
+
+        const Entry &entry(size_t i) const { return int_entries[(int_head + i) % int_entries.size()]; }
+
+        // Index of the first entry with time stamp not lower than time.
+        size_t lowerBound(const TimeType &time) const
+        {
+            size_t first = 0, count = int_size;
+            while (count > 0)
+            {
+                size_t step = count / 2;
+                if (entry(first + step).first < time)
+                {
+                    first += step + 1;
+                    count -= step + 1;
+                }
+                else
+                    count = step;
+            }
+            return first;
+        }
+
+        void checkEmpty() const
+        {
+            if (int_size == 0)
+                throw std::out_of_range("Accessing an empty TfBuffer.");
+        }
+
+        std::vector<Entry> int_entries;
+        size_t int_head{0}, int_size{0};
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_TFBUFFER_H
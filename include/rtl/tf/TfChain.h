@@ -29,21 +29,35 @@
 
 #include <list>
 #include <type_traits>
+#include <variant>
+#include <iterator>
+#include <algorithm>
+
+#include "rtl/core/SmallVector.h"
+#include "rtl/core/Span.h"
 
 
 namespace rtl
 {
+    template<typename... Tfs>
+    class GeneralTf;
+
     /*!
      * TfChain is a container class for storing a list of transformations. Works with GeneralTf, so multiple types of regular transformations can be kept in one TfChain and
      * can be applied via operator() on an object, consecutively applying all transformations in the chain. Now it is only used as a return type of queries on transformations
      * between nodes on the TfTree class.
+     *
+     * The transformations are kept in a contiguous SmallVector with inline capacity for \p inline_size transformations, so chains of typical depth are built and applied without
+     * any heap allocation.
      * @tparam T type of the transformations stored.
+     * @tparam inline_size number of transformations stored without heap allocation.
      */
-    template<typename T>
+    template<typename T, size_t inline_size = 8>
     class TfChain
     {
     public:
         using TransformationType = T;
+        using StorageType = SmallVector<TransformationType, inline_size>;   //!< Type of the internal storage of transformations.
 
         //! Default constructor is deleted.
         TfChain()=default;
@@ -67,7 +81,22 @@ namespace rtl
          *
          * @param list transformations to be stored in the transformation chain.
          */
-        explicit TfChain(const std::list<TransformationType> &list) : tfs_list(list) {}
+        explicit TfChain(const std::list<TransformationType> &list) : tfs_list(list.begin(), list.end()) {}
+
+        //! Constructor from a SmallVector of transformations.
+        /*!
+         * Passing an rvalue of StorageType moves the transformations without copying.
+         * @tparam M inline capacity of the source SmallVector.
+         * @param tfs transformations to be stored in the transformation chain.
+         */
+        template<size_t M>
+        explicit TfChain(SmallVector<TransformationType, M> tfs)
+        {
+            if constexpr (M == inline_size)
+                tfs_list = std::move(tfs);
+            else
+                tfs_list = StorageType(std::make_move_iterator(tfs.begin()), std::make_move_iterator(tfs.end()));
+        }
 
         //! Copy-assignment operator.
         /*!
@@ -129,16 +158,77 @@ namespace rtl
             }
         }
 
+        //! In-place consecutive application of all transformations in the chain on \p obj.
+        /*!
+         * Unlike operator(), the transformed object keeps its type, therefore \p obj may also be a whole array of objects implementing transform() for the transformations in
+         * the chain, such as rtl::PointCloudND. Throws std::out_of_range for an empty chain and std::bad_variant_access if a GeneralTf in the chain cannot transform \p obj in-place.
+         * @tparam Object type of the object to be transformed.
+         * @param obj the object to be transformed.
+         */
+        template<typename Object>
+        void applyTo(Object &obj) const
+        {
+            applyTo(Span<Object>(&obj, 1));
+        }
+
+        //! In-place consecutive application of all transformations in the chain on a batch of objects.
+        /*!
+         * The objects are processed in blocks of apply_block_size, each block passes through the whole chain while it is hot in cache. A GeneralTf in the chain is resolved
+         * once per block instead of once per object. Throws std::out_of_range for an empty chain and std::bad_variant_access if a GeneralTf in the chain cannot transform
+         * \p Object in-place.
+         * @tparam Object type of the objects to be transformed.
+         * @param objs view of the objects to be transformed.
+         */
+        template<typename Object>
+        void applyTo(Span<Object> objs) const
+        {
+            if (tfs_list.empty())
+                throw std::out_of_range("Transforming by an empty TfChain.");
+
+            for (size_t beg = 0; beg < objs.size(); beg += apply_block_size)
+            {
+                Span<Object> block(objs.data() + beg, std::min(apply_block_size, objs.size() - beg));
+                for (const auto &t : tfs_list)
+                {
+                    if constexpr (is_general_tf_v<TransformationType>)
+                        t.applyTo(block);
+                    else
+                        for (auto &o : block)
+                            o.transform(t);
+                }
+            }
+        }
+
         //! Reference access to the internal list of transformations.
         /*!
          *
-         * @return reference the list of contained transformations.
+         * @return reference the contiguous sequence of contained transformations.
          */
-        [[nodiscard]] const std::list<TransformationType>& list() const
+        [[nodiscard]] const StorageType& list() const
         {
             return tfs_list;
         }
 
+        //! Number of transformations in the chain.
+        /*!
+         *
+         * @return number of transformations.
+         */
+        [[nodiscard]] size_t size() const
+        {
+            return tfs_list.size();
+        }
+
+        //! Checks for an empty chain.
+        /*!
+         *
+         * @return true if there are no transformations in the chain, false otherwise.
+         */
+        [[nodiscard]] bool empty() const
+        {
+            return tfs_list.empty();
+        }
+
         //! Tries to squash adjacent transformations together producing a single transformation representing the same transformation as the whole chain.
         /*!
          * If TransformationType transformed by another transformation type may throw, the squash() method may throw as well. This can happen when using GeneralTf with some incompatible
@@ -153,7 +243,42 @@ namespace rtl
             return aggregation;
         }
 
+        //! Pre-composes runs of consecutive compatible transformations into single transformations.
+        /*!
+         * Unlike squash(), collapse() never throws due to incompatible alternatives of GeneralTf. Adjacent transformations are composed while the composition is defined, and a new
+         * transformation is started otherwise. For regular transformation types, the result is a chain with a single transformation equivalent to squash(). Applying the collapsed
+         * chain is cheaper than applying the original one, which pays off when the same chain is used on many objects.
+         * @return collapsed chain representing the same transformation.
+         */
+        TfChain collapse() const
+        {
+            StorageType ret;
+            if (tfs_list.empty())
+                return TfChain(std::move(ret));
+
+            ret.push_back(tfs_list.front());
+            for (auto it = std::next(tfs_list.begin()); it != tfs_list.end(); it++)
+            {
+                if constexpr (is_general_tf_v<TransformationType>)
+                {
+                    try
+                    {
+                        ret.back() = ret.back().transformed(*it);
+                    }
+                    catch (const std::bad_variant_access &)
+                    {
+                        ret.push_back(*it);
+                    }
+                }
+                else
+                    ret.back().transform(*it);
+            }
+            return TfChain(std::move(ret));
+        }
+
     private:
+        static constexpr size_t apply_block_size = 1024;   // objects passed through the whole chain at once by applyTo()
+
         //! Function for generation of custom v-table of the operator().
         /*!
          *
@@ -188,7 +313,16 @@ namespace rtl
             static constexpr FuncPtr array[] = {(&TfChain::validlyTransform<Output, Objs>)...};
         };
 
-        std::list<TransformationType> tfs_list;
+        template<typename>
+        struct is_general_tf : std::false_type {};
+
+        template<typename... Tfs>
+        struct is_general_tf<GeneralTf<Tfs...>> : std::true_type {};
+
+        template<typename Tf>
+        static constexpr bool is_general_tf_v = is_general_tf<Tf>::value;
+
+        StorageType tfs_list;
     };
 }
 
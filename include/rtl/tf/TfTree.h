@@ -28,8 +28,18 @@
 #define ROBOTICTEMPLATELIBRARY_TFTREE_H
 
 #include <map>
-#include <list>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include <memory_resource>
 
+#include <stdexcept>
+
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/Span.h"
 #include "TfTreeNode.h"
 #include "GeneralTf.h"
 #include "VariantResult.h"
@@ -42,16 +52,28 @@ namespace rtl
      * in the tree and is uniquely identified by a key. Transformations between adjacent coordinate frames correspond to the edges of the tree graph. Tree-like structure forbids cycles in the
      * resulting graph, therefore between any two nodes, there is exactly one unique chain of transformations, which eliminates potential inconsistencies. The tree cannot be crated without
      * the root node.
+     *
+     * Nodes are constructed in place and never relocated during their lifetime, so the pointers linking them together serve as stable handles. Moving or swapping a whole tree
+     * only exchanges the internal containers, it takes constant time and does not touch the nodes, which makes it cheap to double-buffer trees with swap().
+     *
+     * The nodes and their sets of children are allocated by \p Allocator rebound to the respective element types, so the tree can be placed e.g. in a per-frame arena by
+     * std::pmr::polymorphic_allocator, see rtl::pmr::TfTree. Copies of the tree obtain their allocator by select_on_container_copy_construction(), as standard containers do.
+     *
+     * Const queries such as tf() and tfSquashed() lazily update transformation caches of the nodes, see TfTreeNode, therefore a TfTree must not be queried from several threads
+     * at once unless the caches have been primed. Use ConcurrentTfTree for trees shared between threads.
      * @tparam K Key type.
      * @tparam T Transformation type.
+     * @tparam Allocator allocator of the internal containers, rebound to their element types.
      */
-    template<typename K, typename T>
+    template<typename K, typename T, typename Allocator = std::allocator<std::byte>>
     class TfTree
     {
     public:
         typedef K KeyType;              //!< Type of the keys.
         typedef T TransformationType;   //!< Type of the transformations between nodes.
-        typedef TfTreeNode<KeyType, TransformationType> NodeType;   //!< Type of the nodes in the tree.
+        typedef Allocator AllocatorType;//!< Type of the allocator.
+        typedef TfTreeNode<KeyType, TransformationType, Allocator> NodeType;    //!< Type of the nodes in the tree.
+        typedef typename NodeType::TimeType TimeType;                           //!< Type of the time stamps of buffered transformations.
 
         TfTree() = delete;
 
@@ -59,11 +81,11 @@ namespace rtl
         /*!
          * TfTree cannot be constructed without root, therefore the implicit constructor is disabled anf the key of the root node has to be passed.
          * @param root_key key of the root node.
+         * @param alloc allocator of the internal containers.
          */
-        explicit TfTree(const KeyType root_key)
+        explicit TfTree(const KeyType root_key, const Allocator &alloc = Allocator()) : nodes(NodeAllocator(alloc))
         {
-            root_node_key = root_key;
-            nodes.emplace(root_key, NodeType(root_key));
+            insertRoot(root_key);
         }
 
         //! Copy constructor.
@@ -71,22 +93,26 @@ namespace rtl
          * Creates a deep copy of the tree.
          * @param cp tree to by copied.
          */
-        TfTree(const TfTree &cp) : nodes(cp.nodes), root_node_key(cp.root_node_key) {}
+        TfTree(const TfTree &cp) : nodes(std::allocator_traits<NodeAllocator>::select_on_container_copy_construction(cp.nodes.get_allocator()))
+        {
+            copyFrom(cp);
+        }
 
         //! Move constructor.
         /*!
-         * Moves content of \p mv to a new tree. The root node is than copied back to keep \p mv valid.
+         * Takes over the nodes of \p mv in constant time, no node is copied or relocated. \p mv is left empty and may only be assigned to or destroyed.
          * @param mv tree to be moved from.
          */
-        TfTree(TfTree &&mv) noexcept: nodes(mv.nodes), root_node_key(mv.root())
+        TfTree(TfTree &&mv) noexcept: nodes(std::move(mv.nodes)), root_node_key(std::move(mv.root_node_key))
         {
-            mv.insertRoot(root_node_key);
+            mv.nodes.clear();
         }
 
         //! Destructor.
         ~TfTree()
         {
-            clear();
+            if (!nodes.empty())
+                clear();
         }
 
         //! Copy assigment operator.
@@ -97,25 +123,62 @@ namespace rtl
          */
         TfTree &operator=(const TfTree &eq)
         {
-            nodes = eq.nodes;
-            root_node_key = eq.root_node_key;
+            if (this != &eq)
+            {
+                clear();
+                nodes.clear();
+                copyFrom(eq);
+            }
             return *this;
         }
 
         //! Move assigment operator.
         /*!
-         * Moves content of \p mv to a new tree. The root node is than copied back to keep \p mv valid.
+         * Takes over the nodes of \p mv in constant time (plus the destruction of the former content of *this), \p mv is left empty. If the allocators differ and do not
+         * propagate on move assignment, the nodes cannot be taken over and the content of \p mv is copied instead.
          * @param mv tree to be moved from.
          * @return reference to *this.
          */
-        TfTree &operator=(TfTree &&mv) noexcept
+        TfTree &operator=(TfTree &&mv) noexcept(nodes_movable)
         {
-            nodes = std::move(mv.nodes);
-            root_node_key = std::move(mv.root_node_key);
-            mv.insertRoot(root_node_key);
+            if (this == &mv)
+                return *this;
+            if (!nodes_movable && nodes.get_allocator() != mv.nodes.get_allocator())
+                return *this = static_cast<const TfTree &>(mv);
+            TfTree tmp(std::move(mv));
+            swap(tmp);
             return *this;
         }
 
+        //! Exchanges the content of two trees.
+        /*!
+         * Constant time, no node is copied or relocated and all references to the nodes stay valid, they only refer to the nodes of the other tree. As with standard containers,
+         * the allocators have to compare equal unless they propagate on swap.
+         * @param other the tree to be swapped with.
+         */
+        void swap(TfTree &other) noexcept
+        {
+            using std::swap;
+            nodes.swap(other.nodes);
+            swap(root_node_key, other.root_node_key);
+        }
+
+        //! Exchanges the content of two trees, see TfTree::swap().
+        friend void swap(TfTree &t1, TfTree &t2) noexcept
+        {
+            t1.swap(t2);
+        }
+
+        //! Allocator of the tree.
+        /*!
+         *
+         * @return copy of the allocator.
+         */
+        [[nodiscard]] Allocator get_allocator() const
+        {
+            return Allocator(nodes.get_allocator());
+        }
+
         //! Checks for an empty tree.
         /*!
          * Since there always should be the root node, a valid tree should never be empty. Useful for checking if the tree became empty by exception.
@@ -139,7 +202,9 @@ namespace rtl
         //! Clears the tree leaving only the root unchanged.
         void clear()
         {
-            std::vector<KeyType> child_keys;
+            if (nodes.empty())
+                return;
+            std::vector<KeyType, KeyAllocator> child_keys(KeyAllocator(nodes.get_allocator()));
             for (auto c : nodes.at(root_node_key).children())
                 child_keys.push_back(c->key());
             for (auto k : child_keys)
@@ -161,7 +226,44 @@ namespace rtl
             auto it_parent = nodes.find(parent);
             if (it_parent == nodes.end())
                 return false;
-            return nodes.emplace(key, NodeType(key, tf, it_parent->second)).second;
+            return nodes.try_emplace(key, key, std::forward<Tf>(tf), it_parent->second).second;
+        }
+
+        //! Inserts a batch of new nodes into the tree.
+        /*!
+         * Each entry of \p entries is a tuple-like object (e.g. std::tuple or an aggregate struct) of the key of the new node, the transformation from its parent and the key of
+         * the parent. Parents have to precede their children in the sequence, as e.g. a robot model listed top-down. Parent lookups are shared by consecutive entries with the same
+         * parent and skipped for entries attached to the node inserted just before, so a kinematic chain is loaded with a single map lookup per node. Entries with an unknown parent
+         * or an already existing key are skipped, as with the single-node insert().
+         * @tparam Range type of the sequence of entries.
+         * @param entries sequence of {key, tf, parent} entries in parent-before-child order.
+         * @return number of inserted nodes.
+         */
+        template<typename Range>
+        size_t insert(const Range &entries)
+        {
+            size_t inserted = 0;
+            NodeType *parent_node = nullptr, *last_node = nullptr;
+            for (const auto &entry : entries)
+            {
+                const auto &[key, tf, parent] = entry;
+                if (last_node != nullptr && last_node->key() == parent)
+                    parent_node = last_node;
+                else if (parent_node == nullptr || !(parent_node->key() == parent))
+                {
+                    auto it_parent = nodes.find(parent);
+                    parent_node = it_parent == nodes.end() ? nullptr : &it_parent->second;
+                }
+                if (parent_node == nullptr)
+                    continue;
+                auto [it, success] = nodes.try_emplace(key, key, tf, *parent_node);
+                if (success)
+                {
+                    last_node = &it->second;
+                    inserted++;
+                }
+            }
+            return inserted;
         }
 
         //! Erases the node with given key and all its child-nodes recursively.
@@ -191,6 +293,19 @@ namespace rtl
             return nodes.find(key) != nodes.end();
         }
 
+        //! Returns a handle of the node with given key for the batch update().
+        /*!
+         * The handle is a pointer to the node, which stays valid until the node is erased, so it can be looked up once, e.g. after loading a robot model, and reused in every
+         * update cycle.
+         * @param key key of the node.
+         * @return pointer to the node, nullptr if there is no node with the \p key in the tree.
+         */
+        [[nodiscard]] NodeType* handle(const KeyType &key)
+        {
+            auto it = nodes.find(key);
+            return it == nodes.end() ? nullptr : &it->second;
+        }
+
         //! Returns reference to the root node.
         /*!
          *
@@ -258,31 +373,219 @@ namespace rtl
          */
         TfChain<TransformationType> tf(const KeyType& from, const KeyType& to) const
         {
+            RTL_ZONE("rtl::TfTree::tf");
+            return TfChain<TransformationType>(pathTfs(from, to, [](const NodeType &n) -> const TransformationType& { return n.tf(); },
+                                                       [](const NodeType &n) -> const TransformationType& { return n.tfInverted(); }));
+        }
+
+        //! Returns chains of transformations from one node to many others.
+        /*!
+         * Equivalent to calling tf(from, t) for each key t in \p to, but the inverted transformations on the ascending path from \p from are computed only once and shared by
+         * all the chains. The common ancestors are found in O(log d) time using TfTreeNode::commonAncestor().
+         * @param from starting node.
+         * @param to end nodes.
+         * @return chains of transformations between \p from and each node in \p to, in the same order.
+         */
+        std::vector<TfChain<TransformationType>> tf(const KeyType& from, const std::vector<KeyType>& to) const
+        {
+            RTL_ZONE("rtl::TfTree::tf");
+            using StorageType = typename TfChain<TransformationType>::StorageType;
             const NodeType *from_node = &nodes.at(from);
-            const NodeType *to_node = &nodes.at(to);
-            std::list<TransformationType> ret;
-            size_t common_depth = std::min(from_node->depth(), to_node->depth());
-
-            if (from_node->depth() > common_depth)
-                for (;from_node->depth() != common_depth; from_node = from_node->parent())
-                    ret.push_back(from_node->tf().inverted());
-            auto insert_pos = ret.end();
-            if (to_node->depth() > common_depth)
-                for (; to_node->depth() != common_depth; to_node = to_node->parent())
-                    insert_pos = ret.insert(insert_pos, to_node->tf());
-
-            while (from_node->key() != to_node->key())
+            const NodeType *up_node = from_node;
+            StorageType up;     // inverted transformations of the ascending path, extended only as far as some target requires
+            std::vector<TfChain<TransformationType>> ret;
+            ret.reserve(to.size());
+            for (const auto &k : to)
+            {
+                const NodeType *to_node = &nodes.at(k);
+                const NodeType *common = NodeType::commonAncestor(from_node, to_node);
+                size_t ascent = from_node->depth() - common->depth();
+                for (; up.size() < ascent; up_node = up_node->parent())
+                    up.push_back(up_node->tfInverted());
+
+                StorageType chain(up.begin(), up.begin() + ascent);
+                size_t descent_beg = chain.size();
+                for (; to_node != common; to_node = to_node->parent())
+                    chain.push_back(to_node->tf());
+                std::reverse(chain.begin() + descent_beg, chain.end());
+                ret.emplace_back(std::move(chain));
+            }
+            return ret;
+        }
+
+        //! Returns a chain of transformations between nodes valid at given time instant.
+        /*!
+         * Transformations of the edges with non-empty TfBuffer are interpolated at \p time, the current transformations are used for the rest. Throws std::out_of_range if
+         * any of the non-empty buffers on the path does not cover \p time.
+         * @param from starting node.
+         * @param to end node.
+         * @param time the time instant.
+         * @return chain of transformations between \p from and \p to at \p time.
+         */
+        TfChain<TransformationType> tf(const KeyType& from, const KeyType& to, const TimeType &time) const
+        {
+            RTL_ZONE("rtl::TfTree::tf");
+            return TfChain<TransformationType>(pathTfs(from, to, [&time](const NodeType &n) { return n.tf(time); },
+                                                       [&time](const NodeType &n) { return n.tfInverted(time); }));
+        }
+
+        //! Returns single transformations between nodes for a batch of time instants.
+        /*!
+         * The path between \p from and \p to is searched only once for the whole batch, which makes the function suitable e.g. for motion compensation of all points of
+         * a lidar sweep. Same restrictions as for tf(from, to, time) and TfChain::squash() apply.
+         * @param from starting node.
+         * @param to end node.
+         * @param times the time instants.
+         * @return transformations from \p from to \p to, one for each element of \p times.
+         */
+        std::vector<TransformationType> tfSquashed(const KeyType& from, const KeyType& to, const std::vector<TimeType> &times) const
+        {
+            auto path = pathTfs(from, to, [](const NodeType &n) { return PathEdge{&n, false}; }, [](const NodeType &n) { return PathEdge{&n, true}; });
+            std::vector<TransformationType> ret;
+            ret.reserve(times.size());
+            for (const auto &t : times)
+            {
+                auto aggregation = TransformationType::identity();
+                for (const auto &edge : path)
+                {
+                    if (edge.inverted)
+                        aggregation.transform(edge.node->tfInverted(t));
+                    else
+                        aggregation.transform(edge.node->tf(t));
+                }
+                ret.push_back(std::move(aggregation));
+            }
+            return ret;
+        }
+
+        //! Records a new time-stamped transformation from the parent of the node with given key.
+        /*!
+         * The transformation is inserted into the node's TfBuffer. If it is the newest one, it also becomes the current transformation returned by NodeType::tf().
+         * @param key key of the node.
+         * @param time time stamp of the transformation.
+         * @param tf the transformation.
+         * @return true if the node exists, false otherwise.
+         */
+        bool update(const KeyType &key, const TimeType &time, const TransformationType &tf)
+        {
+            auto it = nodes.find(key);
+            if (it == nodes.end())
+                return false;
+            auto &buffer = it->second.tfBuffer();
+            if (buffer.empty() || !(time < buffer.newestTime()))
+                it->second.tf() = tf;
+            buffer.insert(time, tf);
+            return true;
+        }
+
+        //! Sets new transformations from the parents of a batch of nodes given by their handles.
+        /*!
+         * Equivalent to assigning tfs[i] to handles[i]->tf() for each i, but without any key lookup and with a single invalidation of cached rootTf() per changed subtree: subtrees
+         * already invalidated by an update of their ancestor earlier in the batch (or before it) are not traversed again.
+         * @param handles handles of the updated nodes obtained by handle().
+         * @param tfs new transformations from the parents of the respective nodes.
+         */
+        void update(Span<NodeType* const> handles, Span<const TransformationType> tfs)
+        {
+            if (handles.size() != tfs.size())
+                throw std::invalid_argument("TfTree: the numbers of handles and transformations differ.");
+            for (size_t i = 0; i < handles.size(); i++)
+                setTf(*handles[i], tfs[i]);
+        }
+
+        //! Records a batch of new time-stamped transformations from the parents of nodes given by their handles.
+        /*!
+         * Batch version of the time-stamped update() with the same time stamp for all transformations. Cached rootTf() is invalidated once per changed subtree as in the batch
+         * update() without time stamps.
+         * @param handles handles of the updated nodes obtained by handle().
+         * @param time time stamp of the transformations.
+         * @param tfs new transformations from the parents of the respective nodes.
+         */
+        void update(Span<NodeType* const> handles, const TimeType &time, Span<const TransformationType> tfs)
+        {
+            if (handles.size() != tfs.size())
+                throw std::invalid_argument("TfTree: the numbers of handles and transformations differ.");
+            for (size_t i = 0; i < handles.size(); i++)
             {
-                insert_pos = ret.insert(insert_pos, to_node->tf());
-                ret.insert(insert_pos, from_node->tf().inverted());
-                from_node = from_node->parent();
-                to_node = to_node->parent();
+                auto &buffer = handles[i]->tfBuffer();
+                if (buffer.empty() || !(time < buffer.newestTime()))
+                    setTf(*handles[i], tfs[i]);
+                buffer.insert(time, tfs[i]);
             }
+        }
 
-            return TfChain<TransformationType>(ret);
+        //! Returns a single transformation between nodes.
+        /*!
+         * The result is equivalent to tf(from, to).squash(), but it is composed from cached root-to-node transformations of both nodes (see TfTreeNode::rootTf()), so repeated queries
+         * on a tree with unchanged transformations cost a single inversion and composition. Same restrictions as for TfChain::squash() apply to the GeneralTf transformation type.
+         * @param from starting node.
+         * @param to end node.
+         * @return transformation from \p from to \p to.
+         */
+        TransformationType tfSquashed(const KeyType& from, const KeyType& to) const
+        {
+            return nodes.at(from).rootTfInverted().transformed(nodes.at(to).rootTf());
         }
 
     private:
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const KeyType, NodeType>> NodeAllocator;
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<KeyType> KeyAllocator;
+
+        static constexpr bool nodes_movable = std::allocator_traits<NodeAllocator>::propagate_on_container_move_assignment::value ||
+                                              std::allocator_traits<NodeAllocator>::is_always_equal::value;
+
+        // Edge of a path between two nodes, inverted for the ascending part of the path.
+        struct PathEdge
+        {
+            const NodeType *node;
+            bool inverted;
+        };
+
+        //! Collects items describing edges on the path between two nodes in the order of application.
+        /*!
+         * \p edge_func is invoked on each node of the descending part of the path and \p inv_edge_func on each node of the ascending part, both except the common ancestor.
+         * @tparam EdgeFunc type of the invokable object for the descending part.
+         * @tparam InvEdgeFunc type of the invokable object for the ascending part.
+         * @param from starting node.
+         * @param to end node.
+         * @param edge_func object returning the item representing an edge from the parent to given node.
+         * @param inv_edge_func object returning the item representing an edge from given node to its parent.
+         * @return contiguous sequence of items.
+         */
+        template<typename EdgeFunc, typename InvEdgeFunc>
+        auto pathTfs(const KeyType& from, const KeyType& to, EdgeFunc &&edge_func, InvEdgeFunc &&inv_edge_func) const
+        {
+            using ItemType = std::decay_t<std::invoke_result_t<EdgeFunc, const NodeType&>>;
+            SmallVector<ItemType, 8> ret, down;    // down collects the descending part of the chain in reversed order
+            const NodeType *from_node = &nodes.at(from);
+            const NodeType *to_node = &nodes.at(to);
+            const NodeType *common = NodeType::commonAncestor(from_node, to_node);
+
+            for (; from_node != common; from_node = from_node->parent())
+                ret.push_back(inv_edge_func(*from_node));
+            for (; to_node != common; to_node = to_node->parent())
+                down.push_back(edge_func(*to_node));
+
+            ret.reserve(ret.size() + down.size());
+            for (auto it = down.end(); it != down.begin();)
+                ret.push_back(std::move(*--it));
+            return ret;
+        }
+
+        //! Sets the transformation from the parent of \p node and invalidates the dependent caches.
+        /*!
+         * A node with a stale rootTf() has only stale descendants, so the subtree is traversed only if the cache of \p node is still valid.
+         * @param node the updated node.
+         * @param tf new transformation from the parent.
+         */
+        static void setTf(NodeType &node, const TransformationType &tf)
+        {
+            node.tf_from_parent = tf;
+            node.int_tf_inv_valid = false;
+            if (node.int_cache_version == node.int_version)
+                node.invalidateRootTf();
+        }
+
         //! Recursively erases all children of given and and then the node itself.
         /*!
          *
@@ -291,7 +594,7 @@ namespace rtl
          */
         bool eraseSubtree(const KeyType &key)
         {
-            std::vector<KeyType> child_keys;
+            std::vector<KeyType, KeyAllocator> child_keys(KeyAllocator(nodes.get_allocator()));
             for (auto c : nodes.at(key).children())
                 child_keys.push_back(c->key());
             for (auto k : child_keys)
@@ -300,6 +603,35 @@ namespace rtl
             return nodes.erase(key);
         }
 
+        //! Rebuilds the structure of \p cp in an empty tree.
+        /*!
+         * Nodes are inserted top-down, so each copied node links to its parent within *this instead of the original tree.
+         * @param cp tree to be copied.
+         */
+        void copyFrom(const TfTree &cp)
+        {
+            insertRoot(cp.root_node_key);
+            nodes.at(root_node_key).tf_from_parent = cp.root().tf();
+            nodes.at(root_node_key).int_tf_buffer = cp.root().tfBuffer();
+            copySubtree(cp.root());
+        }
+
+        //! Recursively copies children of \p src below the node with the same key in *this.
+        /*!
+         *
+         * @param src node of the copied tree.
+         */
+        void copySubtree(const NodeType &src)
+        {
+            auto &parent = nodes.at(src.key());
+            for (const NodeType *c : src.children())    // const access keeps cached transformations of the source valid
+            {
+                auto it = nodes.try_emplace(c->key(), c->key(), c->tf(), parent).first;
+                it->second.int_tf_buffer = c->tfBuffer();
+                copySubtree(*c);
+            }
+        }
+
         //! Creates a rood node with given key.
         /*!
          *
@@ -308,12 +640,19 @@ namespace rtl
         void insertRoot(const KeyType &key)
         {
             root_node_key = key;
-            nodes.emplace(key, NodeType(key));
+            nodes.try_emplace(key, key, Allocator(nodes.get_allocator()));
         }
 
-        std::map<KeyType, NodeType> nodes;
+        std::map<KeyType, NodeType, std::less<KeyType>, NodeAllocator> nodes;
         K root_node_key;
     };
+
+    namespace pmr
+    {
+        //! TfTree allocating from a std::pmr::memory_resource, e.g. std::pmr::monotonic_buffer_resource reset after each cycle of a real-time loop.
+        template<typename K, typename T>
+        using TfTree = rtl::TfTree<K, T, std::pmr::polymorphic_allocator<std::byte>>;
+    }
 }
 
 #endif //ROBOTICTEMPLATELIBRARY_TFTREE_H
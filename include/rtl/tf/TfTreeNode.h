@@ -28,29 +28,56 @@
 #define ROBOTICTEMPLATELIBRARY_TFTREENODE_H
 
 #include <set>
+#include <cstddef>
+#include <memory>
 #include <unordered_set>
 #include <functional>
+#include <vector>
+#include <utility>
+
+#include "TfBuffer.h"
 
 namespace rtl
 {
-    template<typename, typename>
+    template<typename, typename, typename>
     class TfTree;
 
     /*!
      * TfTreeNode is a base building block of the TfTree structure for management of transformations and geometrical relationships between coordinate frames. From the user's point of view,
      * TfTreeNode aggregates all content of the node: key, pointer to the parent node, transformation from the parent node to *this, pointers to the child nodes and depth in the tree. The node
      * internally takes care of its connections with other nodes and neither the tree, nor anything other should interfere with this mechanism.
+     *
+     * Each node also caches the composition of all transformations from the root to itself, see rootTf(). The cache is guarded by a version counter, which is incremented on every
+     * non-const access to tf() of the node or any of its ancestors, and rebuilt lazily on the next rootTf() call.
+     *
+     * Inversions needed for traversal of the tree towards the root are cached as well. tfInverted() keeps the inverse of tf() until the next non-const access to tf() and
+     * rootTfInverted() follows the validity of rootTf().
+     *
+     * The caches are mutable and filled by const queries, so const access to the same node from several threads is a data race unless the caches are valid already. Share
+     * trees between threads through ConcurrentTfTree, which publishes snapshots with all caches filled, or prime them by calling rootTf(), rootTfInverted() and tfInverted()
+     * on every node before the concurrent access starts.
+     *
+     * For constant-time navigation in deep trees, each node keeps pointers to its ancestors 2^k levels above (binary lifting), see ancestor() and commonAncestor(). The table is
+     * built from the parent's one on construction of the node, so it costs O(log d) time and memory per node of depth d and never needs updating while the node lives.
+     *
+     * Optionally, the node keeps a bounded history of the transformation from its parent in a TfBuffer, see tfBuffer() and tf(TimeType).
      * @tparam K Key type.
      * @tparam T Transformation type.
+     * @tparam Allocator allocator of the set of children, rebound to the pointer type. Child nodes take the allocator of their parent.
      */
-    template<typename K, typename T>
+    template<typename K, typename T, typename Allocator = std::allocator<std::byte>>
     class TfTreeNode
     {
+        using ChildAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<TfTreeNode*>;
+
     public:
-        friend class TfTree<K, T>;
+        friend class TfTree<K, T, Allocator>;
 
         using KeyType = K;              //!< Type of the key.
         using TransformationType = T;   //!< Type of the transformation.
+        using AllocatorType = Allocator;//!< Type of the allocator.
+        using BufferType = TfBuffer<T>; //!< Type of the time-stamped history of the transformation.
+        using TimeType = typename BufferType::TimeType; //!< Type of the time stamps.
 
         //! Default constructor.
         /*!
@@ -63,7 +90,11 @@ namespace rtl
          *
          * @param cp node to be copied.
          */
-        TfTreeNode(const TfTreeNode& cp) : int_depth(cp.int_depth), int_key(cp.int_key), tf_from_parent(cp.tf_from_parent), int_parent(cp.int_parent), int_children(cp.int_children)
+        TfTreeNode(const TfTreeNode& cp) : int_depth(cp.int_depth), int_key(cp.int_key), tf_from_parent(cp.tf_from_parent), int_parent(cp.int_parent),
+                                           int_children(cp.int_children, cp.int_children.get_allocator()), int_jumps(cp.int_jumps, cp.int_jumps.get_allocator()),
+                                           int_version(cp.int_version), int_cache_version(cp.int_cache_version), int_root_tf(cp.int_root_tf),
+                                           int_root_inv_version(cp.int_root_inv_version), int_root_tf_inv(cp.int_root_tf_inv), int_tf_inv_valid(cp.int_tf_inv_valid), int_tf_inv(cp.int_tf_inv),
+                                           int_tf_buffer(cp.int_tf_buffer)
         {
         }
 
@@ -72,7 +103,12 @@ namespace rtl
          *
          * @param mv node to be moved.
          */
-        TfTreeNode(TfTreeNode&& mv) noexcept : int_depth(mv.int_depth), int_key(std::move(mv.int_key)), tf_from_parent(mv.tf_from_parent), int_children(std::move(mv.int_children))
+        TfTreeNode(TfTreeNode&& mv) noexcept : int_depth(mv.int_depth), int_key(std::move(mv.int_key)), tf_from_parent(std::move(mv.tf_from_parent)), int_children(std::move(mv.int_children)),
+                                               int_jumps(std::move(mv.int_jumps)),
+                                               int_version(mv.int_version), int_cache_version(mv.int_cache_version), int_root_tf(std::move(mv.int_root_tf)),
+                                               int_root_inv_version(mv.int_root_inv_version), int_root_tf_inv(std::move(mv.int_root_tf_inv)), int_tf_inv_valid(mv.int_tf_inv_valid),
+                                               int_tf_inv(std::move(mv.int_tf_inv)),
+                                               int_tf_buffer(std::move(mv.int_tf_buffer))
         {
             if(int_depth == 0)
             {
@@ -85,15 +121,19 @@ namespace rtl
                 int_parent->int_children.insert(this);
             }
             for (auto c : int_children)
+            {
                 c->int_parent = this;
+                c->rebuildJumps();
+            }
         }
 
         //! Root node constructor.
         /*!
          * Constructs a node with depth 0 and given \p key.
          * @param key key of the root node.
+         * @param alloc allocator of the set of children, inherited by all descendants.
          */
-        explicit TfTreeNode(const KeyType &key) : int_key(key), int_parent(this)
+        explicit TfTreeNode(const KeyType &key, const Allocator &alloc = Allocator()) : int_key(key), int_parent(this), int_children(ChildAllocator(alloc)), int_jumps(ChildAllocator(alloc))
         {
             int_depth = 0;
         }
@@ -107,9 +147,11 @@ namespace rtl
          * @param parent pointer to the parent node.
          */
         template<typename Tf>
-        TfTreeNode(const KeyType &key, Tf &&transformation, TfTreeNode<K, T>& parent) : int_key(key), tf_from_parent(transformation), int_parent(&parent)
+        TfTreeNode(const KeyType &key, Tf &&transformation, TfTreeNode& parent) : int_key(key), tf_from_parent(std::forward<Tf>(transformation)), int_parent(&parent),
+                                                                                  int_children(parent.int_children.get_allocator()), int_jumps(parent.int_children.get_allocator())
         {
             int_depth = parent.depth() + 1;
+            buildJumps();
             int_parent->int_children.insert(this);
         }
 
@@ -178,20 +220,199 @@ namespace rtl
 
         //! Transformation from parent to *this.
         /*!
-         *
+         * Non-const access invalidates cached rootTf() of *this and the whole subtree below it.
          * @return reference to the transformation.
          */
         [[nodiscard]] TransformationType& tf()
         {
+            invalidateRootTf();
+            int_tf_inv_valid = false;
             return tf_from_parent;
         }
 
+        //! Transformation from parent to *this at given time instant.
+        /*!
+         * Interpolated from the history kept in tfBuffer(). If the buffer is empty, the current tf() is returned regardless of \p time. Throws std::out_of_range if non-empty
+         * buffer does not cover \p time.
+         * @param time the time instant.
+         * @return the transformation at \p time.
+         */
+        [[nodiscard]] TransformationType tf(const TimeType &time) const
+        {
+            if (int_tf_buffer.empty())
+                return tf_from_parent;
+            return int_tf_buffer.at(time);
+        }
+
+        //! Transformation from *this to parent, i.e. the inverse of tf().
+        /*!
+         * The inverse is computed on the first call and cached until the next non-const access to tf(), so repeated traversals of the edge towards the root are free of inversion.
+         * @return reference to the cached inverse transformation.
+         */
+        [[nodiscard]] const TransformationType& tfInverted() const
+        {
+            if (!int_tf_inv_valid)
+            {
+                int_tf_inv = tf_from_parent.inverted();
+                int_tf_inv_valid = true;
+            }
+            return int_tf_inv;
+        }
+
+        //! Transformation from *this to parent at given time instant, i.e. the inverse of tf(time).
+        /*!
+         * If the buffer is empty, the cached tfInverted() is returned regardless of \p time, interpolated transformations are inverted on each call. Throws std::out_of_range if
+         * non-empty buffer does not cover \p time.
+         * @param time the time instant.
+         * @return the inverse transformation at \p time.
+         */
+        [[nodiscard]] TransformationType tfInverted(const TimeType &time) const
+        {
+            if (int_tf_buffer.empty())
+                return tfInverted();
+            return int_tf_buffer.at(time).inverted();
+        }
+
+        //! Time-stamped history of the transformation from parent to *this.
+        /*!
+         * The buffer has zero capacity by default, use TfBuffer::setCapacity() to enable the history.
+         * @return reference to the buffer.
+         */
+        [[nodiscard]] const BufferType& tfBuffer() const
+        {
+            return int_tf_buffer;
+        }
+
+        //! Time-stamped history of the transformation from parent to *this.
+        /*!
+         * The buffer has zero capacity by default, use TfBuffer::setCapacity() to enable the history.
+         * @return reference to the buffer.
+         */
+        [[nodiscard]] BufferType& tfBuffer()
+        {
+            return int_tf_buffer;
+        }
+
+        //! Composed transformation from the root of the tree to *this.
+        /*!
+         * Equivalent to squashing the chain of transformations from the root down to *this. The result is cached and only recomputed after tf() of *this or one of its ancestors
+         * was accessed for modification, therefore repeated calls cost a single version check. The root node returns the identity transformation.
+         * @return reference to the cached transformation.
+         */
+        [[nodiscard]] const TransformationType& rootTf() const
+        {
+            if (int_cache_version != int_version)
+            {
+                if (int_depth == 0)
+                    int_root_tf = TransformationType::identity();
+                else
+                    int_root_tf = int_parent->rootTf().transformed(tf_from_parent);
+                int_cache_version = int_version;
+            }
+            return int_root_tf;
+        }
+
+        //! Composed transformation from *this to the root of the tree, i.e. the inverse of rootTf().
+        /*!
+         * Cached and invalidated together with rootTf().
+         * @return reference to the cached transformation.
+         */
+        [[nodiscard]] const TransformationType& rootTfInverted() const
+        {
+            if (int_root_inv_version != int_version)
+            {
+                int_root_tf_inv = rootTf().inverted();
+                int_root_inv_version = int_version;
+            }
+            return int_root_tf_inv;
+        }
+
+        //! Ancestor of the node given number of levels above.
+        /*!
+         * Composed from at most log2(\p levels) jumps of the binary lifting table.
+         * @param levels number of levels to ascend, must not exceed depth().
+         * @return pointer to the ancestor, *this for zero \p levels.
+         */
+        [[nodiscard]] const TfTreeNode* ancestor(size_t levels) const
+        {
+            const TfTreeNode *n = this;
+            for (size_t k = 0; levels != 0; k++, levels >>= 1)
+                if (levels & 1)
+                    n = n->int_jumps[k];
+            return n;
+        }
+
+        //! Lowest common ancestor of two nodes.
+        /*!
+         * Found in O(log d) steps for nodes of depth up to d using the binary lifting tables of the nodes. A node is considered to be an ancestor of itself.
+         * @param n1 the first node.
+         * @param n2 the second node.
+         * @return pointer to the deepest node having both \p n1 and \p n2 in its subtree, nullptr if the nodes do not belong to the same tree.
+         */
+        [[nodiscard]] static const TfTreeNode* commonAncestor(const TfTreeNode *n1, const TfTreeNode *n2)
+        {
+            if (n1->depth() < n2->depth())
+                std::swap(n1, n2);
+            n1 = n1->ancestor(n1->depth() - n2->depth());
+            if (n1 == n2)
+                return n1;
+            for (size_t k = n1->int_jumps.size(); k-- > 0;)
+            {
+                if (k < n1->int_jumps.size() && n1->int_jumps[k] != n2->int_jumps[k])
+                {
+                    n1 = n1->int_jumps[k];
+                    n2 = n2->int_jumps[k];
+                }
+            }
+            return n1->int_parent == n2->int_parent ? n1->int_parent : nullptr;
+        }
+
     private:
+        //! Fills the binary lifting table from the table of the parent.
+        void buildJumps()
+        {
+            int_jumps.clear();
+            if (int_depth == 0)
+                return;
+            int_jumps.push_back(int_parent);
+            for (size_t k = 0; (size_t(2) << k) <= int_depth; k++)
+                int_jumps.push_back(int_jumps[k]->int_jumps[k]);
+        }
+
+        //! Rebuilds binary lifting tables of *this and the whole subtree below, e.g. after an ancestor changed its address.
+        void rebuildJumps()
+        {
+            buildJumps();
+            for (auto c : int_children)
+                c->rebuildJumps();
+        }
+
+        //! Increments the version counter of *this and the subtree below, which makes their cached rootTf() stale.
+        /*!
+         * A node with a stale cache cannot have children with a valid one, so the recursion stops at descendants, which were already invalidated before.
+         */
+        void invalidateRootTf()
+        {
+            int_version++;
+            for (auto c : int_children)
+                if (c->int_cache_version == c->int_version)
+                    c->invalidateRootTf();
+        }
+
         size_t int_depth;
         KeyType int_key;
         TransformationType tf_from_parent;
         TfTreeNode *int_parent;
-        std::set<TfTreeNode*> int_children;
+        std::set<TfTreeNode*, std::less<TfTreeNode*>, ChildAllocator> int_children;
+        std::vector<TfTreeNode*, ChildAllocator> int_jumps;     // int_jumps[k] is the ancestor 2^k levels above
+        size_t int_version{1};
+        mutable size_t int_cache_version{0};
+        mutable TransformationType int_root_tf;
+        mutable size_t int_root_inv_version{0};
+        mutable TransformationType int_root_tf_inv;
+        mutable bool int_tf_inv_valid{false};
+        mutable TransformationType int_tf_inv;
+        BufferType int_tf_buffer;
     };
 }
 
@@ -182,6 +182,18 @@ namespace rtl
             return VectorType::distanceSquared(tr1.int_translation, tr2.int_translation);
         }
 
+        //! Linear interpolation between *this and \p tr.
+        /*!
+         *
+         * @param tr the other translation.
+         * @param scale interpolation parameter in the range [0; 1], 0 returns *this, 1 returns \p tr.
+         * @return interpolated translation.
+         */
+        ChildType interpolated(const TranslationND_common &tr, ElementType scale) const
+        {
+            return ChildType(int_translation + (tr.int_translation - int_translation) * scale);
+        }
+
         //! Return a new translation, which, when applied, leaves the transformed object as is.
         /*!
          *
@@ -214,10 +226,13 @@ namespace rtl
         template<typename ...T, typename std::enable_if<sizeof...(T) == dimensions, int>::type = 0>
         explicit TranslationND_common(T ...args) : int_translation(args...) {}
 
-        TranslationND_common(const TranslationND_common<dimensions, Element, ChildTemplate> &tr)
-        {
-            int_translation = tr.int_translation;
-        }
+        TranslationND_common(const TranslationND_common<dimensions, Element, ChildTemplate> &tr) = default;
+
+        TranslationND_common(TranslationND_common<dimensions, Element, ChildTemplate> &&tr) noexcept = default;
+
+        TranslationND_common<dimensions, Element, ChildTemplate> &operator=(const TranslationND_common<dimensions, Element, ChildTemplate> &tr) = default;
+
+        TranslationND_common<dimensions, Element, ChildTemplate> &operator=(TranslationND_common<dimensions, Element, ChildTemplate> &&tr) noexcept = default;
 
         explicit TranslationND_common(const VectorType &vec)
         {
@@ -237,12 +252,6 @@ namespace rtl
         VectorType int_translation;
 
     private:
-        TranslationND_common<dimensions, Element, ChildTemplate> &operator=(const TranslationND_common<dimensions, Element, ChildTemplate> &tr)
-        {
-            int_translation = tr.int_translation;
-            return *this;
-        }
-
         ChildType &childThis() { return static_cast<ChildType &>(*this); }
         const ChildType &childThis() const { return static_cast<ChildType const &>(*this); }
     };
@@ -264,7 +273,10 @@ namespace rtl
         TranslationND() = default;
 
         //! Copy constructor.
-        TranslationND(const TranslationND<dimensions, Element> &tr) : TranslationND_common<dimensions, Element, TranslationND>(tr) {}
+        TranslationND(const TranslationND<dimensions, Element> &tr) = default;
+
+        //! Move constructor.
+        TranslationND(TranslationND<dimensions, Element> &&tr) noexcept = default;
 
         //! Element-wise construction - number of arguments must correspond to translation's dimensionality.
         template<typename ...T, typename std::enable_if<sizeof...(T) == dimensions, int>::type = 0>
@@ -274,11 +286,10 @@ namespace rtl
         explicit TranslationND(const VectorType &vec) : TranslationND_common<dimensions, Element, TranslationND>(vec) {}
 
         //! Assignment operator.
-        TranslationND<dimensions, Element> &operator=(const TranslationND<dimensions, Element> &tr)
-        {
-            this->int_translation = tr.int_translation;
-            return *this;
-        }
+        TranslationND<dimensions, Element> &operator=(const TranslationND<dimensions, Element> &tr) = default;
+
+        //! Move assignment operator.
+        TranslationND<dimensions, Element> &operator=(TranslationND<dimensions, Element> &&tr) noexcept = default;
     };
 
     //! Two dimensional specialization of TranslationND template.
@@ -297,7 +308,10 @@ namespace rtl
         TranslationND() = default;
 
         //! Copy constructor.
-        TranslationND(const TranslationND<2, Element> &tr) : TranslationND_common<2, Element, TranslationND>(tr) {}
+        TranslationND(const TranslationND<2, Element> &tr) = default;
+
+        //! Move constructor.
+        TranslationND(TranslationND<2, Element> &&tr) noexcept = default;
 
         //! Element-wise construction.
         TranslationND(ElementType x, ElementType y) : TranslationND_common<2, Element, TranslationND>(x, y) {}
@@ -306,11 +320,10 @@ namespace rtl
         explicit TranslationND(const VectorType &vec) : TranslationND_common<2, Element, TranslationND>(vec) {}
 
         //! Assignment operator.
-        TranslationND<2, Element> &operator=(const TranslationND<2, Element> &tr)
-        {
-            this->int_translation = tr.int_translation;
-            return *this;
-        }
+        TranslationND<2, Element> &operator=(const TranslationND<2, Element> &tr) = default;
+
+        //! Move assignment operator.
+        TranslationND<2, Element> &operator=(TranslationND<2, Element> &&tr) noexcept = default;
 
         //! \a x element of the translation vector of the transformation.
         /*!
@@ -369,7 +382,10 @@ namespace rtl
         TranslationND() = default;
 
         //! Copy constructor.
-        TranslationND(const TranslationND<3, Element> &tr) : TranslationND_common<3, Element, TranslationND>(tr) {}
+        TranslationND(const TranslationND<3, Element> &tr) = default;
+
+        //! Move constructor.
+        TranslationND(TranslationND<3, Element> &&tr) noexcept = default;
 
         //! Element-wise construction.
         TranslationND(ElementType x, ElementType y, ElementType z) : TranslationND_common<3, Element, TranslationND>(x, y, z) {}
@@ -378,11 +394,10 @@ namespace rtl
         explicit TranslationND(const VectorType &vec) : TranslationND_common<3, Element, TranslationND>(vec) {}
 
         //! Assignment operator.
-        TranslationND<3, Element> &operator=(const TranslationND<3, Element> &tr)
-        {
-            this->int_translation = tr.int_translation;
-            return *this;
-        }
+        TranslationND<3, Element> &operator=(const TranslationND<3, Element> &tr) = default;
+
+        //! Move assignment operator.
+        TranslationND<3, Element> &operator=(TranslationND<3, Element> &&tr) noexcept = default;
 
         //! \a x element of the translation vector of the transformation.
         /*!
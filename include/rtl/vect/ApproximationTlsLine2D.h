@@ -27,6 +27,11 @@
 #ifndef ROBOTICTEMPLATELIBRARY_VECT_APPROXIMATIONTLSLINE2D_H
 #define ROBOTICTEMPLATELIBRARY_VECT_APPROXIMATIONTLSLINE2D_H
 
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <eigen3/Eigen/Dense>
+
 #include "rtl/Core.h"
 
 #include "rtl/vect/PrecSums.h"
@@ -38,6 +43,9 @@ namespace rtl
      * Instances of ApproximationTlsLine2D work as functor taking PrecSumsType argument and computing linear approximation based on it.
      * Basic operations such as trim() to line segments or project() point are present as well.
      *
+     * Whole lists of ranges of a precomputed array can be fitted at once by fit() into a Batch, or only their total error evaluated by getTotalErrorSquared(). The sums of
+     * the ranges are gathered into chunks of structure-of-arrays and the closed-form 2x2 eigenproblems of a chunk are solved together by vectorized Eigen array expressions.
+     *
      * @tparam Element base type of stored elements.
      * @tparam Compute type for performing computations.
      */
@@ -51,6 +59,46 @@ namespace rtl
         typedef LineSegment2D<ElementType> ConstrainedType; //!< 2D line segment with ElementType elements.
         typedef PrecSums2D<ComputeType> PrecSumsType;       //!< 2D precomputed sums with ComputeType elements.
 
+        //! Approximations of a batch of ranges of points stored as structure of arrays, see fit().
+        struct Batch
+        {
+            std::vector<ElementType> dir_x;         //!< \a x coordinates of the direction vectors.
+            std::vector<ElementType> dir_y;         //!< \a y coordinates of the direction vectors.
+            std::vector<ElementType> dist;          //!< \a c coefficients of the general equations of the lines.
+            std::vector<ElementType> err_squared;   //!< Squared errors of the approximations.
+
+            //! Returns number of approximations in the batch.
+            [[nodiscard]] size_t size() const { return err_squared.size(); }
+
+            //! Returns the approximation with given index.
+            /*!
+             *
+             * @param i index of the approximation.
+             * @return the approximation equal to the one fitted directly to the same range.
+             */
+            [[nodiscard]] ApproximationTlsLine2D operator[](size_t i) const
+            {
+                ApproximationTlsLine2D ret;
+                ret.ld = VectorType(dir_x[i], dir_y[i]);
+                ret.dist = dist[i];
+                ret.sigma2 = err_squared[i];
+                return ret;
+            }
+
+            //! Resizes all arrays of the batch.
+            /*!
+             *
+             * @param n new number of approximations.
+             */
+            void resize(size_t n)
+            {
+                dir_x.resize(n);
+                dir_y.resize(n);
+                dist.resize(n);
+                err_squared.resize(n);
+            }
+        };
+
         //! Default constructor.
         ApproximationTlsLine2D() = default;
 
@@ -139,7 +187,7 @@ namespace rtl
             ld.setY((sxy));
             ld.normalize();
 
-            dist = ld.y() * ps.sx() - ld.x() * ps.sy();
+            dist = ld.y() * (ps.sx() + ps.reference.x()) - ld.x() * (ps.sy() + ps.reference.y());
             return true;
         }
 
@@ -180,7 +228,7 @@ namespace rtl
         template <class Iter>
         ConstrainedType trim(Iter beg, Iter end) const
         {
-            static_assert(std::is_constructible<VectorType, typename Iter::value_type>::value, "Invalid iterator value_type.");
+            static_assert(std::is_constructible<VectorType, typename std::iterator_traits<Iter>::value_type>::value, "Invalid iterator value_type.");
             return trim(*beg, *(--end));
         }
 
@@ -221,7 +269,113 @@ namespace rtl
             return trace_half - std::sqrt(trace_half * trace_half - sx2 * sy2 + sxy * sxy);
         }
 
+        //! Fits approximations to a list of ranges of a precomputed array in a single vectorized pass.
+        /*!
+         * Equivalent to fitting an approximation to sum_array.sums(r.first, r.second) for each range r of \p ranges, but the eigenproblems are solved in chunks by vectorized
+         * array expressions. The storage of \p batch is reused, so repeated fitting does not allocate once the batch is large enough.
+         * @tparam SumArray type of the array of precomputed sums, e.g. PrecArray2D.
+         * @param sum_array precomputed sums.
+         * @param ranges index ranges of the approximated points, each containing at least two points.
+         * @param batch output approximations in the order of \p ranges.
+         */
+        template<class SumArray>
+        static void fit(const SumArray &sum_array, Span<const std::pair<size_t, size_t>> ranges, Batch &batch)
+        {
+            batch.resize(ranges.size());
+            Chunk chunk;
+            for (size_t beg = 0; beg < ranges.size(); beg += batch_chunk)
+            {
+                size_t cnt = std::min(batch_chunk, ranges.size() - beg);
+                for (size_t k = 0; k < cnt; k++)
+                    chunk.gather(k, sum_array.sums(ranges[beg + k].first, ranges[beg + k].second));
+                chunk.pad(cnt);
+                chunk.solve();
+
+                ChunkArray ldx = chunk.cx2 - chunk.err, ldy = chunk.cxy;
+                ChunkArray norm = (ldx * ldx + ldy * ldy).sqrt();
+                ldx /= norm;
+                ldy /= norm;
+                ChunkArray d = ldy * (chunk.mx + chunk.rx) - ldx * (chunk.my + chunk.ry);
+                for (size_t k = 0; k < cnt; k++)
+                {
+                    batch.dir_x[beg + k] = ldx[k];
+                    batch.dir_y[beg + k] = ldy[k];
+                    batch.dist[beg + k] = d[k];
+                    batch.err_squared[beg + k] = chunk.err[k];
+                }
+            }
+        }
+
+        //! Total squared error of approximations of consecutive ranges of a precomputed array.
+        /*!
+         * The ranges are [\p beg, breakpoints[0]), [breakpoints[0], breakpoints[1]), ..., [breakpoints.back(), \p end). The result equals the sum of getErrorSquared() of the
+         * ranges, but only the errors are computed, in chunks by vectorized array expressions and without any allocation. Suitable for the evaluation of candidate breakpoints
+         * in optimizers, see OptimizerTotalError.
+         * @tparam SumArray type of the array of precomputed sums, e.g. PrecArray2D.
+         * @param sum_array precomputed sums.
+         * @param beg first point of the first range.
+         * @param breakpoints ascending boundaries between the ranges.
+         * @param end one behind the last point of the last range.
+         * @return total squared error.
+         */
+        template<class SumArray>
+        static ElementType getTotalErrorSquared(const SumArray &sum_array, size_t beg, Span<const size_t> breakpoints, size_t end)
+        {
+            size_t range_cnt = breakpoints.size() + 1;
+            ElementType total = 0;
+            Chunk chunk;
+            for (size_t first = 0; first < range_cnt; first += batch_chunk)
+            {
+                size_t cnt = std::min(batch_chunk, range_cnt - first);
+                for (size_t k = 0; k < cnt; k++)
+                {
+                    size_t r = first + k;
+                    chunk.gather(k, sum_array.sums(r == 0 ? beg : breakpoints[r - 1], r == range_cnt - 1 ? end : breakpoints[r]));
+                }
+                chunk.pad(cnt);
+                chunk.solve();
+                total += chunk.err.head(cnt).sum();
+            }
+            return total;
+        }
+
     private:
+        static constexpr size_t batch_chunk = 16;
+        typedef Eigen::Array<ElementType, batch_chunk, 1> ChunkArray;
+
+        // Means and central moments of a chunk of ranges in structure of arrays, the padding lanes hold a single point at the origin.
+        struct Chunk
+        {
+            ChunkArray mx, my, rx, ry, cx2, cxy, cy2, err;
+
+            void gather(size_t k, PrecSumsType ps)
+            {
+                ps.average();
+                mx[k] = ps.sx();
+                my[k] = ps.sy();
+                rx[k] = ps.reference.x();
+                ry[k] = ps.reference.y();
+                cx2[k] = ps.sx2() - ps.sx() * ps.sx();
+                cxy[k] = ps.sxy() - ps.sx() * ps.sy();
+                cy2[k] = ps.sy2() - ps.sy() * ps.sy();
+            }
+
+            void pad(size_t cnt)
+            {
+                size_t rest = batch_chunk - cnt;
+                for (ChunkArray *a : {&mx, &my, &rx, &ry, &cxy, &cy2})
+                    a->tail(rest).setZero();
+                cx2.tail(rest).setOnes();
+            }
+
+            // Smaller eigenvalue of each covariance matrix, as in operator()
+            void solve()
+            {
+                ChunkArray trace_half = (cx2 + cy2) * ElementType(0.5);
+                err = trace_half - (trace_half * trace_half - cx2 * cy2 + cxy * cxy).sqrt();
+            }
+        };
+
         VectorType ld;
         ElementType dist{}, sigma2{};
     };
@@ -29,7 +29,8 @@
 
 #include "rtl/Core.h"
 
-#include "PrecSums.h"
+#include "rtl/vect/PrecSums.h"
+#include "rtl/vect/EigenSolver3D.h"
 
 namespace rtl
 {
@@ -40,8 +41,9 @@ namespace rtl
      *
      * @tparam Element base type of stored elements.
      * @tparam Compute type for performing computations.
+     * @tparam EigenSolver policy solving the eigenproblem of the covariance matrix, see rtl/vect/EigenSolver3D.h.
      */
-    template<typename Element, typename Compute>
+    template<typename Element, typename Compute, class EigenSolver = EigenSolverTrigonometric3D>
     class ApproximationTlsLine3D
     {
     public:
@@ -94,19 +96,12 @@ namespace rtl
         bool operator()(PrecSumsType ps)
         {
             ps.average();
-            Eigen::Matrix<ComputeType, 3, 3> cov_m;
-            cov_m(0, 0) = ps.sx2() - ps.sx() * ps.sx();
-            cov_m(1, 0) = ps.sxy() - ps.sx() * ps.sy();
-            cov_m(2, 0) = ps.szx() - ps.sz() * ps.sx();
-            cov_m(1, 1) = ps.sy2() - ps.sy() * ps.sy();
-            cov_m(2, 1) = ps.syz() - ps.sy() * ps.sz();
-            cov_m(2, 2) = ps.sz2() - ps.sz() * ps.sz();
+            Eigen::Matrix<ComputeType, 3, 3> cov_m = covariance(ps);
 
-            Eigen::SelfAdjointEigenSolver<Eigen::Matrix<ComputeType, 3, 3>> solver;
-            solver.computeDirect(cov_m);
-            ld = VectorType(solver.eigenvectors().col(2).template cast<ElementType>());
-            lp = VectorType(ps.sx(), ps.sy(), ps.sz());
-            sigma2 = solver.eigenvalues()[0] + solver.eigenvalues()[1];
+            ComputeType value;
+            ld = VectorType(EigenSolver::eigenvector(cov_m, value, 2).template cast<ElementType>());
+            lp = VectorType(ps.sx() + ps.reference.x(), ps.sy() + ps.reference.y(), ps.sz() + ps.reference.z());
+            sigma2 = cov_m.trace() - value;
 
             return true;
         }
@@ -148,7 +143,7 @@ namespace rtl
         template <class Iter>
         ConstrainedType trim(Iter beg, Iter end) const
         {
-            static_assert(std::is_constructible<VectorType, typename Iter::value_type>::value, "Invalid iterator value_type.");
+            static_assert(std::is_constructible<VectorType, typename std::iterator_traits<Iter>::value_type>::value, "Invalid iterator value_type.");
             return trim(*beg, *(--end));
         }
 
@@ -162,6 +157,33 @@ namespace rtl
         {
             ps.average();
 
+            Eigen::Matrix<ComputeType, 3, 3> cov_m = covariance(ps);
+
+            return cov_m.trace() - EigenSolver::largestEigenvalue(cov_m);
+        }
+
+        //! Lower and upper bound of the squared error of approximation of given precomputed sums.
+        /*!
+         * The bounds are given by eigenvalueBounds3D() and require no solution of the eigenproblem, which makes them considerably cheaper than getErrorSquared().
+         * Extractors use them to decide probes, whose error is surely above or below the threshold, without fitting the approximation.
+         * @param ps precomputed sums to be approximated.
+         * @return pair of the lower and the upper bound of the squared error of linear approximation of \p ps.
+         */
+        static std::pair<ElementType, ElementType> getErrorSquaredBounds(PrecSumsType ps)
+        {
+            ps.average();
+
+            Eigen::Matrix<ComputeType, 3, 3> cov_m = covariance(ps);
+            auto b = eigenvalueBounds3D(cov_m);
+            ComputeType trace = cov_m(0, 0) + cov_m(1, 1) + cov_m(2, 2);
+
+            return std::pair<ElementType, ElementType>(std::max(trace - b.max_upper, ComputeType(0)), trace - b.max_lower);
+        }
+
+    private:
+        //! Lower triangle of the covariance matrix of averaged precomputed sums.
+        static Eigen::Matrix<ComputeType, 3, 3> covariance(const PrecSumsType &ps)
+        {
             Eigen::Matrix<ComputeType, 3, 3> cov_m;
             cov_m(0, 0) = ps.sx2() - ps.sx() * ps.sx();
             cov_m(1, 0) = ps.sxy() - ps.sx() * ps.sy();
@@ -169,14 +191,9 @@ namespace rtl
             cov_m(1, 1) = ps.sy2() - ps.sy() * ps.sy();
             cov_m(2, 1) = ps.syz() - ps.sy() * ps.sz();
             cov_m(2, 2) = ps.sz2() - ps.sz() * ps.sz();
-
-            Eigen::SelfAdjointEigenSolver<Eigen::Matrix<ComputeType, 3, 3>> solver;
-            solver.computeDirect(cov_m, Eigen::DecompositionOptions::EigenvaluesOnly);
-
-            return solver.eigenvalues()[0] + solver.eigenvalues()[1];
+            return cov_m;
         }
 
-    private:
         VectorType lp, ld;
         ElementType sigma2{};
     };
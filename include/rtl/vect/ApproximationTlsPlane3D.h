@@ -29,6 +29,7 @@
 
 #include "rtl/Core.h"
 #include "rtl/vect/PrecSums.h"
+#include "rtl/vect/EigenSolver3D.h"
 
 namespace rtl
 {
@@ -39,8 +40,9 @@ namespace rtl
      *
      * @tparam Element base type of stored elements.
      * @tparam Compute type for performing computations.
+     * @tparam EigenSolver policy solving the eigenproblem of the covariance matrix, see rtl/vect/EigenSolver3D.h.
      */
-    template<typename Element, typename Compute>
+    template<typename Element, typename Compute, class EigenSolver = EigenSolverTrigonometric3D>
     class ApproximationTlsPlane3D
     {
     public:
@@ -93,23 +95,33 @@ namespace rtl
         bool operator()(PrecSumsType ps)
         {
             ps.average();
-            Eigen::Matrix<ComputeType, 3, 3> cov_m;
-            cov_m(0, 0) = ps.sx2() - ps.sx() * ps.sx();
-            cov_m(1, 0) = ps.sxy() - ps.sx() * ps.sy();
-            cov_m(2, 0) = ps.szx() - ps.sz() * ps.sx();
-            cov_m(1, 1) = ps.sy2() - ps.sy() * ps.sy();
-            cov_m(2, 1) = ps.syz() - ps.sy() * ps.sz();
-            cov_m(2, 2) = ps.sz2() - ps.sz() * ps.sz();
+            Eigen::Matrix<ComputeType, 3, 3> cov_m = covariance(ps);
 
-            Eigen::SelfAdjointEigenSolver<Eigen::Matrix<ComputeType, 3, 3>> solver;
-            solver.computeDirect(cov_m);
-            pn = VectorType(solver.eigenvectors().col(0).template cast<ElementType>());
-            pd = VectorType::scalarProjectionOnUnit(VectorType(ps.sx(), ps.sy(), ps.sz()), pn);
-            sigma2 = solver.eigenvalues()[0];
+            ComputeType value;
+            pn = VectorType(EigenSolver::eigenvector(cov_m, value, 0).template cast<ElementType>());
+            pd = VectorType::scalarProjectionOnUnit(VectorType(ps.sx() + ps.reference.x(), ps.sy() + ps.reference.y(), ps.sz() + ps.reference.z()), pn);
+            sigma2 = value;
 
             return true;
         }
 
+        //! Mean squared distance of a set of points to the plane.
+        /*!
+         * Unlike getErrorSquared(), the distances are measured to *this instead of the best fitting plane of the points, which allows to check consistency of a subset
+         * of points with an approximation of a larger set.
+         * @param ps precomputed sums of the points.
+         * @return mean squared distance of the points to *this.
+         */
+        [[nodiscard]] ElementType meanSquaredDistance(PrecSumsType ps) const
+        {
+            ps.average();
+            ComputeType nx = pn.x(), ny = pn.y(), nz = pn.z();
+            ComputeType offset = nx * ps.reference.x() + ny * ps.reference.y() + nz * ps.reference.z() - pd;
+            ComputeType second = nx * nx * ps.sx2() + ny * ny * ps.sy2() + nz * nz * ps.sz2() + 2 * (nx * ny * ps.sxy() + ny * nz * ps.syz() + nz * nx * ps.szx());
+            ComputeType first = nx * ps.sx() + ny * ps.sy() + nz * ps.sz();
+            return static_cast<ElementType>(second + 2 * offset * first + offset * offset);
+        }
+
         //! Projects a point onto the plane.
         /*!
          *
@@ -134,7 +146,7 @@ namespace rtl
         template <class Iter>
         ConstrainedType trim(Iter beg, Iter end, size_t size_hint = 0) const
         {
-            static_assert(std::is_constructible<VectorType, typename Iter::value_type>::value, "Invalid iterator value_type.");
+            static_assert(std::is_constructible<VectorType, typename std::iterator_traits<Iter>::value_type>::value, "Invalid iterator value_type.");
             ConstrainedType out(pn, pd);
             if (size_hint != 0)
                 out.reservePoints(size_hint);
@@ -143,15 +155,31 @@ namespace rtl
             return out;
         }
 
-        //! Trims the planar approximation by std::vector of points.
+        //! Trims the planar approximation by a contiguous sequence of points.
         /*!
          *
          * @param pts points to be projected onto *this forming an outline of the polygon.
          * @return constrained plane - the polygon.
          */
-        ConstrainedType trim(const std::vector<VectorType> &pts) const
+        ConstrainedType trim(Span<const VectorType> pts) const
         {
-            return trim(pts.begin(), pts.end(), pts.size());
+            ConstrainedType out(pn, pd);
+            out.addPoints(pts);
+            return out;
+        }
+
+        //! Trims the planar approximation to the convex hull of a contiguous sequence of points.
+        /*!
+         * Unlike trim(), only the boundary of the projected points is kept, see Polygon3D::addPointsConvexHull(). Suitable for large sets of inliers, whose interior
+         * points would only slow down rendering and intersection of the polygon.
+         * @param pts points to be projected onto *this, the polygon is their convex hull.
+         * @return constrained plane - the convex polygon.
+         */
+        ConstrainedType trimConvex(Span<const VectorType> pts) const
+        {
+            ConstrainedType out(pn, pd);
+            out.addPointsConvexHull(pts);
+            return out;
         }
 
         //! Squared error of approximation of given precomputed sums.
@@ -164,6 +192,32 @@ namespace rtl
         {
             ps.average();
 
+            Eigen::Matrix<ComputeType, 3, 3> cov_m = covariance(ps);
+
+            return EigenSolver::smallestEigenvalue(cov_m);
+        }
+
+        //! Lower and upper bound of the squared error of approximation of given precomputed sums.
+        /*!
+         * The bounds are given by eigenvalueBounds3D() and require no solution of the eigenproblem, which makes them considerably cheaper than getErrorSquared().
+         * Extractors use them to decide probes, whose error is surely above or below the threshold, without fitting the approximation.
+         * @param ps precomputed sums to be approximated.
+         * @return pair of the lower and the upper bound of the squared error of planar approximation of \p ps.
+         */
+        static std::pair<ElementType, ElementType> getErrorSquaredBounds(PrecSumsType ps)
+        {
+            ps.average();
+
+            Eigen::Matrix<ComputeType, 3, 3> cov_m = covariance(ps);
+            auto b = eigenvalueBounds3D(cov_m);
+
+            return std::pair<ElementType, ElementType>(b.min_lower, b.min_upper);
+        }
+
+    private:
+        //! Lower triangle of the covariance matrix of averaged precomputed sums.
+        static Eigen::Matrix<ComputeType, 3, 3> covariance(const PrecSumsType &ps)
+        {
             Eigen::Matrix<ComputeType, 3, 3> cov_m;
             cov_m(0, 0) = ps.sx2() - ps.sx() * ps.sx();
             cov_m(1, 0) = ps.sxy() - ps.sx() * ps.sy();
@@ -171,14 +225,9 @@ namespace rtl
             cov_m(1, 1) = ps.sy2() - ps.sy() * ps.sy();
             cov_m(2, 1) = ps.syz() - ps.sy() * ps.sz();
             cov_m(2, 2) = ps.sz2() - ps.sz() * ps.sz();
-
-            Eigen::SelfAdjointEigenSolver<Eigen::Matrix<ComputeType, 3, 3>> solver;
-            solver.computeDirect(cov_m, Eigen::DecompositionOptions::EigenvaluesOnly);
-
-            return solver.eigenvalues()[0];
+            return cov_m;
         }
 
-    private:
         VectorType pn;
         ElementType pd{}, sigma2{};
     };
@@ -0,0 +1,230 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_VECT_EIGENSOLVER3D_H
+#define ROBOTICTEMPLATELIBRARY_VECT_EIGENSOLVER3D_H
+
+#include <cmath>
+#include <algorithm>
+#include <eigen3/Eigen/Dense>
+
+#include "rtl/core/Constants.h"
+
+namespace rtl
+{
+    /*! \file
+     *  \brief Policies solving the eigenproblem of symmetric 3x3 covariance matrices in 3D approximations.
+     *
+     *  A policy provides static functions eigenvalues(), eigenvector(), smallestEigenvalue() and largestEigenvalue(). Only the lower triangle of the input matrix
+     *  is used and the eigenvalues are returned in ascending order. The eigenvector() function returns a unit eigenvector together with its eigenvalue, index 0
+     *  corresponds to the smallest eigenvalue, index 2 to the largest one.
+     */
+
+    //! Bounds of the extreme eigenvalues of a symmetric positive semi-definite 3x3 matrix.
+    template<typename T>
+    struct EigenvalueBounds3D
+    {
+        T min_lower;    //!< Lower bound of the smallest eigenvalue.
+        T min_upper;    //!< Upper bound of the smallest eigenvalue.
+        T max_lower;    //!< Lower bound of the largest eigenvalue.
+        T max_upper;    //!< Upper bound of the largest eigenvalue.
+    };
+
+    //! Bounds of the smallest and the largest eigenvalue of a covariance matrix computed without solving the eigenproblem.
+    /*!
+     * Only the lower triangle of \p m is used. The eigenvalues are mean + 2 * sqrt(p) * cos(phi + 2 * k * pi / 3) with phi in [0, pi / 3] (see EigenSolverTrigonometric3D),
+     * so the largest one lies in [mean + sqrt(p), mean + 2 * sqrt(p)] and the smallest one in [mean - 2 * sqrt(p), mean - sqrt(p)]. The intervals are tightened by
+     * the diagonal, which lies between the extreme eigenvalues, by the trace for the largest eigenvalue and by the determinant for the smallest one
+     * (det = l0 * l1 * l2 <= l0 * (trace / 2)^2).
+     * @param m symmetric positive semi-definite matrix.
+     * @return bounds of the extreme eigenvalues.
+     */
+    template<typename T>
+    EigenvalueBounds3D<T> eigenvalueBounds3D(const Eigen::Matrix<T, 3, 3> &m)
+    {
+        T trace = m(0, 0) + m(1, 1) + m(2, 2), mean = trace / 3;
+        T a = m(0, 0) - mean, b = m(1, 1) - mean, c = m(2, 2) - mean;
+        T d = m(1, 0), e = m(2, 1), f = m(2, 0);
+        T p_sqrt = std::sqrt(std::max((a * a + b * b + c * c + 2 * (d * d + e * e + f * f)) / 6, T(0)));
+        T diag_min = std::min({m(0, 0), m(1, 1), m(2, 2)}), diag_max = std::max({m(0, 0), m(1, 1), m(2, 2)});
+
+        EigenvalueBounds3D<T> ret;
+        ret.min_upper = std::min(mean - p_sqrt, diag_min);
+        ret.max_lower = std::max(mean + p_sqrt, diag_max);
+        ret.max_upper = std::min(mean + 2 * p_sqrt, trace);
+        ret.min_lower = std::max(mean - 2 * p_sqrt, T(0));
+        if (trace > 0)
+        {
+            T det = m(0, 0) * (m(1, 1) * m(2, 2) - e * e) - d * (d * m(2, 2) - e * f) + f * (d * e - m(1, 1) * f);
+            ret.min_lower = std::max(ret.min_lower, 4 * det / (trace * trace));
+        }
+        return ret;
+    }
+
+    //! Eigen-solver policy using the iterative Eigen::SelfAdjointEigenSolver::compute(). The slowest, but the most precise for nearly degenerate matrices.
+    struct EigenSolverIterative3D
+    {
+        template<typename T>
+        static Eigen::Matrix<T, 3, 1> eigenvalues(const Eigen::Matrix<T, 3, 3> &m)
+        {
+            return Eigen::SelfAdjointEigenSolver<Eigen::Matrix<T, 3, 3>>(m, Eigen::EigenvaluesOnly).eigenvalues();
+        }
+
+        template<typename T>
+        static Eigen::Matrix<T, 3, 1> eigenvector(const Eigen::Matrix<T, 3, 3> &m, T &value, int index)
+        {
+            Eigen::SelfAdjointEigenSolver<Eigen::Matrix<T, 3, 3>> solver(m);
+            value = solver.eigenvalues()[index];
+            return solver.eigenvectors().col(index);
+        }
+
+        template<typename T>
+        static T smallestEigenvalue(const Eigen::Matrix<T, 3, 3> &m) { return eigenvalues(m)[0]; }
+
+        template<typename T>
+        static T largestEigenvalue(const Eigen::Matrix<T, 3, 3> &m) { return eigenvalues(m)[2]; }
+    };
+
+    //! Eigen-solver policy using the closed-form Eigen::SelfAdjointEigenSolver::computeDirect().
+    struct EigenSolverDirect3D
+    {
+        template<typename T>
+        static Eigen::Matrix<T, 3, 1> eigenvalues(const Eigen::Matrix<T, 3, 3> &m)
+        {
+            Eigen::SelfAdjointEigenSolver<Eigen::Matrix<T, 3, 3>> solver;
+            solver.computeDirect(m, Eigen::EigenvaluesOnly);
+            return solver.eigenvalues();
+        }
+
+        template<typename T>
+        static Eigen::Matrix<T, 3, 1> eigenvector(const Eigen::Matrix<T, 3, 3> &m, T &value, int index)
+        {
+            Eigen::SelfAdjointEigenSolver<Eigen::Matrix<T, 3, 3>> solver;
+            solver.computeDirect(m);
+            value = solver.eigenvalues()[index];
+            return solver.eigenvectors().col(index);
+        }
+
+        template<typename T>
+        static T smallestEigenvalue(const Eigen::Matrix<T, 3, 3> &m) { return eigenvalues(m)[0]; }
+
+        template<typename T>
+        static T largestEigenvalue(const Eigen::Matrix<T, 3, 3> &m) { return eigenvalues(m)[2]; }
+    };
+
+    //! Eigen-solver policy with the trigonometric solution of the characteristic polynomial.
+    /*!
+     * The eigenvalues are given by the trigonometric formula for roots of the characteristic cubic of the matrix shifted by the mean of its diagonal. A single eigenvalue
+     * requires one evaluation of cosine and the eigenvector is found as the longest cross product of rows of the matrix with the eigenvalue subtracted from its diagonal.
+     * Only the requested eigenpair is computed, which makes the policy the fastest one. The precision is comparable to EigenSolverDirect3D.
+     */
+    struct EigenSolverTrigonometric3D
+    {
+        template<typename T>
+        static Eigen::Matrix<T, 3, 1> eigenvalues(const Eigen::Matrix<T, 3, 3> &m)
+        {
+            T mean, p_sqrt, phi;
+            characteristic(m, mean, p_sqrt, phi);
+            T v0 = root(mean, p_sqrt, phi, 0), v2 = root(mean, p_sqrt, phi, 2);
+            return Eigen::Matrix<T, 3, 1>(v0, 3 * mean - v0 - v2, v2);
+        }
+
+        template<typename T>
+        static Eigen::Matrix<T, 3, 1> eigenvector(const Eigen::Matrix<T, 3, 3> &m, T &value, int index)
+        {
+            T mean, p_sqrt, phi;
+            characteristic(m, mean, p_sqrt, phi);
+            value = root(mean, p_sqrt, phi, index);
+
+            Eigen::Matrix<T, 3, 1> r0(m(0, 0) - value, m(1, 0), m(2, 0));
+            Eigen::Matrix<T, 3, 1> r1(m(1, 0), m(1, 1) - value, m(2, 1));
+            Eigen::Matrix<T, 3, 1> r2(m(2, 0), m(2, 1), m(2, 2) - value);
+            Eigen::Matrix<T, 3, 1> c01 = r0.cross(r1), c02 = r0.cross(r2), c12 = r1.cross(r2);
+            T n01 = c01.squaredNorm(), n02 = c02.squaredNorm(), n12 = c12.squaredNorm();
+            if (n01 >= n02 && n01 >= n12 && n01 > 0)
+                return c01 / std::sqrt(n01);
+            if (n02 >= n12 && n02 > 0)
+                return c02 / std::sqrt(n02);
+            if (n12 > 0)
+                return c12 / std::sqrt(n12);
+
+            // Multiple eigenvalue: the rows are parallel and any vector orthogonal to them is an eigenvector.
+            Eigen::Matrix<T, 3, 1> r = r0.squaredNorm() >= r1.squaredNorm() ? r0 : r1;
+            r = r.squaredNorm() >= r2.squaredNorm() ? r : r2;
+            if (r.squaredNorm() == 0)
+                return Eigen::Matrix<T, 3, 1>::Unit(index);
+            Eigen::Index axis;
+            r.cwiseAbs().minCoeff(&axis);
+            return r.cross(Eigen::Matrix<T, 3, 1>::Unit(axis)).normalized();
+        }
+
+        template<typename T>
+        static T smallestEigenvalue(const Eigen::Matrix<T, 3, 3> &m)
+        {
+            T mean, p_sqrt, phi;
+            characteristic(m, mean, p_sqrt, phi);
+            return root(mean, p_sqrt, phi, 0);
+        }
+
+        template<typename T>
+        static T largestEigenvalue(const Eigen::Matrix<T, 3, 3> &m)
+        {
+            T mean, p_sqrt, phi;
+            characteristic(m, mean, p_sqrt, phi);
+            return root(mean, p_sqrt, phi, 2);
+        }
+
+    private:
+        //! Parameters of the trigonometric solution: eigenvalues are \p mean + 2 * \p p_sqrt * cos(\p phi + 2 * k * pi / 3).
+        template<typename T>
+        static void characteristic(const Eigen::Matrix<T, 3, 3> &m, T &mean, T &p_sqrt, T &phi)
+        {
+            mean = (m(0, 0) + m(1, 1) + m(2, 2)) / 3;
+            T a = m(0, 0) - mean, b = m(1, 1) - mean, c = m(2, 2) - mean;
+            T d = m(1, 0), e = m(2, 1), f = m(2, 0);
+            T p = (a * a + b * b + c * c + 2 * (d * d + e * e + f * f)) / 6;
+            if (p <= 0)
+            {
+                p_sqrt = phi = 0;
+                return;
+            }
+            p_sqrt = std::sqrt(p);
+            T half_det = (a * (b * c - e * e) - d * (d * c - e * f) + f * (d * e - b * f)) / 2;
+            T r = std::clamp(half_det / (p * p_sqrt), T(-1), T(1));
+            phi = std::acos(r) / 3;
+        }
+
+        //! Eigenvalue with given index in the ascending order.
+        template<typename T>
+        static T root(T mean, T p_sqrt, T phi, int index)
+        {
+            constexpr int shift[3] = {1, 2, 0};
+            return mean + 2 * p_sqrt * std::cos(phi + shift[index] * 2 * C_PI<T> / 3);
+        }
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_VECT_EIGENSOLVER3D_H
@@ -27,12 +27,19 @@
 #ifndef ROBOTICTEMPLATELIBRARY_VECT_EXTRACTORCHAINFAST_H
 #define ROBOTICTEMPLATELIBRARY_VECT_EXTRACTORCHAINFAST_H
 
+#include <utility>
+#include <experimental/type_traits>
+
+#include "rtl/core/Instrumentation.h"
+#include "rtl/vect/VectorizationStats.h"
+
 namespace rtl
 {
     //! Extracts geometrical primitives from an ordered point cloud.
     /*!
      * Approximation fitting works on the binary search principle - to fit an approximation to the longest section of \a N point chain,
-     * roughly \a log \a N computations is required.
+     * roughly \a log \a N computations is required. If the \p Approximation provides static getErrorSquaredBounds() (see e.g. ApproximationTlsLine3D), probes
+     * with the error surely above or below the threshold are decided from the bounds without solving the eigenproblem.
      * @tparam SumArray type of the array of precomputed sums used.
      * @tparam Approximation type of approximation to be fitted to the data.
      */
@@ -64,33 +71,88 @@ namespace rtl
          * @param sum_array precomputed sums to be processed.
          * @param approximations output parameter for found approximations.
          * @param indices output parameter for indices defining valid range for \p approximations.
+         * @param stats optional statistics, the numbers of fits and extracted primitives are added to it.
          * @return true on success, false otherwise.
          */
-        bool operator()(const SumArray &sum_array, std::vector <Approximation> &approximations, std::vector <IndexType> &indices)
+        bool operator()(const SumArray &sum_array, std::vector <Approximation> &approximations, std::vector <IndexType> &indices, VectorizationStats *stats = nullptr)
         {
-            beg_i = 0;
-            last_pt = sum_array.size() - 1;
-            end_i = last_pt;
-            n = end_i;
-
+            RTL_ZONE("rtl::ExtractorChainFast");
             approximations.clear();
             indices.clear();
 
+            return (*this)(sum_array, approximations, indices, 0, stats);
+        }
+
+        //! Functor call for processing of a tail of an array of precomputed sums.
+        /*!
+         * Extraction starts at the point \p first_pt and continues to the end of \p sum_array. Output parameters are not cleared, the found approximations and indices
+         * are appended behind their previous content instead. This allows re-extraction of just the tail of a point cloud, which has been extended since the last extraction.
+         * @param sum_array precomputed sums to be processed.
+         * @param approximations output parameter for found approximations.
+         * @param indices output parameter for indices defining valid range for \p approximations.
+         * @param first_pt index of the first point to be processed.
+         * @param stats optional statistics, the numbers of fits and extracted primitives are added to it.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(const SumArray &sum_array, std::vector <Approximation> &approximations, std::vector <IndexType> &indices, size_t first_pt,
+                        VectorizationStats *stats = nullptr)
+        {
+            size_t fits = 0, pruned = 0, prev_size = approximations.size();
+            last_pt = sum_array.size() - 1;
+            beg_i = first_pt;
+            if (beg_i > 0 && beg_i + 2 > last_pt)
+                beg_i = last_pt - 2;
+            end_i = last_pt;
+            n = end_i - beg_i;
+
             while (true)
             {
-                appr(sum_array.sums(beg_i, end_i));
-                if (appr.errSquared() < err2)
+                // probes with the error surely above or below the threshold are decided by the bounds, the approximation is fitted only when it is stored
+                auto sums = sum_array.sums(beg_i, end_i);
+                bool fitted = false, pass;
+                if constexpr (std::experimental::is_detected_v<ErrorBounds, Approximation, decltype(sums)>)
+                {
+                    auto bounds = Approximation::getErrorSquaredBounds(sums);
+                    if (bounds.first >= err2 || bounds.second < err2)
+                    {
+                        pass = bounds.second < err2;
+                        pruned++;
+                    }
+                    else
+                    {
+                        appr(sums);
+                        fits++;
+                        fitted = true;
+                        pass = appr.errSquared() < err2;
+                    }
+                }
+                else
+                {
+                    appr(sums);
+                    fits++;
+                    fitted = true;
+                    pass = appr.errSquared() < err2;
+                }
+                auto store = [&]() {
+                    if (!fitted)
+                    {
+                        appr(sums);
+                        fits++;
+                    }
+                    approximations.push_back(appr);
+                    indices.emplace_back(beg_i, end_i);
+                };
+
+                if (pass)
                 {
                     if (end_i == last_pt)
                     {
-                        approximations.push_back(appr);
-                        indices.emplace_back(beg_i, end_i);
+                        store();
                         break;
                     }
                     if (n == 0)
                     {
-                        approximations.push_back(appr);
-                        indices.emplace_back(beg_i, end_i);
+                        store();
                         beg_i = end_i;
                         end_i = last_pt;
 
@@ -117,13 +179,11 @@ namespace rtl
                         {
                             if (end_i == last_pt)
                             {
-                                approximations.push_back(appr);
-                                indices.emplace_back(beg_i, end_i);
+                                store();
                                 break;
                             }
 
-                            approximations.push_back(appr);
-                            indices.emplace_back(beg_i, end_i);
+                            store();
                             beg_i = end_i;
                             end_i = last_pt;
                             if (beg_i > end_i - 2)
@@ -140,10 +200,19 @@ namespace rtl
                     }
                 }
             }
+            if (stats != nullptr)
+            {
+                stats->fits += fits;
+                stats->pruned += pruned;
+                stats->extracted += approximations.size() - prev_size;
+            }
             return true;
         }
 
     private:
+        template<class Appr, class Sums>
+        using ErrorBounds = decltype(Appr::getErrorSquaredBounds(std::declval<Sums>()));
+
         Approximation appr;
         size_t beg_i{}, end_i{}, last_pt{}, n{};
         ElementType err2;
@@ -27,12 +27,17 @@
 #ifndef ROBOTICTEMPLATELIBRARY_VECT_EXTRACTORCHAININCREMENTAL_H
 #define ROBOTICTEMPLATELIBRARY_VECT_EXTRACTORCHAININCREMENTAL_H
 
+#include "rtl/core/Instrumentation.h"
+#include "rtl/vect/VectorizationStats.h"
+
 namespace rtl
 {
     //! Extracts geometrical primitives from a continuous stream from an ordered point cloud.
     /*!
-     * Gradually adds points to the approximation until the threshold given by setSigma() is passed, the approximation is saved and theprocess is repeated.
-     * This method does not require an array of precomputed data, but is slow because the approximation is recomputed for each point.
+     * Gradually adds points to the approximation until the threshold given by setSigma() is passed, the approximation is saved and the process is repeated.
+     * This method does not require an array of precomputed data. The running sums are updated in place relative to the first point of the current primitive and the last
+     * fitted approximation is kept. Total squared distance of the points to this approximation bounds the error of the optimal one from above, so the closed-form fit is
+     * recomputed only when the bound exceeds the threshold. A point which breaks the threshold even after the refit is rolled back and starts a new primitive.
      * @tparam Approximation type of approximation to be fitted to the data.
      */
     template<class Approximation>
@@ -65,31 +70,35 @@ namespace rtl
          * @param pts points to be processed.
          * @param approximations output parameter for found approximations.
          * @param indices output parameter for indices defining valid range for \p approximations.
+         * @param stats optional statistics, the numbers of fits and extracted primitives are added to it.
          * @return true on success, false otherwise.
          */
-        bool operator()(const std::vector<VectorType> &pts, std::vector<Approximation> &approximations, std::vector<IndexType> &indices)
+        bool operator()(Span<const VectorType> pts, std::vector<Approximation> &approximations, std::vector<IndexType> &indices, VectorizationStats *stats = nullptr)
         {
-            beg_i = 0;
-            end_i = 0;
-            sums.setZero();
-
+            RTL_ZONE("rtl::ExtractorChainIncremental");
             approximations.clear();
             indices.clear();
+            if (pts.empty())
+                return true;
+
+            beg_i = 0;
+            end_i = 0;
+            fits = 0;
+            restart(pts[0]);
 
             while (end_i < pts.size())
             {
-                PrecSumsType ps(pts[end_i].template cast<ComputeType>());
-                sums += ps;
-                if (Approximation::getErrorSquared(sums) < err2)
+                if (append(pts[end_i]))
                 {
                     end_i++;
                     continue;
                 }
 
-                approximations.emplace_back(sums - ps);
+                approximations.emplace_back(sums);
                 indices.emplace_back(beg_i, end_i);
 
-                sums = ps;
+                restart(pts[end_i]);
+                addPoint(pts[end_i]);
                 beg_i = end_i;
                 end_i++;
             }
@@ -98,13 +107,69 @@ namespace rtl
                 approximations.emplace_back(sums);
                 indices.emplace_back(beg_i, end_i);
             }
+            if (stats != nullptr)
+            {
+                stats->fits += fits;
+                stats->extracted += approximations.size();
+            }
             return true;
         }
 
     private:
-        size_t beg_i{}, end_i{};
-        ElementType err2;
+        //! Starts a new primitive with sums relative to its first point.
+        void restart(const VectorType &pt)
+        {
+            sums.setZero();
+            sums.reference = pt.template cast<ComputeType>();
+            fitted = false;
+            bound = 0;
+        }
+
+        //! Adds a single point to the running sums.
+        void addPoint(const VectorType &pt)
+        {
+            ComputeType terms[PrecSumsType::sumNr()];
+            PrecSumsType::pointSums(pt, sums.reference, terms);
+            for (size_t k = 0; k < PrecSumsType::sumNr(); k++)
+                sums.sums[k] += terms[k];
+            sums.sums[PrecSumsType::sumNr()] += 1;
+        }
+
+        //! Adds a point if the approximation stays within the threshold, the sums are rolled back otherwise.
+        bool append(const VectorType &pt)
+        {
+            PrecSumsType prev = sums;
+            addPoint(pt);
+            ElementType cnt = static_cast<ElementType>(sums.sums[PrecSumsType::sumNr()]);
+
+            if (fitted)
+            {
+                ElementType d2 = (pt - approximation.project(pt)).lengthSquared();
+                if (bound + d2 < err2 * cnt)
+                {
+                    bound += d2;
+                    return true;
+                }
+            }
+
+            approximation(sums);
+            fits++;
+            if (approximation.errSquared() < err2)
+            {
+                fitted = cnt >= 2;
+                bound = approximation.errSquared() * cnt;
+                return true;
+            }
+
+            sums = prev;
+            return false;
+        }
+
+        size_t beg_i{}, end_i{}, fits{};
+        ElementType err2, bound{};
+        bool fitted{false};
         PrecSumsType sums;
+        Approximation approximation;
     };
 }
 
@@ -0,0 +1,236 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_VECT_EXTRACTORPLANEQUADTREE_H
+#define ROBOTICTEMPLATELIBRARY_VECT_EXTRACTORPLANEQUADTREE_H
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+#include "rtl/core/Instrumentation.h"
+#include "rtl/vect/VectorizationStats.h"
+
+namespace rtl
+{
+    //! Extracts planar regions from an organized (image-like) point cloud.
+    /*!
+     * The grid is recursively split into quadrants until the plane fitted to a patch satisfies the threshold given by setSigma(). Patches not smaller than setMinPatch()
+     * in both directions, which still do not fit a plane, are discarded. The accepted patches are then grown into regions: neighbouring regions are merged greedily, pairs
+     * with the smallest error of the merged fit first, as long as the merged plane satisfies the threshold for the union as well as for both merged regions separately.
+     * The latter condition stops large regions from absorbing small patches across edges, which would pass the threshold on average. Every fit is evaluated from
+     * the summed-area table in constant time, regardless of the size of the patch or region.
+     * @tparam SumGrid type of the summed-area table of precomputed sums, e.g. PrecGrid3D.
+     * @tparam Approximation type of the planar approximation.
+     */
+    template<class SumGrid, class Approximation>
+    class ExtractorPlaneQuadtree
+    {
+    public:
+        typedef typename Approximation::ElementType ElementType;    //!< Base type of stored elements.
+        typedef typename Approximation::ComputeType ComputeType;    //!< Base type for precise computations.
+        typedef typename Approximation::PrecSumsType PrecSumsType;  //!< Precomputed sums required by the \p Approximation.
+
+        static constexpr size_t unassigned = std::numeric_limits<size_t>::max();   //!< Label of cells not belonging to any region.
+
+        //! Default constructor.
+        ExtractorPlaneQuadtree() = default;
+
+        //! Default destructor.
+        ~ExtractorPlaneQuadtree() = default;
+
+        //! Sets maximal permitted standard deviation of point-approximation distances.
+        /*!
+         *
+         * @param sigma new standard deviation.
+         */
+        void setSigma(ElementType sigma) { err2 = sigma * sigma; }
+
+        //! Sets the size of the smallest patches, which are not split any further.
+        /*!
+         *
+         * @param side number of rows and columns of the smallest patch, 4 by default.
+         */
+        void setMinPatch(size_t side) { min_patch = std::max<size_t>(side, 1); }
+
+        //! Sets the minimal number of points of an output region.
+        /*!
+         *
+         * @param pts number of valid points, 64 by default.
+         */
+        void setMinPoints(size_t pts) { min_points = pts; }
+
+        //! Functor call for processing of a summed-area table.
+        /*!
+         * Output parameters are always cleared before the extraction process.
+         * @param sum_grid summed-area table of the processed grid.
+         * @param approximations output parameter for planes of the found regions.
+         * @param labels output parameter with region index of each cell of the grid in row-major order, unassigned for cells outside all regions.
+         * @param stats optional statistics, the numbers of fits, region merges and extracted planes are added to it.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(const SumGrid &sum_grid, std::vector<Approximation> &approximations, std::vector<size_t> &labels, VectorizationStats *stats = nullptr)
+        {
+            RTL_ZONE("rtl::ExtractorPlaneQuadtree");
+            size_t rows = sum_grid.rows(), cols = sum_grid.cols();
+            approximations.clear();
+            labels.assign(rows * cols, unassigned);
+            fits = 0;
+            splitPatches(sum_grid);
+
+            // Leaf index of each valid cell and pairs of neighbouring leaves.
+            for (size_t l = 0; l < leaves.size(); l++)
+                for (size_t r = leaves[l].row_beg; r < leaves[l].row_end; r++)
+                    for (size_t c = leaves[l].col_beg; c < leaves[l].col_end; c++)
+                        if (sum_grid.valid(r, c))
+                            labels[r * cols + c] = l;
+            pairs.clear();
+            for (size_t r = 0; r < rows; r++)
+                for (size_t c = 0; c < cols; c++)
+                {
+                    size_t a = labels[r * cols + c];
+                    if (a == unassigned)
+                        continue;
+                    if (size_t b = c + 1 < cols ? labels[r * cols + c + 1] : unassigned; b != unassigned && b != a)
+                        pairs.emplace_back(0, std::minmax(a, b));
+                    if (size_t b = r + 1 < rows ? labels[(r + 1) * cols + c] : unassigned; b != unassigned && b != a)
+                        pairs.emplace_back(0, std::minmax(a, b));
+                }
+            std::sort(pairs.begin(), pairs.end(), [](const PairType &p1, const PairType &p2) { return p1.second < p2.second; });
+            pairs.erase(std::unique(pairs.begin(), pairs.end(), [](const PairType &p1, const PairType &p2) { return p1.second == p2.second; }), pairs.end());
+
+            // Greedy merging of neighbouring regions, the most coplanar pairs first.
+            parent.resize(leaves.size());
+            for (size_t l = 0; l < leaves.size(); l++)
+                parent[l] = l;
+            for (auto &p : pairs)
+                p.first = Approximation::getErrorSquared(leaves[p.second.first].sums + leaves[p.second.second].sums);
+            fits += pairs.size();
+            std::sort(pairs.begin(), pairs.end(), [](const PairType &p1, const PairType &p2) { return p1.first < p2.first; });
+            size_t merges = 0;
+            for (const auto &p : pairs)
+            {
+                if (p.first >= err2)
+                    break;
+                size_t ra = root(p.second.first), rb = root(p.second.second);
+                if (ra == rb)
+                    continue;
+                PrecSumsType merged = leaves[ra].sums + leaves[rb].sums;
+                Approximation plane(merged);
+                fits++;
+                if (plane.errSquared() < err2 && plane.meanSquaredDistance(leaves[ra].sums) < err2 && plane.meanSquaredDistance(leaves[rb].sums) < err2)
+                {
+                    parent[rb] = ra;
+                    leaves[ra].sums = merged;
+                    merges++;
+                }
+            }
+
+            region.assign(leaves.size(), unassigned);
+            for (size_t l = 0; l < leaves.size(); l++)
+                if (size_t rl = root(l); rl == l && leaves[l].sums.cnt() >= static_cast<ComputeType>(min_points))
+                {
+                    region[l] = approximations.size();
+                    approximations.emplace_back(leaves[l].sums);
+                }
+            for (auto &l : labels)
+                if (l != unassigned)
+                    l = region[root(l)];
+            if (stats != nullptr)
+            {
+                stats->fits += fits;
+                stats->merges += merges;
+                stats->extracted += approximations.size();
+            }
+            return true;
+        }
+
+    private:
+        struct Patch
+        {
+            size_t row_beg, col_beg, row_end, col_end;
+            PrecSumsType sums;
+        };
+        typedef std::pair<ElementType, std::pair<size_t, size_t>> PairType;
+
+        //! Quadtree decomposition of the grid into patches fitting a plane.
+        void splitPatches(const SumGrid &sum_grid)
+        {
+            leaves.clear();
+            stack.clear();
+            stack.push_back(Patch{0, 0, sum_grid.rows(), sum_grid.cols(), {}});
+            while (!stack.empty())
+            {
+                Patch p = std::move(stack.back());
+                stack.pop_back();
+                size_t cnt = sum_grid.count(p.row_beg, p.col_beg, p.row_end, p.col_end);
+                if (cnt == 0)
+                    continue;
+                p.sums = sum_grid.sums(p.row_beg, p.col_beg, p.row_end, p.col_end);
+                if (cnt >= 3)
+                {
+                    fits++;
+                    if (Approximation::getErrorSquared(p.sums) < err2)
+                    {
+                        leaves.push_back(std::move(p));
+                        continue;
+                    }
+                }
+
+                size_t h = p.row_end - p.row_beg, w = p.col_end - p.col_beg;
+                if (h <= min_patch && w <= min_patch)
+                    continue;
+                size_t row_mid = h > min_patch ? p.row_beg + h / 2 : p.row_end, col_mid = w > min_patch ? p.col_beg + w / 2 : p.col_end;
+                stack.push_back(Patch{p.row_beg, p.col_beg, row_mid, col_mid, {}});
+                if (col_mid < p.col_end)
+                    stack.push_back(Patch{p.row_beg, col_mid, row_mid, p.col_end, {}});
+                if (row_mid < p.row_end)
+                    stack.push_back(Patch{row_mid, p.col_beg, p.row_end, col_mid, {}});
+                if (row_mid < p.row_end && col_mid < p.col_end)
+                    stack.push_back(Patch{row_mid, col_mid, p.row_end, p.col_end, {}});
+            }
+        }
+
+        size_t root(size_t l)
+        {
+            while (parent[l] != l)
+            {
+                parent[l] = parent[parent[l]];
+                l = parent[l];
+            }
+            return l;
+        }
+
+        ElementType err2{};
+        size_t min_patch{4}, min_points{64}, fits{};
+        std::vector<Patch> leaves, stack;
+        std::vector<PairType> pairs;
+        std::vector<size_t> parent, region;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_VECT_EXTRACTORPLANEQUADTREE_H
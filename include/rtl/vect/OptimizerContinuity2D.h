@@ -27,6 +27,14 @@
 #ifndef ROBOTICTEMPLATELIBRARY_VECT_OPTIMIZERCONTINUITY2D_H
 #define ROBOTICTEMPLATELIBRARY_VECT_OPTIMIZERCONTINUITY2D_H
 
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "rtl/core/Executor.h"
+#include "rtl/core/Instrumentation.h"
+#include "rtl/vect/VectorizationStats.h"
+
 namespace rtl
 {
     //! Checks intersections and fixes 2D line approximations, if continuous output polyline is required.
@@ -35,10 +43,16 @@ namespace rtl
      * close to the cloud (in principle they might not intersect at all). If a continuous polyline is required as the vectorization output,
      * these artifacts can be fixed by addition of an extra approximation bridging the inflexion point. Requires array of precomputed sums
      * to work.
+     *
+     * With a concurrent \p Executor, the break points are processed by a red-black sweep: each check or split touches just the two approximations adjacent to
+     * the break point, so all odd break points are processed in parallel, then all even ones, and the sweeps repeat on the break points next to the inserted
+     * approximations until all of them are continuous. Unlike the sequential walk, the break point preceding a split pair is checked again, so the result
+     * might differ slightly.
      * @tparam SumArray type of precomputed sums.
      * @tparam Approximation type approximation used.
+     * @tparam Executor execution policy for the red-black sweep, see rtl/core/Executor.h.
      */
-    template <class SumArray, class Approximation>
+    template <class SumArray, class Approximation, class Executor = SequentialExecutor>
     class OptimizerContinuity2D
     {
     public:
@@ -51,6 +65,9 @@ namespace rtl
         //! Default constructor.
         OptimizerContinuity2D() = default;
 
+        //! Construction with given executor for the red-black sweep.
+        explicit OptimizerContinuity2D(Executor exec) : executor(std::move(exec)) {}
+
         //! Default destructor.
         ~OptimizerContinuity2D() = default;
 
@@ -70,52 +87,194 @@ namespace rtl
          * @param sum_array precomputed sums.
          * @param lines linear approximations to be optimized.
          * @param indices range indices of the approximations to be optimized.
+         * @param stats optional statistics, the number of inserted approximations is added to it.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(Span<const VectorType> pts, const SumArray &sum_array, std::vector<Approximation> &lines, std::vector<IndexType> &indices,
+                        VectorizationStats *stats = nullptr)
+        {
+            return (*this)(pts, sum_array, lines, indices, 0, stats);
+        }
+
+        //! Functor call for incremental optimization of approximations, whose head has not changed since the last optimization.
+        /*!
+         * Break points between the first \p first_line approximations are considered continuous already and only the following ones are checked. This suits
+         * streaming vectorization, where just the tail of the approximations is re-extracted for each new chunk of points, see VectorizerFTLSPolyline2D::append().
+         * @param pts vectorized points.
+         * @param sum_array precomputed sums.
+         * @param lines linear approximations to be optimized.
+         * @param indices range indices of the approximations to be optimized.
+         * @param first_line number of leading approximations optimized by a previous call and left unchanged since.
+         * @param stats optional statistics, the number of inserted approximations is added to it.
          * @return true on success, false otherwise.
          */
-        bool operator()(const std::vector<VectorType> &pts, const SumArray &sum_array, std::vector<Approximation> &lines, std::vector<IndexType> &indices)
+        bool operator()(Span<const VectorType> pts, const SumArray &sum_array, std::vector<Approximation> &lines, std::vector<IndexType> &indices,
+                        size_t first_line, VectorizationStats *stats = nullptr)
         {
+            RTL_ZONE("rtl::OptimizerContinuity2D");
             if (lines.size() < 2)
                 return true;
-            else
+
+            size_t prev_size = lines.size();
+            bool ret = executor.concurrency() > 1 ? sweep(pts, sum_array, lines, indices, first_line) : walk(pts, sum_array, lines, indices, first_line);
+            if (stats != nullptr)
+                stats->splits += lines.size() - prev_size;
+            return ret;
+        }
+
+    private:
+        //! Result of processing of a single break point.
+        struct BreakResult
+        {
+            size_t i{};
+            bool split{}, failed{};
+            Approximation app1, app2, app3;
+            size_t m1{}, m2{};
+        };
+
+        //! Checks the break point between lines \p i - 1 and \p i and prepares their split if it is not continuous.
+        void processBreak(Span<const VectorType> pts, const SumArray &sum_array, const std::vector<Approximation> &lines, const std::vector<IndexType> &indices,
+                          BreakResult &res) const
+        {
+            size_t i = res.i;
+            VectorType crossing;
+            res.split = res.failed = false;
+            if (Approximation::getCrossing(lines[i - 1], lines[i], crossing) &&
+                !(VectorType::distanceSquared(crossing, (pts[indices[i - 1].second - 1] + pts[indices[i - 1].second]) / 2) > delta2))
+                return;
+
+            if (indices[i].second - indices[i - 1].first < 6)
+            {
+                res.failed = true;
+                return;
+            }
+            res.split = true;
+            res.m1 = (2 * indices[i - 1].first + indices[i].second) / 3;
+            res.m2 = (indices[i - 1].first + 2 * indices[i].second) / 3;
+            res.app1(sum_array.sums(indices[i - 1].first, res.m1));
+            res.app2(sum_array.sums(res.m1, res.m2));
+            res.app3(sum_array.sums(res.m2, indices[i].second));
+        }
+
+        //! Sequential walk over the break points, a split pair is followed by the check of the newly created break points.
+        bool walk(Span<const VectorType> pts, const SumArray &sum_array, std::vector<Approximation> &lines, std::vector<IndexType> &indices, size_t first_line)
+        {
+            BreakResult &res = results.empty() ? results.emplace_back() : results.front();
+            res.i = std::max<size_t>(first_line, 1);
+            while (res.i < lines.size())
             {
-                size_t i = 1;
-                while (i < lines.size())
+                processBreak(pts, sum_array, lines, indices, res);
+                if (res.failed)
+                    return false;
+                if (!res.split)
                 {
-                    if (!Approximation::getCrossing(lines[i - 1], lines[i], v_tmp) ||
-                        VectorType::distanceSquared(v_tmp, (pts[indices[i - 1].second - 1] + pts[indices[i - 1].second]) / 2) > delta2)
+                    res.i++;
+                    continue;
+                }
+
+                size_t i = res.i;
+                lines[i - 1] = res.app1;
+                indices[i - 1] = IndexType(indices[i - 1].first, res.m1);
+                lines[i] = res.app3;
+                indices[i] = IndexType(res.m2, indices[i].second);
+                lines.insert(lines.begin() + i, res.app2);
+                indices.insert(indices.begin() + i, IndexType(res.m1, res.m2));
+            }
+            return true;
+        }
+
+        //! Red-black sweep over the break points, repeated until no break point is left to be checked.
+        bool sweep(Span<const VectorType> pts, const SumArray &sum_array, std::vector<Approximation> &lines, std::vector<IndexType> &indices, size_t first_line)
+        {
+            // pending[i] marks the break point between lines i - 1 and i
+            pending.assign(lines.size(), 0);
+            std::fill(pending.begin() + std::min(std::max<size_t>(first_line, 1), lines.size()), pending.end(), 1);
+
+            bool any = true;
+            while (any)
+            {
+                any = false;
+                for (size_t parity = 1; parity < 3; parity++)
+                {
+                    // break points of the same parity touch disjoint pairs of lines
+                    results.clear();
+                    for (size_t i = 2 - parity % 2; i < lines.size(); i += 2)
+                        if (pending[i])
+                            results.emplace_back().i = i;
+                    if (results.empty())
+                        continue;
+
+                    executor(0, results.size(), [&](size_t begin, size_t end) {
+                        for (size_t r = begin; r < end; r++)
+                            processBreak(pts, sum_array, lines, indices, results[r]);
+                    });
+
+                    bool split = false;
+                    for (const auto &res : results)
                     {
-                        if (indices[i].second - indices[i - 1].first < 6)
+                        if (res.failed)
                             return false;
-                        else
-                        {
-                            m1 = (2 * indices[i - 1].first + indices[i].second) / 3;
-                            m2 = (indices[i - 1].first + 2 * indices[i].second) / 3;
-
-                            app1(sum_array.sums(indices[i - 1].first, m1));
-                            app2(sum_array.sums(m1, m2));
-                            app3(sum_array.sums(m2, indices[i].second));
-
-                            lines[i - 1] = app1;
-                            indices[i - 1] = std::make_pair(indices[i - 1].first, m1);
-                            lines[i] = app3;
-                            indices[i] = std::make_pair(m2, indices[i].second);
-
-                            lines.insert(lines.begin() + i, app2);
-                            indices.insert(indices.begin() + i, IndexType(m1, m2));
-                            continue;
-                        }
+                        pending[res.i] = 0;
+                        split |= res.split;
+                    }
+                    if (split)
+                    {
+                        applySplits(lines, indices);
+                        any = true;
                     }
-                    i++;
                 }
             }
             return true;
         }
 
-    private:
+        //! Replaces the split pairs of lines by their three successors and marks the affected break points pending.
+        void applySplits(std::vector<Approximation> &lines, std::vector<IndexType> &indices)
+        {
+            new_lines.clear();
+            new_indices.clear();
+            new_pending.clear();
+            size_t next = 0;
+            for (const auto &res : results)
+            {
+                if (!res.split)
+                    continue;
+                size_t i = res.i;
+                for (; next < i - 1; next++)
+                {
+                    new_lines.push_back(lines[next]);
+                    new_indices.push_back(indices[next]);
+                    new_pending.push_back(pending[next]);
+                }
+                new_lines.push_back(res.app1);
+                new_lines.push_back(res.app2);
+                new_lines.push_back(res.app3);
+                new_indices.emplace_back(indices[i - 1].first, res.m1);
+                new_indices.emplace_back(res.m1, res.m2);
+                new_indices.emplace_back(res.m2, indices[i].second);
+                new_pending.push_back(i > 1 ? 1 : 0);
+                new_pending.push_back(1);
+                new_pending.push_back(1);
+                next = i + 1;
+                if (next < lines.size())
+                    pending[next] = 1;
+            }
+            for (; next < lines.size(); next++)
+            {
+                new_lines.push_back(lines[next]);
+                new_indices.push_back(indices[next]);
+                new_pending.push_back(pending[next]);
+            }
+            lines.swap(new_lines);
+            indices.swap(new_indices);
+            pending.swap(new_pending);
+        }
+
+        Executor executor;
         ElementType delta2;
-        VectorType v_tmp;
-        size_t m1{}, m2{};
-        Approximation app1, app2, app3;
+        std::vector<BreakResult> results;
+        std::vector<Approximation> new_lines;
+        std::vector<IndexType> new_indices;
+        std::vector<unsigned char> pending, new_pending;
     };
 }
 
@@ -28,8 +28,12 @@
 #define ROBOTICTEMPLATELIBRARY_VECT_OPTIMIZERTOTALERROR_H
 
 #include <vector>
-#include <map>
-#include <set>
+#include <algorithm>
+#include <experimental/type_traits>
+
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/Span.h"
+#include "rtl/vect/VectorizationStats.h"
 
 namespace rtl
 {
@@ -38,6 +42,10 @@ namespace rtl
      * The optimization starts with regular vectorization output and manipulates ranges of the approximations to minimize overall error.
      * Principle of the optimization is the Nelder-Mead method modified to work in discrete space of integral indices and with constraints
      * arising from limited number of input points and strict condition on "touching" intervals of approximation.
+     *
+     * Buffers of the simplex are kept between calls and only grow to the size required by the largest problem so far, so repeated optimization (e.g. once per scan)
+     * does not allocate memory. If the \p Approximation provides static getTotalErrorSquared() (see ApproximationTlsLine2D), the total error of each simplex vertex is
+     * evaluated by this single vectorized call instead of fitting the ranges one by one.
      * @tparam SumArray type of precomputed sums.
      * @tparam Approximation type approximation used.
      */
@@ -78,19 +86,32 @@ namespace rtl
          * @param sum_array precomputed sums.
          * @param approximations approximations to be optimized.
          * @param indices range indices of the approximations to be optimized.
+         * @param stats optional statistics, the number of iterations is added to it.
          * @return true on success, false otherwise.
          */
-        bool operator()(const std::vector<VectorType> &, const SumArray &sum_array, std::vector<Approximation> &approximations, std::vector<IndexType> &indices)
+        bool operator()(Span<const VectorType>, const SumArray &sum_array, std::vector<Approximation> &approximations, std::vector<IndexType> &indices,
+                        VectorizationStats *stats = nullptr)
         {
+            RTL_ZONE("rtl::OptimizerTotalError");
             size_t bp_cnt = approximations.size();
             if (bp_cnt < 2)
                 return true;
 
             bp_cnt--;
 
-            std::multimap<ElementType, size_t*> opt_vec_order;
+            // vertices of the simplex ordered by their error, equal errors keep the order of insertion
+            auto &opt_vec_order = vertex_order;
+            opt_vec_order.clear();
+            auto orderInsert = [&opt_vec_order](ElementType err, size_t *bp)
+            {
+                auto pos = std::upper_bound(opt_vec_order.begin(), opt_vec_order.end(), err, [](ElementType e, const VertexType &v) { return e < v.first; });
+                opt_vec_order.emplace(pos, err, bp);
+            };
+
             size_t opt_vec_size = bp_cnt * (bp_cnt + 1 + 3);
-            auto bp_array = new size_t[opt_vec_size];
+            if (bp_buffer.size() < opt_vec_size)
+                bp_buffer.resize(opt_vec_size);
+            size_t *bp_array = bp_buffer.data();
             size_t *bp_tmp = bp_array + bp_cnt * (bp_cnt + 1);
             size_t *bp_sums = bp_array + bp_cnt * (bp_cnt + 2);
             size_t *bp_mean = bp_array + bp_cnt * (bp_cnt + 3);
@@ -100,6 +121,8 @@ namespace rtl
 
             auto totalError = [&sum_array, bp_cnt, bp_last_i](size_t *bp)
             {
+                if constexpr (std::experimental::is_detected_v<TotalError, Approximation, SumArray>)
+                    return Approximation::getTotalErrorSquared(sum_array, 0, Span<const size_t>(bp, bp_cnt), bp_last_i);
                 ElementType sigma2 = 0;
                 size_t sum_beg = 0;
                 for (size_t i = 0; i < bp_cnt; i++)
@@ -178,14 +201,15 @@ namespace rtl
 
             // vector order list generation
             for (size_t *pi = bp_array; pi < bp_tmp; pi += bp_cnt)
-                opt_vec_order.emplace(totalError(pi), pi);
+                orderInsert(totalError(pi), pi);
 
             if(!wholeSimplexValidation())
                 return true;
 
             //int iteration_counter = 0;
             // the Nelder-Mead minimization
-            for (size_t iter_cnt = 0; iter_cnt < max_iter; iter_cnt++)
+            size_t iter_cnt = 0;
+            for (; iter_cnt < max_iter; iter_cnt++)
             {
                 //iteration_counter++;
                 /*std::cout<<std::endl;
@@ -197,7 +221,7 @@ namespace rtl
                     std::cout<<std::endl;
                 }
                 std::cout<<std::endl;*/
-                discard = opt_vec_order.rbegin()->second;
+                discard = opt_vec_order.back().second;
                 for (i = bp_cnt - 1; i < bp_cnt; i--)
                 {
                     bp_sums[i] -= discard[i]; // remove the discarded vector from the sum m
@@ -210,7 +234,7 @@ namespace rtl
                 }
                 forwardHomogenize(bp_tmp);
                 opt_err_tmp1 = totalError(bp_tmp);
-                if (opt_err_tmp1 < opt_vec_order.begin()->first)
+                if (opt_err_tmp1 < opt_vec_order.front().first)
                 {
                     for (i = bp_cnt - 1; i < bp_cnt; i--)
                     {
@@ -224,29 +248,29 @@ namespace rtl
                     opt_err_tmp2 = totalError(discard);
                     if (opt_err_tmp2 < opt_err_tmp1)
                     {
-                        opt_vec_order.erase(--opt_vec_order.end());
+                        opt_vec_order.pop_back();
                         if(!newVertexValidation(discard))
                             break;
-                        opt_vec_order.emplace(opt_err_tmp2, discard); // simplex EXPANDed
+                        orderInsert(opt_err_tmp2, discard); // simplex EXPANDed
                         for (i = 0; i < bp_cnt; i++)
                             bp_sums[i] += discard[i];
                         //std::cout<<"simplex EXPANDed"<<std::endl;
                         continue;
                     }
                 }
-                if (opt_err_tmp1 < (++opt_vec_order.rbegin())->first)
+                if (opt_err_tmp1 < opt_vec_order[opt_vec_order.size() - 2].first)
                 {
-                    opt_vec_order.erase(--opt_vec_order.end());
+                    opt_vec_order.pop_back();
                     if(!newVertexValidation(bp_tmp))
                         break;
-                    opt_vec_order.emplace(opt_err_tmp1, bp_tmp); // simplex RFLECTed
+                    orderInsert(opt_err_tmp1, bp_tmp); // simplex RFLECTed
                     for (i = 0; i < bp_cnt; i++)
                         bp_sums[i] += bp_tmp[i];
                     bp_tmp = discard;
                     //std::cout<<"simplex RFLECTed"<<std::endl;
                     continue;
                 }
-                if (opt_err_tmp1 < opt_vec_order.rbegin()->first)
+                if (opt_err_tmp1 < opt_vec_order.back().first)
                 {
                     for (i = bp_cnt - 1; i < bp_cnt; i--)
                     {
@@ -260,10 +284,10 @@ namespace rtl
                     opt_err_tmp2 = totalError(bp_tmp);
                     if (opt_err_tmp2 < opt_err_tmp1)
                     {
-                        opt_vec_order.erase(--opt_vec_order.end());
+                        opt_vec_order.pop_back();
                         if(!newVertexValidation(bp_tmp))
                             break;
-                        opt_vec_order.emplace(opt_err_tmp2, bp_tmp); // simplex CONTRACTed OUTSIDE
+                        orderInsert(opt_err_tmp2, bp_tmp); // simplex CONTRACTed OUTSIDE
                         for (i = 0; i < bp_cnt; i++)
                             bp_sums[i] += bp_tmp[i];
                         bp_tmp = discard;
@@ -283,12 +307,12 @@ namespace rtl
                     }
                     forwardHomogenize(bp_tmp);
                     opt_err_tmp2 = totalError(bp_tmp);
-                    if (opt_err_tmp2 < opt_vec_order.rbegin()->first)
+                    if (opt_err_tmp2 < opt_vec_order.back().first)
                     {
-                        opt_vec_order.erase(--opt_vec_order.end());
+                        opt_vec_order.pop_back();
                         if(!newVertexValidation(bp_tmp))
                             break;
-                        opt_vec_order.emplace(opt_err_tmp2, bp_tmp); // simplex CONTRACTed INSIDE
+                        orderInsert(opt_err_tmp2, bp_tmp); // simplex CONTRACTed INSIDE
                         for (i = 0; i < bp_cnt; i++)
                             bp_sums[i] += bp_tmp[i];
                         bp_tmp = discard;
@@ -299,8 +323,8 @@ namespace rtl
                 // simplex SHRINKed
                 //std::cout<<"simplex SHRINKed"<<std::endl;
                 // recompute all but the first vector
-                opt_err_tmp1 = opt_vec_order.begin()->first;
-                bp_first = opt_vec_order.begin()->second;
+                opt_err_tmp1 = opt_vec_order.front().first;
+                bp_first = opt_vec_order.front().second;
                 for (i = 0; i < bp_cnt; i++)
                     bp_sums[i] = bp_first[i];
                 for (auto it = ++opt_vec_order.begin(); it != opt_vec_order.end(); it++)
@@ -320,20 +344,23 @@ namespace rtl
                 }
                 // clear and repopulate the map with new simplices
                 opt_vec_order.clear();
-                opt_vec_order.emplace(opt_err_tmp1, bp_first);
+                orderInsert(opt_err_tmp1, bp_first);
                 for (size_t *pi = bp_array; pi < bp_sums; pi += bp_cnt)
                 {
                     if (pi != bp_first && pi != bp_tmp)
                     {
-                        opt_vec_order.emplace(totalError(pi), pi);
+                        orderInsert(totalError(pi), pi);
                     }
                 }
                 if (!wholeSimplexValidation())
                     break;
             }
 
+            if (stats != nullptr)
+                stats->optimizer_iterations += iter_cnt;
+
             size_t sum_beg = 0;
-            bp_first = opt_vec_order.begin()->second;
+            bp_first = opt_vec_order.front().second;
             for (i = 0; i < bp_cnt; i++)
             {
                 approximations[i](sum_array.sums(sum_beg, bp_first[i]));
@@ -348,7 +375,14 @@ namespace rtl
         }
 
     private:
+        typedef std::pair<ElementType, size_t*> VertexType;
+
+        template<class Appr, class Sums>
+        using TotalError = decltype(Appr::getTotalErrorSquared(std::declval<const Sums&>(), size_t(), Span<const size_t>(), size_t()));
+
         size_t shift{1}, max_iter{10000};
+        std::vector<size_t> bp_buffer;
+        std::vector<VertexType> vertex_order;
     };
 }
 
@@ -0,0 +1,157 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_VECT_POSTPROCESSORGRIDOUTLINE_H
+#define ROBOTICTEMPLATELIBRARY_VECT_POSTPROCESSORGRIDOUTLINE_H
+
+#include <vector>
+#include <limits>
+
+#include "rtl/core/Instrumentation.h"
+
+namespace rtl
+{
+    //! Constrains planar approximations of regions in an organized point cloud by their outlines.
+    /*!
+     * The outer boundary of each region is traced in its label image by the Moore neighbour tracing, the boundary points are then projected onto the approximation
+     * forming vertices of the output polygon. Only the first connected component of a region in the row-major order is traced and holes are ignored.
+     * @tparam Approximation type of the planar approximation.
+     */
+    template<class Approximation>
+    class PostprocessorGridOutline
+    {
+    public:
+        typedef typename Approximation::ElementType ElementType;        //!< Base type of stored elements.
+        typedef typename Approximation::VectorType VectorType;          //!< VectorND specialization corresponding to given \p Approximation.
+        typedef typename Approximation::ConstrainedType OutputType;     //!< Type of constrained planar approximation.
+
+        static constexpr size_t unassigned = std::numeric_limits<size_t>::max();   //!< Label of cells not belonging to any region.
+
+        //! Default constructor.
+        PostprocessorGridOutline() = default;
+
+        //! Default destructor.
+        ~PostprocessorGridOutline() = default;
+
+        //! Read-only access to extracted constrained primitives.
+        /*!
+         *
+         * @return constrained approximations.
+         */
+        const std::vector<OutputType>& output() const { return int_output; }
+
+        //! Functor call for constrained primitives extraction.
+        /*!
+         *
+         * @param pts row-major grid of points with \p rows * \p cols elements.
+         * @param rows number of rows of the grid.
+         * @param cols number of columns of the grid.
+         * @param approximations approximations being trimmed.
+         * @param labels region index of each cell of the grid, unassigned for cells outside all regions.
+         * @return true on success, false otherwise.
+         */
+        bool operator()(Span<const VectorType> pts, size_t rows, size_t cols, const std::vector<Approximation> &approximations, const std::vector<size_t> &labels)
+        {
+            RTL_ZONE("rtl::PostprocessorGridOutline");
+            if (labels.size() != rows * cols || pts.size() < rows * cols)
+                return false;
+            int_output.clear();
+            int_output.reserve(approximations.size());
+            starts.assign(approximations.size(), unassigned);
+            cell_nr.assign(approximations.size(), 0);
+            for (size_t i = 0; i < labels.size(); i++)
+                if (labels[i] != unassigned)
+                {
+                    if (starts[labels[i]] == unassigned)
+                        starts[labels[i]] = i;
+                    cell_nr[labels[i]]++;
+                }
+
+            for (size_t l = 0; l < approximations.size(); l++)
+            {
+                traceOutline(pts, rows, cols, labels, l);
+                int_output.emplace_back(approximations[l].trim(Span<const VectorType>(outline)));
+            }
+            return true;
+        }
+
+    private:
+        //! Moore neighbour tracing of the outer boundary with Jacob's stopping criterion.
+        void traceOutline(Span<const VectorType> pts, size_t rows, size_t cols, const std::vector<size_t> &labels, size_t label)
+        {
+            // Neighbours in clockwise order starting to the east, rows grow downwards.
+            static constexpr int dr[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+            static constexpr int dc[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+            static constexpr int dir_index[9] = {5, 6, 7, 4, -1, 0, 3, 2, 1};
+
+            outline.clear();
+            if (starts[label] == unassigned)
+                return;
+            size_t start = starts[label], cur = start, first_next = unassigned;
+            int back = 4; // the west neighbour of the first cell in row-major order is outside the region
+            for (size_t step = 0; step < 4 * cell_nr[label] + 4; step++)
+            {
+                long r = static_cast<long>(cur / cols), c = static_cast<long>(cur % cols);
+                size_t next = unassigned;
+                int k = 1;
+                for (; k <= 8; k++)
+                {
+                    int d = (back + k) % 8;
+                    long nr = r + dr[d], nc = c + dc[d];
+                    if (nr >= 0 && nc >= 0 && nr < static_cast<long>(rows) && nc < static_cast<long>(cols) && labels[nr * cols + nc] == label)
+                    {
+                        next = nr * cols + nc;
+                        break;
+                    }
+                }
+                if (next == unassigned)
+                {
+                    outline.push_back(pts[cur]);
+                    break;
+                }
+                if (cur == start)
+                {
+                    if (first_next == unassigned)
+                        first_next = next;
+                    else if (next == first_next)
+                        break;
+                }
+                outline.push_back(pts[cur]);
+
+                int prev = (back + k - 1) % 8;
+                long br = r + dr[prev] - static_cast<long>(next / cols), bc = c + dc[prev] - static_cast<long>(next % cols);
+                back = dir_index[(br + 1) * 3 + bc + 1];
+                cur = next;
+            }
+        }
+
+        std::vector<OutputType> int_output;
+        std::vector<VectorType> outline;
+        std::vector<size_t> starts, cell_nr;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_VECT_POSTPROCESSORGRIDOUTLINE_H
@@ -27,6 +27,8 @@
 #ifndef ROBOTICTEMPLATELIBRARY_VECT_POSTPROCESSORPOLYLINE2D_H
 #define ROBOTICTEMPLATELIBRARY_VECT_POSTPROCESSORPOLYLINE2D_H
 
+#include "rtl/core/Instrumentation.h"
+
 namespace rtl
 {
     //! Generates polyline output from linear approximation in 2D.
@@ -51,21 +53,19 @@ namespace rtl
         //! Default destructor.
         ~PostprocessorPolyline2D() = default;
 
-        //! Generates and returns line segments forming the polyline.
+        //! Returns line segments forming the polyline.
+        /*!
+         * The segments are generated once by the functor call and kept in a buffer reused by the following calls.
+         * @return line segments of the polyline, empty if the last functor call failed.
+         */
+        const std::vector<LineSegmentType>& lineSegments() const { return int_segments; }
+
+        //! Returns vertices of the polyline.
         /*!
          *
-         * @return line segments of the polyline.
+         * @return vertices of the polyline, one more than the number of line segments.
          */
-        std::vector<LineSegmentType> lineSegments() const
-        {
-            std::vector<LineSegmentType> output;
-            if (int_polyline.size() < 2)
-                return output;
-            output.reserve(int_polyline.size() - 1);
-            for (size_t i = 1; i < int_polyline.size(); i++)
-                output.emplace_back(int_polyline[i - 1], int_polyline[i]);
-            return output;
-        }
+        const std::vector<VectorType>& polyline() const { return int_polyline; }
 
         //! Functor call for polyline extraction.
         /*!
@@ -75,8 +75,10 @@ namespace rtl
          * @param indices range indices of the approximations.
          * @return true on success, false otherwise.
          */
-        bool operator()(const std::vector<VectorType> &pts, const std::vector<Approximation> &lines, const std::vector<IndexType> &indices)
+        bool operator()(Span<const VectorType> pts, const std::vector<Approximation> &lines, const std::vector<IndexType> &indices)
         {
+            RTL_ZONE("rtl::PostprocessorPolyline2D");
+            int_segments.clear();
             if (lines.size() != indices.size() || lines.size() == 0)
                 return false;
             int_polyline.clear();
@@ -88,11 +90,15 @@ namespace rtl
                 int_polyline.push_back(vec_tmp);
             }
             int_polyline.emplace_back(lines.back().project(pts.back()));
+
+            for (size_t i = 1; i < int_polyline.size(); i++)
+                int_segments.emplace_back(int_polyline[i - 1], int_polyline[i]);
             return true;
         }
 
     private:
         std::vector<VectorType> int_polyline;
+        std::vector<LineSegmentType> int_segments;
         VectorType vec_tmp;
     };
 }
@@ -27,6 +27,8 @@
 #ifndef ROBOTICTEMPLATELIBRARY_VECT_POSTPROCESSORPROJECTENDPOINTS_H
 #define ROBOTICTEMPLATELIBRARY_VECT_POSTPROCESSORPROJECTENDPOINTS_H
 
+#include "rtl/core/Instrumentation.h"
+
 namespace rtl
 {
     //! Trims approximations with their end points to produce constrained output primitives.
@@ -66,8 +68,9 @@ namespace rtl
          * @param indices range indices of the approximations.
          * @return true on success, false otherwise.
          */
-        bool operator()(const std::vector<VectorType> &pts, const std::vector<Approximation> &approximations, const std::vector<IndexType> &indices)
+        bool operator()(Span<const VectorType> pts, const std::vector<Approximation> &approximations, const std::vector<IndexType> &indices)
         {
+            RTL_ZONE("rtl::PostprocessorProjectEndpoints");
             if (approximations.size() != indices.size() || approximations.size() == 0)
                 return false;
             int_output.clear();
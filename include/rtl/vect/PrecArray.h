@@ -27,8 +27,14 @@
 #ifndef ROBOTICTEMPLATELIBRARY_VECT_PRECARRAY_H
 #define ROBOTICTEMPLATELIBRARY_VECT_PRECARRAY_H
 
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
 #include <eigen3/Eigen/Dense>
 
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/Span.h"
 #include "rtl/vect/PrecSums.h"
 
 namespace rtl
@@ -38,6 +44,15 @@ namespace rtl
      * Common operations for all precomputed arrays are implemented here. Adds the first row of zeros to the array
      * making the array one row longer than the number of points used to its precomputation. This feature makes computation
      * of precomputed sums as simple as subtraction of two rows of the array in all cases.
+     *
+     * The array is stored row-major, so both the precomputation and the extraction of sums() access one contiguous row per point. Derived arrays fill the rows by a single
+     * streaming pass of prefixSums(), which reads every point once and writes its products together with the running sums. Optionally, the running sums are accumulated
+     * with Kahan compensation to reduce the rounding error of long point clouds, see setCompensatedSummation().
+     *
+     * For single precision ComputeType, the array can be split into centered blocks by setCenteredBlocks(). The rows of each block then hold prefix sums of coordinates
+     * relative to the first point of the block, which keeps their magnitude small. Sums of the whole blocks are stored as checkpoints in at least double precision. The sums
+     * of a range are combined from the partial blocks and the checkpoints in the wider type and returned relative to the reference point of the range's first block, so the
+     * subsequent computation of central moments does not suffer from cancellation either.
      * @tparam Compute type for precise computations.
      * @tparam SumType precomputed sum type.
      */
@@ -45,7 +60,11 @@ namespace rtl
     struct PrecArayBase
     {
         typedef Compute ComputeType;        //!< Type for precise computations.
-        typedef Eigen::Array<ComputeType, Eigen::Dynamic, SumType::sumNr()> EigenType; //!< Underlying Eigen type.
+        typedef Eigen::Array<ComputeType, Eigen::Dynamic, SumType::sumNr(), Eigen::RowMajor> EigenType;    //!< Underlying Eigen type.
+        typedef Eigen::Array<ComputeType, 1, SumType::sumNr()> RowType;                                     //!< One row of the array.
+        typedef std::conditional_t<(sizeof(ComputeType) < sizeof(double)), double, ComputeType> WideType;  //!< Type of the block checkpoints.
+        typedef Eigen::Array<WideType, 1, SumType::sumNr() + 1> WideRowType;                               //!< Block checkpoint including number of points.
+        typedef typename SumType::VectorType ReferenceType;                                                 //!< Type of the reference points of blocks.
 
         //! Default constructor.
         PrecArayBase() = default;
@@ -76,6 +95,45 @@ namespace rtl
             array_size = pts_cnt;
         }
 
+        //! Change size of the array while preserving already precomputed rows.
+        /*!
+         * Unlike resize(), the content of the array is kept intact. The underlying storage grows geometrically, so repeated extension by small amounts of points
+         * does not reallocate the array every time. size() then returns \p pts_cnt + 1.
+         * @param pts_cnt number of points.
+         */
+        void extend(size_t pts_cnt)
+        {
+            pts_cnt += 1; // for initial row of zeros
+            if (static_cast<size_t>(array.rows()) < pts_cnt)
+                array.conservativeResize(std::max(pts_cnt, 2 * static_cast<size_t>(array.rows())), Eigen::NoChange);
+            array_size = pts_cnt;
+        }
+
+        //! Removes all precomputed points, leaving only the initial row of zeros.
+        void clear() { resize(0); }
+
+        //! Enables or disables Kahan compensated summation of the running sums.
+        /*!
+         * Compensation reduces the accumulated rounding error, which grows with the number of points and their distance from origin, at the cost of approx. four times more
+         * floating-point operations per sum. Disabled by default.
+         * @param compensated true to enable compensated summation.
+         */
+        void setCompensatedSummation(bool compensated) { compensated_summation = compensated; }
+
+        //! Returns true if Kahan compensated summation is used.
+        [[nodiscard]] bool compensatedSummation() const { return compensated_summation; }
+
+        //! Sets size of the locally centered blocks, zero disables the blocks (default).
+        /*!
+         * The setting applies to the following precompute() or a stream started by clear(). Blocks of a few hundred points make single precision ComputeType as precise as
+         * double precision without blocks, since neither the running sums nor their differences grow with the size of the whole point cloud.
+         * @param block_size number of points in a block.
+         */
+        void setCenteredBlocks(size_t block_size) { centered_blocks = block_size; }
+
+        //! Returns size of the locally centered blocks, zero if the blocks are disabled.
+        [[nodiscard]] size_t centeredBlocks() const { return centered_blocks; }
+
         //! Returns precomputed sums from given row of the array.
         /*!
          *
@@ -84,6 +142,8 @@ namespace rtl
          */
         SumType sums(size_t index) const
         {
+            if (centered_blocks > 0)
+                return sums(0, index);
             SumType ret;
             ret.sums.block(0, 0, 1, SumType::sumNr()) = array.row(index);
             ret.sums(0, SumType::sumNr()) = index;
@@ -100,18 +160,166 @@ namespace rtl
         SumType sums(size_t beg, size_t end) const
         {
             SumType ret;
-            ret.sums.block(0, 0, 1, SumType::sumNr()) = array.row(end) - array.row(beg);
-            ret.sums(0, SumType::sumNr()) = end - beg;
+            size_t kb = centered_blocks > 0 ? beg / centered_blocks : 0, ke = centered_blocks > 0 ? end / centered_blocks : 0;
+            if (kb == ke)
+            {
+                ret.sums.block(0, 0, 1, SumType::sumNr()) = array.row(end) - array.row(beg);
+                ret.sums(0, SumType::sumNr()) = end - beg;
+                if (centered_blocks > 0 && kb < block_refs.size())
+                    ret.reference = block_refs[kb];
+                return ret;
+            }
+
+            // the rest of the first block, whole blocks in between and the beginning of the last block, all relative to the first block's reference
+            constexpr size_t n = SumType::sumNr(), dim = ReferenceType::dimensionality();
+            WideType offset[dim];
+            WideRowType wide, part;
+            wide.head(n) = (block_sums[kb] - array.row(beg)).template cast<WideType>();
+            wide[n] = static_cast<WideType>((kb + 1) * centered_blocks - beg);
+            if (ke > kb + 1)
+            {
+                part = block_prefix[ke] - block_prefix[kb + 1];
+                for (size_t j = 0; j < dim; j++)
+                    offset[j] = -static_cast<WideType>(block_refs[kb][j]);
+                SumType::shiftSums(part, offset);
+                wide += part;
+            }
+            if (end % centered_blocks != 0)
+            {
+                part.head(n) = array.row(end).template cast<WideType>();
+                part[n] = static_cast<WideType>(end % centered_blocks);
+                for (size_t j = 0; j < dim; j++)
+                    offset[j] = static_cast<WideType>(block_refs[ke][j]) - static_cast<WideType>(block_refs[kb][j]);
+                SumType::shiftSums(part, offset);
+                wide += part;
+            }
+            ret.sums = wide.template cast<ComputeType>();
+            ret.reference = block_refs[kb];
             return ret;
         }
 
         EigenType array;
         size_t array_size{};
+        bool compensated_summation{false};
+        RowType compensation{RowType::Zero()};
+        size_t centered_blocks{};
+        std::vector<ReferenceType> block_refs;
+        std::vector<RowType> block_sums;
+        std::vector<WideRowType, Eigen::aligned_allocator<WideRowType>> block_prefix;
+
+    protected:
+        //! Fused computation of sums and their prefix for points \p pts starting at row \p beg.
+        /*!
+         * The row \p beg - 1 must already hold valid running sums. For each point, the sums given by SumType::pointSums() are added to the running sums and written directly
+         * to the array. Compensation of the rounding error and the centered blocks are carried between calls, so appended chunks stay compensated and centered as well.
+         * @tparam Point type of the points.
+         * @param beg first row to be computed.
+         * @param pts points to be processed.
+         */
+        template<class Point>
+        void prefixSums(size_t beg, Span<const Point> pts)
+        {
+            if (beg == 1)
+            {
+                compensation.setZero();
+                block_refs.clear();
+                block_sums.clear();
+                block_prefix.assign(1, WideRowType::Zero());
+            }
+            if (compensated_summation)
+                prefixSumsImpl<true>(beg, pts);
+            else
+                prefixSumsImpl<false>(beg, pts);
+        }
+
+    private:
+        // Rows of the row-major array are contiguous and the running sums are kept in local arrays of a fixed size. The per-sum operations are expanded at compile
+        // time, so the accumulators stay in registers regardless of the optimizer's loop unrolling heuristics. With centered blocks, the pass is split at block
+        // boundaries, where the running sums are moved to the checkpoints and restarted from zero.
+        template<bool compensated, class Point>
+        void prefixSumsImpl(size_t beg, Span<const Point> pts)
+        {
+            constexpr size_t n = SumType::sumNr();
+            ComputeType acc[n], comp[n];
+            for (size_t k = 0; k < n; k++)
+            {
+                acc[k] = array(beg - 1, k);
+                comp[k] = compensation(k);
+            }
+            ReferenceType ref = centered_blocks > 0 && !block_refs.empty() ? block_refs.back() : ReferenceType::zeros();
+            ComputeType *row = array.data() + beg * n;
+            for (size_t i = 0; i < pts.size();)
+            {
+                size_t seg_end = pts.size();
+                if (centered_blocks > 0)
+                {
+                    size_t pos = (beg - 1 + i) % centered_blocks;
+                    if (pos == 0)
+                    {
+                        ref = pts[i].template cast<ComputeType>();
+                        block_refs.push_back(ref);
+                        std::fill(acc, acc + n, 0);
+                        std::fill(comp, comp + n, 0);
+                    }
+                    seg_end = std::min(pts.size(), i + centered_blocks - pos);
+                }
+
+                accumulate<compensated>(pts.data() + i, seg_end - i, ref, row, acc, comp);
+                row += (seg_end - i) * n;
+                i = seg_end;
+
+                if (centered_blocks > 0 && (beg - 1 + i) % centered_blocks == 0)
+                {
+                    block_sums.emplace_back(Eigen::Map<const RowType>(acc));
+                    WideRowType checkpoint;
+                    checkpoint.head(n) = block_sums.back().template cast<WideType>();
+                    checkpoint[n] = static_cast<WideType>(centered_blocks);
+                    WideType offset[ReferenceType::dimensionality()];
+                    for (size_t j = 0; j < ReferenceType::dimensionality(); j++)
+                        offset[j] = static_cast<WideType>(ref[j]);
+                    SumType::shiftSums(checkpoint, offset);
+                    block_prefix.push_back(block_prefix.back() + checkpoint);
+                    std::fill(row - n, row, 0);
+                }
+            }
+            for (size_t k = 0; k < n; k++)
+                compensation(k) = comp[k];
+        }
+
+        // The running sums are copied to local arrays, which do not escape, so the compiler keeps them in registers.
+        template<bool compensated, class Point>
+        static void accumulate(const Point *pts, size_t cnt, const ReferenceType &ref, ComputeType *row, ComputeType *acc_io, ComputeType *comp_io)
+        {
+            constexpr size_t n = SumType::sumNr();
+            ComputeType acc[n], comp[n], term[n];
+            std::copy(acc_io, acc_io + n, acc);
+            std::copy(comp_io, comp_io + n, comp);
+            for (size_t i = 0; i < cnt; i++, row += n)
+            {
+                SumType::pointSums(pts[i], ref, term);
+                forEachSum([&](size_t k) {
+                    if constexpr (compensated)
+                    {
+                        ComputeType corrected = term[k] - comp[k], next = acc[k] + corrected;
+                        comp[k] = (next - acc[k]) - corrected;
+                        acc[k] = next;
+                    }
+                    else
+                        acc[k] += term[k];
+                    row[k] = acc[k];
+                }, std::make_index_sequence<n>());
+            }
+            std::copy(acc, acc + n, acc_io);
+            std::copy(comp, comp + n, comp_io);
+        }
+
+        template<class Func, size_t... k>
+        static void forEachSum(Func &&func, std::index_sequence<k...>) { (func(k), ...); }
     };
 
     //! Precomputed array for 2D total least squares fitting of lines.
     /*!
-     *
+     * Points may be stored in a compact type (see rtl/core/CompactElement.h), each of them is widened to Compute as it is read by the precomputation.
      * @tparam Element type for data element storage.
      * @tparam Compute type for precise computation.
      */
@@ -126,29 +334,36 @@ namespace rtl
 
         //! Precompute sums for given points.
         /*!
-         * Points are organized in std::vector and the function rely on fact that they are stored in correct order in continuous chunk of memory.
+         * Points are given by a span (a whole std::vector converts implicitly) in the correct order. All sums are computed in a single pass over the points.
          * @param vec points for precomputation.
          */
-        void precompute(const std::vector<rtl::Vector2D<ElementType>> &vec)
+        void precompute(Span<const rtl::Vector2D<ElementType>> vec)
+        {
+            RTL_ZONE("rtl::PrecArray::precompute");
+            BaseType::resize(vec.size());
+            BaseType::prefixSums(1, vec);
+        }
+
+        //! Extends the precomputed sums by another chunk of points.
+        /*!
+         * Points of \p chunk are treated as if they followed the points already precomputed, the existing rows of the array are not recomputed. Suitable for streamed data,
+         * where the points are obtained in smaller chunks and the whole cloud is not available at once. Use clear() to start a new stream.
+         * @param chunk points to be appended.
+         */
+        void append(Span<const rtl::Vector2D<ElementType>> chunk)
         {
-            size_t vec_size = vec.size();
-            BaseType::resize(vec_size);
-
-            Eigen::Map<const Eigen::Matrix<ElementType, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> map(&vec[0][0], vec_size, 2);
-            BaseType::array.block(1, SumsType::cx, vec_size, 1) = map.array().col(SumsType::cx).template cast<ComputeType>();
-            BaseType::array.block(1, SumsType::cy, vec_size, 1) = map.array().col(SumsType::cy).template cast<ComputeType>();
-            BaseType::array.block(1, SumsType::cx2, vec_size, 1) = BaseType::array.block(1, SumsType::cx, vec_size, 1) * BaseType::array.block(1, SumsType::cx, vec_size, 1);
-            BaseType::array.block(1, SumsType::cy2, vec_size, 1) = BaseType::array.block(1, SumsType::cy, vec_size, 1) * BaseType::array.block(1, SumsType::cy, vec_size, 1);
-            BaseType::array.block(1, SumsType::cxy, vec_size, 1) = BaseType::array.block(1, SumsType::cx, vec_size, 1) * BaseType::array.block(1, SumsType::cy, vec_size, 1);
-
-            for (size_t i = 1; i < vec_size + 1; i++)
-                BaseType::array.row(i) += BaseType::array.row(i - 1);
+            RTL_ZONE("rtl::PrecArray::append");
+            if (BaseType::array_size == 0)
+                BaseType::clear();
+            size_t beg = BaseType::array_size;
+            BaseType::extend(beg - 1 + chunk.size());
+            BaseType::prefixSums(beg, chunk);
         }
     };
 
     //! Precomputed array for 3D total least squares fitting of lines and planes.
     /*!
-     *
+     * Points may be stored in a compact type (see rtl/core/CompactElement.h), each of them is widened to Compute as it is read by the precomputation.
      * @tparam Element type for data element storage.
      * @tparam Compute type for precise computation.
      */
@@ -163,29 +378,31 @@ namespace rtl
 
         //! Precompute sums for given points.
         /*!
-         * Points are organized in std::vector and the function rely on fact that they are stored in correct order in continuous chunk of memory.
+         * Points are given by a span (a whole std::vector converts implicitly) in the correct order. All sums are computed in a single pass over the points.
          * @param vec points for precomputation.
          */
-        void precompute(const std::vector<rtl::Vector3D<ElementType>> &vec)
+        void precompute(Span<const rtl::Vector3D<ElementType>> vec)
         {
-            size_t vec_size = vec.size();
-            BaseType::resize(vec_size);
-
-            Eigen::Map<const Eigen::Matrix<ElementType, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> map(&vec[0][0], vec_size, 3);
-            BaseType::array.block(1, SumsType::cx, vec_size, 1) = map.array().col(SumsType::cx).template cast<ComputeType>();
-            BaseType::array.block(1, SumsType::cy, vec_size, 1) = map.array().col(SumsType::cy).template cast<ComputeType>();
-            BaseType::array.block(1, SumsType::cz, vec_size, 1) = map.array().col(SumsType::cz).template cast<ComputeType>();
-
-            BaseType::array.block(1, SumsType::cx2, vec_size, 1) = BaseType::array.block(1, SumsType::cx, vec_size, 1) * BaseType::array.block(1, SumsType::cx, vec_size, 1);
-            BaseType::array.block(1, SumsType::cy2, vec_size, 1) = BaseType::array.block(1, SumsType::cy, vec_size, 1) * BaseType::array.block(1, SumsType::cy, vec_size, 1);
-            BaseType::array.block(1, SumsType::cz2, vec_size, 1) = BaseType::array.block(1, SumsType::cz, vec_size, 1) * BaseType::array.block(1, SumsType::cz, vec_size, 1);
+            RTL_ZONE("rtl::PrecArray::precompute");
+            BaseType::resize(vec.size());
+            BaseType::prefixSums(1, vec);
+        }
 
-            BaseType::array.block(1, SumsType::cxy, vec_size, 1) = BaseType::array.block(1, SumsType::cx, vec_size, 1) * BaseType::array.block(1, SumsType::cy, vec_size, 1);
-            BaseType::array.block(1, SumsType::cyz, vec_size, 1) = BaseType::array.block(1, SumsType::cy, vec_size, 1) * BaseType::array.block(1, SumsType::cz, vec_size, 1);
-            BaseType::array.block(1, SumsType::czx, vec_size, 1) = BaseType::array.block(1, SumsType::cz, vec_size, 1) * BaseType::array.block(1, SumsType::cx, vec_size, 1);
+        //! Extends the precomputed sums by another chunk of points.
+        /*!
+         * Points of \p chunk are treated as if they followed the points already precomputed, the existing rows of the array are not recomputed. Suitable for streamed data,
+         * where the points are obtained in smaller chunks and the whole cloud is not available at once. Use clear() to start a new stream.
+         * @param chunk points to be appended.
+         */
+        void append(Span<const rtl::Vector3D<ElementType>> chunk)
+        {
+            RTL_ZONE("rtl::PrecArray::append");
+            if (BaseType::array_size == 0)
+                BaseType::clear();
+            size_t beg = BaseType::array_size;
+            BaseType::extend(beg - 1 + chunk.size());
 
-            for (size_t i = 1; i < vec_size + 1; i++)
-                BaseType::array.row(i) += BaseType::array.row(i - 1);
+            BaseType::prefixSums(beg, chunk);
         }
     };
 }
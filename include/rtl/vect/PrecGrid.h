@@ -0,0 +1,177 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_VECT_PRECGRID_H
+#define ROBOTICTEMPLATELIBRARY_VECT_PRECGRID_H
+
+#include <cmath>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/Span.h"
+#include "rtl/vect/PrecSums.h"
+
+namespace rtl
+{
+    //! Summed-area table of precomputed sums over an organized (image-like) 3D point cloud.
+    /*!
+     * Organized clouds, such as depth images or lidar range images, store points in a row-major grid of \a rows x \a cols cells. The table holds sums of all points in
+     * the rectangle spanned by the grid origin and each cell, which makes precomputed sums of any rectangular patch available in constant time by four table lookups.
+     * Cells with non-finite coordinates are treated as missing measurements and contribute neither to the sums nor to the number of points.
+     *
+     * The sums are taken relative to the first valid point of the grid to reduce cancellation in the central moments. Large grids still accumulate sums of many points,
+     * so double precision ComputeType is recommended.
+     * @tparam Element type of the point coordinates.
+     * @tparam Compute type for precise computations.
+     */
+    template<typename Element, typename Compute>
+    class PrecGrid3D
+    {
+    public:
+        typedef Element ElementType;                                //!< Type of the point coordinates.
+        typedef Compute ComputeType;                                //!< Type for precise computations.
+        typedef Vector3D<ElementType> VectorType;                   //!< Type of the points.
+        typedef PrecSums3D<ComputeType> PrecSumsType;               //!< Precomputed sums of patches.
+        typedef Eigen::Array<ComputeType, Eigen::Dynamic, PrecSumsType::sumNr() + 1, Eigen::RowMajor> EigenType;  //!< Underlying Eigen type.
+
+        //! Default constructor.
+        PrecGrid3D() = default;
+
+        //! Default destructor.
+        ~PrecGrid3D() = default;
+
+        //! Number of rows of the grid.
+        [[nodiscard]] size_t rows() const { return int_rows; }
+
+        //! Number of columns of the grid.
+        [[nodiscard]] size_t cols() const { return int_cols; }
+
+        //! Returns true if the cell contains a valid point.
+        /*!
+         *
+         * @param row row of the cell.
+         * @param col column of the cell.
+         * @return true if the point has finite coordinates.
+         */
+        [[nodiscard]] bool valid(size_t row, size_t col) const { return int_valid[row * int_cols + col] != 0; }
+
+        //! Precomputes the summed-area table of an organized point cloud.
+        /*!
+         *
+         * @param pts row-major grid of points with \p rows * \p cols elements.
+         * @param rows number of rows of the grid.
+         * @param cols number of columns of the grid.
+         */
+        void precompute(Span<const VectorType> pts, size_t rows, size_t cols)
+        {
+            RTL_ZONE("rtl::PrecGrid::precompute");
+            constexpr size_t n = PrecSumsType::sumNr() + 1;
+            int_rows = rows;
+            int_cols = cols;
+            table.resize((rows + 1) * (cols + 1), Eigen::NoChange);
+            table.topRows(cols + 1).setZero();
+            int_valid.assign(rows * cols, 0);
+
+            reference = PrecSumsType::VectorType::zeros();
+            for (size_t i = 0; i < rows * cols; i++)
+                if (finite(pts[i]))
+                {
+                    reference = pts[i].template cast<ComputeType>();
+                    break;
+                }
+
+            ComputeType acc[n], term[n];
+            for (size_t r = 0; r < rows; r++)
+            {
+                ComputeType *dst = table.data() + ((r + 1) * (cols + 1)) * n;
+                const ComputeType *above = table.data() + (r * (cols + 1)) * n;
+                std::fill(acc, acc + n, ComputeType(0));
+                std::fill(dst, dst + n, ComputeType(0));
+                for (size_t c = 0; c < cols; c++)
+                {
+                    const VectorType &pt = pts[r * cols + c];
+                    if (finite(pt))
+                    {
+                        PrecSumsType::pointSums(pt, reference, term);
+                        for (size_t k = 0; k < n - 1; k++)
+                            acc[k] += term[k];
+                        acc[n - 1] += 1;
+                        int_valid[r * cols + c] = 1;
+                    }
+                    dst += n;
+                    above += n;
+                    for (size_t k = 0; k < n; k++)
+                        dst[k] = above[k] + acc[k];
+                }
+            }
+        }
+
+        //! Precomputed sums of a rectangular patch.
+        /*!
+         *
+         * @param row_beg first row of the patch.
+         * @param col_beg first column of the patch.
+         * @param row_end one behind the last row of the patch.
+         * @param col_end one behind the last column of the patch.
+         * @return sums of valid points in the patch.
+         */
+        PrecSumsType sums(size_t row_beg, size_t col_beg, size_t row_end, size_t col_end) const
+        {
+            PrecSumsType ret;
+            ret.sums = table.row(row_end * (int_cols + 1) + col_end) - table.row(row_beg * (int_cols + 1) + col_end)
+                     - table.row(row_end * (int_cols + 1) + col_beg) + table.row(row_beg * (int_cols + 1) + col_beg);
+            ret.reference = reference;
+            return ret;
+        }
+
+        //! Number of valid points in a rectangular patch.
+        /*!
+         *
+         * @param row_beg first row of the patch.
+         * @param col_beg first column of the patch.
+         * @param row_end one behind the last row of the patch.
+         * @param col_end one behind the last column of the patch.
+         * @return number of valid points.
+         */
+        [[nodiscard]] size_t count(size_t row_beg, size_t col_beg, size_t row_end, size_t col_end) const
+        {
+            constexpr size_t cn = PrecSumsType::sumNr();
+            return static_cast<size_t>(table(row_end * (int_cols + 1) + col_end, cn) - table(row_beg * (int_cols + 1) + col_end, cn)
+                                     - table(row_end * (int_cols + 1) + col_beg, cn) + table(row_beg * (int_cols + 1) + col_beg, cn));
+        }
+
+    private:
+        static bool finite(const VectorType &pt) { return std::isfinite(pt.x()) && std::isfinite(pt.y()) && std::isfinite(pt.z()); }
+
+        size_t int_rows{}, int_cols{};
+        EigenType table;
+        std::vector<uint8_t> int_valid;
+        typename PrecSumsType::VectorType reference{PrecSumsType::VectorType::zeros()};
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_VECT_PRECGRID_H
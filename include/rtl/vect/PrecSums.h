@@ -41,7 +41,9 @@ namespace rtl
 
     //! Base class for precomputed sums.
     /*!
-     * Common operations for all precomputed sums.
+     * Common operations for all precomputed sums. The sums are taken over coordinates relative to a reference point stored in the derived classes (origin by default).
+     * Sums relative to a point close to the summed points avoid cancellation in the computation of central moments, which is crucial for single precision ComputeType.
+     * Sums with different reference points can be still added and subtracted, the right operand is moved to the reference point of the left one.
      * @tparam Compute type for precise computations.
      * @tparam Derived derived precomputed sums implementation (CRTP).
      * @tparam Names structure with enumerator naming of the sums.
@@ -58,7 +60,7 @@ namespace rtl
          * @param pc precomputed sums to be added to *this.
          * @return new precomputed sums representing the sum of \p pc and *this.
          */
-        Derived operator+(const Derived &pc) const { return Derived(sums + pc.sums); }
+        Derived operator+(const Derived &pc) const { Derived ret(derived()); ret += pc; return ret; }
 
         //! In-place addition of precomputed sums.
         /*!
@@ -66,7 +68,14 @@ namespace rtl
          * @param pc precomputed sums to be added to *this.
          * @return reference to *this.
          */
-        Derived& operator+=(const Derived &pc) { sums += pc.sums; return static_cast<Derived&>(*this); }
+        Derived& operator+=(const Derived &pc)
+        {
+            if (derived().reference == pc.reference)
+                sums += pc.sums;
+            else
+                sums += pc.relativeTo(derived().reference).sums;
+            return derived();
+        }
 
         //! Subtraction of precomputed sums.
         /*!
@@ -74,7 +83,7 @@ namespace rtl
          * @param pc precomputed sums to be subtracted from *this.
          * @return new precomputed sums representing the subtraction of \p pc from *this.
          */
-        Derived operator-(const Derived &pc) const { return Derived(sums - pc.sums); }
+        Derived operator-(const Derived &pc) const { Derived ret(derived()); ret -= pc; return ret; }
 
         //! In-place subtraction of precomputed sums.
         /*!
@@ -82,7 +91,14 @@ namespace rtl
          * @param pc precomputed sums to be subtracted from *this.
          * @return reference to *this.
          */
-        Derived& operator-=(const Derived &pc) { sums -= pc.sums; return static_cast<Derived&>(*this); }
+        Derived& operator-=(const Derived &pc)
+        {
+            if (derived().reference == pc.reference)
+                sums -= pc.sums;
+            else
+                sums -= pc.relativeTo(derived().reference).sums;
+            return derived();
+        }
 
         //! In-place divides all sums by number of points they represent.
         void average()
@@ -96,7 +112,24 @@ namespace rtl
          *
          * @return new precomputed sums representing averaged *this.
          */
-        Derived averaged() const { return Derived(sums).average(); }
+        Derived averaged() const { Derived ret(derived()); ret.average(); return ret; }
+
+        //! Returns the same sums taken relative to another reference point.
+        /*!
+         *
+         * @tparam Reference VectorND specialization of the derived sums.
+         * @param ref new reference point.
+         * @return new precomputed sums with \p ref as the reference point.
+         */
+        template<class Reference>
+        Derived relativeTo(const Reference &ref) const
+        {
+            Derived ret(derived());
+            auto offset = derived().reference - ref;
+            Derived::shiftSums(ret.sums, offset.data().data());
+            ret.reference = ref;
+            return ret;
+        }
 
         //! Sets all sums to zero.
         void setZero() { sums.setZero(); }
@@ -110,6 +143,9 @@ namespace rtl
         PrecSumsBase() = default;
         explicit PrecSumsBase(EigenType &&raw_sums) : sums(raw_sums) {}
         ~PrecSumsBase() = default;
+
+        const Derived& derived() const { return static_cast<const Derived&>(*this); }
+        Derived& derived() { return static_cast<Derived&>(*this); }
     };
 
     //! Precomputed sums for 2D line approximations.
@@ -123,6 +159,7 @@ namespace rtl
         typedef PrecSumsBase<Compute, PrecSums2D<Compute>, PrecSums2DNames> BaseType;   //!< Specialization of PrecSumsBase.
         typedef typename BaseType::ComputeType ComputeType;                             //!< Type for precise computations.
         typedef typename BaseType::EigenType EigenType;                                 //!< Underlying Eigen type.
+        typedef VectorND<2, ComputeType> VectorType;                                    //!< Type of the reference point.
 
         using BaseType::cx, BaseType::cy, BaseType::cx2, BaseType::cy2, BaseType::cxy, BaseType::cn;
 
@@ -200,6 +237,44 @@ namespace rtl
          * @return number of summed.
          */
         ComputeType cnt() const { return BaseType::sums[cn]; }
+
+        //! Computes raw sums of a single point relative to a reference point.
+        /*!
+         * Fills the sums without the number of points, used in the precomputation of arrays.
+         * @tparam Point type of the point.
+         * @param pt the point.
+         * @param ref reference point.
+         * @param row output array with sumNr() elements.
+         */
+        template<class Point>
+        static void pointSums(const Point &pt, const VectorType &ref, ComputeType *row)
+        {
+            ComputeType x = static_cast<ComputeType>(pt.x()) - ref.x(), y = static_cast<ComputeType>(pt.y()) - ref.y();
+            row[cx] = x;
+            row[cy] = y;
+            row[cx2] = x * x;
+            row[cy2] = y * y;
+            row[cxy] = x * y;
+        }
+
+        //! Moves the sums by given offset of the coordinates.
+        /*!
+         * Sums of coordinates \a p are changed to the sums of \a p + \p d. Works with raw sums of any scalar type.
+         * @tparam Array type of the raw sums.
+         * @param s raw sums to be changed, the number of points included.
+         * @param d offset with two elements.
+         */
+        template<class Array, typename T>
+        static void shiftSums(Array &s, const T *d)
+        {
+            s[cx2] += (2 * s[cx] + s[cn] * d[0]) * d[0];
+            s[cy2] += (2 * s[cy] + s[cn] * d[1]) * d[1];
+            s[cxy] += d[0] * s[cy] + d[1] * s[cx] + s[cn] * d[0] * d[1];
+            s[cx] += s[cn] * d[0];
+            s[cy] += s[cn] * d[1];
+        }
+
+        VectorType reference{VectorType::zeros()};
     };
 
     //! Precomputed sums for 3D line and plane approximations.
@@ -213,6 +288,7 @@ namespace rtl
         typedef PrecSumsBase<Compute, PrecSums3D<Compute>, PrecSums3DNames> BaseType;   //!< Specialization of PrecSumsBase.
         typedef typename BaseType::ComputeType ComputeType;                             //!< Type for precise computations.
         typedef typename BaseType::EigenType EigenType;                                 //!< Underlying Eigen type.
+        typedef VectorND<3, ComputeType> VectorType;                                    //!< Type of the reference point.
 
         using BaseType::cx, BaseType::cy, BaseType::cz, BaseType::cx2, BaseType::cy2, BaseType::cz2, BaseType::cxy, BaseType::cyz, BaseType::czx, BaseType::cn;
 
@@ -327,6 +403,52 @@ namespace rtl
          * @return number of summed.
          */
         ComputeType cnt() const { return BaseType::sums[cn]; }
+
+        //! Computes raw sums of a single point relative to a reference point.
+        /*!
+         * Fills the sums without the number of points, used in the precomputation of arrays.
+         * @tparam Point type of the point.
+         * @param pt the point.
+         * @param ref reference point.
+         * @param row output array with sumNr() elements.
+         */
+        template<class Point>
+        static void pointSums(const Point &pt, const VectorType &ref, ComputeType *row)
+        {
+            ComputeType x = static_cast<ComputeType>(pt.x()) - ref.x(), y = static_cast<ComputeType>(pt.y()) - ref.y(), z = static_cast<ComputeType>(pt.z()) - ref.z();
+            row[cx] = x;
+            row[cy] = y;
+            row[cz] = z;
+            row[cx2] = x * x;
+            row[cy2] = y * y;
+            row[cz2] = z * z;
+            row[cxy] = x * y;
+            row[cyz] = y * z;
+            row[czx] = z * x;
+        }
+
+        //! Moves the sums by given offset of the coordinates.
+        /*!
+         * Sums of coordinates \a p are changed to the sums of \a p + \p d. Works with raw sums of any scalar type.
+         * @tparam Array type of the raw sums.
+         * @param s raw sums to be changed, the number of points included.
+         * @param d offset with three elements.
+         */
+        template<class Array, typename T>
+        static void shiftSums(Array &s, const T *d)
+        {
+            s[cx2] += (2 * s[cx] + s[cn] * d[0]) * d[0];
+            s[cy2] += (2 * s[cy] + s[cn] * d[1]) * d[1];
+            s[cz2] += (2 * s[cz] + s[cn] * d[2]) * d[2];
+            s[cxy] += d[0] * s[cy] + d[1] * s[cx] + s[cn] * d[0] * d[1];
+            s[cyz] += d[1] * s[cz] + d[2] * s[cy] + s[cn] * d[1] * d[2];
+            s[czx] += d[2] * s[cx] + d[0] * s[cz] + s[cn] * d[2] * d[0];
+            s[cx] += s[cn] * d[0];
+            s[cy] += s[cn] * d[1];
+            s[cz] += s[cn] * d[2];
+        }
+
+        VectorType reference{VectorType::zeros()};
     };
 }
 
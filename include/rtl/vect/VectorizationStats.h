@@ -0,0 +1,56 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#ifndef ROBOTICTEMPLATELIBRARY_VECT_VECTORIZATIONSTATS_H
+#define ROBOTICTEMPLATELIBRARY_VECT_VECTORIZATIONSTATS_H
+
+#include <cstddef>
+
+namespace rtl
+{
+    //! Per-stage statistics of a single run of a vectorization pipeline.
+    /*!
+     * Filled by the vectorizers after setStatsEnabled(true), see e.g. VectorizerFTLSPolyline2D::stats(). The extractors and optimizers take an optional pointer
+     * to this structure and add their counts to it, while the vectorizer resets it at the beginning of each call. The counters are accumulated in locals and stored
+     * once per stage, so a null pointer costs a single branch per stage.
+     */
+    struct VectorizationStats
+    {
+        size_t points{0};                   //!< Number of processed points.
+        size_t fits{0};                     //!< Number of approximations fitted by the extractor, including the rejected ones.
+        size_t extracted{0};                //!< Number of primitives found by the extractor.
+        size_t pruned{0};                   //!< Number of extractor probes decided by error bounds without fitting an approximation.
+        size_t optimizer_iterations{0};     //!< Number of Nelder-Mead iterations of OptimizerTotalError.
+        size_t splits{0};                   //!< Number of approximations inserted by OptimizerContinuity2D to bridge inflexion points.
+        size_t merges{0};                   //!< Number of region merges in ExtractorPlaneQuadtree.
+
+        //! Sets all counters to zero.
+        void reset() { *this = VectorizationStats(); }
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_VECT_VECTORIZATIONSTATS_H
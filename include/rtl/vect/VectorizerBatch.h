@@ -0,0 +1,262 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#ifndef ROBOTICTEMPLATELIBRARY_VECT_VECTORIZERBATCH_H
+#define ROBOTICTEMPLATELIBRARY_VECT_VECTORIZERBATCH_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+#include <experimental/type_traits>
+
+#include "rtl/core/Executor.h"
+#include "rtl/core/Instrumentation.h"
+#include "rtl/core/Span.h"
+
+namespace rtl
+{
+    //! Batch front-end running any of the vectorizers on many independent point clouds.
+    /*!
+     * Inputs (e.g. scans of several sensors, or clusters from CAR_Segmenter given as ranges or offsets of one buffer) are split into as many chunks as the executor runs concurrently and each chunk is processed
+     * by a single shared instance of \p Vectorizer in its own Vectorizer::Workspace. The workspaces are kept between calls, so their precomputed arrays and other buffers are
+     * reused and no allocation takes place once they have grown to the size of the largest input. Memory of the buffers is therefore bounded by the number of workers.
+     *
+     * Results of all inputs are concatenated into flat structure-of-arrays buffers: segments() holds the output objects (line segments or polygons), indices() the
+     * corresponding point index ranges, and segmentOffsets(i) to segmentOffsets(i + 1) delimits the results of the i-th input.
+     * @tparam Vectorizer type of the vectorizer, e.g. VectorizerFTLSPolyline2D.
+     * @tparam Executor execution policy, see rtl/core/Executor.h.
+     */
+    template<class Vectorizer, class Executor = SequentialExecutor>
+    class VectorizerBatch
+    {
+        typedef typename Vectorizer::Workspace WorkspaceType;
+
+        template<typename V>
+        using LineSegmentsResult = decltype(std::declval<const V &>().lineSegments());
+        template<typename V>
+        using PolygonsResult = decltype(std::declval<const V &>().polygons());
+        typedef std::decay_t<std::experimental::detected_or_t<std::experimental::detected_t<PolygonsResult, WorkspaceType>, LineSegmentsResult, WorkspaceType>> OutputVectorType;
+
+        static decltype(auto) output(const WorkspaceType &ws)
+        {
+            if constexpr (std::experimental::is_detected_v<LineSegmentsResult, WorkspaceType>)
+                return ws.lineSegments();
+            else
+                return ws.polygons();
+        }
+
+    public:
+        typedef Vectorizer VectorizerType;                                      //!< Type of the shared vectorizer.
+        typedef typename Vectorizer::VectorType VectorType;                     //!< Type of the input points.
+        typedef typename Vectorizer::IndexType IndexType;                       //!< Type holding a pair of indices to an input.
+        typedef typename OutputVectorType::value_type OutputType;             //!< Type of the output objects.
+
+        //! Construction with given vectorizer prototype and executor.
+        /*!
+         * The shared vectorizer is a copy of the \p prototype, so all its settings (sigma, delta etc.) are applied to the batch. Each worker gets its own workspace.
+         * @param prototype configured vectorizer.
+         * @param executor executor used for parallel processing.
+         */
+        explicit VectorizerBatch(const Vectorizer &prototype = Vectorizer(), Executor executor = Executor())
+                : int_executor(std::move(executor)), int_vectorizer(prototype), int_workspaces(std::max<size_t>(int_executor.concurrency(), 1)) {}
+
+        //! Applies \p func on the shared vectorizer, e.g. to change its settings.
+        template<class Func>
+        void configure(Func &&func)
+        {
+            func(int_vectorizer);
+        }
+
+        //! Reserves buffers of all worker workspaces to accept inputs of given size.
+        /*!
+         * Available only for vectorizers with setMaxSize().
+         * @param size maximal size of a single input.
+         */
+        void setMaxSize(size_t size)
+        {
+            for (auto &ws : int_workspaces)
+                ws.setMaxSize(size);
+        }
+
+        //! Vectorizes all \p inputs.
+        /*!
+         * Inputs are distributed into contiguous chunks with approximately the same number of points, one per worker workspace, so the assignment of inputs
+         * to the workspaces is deterministic.
+         * @param inputs independent ordered point clouds.
+         * @return true if all inputs were vectorized successfully, false otherwise. Results of failed inputs are empty.
+         */
+        bool operator()(const std::vector<std::vector<VectorType>> &inputs)
+        {
+            return process(inputs.size(), [&inputs](size_t i) { return Span<const VectorType>(inputs[i]); });
+        }
+
+        //! Vectorizes ranges of a single buffer of points.
+        /*!
+         * Suitable for clusters of a segmented scan (see CAR_Segmenter::clusteredPoints() and CAR_Segmenter::clusterRanges()), the clusters are processed in place without copying.
+         * @param points buffer with all inputs.
+         * @param ranges first and one behind the last point of each input in \p points.
+         * @return true if all inputs were vectorized successfully, false otherwise. Results of failed inputs are empty.
+         */
+        bool operator()(Span<const VectorType> points, const std::vector<IndexType> &ranges)
+        {
+            RTL_ZONE("rtl::VectorizerBatch");
+            return process(ranges.size(), [&points, &ranges](size_t i) { return points.subspan(ranges[i].first, ranges[i].second - ranges[i].first); });
+        }
+
+        //! Vectorizes parts of a single buffer of points delimited by offsets (compressed sparse row layout).
+        /*!
+         * Suitable for flat cluster output of the segmenters (see CAR_Segmenter::clusterOffsets() and IA_Segmenter::clusterOffsets()), the clusters are processed in place without copying.
+         * @param points buffer with all inputs.
+         * @param offsets first point of each input in \p points followed by the total number of points, one more element than the number of inputs.
+         * @return true if all inputs were vectorized successfully, false otherwise. Results of failed inputs are empty.
+         */
+        bool operator()(Span<const VectorType> points, Span<const size_t> offsets)
+        {
+            RTL_ZONE("rtl::VectorizerBatch");
+            return process(offsets.empty() ? 0 : offsets.size() - 1, [&points, &offsets](size_t i) { return points.subspan(offsets[i], offsets[i + 1] - offsets[i]); });
+        }
+
+        //! Vectorizes rings of an organized scan, e.g. from a multi-beam lidar.
+        /*!
+         * The scan is stored ring by ring, all rings with the same number of points. Each ring is an ordered point cloud of its own and all rings are processed
+         * in place, so the scan is not copied. Since the worker workspaces are kept between calls, setMaxSize() with the ring width makes the precomputed arrays
+         * of all workers allocated once, and consecutive scans are then vectorized without any allocation. The ring of each output object is given by inputIndices().
+         * @param scan points of all rings, ring after ring.
+         * @param rings number of rings in the \p scan, the number of its points has to be divisible by it.
+         * @return true if all rings were vectorized successfully, false otherwise. Results of failed rings are empty.
+         */
+        bool operator()(Span<const VectorType> scan, size_t rings)
+        {
+            RTL_ZONE("rtl::VectorizerBatch");
+            if (rings == 0 || scan.size() % rings != 0)
+                throw std::invalid_argument("rtl::VectorizerBatch: scan size is not divisible by the number of rings.");
+            const size_t width = scan.size() / rings;
+            return process(rings, [&scan, width](size_t i) { return scan.subspan(i * width, width); });
+        }
+
+        //! Number of inputs processed by the last call.
+        [[nodiscard]] size_t size() const { return int_success.size(); }
+
+        //! Whether the \p i -th input was vectorized successfully.
+        [[nodiscard]] bool success(size_t i) const { return int_success[i] != 0; }
+
+        //! Output objects of all inputs concatenated.
+        [[nodiscard]] const std::vector<OutputType> &segments() const { return int_segments; }
+
+        //! Point index ranges of all output objects concatenated, indices are relative to the respective input.
+        [[nodiscard]] const std::vector<IndexType> &indices() const { return int_indices; }
+
+        //! Index of the input (e.g. ring of an organized scan) of each output object, the same size as segments().
+        [[nodiscard]] const std::vector<size_t> &inputIndices() const { return int_inputs; }
+
+        //! Offset of the results of the \p i -th input in segments() and indices(), segmentOffset(size()) equals the total count.
+        [[nodiscard]] size_t segmentOffset(size_t i) const { return int_offsets[i]; }
+
+        //! Offsets of the results of all inputs, size() + 1 elements.
+        [[nodiscard]] const std::vector<size_t> &segmentOffsets() const { return int_offsets; }
+
+    private:
+        template<class InputFunc>
+        bool process(size_t input_cnt, InputFunc &&input)
+        {
+            const size_t chunks = std::max<size_t>(1, std::min(int_workspaces.size(), input_cnt));
+            int_success.assign(input_cnt, 0);
+            int_offsets.assign(input_cnt + 1, 0);
+            int_chunk_segments.resize(chunks);
+            int_chunk_indices.resize(chunks);
+
+            // chunk borders balance the number of points rather than inputs, since scan rings or clusters differ in size considerably
+            int_borders.assign(chunks + 1, input_cnt);
+            int_borders[0] = 0;
+            size_t total = 0;
+            for (size_t i = 0; i < input_cnt; i++)
+                total += input(i).size();
+            for (size_t i = 0, c = 1, acc = 0; i < input_cnt && c < chunks; i++)
+            {
+                while (c < chunks && acc >= total * c / chunks)
+                    int_borders[c++] = i;
+                acc += input(i).size();
+            }
+
+            // each chunk collects its results into its own buffers, counts of results are stored as offsets shifted by one
+            int_executor(0, chunks, [&](size_t c_begin, size_t c_end) {
+                for (size_t c = c_begin; c < c_end; c++)
+                {
+                    auto &ws = int_workspaces[c];
+                    int_chunk_segments[c].clear();
+                    int_chunk_indices[c].clear();
+                    for (size_t i = int_borders[c]; i < int_borders[c + 1]; i++)
+                    {
+                        auto pts = input(i);
+                        if (pts.empty() || !int_vectorizer(pts, ws))
+                            continue;
+                        const auto &segments = output(ws);
+                        const auto &indices = ws.indices();
+                        size_t cnt = std::min(segments.size(), indices.size());
+                        int_chunk_segments[c].insert(int_chunk_segments[c].end(), segments.begin(), segments.begin() + cnt);
+                        int_chunk_indices[c].insert(int_chunk_indices[c].end(), indices.begin(), indices.begin() + cnt);
+                        int_offsets[i + 1] = cnt;
+                        int_success[i] = 1;
+                    }
+                }
+            });
+
+            for (size_t i = 1; i <= input_cnt; i++)
+                int_offsets[i] += int_offsets[i - 1];
+
+            int_segments.clear();
+            int_indices.clear();
+            int_segments.reserve(int_offsets.back());
+            int_indices.reserve(int_offsets.back());
+            for (size_t c = 0; c < chunks; c++)
+            {
+                int_segments.insert(int_segments.end(), int_chunk_segments[c].begin(), int_chunk_segments[c].end());
+                int_indices.insert(int_indices.end(), int_chunk_indices[c].begin(), int_chunk_indices[c].end());
+            }
+            int_inputs.resize(int_offsets.back());
+            for (size_t i = 0; i < input_cnt; i++)
+                std::fill(int_inputs.begin() + int_offsets[i], int_inputs.begin() + int_offsets[i + 1], i);
+
+            return std::all_of(int_success.begin(), int_success.end(), [](unsigned char s) { return s != 0; });
+        }
+
+        Executor int_executor;
+        Vectorizer int_vectorizer;
+        std::vector<WorkspaceType> int_workspaces;
+        std::vector<std::vector<OutputType>> int_chunk_segments;
+        std::vector<std::vector<IndexType>> int_chunk_indices;
+        std::vector<OutputType> int_segments;
+        std::vector<IndexType> int_indices;
+        std::vector<size_t> int_offsets;
+        std::vector<size_t> int_inputs;
+        std::vector<size_t> int_borders;
+        std::vector<unsigned char> int_success;
+    };
+}
+
+#endif //ROBOTICTEMPLATELIBRARY_VECT_VECTORIZERBATCH_H
@@ -29,6 +29,8 @@
 
 #include <vector>
 #include <limits>
+#include <utility>
+#include <algorithm>
 
 #include "rtl/Core.h"
 
@@ -36,11 +38,15 @@ namespace rtl
 {
     //! Douglas-Peucker polyline simplification algorithm.
     /*!
-     * Can be used to simplify ordered points clouds as well.
+     * Can be used to simplify ordered points clouds as well. Sub-polylines are processed in rounds: a sub-polyline longer than the cutoff given by setParallelCutoff() is
+     * split at its farthest point and both halves are passed to the next round, shorter ones are simplified completely. All sub-polylines of a round are independent and
+     * are distributed by the \p Executor. While there are fewer of them than the executor's concurrency, the search of the farthest point itself is split instead.
+     * The result does not depend on the executor and is identical to the serial recursive algorithm.
      * @tparam dimensions dimensionality of the processed point cloud.
      * @tparam Element type for data element storage.
+     * @tparam Executor execution policy for independent sub-polylines, see rtl/core/Executor.h.
      */
-    template<int dimensions, typename Element>
+    template<int dimensions, typename Element, class Executor = SequentialExecutor>
     class VectorizerDouglasPeuckerND
     {
     public:
@@ -55,8 +61,9 @@ namespace rtl
         /*!
          *
          * @param eps maximal permitted distance of points from approximation line.
+         * @param exec executor used for parallel processing of the sub-polylines.
          */
-        explicit VectorizerDouglasPeuckerND(ElementType eps) : epsilon2(eps * eps) {}
+        explicit VectorizerDouglasPeuckerND(ElementType eps, Executor exec = Executor()) : epsilon2(eps * eps), executor(std::move(exec)) {}
 
         //! Default destructor.
         ~VectorizerDouglasPeuckerND() = default;
@@ -68,12 +75,22 @@ namespace rtl
          */
         void setEpsilon(ElementType eps) { epsilon2 = eps * eps; }
 
+        //! Sets the number of points of sub-polylines, which are simplified by a single worker without further splitting.
+        /*!
+         *
+         * @param cutoff number of points, 4096 by default.
+         */
+        void setParallelCutoff(size_t cutoff) { parallel_cutoff = std::max<size_t>(cutoff, 2); }
+
+        //! Returns the number of points of sub-polylines, which are simplified by a single worker without further splitting.
+        [[nodiscard]] size_t parallelCutoff() const { return parallel_cutoff; }
+
         //! Reserves memory in internal buffers for better performance.
         /*!
          *
          * @param size expected maximal number of break points of extracted polylines.
          */
-        void setMaxSize(size_t size) { break_pts.reserve(size); polyline.reserve(size + 1); }
+        void setMaxSize(size_t size) { ranges.reserve(size); next_ranges.reserve(size); splits.reserve(size); }
 
         //! Functor call for simplification of input ordered point cloud.
         /*!
@@ -81,61 +98,153 @@ namespace rtl
          * @param input ordered point cloud.
          * @param output selected points approximating overall shape of the point cloud.
          */
-        void operator()(std::vector<VectorType> & input, std::vector<LineSegmentType> & output)
+        void operator()(Span<const VectorType> input, std::vector<LineSegmentType> &output)
         {
-            break_pts.clear();
-            polyline.clear();
-            work_pt = 0;
+            output.clear();
+            if (input.size() < 2)
+                return;
 
-            break_pts.push_back(input.size() - 1);
+            keep.assign(input.size(), 0);
+            keep.front() = keep.back() = 1;
+            ranges.clear();
+            ranges.emplace_back(0, input.size() - 1);
 
-            while (!break_pts.empty())
+            while (!ranges.empty())
             {
-                if (break_pts.back() - work_pt < 2)
+                splits.assign(ranges.size(), npos);
+                if (ranges.size() < executor.concurrency())
                 {
-                    polyline.push_back(input[work_pt]);
-                    work_pt = break_pts.back();
-                    break_pts.pop_back();
+                    for (size_t r = 0; r < ranges.size(); r++)
+                        splits[r] = ranges[r].second - ranges[r].first > parallel_cutoff ? splitParallel(input, ranges[r]) : simplify(input, ranges[r], break_pts);
                 }
                 else
                 {
-                    max_dist = 0;
-                    max_dist_index = 0;
-
-                    LineSegmentType ls(input[work_pt], input[break_pts.back()]);
+                    executor(0, ranges.size(), [this, input](size_t begin, size_t end) {
+                        std::vector<size_t> stack;
+                        for (size_t r = begin; r < end; r++)
+                            splits[r] = simplify(input, ranges[r], stack);
+                    });
+                }
 
-                    for (size_t i = work_pt + 1; i < break_pts.back(); i++)
+                next_ranges.clear();
+                for (size_t r = 0; r < ranges.size(); r++)
+                    if (splits[r] != npos)
                     {
-                        d = ls.distanceToPointSquared(input[i]);
-                        if (d > max_dist)
-                        {
-                            max_dist = d;
-                            max_dist_index = i;
-                        }
+                        keep[splits[r]] = 1;
+                        next_ranges.emplace_back(ranges[r].first, splits[r]);
+                        next_ranges.emplace_back(splits[r], ranges[r].second);
                     }
+                std::swap(ranges, next_ranges);
+            }
 
-                    if (max_dist > epsilon2)
-                        break_pts.push_back(max_dist_index);
-                    else
-                    {
-                        polyline.push_back(input[work_pt]);
-                        work_pt = break_pts.back();
-                        break_pts.pop_back();
-                    }
+            size_t last = 0;
+            for (size_t i = 1; i < input.size(); i++)
+                if (keep[i])
+                {
+                    output.emplace_back(input[last], input[i]);
+                    last = i;
+                }
+        }
+
+        //! Functor call for simplification of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into an internal buffer first, see StridedSpan::span().
+         * @param input view of the ordered point cloud.
+         * @param output selected points approximating overall shape of the point cloud.
+         */
+        void operator()(StridedSpan<const VectorType> input, std::vector<LineSegmentType> &output) { (*this)(input.span(packed_pts), output); }
+
+    private:
+        typedef std::pair<size_t, size_t> RangeType;
+        typedef std::pair<ElementType, size_t> FarthestType;
+
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        //! Farthest point from the line of the range ends in [\p begin, \p end), the first one wins ties.
+        /*!
+         * Distances are evaluated in small blocks with a branch-free maximum, the index is searched for only in blocks which improve the maximum.
+         */
+        static FarthestType farthest(Span<const VectorType> input, const RangeType &range, size_t begin, size_t end)
+        {
+            constexpr size_t block = 16;
+            ElementType max_dist = 0, dist[block];
+            size_t max_dist_index = 0;
+            LineSegmentType ls(input[range.first], input[range.second]);
+            for (size_t b = begin; b < end; b += block)
+            {
+                size_t cnt = std::min(block, end - b);
+                ElementType block_max = 0;
+                for (size_t i = 0; i < cnt; i++)
+                {
+                    dist[i] = ls.distanceToPointSquared(input[b + i]);
+                    block_max = std::max(block_max, dist[i]);
+                }
+                if (block_max > max_dist)
+                {
+                    max_dist = block_max;
+                    max_dist_index = b + (std::find(dist, dist + cnt, block_max) - dist);
                 }
             }
-            polyline.push_back(input[work_pt]);
+            return FarthestType(max_dist, max_dist_index);
+        }
 
-            output.clear();
-            for (size_t i = 1; i < polyline.size(); i++)
-                output.emplace_back(polyline[i - 1], polyline[i]);
+        //! Finds the split point of a long range by the executor, returns npos if the range is not split.
+        size_t splitParallel(Span<const VectorType> input, const RangeType &range)
+        {
+            size_t chunks = executor.concurrency(), len = range.second - range.first - 1;
+            partial.assign(chunks, FarthestType(0, 0));
+            executor(0, chunks, [&](size_t begin, size_t end) {
+                for (size_t c = begin; c < end; c++)
+                    partial[c] = farthest(input, range, range.first + 1 + len * c / chunks, range.first + 1 + len * (c + 1) / chunks);
+            });
+            FarthestType best(0, 0);
+            for (const auto &p : partial)
+                if (p.first > best.first)
+                    best = p;
+            return best.first > epsilon2 ? best.second : npos;
         }
 
-    private:
-        ElementType d{}, max_dist{}, epsilon2{0.000001};
-        size_t work_pt{}, max_dist_index{};
-        std::vector<size_t > break_pts;
-        std::vector<VectorType> polyline;
+        //! Splits a long range once or simplifies a short one completely, returns the split point or npos.
+        size_t simplify(Span<const VectorType> input, const RangeType &range, std::vector<size_t> &stack)
+        {
+            if (range.second - range.first < 2)
+                return npos;
+            if (range.second - range.first > parallel_cutoff)
+            {
+                FarthestType f = farthest(input, range, range.first + 1, range.second);
+                return f.first > epsilon2 ? f.second : npos;
+            }
+
+            stack.clear();
+            stack.push_back(range.second);
+            size_t work_pt = range.first;
+            while (!stack.empty())
+            {
+                FarthestType f(0, 0);
+                if (stack.back() - work_pt >= 2)
+                    f = farthest(input, RangeType(work_pt, stack.back()), work_pt + 1, stack.back());
+                if (f.first > epsilon2)
+                {
+                    keep[f.second] = 1;
+                    stack.push_back(f.second);
+                }
+                else
+                {
+                    work_pt = stack.back();
+                    stack.pop_back();
+                }
+            }
+            return npos;
+        }
+
+        ElementType epsilon2{0.000001};
+        size_t parallel_cutoff{4096};
+        Executor executor;
+        std::vector<uint8_t> keep;
+        std::vector<RangeType> ranges, next_ranges;
+        std::vector<size_t> splits, break_pts;
+        std::vector<FarthestType> partial;
+        std::vector<VectorType> packed_pts;
     };
 
     //! Reumann-Witkam polyline simplification algorithm.
@@ -174,10 +283,10 @@ namespace rtl
 
         //! Reserves memory in internal buffers for better performance.
         /*!
-         *
+         * The output is written directly without internal buffers, the call is kept for compatibility with the other vectorizers.
          * @param size expected maximal number of break points of extracted polylines.
          */
-        void setMaxSize(size_t size) { polyline.reserve(size + 1); }
+        void setMaxSize([[maybe_unused]] size_t size) {}
 
         //! Functor call for simplification of input ordered point cloud.
         /*!
@@ -185,10 +294,12 @@ namespace rtl
          * @param input ordered point cloud.
          * @param output selected points approximating overall shape of the point cloud.
          */
-        void operator()(std::vector<VectorType> &input, std::vector<LineSegmentType> &output)
+        void operator()(Span<const VectorType> input, std::vector<LineSegmentType> &output)
         {
-            polyline.clear();
-            polyline.push_back(input[0]);
+            output.clear();
+            if (input.empty())
+                return;
+            size_t last = 0;
             kp = 0;
             wp = 1;
             tp = 2;
@@ -205,25 +316,30 @@ namespace rtl
 
                 if (tp == input.size())
                 {
-                    polyline.push_back(input.back());
+                    output.emplace_back(input[last], input.back());
                     break;
                 }
 
-                polyline.push_back(input[tp]);
+                output.emplace_back(input[last], input[tp]);
+                last = tp;
                 kp = wp;
                 wp = tp;
                 tp++;
             }
-
-            output.clear();
-            for (size_t i = 1; i < polyline.size(); i++)
-                output.emplace_back(polyline[i - 1], polyline[i]);
         }
 
+        //! Functor call for simplification of an ordered point cloud viewed in an external buffer.
+        /*!
+         * Tightly packed views are processed in place, padded ones are packed into an internal buffer first, see StridedSpan::span().
+         * @param input view of the ordered point cloud.
+         * @param output selected points approximating overall shape of the point cloud.
+         */
+        void operator()(StridedSpan<const VectorType> input, std::vector<LineSegmentType> &output) { (*this)(input.span(packed_pts), output); }
+
     private:
-        ElementType a{}, b{}, c{}, d{}, l{}, epsilon2{0.000001};
+        ElementType d{}, epsilon2{0.000001};
         size_t kp{}, wp{}, tp{};
-        std::vector<VectorType> polyline;
+        std::vector<VectorType> packed_pts;
     };
 }
 
@@ -25,11 +25,31 @@
 // Contact person: Adam Ligocki <adam.ligocki@vutbr.cz>
 
 #include <gtest/gtest.h>
+#include <memory_resource>
 
 #include "rtl/Algorithms.h"
 
 #define error_1 1e-1
 
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations{0};
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
 TEST(t_genetic_algorithm, init) {
     auto genetic_algorithm = rtl::GeneticAlgorithm<rtl::SimpleAgent<float>, 100, 10, 50, 10>();
 }
@@ -98,6 +118,171 @@ TEST(t_genetic_algorithm, test_int_1) {
 }
 
 
+TEST(t_genetic_algorithm, test_parallel_evaluation) {
+    auto genetic_algorithm = rtl::GeneticAlgorithm<rtl::SimpleAgent<float>, 1000, 100, 500, 500, rtl::ThreadExecutor>(rtl::ThreadExecutor(4));
+
+    rtl::SimpleAgent<float>::set_fit_fn([](float val){
+        return 1.0f / (std::abs(0.0 - val) + 0.001f);
+    });
+
+    for (size_t i = 0 ; i < 100 ; i++) {
+        genetic_algorithm.iterate_epoch();
+    }
+
+    auto best = genetic_algorithm.best_agent();
+    EXPECT_NEAR(0.0f, best.value(), error_1);
+
+    auto bests = genetic_algorithm.best_agents(10);
+    ASSERT_EQ(bests.size(), 10);
+    for (size_t i = 1 ; i < bests.size() ; i++) {
+        EXPECT_GE(bests[i - 1].score(), bests[i].score());
+    }
+}
+
+
+TEST(t_genetic_algorithm, test_steady_state) {
+    auto genetic_algorithm = rtl::GeneticAlgorithm<rtl::SimpleAgent<float>, 1000, 100, 500, 500, rtl::ThreadExecutor>(rtl::ThreadExecutor(4));
+
+    rtl::SimpleAgent<float>::set_fit_fn([](float val){
+        return 1.0f / (std::abs(0.0 - val) + 0.001f);
+    });
+
+    genetic_algorithm.iterate_steady_state(50000, 3);
+
+    auto best = genetic_algorithm.best_agent();
+    EXPECT_NEAR(0.0f, best.value(), error_1);
+
+    // epochs can follow the steady-state evolution
+    genetic_algorithm.iterate_epoch();
+    EXPECT_NEAR(0.0f, genetic_algorithm.best_agent().value(), error_1);
+}
+
+
+TEST(t_genetic_algorithm, test_seeded_steady_state) {
+    rtl::SimpleAgent<float>::set_fit_fn([](float val){
+        return 1.0f / (std::abs(0.0 - val) + 0.001f);
+    });
+
+    auto run = []() {
+        auto genetic_algorithm = rtl::GeneticAlgorithm<rtl::SimpleAgent<float>, 200, 20, 100, 100>();
+        genetic_algorithm.seed(42);
+        genetic_algorithm.iterate_steady_state(5000);
+        return genetic_algorithm.best_agents(5);
+    };
+    auto first = run(), second = run();
+    ASSERT_EQ(first.size(), second.size());
+    for (size_t i = 0 ; i < first.size() ; i++) {
+        EXPECT_EQ(first[i].value(), second[i].value());
+    }
+}
+
+
+TEST(t_genetic_algorithm, test_dynamic) {
+    static_assert(rtl::has_in_place_crossover_v<rtl::SimpleAgent<float>>);
+    rtl::SimpleAgent<float>::set_fit_fn([](float val){
+        return 1.0f / (std::abs(0.0 - val) + 0.001f);
+    });
+
+    auto genetic_algorithm = rtl::GeneticAlgorithmDynamic<rtl::SimpleAgent<float>, rtl::ThreadExecutor>(1000, 100, 500, 500, rtl::ThreadExecutor(4));
+    for (size_t i = 0 ; i < 100 ; i++) {
+        genetic_algorithm.iterate_epoch();
+    }
+    EXPECT_NEAR(0.0f, genetic_algorithm.best_agent().value(), error_1);
+
+    genetic_algorithm.configure(200, 20, 100, 100);
+    ASSERT_EQ(genetic_algorithm.agents_in_epoch(), 200);
+    genetic_algorithm.iterate_steady_state(20000, 3);
+    EXPECT_NEAR(0.0f, genetic_algorithm.best_agent().value(), error_1);
+
+    auto bests = genetic_algorithm.best_agents(10);
+    ASSERT_EQ(bests.size(), 10);
+    for (size_t i = 1 ; i < bests.size() ; i++) {
+        EXPECT_GE(bests[i - 1].score(), bests[i].score());
+    }
+
+    EXPECT_THROW(genetic_algorithm.configure(100, 50, 100, 10), std::invalid_argument);
+}
+
+
+TEST(t_genetic_algorithm, test_dynamic_no_allocation) {
+    rtl::SimpleAgent<float>::set_fit_fn([](float val){
+        return 1.0f / (std::abs(0.0 - val) + 0.001f);
+    });
+
+    CountingResource resource;
+    auto genetic_algorithm = rtl::pmr::GeneticAlgorithmDynamic<rtl::SimpleAgent<float>>(500, 50, 250, 250, rtl::SequentialExecutor(), &resource);
+    genetic_algorithm.seed(7);
+    genetic_algorithm.iterate_epoch();
+    genetic_algorithm.iterate_steady_state(100);
+    size_t allocations = resource.allocations;
+
+    for (size_t i = 0 ; i < 20 ; i++) {
+        genetic_algorithm.iterate_epoch();
+        genetic_algorithm.iterate_steady_state(1000);
+    }
+    EXPECT_EQ(resource.allocations, allocations);
+
+    // shrinking the population reuses the buffers
+    genetic_algorithm.configure(300, 30, 150, 150);
+    genetic_algorithm.iterate_epoch();
+    EXPECT_EQ(resource.allocations, allocations);
+    EXPECT_NEAR(0.0f, genetic_algorithm.best_agent().value(), 1.0f);
+}
+
+
+TEST(t_genetic_algorithm, test_islands) {
+    auto islands = rtl::GeneticIslands<rtl::SimpleAgent<float>, 200, 20, 100, 100, rtl::ThreadExecutor>(4, 5, 5, rtl::ThreadExecutor(4));
+    ASSERT_EQ(islands.islands(), 4);
+
+    rtl::SimpleAgent<float>::set_fit_fn([](float val){
+        return 1.0f / (std::abs(5.0 - val) + 0.001f);
+    });
+
+    islands.iterate_epochs(100);
+
+    auto best = islands.best_agent();
+    EXPECT_NEAR(5.0f, best.value(), error_1);
+}
+
+
+TEST(t_genetic_algorithm, test_seeded_islands) {
+    static_assert(rtl::has_bulk_random_v<rtl::SimpleAgent<float>, rtl::RandomStreams::EngineType>);
+    rtl::SimpleAgent<float>::set_fit_fn([](float val){
+        return 1.0f / (std::abs(-3.0 - val) + 0.001f);
+    });
+
+    auto threaded = rtl::GeneticIslands<rtl::SimpleAgent<float>, 200, 20, 100, 100, rtl::ThreadExecutor>(4, 5, 5, rtl::ThreadExecutor(4));
+    auto sequential = rtl::GeneticIslands<rtl::SimpleAgent<float>, 200, 20, 100, 100>(4, 5, 5);
+    threaded.seed(7);
+    sequential.seed(7);
+    threaded.iterate_epochs(30);
+    sequential.iterate_epochs(30);
+
+    EXPECT_EQ(threaded.best_agent().value(), sequential.best_agent().value());
+    EXPECT_NEAR(-3.0f, sequential.best_agent().value(), error_1);
+}
+
+
+TEST(t_genetic_algorithm, test_pmr_allocator) {
+    rtl::SimpleAgent<float>::set_fit_fn([](float val){
+        return 1.0f / (std::abs(2.0 - val) + 0.001f);
+    });
+
+    CountingResource resource;
+    auto genetic_algorithm = rtl::pmr::GeneticAlgorithm<rtl::SimpleAgent<float>, 1000, 100, 500, 500>(rtl::SequentialExecutor(), &resource);
+    genetic_algorithm.seed(3);
+    size_t allocations = resource.allocations;
+    EXPECT_GT(allocations, 0);
+
+    for (size_t i = 0 ; i < 50 ; i++) {
+        genetic_algorithm.iterate_epoch();
+    }
+
+    EXPECT_EQ(resource.allocations, allocations);
+    EXPECT_NEAR(2.0f, genetic_algorithm.best_agent().value(), error_1);
+}
+
+
 int main(int argc, char **argv){
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
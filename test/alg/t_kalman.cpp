@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <rtl/Core.h>
 #include <math.h>
+#include <random>
 
 #include "rtl/Algorithms.h"
 
@@ -129,6 +130,429 @@ TEST(t_kalman, filtration_3) {
     EXPECT_NEAR(filter.states().getElement(1, 0), speed, max_err_1);
 }
 
+TEST(t_kalman, bank) {
+
+    constexpr size_t filters = 17;
+    double dt_step = 0.1;
+    std::default_random_engine engine(3);
+    std::normal_distribution<double> distribution(0.0, 1.0);
+
+    auto A = rtl::Matrix<4, 4, double>::identity();
+    A.setElement(0, 2, dt_step);
+    A.setElement(1, 3, dt_step);
+    auto B = rtl::Matrix<4, 1, double>::zeros();
+    B.setElement(2, 0, dt_step);
+    auto H = rtl::Matrix<2, 4, double>::zeros();
+    H.setElement(0, 0, 1.0);
+    H.setElement(1, 1, 1.0);
+    auto R = rtl::Matrix<2, 2, double>::identity() * 0.2;
+    R.setElement(0, 1, 0.05);
+    R.setElement(1, 0, 0.05);
+
+    std::vector<rtl::Kalman<double, 4, 2, 1>> singles(filters, rtl::Kalman<double, 4, 2, 1>(0.01, 0.2));
+    rtl::KalmanBank<double, 4, 2, 1> bank(0, 0.01, 0.2);
+    bank.set_transision_matrix(A);
+    bank.set_control_matrix(B);
+    bank.set_measurement_matrix(H);
+    bank.set_measurement_noise_covariance_matrix(R);
+    for (auto& f : singles) {
+        f.set_transision_matrix(A);
+        f.set_control_matrix(B);
+        f.set_measurement_matrix(H);
+        f.set_measurement_noise_covariance_matrix(R);
+
+        auto x = rtl::Matrix<4, 1, double>::zeros();
+        for (size_t j = 0 ; j < 4 ; j++) { x.setElement(j, 0, distribution(engine)); }
+        f.set_states(x);
+        bank.add_filter(x, rtl::Matrix<4, 4, double>::identity());
+    }
+    ASSERT_EQ(bank.size(), filters);
+
+    for (size_t step = 0 ; step < 30 ; step++) {
+        rtl::KalmanBank<double, 4, 2, 1>::ControlsType u(filters, 1);
+        rtl::KalmanBank<double, 4, 2, 1>::MeasurementsType z(filters, 2);
+        std::vector<bool> active(filters);
+        for (size_t i = 0 ; i < filters ; i++) {
+            u(i, 0) = distribution(engine);
+            z(i, 0) = distribution(engine);
+            z(i, 1) = distribution(engine);
+            active[i] = (i + step) % 3 != 0;
+
+            auto control = rtl::Matrix<1, 1, double>::zeros();
+            control.setElement(0, 0, u(i, 0));
+            singles[i].predict(control);
+            if (active[i]) {
+                auto measurement = rtl::Matrix<2, 1, double>::zeros();
+                measurement.setElement(0, 0, z(i, 0));
+                measurement.setElement(1, 0, z(i, 1));
+                singles[i].correct(measurement);
+            }
+        }
+        bank.predict(u);
+        bank.correct(z, active);
+    }
+
+    typedef rtl::Matrix<4, 1, double> StateType;
+    typedef rtl::Matrix<4, 4, double> CovarianceType;
+    for (size_t i = 0 ; i < filters ; i++) {
+        EXPECT_NEAR(StateType::distance(bank.states(i), singles[i].states()), 0.0, max_err_10);
+        EXPECT_NEAR(CovarianceType::distance(bank.covariance(i), singles[i].covariance()), 0.0, max_err_10);
+    }
+
+    bank.remove_filter(3);
+    ASSERT_EQ(bank.size(), filters - 1);
+    EXPECT_NEAR(StateType::distance(bank.states(3), singles[filters - 1].states()), 0.0, max_err_10);
+}
+
+TEST(t_kalman, correction_forms) {
+
+    std::default_random_engine engine(5);
+    std::normal_distribution<double> distribution(0.0, 1.0);
+
+    auto A = rtl::Matrix<3, 3, double>::identity();
+    A.setElement(0, 1, 0.1);
+    A.setElement(1, 2, 0.1);
+    auto H = rtl::Matrix<2, 3, double>::zeros();
+    H.setElement(0, 0, 1.0);
+    H.setElement(1, 1, 0.5);
+    H.setElement(1, 2, 0.5);
+
+    std::vector<rtl::Kalman<double, 3, 2, 1>> filters(3, rtl::Kalman<double, 3, 2, 1>(0.01, 0.3));
+    filters[1].set_correction(rtl::KalmanCorrection::Joseph);
+    filters[2].set_correction(rtl::KalmanCorrection::Sequential);
+    for (auto& f : filters) {
+        f.set_transision_matrix(A);
+        f.set_measurement_matrix(H);
+    }
+
+    for (size_t step = 0 ; step < 50 ; step++) {
+        auto z = rtl::Matrix<2, 1, double>::zeros();
+        z.setElement(0, 0, distribution(engine));
+        z.setElement(1, 0, distribution(engine));
+        for (auto& f : filters) {
+            f.predict(rtl::Matrix<1, 1, double>::zeros());
+            f.correct(z);
+        }
+    }
+
+    typedef rtl::Matrix<3, 1, double> StateType;
+    typedef rtl::Matrix<3, 3, double> CovarianceType;
+    for (size_t i = 1 ; i < filters.size() ; i++) {
+        EXPECT_NEAR(StateType::distance(filters[0].states(), filters[i].states()), 0.0, max_err_10);
+        EXPECT_NEAR(CovarianceType::distance(filters[0].covariance(), filters[i].covariance()), 0.0, max_err_10);
+    }
+}
+
+TEST(t_kalman, joseph_symmetry) {
+
+    auto filter = rtl::Kalman<float, 2, 1, 1>(1e-6f, 1e-6f);
+    filter.set_correction(rtl::KalmanCorrection::Joseph);
+    auto A = rtl::Matrix<2, 2, float>::identity();
+    A.setElement(0, 1, 0.01f);
+    filter.set_transision_matrix(A);
+    auto H = rtl::Matrix<1, 2, float>::zeros();
+    H.setElement(0, 0, 1.0f);
+    filter.set_measurement_matrix(H);
+    filter.set_covariance_matrix(rtl::Matrix<2, 2, float>::identity() * 1e4f);
+
+    for (size_t i = 0 ; i < 1000 ; i++) {
+        filter.predict(rtl::Matrix<1, 1, float>::zeros());
+        filter.correct(rtl::Matrix<1, 1, float>::zeros());
+    }
+
+    const auto& P = filter.covariance();
+    EXPECT_EQ(P.getElement(0, 1), P.getElement(1, 0));
+    EXPECT_GT(P.getElement(0, 0), 0.0f);
+    EXPECT_GT(P.getElement(1, 1), 0.0f);
+    EXPECT_GT(P.getElement(0, 0) * P.getElement(1, 1) - P.getElement(0, 1) * P.getElement(1, 0), 0.0f);
+}
+
+TEST(t_kalman, eigen_expressions) {
+
+    auto A = rtl::Matrix<2, 2, double>::identity();
+    A.setElement(0, 1, 0.1);
+    std::vector<rtl::Kalman<double, 2, 2, 1>> filters(2, rtl::Kalman<double, 2, 2, 1>(0.01, 0.1));
+    for (auto& f : filters) {
+        f.set_transision_matrix(A);
+        f.set_measurement_matrix(rtl::Matrix<2, 2, double>::identity());
+    }
+
+    Eigen::Matrix<double, 1, 1> u(0.5);
+    Eigen::Vector2d z(1.0, 2.0);
+    for (size_t i = 0 ; i < 20 ; i++) {
+        filters[0].predict(rtl::Matrix<1, 1, double>(u));
+        filters[0].correct(rtl::Matrix<2, 1, double>(Eigen::Vector2d(z * 2.0)));
+        filters[1].predict(u);
+        filters[1].correct(z * 2.0);
+    }
+
+    typedef rtl::Matrix<2, 1, double> StateType;
+    typedef rtl::Matrix<2, 2, double> CovarianceType;
+    EXPECT_NEAR(StateType::distance(filters[0].states(), filters[1].states()), 0.0, max_err_10);
+    EXPECT_NEAR(CovarianceType::distance(filters[0].covariance(), filters[1].covariance()), 0.0, max_err_10);
+}
+
+TEST(t_kalman, unscented_linear) {
+
+    std::default_random_engine engine(7);
+    std::normal_distribution<double> distribution(0.0, 1.0);
+
+    auto A = rtl::Matrix<3, 3, double>::identity();
+    A.setElement(0, 1, 0.1);
+    A.setElement(1, 2, 0.1);
+    auto B = rtl::Matrix<3, 1, double>::zeros();
+    B.setElement(2, 0, 0.5);
+    auto H = rtl::Matrix<2, 3, double>::zeros();
+    H.setElement(0, 0, 1.0);
+    H.setElement(1, 1, 0.5);
+    H.setElement(1, 2, 0.5);
+
+    auto linear = rtl::Kalman<double, 3, 2, 1>(0.01, 0.3);
+    linear.set_transision_matrix(A);
+    linear.set_control_matrix(B);
+    linear.set_measurement_matrix(H);
+    auto unscented = rtl::UnscentedKalman<double, 3, 2, 1>(0.01, 0.3);
+    auto motion = [&](const rtl::Matrix<3, 1, double>& x, const rtl::Matrix<1, 1, double>& u) { return A * x + B * u; };
+    auto measurement = [&](const rtl::Matrix<3, 1, double>& x) { return H * x; };
+
+    for (size_t step = 0 ; step < 50 ; step++) {
+        auto u = rtl::Matrix<1, 1, double>::zeros();
+        u.setElement(0, 0, distribution(engine));
+        auto z = rtl::Matrix<2, 1, double>::zeros();
+        z.setElement(0, 0, distribution(engine));
+        z.setElement(1, 0, distribution(engine));
+        linear.predict(u);
+        linear.correct(z);
+        unscented.predict(u, motion);
+        unscented.correct(z, measurement);
+    }
+
+    // the unscented transform is exact for linear models
+    typedef rtl::Matrix<3, 1, double> StateType;
+    typedef rtl::Matrix<3, 3, double> CovarianceType;
+    EXPECT_NEAR(StateType::distance(linear.states(), unscented.states()), 0.0, max_err_10);
+    EXPECT_NEAR(CovarianceType::distance(linear.covariance(), unscented.covariance()), 0.0, max_err_10);
+}
+
+TEST(t_kalman, unscented_radar) {
+
+    // constant velocity target observed by range and bearing from the origin
+    typedef rtl::Matrix<4, 1, double> StateType;
+    typedef rtl::Matrix<2, 1, double> MeasurementType;
+    const double dt = 0.1;
+    auto motion = [dt](const StateType& x, const rtl::Matrix<1, 1, double>&) {
+        StateType ret = x;
+        ret.setElement(0, 0, x.getElement(0, 0) + dt * x.getElement(2, 0));
+        ret.setElement(1, 0, x.getElement(1, 0) + dt * x.getElement(3, 0));
+        return ret;
+    };
+    auto radar = [](const StateType& x) {
+        MeasurementType z;
+        z.setElement(0, 0, std::hypot(x.getElement(0, 0), x.getElement(1, 0)));
+        z.setElement(1, 0, std::atan2(x.getElement(1, 0), x.getElement(0, 0)));
+        return z;
+    };
+
+    std::vector<rtl::UnscentedKalman<double, 4, 2, 1, rtl::ThreadExecutor>> filters(3, rtl::UnscentedKalman<double, 4, 2, 1, rtl::ThreadExecutor>(1e-4, 1e-4, rtl::ThreadExecutor(1)));
+    filters[1] = rtl::UnscentedKalman<double, 4, 2, 1, rtl::ThreadExecutor>(1e-4, 1e-4, rtl::ThreadExecutor(4));
+    filters[2].set_reuse_propagated_sigma_points(true);
+    StateType initial = StateType::zeros();
+    initial.setElement(0, 0, 10.0);
+    initial.setElement(1, 0, 10.0);
+    for (auto& f : filters) {
+        f.set_states(initial);
+        f.set_covariance_matrix(rtl::Matrix<4, 4, double>::identity() * 10.0);
+    }
+
+    StateType truth = StateType::zeros();
+    truth.setElement(0, 0, 12.0);
+    truth.setElement(1, 0, 8.0);
+    truth.setElement(2, 0, 1.0);
+    truth.setElement(3, 0, -0.5);
+    for (size_t step = 0 ; step < 200 ; step++) {
+        truth = motion(truth, rtl::Matrix<1, 1, double>::zeros());
+        for (auto& f : filters) {
+            f.predict(rtl::Matrix<1, 1, double>::zeros(), motion);
+            f.correct(radar(truth), radar);
+        }
+    }
+
+    for (auto& f : filters) {
+        EXPECT_NEAR(StateType::distance(f.states(), truth), 0.0, max_err_1);
+    }
+    EXPECT_NEAR(StateType::distance(filters[0].states(), filters[1].states()), 0.0, max_err_10);
+
+    filters[0].set_covariance_matrix(rtl::Matrix<4, 4, double>::zeros() - rtl::Matrix<4, 4, double>::identity());
+    EXPECT_THROW(filters[0].predict(rtl::Matrix<1, 1, double>::zeros(), motion), std::runtime_error);
+}
+
+TEST(t_kalman, information_fusion) {
+
+    std::default_random_engine engine(9);
+    std::normal_distribution<double> distribution(0.0, 1.0);
+
+    auto A = rtl::Matrix<3, 3, double>::identity();
+    A.setElement(0, 1, 0.1);
+    A.setElement(1, 2, 0.1);
+    auto H = rtl::Matrix<2, 3, double>::zeros();
+    H.setElement(0, 0, 1.0);
+    H.setElement(1, 1, 0.5);
+    H.setElement(1, 2, 0.5);
+
+    std::vector<rtl::Kalman<double, 3, 2, 1>> filters(2, rtl::Kalman<double, 3, 2, 1>(0.01, 0.3));
+    for (auto& f : filters) {
+        f.set_transision_matrix(A);
+        f.set_measurement_matrix(H);
+    }
+
+    std::vector<rtl::Matrix<2, 1, double>> z(20, rtl::Matrix<2, 1, double>::zeros());
+    for (size_t step = 0 ; step < 10 ; step++) {
+        for (auto& m : z) {
+            m.setElement(0, 0, distribution(engine));
+            m.setElement(1, 0, distribution(engine));
+        }
+        for (auto& f : filters) {
+            f.predict(rtl::Matrix<1, 1, double>::zeros());
+        }
+        for (const auto& m : z) {
+            filters[0].correct(m);
+        }
+        filters[1].fuse(z);
+    }
+
+    typedef rtl::Matrix<3, 1, double> StateType;
+    typedef rtl::Matrix<3, 3, double> CovarianceType;
+    EXPECT_NEAR(StateType::distance(filters[0].states(), filters[1].states()), 0.0, max_err_10);
+    EXPECT_NEAR(CovarianceType::distance(filters[0].covariance(), filters[1].covariance()), 0.0, max_err_10);
+
+    // sensors of different dimensions accumulated separately and merged are equivalent to a single stacked measurement
+    auto H1 = rtl::Matrix<2, 3, double>::zeros();
+    H1.setElement(0, 0, 1.0);
+    H1.setElement(1, 2, 1.0);
+    auto R1 = rtl::Matrix<2, 2, double>::identity() * 0.2;
+    auto H2 = rtl::Matrix<1, 3, double>::zeros();
+    H2.setElement(0, 1, 2.0);
+    auto R2 = rtl::Matrix<1, 1, double>::identity() * 0.5;
+    auto z1 = rtl::Matrix<2, 1, double>::zeros();
+    z1.setElement(0, 0, 1.0);
+    z1.setElement(1, 0, -1.0);
+    auto z2 = rtl::Matrix<1, 1, double>::zeros();
+    z2.setElement(0, 0, 0.5);
+
+    auto stacked = rtl::Kalman<double, 3, 3, 1>(0.01, 0.3);
+    auto H_stacked = rtl::Matrix<3, 3, double>::zeros();
+    H_stacked.data().topRows<2>() = H1.data();
+    H_stacked.data().bottomRows<1>() = H2.data();
+    auto R_stacked = rtl::Matrix<3, 3, double>::zeros();
+    R_stacked.data().topLeftCorner<2, 2>() = R1.data();
+    R_stacked.data().bottomRightCorner<1, 1>() = R2.data();
+    auto z_stacked = rtl::Matrix<3, 1, double>::zeros();
+    z_stacked.data() << z1.data(), z2.data();
+    stacked.set_measurement_matrix(H_stacked);
+    stacked.set_measurement_noise_covariance_matrix(R_stacked);
+    stacked.set_states(filters[0].states());
+    stacked.set_covariance_matrix(filters[0].covariance());
+    stacked.correct(z_stacked);
+
+    rtl::KalmanInformation<double, 3> info_1, info_2;
+    info_1.add(z1, H1, R1);
+    info_2.add(z2, H2, R2);
+    info_1.merge(info_2);
+    filters[1].correct_information(info_1);
+    EXPECT_NEAR(StateType::distance(stacked.states(), filters[1].states()), 0.0, max_err_10);
+    EXPECT_NEAR(CovarianceType::distance(stacked.covariance(), filters[1].covariance()), 0.0, max_err_10);
+}
+
+TEST(t_kalman, fixed_lag_smoother) {
+
+    std::default_random_engine engine(11);
+    std::normal_distribution<double> distribution(0.0, 1.0);
+
+    auto A = rtl::Matrix<2, 2, double>::identity();
+    A.setElement(0, 1, 0.1);
+    auto H = rtl::Matrix<1, 2, double>::zeros();
+    H.setElement(0, 0, 1.0);
+
+    constexpr size_t lag = 5;
+    rtl::KalmanSmoother<double, 2, 1, 1, lag> smoother(0.01, 0.5);
+    smoother.filter().set_transision_matrix(A);
+    smoother.filter().set_measurement_matrix(H);
+    EXPECT_THROW(smoother.smoothed_states(0), std::out_of_range);
+
+    // full history for the reference RTS pass
+    typedef Eigen::Matrix<double, 2, 1> V;
+    typedef Eigen::Matrix<double, 2, 2> M;
+    std::vector<V> x_p, x_f;
+    std::vector<M> P_p, P_f;
+    for (size_t step = 0 ; step < 40 ; step++) {
+        auto z = rtl::Matrix<1, 1, double>::zeros();
+        z.setElement(0, 0, 0.2 * step + distribution(engine));
+        smoother.predict(rtl::Matrix<1, 1, double>::zeros());
+        x_p.push_back(smoother.filter().states().data());
+        P_p.push_back(smoother.filter().covariance().data());
+        smoother.correct(z);
+        x_f.push_back(smoother.filter().states().data());
+        P_f.push_back(smoother.filter().covariance().data());
+        ASSERT_EQ(smoother.size(), std::min(step + 1, lag + 1));
+
+        V xs = x_f.back();
+        M Ps = P_f.back();
+        for (size_t d = 1 ; d < smoother.size() ; d++) {
+            size_t k = x_f.size() - 1 - d;
+            M C = P_f[k] * A.data().transpose() * P_p[k + 1].inverse();
+            xs = x_f[k] + C * (xs - x_p[k + 1]);
+            Ps = P_f[k] + C * (Ps - P_p[k + 1]) * C.transpose();
+            EXPECT_NEAR((xs - smoother.smoothed_states(d).data()).norm(), 0.0, max_err_10);
+            EXPECT_NEAR((Ps - smoother.smoothed_covariance(d).data()).norm(), 0.0, max_err_10);
+            EXPECT_LE(Ps.trace(), P_f[k].trace());
+        }
+    }
+    EXPECT_EQ(smoother.smoothed_states(0).data(), smoother.filter().states().data());
+    EXPECT_THROW(smoother.smoothed_states(lag + 1), std::out_of_range);
+}
+
+TEST(t_kalman, selected_measurement) {
+
+    std::default_random_engine engine(13);
+    std::normal_distribution<double> distribution(0.0, 1.0);
+
+    auto A = rtl::Matrix<6, 6, double>::identity();
+    for (int i = 0 ; i < 3 ; i++) {
+        A.setElement(i, i + 3, 0.1);
+    }
+    auto H = rtl::Matrix<3, 6, double>::zeros();
+    H.setElement(0, 4, 1.0);
+    H.setElement(1, 0, 1.0);
+    H.setElement(2, 2, 1.0);
+
+    for (auto correction : {rtl::KalmanCorrection::Standard, rtl::KalmanCorrection::Joseph, rtl::KalmanCorrection::Sequential}) {
+        std::vector<rtl::Kalman<double, 6, 3, 1>> filters(2, rtl::Kalman<double, 6, 3, 1>(0.01, 0.3));
+        for (auto& f : filters) {
+            f.set_transision_matrix(A);
+            f.set_measurement_matrix(H);
+            f.set_correction(correction);
+        }
+        for (size_t step = 0 ; step < 30 ; step++) {
+            auto z = rtl::Matrix<3, 1, double>::zeros();
+            for (int i = 0 ; i < 3 ; i++) {
+                z.setElement(i, 0, distribution(engine));
+            }
+            for (auto& f : filters) {
+                f.predict(rtl::Matrix<1, 1, double>::zeros());
+            }
+            filters[0].correct(z);
+            filters[1].correct_selected<4, 0, 2>(z);
+        }
+
+        typedef rtl::Matrix<6, 1, double> StateType;
+        typedef rtl::Matrix<6, 6, double> CovarianceType;
+        typedef rtl::Matrix<6, 3, double> GainType;
+        EXPECT_NEAR(StateType::distance(filters[0].states(), filters[1].states()), 0.0, max_err_10);
+        EXPECT_NEAR(CovarianceType::distance(filters[0].covariance(), filters[1].covariance()), 0.0, max_err_10);
+        EXPECT_NEAR(GainType::distance(filters[0].kalman_gain(), filters[1].kalman_gain()), 0.0, max_err_10);
+    }
+}
+
 int main(int argc, char **argv){
 
     testing::InitGoogleTest(&argc, argv);
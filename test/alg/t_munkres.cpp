@@ -26,7 +26,10 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <random>
+#include <numeric>
 
+#include "rtl/Core.h"
 #include "rtl/Algorithms.h"
 
 #define max_err 1e-10
@@ -96,7 +99,356 @@ TEST(t_munkres, test_3_max) {
     EXPECT_EQ(result[3].row, 3); EXPECT_EQ(result[3].col, 1); EXPECT_EQ(result[3].cost, 0.7f);
 }
 
+TEST(t_munkres, dynamic_square) {
 
+    std::vector<int> cost_matrix{22, 14, 120, 21, 4, 51,
+                                 19, 12, 172, 21, 28, 43,
+                                 161, 122, 2, 50, 128, 39,
+                                 19, 22, 90, 11, 28, 4,
+                                 1, 30, 113, 14, 28, 86,
+                                 60, 70, 170, 28, 68, 104};
+
+    rtl::MunkresDynamic<int> munkres;
+    auto result = munkres.solve(cost_matrix, 6, 6);
+
+    ASSERT_EQ(result.size(), 6);
+    EXPECT_EQ(result[0].row, 0); EXPECT_EQ(result[0].col, 4); EXPECT_EQ(result[0].cost, 4);
+    EXPECT_EQ(result[1].row, 1); EXPECT_EQ(result[1].col, 1); EXPECT_EQ(result[1].cost, 12);
+    EXPECT_EQ(result[2].row, 2); EXPECT_EQ(result[2].col, 2); EXPECT_EQ(result[2].cost, 2);
+    EXPECT_EQ(result[3].row, 3); EXPECT_EQ(result[3].col, 5); EXPECT_EQ(result[3].cost, 4);
+    EXPECT_EQ(result[4].row, 4); EXPECT_EQ(result[4].col, 0); EXPECT_EQ(result[4].cost, 1);
+    EXPECT_EQ(result[5].row, 5); EXPECT_EQ(result[5].col, 3); EXPECT_EQ(result[5].cost, 28);
+}
+
+TEST(t_munkres, dynamic_rectangular) {
+
+    auto cost_matrix = rtl::Matrix<2, 3, size_t>::zeros();
+    cost_matrix.setRow(0, rtl::VectorND<3, size_t>{1, 2, 3});
+    cost_matrix.setRow(1, rtl::VectorND<3, size_t>{3, 6, 9});
+
+    rtl::MunkresDynamic<size_t> munkres;
+    auto result = munkres.solve(cost_matrix);
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0].row, 0); EXPECT_EQ(result[0].col, 1); EXPECT_EQ(result[0].cost, 2);
+    EXPECT_EQ(result[1].row, 1); EXPECT_EQ(result[1].col, 0); EXPECT_EQ(result[1].cost, 3);
+
+    result = munkres.solve(std::vector<size_t>{1, 3, 2, 6, 3, 9}, 3, 2, true);
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0].row, 1); EXPECT_EQ(result[0].col, 0); EXPECT_EQ(result[0].cost, 2);
+    EXPECT_EQ(result[1].row, 2); EXPECT_EQ(result[1].col, 1); EXPECT_EQ(result[1].cost, 9);
+}
+
+TEST(t_munkres, dynamic_warm_start) {
+
+    constexpr size_t N = 8;
+    std::default_random_engine engine(42);
+    std::uniform_int_distribution<int> distribution(0, 100);
+
+    rtl::MunkresDynamic<int> warm, cold;
+    cold.setWarmStart(false);
+    std::vector<int> costs(N * N);
+    for (auto& c : costs) { c = distribution(engine); }
+
+    for (size_t frame = 0 ; frame < 50 ; frame++) {
+        for (size_t i = 0 ; i < N ; i++) { costs[(frame * 7 + i * 3) % costs.size()] = distribution(engine); }
+        size_t rows = N - frame % 3, cols = N - frame % 4;
+        std::vector<int> sub(rows * cols);
+        for (size_t r = 0 ; r < rows ; r++) {
+            for (size_t c = 0 ; c < cols ; c++) { sub[r * cols + c] = costs[r * N + c]; }
+        }
+
+        auto res_warm = warm.solve(sub, rows, cols);
+        auto res_cold = cold.solve(sub, rows, cols);
+        ASSERT_EQ(res_warm.size(), std::min(rows, cols));
+        ASSERT_EQ(res_cold.size(), std::min(rows, cols));
+
+        int sum_warm = 0, sum_cold = 0;
+        for (const auto& r : res_warm) { sum_warm += r.cost; }
+        for (const auto& r : res_cold) { sum_cold += r.cost; }
+        EXPECT_EQ(sum_warm, sum_cold);
+
+        if (rows == cols) {
+            std::vector<size_t> perm(rows);
+            std::iota(perm.begin(), perm.end(), 0);
+            int sum_ref = std::numeric_limits<int>::max();
+            do {
+                int sum = 0;
+                for (size_t r = 0 ; r < rows ; r++) { sum += sub[r * cols + perm[r]]; }
+                sum_ref = std::min(sum_ref, sum);
+            } while (std::next_permutation(perm.begin(), perm.end()));
+            EXPECT_EQ(sum_warm, sum_ref);
+        }
+    }
+}
+
+TEST(t_munkres, jonker_volgenant) {
+
+    auto cost_matrix = rtl::Matrix<6, 6, int>::zeros();
+    cost_matrix.setRow(0, rtl::VectorND<6, int>{22, 14, 120, 21, 4, 51});
+    cost_matrix.setRow(1, rtl::VectorND<6, int>{19, 12, 172, 21, 28, 43});
+    cost_matrix.setRow(2, rtl::VectorND<6, int>{161, 122, 2, 50, 128, 39});
+    cost_matrix.setRow(3, rtl::VectorND<6, int>{19, 22, 90, 11, 28, 4});
+    cost_matrix.setRow(4, rtl::VectorND<6, int>{1, 30, 113, 14, 28, 86});
+    cost_matrix.setRow(5, rtl::VectorND<6, int>{60, 70, 170, 28, 68, 104});
+
+    auto result = rtl::Munkres<int, 6, rtl::MunkresJonkerVolgenant>::solve(cost_matrix);
+
+    EXPECT_EQ(result[0].row, 0); EXPECT_EQ(result[0].col, 4); EXPECT_EQ(result[0].cost, 4);
+    EXPECT_EQ(result[1].row, 1); EXPECT_EQ(result[1].col, 1); EXPECT_EQ(result[1].cost, 12);
+    EXPECT_EQ(result[2].row, 2); EXPECT_EQ(result[2].col, 2); EXPECT_EQ(result[2].cost, 2);
+    EXPECT_EQ(result[3].row, 3); EXPECT_EQ(result[3].col, 5); EXPECT_EQ(result[3].cost, 4);
+    EXPECT_EQ(result[4].row, 4); EXPECT_EQ(result[4].col, 0); EXPECT_EQ(result[4].cost, 1);
+    EXPECT_EQ(result[5].row, 5); EXPECT_EQ(result[5].col, 3); EXPECT_EQ(result[5].cost, 28);
+
+    auto iou_matrix = rtl::Matrix<4, 4, float>::zeros();
+    iou_matrix.setRow(0, rtl::VectorND<4, float>{0.8f, 0.0f, 0.0f, 0.0f});
+    iou_matrix.setRow(1, rtl::VectorND<4, float>{0.0f, 0.0f, 0.65f, 0.1f});
+    iou_matrix.setRow(2, rtl::VectorND<4, float>{0.0f, 0.0f, 0.0f, 0.0f});
+    iou_matrix.setRow(3, rtl::VectorND<4, float>{0.1f, 0.7f, 0.0f, 0.0f});
+
+    auto iou_result = rtl::Munkres<float, 4, rtl::MunkresJonkerVolgenant>::solve(iou_matrix, true);
+
+    EXPECT_EQ(iou_result[0].col, 0); EXPECT_EQ(iou_result[0].cost, 0.8f);
+    EXPECT_EQ(iou_result[1].col, 2); EXPECT_EQ(iou_result[1].cost, 0.65f);
+    EXPECT_EQ(iou_result[2].col, 3); EXPECT_EQ(iou_result[2].cost, 0.0f);
+    EXPECT_EQ(iou_result[3].col, 1); EXPECT_EQ(iou_result[3].cost, 0.7f);
+}
+
+TEST(t_munkres, jonker_volgenant_random) {
+
+    constexpr size_t N = 12;
+    std::default_random_engine engine(7);
+    std::uniform_int_distribution<int> distribution(0, 20);
+
+    for (size_t i = 0 ; i < 200 ; i++) {
+        rtl::Matrix<N, N, int> cost_matrix;
+        for (size_t r = 0 ; r < N ; r++) {
+            for (size_t c = 0 ; c < N ; c++) { cost_matrix.setElement(r, c, distribution(engine)); }
+        }
+
+        int sum_steps = 0, sum_jv = 0;
+        std::array<bool, N> col_used{};
+        for (const auto& r : rtl::Munkres<int, N>::solve(cost_matrix)) { sum_steps += r.cost; }
+        for (const auto& r : rtl::Munkres<int, N, rtl::MunkresJonkerVolgenant>::solve(cost_matrix)) {
+            sum_jv += r.cost;
+            EXPECT_FALSE(col_used[r.col]);
+            col_used[r.col] = true;
+        }
+        EXPECT_EQ(sum_steps, sum_jv);
+    }
+}
+
+TEST(t_munkres, sparse) {
+
+    typedef rtl::MunkresSparse<int>::Edge Edge;
+    std::vector<Edge> edges{{0, 0, 5}, {0, 1, 1}, {1, 0, 2}, {1, 1, 9},
+                            {2, 3, 7},
+                            {3, 2, 4}, {4, 2, 3}, {4, 2, 8}};
+
+    rtl::MunkresSparse<int> munkres;
+    auto result = munkres.solve(edges, 6, 5);
+    EXPECT_EQ(munkres.componentNr(), 3);
+
+    ASSERT_EQ(result.size(), 4);
+    EXPECT_EQ(result[0].row, 0); EXPECT_EQ(result[0].col, 1); EXPECT_EQ(result[0].cost, 1);
+    EXPECT_EQ(result[1].row, 1); EXPECT_EQ(result[1].col, 0); EXPECT_EQ(result[1].cost, 2);
+    EXPECT_EQ(result[2].row, 2); EXPECT_EQ(result[2].col, 3); EXPECT_EQ(result[2].cost, 7);
+    EXPECT_EQ(result[3].row, 4); EXPECT_EQ(result[3].col, 2); EXPECT_EQ(result[3].cost, 3);
+
+    result = munkres.solve(edges, 6, 5, true);
+    ASSERT_EQ(result.size(), 4);
+    EXPECT_EQ(result[0].row, 0); EXPECT_EQ(result[0].col, 0); EXPECT_EQ(result[0].cost, 5);
+    EXPECT_EQ(result[1].row, 1); EXPECT_EQ(result[1].col, 1); EXPECT_EQ(result[1].cost, 9);
+    EXPECT_EQ(result[2].row, 2); EXPECT_EQ(result[2].col, 3); EXPECT_EQ(result[2].cost, 7);
+    EXPECT_EQ(result[3].row, 4); EXPECT_EQ(result[3].col, 2); EXPECT_EQ(result[3].cost, 8);
+}
+
+TEST(t_munkres, sparse_random) {
+
+    constexpr size_t rows = 7, cols = 6;
+    std::default_random_engine engine(11);
+    std::uniform_int_distribution<int> distribution(0, 50);
+    std::bernoulli_distribution gate(0.3);
+
+    rtl::MunkresSparse<int> sequential;
+    rtl::MunkresSparse<int, rtl::ThreadExecutor> parallel(rtl::ThreadExecutor(4));
+
+    for (size_t i = 0 ; i < 100 ; i++) {
+        std::vector<rtl::MunkresSparse<int>::Edge> edges;
+        std::vector<int> dense(rows * cols, -1);
+        for (size_t r = 0 ; r < rows ; r++) {
+            for (size_t c = 0 ; c < cols ; c++) {
+                if (gate(engine)) {
+                    dense[r * cols + c] = distribution(engine);
+                    edges.emplace_back(r, c, dense[r * cols + c]);
+                }
+            }
+        }
+
+        // Reference by brute force: maximal number of admissible pairs with the minimal cost sum.
+        std::vector<size_t> perm(rows);
+        std::iota(perm.begin(), perm.end(), 0);
+        std::pair<int, int> best{0, 0};
+        do {
+            std::pair<int, int> val{0, 0};
+            for (size_t r = 0 ; r < rows ; r++) {
+                if (perm[r] < cols && dense[r * cols + perm[r]] >= 0) {
+                    val.first--;
+                    val.second += dense[r * cols + perm[r]];
+                }
+            }
+            best = std::min(best, val);
+        } while (std::next_permutation(perm.begin(), perm.end()));
+
+        auto res_seq = sequential.solve(edges, rows, cols);
+        auto res_par = parallel.solve(edges, rows, cols);
+        ASSERT_EQ(res_seq.size(), size_t(-best.first));
+        ASSERT_EQ(res_par.size(), res_seq.size());
+
+        int sum = 0;
+        for (size_t k = 0 ; k < res_seq.size() ; k++) {
+            EXPECT_GE(dense[res_seq[k].row * cols + res_seq[k].col], 0);
+            EXPECT_EQ(res_seq[k].row, res_par[k].row);
+            EXPECT_EQ(res_seq[k].col, res_par[k].col);
+            sum += res_seq[k].cost;
+        }
+        EXPECT_EQ(sum, best.second);
+    }
+}
+
+TEST(t_munkres, iou) {
+
+    auto box = [](double x, double y, double w) { return rtl::BoundingBox2d(rtl::Vector2d(x, y), rtl::Vector2d(x + w, y + w)); };
+    std::vector<rtl::BoundingBox2d> tracks{box(0, 0, 2), box(5, 5, 2), box(10, 0, 1)};
+    std::vector<rtl::BoundingBox2d> detections{box(5.5, 5, 2), box(20, 20, 1), box(0.2, 0.1, 2), box(10.9, 0, 1)};
+
+    rtl::MunkresIoU<2, double> munkres;
+    auto result = munkres.solve(tracks, detections);
+    ASSERT_EQ(result.size(), 3);
+    EXPECT_EQ(result[0].row, 0); EXPECT_EQ(result[0].col, 2);
+    EXPECT_EQ(result[1].row, 1); EXPECT_EQ(result[1].col, 0);
+    EXPECT_EQ(result[2].row, 2); EXPECT_EQ(result[2].col, 3);
+    for (const auto& r : result) {
+        EXPECT_DOUBLE_EQ(r.cost, tracks[r.row].intersectionOverUnion(detections[r.col]));
+        EXPECT_DOUBLE_EQ(munkres.iou(r.row, r.col), r.cost);
+    }
+
+    munkres.setMinIoU(0.5);
+    result = munkres.solve(tracks, detections);
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0].row, 0);
+    EXPECT_EQ(result[1].row, 1);
+
+    EXPECT_TRUE(munkres.solve({}, detections).empty());
+}
+
+
+TEST(t_munkres, batch) {
+
+    std::default_random_engine engine(17);
+    std::uniform_int_distribution<int> distribution(0, 100);
+    std::uniform_int_distribution<size_t> size_distribution(1, 9);
+
+    std::vector<std::vector<int>> costs(200);
+    std::vector<rtl::MunkresProblem<int>> problems;
+    for (auto& c : costs) {
+        size_t rows = size_distribution(engine), cols = size_distribution(engine);
+        c.resize(rows * cols);
+        std::generate(c.begin(), c.end(), [&](){ return distribution(engine); });
+        problems.push_back({c, rows, cols, problems.size() % 2 == 0});
+    }
+
+    rtl::MunkresBatch<int, rtl::ThreadExecutor> parallel(rtl::ThreadExecutor(4));
+    rtl::MunkresBatch<int> sequential;
+    auto res_par = parallel.solve(problems);
+    auto res_seq = sequential.solve(problems);
+    ASSERT_EQ(res_par.size(), problems.size());
+
+    rtl::MunkresDynamic<int> reference;
+    reference.setWarmStart(false);
+    auto total = [](const auto& res) {
+        int sum = 0;
+        for (const auto& r : res) {
+            sum += r.cost;
+        }
+        return sum;
+    };
+    for (size_t i = 0 ; i < problems.size() ; i++) {
+        auto expected = reference.solve(costs[i], problems[i].rows, problems[i].cols, problems[i].max_cost);
+        ASSERT_EQ(res_par[i].size(), expected.size());
+        ASSERT_EQ(res_seq[i].size(), expected.size());
+        EXPECT_EQ(total(res_par[i]), total(expected));
+        EXPECT_EQ(total(res_seq[i]), total(expected));
+    }
+}
+
+TEST(t_munkres, k_best) {
+
+    std::default_random_engine engine(23);
+    std::uniform_int_distribution<int> distribution(0, 20);
+    std::uniform_int_distribution<size_t> size_distribution(1, 5);
+
+    rtl::MunkresKBest<int> munkres;
+    for (size_t trial = 0 ; trial < 100 ; trial++) {
+        size_t rows = size_distribution(engine), cols = size_distribution(engine);
+        bool max_cost = trial % 2 == 1;
+        std::vector<int> costs(rows * cols);
+        std::generate(costs.begin(), costs.end(), [&](){ return distribution(engine); });
+
+        // Brute force over permutations of the padded matrix, assignments differing in dummies only are merged.
+        size_t n = std::max(rows, cols);
+        std::vector<size_t> perm(n);
+        std::iota(perm.begin(), perm.end(), 0);
+        std::vector<std::pair<std::vector<std::pair<size_t, size_t>>, int>> expected;
+        do {
+            std::vector<std::pair<size_t, size_t>> pairs;
+            int sum = 0;
+            for (size_t r = 0 ; r < rows ; r++) {
+                if (perm[r] < cols) {
+                    pairs.emplace_back(r, perm[r]);
+                    sum += costs[r * cols + perm[r]];
+                }
+            }
+            if (std::find_if(expected.begin(), expected.end(), [&](const auto& e){ return e.first == pairs; }) == expected.end()) {
+                expected.emplace_back(pairs, sum);
+            }
+        } while (std::next_permutation(perm.begin(), perm.end()));
+        std::sort(expected.begin(), expected.end(), [&](const auto& a, const auto& b){ return max_cost ? a.second > b.second : a.second < b.second; });
+
+        size_t k = 10;
+        auto result = munkres.solve(costs, rows, cols, k, max_cost);
+        ASSERT_EQ(result.size(), std::min(k, expected.size()));
+        for (size_t i = 0 ; i < result.size() ; i++) {
+            EXPECT_EQ(result[i].cost, expected[i].second);
+            ASSERT_EQ(result[i].assignment.size(), std::min(rows, cols));
+            int sum = 0;
+            std::vector<std::pair<size_t, size_t>> pairs;
+            for (const auto& a : result[i].assignment) {
+                EXPECT_EQ(a.cost, costs[a.row * cols + a.col]);
+                sum += a.cost;
+                pairs.emplace_back(a.row, a.col);
+            }
+            EXPECT_EQ(sum, result[i].cost);
+            for (size_t j = 0 ; j < i ; j++) {
+                std::vector<std::pair<size_t, size_t>> other;
+                for (const auto& a : result[j].assignment) {
+                    other.emplace_back(a.row, a.col);
+                }
+                EXPECT_NE(pairs, other);
+            }
+        }
+    }
+
+    auto cost_matrix = rtl::Matrix<3, 3, int>::zeros();
+    cost_matrix.setRow(0, rtl::VectorND<3, int>{1, 2, 3});
+    cost_matrix.setRow(1, rtl::VectorND<3, int>{2, 4, 6});
+    cost_matrix.setRow(2, rtl::VectorND<3, int>{3, 6, 9});
+    auto result = munkres.solve(cost_matrix, 10);
+    ASSERT_EQ(result.size(), 6);
+    EXPECT_EQ(result.front().cost, 10);
+    EXPECT_EQ(result.back().cost, 14);
+    EXPECT_TRUE(munkres.solve(std::vector<int>{}, 0, 3, 5).empty());
+}
 
 int main(int argc, char **argv){
 
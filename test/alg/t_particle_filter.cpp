@@ -25,10 +25,164 @@
 // Contact person: Adam Ligocki <adam.ligocki@vutbr.cz>
 
 #include <gtest/gtest.h>
+#include <memory_resource>
+#include <random>
 
 #include "rtl/Algorithms.h"
 
 
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations{0};
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/*!
+ * Particle with likelihoods far below the range of double, it can only be scored in log domain.
+ */
+class NarrowParticle {
+public:
+    using Action = rtl::SimpleParticle<double>::Action;
+    using Measurement = rtl::SimpleParticle<double>::Measurement;
+    using Result = rtl::SimpleParticle<double>::Result;
+
+    explicit NarrowParticle(double val) : value_{val} {}
+
+    static NarrowParticle random() {
+        static std::mt19937 engine(1);
+        return random(engine);
+    }
+
+    template<class Engine>
+    static NarrowParticle random(Engine& engine) {
+        return NarrowParticle(std::uniform_real_distribution<double>(-100.0, 100.0)(engine));
+    }
+
+    void move(const Action& action) {
+        value_ += action.value();
+    }
+
+    [[nodiscard]] double log_belief(const Measurement& measurement) const {
+        return -2000.0 - (value_ - measurement.value()) * (value_ - measurement.value());
+    }
+
+    [[nodiscard]] static Result evaluation(const std::vector<NarrowParticle>& vec) {
+        std::vector<rtl::SimpleParticle<double>> values;
+        for (const auto& p : vec) {
+            values.emplace_back(p.value_);
+        }
+        return rtl::SimpleParticle<double>::evaluation(values);
+    }
+
+private:
+    double value_;
+};
+
+using Field = rtl::LikelihoodField2D<float>;
+
+/*!
+ * Planar pose particle scored by a shared likelihood field.
+ */
+class PoseParticle {
+public:
+    using Action = rtl::SimpleParticle<float>::Action;
+
+    class Measurement {
+    public:
+        Measurement(const Field& field, std::vector<Field::VectorType> beams) : field_{&field}, beams_{std::move(beams)} {}
+        [[nodiscard]] const Field& field() const {return *field_;}
+        [[nodiscard]] rtl::Span<const Field::VectorType> beams() const {return beams_;}
+    private:
+        const Field* field_;
+        std::vector<Field::VectorType> beams_;
+    };
+
+    using Result = Field::TransformationType;
+
+    explicit PoseParticle(const Result& pose) : pose_{pose} {}
+
+    static PoseParticle random() {
+        static std::mt19937 engine(3);
+        return random(engine);
+    }
+
+    template<class Engine>
+    static PoseParticle random(Engine& engine) {
+        std::uniform_real_distribution<float> x(0.0f, 10.0f), y(0.0f, 8.0f), a(-rtl::C_PI<float>, rtl::C_PI<float>);
+        return PoseParticle(Result(a(engine), x(engine), y(engine)));
+    }
+
+    void move(const Action&) {
+        static std::mt19937 engine(4);
+        std::normal_distribution<float> tr(0.0f, 0.05f), rot(0.0f, 0.02f);
+        pose_ = Result(pose_.rotAngle() + rot(engine), pose_.trVecX() + tr(engine), pose_.trVecY() + tr(engine));
+    }
+
+    static void log_belief(rtl::Span<const PoseParticle> particles, const Measurement& measurement, rtl::Span<double> log_weights) {
+        measurement.field().log_likelihood(particles, [](const PoseParticle& p) {return p.pose_;}, measurement.beams(), log_weights);
+    }
+
+    [[nodiscard]] static Result evaluation(rtl::Span<const PoseParticle> vec) {
+        float x = 0.0f, y = 0.0f, c = 0.0f, s = 0.0f;
+        for (const auto& p : vec) {
+            x += p.pose_.trVecX();
+            y += p.pose_.trVecY();
+            c += p.pose_.rotCos();
+            s += p.pose_.rotSin();
+        }
+        return Result(std::atan2(s, c), x / vec.size(), y / vec.size());
+    }
+
+private:
+    Result pose_;
+};
+
+//! L-shaped room, its walls and ray-cast scan taken from given pose
+std::vector<Field::LineSegmentType> l_room() {
+    std::vector<Field::VectorType> corners{{0.0f, 0.0f}, {10.0f, 0.0f}, {10.0f, 4.0f}, {6.0f, 4.0f}, {6.0f, 8.0f}, {0.0f, 8.0f}};
+    std::vector<Field::LineSegmentType> walls;
+    for (size_t i = 0 ; i < corners.size() ; i++) {
+        walls.emplace_back(corners[i], corners[(i + 1) % corners.size()]);
+    }
+    return walls;
+}
+
+std::vector<Field::VectorType> l_room_scan(const std::vector<Field::LineSegmentType>& walls, const Field::TransformationType& pose, size_t beams) {
+    std::vector<Field::VectorType> scan;
+    for (size_t b = 0 ; b < beams ; b++) {
+        const float a = 2.0f * rtl::C_PI<float> * static_cast<float>(b) / static_cast<float>(beams);
+        const float dx = std::cos(a + pose.rotAngle()), dy = std::sin(a + pose.rotAngle());
+        float range = std::numeric_limits<float>::infinity();
+        for (const auto& w : walls) {
+            const float ex = w.end().x() - w.beg().x(), ey = w.end().y() - w.beg().y();
+            const float ox = w.beg().x() - pose.trVecX(), oy = w.beg().y() - pose.trVecY();
+            const float den = dx * ey - dy * ex;
+            if (std::abs(den) < 1e-9f) {
+                continue;
+            }
+            const float t = (ox * ey - oy * ex) / den, u = (ox * dy - oy * dx) / den;
+            if (t > 0.0f && u >= 0.0f && u <= 1.0f) {
+                range = std::min(range, t);
+            }
+        }
+        scan.emplace_back(range * std::cos(a), range * std::sin(a));
+    }
+    return scan;
+}
+
 TEST(t_particle_filter, init) {
     auto particle_filter = rtl::ParticleFilter<rtl::SimpleParticle<float>, 10, 5>();
 }
@@ -83,6 +237,249 @@ TEST(t_particle_filter, test_3) {
 }
 
 
+TEST(t_particle_filter, parallel_executor) {
+
+    using ParticleFilterType = rtl::ParticleFilter<rtl::SimpleParticle<float>, 10000, 3000, rtl::ThreadExecutor>;
+    auto particle_filter = ParticleFilterType(rtl::ThreadExecutor(4));
+    float step = 0.1;
+    float measurement = 0.0;
+
+    for (size_t i = 0 ; i < 100 ; i++) {
+        measurement += step;
+        particle_filter.iteration(rtl::SimpleParticle<float>::Action(step), rtl::SimpleParticle<float>::Measurement(measurement));
+    }
+
+    auto result = particle_filter.evaluate();
+    std::cout << "gt: " << measurement << " mean_pose: " << result.mean() << " std_dev_pose: " << result.std_dev() << std::endl;
+    EXPECT_NEAR(result.mean(), measurement, 5.0);
+}
+
+
+template<class Resampling>
+void resampling_test() {
+
+    using ParticleFilterType = rtl::ParticleFilter<rtl::SimpleParticle<float>, 1000, 300, rtl::SequentialExecutor, Resampling>;
+    auto particle_filter = ParticleFilterType();
+    float step = 0.1;
+    float measurement = 0.0;
+
+    for (size_t i = 0 ; i < 100 ; i++) {
+        measurement += step;
+        particle_filter.iteration(rtl::SimpleParticle<float>::Action(step), rtl::SimpleParticle<float>::Measurement(measurement));
+    }
+
+    auto result = particle_filter.evaluate();
+    std::cout << "gt: " << measurement << " mean_pose: " << result.mean() << " std_dev_pose: " << result.std_dev() << std::endl;
+    EXPECT_NEAR(result.mean(), measurement, 5.0);
+}
+
+
+TEST(t_particle_filter, resampling_policies) {
+    resampling_test<rtl::DeterministicResampling>();
+    resampling_test<rtl::SystematicResampling>();
+    resampling_test<rtl::StratifiedResampling>();
+    resampling_test<rtl::ResidualResampling>();
+}
+
+
+TEST(t_particle_filter, seeded_reproducibility) {
+
+    using Particle = rtl::SimpleParticle<double>;
+    static_assert(rtl::has_bulk_random_v<Particle, rtl::RandomStreams::EngineType>);
+    auto run = [](auto& filter) {
+        filter.seed(42);
+        double measurement = 0.0;
+        for (size_t i = 0 ; i < 50 ; i++) {
+            measurement += 0.5;
+            filter.iteration(Particle::Action(0.5), Particle::Measurement(measurement));
+        }
+        return filter.evaluate();
+    };
+
+    rtl::ParticleFilter<Particle, 2000, 500, rtl::ThreadExecutor, rtl::SystematicResampling> threaded_1(rtl::ThreadExecutor(4)), threaded_2(rtl::ThreadExecutor(4));
+    rtl::ParticleFilter<Particle, 2000, 500, rtl::SequentialExecutor, rtl::SystematicResampling> sequential;
+    auto r1 = run(threaded_1);
+    auto r2 = run(threaded_2);
+    auto r3 = run(sequential);
+
+    EXPECT_EQ(r1.mean(), r2.mean());
+    EXPECT_EQ(r1.std_dev(), r2.std_dev());
+    EXPECT_NEAR(r1.mean(), r3.mean(), 1e-6);
+    EXPECT_NEAR(r1.std_dev(), r3.std_dev(), 1e-6);
+}
+
+TEST(t_particle_filter, pmr_allocator) {
+
+    using Particle = rtl::SimpleParticle<double>;
+    CountingResource resource;
+    rtl::pmr::ParticleFilter<Particle, 1000, 300, rtl::SequentialExecutor, rtl::SystematicResampling> filter(rtl::SequentialExecutor(), &resource);
+    filter.seed(7);
+    size_t allocations = resource.allocations;
+    EXPECT_GT(allocations, 0);
+
+    double measurement = 0.0;
+    for (size_t i = 0 ; i < 20 ; i++) {
+        measurement += 0.5;
+        filter.iteration(Particle::Action(0.5), Particle::Measurement(measurement));
+    }
+    auto result = filter.evaluate();
+    EXPECT_EQ(resource.allocations, allocations);
+    EXPECT_NEAR(result.mean(), measurement, 5.0);
+}
+
+TEST(t_particle_filter, adaptive_population) {
+
+    using Particle = rtl::SimpleParticle<double>;
+    rtl::AdaptiveParticleFilter<Particle, rtl::KldSampling, rtl::SequentialExecutor, rtl::SystematicResampling> filter(100, 10000, 0.3);
+    filter.seed(3);
+    EXPECT_EQ(filter.size(), 10000);
+
+    double measurement = 0.0;
+    for (size_t i = 0 ; i < 50 ; i++) {
+        measurement += 0.5;
+        filter.iteration(Particle::Action(0.5), Particle::Measurement(measurement));
+        EXPECT_GE(filter.size(), 100);
+        EXPECT_LE(filter.size(), 10000);
+    }
+    auto result = filter.evaluate();
+    std::cout << "gt: " << measurement << " mean_pose: " << result.mean() << " std_dev_pose: " << result.std_dev() << " particles: " << filter.size() << std::endl;
+    EXPECT_NEAR(result.mean(), measurement, 5.0);
+    EXPECT_LT(filter.size(), 10000 / 3);
+
+    EXPECT_THROW((rtl::AdaptiveParticleFilter<Particle>(0, 100, 0.3)), std::invalid_argument);
+    EXPECT_THROW((rtl::AdaptiveParticleFilter<Particle>(200, 100, 0.3)), std::invalid_argument);
+    EXPECT_THROW((rtl::AdaptiveParticleFilter<Particle>(10, 100, 0.0)), std::invalid_argument);
+}
+
+TEST(t_particle_filter, kld_sampling) {
+
+    rtl::KldSampling kld(0.05, 2.326);
+    EXPECT_EQ(kld.required_samples(1), 1);
+    EXPECT_LT(kld.required_samples(10), kld.required_samples(100));
+    EXPECT_EQ(kld.required_samples(100), 1347);
+
+    std::vector<rtl::SimpleParticle<double>> particles;
+    for (size_t i = 0 ; i < 1000 ; i++) {
+        particles.emplace_back(static_cast<double>(i % 100) + 0.5);
+    }
+    EXPECT_EQ(kld(particles), kld.required_samples(100));
+}
+
+TEST(t_particle_filter, log_domain_weights) {
+
+    static_assert(rtl::has_batch_log_belief_v<rtl::SimpleParticle<float>, rtl::SimpleParticle<float>::Measurement>);
+    static_assert(rtl::has_log_belief_v<NarrowParticle, NarrowParticle::Measurement>);
+
+    rtl::ParticleFilter<NarrowParticle, 2000, 500, rtl::ThreadExecutor, rtl::SystematicResampling> filter(rtl::ThreadExecutor(4));
+    filter.seed(11);
+    for (size_t i = 0 ; i < 20 ; i++) {
+        filter.iteration(NarrowParticle::Action(0.0), NarrowParticle::Measurement(42.0));
+    }
+    auto result = filter.evaluate();
+    EXPECT_NEAR(result.mean(), 42.0, 1.0);
+    EXPECT_LT(result.std_dev(), 1.0);
+}
+
+TEST(t_particle_filter, weighted_estimate) {
+
+    using Particle = rtl::SimpleParticle<double>;
+    static_assert(rtl::has_span_evaluation_v<Particle> && rtl::has_accumulator_v<Particle>);
+    static_assert(!rtl::has_span_evaluation_v<NarrowParticle> && !rtl::has_accumulator_v<NarrowParticle>);
+
+    rtl::ParticleFilter<Particle, 2000, 500, rtl::ThreadExecutor, rtl::SystematicResampling> threaded(rtl::ThreadExecutor(4));
+    rtl::ParticleFilter<Particle, 2000, 500, rtl::SequentialExecutor, rtl::SystematicResampling> sequential;
+    threaded.seed(5);
+    sequential.seed(5);
+    double measurement = 0.0;
+    for (size_t i = 0 ; i < 30 ; i++) {
+        measurement += 0.5;
+        threaded.iteration(Particle::Action(0.5), Particle::Measurement(measurement));
+        sequential.iteration(Particle::Action(0.5), Particle::Measurement(measurement));
+    }
+
+    auto estimate = threaded.estimate();
+    std::cout << "gt: " << measurement << " weighted mean_pose: " << estimate.mean() << " std_dev_pose: " << estimate.std_dev() << std::endl;
+    EXPECT_NEAR(estimate.mean(), measurement, 5.0);
+    EXPECT_GT(estimate.std_dev(), 0.0);
+    EXPECT_NEAR(estimate.mean(), sequential.estimate().mean(), 1e-6);
+    EXPECT_NEAR(estimate.std_dev(), sequential.estimate().std_dev(), 1e-6);
+    EXPECT_NEAR(threaded.evaluate().mean(), sequential.evaluate().mean(), 1e-6);
+}
+
+TEST(t_particle_filter, likelihood_field_distances) {
+
+    auto walls = l_room();
+    std::vector<Field::VectorType> points;
+    for (const auto& w : walls) {
+        for (float t = 0.0f ; t <= 1.0f ; t += 0.01f) {
+            points.push_back(w.beg() + (w.end() - w.beg()) * t);
+        }
+    }
+    Field from_segments(0.05f, 0.2f, 2.0f), from_points(0.05f, 0.2f, 2.0f);
+    from_segments.build(walls);
+    from_points.build(points);
+    EXPECT_EQ(from_segments.cells_x(), static_cast<size_t>(14.0f / 0.05f) + 1);
+
+    std::mt19937 engine(11);
+    std::uniform_real_distribution<float> x(-3.0f, 13.0f), y(-3.0f, 11.0f);
+    for (size_t i = 0 ; i < 2000 ; i++) {
+        Field::VectorType pt(x(engine), y(engine));
+        float d = std::numeric_limits<float>::max();
+        for (const auto& w : walls) {
+            d = std::min(d, std::sqrt(w.segmentDistanceToPointSquared(pt)));
+        }
+        d = std::min(d, 2.0f);
+        EXPECT_NEAR(from_segments.distance(pt), d, 0.075f);
+        EXPECT_NEAR(from_points.distance(pt), d, 0.1f);
+        EXPECT_NEAR(from_segments.log_likelihood(pt), from_points.log_likelihood(pt), 0.5);
+    }
+    EXPECT_THROW(Field(0.0f, 0.2f, 2.0f), std::invalid_argument);
+}
+
+TEST(t_particle_filter, likelihood_field_scan) {
+
+    auto walls = l_room();
+    Field field(0.05f, 0.1f, 1.0f);
+    field.build(walls);
+    Field::TransformationType pose(0.4f, 2.5f, 2.0f);
+    auto scan = l_room_scan(walls, pose, 90);
+
+    double sum = 0.0;
+    for (const auto& b : scan) {
+        sum += field.log_likelihood(pose(b));
+    }
+    EXPECT_NEAR(field.log_likelihood(pose, scan), sum, 1e-6 * std::abs(sum));
+
+    std::vector<PoseParticle> particles{PoseParticle(pose), PoseParticle(Field::TransformationType(0.4f, 2.8f, 2.0f)),
+                                        PoseParticle(Field::TransformationType(0.6f, 2.5f, 2.0f))};
+    std::vector<double> log_weights(particles.size());
+    PoseParticle::log_belief(particles, PoseParticle::Measurement(field, scan), log_weights);
+    EXPECT_DOUBLE_EQ(log_weights[0], field.log_likelihood(pose, scan));
+    EXPECT_GT(log_weights[0], log_weights[1]);
+    EXPECT_GT(log_weights[0], log_weights[2]);
+}
+
+TEST(t_particle_filter, likelihood_field_localization) {
+
+    auto walls = l_room();
+    Field field(0.05f, 0.15f, 1.0f);
+    field.build(walls);
+    Field::TransformationType pose(0.4f, 2.5f, 2.0f);
+    PoseParticle::Measurement measurement(field, l_room_scan(walls, pose, 60));
+
+    rtl::ParticleFilter<PoseParticle, 5000, 1000, rtl::SequentialExecutor, rtl::SystematicResampling> filter;
+    filter.seed(9);
+    for (size_t i = 0 ; i < 30 ; i++) {
+        filter.iteration(PoseParticle::Action(0.0f), measurement);
+    }
+    auto result = filter.evaluate();
+    std::cout << "gt: " << pose.trVecX() << " " << pose.trVecY() << " " << pose.rotAngle() << " estimate: "
+              << result.trVecX() << " " << result.trVecY() << " " << result.rotAngle() << std::endl;
+    EXPECT_NEAR(result.trVecX(), pose.trVecX(), 0.2f);
+    EXPECT_NEAR(result.trVecY(), pose.trVecY(), 0.2f);
+    EXPECT_NEAR(result.rotAngle(), pose.rotAngle(), 0.1f);
+}
+
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,117 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Adam Ligocki <adam.ligocki@vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "rtl/Core.h"
+#include "rtl/Transformation.h"
+#include "rtl/Algorithms.h"
+
+namespace
+{
+    // L-shaped room, all degrees of freedom are observable
+    std::vector<rtl::LineSegment2f> room()
+    {
+        std::vector<rtl::Vector2f> corners{{0.0f, 0.0f}, {10.0f, 0.0f}, {10.0f, 4.0f}, {6.0f, 4.0f}, {6.0f, 8.0f}, {0.0f, 8.0f}};
+        std::vector<rtl::LineSegment2f> walls;
+        for (size_t i = 0; i < corners.size(); i++)
+            walls.emplace_back(corners[i], corners[(i + 1) % corners.size()]);
+        return walls;
+    }
+
+    std::vector<rtl::Vector2f> scan(const std::vector<rtl::LineSegment2f> &walls, const rtl::RigidTf2f &pose, size_t pts_per_wall, float noise)
+    {
+        std::default_random_engine generator(7);
+        std::normal_distribution<float> rnd_noise(0.0f, noise);
+        auto inv = pose.inverted();
+        std::vector<rtl::Vector2f> pts;
+        for (const auto &w : walls)
+            for (size_t i = 0; i < pts_per_wall; i++)
+            {
+                float t = ((float)i + 0.5f) / (float)pts_per_wall;
+                rtl::Vector2f p = w.beg() + (w.end() - w.beg()) * t + w.normal() * rnd_noise(generator);
+                pts.push_back(inv(p));
+            }
+        return pts;
+    }
+}
+
+TEST(t_scan_matching, recovers_pose)
+{
+    auto walls = room();
+    rtl::RigidTf2f pose(0.05f, 0.3f, -0.2f);
+    auto pts = scan(walls, pose, 200, 0.01f);
+
+    rtl::ScanMatcherPointToLine2D<float> matcher;
+    matcher.setReference(walls);
+    matcher.setMaxDistance(1.0f);
+    ASSERT_TRUE(matcher(pts));
+    EXPECT_NEAR(matcher.transformation().rotAngle(), pose.rotAngle(), 1e-3f);
+    EXPECT_NEAR(matcher.transformation().trVecX(), pose.trVecX(), 1e-2f);
+    EXPECT_NEAR(matcher.transformation().trVecY(), pose.trVecY(), 1e-2f);
+    EXPECT_EQ(matcher.correspondences(), pts.size());
+    EXPECT_LT(matcher.error(), 0.02f);
+}
+
+TEST(t_scan_matching, parallel_equals_sequential)
+{
+    auto walls = room();
+    rtl::RigidTf2f pose(-0.08f, -0.4f, 0.25f);
+    auto pts = scan(walls, pose, 500, 0.02f);
+
+    rtl::ScanMatcherPointToLine2D<float> sequential;
+    rtl::ScanMatcherPointToLine2D<float, rtl::ThreadExecutor> parallel{rtl::ThreadExecutor(4)};
+    sequential.setReference(walls);
+    parallel.setReference(walls);
+    bool seq_ok = sequential(pts), par_ok = parallel(pts);
+    ASSERT_TRUE(seq_ok);
+    ASSERT_TRUE(par_ok);
+    EXPECT_EQ(sequential.iterations(), parallel.iterations());
+    EXPECT_NEAR(sequential.transformation().rotAngle(), parallel.transformation().rotAngle(), 1e-5f);
+    EXPECT_NEAR(sequential.transformation().trVecX(), parallel.transformation().trVecX(), 1e-4f);
+    EXPECT_NEAR(sequential.transformation().trVecY(), parallel.transformation().trVecY(), 1e-4f);
+}
+
+TEST(t_scan_matching, initial_estimate_and_degenerate_corridor)
+{
+    // a corridor does not constrain the translation along its walls, which is kept from the initial estimate
+    std::vector<rtl::LineSegment2f> corridor{rtl::LineSegment2f(rtl::Vector2f(-20.0f, -1.0f), rtl::Vector2f(20.0f, -1.0f)),
+                                             rtl::LineSegment2f(rtl::Vector2f(-20.0f, 1.0f), rtl::Vector2f(20.0f, 1.0f))};
+    rtl::RigidTf2f pose(0.02f, 0.5f, 0.1f);
+    auto pts = scan(corridor, pose, 300, 0.0f);
+
+    rtl::ScanMatcherPointToLine2D<float> matcher;
+    matcher.setReference(corridor);
+    ASSERT_TRUE(matcher(pts, rtl::RigidTf2f(0.0f, 0.5f, 0.0f)));
+    EXPECT_NEAR(matcher.transformation().rotAngle(), pose.rotAngle(), 1e-3f);
+    EXPECT_NEAR(matcher.transformation().trVecY(), pose.trVecY(), 1e-2f);
+    EXPECT_TRUE(std::isfinite(matcher.transformation().trVecX()));
+
+    rtl::ScanMatcherPointToLine2D<float> empty;
+    EXPECT_FALSE(empty(pts));
+    EXPECT_EQ(empty.correspondences(), 0u);
+}
@@ -0,0 +1,82 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+#include "rtl/Core.h"
+
+template<typename T, size_t alignment>
+bool isAligned(const T *p)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+TEST(t_aligned_allocator, vectors)
+{
+    for (size_t n : {1, 3, 17, 1000})
+    {
+        rtl::AlignedVector<float> vf(n);
+        rtl::AlignedVector<double> vd(n);
+        ASSERT_TRUE((isAligned<float, rtl::C_SIMD_ALIGNMENT>(vf.data())));
+        ASSERT_TRUE((isAligned<double, rtl::C_SIMD_ALIGNMENT>(vd.data())));
+        vf.resize(3 * n + 1);
+        ASSERT_TRUE((isAligned<float, rtl::C_SIMD_ALIGNMENT>(vf.data())));
+    }
+
+    std::vector<rtl::Vector3f, rtl::AlignedAllocator<rtl::Vector3f, 16>> pts(5, rtl::Vector3f(1, 2, 3));
+    ASSERT_TRUE((isAligned<rtl::Vector3f, 16>(pts.data())));
+    ASSERT_EQ(pts[4], rtl::Vector3f(1, 2, 3));
+    ASSERT_EQ((rtl::AlignedAllocator<char, 128>::alignmentBytes()), 128u);
+
+    ASSERT_EQ(rtl::alignedCount<float>(0), 0u);
+    ASSERT_EQ(rtl::alignedCount<float>(1), 16u);
+    ASSERT_EQ(rtl::alignedCount<float>(16), 16u);
+    ASSERT_EQ(rtl::alignedCount<double>(9), 16u);
+}
+
+TEST(t_aligned_allocator, padded_containers)
+{
+    rtl::PointCloud3f pc;
+    for (int i = 0; i < 1000; i++)
+        pc.addPoint(rtl::Vector3f((float) i, 0, 0));
+    ASSERT_EQ(pc.capacity() % rtl::alignedCount<float>(1), 0u);
+    for (size_t d = 1; d < 3; d++)
+        ASSERT_EQ((pc.coordData(d) - pc.coordData(0)) % rtl::alignedCount<float>(1), 0);
+    ASSERT_EQ(pc.size(), 1000u);
+    ASSERT_EQ(pc.getPoint(999), rtl::Vector3f(999, 0, 0));
+
+    rtl::QuaternionArrayd qa(5);
+    ASSERT_EQ(qa.size(), 5u);
+    ASSERT_EQ(qa.capacity() % rtl::alignedCount<double>(1), 0u);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
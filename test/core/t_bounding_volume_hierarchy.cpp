@@ -0,0 +1,206 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "rtl/Core.h"
+
+typedef rtl::BoundingVolumeHierarchy3D<double, int> BVH3d;
+
+std::vector<rtl::BoundingBox3d> randomBoxes(size_t n, double range, double size, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> pos(-range, range), ext(0.0, size);
+    std::vector<rtl::BoundingBox3d> boxes;
+    for (size_t i = 0; i < n; i++)
+    {
+        rtl::Vector3d p(pos(gen), pos(gen), pos(gen));
+        boxes.emplace_back(p, p + rtl::Vector3d(ext(gen), ext(gen), ext(gen)));
+    }
+    return boxes;
+}
+
+std::vector<int> payloads(size_t n)
+{
+    std::vector<int> ret(n);
+    for (size_t i = 0; i < n; i++)
+        ret[i] = 10 * (int)i;
+    return ret;
+}
+
+double bruteForceEntry(const rtl::BoundingBox3d &bb, const rtl::Vector3d &o, const rtl::Vector3d &d)
+{
+    double t_min = 0, t_max = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < 3; i++)
+    {
+        if (d[i] == 0)
+        {
+            if (o[i] < bb.min()[i] || o[i] > bb.max()[i])
+                return std::numeric_limits<double>::infinity();
+            continue;
+        }
+        double t1 = (bb.min()[i] - o[i]) / d[i], t2 = (bb.max()[i] - o[i]) / d[i];
+        t_min = std::max(t_min, std::min(t1, t2));
+        t_max = std::min(t_max, std::max(t1, t2));
+    }
+    return t_min <= t_max ? t_min : std::numeric_limits<double>::infinity();
+}
+
+TEST(t_bounding_volume_hierarchy, empty)
+{
+    BVH3d bvh;
+    bvh.build({}, {});
+    EXPECT_TRUE(bvh.empty());
+    EXPECT_TRUE(bvh.overlapping(rtl::BoundingBox3d(rtl::Vector3d(0, 0, 0), rtl::Vector3d(1, 1, 1))).empty());
+    EXPECT_TRUE(bvh.selfOverlaps().empty());
+    EXPECT_EQ(bvh.firstHit(rtl::Vector3d(0, 0, 0), rtl::Vector3d(1, 0, 0)).first, 0u);
+    EXPECT_THROW(bvh.build(randomBoxes(3, 1, 1, 0), payloads(2)), std::invalid_argument);
+}
+
+TEST(t_bounding_volume_hierarchy, overlaps)
+{
+    auto boxes = randomBoxes(500, 10, 1.5, 1);
+    BVH3d bvh(boxes, payloads(boxes.size()));
+    EXPECT_EQ(bvh.size(), boxes.size());
+    EXPECT_EQ(bvh.payload(7), 70);
+
+    auto queries = randomBoxes(100, 10, 3, 2);
+    std::vector<std::pair<size_t, size_t>> expected;
+    for (size_t q = 0; q < queries.size(); q++)
+        for (size_t i = 0; i < boxes.size(); i++)
+            if (queries[q].intersects(boxes[i]))
+                expected.emplace_back(q, i);
+    EXPECT_EQ(bvh.overlapping(queries), expected);
+    EXPECT_EQ(bvh.overlapping(queries, rtl::ThreadExecutor(3)), expected);
+
+    std::vector<std::pair<size_t, size_t>> expected_self;
+    for (size_t i = 0; i < boxes.size(); i++)
+        for (size_t j = i + 1; j < boxes.size(); j++)
+            if (boxes[i].intersects(boxes[j]))
+                expected_self.emplace_back(i, j);
+    EXPECT_FALSE(expected_self.empty());
+    EXPECT_EQ(bvh.selfOverlaps(), expected_self);
+    EXPECT_EQ(bvh.selfOverlaps(rtl::ThreadExecutor(4)), expected_self);
+}
+
+TEST(t_bounding_volume_hierarchy, identical_boxes)
+{
+    std::vector<rtl::BoundingBox3d> boxes(50, rtl::BoundingBox3d(rtl::Vector3d(0, 0, 0), rtl::Vector3d(1, 1, 1)));
+    BVH3d bvh(boxes, payloads(boxes.size()));
+    EXPECT_EQ(bvh.selfOverlaps().size(), 50u * 49u / 2u);
+    EXPECT_EQ(bvh.overlapping(rtl::BoundingBox3d(rtl::Vector3d(0.5, 0.5, 0.5))).size(), 50u);
+}
+
+TEST(t_bounding_volume_hierarchy, raycast)
+{
+    auto boxes = randomBoxes(300, 10, 2, 3);
+    BVH3d bvh(boxes, payloads(boxes.size()));
+    std::mt19937 gen(4);
+    std::uniform_real_distribution<double> dist(-12, 12);
+    std::vector<rtl::Vector3d> origins, directions;
+    for (size_t r = 0; r < 200; r++)
+    {
+        origins.emplace_back(dist(gen), dist(gen), dist(gen));
+        directions.emplace_back(dist(gen), dist(gen), r % 10 == 0 ? 0.0 : dist(gen));
+    }
+
+    auto hits = bvh.firstHits(origins, directions, 5.0, rtl::ThreadExecutor(2));
+    size_t hit_nr = 0;
+    for (size_t r = 0; r < origins.size(); r++)
+    {
+        std::pair<size_t, double> best(boxes.size(), 5.0);
+        std::vector<size_t> all;
+        for (size_t i = 0; i < boxes.size(); i++)
+        {
+            double t = bruteForceEntry(boxes[i], origins[r], directions[r]);
+            if (t <= 5.0)
+                all.push_back(i);
+            if (t < best.second || (t == best.second && i < best.first))
+                best = {i, t};
+        }
+        EXPECT_EQ(hits[r].first, best.first);
+        EXPECT_NEAR(hits[r].second, best.second, 1e-9);
+        hit_nr += best.first < boxes.size();
+
+        std::vector<size_t> visited;
+        bvh.raycast(origins[r], directions[r], [&visited](size_t i, double) { visited.push_back(i); }, 5.0);
+        std::sort(visited.begin(), visited.end());
+        EXPECT_EQ(visited, all);
+    }
+    EXPECT_GT(hit_nr, 0u);
+}
+
+TEST(t_bounding_volume_hierarchy, refit)
+{
+    auto boxes = randomBoxes(400, 10, 1.5, 5);
+    BVH3d bvh(boxes, payloads(boxes.size()));
+    auto moved = randomBoxes(400, 10, 1.5, 6);
+    for (size_t i = 0; i < boxes.size(); i += 2)
+    {
+        boxes[i] = moved[i];
+        bvh.update(i, moved[i]);
+    }
+    for (size_t i = 1; i < boxes.size(); i += 2)
+    {
+        boxes[i] = moved[i];
+        bvh.setBox(i, moved[i]);
+    }
+    bvh.refit();
+
+    std::vector<std::pair<size_t, size_t>> expected_self;
+    for (size_t i = 0; i < boxes.size(); i++)
+        for (size_t j = i + 1; j < boxes.size(); j++)
+            if (boxes[i].intersects(boxes[j]))
+                expected_self.emplace_back(i, j);
+    EXPECT_EQ(bvh.selfOverlaps(), expected_self);
+    rtl::BoundingBox3d all = boxes[0];
+    for (const auto &bb : boxes)
+        all.addBoundingBox(bb);
+    for (size_t i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(bvh.bounds().min()[i], all.min()[i]);
+        EXPECT_EQ(bvh.bounds().max()[i], all.max()[i]);
+    }
+}
+
+TEST(t_bounding_volume_hierarchy, plane)
+{
+    std::vector<rtl::BoundingBox2f> boxes;
+    for (int i = 0; i < 20; i++)
+        boxes.emplace_back(rtl::Vector2f((float)i, 0.0f), rtl::Vector2f((float)i + 0.5f, 1.0f));
+    rtl::BoundingVolumeHierarchy2D<float> bvh;
+    bvh.setMaxLeafSize(1);
+    bvh.build(boxes, std::vector<size_t>(boxes.size()));
+    EXPECT_EQ(bvh.nodeNr(), 2 * boxes.size() - 1);
+    auto hit = bvh.firstHit(rtl::Vector2f(-1.0f, 0.5f), rtl::Vector2f(1.0f, 0.0f));
+    EXPECT_EQ(hit.first, 0u);
+    EXPECT_FLOAT_EQ(hit.second, 1.0f);
+    hit = bvh.firstHit(rtl::Vector2f(30.0f, 0.5f), rtl::Vector2f(-1.0f, 0.0f));
+    EXPECT_EQ(hit.first, 19u);
+    EXPECT_FLOAT_EQ(hit.second, 10.5f);
+    EXPECT_EQ(bvh.overlapping(rtl::BoundingBox2f(rtl::Vector2f(2.7f, 0.2f), rtl::Vector2f(5.2f, 0.4f))), std::vector<size_t>({3, 4, 5}));
+}
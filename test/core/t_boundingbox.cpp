@@ -25,6 +25,7 @@
 // Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
 
 #include <gtest/gtest.h>
+#include <random>
 
 #include "rtl/Core.h"
 #include "rtl/Transformation.h"
@@ -102,6 +103,56 @@ TEST(t_boundingbox, add_point) {
     EXPECT_EQ(box.max().getElement(2), 2);
 }
 
+TEST(t_boundingbox, add_points) {
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    for (size_t n : {1, 2, 15, 16, 17, 100, 1001}) {
+        std::vector<rtl::Vector3f> pts(n);
+        for (auto &p : pts)
+            p = rtl::Vector3f(dist(gen), dist(gen), dist(gen));
+
+        rtl::BoundingBox3f ref(pts.front());
+        for (const auto &p : pts)
+            ref.addPoint(p);
+
+        rtl::BoundingBox3f aos(pts);
+        rtl::BoundingBox3f par(pts.front());
+        par.addPoints(rtl::Span<const rtl::Vector3f>(pts), rtl::ThreadExecutor(3));
+        rtl::BoundingBox3f strided(pts.front());
+        strided.addPoints(rtl::StridedSpan<const rtl::Vector3f>(pts.front().data().data(), (n + 1) / 2, 2 * sizeof(rtl::Vector3f)));
+        rtl::PointCloud3f cloud(pts);
+        auto soa = cloud.boundingBox();
+
+        for (const auto &bb : {aos, par, soa}) {
+            EXPECT_EQ(bb.min(), ref.min());
+            EXPECT_EQ(bb.max(), ref.max());
+        }
+        rtl::BoundingBox3f strided_ref(pts.front());
+        for (size_t i = 0; i < n; i += 2)
+            strided_ref.addPoint(pts[i]);
+        EXPECT_EQ(strided.min(), strided_ref.min());
+        EXPECT_EQ(strided.max(), strided_ref.max());
+        rtl::BoundingBox3f dense(pts.front());
+        dense.addPoints(rtl::StridedSpan<const rtl::Vector3f>(rtl::Span<const rtl::Vector3f>(pts)));
+        EXPECT_EQ(dense.min(), ref.min());
+        EXPECT_EQ(dense.max(), ref.max());
+    }
+
+    std::vector<rtl::Vector3f> empty;
+    EXPECT_THROW(rtl::BoundingBox3f{empty}, std::invalid_argument);
+}
+
+TEST(t_boundingbox, all_vertices) {
+
+    auto box = getSmallBox();
+    auto vertices = box.allVertices([](const rtl::Vector3d &v) { return v; });
+    static_assert(std::tuple_size_v<decltype(vertices)> == 8);
+    rtl::BoundingBox3d rebuilt(vertices);
+    EXPECT_EQ(rebuilt.min(), box.min());
+    EXPECT_EQ(rebuilt.max(), box.max());
+}
+
 TEST(t_boundingbox, iou) {
 
     auto box1 = getUnitBox();
@@ -110,6 +161,28 @@ TEST(t_boundingbox, iou) {
     EXPECT_NEAR(box1.intersectionOverUnion(box2), 1.0/15.0, 0.0001);
 }
 
+TEST(t_boundingbox, iou_matrix) {
+
+    std::vector<rtl::BoundingBox3d> rows{getUnitBox(), getSmallBox(), getHugeBox(), getSmallBox2(), rtl::BoundingBox3d(rtl::Vector3d(0.5, 0.5, 0.5))};
+    std::vector<rtl::BoundingBox3d> cols{getSmallBox2(), getHugeBox(), getUnitBox(), rtl::BoundingBox3d(rtl::Vector3d(1, -1, 0), rtl::Vector3d(2, 1, 1))};
+
+    auto iou = rtl::BoundingBox3d::iouMatrix(rows, cols);
+    ASSERT_EQ(iou.data().rows(), 5);
+    ASSERT_EQ(iou.data().cols(), 4);
+    for (size_t r = 0; r < rows.size(); r++)
+        for (size_t c = 0; c < cols.size(); c++)
+            EXPECT_NEAR(iou.getElement(r, c), rows[r].intersectionOverUnion(cols[c]), 1e-12);
+    EXPECT_NEAR(iou.getElement(0, 1), 1.0 / 15.0, 1e-12);
+    EXPECT_EQ(iou.getElement(0, 3), 0.0);
+    EXPECT_EQ(iou.getElement(4, 2), 0.0);
+
+    rtl::BoundingBox3d::iouMatrix(cols, rows, iou);
+    ASSERT_EQ(iou.data().rows(), 4);
+    EXPECT_EQ(iou.getElement(1, 0), rows[0].intersectionOverUnion(cols[1]));
+    rtl::BoundingBox3d::iouMatrix({}, rows, iou);
+    EXPECT_EQ(iou.data().size(), 0);
+}
+
 TEST(t_boundingbox, transformation) {
 
     auto box = getUnitBox();
@@ -138,6 +211,21 @@ TEST(t_boundingbox, transformation) {
 
 
 
+TEST(t_boundingbox, transformation_batch) {
+
+    rtl::RigidTf3d tf(0.7, rtl::Vector3d(1, 2, 3).normalized(), rtl::Vector3d(-1, 0.5, 4));
+    std::vector<rtl::BoundingBox3d> boxes{getUnitBox(), getSmallBox(), getHugeBox(), getSmallBox2(), rtl::BoundingBox3d(rtl::Vector3d(0.5, 0.5, 0.5))};
+    auto batch = boxes;
+    rtl::BoundingBox3d::transform(batch, tf);
+    for (size_t i = 0; i < boxes.size(); i++) {
+        auto ref = boxes[i].transformed(tf);
+        EXPECT_NEAR(rtl::Vector3d::distance(batch[i].min(), ref.min()), 0, max_err);
+        EXPECT_NEAR(rtl::Vector3d::distance(batch[i].max(), ref.max()), 0, max_err);
+    }
+}
+
+
+
 int main(int argc, char **argv){
 
     testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,126 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "rtl/Core.h"
+#include "rtl/Vectorization.h"
+
+TEST(t_compact_element, fixed_point_conversions)
+{
+    using F = rtl::Fixed16<10>;
+    static_assert(sizeof(F) == 2);
+    static_assert(std::is_same_v<rtl::compute_type_t<F>, float>);
+    static_assert(std::is_same_v<rtl::compute_type_t<rtl::FixedPoint<std::int32_t, 16>>, double>);
+    static_assert(std::is_same_v<rtl::compute_type_t<double>, double>);
+
+    EXPECT_DOUBLE_EQ(F::resolution(), 1.0 / 1024.0);
+    EXPECT_EQ(F(1.5f).raw(), 1536);
+    EXPECT_EQ(F(-1.5).raw(), -1536);
+    EXPECT_EQ(F(0.0004).raw(), 0);
+    EXPECT_EQ(F(0.0006).raw(), 1);
+    EXPECT_EQ(F(100.0f), F::highest());
+    EXPECT_EQ(F(-100.0f), F::lowest());
+    EXPECT_EQ(F(std::numeric_limits<float>::quiet_NaN()).raw(), 0);
+    EXPECT_EQ(rtl::UFixed16<11>(-1.0f).raw(), 0);
+
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> val(-15.0f, 15.0f);
+    for (size_t i = 0; i < 1000; i++)
+    {
+        float a = val(gen), b = val(gen);
+        EXPECT_NEAR((float)F(a), a, 0.5 * F::resolution());
+        EXPECT_NEAR((float)(F(a) - F(b)), (float)F(a) - (float)F(b), 1e-6);
+        EXPECT_EQ(F(a) < F(b), F(a).raw() < F(b).raw());
+    }
+    EXPECT_EQ(F(20.0f) + F(20.0f), F::highest());
+    EXPECT_NEAR((float)(F(1.5f) * F(-2.25f)), -3.375f, F::resolution());
+}
+
+TEST(t_compact_element, compact_vectors)
+{
+    using F = rtl::Fixed16<10>;
+    static_assert(sizeof(rtl::Vector2D<F>) == 2 * sizeof(F));
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<float> val(-15.0f, 15.0f);
+    for (size_t i = 0; i < 1000; i++)
+    {
+        rtl::Vector2f v(val(gen), val(gen)), w(val(gen), val(gen));
+        rtl::Vector2D<F> cv = v.cast<F>(), cw(w.x(), w.y());
+        EXPECT_LE((cv.cast<float>() - v).length(), F::resolution());
+        EXPECT_LE(((cv - cw).cast<float>() - (v - w)).length(), 2.0 * F::resolution());
+    }
+
+#ifdef RTL_HAS_FLOAT16
+    static_assert(sizeof(rtl::Vector3D<rtl::Half>) == 3 * sizeof(rtl::Half));
+    static_assert(std::is_same_v<rtl::compute_type_t<rtl::Half>, float>);
+    for (size_t i = 0; i < 1000; i++)
+    {
+        rtl::Vector3f v(val(gen), val(gen), val(gen));
+        rtl::Vector3D<rtl::Half> h = v.cast<rtl::Half>();
+        EXPECT_LE((h.cast<float>() - v).length(), 3e-2f);
+    }
+#endif
+}
+
+// Scans of a few hundred points stored in compact types give the same line fits as float storage up to the storage resolution.
+template<typename Storage>
+void compactPrecArray(float tolerance)
+{
+    using Compute = rtl::compute_type_t<Storage>;
+    std::mt19937 gen(11);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    std::vector<rtl::Vector2f> pts;
+    for (size_t i = 0; i < 400; i++)
+        pts.emplace_back(5.0f + 0.02f * (float)i, -3.0f + 0.01f * (float)i + noise(gen));
+    std::vector<rtl::Vector2D<Storage>> compact;
+    for (const auto &p : pts)
+        compact.push_back(p.cast<Storage>());
+
+    rtl::PrecArray2D<float, float> reference;
+    rtl::PrecArray2D<Storage, Compute> stored;
+    reference.setCenteredBlocks(64);
+    stored.setCenteredBlocks(64);
+    reference.precompute(pts);
+    stored.precompute(compact);
+    ASSERT_EQ(stored.size(), reference.size());
+    for (size_t beg = 0; beg + 50 < pts.size(); beg += 37)
+    {
+        rtl::ApproximationTlsLine2D<float, Compute> l_ref(reference.sums(beg, beg + 50)), l_stored(stored.sums(beg, beg + 50));
+        EXPECT_NEAR(std::sqrt(l_ref.errSquared()), std::sqrt(l_stored.errSquared()), tolerance);
+        EXPECT_NEAR(l_ref.c(), l_stored.c(), tolerance);
+        EXPECT_NEAR(std::abs(l_ref.normal().dot(l_stored.normal())), 1.0f, tolerance);
+    }
+}
+
+TEST(t_compact_element, compact_prec_array)
+{
+    compactPrecArray<rtl::Fixed16<10>>(2e-3f);
+#ifdef RTL_HAS_FLOAT16
+    compactPrecArray<rtl::Half>(2e-2f);
+#endif
+}
@@ -0,0 +1,81 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "rtl/Core.h"
+
+TEST(t_executor, repeated_calls)
+{
+    rtl::ThreadExecutor exec(4);
+    std::vector<int> hits(1000, 0);
+    for (size_t r = 0; r < 50; r++)
+        exec(0, hits.size(), [&hits](size_t b, size_t e) { for (size_t i = b; i < e; i++) hits[i]++; });
+    for (auto h : hits)
+        ASSERT_EQ(h, 50);
+
+    rtl::ThreadExecutor copy = exec;
+    std::atomic<size_t> sum{0};
+    copy(0, 3, [&sum](size_t b, size_t e) { sum += e - b; });
+    ASSERT_EQ(sum, 3);
+}
+
+TEST(t_executor, nested_calls)
+{
+    rtl::ThreadExecutor exec(4);
+    std::atomic<size_t> sum{0};
+    exec(0, 8, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; i++)
+            exec(0, 100, [&sum](size_t ib, size_t ie) { sum += ie - ib; });
+    });
+    ASSERT_EQ(sum, 800);
+}
+
+TEST(t_executor, exceptions)
+{
+    rtl::ThreadExecutor exec(4);
+    for (size_t thrower = 0; thrower < 4; thrower++)
+    {
+        std::atomic<size_t> processed{0};
+        auto func = [&processed, thrower](size_t b, size_t e)
+        {
+            processed += e - b;
+            if (b == thrower * 25)
+                throw std::runtime_error("sub-range failed");
+        };
+        ASSERT_THROW(exec(0, 100, func), std::runtime_error);
+        ASSERT_EQ(processed, 100);
+    }
+
+    std::atomic<size_t> sum{0};
+    exec(0, 100, [&sum](size_t b, size_t e) { sum += e - b; });
+    ASSERT_EQ(sum, 100);
+}
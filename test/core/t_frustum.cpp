@@ -295,6 +295,96 @@ TEST(t_frustum, transformation_tf) {
     EXPECT_NEAR(transformedFrustum.getFarBottomRight().z(), -1 * scale, max_err);
 }
 
+TEST(t_frustum, transformation_batch) {
+    using V = rtl::Frustum3D<double>::VectorType;
+
+    rtl::RigidTf3d tf{0.3, -1.2, 2.1, V{2, -3, 0.5}};
+    std::vector<rtl::Frustum3D<double>> frustums;
+    for (int i = 0; i < 5; i++)
+        frustums.emplace_back(V{(double)i, 0, 0}, V{10.0 + i, 1, 1}, V{10.0 + i, -1, 1}, V{10.0 + i, 1, -1}, V{10.0 + i, -1, -1}, 1 + i);
+    auto batch = frustums;
+    rtl::Frustum3D<double>::transform(batch, tf);
+
+    for (size_t i = 0; i < frustums.size(); i++) {
+        auto ref = frustums[i].transformed(tf);
+        EXPECT_NEAR(V::distance(batch[i].getOrigin(), ref.getOrigin()), 0, max_err);
+        EXPECT_NEAR(V::distance(batch[i].getNearTopLeft(), ref.getNearTopLeft()), 0, max_err);
+        EXPECT_NEAR(V::distance(batch[i].getNearBottomRight(), ref.getNearBottomRight()), 0, max_err);
+        EXPECT_NEAR(V::distance(batch[i].getFarTopRight(), ref.getFarTopRight()), 0, max_err);
+        for (size_t j = 0; j < 6; j++) {
+            EXPECT_NEAR(V::distance(batch[i].getPlaneNormal(j), ref.getPlaneNormal(j)), 0, max_err);
+            EXPECT_NEAR(batch[i].getPlaneOffset(j), ref.getPlaneOffset(j), max_err);
+        }
+    }
+}
+
+TEST(t_frustum, contains) {
+
+    using V = rtl::Frustum3D<double>::VectorType;
+
+    rtl::Frustum3D<double> frustum(V{0,0,0}, V{10,1,1}, V{10,-1,1}, V{10,1,-1}, V{10,-1,-1}, 1);
+
+    EXPECT_TRUE(frustum.contains(V{10.5, 0, 0}));
+    EXPECT_TRUE(frustum.contains(V{10, 1, 1}));
+    EXPECT_TRUE(frustum.contains(V{10.5, 1.04, -1.04}));
+    EXPECT_FALSE(frustum.contains(V{9.9, 0, 0}));
+    EXPECT_FALSE(frustum.contains(V{11.1, 0, 0}));
+    EXPECT_FALSE(frustum.contains(V{10.5, 1.06, 0}));
+    EXPECT_FALSE(frustum.contains(V{10.5, 0, -1.06}));
+
+    for (size_t i = 0; i < 6; i++) {
+        EXPECT_NEAR(frustum.getPlaneNormal(i).length(), 1.0, max_err);
+        EXPECT_GT(frustum.getPlaneNormal(i).dot(V{10.5, 0, 0}) + frustum.getPlaneOffset(i), 0);
+    }
+
+    rtl::RigidTf3d tf(rtl::C_PId / 3, V{0.3, 0.2, 1}.normalized(), V{5, -2, 1});
+    auto transformed = frustum.transformed(tf);
+    std::vector<V> pts;
+    // the grid avoids the boundary of the frustum, where the results might differ due to rounding
+    for (double x = 9.55; x < 11.5; x += 0.1)
+        for (double y = -1.45; y < 1.5; y += 0.1)
+            for (double z = -1.5; z < 1.5; z += 0.13)
+                pts.push_back(tf(V{x, y, z}));
+
+    std::vector<uint64_t> mask, mask_pc;
+    transformed.contains(pts, mask);
+    transformed.contains(rtl::PointCloud3d(pts), mask_pc);
+    ASSERT_EQ(mask.size(), (pts.size() + 63) / 64);
+    EXPECT_EQ(mask, mask_pc);
+    size_t inside = 0;
+    for (size_t i = 0; i < pts.size(); i++) {
+        bool in = (mask[i / 64] >> (i % 64)) & 1u;
+        EXPECT_EQ(in, transformed.contains(pts[i]));
+        EXPECT_EQ(in, frustum.contains(tf.inverted()(pts[i])));
+        inside += in;
+    }
+    EXPECT_GT(inside, 0);
+    EXPECT_LT(inside, pts.size());
+}
+
+TEST(t_frustum, intersects) {
+
+    using V = rtl::Frustum3D<double>::VectorType;
+
+    rtl::Frustum3D<double> frustum(V{0,0,0}, V{10,1,1}, V{10,-1,1}, V{10,1,-1}, V{10,-1,-1}, 1);
+
+    std::vector<rtl::BoundingBox3d> boxes{rtl::BoundingBox3d(V{10.2, -0.1, -0.1}, V{10.4, 0.1, 0.1}),
+                                          rtl::BoundingBox3d(V{8, -5, -5}, V{12, 5, 5}),
+                                          rtl::BoundingBox3d(V{10.5, 0.9, 0.9}, V{12, 3, 3}),
+                                          rtl::BoundingBox3d(V{8, -1, -1}, V{9.9, 1, 1}),
+                                          rtl::BoundingBox3d(V{10, 1.2, -1}, V{11, 2, 1}),
+                                          rtl::BoundingBox3d(V{0, 0, 0}, V{0, 0, 0})};
+    std::vector<bool> expected{true, true, true, false, false, false};
+
+    std::vector<uint64_t> mask;
+    frustum.intersects(boxes, mask);
+    ASSERT_EQ(mask.size(), 1);
+    for (size_t i = 0; i < boxes.size(); i++) {
+        EXPECT_EQ(frustum.intersects(boxes[i]), expected[i]);
+        EXPECT_EQ(bool((mask[0] >> i) & 1u), expected[i]);
+    }
+}
+
 int main(int argc, char **argv){
 
     testing::InitGoogleTest(&argc, argv);
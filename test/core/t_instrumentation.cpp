@@ -0,0 +1,106 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#define RTL_INSTRUMENTATION
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "rtl/Core.h"
+#include "rtl/Algorithms.h"
+
+TEST(t_instrumentation, zones_and_counters)
+{
+    rtl::instrumentation::HistogramSink sink;
+    rtl::instrumentation::setSink(&sink);
+
+    for (int i = 0; i < 10; i++)
+    {
+        RTL_ZONE("test::outer");
+        RTL_COUNT("test::counter", i);
+    }
+
+    auto zones = sink.zoneStats();
+    auto counters = sink.counterStats();
+    ASSERT_EQ(zones.count("test::outer"), 1);
+    ASSERT_EQ(zones["test::outer"].calls, 10);
+    ASSERT_LE(zones["test::outer"].min, zones["test::outer"].max);
+    ASSERT_LE(zones["test::outer"].quantile(0.5), zones["test::outer"].quantile(1.0));
+    ASSERT_EQ(counters["test::counter"].calls, 10);
+    ASSERT_EQ(counters["test::counter"].total, 45);
+    ASSERT_EQ(counters["test::counter"].min, 0);
+    ASSERT_EQ(counters["test::counter"].max, 9);
+
+    sink.clear();
+    rtl::instrumentation::setSink(nullptr);
+    {
+        RTL_ZONE("test::disabled");
+        RTL_COUNT("test::disabled", 1);
+    }
+    ASSERT_TRUE(sink.zoneStats().empty());
+    ASSERT_TRUE(sink.counterStats().empty());
+}
+
+TEST(t_instrumentation, algorithm_zones)
+{
+    rtl::instrumentation::HistogramSink sink;
+    rtl::instrumentation::setSink(&sink);
+
+    auto cost_matrix = rtl::Matrix<3, 3, size_t>::zeros();
+    cost_matrix.setRow(0, rtl::VectorND<3, size_t>{1, 2, 3});
+    cost_matrix.setRow(1, rtl::VectorND<3, size_t>{2, 4, 6});
+    cost_matrix.setRow(2, rtl::VectorND<3, size_t>{3, 6, 9});
+    (void) rtl::Munkres<size_t, 3>::solve(cost_matrix);
+    (void) rtl::Munkres<size_t, 3>::solve(cost_matrix);
+
+    rtl::instrumentation::setSink(nullptr);
+    auto zones = sink.zoneStats();
+    ASSERT_EQ(zones["rtl::Munkres::solve"].calls, 2);
+}
+
+TEST(t_instrumentation, concurrent_reporting)
+{
+    rtl::instrumentation::HistogramSink sink;
+    rtl::instrumentation::setSink(&sink);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([]() {
+            for (int i = 0; i < 1000; i++)
+            {
+                RTL_ZONE("test::thread");
+                RTL_COUNT("test::thread", 1);
+            }
+        });
+    for (auto &t : threads)
+        t.join();
+
+    rtl::instrumentation::setSink(nullptr);
+    ASSERT_EQ(sink.zoneStats()["test::thread"].calls, 4000);
+    ASSERT_EQ(sink.counterStats()["test::thread"].total, 4000);
+}
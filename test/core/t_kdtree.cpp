@@ -0,0 +1,153 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "rtl/Core.h"
+
+typedef rtl::KdTreeND<3, double> KdTree3d;
+typedef KdTree3d::ResultType Result;
+
+std::vector<rtl::Vector3d> randomPoints(size_t n, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> pos(-10, 10);
+    std::vector<rtl::Vector3d> pts;
+    for (size_t i = 0; i < n; i++)
+        pts.emplace_back(pos(gen), pos(gen), pos(gen));
+    return pts;
+}
+
+std::vector<Result> bruteForce(const std::vector<rtl::Vector3d> &pts, const rtl::Vector3d &q)
+{
+    std::vector<Result> ret;
+    for (size_t i = 0; i < pts.size(); i++)
+        ret.emplace_back(i, rtl::Vector3d::distanceSquared(q, pts[i]));
+    std::sort(ret.begin(), ret.end(), [](const Result &a, const Result &b) { return a.second < b.second || (a.second == b.second && a.first < b.first); });
+    return ret;
+}
+
+void checkQueries(const KdTree3d &tree, const std::vector<rtl::Vector3d> &pts, unsigned seed)
+{
+    for (const auto &q : randomPoints(50, seed))
+    {
+        auto expected = bruteForce(pts, q);
+        EXPECT_EQ(tree.nearest(q), expected.front());
+
+        auto knn = tree.kNearest(q, 7);
+        ASSERT_EQ(knn.size(), std::min<size_t>(7, pts.size()));
+        for (size_t i = 0; i < knn.size(); i++)
+            EXPECT_EQ(knn[i], expected[i]);
+
+        auto rs = tree.radiusSearch(q, 4.0);
+        size_t in_radius = 0;
+        while (in_radius < expected.size() && expected[in_radius].second <= 16.0)
+            in_radius++;
+        EXPECT_EQ(rs, std::vector<Result>(expected.begin(), expected.begin() + in_radius));
+    }
+}
+
+TEST(t_kdtree, empty)
+{
+    KdTree3d tree;
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.nearest(rtl::Vector3d(0, 0, 0)).first, 0u);
+    EXPECT_TRUE(tree.kNearest(rtl::Vector3d(0, 0, 0), 3).empty());
+    EXPECT_TRUE(tree.radiusSearch(rtl::Vector3d(0, 0, 0), 1.0).empty());
+}
+
+TEST(t_kdtree, build)
+{
+    auto pts = randomPoints(2000, 1);
+    KdTree3d tree(pts);
+    EXPECT_EQ(tree.size(), pts.size());
+    EXPECT_EQ(tree.treeNr(), 1u);
+    checkQueries(tree, pts, 2);
+}
+
+TEST(t_kdtree, insert)
+{
+    auto pts = randomPoints(1500, 3);
+    KdTree3d tree(std::vector<rtl::Vector3d>(pts.begin(), pts.begin() + 500));
+    for (size_t i = 500; i < 1000; i++)
+        tree.insert(pts[i]);
+    tree.insert(std::vector<rtl::Vector3d>(pts.begin() + 1000, pts.end()));
+    EXPECT_EQ(tree.size(), pts.size());
+    EXPECT_LT(tree.treeNr(), 12u);
+    EXPECT_EQ(tree.point(1234), pts[1234]);
+    checkQueries(tree, pts, 4);
+
+    KdTree3d incremental;
+    incremental.setLeafSize(3);
+    for (size_t i = 0; i < 100; i++)
+        incremental.insert(pts[i]);
+    checkQueries(incremental, std::vector<rtl::Vector3d>(pts.begin(), pts.begin() + 100), 5);
+}
+
+TEST(t_kdtree, duplicates)
+{
+    std::vector<rtl::Vector3d> pts(100, rtl::Vector3d(1, 2, 3));
+    pts.emplace_back(0, 0, 0);
+    KdTree3d tree(pts);
+    auto knn = tree.kNearest(rtl::Vector3d(1, 2, 3.5), 5);
+    ASSERT_EQ(knn.size(), 5u);
+    for (size_t i = 0; i < 5; i++)
+        EXPECT_EQ(knn[i].first, i);
+    EXPECT_EQ(tree.nearest(rtl::Vector3d(-1, 0, 0)).first, 100u);
+    EXPECT_EQ(tree.radiusSearch(rtl::Vector3d(1, 2, 3), 0.0).size(), 100u);
+}
+
+TEST(t_kdtree, batch)
+{
+    auto pts = randomPoints(3000, 6);
+    auto queries = randomPoints(200, 7);
+    KdTree3d tree(pts);
+
+    auto nn = tree.nearest(queries, rtl::ThreadExecutor(3));
+    auto knn = tree.kNearest(queries, 4, rtl::ThreadExecutor(3));
+    auto rs = tree.radiusSearch(queries, 2.0, rtl::ThreadExecutor(3));
+    ASSERT_EQ(nn.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+        EXPECT_EQ(nn[i], tree.nearest(queries[i]));
+        EXPECT_EQ(knn[i], tree.kNearest(queries[i], 4));
+        EXPECT_EQ(rs[i], tree.radiusSearch(queries[i], 2.0));
+    }
+}
+
+TEST(t_kdtree, plane)
+{
+    std::vector<rtl::Vector2f> pts;
+    for (int x = 0; x < 10; x++)
+        for (int y = 0; y < 10; y++)
+            pts.emplace_back((float)x, (float)y);
+    rtl::KdTreeND<2, float> tree(pts);
+    auto nn = tree.nearest(rtl::Vector2f(3.2f, 6.9f));
+    EXPECT_EQ(nn.first, 37u);
+    EXPECT_NEAR(nn.second, 0.05f, 1e-5f);
+    EXPECT_EQ(tree.radiusSearch(rtl::Vector2f(5.0f, 5.0f), 1.0f).size(), 5u);
+}
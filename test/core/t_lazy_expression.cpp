@@ -0,0 +1,128 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <type_traits>
+
+#include "rtl/Core.h"
+#include "rtl/Transformation.h"
+#include "rtl/Test.h"
+
+template<int dim, typename E>
+struct TesterLazyVector
+{
+    static void testFunction(size_t repeat)
+    {
+        using V = rtl::VectorND<dim, E>;
+        using M = rtl::Matrix<dim, dim, E>;
+        std::cout << "\n" << rtl::test::type<V>::description() << " lazy expression test:" << std::endl;
+
+        auto el_gen = rtl::test::Random::uniformCallable<E>((E)-1, (E)1);
+        E eps = rtl::test::type<V>::allowedError();
+        for (size_t i = 0; i < repeat; i++)
+        {
+            V a = V::random(el_gen), b = V::random(el_gen), c = V::random(el_gen);
+            M m = M::random(el_gen);
+            E s = el_gen();
+
+            static_assert(!std::is_same_v<decltype(rtl::lazy(a) + rtl::lazy(b) * s - c), V>, "Lazy expression must not be evaluated by operators.");
+            V lazy_res = rtl::lazy(a) + rtl::lazy(b) * s - c;
+            ASSERT_LT(V::distance(lazy_res, a + b * s - c), eps);
+
+            // Temporary operands are owned by the expression.
+            auto owning = rtl::lazy(a) + b * s - c;
+            V owning_res = owning;
+            ASSERT_LT(V::distance(owning_res, a + b * s - c), eps);
+
+            V neg = -(rtl::lazy(a) / s) + c;
+            ASSERT_LT(V::distance(neg, c - a / s), eps);
+
+            V prod = m * rtl::lazy(a) + s * rtl::lazy(b);
+            ASSERT_LT(V::distance(prod, m * a + b * s), eps);
+
+            ASSERT_NEAR((rtl::lazy(a) - b).lengthSquared(), (a - b).lengthSquared(), eps);
+            ASSERT_NEAR((rtl::lazy(a) - b).length(), (a - b).length(), eps);
+            ASSERT_NEAR((rtl::lazy(a) + b).dot(rtl::lazy(c) * s), (a + b).dot(c * s), eps);
+
+            // Assignment to an operand of the expression.
+            V d = a;
+            d = rtl::lazy(m) * d + d;
+            ASSERT_LT(V::distance(d, m * a + a), eps);
+
+            M mm = rtl::lazy(m) * m - m * s;
+            ASSERT_LT((mm - (m * m - m * s)).data().norm(), eps);
+        }
+    }
+};
+
+template<int dim, typename E>
+struct TesterLazyGeometry
+{
+    static void testFunction(size_t repeat)
+    {
+        using V = rtl::VectorND<dim, E>;
+        using LS = rtl::LineSegmentND<dim, E>;
+        std::cout << "\n" << rtl::test::type<LS>::description() << " lazy geometry test:" << std::endl;
+
+        auto el_gen = rtl::test::Random::uniformCallable<E>((E)-1, (E)1);
+        E eps = rtl::test::type<V>::allowedError();
+        for (size_t i = 0; i < repeat; i++)
+        {
+            LS ls = LS::random(el_gen);
+            V p = V::random(el_gen);
+            V dif = ls.beg() - p;
+            V ref = dif - ls.direction() * dif.dot(ls.direction());
+            ASSERT_NEAR(ls.distanceToPointSquared(p), ref.lengthSquared(), eps);
+            ASSERT_NEAR(ls.distanceToPoint(p), ref.length(), eps);
+            ASSERT_LT(V::distance(ls.vectorProjection(p), ls.beg() + ls.direction() * ls.direction().dot(p - ls.beg())), eps);
+
+            auto tf = rtl::RigidTfND<dim, E>::random(el_gen);
+            V tf_ref(typename V::EigenType(tf.rotMat().data() * p.data() + tf.trVec().data()));
+            ASSERT_LT(V::distance(p.transformed(tf), tf_ref), eps);
+            p.transform(tf);
+            ASSERT_LT(V::distance(p, tf_ref), eps);
+        }
+    }
+};
+
+TEST(t_lazy_expression, vector_and_matrix)
+{
+    size_t repeat = 100;
+    rtl::test::RangeTypes<TesterLazyVector, 1, 5, float, double> t(repeat);
+}
+
+TEST(t_lazy_expression, geometry)
+{
+    size_t repeat = 100;
+    rtl::test::RangeTypes<TesterLazyGeometry, 2, 4, float, double> t(repeat);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,221 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include "rtl/Core.h"
+#include "rtl/Transformation.h"
+#include "rtl/Test.h"
+
+template<int dim, typename E>
+E pointSegmentReference(const rtl::LineSegmentND<dim, E> &ls, const rtl::VectorND<dim, E> &p)
+{
+    E t = std::clamp(ls.scalarProjectionUnit(p), (E)0, ls.length());
+    return rtl::VectorND<dim, E>::distanceSquared(ls.beg() + ls.direction() * t, p);
+}
+
+template<int dim, typename E>
+E segmentSegmentReference(const rtl::LineSegmentND<dim, E> &l1, const rtl::LineSegmentND<dim, E> &l2)
+{
+    E ret = std::min({pointSegmentReference(l1, l2.beg()), pointSegmentReference(l1, l2.end()), pointSegmentReference(l2, l1.beg()), pointSegmentReference(l2, l1.end())});
+    E t1, t2;
+    if (rtl::LineSegmentND<dim, E>::closestPoint(l1, l2, t1, t2) && t1 > 0 && t1 < 1 && t2 > 0 && t2 < 1)
+    {
+        auto p1 = l1.beg() + (l1.end() - l1.beg()) * t1, p2 = l2.beg() + (l2.end() - l2.beg()) * t2;
+        ret = std::min(ret, rtl::VectorND<dim, E>::distanceSquared(p1, p2));
+    }
+    return ret;
+}
+
+template<int dim, typename E>
+struct TesterLineSegmentArray
+{
+    static void testFunction(size_t seg_nr)
+    {
+        using V = rtl::VectorND<dim, E>;
+        using LS = rtl::LineSegmentND<dim, E>;
+        using LSA = rtl::LineSegmentArrayND<dim, E>;
+        std::cout << "\n" << rtl::test::type<LS>::description() << " array test:" << std::endl;
+
+        auto el_gen = rtl::test::Random::uniformCallable<E>((E)-10, (E)10);
+        auto small_gen = rtl::test::Random::uniformCallable<E>((E)-1, (E)1);
+        std::vector<LS> segments;
+        for (size_t i = 0; i < seg_nr; i++)
+        {
+            V beg = V::random(el_gen);
+            segments.emplace_back(beg, beg + V::random(small_gen));
+        }
+        segments.emplace_back(V::ones(), V::ones());    // degenerate segment
+        LSA lsa(segments);
+        ASSERT_EQ(lsa.size(), segments.size());
+        ASSERT_LT(LS::VectorType::distance(lsa.getSegment(3).end(), segments[3].end()), 100 * rtl::test::type<V>::allowedError());
+
+        E eps = 100 * rtl::test::type<V>::allowedError();
+        std::vector<E> dists;
+        std::vector<V> points;
+        std::vector<LS> queries;
+        for (size_t q = 0; q < 20; q++)
+        {
+            V p = V::random(el_gen);
+            points.push_back(p);
+            lsa.distancesSquared(p, dists);
+            ASSERT_EQ(dists.size(), segments.size());
+            size_t best = 0;
+            for (size_t i = 0; i < segments.size(); i++)
+            {
+                E ref = pointSegmentReference(segments[i], p);
+                if (i + 1 == segments.size())
+                    ref = V::distanceSquared(V::ones(), p);
+                ASSERT_NEAR(dists[i], ref, eps * (1 + ref));
+                if (dists[i] < dists[best])
+                    best = i;
+            }
+            ASSERT_EQ(lsa.closestSegment(p).first, best);
+
+            LS ls(p, p + V::random(el_gen));
+            queries.push_back(ls);
+            lsa.distancesSquared(ls, dists);
+            for (size_t i = 0; i + 1 < segments.size(); i++)
+            {
+                E ref = segmentSegmentReference(segments[i], ls);
+                ASSERT_NEAR(dists[i], ref, eps * (1 + ref));
+            }
+        }
+
+        auto scan_pts = lsa.closestSegments(points);
+        auto scan_ls = lsa.closestSegments(queries);
+        E radius = 3;
+        auto gated_pts = lsa.closestSegments(points, radius);
+        lsa.buildIndex();
+        ASSERT_TRUE(lsa.indexed());
+        auto indexed_pts = lsa.closestSegments(points, radius);
+        auto indexed_ls = lsa.closestSegments(queries, radius);
+        for (size_t q = 0; q < points.size(); q++)
+        {
+            ASSERT_EQ(gated_pts[q], indexed_pts[q]);
+            if (scan_pts[q].second <= radius * radius)
+                ASSERT_EQ(indexed_pts[q], scan_pts[q]);
+            else
+                ASSERT_EQ(indexed_pts[q].first, lsa.size());
+            if (scan_ls[q].second <= radius * radius)
+                ASSERT_NEAR(indexed_ls[q].second, scan_ls[q].second, eps);
+            else
+                ASSERT_EQ(indexed_ls[q].first, lsa.size());
+        }
+
+        V c1 = V::random(el_gen), c2 = V::random(el_gen);
+        std::vector<size_t> indices;
+        std::vector<E> beg_t, end_t;
+        size_t survived = lsa.cropByHyperRect(c1, c2, indices, beg_t, end_t);
+        ASSERT_EQ(survived, indices.size());
+        size_t k = 0;
+        for (size_t i = 0; i + 1 < segments.size(); i++)
+        {
+            E l_beg = 0, l_end = 0;
+            bool ref = segments[i].cropByHyperRect(c1, c2, l_beg, l_end);
+            if (ref)
+            {
+                l_beg = std::max(l_beg, (E)0);
+                l_end = std::min(l_end, segments[i].length());
+                ref = l_beg <= l_end;
+            }
+            if (ref && l_end - l_beg < eps)
+            {
+                // touching segments are allowed to go either way
+                k += k < indices.size() && indices[k] == i;
+                continue;
+            }
+            ASSERT_EQ(k < indices.size() && indices[k] == i, ref);
+            if (ref)
+            {
+                ASSERT_NEAR(beg_t[k], l_beg, eps * (1 + std::abs(l_beg)));
+                ASSERT_NEAR(end_t[k], l_end, eps * (1 + std::abs(l_end)));
+                k++;
+            }
+        }
+
+        LSA fitted = lsa;
+        fitted.fitToHyperRect(c1, c2);
+        ASSERT_EQ(fitted.size(), survived);
+        for (size_t i = 0; i < survived; i++)
+        {
+            LS ref = lsa.getSegment(indices[i]);
+            auto ref_beg = ref.beg() + ref.direction() * beg_t[i], ref_end = ref.beg() + ref.direction() * end_t[i];
+            ASSERT_LT(V::distance(fitted.getSegment(i).beg(), ref_beg), eps * 10);
+            ASSERT_LT(V::distance(fitted.getSegment(i).end(), ref_end), eps * 10);
+        }
+
+        LSA axis;
+        V b = V::zeros(), e = V::zeros();
+        e[0] = 4;
+        axis.addSegment(LS(b, e));
+        b[dim - 1] = e[dim - 1] = 2;
+        axis.addSegment(LS(b, e));
+        axis.cropByHyperRect(V::ones(), V::ones() * -1, indices, beg_t, end_t);
+        ASSERT_EQ(indices.size(), 1u);
+        ASSERT_EQ(indices[0], 0u);
+        ASSERT_NEAR(beg_t[0], (E)0, eps);
+        ASSERT_NEAR(end_t[0], (E)1, eps);
+
+        lsa.setSegment(0, segments[1]);
+        ASSERT_FALSE(lsa.indexed());
+        lsa.clear();
+        ASSERT_EQ(lsa.closestSegment(points[0]).first, 0u);
+    }
+};
+
+TEST(t_line_segment_array, general_test)
+{
+    size_t seg_nr = 500;
+    rtl::test::RangeTypes<TesterLineSegmentArray, 2, 4, float, double> t(seg_nr);
+}
+
+TEST(t_line_segment_array, batch_transformation)
+{
+    auto el_gen = rtl::test::Random::uniformCallable<double>(-10.0, 10.0);
+    std::vector<rtl::LineSegment3d> segments;
+    for (size_t i = 0; i < 100; i++)
+        segments.push_back(rtl::LineSegment3d::random(el_gen));
+    auto tf = rtl::RigidTf3d::random(el_gen);
+    auto batch = segments;
+    rtl::LineSegment3d::transform(batch, tf);
+    for (size_t i = 0; i < segments.size(); i++)
+    {
+        auto ref = segments[i].transformed(tf);
+        ASSERT_NEAR(rtl::Vector3d::distance(batch[i].beg(), ref.beg()), 0.0, 1e-9);
+        ASSERT_NEAR(rtl::Vector3d::distance(batch[i].end(), ref.end()), 0.0, 1e-9);
+        ASSERT_NEAR(rtl::Vector3d::distance(batch[i].direction(), ref.direction()), 0.0, 1e-9);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,137 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "rtl/Core.h"
+
+std::vector<rtl::LineSegment2d> randomSegments(size_t n, double range, double length, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> pos(-range, range), len(0.0, length), ang(0.0, 2.0 * rtl::C_PI<double>);
+    std::vector<rtl::LineSegment2d> segments;
+    for (size_t i = 0; i < n; i++)
+    {
+        rtl::Vector2d beg(pos(gen), pos(gen));
+        double l = len(gen), a = ang(gen);
+        if (i % 10 == 0)
+            a = 0.0;    // axis parallel segments
+        segments.emplace_back(beg, rtl::Vector2d(beg.x() + l * std::cos(a), beg.y() + l * std::sin(a)));
+    }
+    return segments;
+}
+
+double distance(const rtl::LineSegment2d &s, const rtl::Vector2d &pt)
+{
+    return std::sqrt(s.segmentDistanceToPointSquared(pt));
+}
+
+std::vector<rtl::Vector2d> randomPoints(size_t n, double range, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> pos(-range, range);
+    std::vector<rtl::Vector2d> pts;
+    for (size_t i = 0; i < n; i++)
+        pts.emplace_back(pos(gen), pos(gen));
+    return pts;
+}
+
+TEST(t_line_segment_grid, radius_query)
+{
+    auto segments = randomSegments(500, 50.0, 8.0, 1);
+    rtl::LineSegmentGrid2d grid(segments);
+    EXPECT_EQ(grid.size(), segments.size());
+    EXPECT_GT(grid.cellsX() * grid.cellsY(), 1u);
+
+    for (const auto &pt : randomPoints(200, 60.0, 2))
+    {
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < segments.size(); i++)
+            if (distance(segments[i], pt) <= 3.0)
+                expected.push_back(i);
+        EXPECT_EQ(grid.inRadius(pt, 3.0), expected);
+    }
+}
+
+TEST(t_line_segment_grid, nearest_query)
+{
+    auto segments = randomSegments(300, 50.0, 5.0, 3);
+    rtl::LineSegmentGrid2d grid(segments, 2.0);
+
+    for (const auto &pt : randomPoints(200, 80.0, 4))
+    {
+        size_t best = 0;
+        for (size_t i = 1; i < segments.size(); i++)
+            if (distance(segments[i], pt) < distance(segments[best], pt))
+                best = i;
+        auto res = grid.nearest(pt);
+        ASSERT_LT(res.first, segments.size());
+        EXPECT_NEAR(res.second, distance(segments[best], pt), 1e-9);
+
+        auto bounded = grid.nearest(pt, 1.0);
+        if (distance(segments[best], pt) < 1.0)
+            EXPECT_NEAR(bounded.second, distance(segments[best], pt), 1e-9);
+        else
+            EXPECT_EQ(bounded.first, grid.size());
+    }
+}
+
+TEST(t_line_segment_grid, batch_queries)
+{
+    auto segments = randomSegments(400, 30.0, 6.0, 5);
+    rtl::LineSegmentGrid2d grid(segments);
+    auto pts = randomPoints(300, 35.0, 6);
+
+    auto pairs_seq = grid.inRadius(pts, 2.0);
+    auto pairs_par = grid.inRadius(pts, 2.0, rtl::ThreadExecutor(4));
+    EXPECT_EQ(pairs_seq, pairs_par);
+    size_t cnt = 0;
+    for (size_t q = 0; q < pts.size(); q++)
+        cnt += grid.inRadius(pts[q], 2.0).size();
+    EXPECT_EQ(pairs_seq.size(), cnt);
+
+    auto nearest_par = grid.nearest(pts, 10.0, rtl::ThreadExecutor(4));
+    ASSERT_EQ(nearest_par.size(), pts.size());
+    for (size_t q = 0; q < pts.size(); q++)
+        EXPECT_EQ(nearest_par[q], grid.nearest(pts[q], 10.0));
+}
+
+TEST(t_line_segment_grid, rebuild)
+{
+    rtl::LineSegmentGrid2d grid;
+    EXPECT_EQ(grid.nearest(rtl::Vector2d(0.0, 0.0)).first, 0u);
+    EXPECT_TRUE(grid.inRadius(rtl::Vector2d(0.0, 0.0), 1.0).empty());
+
+    auto segments = randomSegments(200, 20.0, 4.0, 7);
+    grid.build(segments);
+    segments.resize(100);
+    segments.emplace_back(rtl::Vector2d(100.0, 100.0), rtl::Vector2d(101.0, 100.0));
+    grid.build(segments);
+    EXPECT_EQ(grid.size(), 101u);
+    EXPECT_EQ(grid.nearest(rtl::Vector2d(100.5, 100.2)).first, 100u);
+    EXPECT_EQ(grid.inRadius(rtl::Vector2d(100.5, 101.0), 1.0), std::vector<size_t>{100});
+}
@@ -0,0 +1,101 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <type_traits>
+#include <vector>
+
+#include "rtl/Core.h"
+#include "rtl/Transformation.h"
+#include "rtl/Test.h"
+
+template<typename T>
+constexpr bool nothrowMovable()
+{
+    return std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>;
+}
+
+static_assert(nothrowMovable<rtl::Vector2f>() && nothrowMovable<rtl::Vector3d>() && nothrowMovable<rtl::VectorND<5, float>>());
+static_assert(nothrowMovable<rtl::LineSegment2f>() && nothrowMovable<rtl::LineSegment3d>() && nothrowMovable<rtl::LineSegmentND<5, float>>());
+static_assert(nothrowMovable<rtl::Translation2f>() && nothrowMovable<rtl::Translation3d>() && nothrowMovable<rtl::TranslationND<5, float>>());
+static_assert(nothrowMovable<rtl::Rotation2f>() && nothrowMovable<rtl::Rotation3d>() && nothrowMovable<rtl::RotationND<5, float>>());
+static_assert(nothrowMovable<rtl::RigidTf2f>() && nothrowMovable<rtl::RigidTf3d>() && nothrowMovable<rtl::RigidTfND<5, float>>());
+static_assert(nothrowMovable<rtl::Matrix<3, 3, float>>() && nothrowMovable<rtl::Matrix<Eigen::Dynamic, Eigen::Dynamic, double>>());
+
+TEST(t_move_semantics, dynamic_matrix)
+{
+    rtl::Matrix<Eigen::Dynamic, Eigen::Dynamic, double> m(64, 32);
+    m.data().setZero();
+    m.setElement(3, 5, 1.0);
+    const double *storage = m.data().data();
+
+    rtl::Matrix<Eigen::Dynamic, Eigen::Dynamic, double> moved(std::move(m));
+    ASSERT_EQ(moved.data().data(), storage);
+    ASSERT_EQ(moved.data().rows(), 64);
+    ASSERT_EQ(moved.getElement(3, 5), 1.0);
+
+    rtl::Matrix<Eigen::Dynamic, Eigen::Dynamic, double> assigned;
+    assigned = std::move(moved);
+    ASSERT_EQ(assigned.data().data(), storage);
+
+    Eigen::MatrixXd em = Eigen::MatrixXd::Ones(16, 16);
+    const double *em_storage = em.data();
+    rtl::Matrix<Eigen::Dynamic, Eigen::Dynamic, double> from_eigen(std::move(em));
+    ASSERT_EQ(from_eigen.data().data(), em_storage);
+}
+
+TEST(t_move_semantics, value_types)
+{
+    auto gen = rtl::test::Random::uniformCallable<double>(-10.0, 10.0);
+
+    auto v = rtl::Vector3d::random(gen), v_cp = v;
+    rtl::Vector3d v_mv(std::move(v));
+    ASSERT_EQ(v_mv, v_cp);
+
+    auto ls = rtl::LineSegment3d::random(gen), ls_cp = ls;
+    rtl::LineSegment3d ls_mv;
+    ls_mv = std::move(ls);
+    ASSERT_EQ(ls_mv.beg(), ls_cp.beg());
+    ASSERT_EQ(ls_mv.end(), ls_cp.end());
+    ASSERT_EQ(ls_mv.direction(), ls_cp.direction());
+
+    auto tf = rtl::RigidTf3d::random(gen), tf_cp = tf;
+    rtl::RigidTf3d tf_mv(std::move(tf)), tf_as;
+    tf_as = tf_cp;
+    ASSERT_EQ(tf_mv.rotMat(), tf_cp.rotMat());
+    ASSERT_EQ(tf_mv.trVec(), tf_cp.trVec());
+    ASSERT_EQ(tf_as.rotAngle(), tf_cp.rotAngle());
+    ASSERT_EQ(tf_as.trVec(), tf_cp.trVec());
+
+    std::vector<rtl::LineSegment3d> segments;
+    for (size_t i = 0; i < 100; i++)
+        segments.push_back(rtl::LineSegment3d::random(gen));
+    const auto *storage = segments.data();
+    auto segments_mv = std::move(segments);
+    ASSERT_EQ(segments_mv.data(), storage);
+    ASSERT_EQ(segments_mv.size(), 100);
+}
@@ -0,0 +1,243 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "rtl/Core.h"
+#include "rtl/Vectorization.h"
+#include "rtl/seg/CAR_Segmenter.h"
+
+struct NumberFrame
+{
+    size_t id{0};
+    std::vector<double> values;
+    double sum{0.0}, scaled{0.0};
+};
+
+static void fillValues(NumberFrame &f)
+{
+    f.values.resize(100 + f.id % 50);
+    for (size_t i = 0; i < f.values.size(); i++)
+        f.values[i] = std::sin((double)(f.id * 1000 + i));
+}
+
+static void sumValues(NumberFrame &f)
+{
+    f.sum = 0.0;
+    for (auto v : f.values)
+        f.sum += v;
+}
+
+TEST(t_pipeline, bounded_queue)
+{
+    rtl::BoundedQueue<int> queue(3);
+    ASSERT_EQ(queue.capacity(), 3);
+    std::thread producer([&queue]() {
+        for (int i = 0; i < 100; i++)
+            queue.push(i);
+        queue.close();
+    });
+    int item, expected = 0;
+    while (queue.pop(item))
+        ASSERT_EQ(item, expected++);
+    producer.join();
+    ASSERT_EQ(expected, 100);
+    ASSERT_FALSE(queue.push(0));
+}
+
+TEST(t_pipeline, run)
+{
+    rtl::Pipeline<NumberFrame> pipeline({fillValues, sumValues, [](NumberFrame &f) { f.scaled = 2.0 * f.sum; }}, 4);
+    ASSERT_EQ(pipeline.stageCount(), 3);
+    ASSERT_EQ(pipeline.framesInFlight(), 4);
+
+    size_t next_id = 0, expected_id = 0;
+    size_t processed = pipeline.run([&next_id](NumberFrame &f) {
+        if (next_id == 500)
+            return false;
+        f.id = next_id++;
+        return true;
+    }, [&expected_id](NumberFrame &f) {
+        NumberFrame ref;
+        ref.id = expected_id++;
+        fillValues(ref);
+        sumValues(ref);
+        ASSERT_EQ(f.id, ref.id);
+        ASSERT_EQ(f.values, ref.values);
+        ASSERT_EQ(f.scaled, 2.0 * ref.sum);
+    });
+    ASSERT_EQ(processed, 500);
+    ASSERT_EQ(expected_id, 500);
+}
+
+TEST(t_pipeline, manual_stream)
+{
+    rtl::Pipeline<NumberFrame> pipeline({fillValues, sumValues});
+    ASSERT_EQ(pipeline.framesInFlight(), 3);
+    for (size_t round = 0; round < 10; round++)
+    {
+        for (size_t i = 0; i < pipeline.framesInFlight(); i++)
+        {
+            auto *f = pipeline.acquire();
+            ASSERT_NE(f, nullptr);
+            f->id = round * 10 + i;
+            ASSERT_TRUE(pipeline.submit(f));
+        }
+        for (size_t i = 0; i < pipeline.framesInFlight(); i++)
+        {
+            auto *f = pipeline.retrieve();
+            ASSERT_NE(f, nullptr);
+            ASSERT_EQ(f->id, round * 10 + i);
+            ASSERT_EQ(f->values.size(), 100 + f->id % 50);
+            pipeline.release(f);
+        }
+    }
+    pipeline.close();
+    ASSERT_EQ(pipeline.retrieve(), nullptr);
+}
+
+TEST(t_pipeline, stage_exception)
+{
+    rtl::Pipeline<NumberFrame> pipeline({fillValues, [](NumberFrame &f) {
+        if (f.id == 20)
+            throw std::runtime_error("stage failure");
+        sumValues(f);
+    }});
+    size_t next_id = 0, retrieved = 0;
+    EXPECT_THROW(pipeline.run([&next_id](NumberFrame &f) { f.id = next_id++; return true; }, [&retrieved](NumberFrame &) { retrieved++; }), std::runtime_error);
+    EXPECT_EQ(retrieved, 20);
+}
+
+TEST(t_pipeline, early_stage_exception)
+{
+    // the first stage fails while earlier frames still wait for the slow second one, those have to be finished
+    rtl::Pipeline<NumberFrame> pipeline({[](NumberFrame &f) {
+        if (f.id == 3)
+            throw std::runtime_error("stage failure");
+        fillValues(f);
+    }, [](NumberFrame &f) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        sumValues(f);
+        f.scaled = 1.0;
+    }}, 4);
+    for (size_t i = 0; i < 4; i++)
+    {
+        auto *f = pipeline.acquire();
+        ASSERT_NE(f, nullptr);
+        f->id = i;
+        ASSERT_TRUE(pipeline.submit(f));
+    }
+    for (size_t i = 0; i < 3; i++)
+    {
+        auto *f = pipeline.retrieve();
+        ASSERT_NE(f, nullptr);
+        ASSERT_EQ(f->id, i);
+        ASSERT_EQ(f->scaled, 1.0);
+        ASSERT_EQ(f->values.size(), 100 + f->id % 50);
+        pipeline.release(f);
+    }
+    EXPECT_THROW(pipeline.retrieve(), std::runtime_error);
+    pipeline.close();
+}
+
+struct ScanFrame
+{
+    std::vector<rtl::Vector2f> scan, clustered;
+    std::vector<size_t> offsets;
+    std::vector<rtl::LineSegment2f> segments;
+};
+
+// a square room observed from its center, with occluded sectors depending on the frame
+static void generateScan(size_t frame, std::vector<rtl::Vector2f> &scan)
+{
+    scan.clear();
+    for (size_t b = 0; b < 720; b++)
+    {
+        float a = rtl::C_PIf * 2.0f * (float)b / 720.0f;
+        if ((b + frame * 7) % 180 < 10)
+            continue;
+        float c = std::cos(a), s = std::sin(a), r = 3.0f / std::max(std::abs(c), std::abs(s));
+        scan.emplace_back(r * c, r * s);
+    }
+}
+
+TEST(t_pipeline, segmentation_vectorization)
+{
+    typedef rtl::VectorizerITLSProjections2D<float, double> Vectorizer;
+    Vectorizer prototype;
+    prototype.setSigma(0.01f);
+
+    // serial reference
+    rtl::CAR_Segmenter<rtl::Vector2f> seg_ref(5, 0.05f, 0.5f);
+    rtl::VectorizerBatch<Vectorizer> vec_ref(prototype);
+    std::vector<std::vector<rtl::LineSegment2f>> reference;
+    std::vector<rtl::Vector2f> scan;
+    for (size_t i = 0; i < 40; i++)
+    {
+        generateScan(i, scan);
+        seg_ref.loadData(scan);
+        ASSERT_TRUE(vec_ref(seg_ref.clusteredPoints(), rtl::Span<const size_t>(seg_ref.clusterOffsets())));
+        ASSERT_FALSE(vec_ref.segments().empty());
+        reference.push_back(vec_ref.segments());
+    }
+
+    // each stage owns its functor, results are copied into the frame, so the next frame can be processed meanwhile
+    rtl::CAR_Segmenter<rtl::Vector2f> seg(5, 0.05f, 0.5f);
+    rtl::VectorizerBatch<Vectorizer> vec(prototype);
+    rtl::Pipeline<ScanFrame> pipeline({
+        [&seg](ScanFrame &f) {
+            seg.loadData(f.scan);
+            f.clustered = seg.clusteredPoints();
+            f.offsets = seg.clusterOffsets();
+        },
+        [&vec](ScanFrame &f) {
+            if (!vec(f.clustered, rtl::Span<const size_t>(f.offsets)))
+                throw std::runtime_error("vectorization failed");
+            f.segments = vec.segments();
+        }});
+
+    size_t next = 0, done = 0;
+    pipeline.run([&next](ScanFrame &f) {
+        if (next == 40)
+            return false;
+        generateScan(next++, f.scan);
+        return true;
+    }, [&reference, &done](ScanFrame &f) {
+        ASSERT_EQ(f.segments.size(), reference[done].size());
+        for (size_t i = 0; i < f.segments.size(); i++)
+        {
+            ASSERT_EQ(f.segments[i].beg(), reference[done][i].beg());
+            ASSERT_EQ(f.segments[i].end(), reference[done][i].end());
+        }
+        done++;
+    });
+    ASSERT_EQ(done, 40);
+}
@@ -0,0 +1,117 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+
+#include "rtl/Core.h"
+#include "rtl/Transformation.h"
+#include "rtl/Test.h"
+
+template<int dim, typename E>
+struct TesterPointCloudConstruction
+{
+    static void testFunction(size_t pts_nr)
+    {
+        using V = rtl::VectorND<dim, E>;
+        using PC = rtl::PointCloudND<dim, E>;
+        std::cout << "\n" << rtl::test::type<PC>::description() << " construction test:" << std::endl;
+
+        auto el_gen = rtl::test::Random::uniformCallable<E>((E)-1, (E)1);
+        std::vector<V> pts;
+        for (size_t i = 0; i < pts_nr; i++)
+            pts.push_back(V::random(el_gen));
+
+        PC pc_vec(pts), pc_add;
+        for (const auto &p : pts)
+            pc_add.addPoint(p);
+        ASSERT_EQ(pc_vec.size(), pts_nr);
+        ASSERT_EQ(pc_add.size(), pts_nr);
+
+        auto back = pc_vec.toVector();
+        for (size_t i = 0; i < pts_nr; i++)
+        {
+            ASSERT_EQ(back[i], pts[i]);
+            ASSERT_EQ(pc_add.getPoint(i), pts[i]);
+            for (int d = 0; d < dim; d++)
+                ASSERT_EQ(pc_vec.coordData(d)[i], pts[i][d]);
+        }
+
+        pc_add.clear();
+        ASSERT_TRUE(pc_add.empty());
+        ASSERT_GE(pc_add.capacity(), pts_nr);
+    }
+};
+
+template<int dim, typename E>
+struct TesterPointCloudTransformation
+{
+    template<class Tf>
+    static void compare(const std::vector<rtl::VectorND<dim, E>> &pts, const Tf &tf)
+    {
+        using V = rtl::VectorND<dim, E>;
+        using PC = rtl::PointCloudND<dim, E>;
+        PC pc(pts);
+        PC pc_tr = tf(pc);
+        pc.transform(tf);
+        for (size_t i = 0; i < pts.size(); i++)
+        {
+            V v_tr = tf(pts[i]);
+            ASSERT_LT(V::distance(pc_tr.getPoint(i), v_tr), rtl::test::type<V>::allowedError());
+            ASSERT_LT(V::distance(pc.getPoint(i), v_tr), rtl::test::type<V>::allowedError());
+        }
+    }
+
+    static void testFunction(size_t pts_nr)
+    {
+        using V = rtl::VectorND<dim, E>;
+        std::cout << "\n" << rtl::test::type<rtl::PointCloudND<dim, E>>::description() << " transformation test:" << std::endl;
+
+        auto el_gen = rtl::test::Random::uniformCallable<E>((E)-1, (E)1);
+        std::vector<V> pts;
+        for (size_t i = 0; i < pts_nr; i++)
+            pts.push_back(V::random(el_gen));
+
+        compare(pts, rtl::TranslationND<dim, E>::random(el_gen));
+        compare(pts, rtl::RotationND<dim, E>::random(el_gen));
+        compare(pts, rtl::RigidTfND<dim, E>::random(el_gen));
+    }
+};
+
+TEST(t_pointcloud, general_test)
+{
+    size_t pts_nr = 1000;
+
+    rtl::test::RangeTypes<TesterPointCloudConstruction, 1, 4, float, double> t_c(pts_nr);
+    rtl::test::RangeTypes<TesterPointCloudTransformation, 2, 4, float, double> t_tf(pts_nr);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
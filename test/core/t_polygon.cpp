@@ -0,0 +1,268 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include "rtl/Core.h"
+#include "rtl/Transformation.h"
+#include "rtl/Test.h"
+
+// Star-shaped (generally concave) polygon with vertices in counter-clockwise order.
+template<typename E>
+rtl::Polygon2D<E> randomStar(size_t vertices, E r_min, E r_max, const rtl::Vector2D<E> &center)
+{
+    auto r_gen = rtl::test::Random::uniformCallable<E>(r_min, r_max);
+    rtl::Polygon2D<E> ret;
+    for (size_t i = 0; i < vertices; i++)
+    {
+        E a = 2 * rtl::C_PI<E> * (E)i / (E)vertices;
+        ret.addPoint(center + rtl::Vector2D<E>(std::cos(a), std::sin(a)) * r_gen());
+    }
+    return ret;
+}
+
+template<typename E>
+E boundaryDistance(const rtl::Polygon2D<E> &poly, const rtl::Vector2D<E> &p)
+{
+    E ret = std::numeric_limits<E>::max();
+    const auto &pts = poly.points();
+    for (size_t j = pts.size() - 1, k = 0; k < pts.size(); j = k, k++)
+    {
+        auto d = pts[k] - pts[j];
+        E t = std::clamp((p - pts[j]).dot(d) / d.dot(d), (E)0, (E)1);
+        ret = std::min(ret, rtl::Vector2D<E>::distance(pts[j] + d * t, p));
+    }
+    return ret;
+}
+
+template<typename E>
+void testPolygon2D()
+{
+    using V = rtl::Vector2D<E>;
+    std::cout << "\n" << rtl::test::type<rtl::Polygon2D<E>>::description() << " test:" << std::endl;
+    E margin = std::is_same_v<E, float> ? (E)1e-3 : (E)1e-8;
+
+    rtl::Polygon2D<E> square;
+    square.addPoint(V(0, 0));
+    square.addPoint(V(2, 0));
+    square.addPoint(V(2, 2));
+    square.addPoint(V(0, 2));
+    ASSERT_NEAR(square.signedArea(), (E)4, margin);
+    ASSERT_TRUE(square.contains(V(1, 1)));
+    ASSERT_FALSE(square.contains(V(3, 1)));
+    square.buildIndex(3);
+    ASSERT_TRUE(square.indexed());
+    ASSERT_TRUE(square.contains(V(1, 1)));
+    ASSERT_FALSE(square.contains(V(1, -1)));
+
+    auto pt_gen = rtl::test::Random::uniformCallable<E>((E)-12, (E)12);
+    for (size_t rep = 0; rep < 4; rep++)
+    {
+        auto star = randomStar<E>(30 + 20 * rep, (E)2, (E)10, V::zeros());
+        auto indexed = star;
+        indexed.buildIndex();
+        ASSERT_TRUE(indexed.indexed());
+        ASSERT_FALSE(star.indexed());
+
+        // area of a fan around the center of the star
+        E fan = 0;
+        const auto &pts = star.points();
+        for (size_t j = pts.size() - 1, k = 0; k < pts.size(); j = k, k++)
+            fan += pts[j].cross(pts[k]) / 2;
+        ASSERT_NEAR(star.signedArea(), fan, margin * fan);
+
+        std::vector<V> queries;
+        for (size_t i = 0; i < 300; i++)
+            queries.emplace_back(pt_gen(), pt_gen());
+        std::vector<uint64_t> mask;
+        indexed.contains(queries, mask);
+        ASSERT_EQ(mask.size(), (queries.size() + 63) / 64);
+        for (size_t i = 0; i < queries.size(); i++)
+        {
+            bool ref = star.contains(queries[i]);
+            ASSERT_EQ(indexed.contains(queries[i]), ref);
+            ASSERT_EQ((mask[i / 64] >> (i % 64)) & 1u, (uint64_t)ref);
+            if (boundaryDistance(star, queries[i]) > margin)
+            {
+                // star-shaped around origin: inside iff closer than the boundary along the ray
+                E a = std::atan2(queries[i].y(), queries[i].x());
+                a = a < 0 ? a + 2 * rtl::C_PI<E> : a;
+                size_t seg = (size_t)(a / (2 * rtl::C_PI<E>) * (E)pts.size()) % pts.size();
+                auto b = pts[seg], c = pts[(seg + 1) % pts.size()];
+                bool in = (c - b).cross(queries[i] - b) > 0;
+                ASSERT_EQ(ref, in);
+            }
+        }
+
+        // clipping of the star by a convex polygon
+        auto clipper = randomStar<E>(20, (E)5, (E)5, V(pt_gen() / 3, pt_gen() / 3));
+        rtl::Polygon2D<E> clipped;
+        std::vector<V> buffer;
+        star.clip(clipper, clipped, buffer);
+        auto capacity = clipped.points().capacity();
+        star.clip(clipper, clipped, buffer);
+        ASSERT_EQ(clipped.points().capacity(), capacity);
+        for (const auto &q : queries)
+        {
+            if (boundaryDistance(star, q) < margin || boundaryDistance(clipper, q) < margin)
+                continue;
+            // degenerate bridges of the concave parts have zero area, they do not affect the even-odd test of points aside of them
+            if (boundaryDistance(clipped, q) < margin)
+                continue;
+            ASSERT_EQ(clipped.contains(q), star.contains(q) && clipper.contains(q));
+        }
+        ASSERT_LE(clipped.area(), std::min(star.area(), clipper.area()) * (1 + margin));
+        ASSERT_EQ(star.clipped(clipper).points().size(), clipped.points().size());
+    }
+}
+
+template<typename E>
+void testPolygon3D()
+{
+    using V2 = rtl::Vector2D<E>;
+    using V3 = rtl::Vector3D<E>;
+    std::cout << "\n" << rtl::test::type<rtl::Polygon3D<E>>::description() << " test:" << std::endl;
+    E margin = std::is_same_v<E, float> ? (E)1e-3 : (E)1e-8;
+    auto el_gen = rtl::test::Random::uniformCallable<E>((E)-1, (E)1);
+    auto pt_gen = rtl::test::Random::uniformCallable<E>((E)-12, (E)12);
+
+    for (size_t rep = 0; rep < 4; rep++)
+    {
+        V3 n = V3::random(el_gen).normalized();
+        E dist = pt_gen();
+        V3 e1 = n.cross(std::abs(n.x()) < (E)0.5 ? V3::baseX() : V3::baseY()).normalized(), e2 = n.cross(e1);
+        auto lift = [&](const V2 &p) { return e1 * p.x() + e2 * p.y() + n * dist; };
+
+        auto star = randomStar<E>(60, (E)2, (E)10, V2::zeros());
+        rtl::Polygon3D<E> poly(n, dist);
+        for (const auto &p : star.points())
+            poly.addPoint(lift(p));
+        ASSERT_NEAR(poly.area(), star.area(), margin * star.area() * 10);
+
+        // batch projection of points off the plane
+        std::vector<V3> lifted;
+        for (const auto &p : star.points())
+            lifted.push_back(lift(p) + n * pt_gen());
+        rtl::Polygon3D<E> batch(n, dist), single(n, dist);
+        batch.addPoints(rtl::Span<const V3>(lifted));
+        for (const auto &p : lifted)
+            single.addPoint(p);
+        ASSERT_EQ(batch.points().size(), single.points().size());
+        for (size_t i = 0; i < lifted.size(); i++)
+            ASSERT_LT(V3::distance(batch.points()[i], single.points()[i]), margin * 10);
+
+        // convex hull keeps only the boundary, all other points project inside
+        rtl::Polygon3D<E> hull(n, dist);
+        hull.addPointsConvexHull(rtl::Span<const V3>(lifted));
+        ASSERT_LE(hull.points().size(), lifted.size());
+        ASSERT_GE(hull.points().size(), 3);
+        ASSERT_GE(hull.area(), star.area() * (1 - margin));
+        for (const auto &p : hull.points())
+            ASSERT_NEAR(n.dot(p), dist, margin * 10);
+        const auto &hp = hull.points();
+        E orientation = 0;
+        for (size_t i = 0; i < hp.size(); i++)
+        {
+            E turn = n.dot((hp[(i + 1) % hp.size()] - hp[i]).cross(hp[(i + 2) % hp.size()] - hp[(i + 1) % hp.size()]));
+            if (orientation == 0)
+                orientation = turn;
+            ASSERT_GT(turn * orientation, 0);
+        }
+        hull.buildIndex();
+        for (const auto &p : star.points())
+            ASSERT_TRUE(hull.contains(lift(p * (E)0.99)));
+        size_t hull_size = hull.points().size();
+        hull.addPointsConvexHull(rtl::Span<const V3>(lifted.data(), 10));
+        ASSERT_EQ(hull.points().size(), hull_size);
+
+        std::vector<V3> queries;
+        std::vector<V2> queries_2d;
+        for (size_t i = 0; i < 300; i++)
+        {
+            queries_2d.emplace_back(pt_gen(), pt_gen());
+            queries.push_back(lift(queries_2d.back()) + n * pt_gen());
+        }
+        auto indexed = poly;
+        indexed.buildIndex();
+        ASSERT_TRUE(indexed.indexed());
+        std::vector<uint64_t> mask;
+        indexed.contains(queries, mask);
+        for (size_t i = 0; i < queries.size(); i++)
+        {
+            bool ref = poly.contains(queries[i]);
+            ASSERT_EQ(indexed.contains(queries[i]), ref);
+            ASSERT_EQ((mask[i / 64] >> (i % 64)) & 1u, (uint64_t)ref);
+            if (boundaryDistance(star, queries_2d[i]) > margin * 10)
+            {
+                ASSERT_EQ(ref, star.contains(queries_2d[i]));
+            }
+        }
+
+        // batch transformation of a collection
+        auto tf = rtl::RigidTfND<3, E>::random(el_gen);
+        std::vector<rtl::Polygon3D<E>> collection{poly, hull, batch};
+        rtl::Polygon3D<E>::transform(collection, tf);
+        for (const auto &[res, src] : {std::pair(collection[0], poly), std::pair(collection[1], hull), std::pair(collection[2], batch)})
+        {
+            auto ref = src.transformed(tf);
+            ASSERT_LT(V3::distance(res.normal(), ref.normal()), margin);
+            ASSERT_NEAR(res.distance(), ref.distance(), margin * 100);
+            ASSERT_EQ(res.points().size(), ref.points().size());
+            for (size_t i = 0; i < ref.points().size(); i++)
+                ASSERT_LT(V3::distance(res.points()[i], ref.points()[i]), margin * 100);
+        }
+
+        rtl::Polygon3D<E> above, under;
+        V3 split_n = V3::random(el_gen).normalized();
+        poly.split(split_n, split_n.dot(n * dist), above, under);
+        ASSERT_NEAR(above.area() + under.area(), poly.area(), margin * poly.area() * 10);
+        for (const auto &p : above.points())
+            ASSERT_GT(split_n.dot(p) - split_n.dot(n * dist), -margin * 10);
+        for (const auto &p : under.points())
+            ASSERT_LT(split_n.dot(p) - split_n.dot(n * dist), margin * 10);
+    }
+}
+
+TEST(t_polygon, polygon_2d)
+{
+    testPolygon2D<float>();
+    testPolygon2D<double>();
+}
+
+TEST(t_polygon, polygon_3d)
+{
+    testPolygon3D<float>();
+    testPolygon3D<double>();
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
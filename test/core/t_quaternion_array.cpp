@@ -0,0 +1,165 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include "rtl/Core.h"
+#include "rtl/Test.h"
+
+template<typename E>
+std::vector<rtl::Quaternion<E>> randomRotations(size_t nr)
+{
+    auto el_gen = rtl::test::Random::uniformCallable<E>((E)-1, (E)1);
+    auto ang_gen = rtl::test::Random::uniformCallable<E>(-rtl::C_PI<E>, rtl::C_PI<E>);
+    std::vector<rtl::Quaternion<E>> ret;
+    for (size_t i = 0; i < nr; i++)
+        ret.push_back(rtl::Quaternion<E>::random(ang_gen, el_gen).normalized());
+    return ret;
+}
+
+// Both q and -q represent the same rotation.
+template<typename E>
+E rotationDifference(const rtl::Quaternion<E> &q1, const rtl::Quaternion<E> &q2)
+{
+    return std::min(rtl::Quaternion<E>::distance(q1, q2), rtl::Quaternion<E>::distance(q1, -q2));
+}
+
+template<typename E>
+void testConstruction(size_t nr)
+{
+    auto qs = randomRotations<E>(nr);
+    rtl::QuaternionArray<E> qa_vec(qs), qa_add;
+    for (const auto &q : qs)
+        qa_add.addQuaternion(q);
+    ASSERT_EQ(qa_vec.size(), nr);
+    ASSERT_EQ(qa_add.size(), nr);
+
+    auto back = qa_vec.toVector();
+    for (size_t i = 0; i < nr; i++)
+    {
+        ASSERT_EQ(back[i].w(), qs[i].w());
+        ASSERT_EQ(qa_add.getQuaternion(i).z(), qs[i].z());
+        ASSERT_EQ(qa_vec.coeffData(1)[i], qs[i].x());
+        ASSERT_EQ(qa_vec.coeffData(2)[i], qs[i].y());
+    }
+
+    qa_add.clear();
+    ASSERT_TRUE(qa_add.empty());
+    ASSERT_GE(qa_add.capacity(), nr);
+}
+
+template<typename E>
+void testKernels(size_t nr, E eps)
+{
+    auto qs1 = randomRotations<E>(nr), qs2 = randomRotations<E>(nr);
+    rtl::QuaternionArray<E> qa1(qs1), qa2(qs2), out;
+
+    auto prod = qa1 * qa2;
+    for (size_t i = 0; i < nr; i++)
+        ASSERT_LT(rtl::Quaternion<E>::distance(prod.getQuaternion(i), qs1[i] * qs2[i]), eps);
+    rtl::QuaternionArray<E> in_place(qa1);
+    rtl::QuaternionArray<E>::multiply(in_place, qa2, in_place);
+    for (size_t i = 0; i < nr; i++)
+        ASSERT_LT(rtl::Quaternion<E>::distance(in_place.getQuaternion(i), qs1[i] * qs2[i]), eps);
+
+    rtl::QuaternionArray<E> scaled(nr);
+    for (size_t i = 0; i < nr; i++)
+        scaled.setQuaternion(i, qs1[i] * (E)(1 + i % 7));
+    scaled.normalize();
+    for (size_t i = 0; i < nr; i++)
+        ASSERT_LT(rtl::Quaternion<E>::distance(scaled.getQuaternion(i), qs1[i]), eps);
+
+    auto el_gen = rtl::test::Random::uniformCallable<E>((E)-10, (E)10);
+    std::vector<rtl::Vector3D<E>> pts;
+    for (size_t i = 0; i < nr; i++)
+        pts.push_back(rtl::Vector3D<E>::random(el_gen));
+    rtl::PointCloud3D<E> pc(pts), pc_rot;
+    qa1.rotate(pc, pc_rot);
+    qa1.rotate(pc, pc);
+    for (size_t i = 0; i < nr; i++)
+    {
+        rtl::Vector3D<E> ref(typename rtl::Vector3D<E>::EigenType(qs1[i].data() * pts[i].data()));
+        ASSERT_LT(rtl::Vector3D<E>::distance(pc_rot.getPoint(i), ref), 10 * eps);
+        ASSERT_LT(rtl::Vector3D<E>::distance(pc.getPoint(i), ref), 10 * eps);
+    }
+    ASSERT_THROW(qa1.rotate(rtl::PointCloud3D<E>(nr + 1), pc), std::invalid_argument);
+
+    std::vector<E> ts;
+    for (size_t i = 0; i < nr; i++)
+        ts.push_back((E)i / (E)(nr - 1));
+    rtl::QuaternionArray<E>::slerp(qa1, qa2, ts, out);
+    for (size_t i = 0; i < nr; i++)
+        ASSERT_LT(rotationDifference(out.getQuaternion(i), qs1[i].slerp(qs2[i], ts[i])), eps);
+    rtl::QuaternionArray<E>::slerp(qa1, qa2, (E)0.3, out);
+    for (size_t i = 0; i < nr; i++)
+        ASSERT_LT(rotationDifference(out.getQuaternion(i), qs1[i].slerp(qs2[i], (E)0.3)), eps);
+    rtl::QuaternionArray<E>::slerp(qa1, qa1, (E)0.3, out);
+    for (size_t i = 0; i < nr; i++)
+        ASSERT_LT(rotationDifference(out.getQuaternion(i), qs1[i]), eps);
+    ASSERT_THROW(rtl::QuaternionArray<E>::slerp(qa1, rtl::QuaternionArray<E>(nr + 1), (E)0.5, out), std::invalid_argument);
+
+    // Small rotations between the endpoints, nlerp has to stay within its documented error bound.
+    rtl::QuaternionArray<E> qa_near(nr);
+    std::vector<E> angles;
+    for (size_t i = 0; i < nr; i++)
+    {
+        angles.push_back((E)0.3 * (E)(i % 10) / (E)10);
+        qa_near.setQuaternion(i, qs1[i] * rtl::Quaternion<E>(angles.back(), pts[i].normalized()));
+    }
+    rtl::QuaternionArray<E>::nlerp(qa1, qa_near, ts, out);
+    for (size_t i = 0; i < nr; i++)
+    {
+        auto ref = qs1[i].slerp(qa_near.getQuaternion(i), ts[i]);
+        // angle of the relative rotation, chord based formula is well conditioned for small angles unlike acos of the dot product
+        E rot_error = 4 * std::asin(std::min((E)1, rotationDifference(out.getQuaternion(i), ref) / 2));
+        ASSERT_LE(rot_error, std::pow(angles[i], 3) / 216 + 10 * eps);
+        ASSERT_NEAR(out.getQuaternion(i).norm(), 1, eps);
+    }
+    rtl::QuaternionArray<E>::nlerp(qa1, qa2, (E)0.5, out);
+    for (size_t i = 0; i < nr; i++)
+        ASSERT_LT(rotationDifference(out.getQuaternion(i), qs1[i].slerp(qs2[i], (E)0.5)), eps);
+}
+
+TEST(t_quaternion_array, construction)
+{
+    testConstruction<float>(1000);
+    testConstruction<double>(1000);
+}
+
+TEST(t_quaternion_array, kernels)
+{
+    testKernels<float>(1000, 1e-4f);
+    testKernels<double>(1000, 1e-9);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
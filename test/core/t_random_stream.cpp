@@ -0,0 +1,175 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <set>
+
+#include "rtl/Core.h"
+#include "rtl/Test.h"
+
+TEST(t_random_stream, reproducibility)
+{
+    rtl::Xoshiro256PlusPlus a(123), b(123), c(124);
+    for (size_t i = 0; i < 1000; i++)
+    {
+        auto va = a();
+        ASSERT_EQ(va, b());
+        ASSERT_NE(va, c());
+    }
+
+    a.seed(5);
+    b.seed(5);
+    b.discard(10);
+    for (size_t i = 0; i < 10; i++)
+        a();
+    ASSERT_EQ(a, b);
+}
+
+TEST(t_random_stream, streams)
+{
+    rtl::RandomStreams streams(99);
+    std::vector<rtl::RandomStreams::EngineType> engines;
+    streams.streams(8, engines);
+    ASSERT_EQ(engines.size(), 8);
+
+    std::set<uint64_t> values;
+    for (size_t s = 0; s < engines.size(); s++)
+    {
+        ASSERT_EQ(engines[s], streams.stream(s));
+        for (size_t i = 0; i < 100; i++)
+            values.insert(engines[s]());
+    }
+    EXPECT_EQ(values.size(), 800);
+
+    auto e = streams.stream(3);
+    rtl::test::Random::seed(17);
+    auto v1 = rtl::test::Random::uniformValue(0.0, 1.0);
+    auto i1 = rtl::test::Random::uniformValue(-10, 10, e);
+    rtl::test::Random::seed(17);
+    e = streams.stream(3);
+    EXPECT_EQ(v1, rtl::test::Random::uniformValue(0.0, 1.0));
+    EXPECT_EQ(i1, rtl::test::Random::uniformCallable(-10, 10, e)());
+}
+
+TEST(t_random_stream, bulk)
+{
+    // every lane continues the sequence of a scalar generator seeded by one output of the seeding engine
+    rtl::Xoshiro256PlusPlus seeder(77), lane_seeder(77);
+    rtl::Xoshiro256PlusPlusBulk<4> bulk(seeder);
+    std::vector<rtl::Xoshiro256PlusPlus> lanes;
+    for (size_t l = 0; l < 4; l++)
+        lanes.emplace_back(lane_seeder());
+    ASSERT_EQ(seeder, lane_seeder);
+
+    std::vector<uint64_t> raw(4 * 50 + 3);
+    bulk.fill(raw);
+    for (size_t i = 0; i < raw.size(); i++)
+        ASSERT_EQ(raw[i], lanes[i % 4]());
+
+    rtl::Xoshiro256PlusPlusBulk<> a(5), b(5);
+    std::vector<float> uf(100003), uf2(uf.size());
+    a.uniform(rtl::Span<float>(uf), -2.0f, 3.0f);
+    b.uniform(rtl::Span<float>(uf2), -2.0f, 3.0f);
+    ASSERT_EQ(uf, uf2);
+    double mean = 0.0;
+    for (auto v : uf)
+    {
+        ASSERT_GE(v, -2.0f);
+        ASSERT_LE(v, 3.0f);
+        mean += v;
+    }
+    ASSERT_NEAR(mean / uf.size(), 0.5, 0.02);
+
+    std::vector<double> nd(100001);
+    a.normal(rtl::Span<double>(nd), 1.0, 2.0);
+    double sum = 0.0, sum2 = 0.0;
+    for (auto v : nd)
+    {
+        ASSERT_TRUE(std::isfinite(v));
+        sum += v;
+        sum2 += v * v;
+    }
+    mean = sum / nd.size();
+    ASSERT_NEAR(mean, 1.0, 0.03);
+    ASSERT_NEAR(std::sqrt(sum2 / nd.size() - mean * mean), 2.0, 0.03);
+}
+
+TEST(t_random_stream, bulk_geometry)
+{
+    constexpr size_t n = 1000;
+    rtl::test::Random::seed(11);
+
+    std::vector<rtl::Vector3f> vecs(n);
+    rtl::test::Random::vectorArray(rtl::Span<rtl::Vector3f>(vecs), -1.0f, 1.0f);
+    for (const auto &v : vecs)
+        for (size_t d = 0; d < 3; d++)
+        {
+            ASSERT_GE(v.getElement(d), -1.0f);
+            ASSERT_LE(v.getElement(d), 1.0f);
+        }
+
+    std::vector<rtl::Quaternion<double>> quats(n);
+    rtl::test::Random::quaternionArray(rtl::Span<rtl::Quaternion<double>>(quats));
+    double mean_w = 0.0;
+    for (const auto &q : quats)
+    {
+        ASSERT_NEAR(q.norm(), 1.0, 1e-12);
+        mean_w += q.w();
+    }
+    ASSERT_NEAR(mean_w / n, 0.0, 0.1);
+
+    rtl::Xoshiro256PlusPlusBulk<> engine(3);
+    std::vector<rtl::RigidTf2D<float>> tfs2(n);
+    rtl::test::Random::rigidTfArray(rtl::Span<rtl::RigidTf2D<float>>(tfs2), -5.0f, 5.0f, engine);
+    for (const auto &tf : tfs2)
+    {
+        ASSERT_NEAR(tf.rotMat().determinant(), 1.0f, 1e-5f);
+        ASSERT_LE(std::abs(tf.trVecX()), 5.0f);
+    }
+
+    std::vector<rtl::RigidTf3D<double>> tfs3(n);
+    rtl::test::Random::rigidTfArray(rtl::Span<rtl::RigidTf3D<double>>(tfs3), -5.0, 5.0, engine);
+    for (const auto &tf : tfs3)
+    {
+        ASSERT_NEAR(tf.rotMat().determinant(), 1.0, 1e-12);
+        ASSERT_LE(tf.trVec().length(), 5.0 * std::sqrt(3.0));
+    }
+
+    std::vector<rtl::LineSegment2d> segs(n);
+    rtl::test::Random::lineSegmentArray(rtl::Span<rtl::LineSegment2d>(segs), 0.0, 10.0);
+    for (const auto &ls : segs)
+    {
+        ASSERT_NEAR(ls.direction().length(), 1.0, 1e-9);
+        ASSERT_NEAR((ls.end() - ls.beg()).length(), ls.length(), 1e-9);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
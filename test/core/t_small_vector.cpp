@@ -0,0 +1,116 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "rtl/Core.h"
+#include "rtl/Transformation.h"
+#include "rtl/Test.h"
+
+TEST(t_small_vector, inline_and_heap)
+{
+    rtl::SmallVector<std::string, 4> sv;
+    ASSERT_TRUE(sv.empty());
+    ASSERT_TRUE(sv.isInline());
+    ASSERT_EQ(sv.capacity(), 4);
+
+    std::vector<std::string> ref;
+    for (size_t i = 0; i < 20; i++)
+    {
+        sv.push_back(std::to_string(i));
+        ref.push_back(std::to_string(i));
+        ASSERT_EQ(sv.isInline(), i < 4);
+    }
+    ASSERT_EQ(sv.size(), ref.size());
+    for (size_t i = 0; i < ref.size(); i++)
+        ASSERT_EQ(sv[i], ref[i]);
+
+    sv.insert(sv.begin(), "front");
+    sv.insert(sv.begin() + 5, "middle");
+    ref.insert(ref.begin(), "front");
+    ref.insert(ref.begin() + 5, "middle");
+    ASSERT_TRUE(std::equal(sv.begin(), sv.end(), ref.begin(), ref.end()));
+
+    sv.pop_back();
+    ref.pop_back();
+    ASSERT_EQ(sv.back(), ref.back());
+    ASSERT_THROW(sv.at(sv.size()), std::out_of_range);
+
+    sv.clear();
+    ASSERT_TRUE(sv.empty());
+    ASSERT_GE(sv.capacity(), 20);
+}
+
+TEST(t_small_vector, copy_and_move)
+{
+    for (size_t n : {2, 4, 9})
+    {
+        rtl::SmallVector<std::string, 4> sv;
+        for (size_t i = 0; i < n; i++)
+            sv.emplace_back(i + 1, 'x');
+
+        auto cp(sv);
+        ASSERT_TRUE(std::equal(sv.begin(), sv.end(), cp.begin(), cp.end()));
+
+        auto mv(std::move(cp));
+        ASSERT_TRUE(cp.empty());
+        ASSERT_TRUE(std::equal(sv.begin(), sv.end(), mv.begin(), mv.end()));
+
+        rtl::SmallVector<std::string, 4> asg{"a", "b", "c", "d", "e"};
+        asg = sv;
+        ASSERT_TRUE(std::equal(sv.begin(), sv.end(), asg.begin(), asg.end()));
+        asg = std::move(mv);
+        ASSERT_TRUE(mv.empty());
+        ASSERT_TRUE(std::equal(sv.begin(), sv.end(), asg.begin(), asg.end()));
+
+        sv.push_back(sv.front());   // self-referencing insertion may trigger reallocation
+        ASSERT_EQ(sv.back(), sv.front());
+    }
+}
+
+TEST(t_small_vector, aligned_elements)
+{
+    auto gen = rtl::test::Random::uniformCallable<double>(-1.0, 1.0);
+    rtl::SmallVector<rtl::RigidTf3d, 2> sv;
+    std::vector<rtl::RigidTf3d> ref;
+    for (size_t i = 0; i < 10; i++)
+    {
+        ref.push_back(rtl::RigidTf3d::random(gen));
+        sv.push_back(ref.back());
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(&sv.back()) % alignof(rtl::RigidTf3d), 0);
+    }
+    for (size_t i = 0; i < ref.size(); i++)
+        ASSERT_EQ(sv[i].trVec(), ref[i].trVec());
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,183 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "rtl/Core.h"
+#include "rtl/Transformation.h"
+#include "rtl/Vectorization.h"
+#include "rtl/seg/CAR_Segmenter.h"
+#include "rtl/Test.h"
+
+// Layout of a typical sensor_msgs/PointCloud2 point: x, y, z, padding, intensity, ring.
+struct DriverPoint
+{
+    float x, y, z, pad;
+    float intensity;
+    uint16_t ring;
+};
+
+static std::vector<DriverPoint> driverBuffer(const std::vector<rtl::Vector3f> &pts)
+{
+    std::vector<DriverPoint> buf(pts.size());
+    for (size_t i = 0; i < pts.size(); i++)
+        buf[i] = DriverPoint{pts[i].x(), pts[i].y(), pts[i].z(), 0.0f, (float) i, (uint16_t) (i % 16)};
+    return buf;
+}
+
+static std::vector<rtl::Vector3f> randomPoints(size_t n)
+{
+    auto gen = rtl::test::Random::uniformCallable<float>(-10.0f, 10.0f);
+    std::vector<rtl::Vector3f> pts;
+    for (size_t i = 0; i < n; i++)
+        pts.push_back(rtl::Vector3f::random(gen));
+    return pts;
+}
+
+TEST(t_strided_span, access)
+{
+    auto pts = randomPoints(100);
+    auto buf = driverBuffer(pts);
+    rtl::StridedSpan<const rtl::Vector3f> view(buf.data(), buf.size(), sizeof(DriverPoint), offsetof(DriverPoint, x));
+    ASSERT_EQ(view.size(), pts.size());
+    ASSERT_FALSE(view.contiguous());
+    ASSERT_EQ(view.front(), pts.front());
+    ASSERT_EQ(view.back(), pts.back());
+    for (size_t i = 0; i < pts.size(); i++)
+        ASSERT_EQ(view[i], pts[i]);
+    ASSERT_TRUE(std::equal(view.begin(), view.end(), pts.begin(), pts.end()));
+    ASSERT_EQ(view.end() - view.begin(), (std::ptrdiff_t) pts.size());
+
+    auto sub = view.subspan(10, 5);
+    ASSERT_EQ(sub.size(), 5);
+    ASSERT_EQ(sub[0], pts[10]);
+    ASSERT_EQ(view.map().col(42), pts[42].data());
+    ASSERT_THROW((void) view.span(), std::invalid_argument);
+    std::vector<rtl::Vector3f> scratch;
+    auto packed = view.span(scratch);
+    ASSERT_TRUE(std::equal(packed.begin(), packed.end(), pts.begin(), pts.end()));
+
+    rtl::StridedSpan<const rtl::Vector3f> dense = rtl::Span<const rtl::Vector3f>(pts);
+    ASSERT_TRUE(dense.contiguous());
+    ASSERT_EQ(dense.span().data(), pts.data());
+    ASSERT_EQ(dense.span(scratch).data(), pts.data());
+    rtl::StridedSpan<const rtl::Vector3f> raw(&pts.front().data()(0), pts.size(), sizeof(rtl::Vector3f));
+    ASSERT_EQ(raw[7], pts[7]);
+
+    rtl::StridedSpan<rtl::Vector3f> writable(buf.data(), buf.size(), sizeof(DriverPoint), offsetof(DriverPoint, x));
+    writable.set(3, rtl::Vector3f(1.0f, 2.0f, 3.0f));
+    ASSERT_EQ(buf[3].x, 1.0f);
+    ASSERT_EQ(buf[3].z, 3.0f);
+    ASSERT_EQ(buf[3].intensity, 3.0f);
+    rtl::StridedSpan<const rtl::Vector3f> converted = writable;
+    ASSERT_EQ(converted[3], rtl::Vector3f(1.0f, 2.0f, 3.0f));
+
+    ASSERT_THROW(rtl::StridedSpan<const rtl::Vector3f>(buf.data(), buf.size(), sizeof(DriverPoint) - 2, 0), std::invalid_argument);
+    ASSERT_THROW(rtl::StridedSpan<const rtl::Vector3f>(buf.data(), buf.size(), sizeof(DriverPoint), 1), std::invalid_argument);
+    ASSERT_THROW(rtl::StridedSpan<const rtl::Vector3f>(buf.data(), buf.size(), 8, 0), std::invalid_argument);
+}
+
+TEST(t_strided_span, consumers)
+{
+    auto pts = randomPoints(1000);
+    auto buf = driverBuffer(pts);
+    rtl::StridedSpan<const rtl::Vector3f> view(buf.data(), buf.size(), sizeof(DriverPoint), offsetof(DriverPoint, x));
+
+    rtl::BoundingBox3f bb_ref(pts.front()), bb(pts.front());
+    bb_ref.addPoints(pts);
+    bb.addPoints(view);
+    ASSERT_EQ(bb.min(), bb_ref.min());
+    ASSERT_EQ(bb.max(), bb_ref.max());
+
+    rtl::PointCloudND<3, float> cloud;
+    cloud.addPoint(rtl::Vector3f::zeros());
+    cloud.addPoints(view);
+    ASSERT_EQ(cloud.size(), pts.size() + 1);
+    for (size_t i = 0; i < pts.size(); i++)
+        ASSERT_EQ(cloud.getPoint(i + 1), pts[i]);
+
+    auto gen = rtl::test::Random::uniformCallable<float>(-1.0f, 1.0f);
+    auto tf = rtl::RigidTf3f::random(gen);
+    std::vector<rtl::Vector3f> transformed(pts.size());
+    tf.transformPoints(view, rtl::Span<rtl::Vector3f>(transformed));
+    rtl::StridedSpan<rtl::Vector3f> in_place(buf.data(), buf.size(), sizeof(DriverPoint), offsetof(DriverPoint, x));
+    tf.transformPoints(in_place, in_place);
+    for (size_t i = 0; i < pts.size(); i++)
+    {
+        ASSERT_LT(rtl::Vector3f::distance(transformed[i], tf(pts[i])), 1e-5f);
+        ASSERT_EQ(in_place[i], transformed[i]);
+        ASSERT_EQ(buf[i].intensity, (float) i);
+        ASSERT_EQ(buf[i].ring, i % 16);
+    }
+    ASSERT_THROW(tf.transformPoints(view, in_place.subspan(0, 10)), std::invalid_argument);
+}
+
+TEST(t_strided_span, vectorization_and_segmentation)
+{
+    std::vector<rtl::Vector3f> scan;
+    for (size_t i = 0; i < 720; i++)
+    {
+        float a = rtl::C_PI<float> * 2.0f * (float) i / 720.0f;
+        float r = i < 360 ? 5.0f : 8.0f;
+        scan.emplace_back(r * std::cos(a), r * std::sin(a), 0.5f);
+    }
+    auto buf = driverBuffer(scan);
+    rtl::StridedSpan<const rtl::Vector3f> view(buf.data(), buf.size(), sizeof(DriverPoint), offsetof(DriverPoint, x));
+
+    rtl::VectorizerFTLSProjections3D<float, double> vect_ref, vect;
+    vect_ref.setSigma(0.05f);
+    vect.setSigma(0.05f);
+    ASSERT_TRUE(vect_ref(scan));
+    ASSERT_TRUE(vect(view));
+    ASSERT_GT(vect_ref.lineSegments().size(), 2);
+    ASSERT_EQ(vect.lineSegments().size(), vect_ref.lineSegments().size());
+    for (size_t i = 0; i < vect.lineSegments().size(); i++)
+    {
+        ASSERT_EQ(vect.lineSegments()[i].beg(), vect_ref.lineSegments()[i].beg());
+        ASSERT_EQ(vect.lineSegments()[i].end(), vect_ref.lineSegments()[i].end());
+    }
+
+    rtl::VectorizerDouglasPeuckerND<3, float> dp;
+    dp.setEpsilon(0.05f);
+    std::vector<rtl::LineSegment3f> dp_ref, dp_out;
+    dp(scan, dp_ref);
+    dp(view, dp_out);
+    ASSERT_EQ(dp_out.size(), dp_ref.size());
+
+    rtl::CAR_Segmenter<rtl::Vector3f> seg_ref(3, 0.1f, 0.5f), seg(3, 0.1f, 0.5f);
+    seg_ref.loadData(scan);
+    seg.loadData(view);
+    ASSERT_GT(seg_ref.clustersAvailable(), 0);
+    ASSERT_EQ(seg.clustersAvailable(), seg_ref.clustersAvailable());
+    for (size_t c = 0; c < seg.clustersAvailable(); c++)
+    {
+        auto cl = seg.cluster(c), cl_ref = seg_ref.cluster(c);
+        ASSERT_TRUE(std::equal(cl.begin(), cl.end(), cl_ref.begin(), cl_ref.end()));
+    }
+}
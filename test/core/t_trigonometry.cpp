@@ -0,0 +1,117 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+#include "rtl/Core.h"
+#include "rtl/Transformation.h"
+#include "rtl/Test.h"
+
+template<typename T>
+std::vector<T> randomAngles(size_t n, T range)
+{
+    std::vector<T> ret(n);
+    for (auto &a : ret)
+        a = rtl::test::Random::uniformValue<T>(-range, range);
+    return ret;
+}
+
+template<typename T>
+class TrigonometryTest : public testing::Test
+{
+};
+
+typedef testing::Types<float, double> TestTypes;
+TYPED_TEST_SUITE(TrigonometryTest, TestTypes);
+
+TYPED_TEST(TrigonometryTest, fast_error_bounds)
+{
+    using T = TypeParam;
+    for (auto a : randomAngles<T>(100000, T(1000)))
+    {
+        T s, c;
+        rtl::TrigFast::sincos(a, s, c);
+        EXPECT_LE(std::abs(s - std::sin((double) a)), rtl::TrigFast::sincos_max_error);
+        EXPECT_LE(std::abs(c - std::cos((double) a)), rtl::TrigFast::sincos_max_error);
+    }
+    for (T a : {T(0), rtl::C_PI_2<T>, rtl::C_PI<T>, -rtl::C_PI_2<T>, -rtl::C_PI<T>})
+    {
+        T s, c;
+        rtl::TrigFast::sincos(a, s, c);
+        EXPECT_NEAR(s, std::sin(a), rtl::TrigFast::sincos_max_error);
+        EXPECT_NEAR(c, std::cos(a), rtl::TrigFast::sincos_max_error);
+    }
+
+    auto ys = randomAngles<T>(100000, T(10)), xs = randomAngles<T>(100000, T(10));
+    for (size_t i = 0; i < ys.size(); i++)
+        EXPECT_LE(std::abs(rtl::TrigFast::atan2(ys[i], xs[i]) - std::atan2((double) ys[i], (double) xs[i])), rtl::TrigFast::atan2_max_error);
+    for (T y : {T(-1), T(0), T(1)})
+        for (T x : {T(-1), T(0), T(1)})
+            EXPECT_NEAR(rtl::TrigFast::atan2(y, x), std::atan2(y, x), rtl::TrigFast::atan2_max_error);
+}
+
+TYPED_TEST(TrigonometryTest, batch_rotations)
+{
+    using T = TypeParam;
+    auto angles = randomAngles<T>(1000, T(10));
+    auto tr_x = randomAngles<T>(angles.size(), T(10)), tr_y = randomAngles<T>(angles.size(), T(10));
+
+    std::vector<rtl::Rotation2D<T>> rot_std(angles.size()), rot_fast(angles.size());
+    rtl::Rotation2D<T>::fromAngles(angles, rot_std);
+    rtl::Rotation2D<T>::template fromAngles<rtl::TrigFast>(angles, rot_fast);
+    std::vector<rtl::RigidTf2D<T>> tf_fast(angles.size());
+    rtl::RigidTf2D<T>::template fromAngles<rtl::TrigFast>(angles, tr_x, tr_y, tf_fast);
+
+    for (size_t i = 0; i < angles.size(); i++)
+    {
+        rtl::Rotation2D<T> ref(angles[i]);
+        EXPECT_NEAR(rot_std[i].rotCos(), ref.rotCos(), rtl::test::type<T>::allowedError());
+        EXPECT_NEAR(rot_std[i].rotSin(), ref.rotSin(), rtl::test::type<T>::allowedError());
+        EXPECT_NEAR(rot_fast[i].rotCos(), ref.rotCos(), rtl::TrigFast::sincos_max_error);
+        EXPECT_NEAR(rot_fast[i].rotSin(), ref.rotSin(), rtl::TrigFast::sincos_max_error);
+        EXPECT_EQ(tf_fast[i].rotCos(), rot_fast[i].rotCos());
+        EXPECT_EQ(tf_fast[i].rotSin(), rot_fast[i].rotSin());
+        EXPECT_EQ(tf_fast[i].trVecX(), tr_x[i]);
+        EXPECT_EQ(tf_fast[i].trVecY(), tr_y[i]);
+        EXPECT_NEAR(std::remainder(rot_fast[i].template rotAngle<rtl::TrigFast>() - angles[i], 2 * rtl::C_PI<T>), 0,
+                    rtl::TrigFast::atan2_max_error + 10 * rtl::test::type<T>::allowedError());
+    }
+
+    rtl::Rotation2D<T> rot;
+    rot.template setAngle<rtl::TrigFast>(angles[0]);
+    EXPECT_EQ(rot.rotCos(), rot_fast[0].rotCos());
+    EXPECT_THROW(rtl::Rotation2D<T>::fromAngles(angles, rtl::Span<rtl::Rotation2D<T>>(rot_std.data(), 1)), std::invalid_argument);
+    EXPECT_THROW(rtl::RigidTf2D<T>::fromAngles(angles, tr_x, rtl::Span<const T>(), tf_fast), std::invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,248 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "rtl/Core.h"
+#include "rtl/Transformation.h"
+#include "rtl/Test.h"
+#include "rtl/io/BinaryLog.h"
+
+static const std::string log_file = "t_io_binary_log.rtlb";
+
+template<int dim, typename E>
+std::vector<rtl::VectorND<dim, E>> randomPoints(size_t n)
+{
+    auto gen = rtl::test::Random::uniformCallable<E>(-10, 10);
+    std::vector<rtl::VectorND<dim, E>> pts;
+    for (size_t i = 0; i < n; i++)
+        pts.push_back(rtl::VectorND<dim, E>::random(gen));
+    return pts;
+}
+
+TEST(t_io_binary_log, points_and_segments)
+{
+    auto pts3f = randomPoints<3, float>(1001);
+    auto pts2d = randomPoints<2, double>(17);
+    std::vector<rtl::LineSegment2D<double>> segments;
+    for (size_t i = 1; i < pts2d.size(); i++)
+        segments.emplace_back(pts2d[i - 1], pts2d[i]);
+    {
+        rtl::BinaryLogWriter writer(log_file);
+        writer.writePoints(pts3f, 10);
+        writer.writePoints(rtl::Span<const rtl::Vector2D<double>>(pts2d), 20);
+        writer.writeLineSegments(segments, 30);
+        writer.writePoints(std::vector<rtl::Vector3f>(), 40);
+    }
+
+    rtl::BinaryLogReader reader(log_file);
+    ASSERT_EQ(reader.version(), 1);
+    ASSERT_EQ(reader.size(), 4);
+    ASSERT_FALSE(reader.truncated());
+
+    const auto &r0 = reader[0];
+    ASSERT_EQ(r0.type(), rtl::BinaryLogRecordType::points);
+    ASSERT_EQ(r0.timestamp(), 10);
+    ASSERT_TRUE((r0.holds<3, float>()));
+    ASSERT_FALSE((r0.holds<3, double>()));
+    auto span3f = r0.points<3, float>();
+    ASSERT_EQ(span3f.size(), pts3f.size());
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(span3f.data()) % 16, 0);
+    for (size_t i = 0; i < pts3f.size(); i++)
+        ASSERT_EQ(span3f[i], pts3f[i]);
+    ASSERT_THROW((void) (r0.points<2, float>()), std::invalid_argument);
+    ASSERT_THROW((void) (r0.points<3, double>()), std::invalid_argument);
+    ASSERT_THROW((void) (r0.lineSegmentEndpoints<3, float>()), std::invalid_argument);
+
+    auto span2d = reader[1].points<2, double>();
+    ASSERT_EQ(reader[1].timestamp(), 20);
+    ASSERT_TRUE(std::equal(span2d.begin(), span2d.end(), pts2d.begin(), pts2d.end()));
+
+    std::vector<rtl::LineSegment2D<double>> restored;
+    reader[2].lineSegments(restored);
+    ASSERT_EQ(restored.size(), segments.size());
+    for (size_t i = 0; i < segments.size(); i++)
+    {
+        ASSERT_EQ(restored[i].beg(), segments[i].beg());
+        ASSERT_EQ(restored[i].end(), segments[i].end());
+    }
+
+    ASSERT_EQ(reader[3].size(), 0);
+    ASSERT_TRUE((reader[3].points<3, float>().empty()));
+
+    size_t cnt = 0;
+    for (const auto &rec : reader)
+        ASSERT_EQ(rec.timestamp(), 10 * (int64_t) ++cnt);
+    std::remove(log_file.c_str());
+}
+
+TEST(t_io_binary_log, transforms)
+{
+    auto gen = rtl::test::Random::uniformCallable<double>(-1, 1);
+    auto gen_f = rtl::test::Random::uniformCallable<float>(-1, 1);
+    std::vector<rtl::RigidTf3D<double>> tfs3;
+    std::vector<rtl::RigidTf2D<float>> tfs2;
+    for (size_t i = 0; i < 50; i++)
+    {
+        tfs3.push_back(rtl::RigidTf3D<double>::random(gen));
+        tfs2.push_back(rtl::RigidTf2D<float>::random(gen_f));
+    }
+    {
+        rtl::BinaryLogWriter writer(log_file);
+        writer.writeTransforms(tfs3);
+        writer.writeTransforms(tfs2);
+    }
+
+    rtl::BinaryLogReader reader(log_file);
+    ASSERT_EQ(reader.size(), 2);
+    std::vector<rtl::RigidTf3D<double>> restored3;
+    reader[0].transforms(restored3);
+    ASSERT_EQ(restored3.size(), tfs3.size());
+    for (size_t i = 0; i < tfs3.size(); i++)
+    {
+        ASSERT_EQ(restored3[i].rotMat(), tfs3[i].rotMat());
+        ASSERT_EQ(restored3[i].trVec(), tfs3[i].trVec());
+        ASSERT_NEAR(restored3[i].rotAngle(), tfs3[i].rotAngle(), 1e-9);
+    }
+    auto tf2 = reader[1].transform<2, float>(7);
+    ASSERT_EQ(tf2.rotMat(), tfs2[7].rotMat());
+    ASSERT_EQ(tf2.trVec(), tfs2[7].trVec());
+    ASSERT_THROW((reader[1].transform<2, float>(50)), std::out_of_range);
+    ASSERT_THROW((reader[1].transform<3, float>(0)), std::invalid_argument);
+    std::remove(log_file.c_str());
+}
+
+TEST(t_io_binary_log, tf_tree)
+{
+    auto gen = rtl::test::Random::uniformCallable<float>(-1, 1);
+    rtl::TfTree<int, rtl::RigidTf3f> int_tree(0);
+    for (int i = 1; i < 40; i++)
+        int_tree.insert(i, rtl::RigidTf3f::random(gen), i / 3);
+    rtl::TfTree<std::string, rtl::RigidTf2D<double>> str_tree("map");
+    str_tree.insert("odom", rtl::RigidTf2D<double>(0.5, 1.0, 2.0), "map");
+    str_tree.insert("base_link", rtl::RigidTf2D<double>(-0.2, 0.1, 0.0), "odom");
+    str_tree.insert("laser", rtl::RigidTf2D<double>(0.0, 0.3, 0.0), "base_link");
+    str_tree.insert("", rtl::RigidTf2D<double>(1.0, 0.0, 0.0), "map");
+    {
+        rtl::BinaryLogWriter writer(log_file);
+        writer.writeTfTree(int_tree, 1);
+        writer.writeTfTree(str_tree, 2);
+    }
+
+    rtl::BinaryLogReader reader(log_file);
+    ASSERT_EQ(reader.size(), 2);
+    ASSERT_EQ(reader[0].type(), rtl::BinaryLogRecordType::tf_tree);
+    ASSERT_EQ(reader[0].size(), 40);
+    auto int_restored = reader[0].tfTree<int, 3, float>();
+    for (int i = 1; i < 40; i++)
+    {
+        ASSERT_TRUE(int_restored.contains(i));
+        ASSERT_EQ(int_restored[i].parent()->key(), i / 3);
+        ASSERT_EQ(int_restored[i].tf().rotMat(), int_tree[i].tf().rotMat());
+        ASSERT_EQ(int_restored[i].tf().trVec(), int_tree[i].tf().trVec());
+    }
+    ASSERT_THROW((reader[0].tfTree<long, 3, float>()), std::invalid_argument);
+    ASSERT_THROW((reader[0].tfTree<std::string, 3, float>()), std::invalid_argument);
+
+    auto str_restored = reader[1].tfTree<std::string, 2, double>();
+    ASSERT_EQ(str_restored.root().key(), "map");
+    ASSERT_EQ(str_restored["laser"].parent()->key(), "base_link");
+    ASSERT_EQ(str_restored[""].parent()->key(), "map");
+    auto chain_tf = str_restored.tf("laser", "map").squash();
+    auto ref_tf = str_tree.tf("laser", "map").squash();
+    ASSERT_EQ(chain_tf.rotMat(), ref_tf.rotMat());
+    ASSERT_EQ(chain_tf.trVec(), ref_tf.trVec());
+    std::remove(log_file.c_str());
+}
+
+TEST(t_io_binary_log, malformed_files)
+{
+    auto pts = randomPoints<2, float>(100);
+    {
+        rtl::BinaryLogWriter writer(log_file);
+        writer.writePoints(pts, 1);
+        writer.writePoints(pts, 2);
+    }
+    std::ifstream ifs(log_file, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+
+    std::ofstream(log_file, std::ios::binary | std::ios::trunc).write(content.data(), (std::streamsize) content.size() - 20);
+    {
+        rtl::BinaryLogReader reader(log_file);
+        ASSERT_TRUE(reader.truncated());
+        ASSERT_EQ(reader.size(), 1);
+        ASSERT_EQ((reader[0].points<2, float>().size()), pts.size());
+    }
+
+    // a count wrapping the payload size computation must not pass the bounds check
+    std::string corrupted = content;
+    uint64_t huge_count = (uint64_t(1) << 61) + pts.size();
+    std::memcpy(&corrupted[rtl::detail::binary_log_header_size + 8], &huge_count, 8);
+    std::ofstream(log_file, std::ios::binary | std::ios::trunc).write(corrupted.data(), (std::streamsize) corrupted.size());
+    {
+        rtl::BinaryLogReader reader(log_file);
+        ASSERT_THROW((void) (reader[0].points<2, float>()), std::invalid_argument);
+    }
+
+    rtl::TfTree<int, rtl::RigidTf3f> tree(0);
+    tree.insert(1, rtl::RigidTf3f::identity(), 0);
+    {
+        rtl::BinaryLogWriter writer(log_file);
+        writer.writeTfTree(tree, 1);
+    }
+    ifs.open(log_file, std::ios::binary);
+    corrupted.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+    uint32_t key_size = 2;
+    std::memcpy(&corrupted[rtl::detail::binary_log_header_size + rtl::detail::binary_log_record_header_size + sizeof(rtl::detail::BinaryLogTreeNode) + 4], &key_size, 4);
+    std::ofstream(log_file, std::ios::binary | std::ios::trunc).write(corrupted.data(), (std::streamsize) corrupted.size());
+    {
+        rtl::BinaryLogReader reader(log_file);
+        ASSERT_THROW((reader[0].tfTree<int, 3, float>()), std::invalid_argument);
+    }
+
+    std::ofstream(log_file, std::ios::binary | std::ios::trunc).write("RTLX", 4);
+    ASSERT_THROW(rtl::BinaryLogReader{log_file}, std::invalid_argument);
+    std::ofstream(log_file, std::ios::binary | std::ios::trunc);
+    ASSERT_THROW(rtl::BinaryLogReader{log_file}, std::invalid_argument);
+    std::remove(log_file.c_str());
+    ASSERT_THROW(rtl::BinaryLogReader{log_file}, std::runtime_error);
+
+    // write errors are reported, e.g. on a full disk
+    if (std::ifstream("/dev/full").good())
+    {
+        rtl::BinaryLogWriter writer("/dev/full");
+        auto many_pts = randomPoints<3, double>(100000);
+        ASSERT_THROW(writer.writePoints(many_pts, 1), std::runtime_error);
+    }
+}
@@ -0,0 +1,150 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+
+#include <gtest/gtest.h>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "rtl/Core.h"
+#include "rtl/Transformation.h"
+#include "rtl/Test.h"
+#include "rtl/io/StdLib.h"
+#include "rtl/io/TextParser.h"
+
+template<typename T>
+std::string printed(const T &obj)
+{
+    std::ostringstream os;
+    os << std::setprecision(std::numeric_limits<typename T::ElementType>::max_digits10) << obj;
+    return os.str();
+}
+
+TEST(t_io_text_parser, vectors_and_matrices)
+{
+    auto gen = rtl::test::Random::uniformCallable<double>(-1e3, 1e3);
+    for (size_t i = 0; i < 100; i++)
+    {
+        auto v2 = rtl::Vector2D<double>::random(gen);
+        ASSERT_EQ(rtl::io::parse<rtl::Vector2D<double>>(printed(v2)), v2);
+        auto v5 = rtl::VectorND<5, double>::random(gen);
+        ASSERT_EQ((rtl::io::parse<rtl::VectorND<5, double>>(printed(v5))), v5);
+        auto m = rtl::Matrix<3, 2, double>::random(gen);
+        ASSERT_EQ((rtl::io::parse<rtl::Matrix<3, 2, double>>(printed(m))), m);
+    }
+
+    ASSERT_EQ(rtl::io::parse<rtl::Vector3f>(" 1 +2.5\t-3e2 "), rtl::Vector3f(1.0f, 2.5f, -300.0f));
+    ASSERT_EQ(rtl::io::parse<rtl::Vector3f>("[1,2,3]"), rtl::Vector3f(1.0f, 2.0f, 3.0f));
+    ASSERT_THROW(rtl::io::parse<rtl::Vector3f>("[1, 2]"), std::invalid_argument);
+    ASSERT_THROW(rtl::io::parse<rtl::Vector3f>("[1, 2, 3"), std::invalid_argument);
+    ASSERT_THROW(rtl::io::parse<rtl::Vector3f>("[1, 2, 3] 4"), std::invalid_argument);
+    ASSERT_THROW(rtl::io::parse<rtl::Vector3f>("1, x, 3"), std::invalid_argument);
+
+    std::string text = "[1, 2] [3, 4]";
+    rtl::Vector2f a, b;
+    auto res = rtl::io::fromChars(text.data(), text.data() + text.size(), a);
+    ASSERT_EQ(res.ec, std::errc());
+    res = rtl::io::fromChars(res.ptr, text.data() + text.size(), b);
+    ASSERT_EQ(res.ec, std::errc());
+    ASSERT_EQ(res.ptr, text.data() + text.size());
+    ASSERT_EQ(b, rtl::Vector2f(3.0f, 4.0f));
+}
+
+TEST(t_io_text_parser, quaternions_and_transforms)
+{
+    auto gen = rtl::test::Random::uniformCallable<double>(-1, 1);
+    auto ang_gen = rtl::test::Random::uniformCallable<double>(-rtl::C_PI<double>, rtl::C_PI<double>);
+    for (size_t i = 0; i < 100; i++)
+    {
+        auto q = rtl::Quaternion<double>::random(gen);
+        auto q_parsed = rtl::io::parse<rtl::Quaternion<double>>(printed(q));
+        ASSERT_EQ(q_parsed.w(), q.w());
+        ASSERT_EQ(q_parsed.x(), q.x());
+        ASSERT_EQ(q_parsed.y(), q.y());
+        ASSERT_EQ(q_parsed.z(), q.z());
+
+        auto tf2 = rtl::RigidTf2D<double>(ang_gen(), gen(), gen());
+        auto tf2_parsed = rtl::io::parse<rtl::RigidTf2D<double>>(printed(tf2));
+        ASSERT_EQ(tf2_parsed.rotMat(), tf2.rotMat());
+        ASSERT_EQ(tf2_parsed.trVec(), tf2.trVec());
+
+        auto tf3 = rtl::RigidTf3D<double>::random(gen);
+        auto tf3_parsed = rtl::io::parse<rtl::RigidTf3D<double>>(printed(tf3));
+        ASSERT_EQ(tf3_parsed.rotMat(), tf3.rotMat());
+        ASSERT_EQ(tf3_parsed.trVec(), tf3.trVec());
+        ASSERT_NEAR(tf3_parsed.rotAngle(), tf3.rotAngle(), 1e-9);
+    }
+    ASSERT_THROW(rtl::io::parse<rtl::Quaternion<float>>("1 + 2i + 3k + 4j"), std::invalid_argument);
+    ASSERT_THROW(rtl::io::parse<rtl::RigidTf2D<float>>("R: [1, 0; 0, 1]"), std::invalid_argument);
+}
+
+TEST(t_io_text_parser, point_clouds)
+{
+    auto gen = rtl::test::Random::uniformCallable<float>(-100, 100);
+    std::vector<rtl::Vector3f> pts;
+    std::ostringstream csv, ssv;
+    csv << std::setprecision(std::numeric_limits<float>::max_digits10) << "x,y,z,intensity\n";
+    ssv << std::setprecision(std::numeric_limits<float>::max_digits10);
+    for (size_t i = 0; i < 20000; i++)
+    {
+        pts.push_back(rtl::Vector3f::random(gen));
+        csv << pts.back().x() << ", " << pts.back().y() << "," << pts.back().z() << "," << i << "\r\n";
+        ssv << pts.back().x() << "  " << pts.back().y() << "\t" << pts.back().z() << "\n";
+        if (i % 1000 == 0)
+        {
+            csv << "# comment\n\n";
+            ssv << "   \n";
+        }
+    }
+
+    for (size_t threads : {1, 3, 8})
+    {
+        rtl::PointCloudND<3, float> cloud;
+        cloud.addPoint(rtl::Vector3f(1.0f, 2.0f, 3.0f));
+        rtl::io::parsePointCloud(csv.str(), cloud, ',', 1, rtl::ThreadExecutor(threads));
+        ASSERT_EQ(cloud.size(), pts.size() + 1);
+        ASSERT_EQ(cloud.getPoint(0), rtl::Vector3f(1.0f, 2.0f, 3.0f));
+        for (size_t i = 0; i < pts.size(); i++)
+            ASSERT_EQ(cloud.getPoint(i + 1), pts[i]);
+
+        rtl::PointCloudND<3, float> cloud_ssv;
+        rtl::io::parsePointCloud(ssv.str(), cloud_ssv, ' ', 0, rtl::ThreadExecutor(threads));
+        ASSERT_EQ(cloud_ssv.size(), pts.size());
+        for (size_t i = 0; i < pts.size(); i++)
+            ASSERT_EQ(cloud_ssv.getPoint(i), pts[i]);
+    }
+
+    rtl::PointCloudND<2, float> cloud;
+    rtl::io::parsePointCloud("1,2\n3,4\n", cloud);
+    ASSERT_EQ(cloud.size(), 2);
+    ASSERT_THROW(rtl::io::parsePointCloud("1,2\n3;4\n", cloud), std::invalid_argument);
+    ASSERT_THROW(rtl::io::parsePointCloud("1,2\n3\n", cloud), std::invalid_argument);
+    ASSERT_THROW(rtl::io::parsePointCloud("1,2a\n", cloud), std::invalid_argument);
+    ASSERT_EQ(cloud.size(), 2);
+    ASSERT_THROW(rtl::io::readPointCloud("t_io_text_parser_missing.csv", cloud), std::runtime_error);
+}
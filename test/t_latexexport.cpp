@@ -24,6 +24,10 @@
 //
 // Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
 
+#include <iostream>
+#include <sstream>
+#include <vector>
+
 #include "rtl/io/LaTeXDoc.h"
 
 int main()
@@ -251,5 +255,36 @@ int main()
     le3.addFace(rtl::RigidTf3f(-rtl::C_PIf / 2.0f, rtl::Vector3f::baseY(), rtl::Vector3f(0, 0, 0.5))(square), "style={fill=magenta}", "style={fill=black}", "");
     ld.addGridLE(rot_view_lambda_const_dist, 4, 20);
 
+    rtl::LaTeXTable buffered, streamed;
+    for (auto *tab : {&buffered, &streamed})
+    {
+        tab->setColumnStyle("l|r|r|r");
+        tab->setHeading({"Run", "Points", "Time [ms]", "Error"});
+        tab->setPrecision(3);
+    }
+    std::ostringstream buffered_tex, streamed_tex;
+    streamed.beginStream(streamed_tex);
+    for (auto *tab : {&buffered, &streamed})
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            tab->addRowCells("run " + std::to_string(i), 1000 * i, 0.125 * i, 1.0f / float(i + 1));
+            if (i % 100 == 99)
+                tab->addHLine();
+        }
+        tab->addRow(std::vector<double>{-1.0, 2.5, 1e3});
+    }
+    buffered.writeTable(buffered_tex, "Benchmark");
+    streamed.endStream("Benchmark");
+    std::cout << "Streamed table equal to buffered: " << (buffered_tex.str() == streamed_tex.str() ? "OK" : "FAILED") << std::endl;
+
+    rtl::LaTeXTable report;
+    report.setColumnStyle("r|r");
+    report.setHeading({"$n$", "$\\sqrt{n}$"});
+    ld.beginTable(report);
+    for (int i = 0; i < 40; i++)
+        report.addRowCells(i, std::sqrt(float(i)));
+    ld.endTable(report, "Table streamed into the document");
+
     return 0;
 }
\ No newline at end of file
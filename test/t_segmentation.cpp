@@ -24,6 +24,7 @@
 //
 // Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
 
+#include <gtest/gtest.h>
 #include <vector>
 #include <chrono>
 #include <random>
@@ -31,6 +32,7 @@
 #include "rtl/Core.h"
 #include "rtl/seg/CAR_Segmenter.h"
 #include "rtl/seg/IA_Segmenter.h"
+#include "rtl/seg/MRA_Segmenter.h"
 #include "rtl/io/LaTeXDoc.h"
 
 template<typename T>
@@ -199,7 +201,160 @@ void testIA_Segmenter3D(std::vector<rtl::Vector3f> points, rtl::LaTeXTikz3D &le)
     }
 }
 
-int main()
+TEST(t_segmentation, car_sectors)
+{
+    // two arcs of different radii, the first one is closed across the beginning of the scan
+    std::vector<rtl::Vector2f> points;
+    for (size_t i = 0; i < 1000; i++)
+    {
+        float a = 2.0f * rtl::C_PIf * (float)i / 1000.0f, r = (i >= 300 && i < 600) ? 1.5f : 1.0f;
+        points.emplace_back(r * std::cos(a), r * std::sin(a));
+    }
+
+    rtl::CAR_Segmenter<rtl::Vector2f> seg(10, 0.01, 0.1);
+    seg.loadData(points);
+    ASSERT_EQ(seg.clusterCount(), 2);
+    auto cl = seg.cluster(0);
+    ASSERT_EQ(cl.size(), 700);
+    EXPECT_EQ(cl.front(), points[600]);
+    EXPECT_EQ(cl.back(), points[299]);
+    ASSERT_EQ(seg.cluster(1).size(), 300);
+    EXPECT_EQ(seg.cluster(1).front(), points[300]);
+
+    // sector-parallel segmentation has to give the same result for any number of sectors
+    std::vector<rtl::Vector2f> noisy = genStepCycle<float>(10000, 1.0, 0.01);
+    for (size_t i = 0; i < noisy.size(); i += 997)
+        noisy[i] = rtl::Vector2f::nan();
+    seg.loadData(noisy);
+    for (size_t threads : {2, 3, 8, 64})
+    {
+        rtl::CAR_Segmenter<rtl::Vector2f, rtl::ThreadExecutor> seg_par(10, 0.01, 0.1, rtl::ThreadExecutor(threads));
+        seg_par.loadData(noisy);
+        ASSERT_EQ(seg_par.clusterRanges(), seg.clusterRanges());
+        ASSERT_EQ(seg_par.clusteredPoints().size(), seg.clusteredPoints().size());
+        EXPECT_TRUE(std::equal(seg_par.clusteredPoints().begin(), seg_par.clusteredPoints().end(), seg.clusteredPoints().begin()));
+    }
+
+    // offsets delimit the same clusters as the ranges
+    ASSERT_EQ(seg.clusterOffsets().size(), seg.clusterCount() + 1);
+    for (size_t c = 0; c < seg.clusterCount(); c++)
+    {
+        EXPECT_EQ(seg.clusterOffsets()[c], seg.clusterRanges()[c].first);
+        EXPECT_EQ(seg.clusterOffsets()[c + 1], seg.clusterRanges()[c].second);
+    }
+}
+
+TEST(t_segmentation, ia_flat_output)
+{
+    std::vector<rtl::Vector2f> points = genStepCycle<float>(5000, 1.0, 0.01);
+    float scaling = 2 * rtl::C_PIf * (float)10 / points.size();
+    rtl::IA_Segmenter<rtl::Vector2f> seg(10, 0.01, 0.1, scaling), seg_flat(10, 0.01, 0.1, scaling);
+    seg_flat.setFlatOutput(true);
+
+    const rtl::Vector2f *buffer = nullptr;
+    size_t capacity = 0;
+    for (size_t scan = 0; scan < 3; scan++)
+    {
+        seg_flat.clearClusters();
+        for (auto &p : points)
+        {
+            seg.addPoint(p);
+            seg_flat.addPoint(p);
+        }
+        EXPECT_EQ(seg_flat.closedClustersAvailable(), 0);
+        ASSERT_EQ(seg_flat.clusterCount(), seg.closedClustersAvailable());
+        ASSERT_EQ(seg_flat.clusterOffsets().back(), seg_flat.clusteredPoints().size());
+
+        // flat clusters are ordered by closing, grabbed ones by creation
+        std::vector<std::vector<rtl::Vector2f>> grabbed;
+        while (seg.closedClustersAvailable() > 0)
+            grabbed.push_back(seg.grabCluster());
+        for (size_t c = 0; c < seg_flat.clusterCount(); c++)
+        {
+            auto cl = seg_flat.cluster(c);
+            EXPECT_EQ(std::count_if(grabbed.begin(), grabbed.end(), [&cl](const auto &g) { return std::equal(g.begin(), g.end(), cl.begin(), cl.end()); }), 1);
+        }
+
+        // the buffer is reused once it has grown to the size of a scan
+        if (scan > 0 && seg_flat.clusteredPoints().size() <= capacity)
+        {
+            EXPECT_EQ(seg_flat.clusteredPoints().data(), buffer);
+        }
+        buffer = seg_flat.clusteredPoints().data();
+        capacity = seg_flat.clusteredPoints().capacity();
+    }
+}
+
+TEST(t_segmentation, ia_pool)
+{
+    std::vector<rtl::Vector2f> points = genStepCycle<float>(5000, 1.0, 0.01);
+    float scaling = 2 * rtl::C_PIf * (float)10 / points.size();
+    rtl::IA_Segmenter<rtl::Vector2f> seg_flat(10, 0.01, 0.1, scaling), seg_pool(10, 0.01, 0.1, scaling), seg_small(10, 0.01, 0.1, scaling);
+    seg_flat.setFlatOutput(true);
+
+    std::vector<std::vector<rtl::Vector2f>> pooled;
+    seg_pool.setPool(points.size(), [&pooled](rtl::Span<const rtl::Vector2f> cl) { pooled.emplace_back(cl.begin(), cl.end()); });
+    size_t small_cnt = 0, small_max = 0;
+    seg_small.setPool(100, [&](rtl::Span<const rtl::Vector2f> cl) { small_cnt += cl.size(); small_max = std::max(small_max, cl.size()); });
+    EXPECT_EQ(seg_small.poolCapacity(), 100);
+
+    // a stream of several scans, clusters are handed over in the order of closing as in the flat output
+    for (size_t scan = 0; scan < 4; scan++)
+        for (auto &p : points)
+        {
+            seg_flat.addPoint(p);
+            seg_pool.addPoint(p);
+            seg_small.addPoint(p);
+        }
+    EXPECT_EQ(seg_pool.closedClustersAvailable(), 0);
+    EXPECT_EQ(seg_pool.aliveClustersAvailable(), 0);
+    ASSERT_EQ(pooled.size(), seg_flat.clusterCount());
+    for (size_t c = 0; c < pooled.size(); c++)
+    {
+        auto cl = seg_flat.cluster(c);
+        EXPECT_TRUE(std::equal(pooled[c].begin(), pooled[c].end(), cl.begin(), cl.end()));
+    }
+
+    // the small pool hands over parts of long clusters, but no point is lost
+    EXPECT_LE(small_max, 100);
+    EXPECT_GE(small_cnt + 100 + 11, 4 * points.size());
+    EXPECT_LE(small_cnt, 4 * points.size());
+
+    EXPECT_THROW(seg_small.setPool(10, nullptr), std::invalid_argument);
+}
+
+TEST(t_segmentation, mra_rings)
+{
+    // cylindrical wall around the sensor with a box in front of it, spanning several rings
+    const size_t rings = 16, cols = 360;
+    std::vector<rtl::Vector3f> points;
+    for (size_t r = 0; r < rings; r++)
+        for (size_t c = 0; c < cols; c++)
+        {
+            float a = 2.0f * rtl::C_PIf * (float)c / (float)cols, d = (r >= 4 && r < 10 && c >= 100 && c < 120) ? 3.0f : 5.0f;
+            points.emplace_back(d * std::cos(a), d * std::sin(a), 0.1f * (float)r);
+        }
+    points[5 * cols + 200] = rtl::Vector3f::nan();
+
+    rtl::MRA_Segmenter<rtl::Vector3f> seg(4, 0.05f, 0.5f);
+    seg.loadData(points, rings);
+    ASSERT_EQ(seg.labels().size(), points.size());
+    EXPECT_EQ(seg.clusterCount(), 2);
+    EXPECT_EQ(seg.labels()[0], 0);
+    EXPECT_EQ(seg.labels()[15 * cols + 359], 0);
+    EXPECT_EQ(seg.labels()[4 * cols + 100], 1);
+    EXPECT_EQ(seg.labels()[9 * cols + 119], 1);
+    EXPECT_EQ(seg.labels()[5 * cols + 200], rtl::MRA_Segmenter<rtl::Vector3f>::invalid_label);
+
+    for (size_t threads : {2, 5, 16, 64})
+    {
+        rtl::MRA_Segmenter<rtl::Vector3f, rtl::ThreadExecutor> seg_par(4, 0.05f, 0.5f, rtl::ThreadExecutor(threads));
+        seg_par.loadData(points, rings);
+        EXPECT_EQ(seg_par.labels(), seg.labels());
+    }
+}
+
+int main(int argc, char **argv)
 {
     rtl::LaTeXDoc ld("t_segmentation_out", "seg_test");
     ld.setRemoveTmpDir([](const std::string &){ return true; });
@@ -218,4 +373,7 @@ int main()
 
     testIA_Segmenter3D(genStepSpiral<float>(1000, 1.0, 0.2, 5 * rtl::C_PIf, 0.01), le3d);
     ld.addLE(le3d, "IA segmenter in 3D.");
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
 }
\ No newline at end of file
@@ -33,6 +33,7 @@
 #include <string>
 #include <chrono>
 #include <random>
+#include <typeinfo>
 
 #include "rtl/Core.h"
 #include "rtl/Vectorization.h"
@@ -737,6 +738,587 @@ void tlsLine2D(size_t repeat, size_t point_nr, Element epsilon)
     }
 }
 
+template <typename Element, typename Compute, class EigenSolver>
+void tls3DEigenSolver(size_t repeat, size_t point_nr, Element epsilon)
+{
+    std::cout<<"\nTLS approximations in 3D with "<<typeid(EigenSolver).name()<<":"<<std::endl;
+    std::default_random_engine generator(17);
+    std::uniform_real_distribution<Element> rnd_element(-1, 1);
+    auto el_rnd_gen = [&generator, &rnd_element](){ return rnd_element(generator); };
+
+    size_t failed = 0;
+    for (size_t i = 0; i < repeat; i++)
+    {
+        std::vector<rtl::Vector3D<Element>> line, plane;
+        rtl::Vector3D<Element> origin = rtl::Vector3D<Element>::random(el_rnd_gen);
+        rtl::Vector3D<Element> dir1 = rtl::Vector3D<Element>::random(el_rnd_gen), dir2 = rtl::Vector3D<Element>::random(el_rnd_gen);
+        for (size_t j = 0; j < point_nr; j++)
+        {
+            rtl::Vector3D<Element> noise = rtl::Vector3D<Element>::random(el_rnd_gen) * 0.001f;
+            line.push_back(origin + dir1 * el_rnd_gen() + noise);
+            plane.push_back(origin + dir1 * el_rnd_gen() + dir2 * el_rnd_gen() + noise);
+        }
+
+        rtl::PrecArray3D<Element, Compute> arr_line, arr_plane;
+        arr_line.precompute(line);
+        arr_plane.precompute(plane);
+        rtl::ApproximationTlsLine3D<Element, Compute, EigenSolver> tls_line(arr_line.sums(point_nr));
+        rtl::ApproximationTlsLine3D<Element, Compute, rtl::EigenSolverIterative3D> ref_line(arr_line.sums(point_nr));
+        rtl::ApproximationTlsPlane3D<Element, Compute, EigenSolver> tls_plane(arr_plane.sums(point_nr));
+        rtl::ApproximationTlsPlane3D<Element, Compute, rtl::EigenSolverIterative3D> ref_plane(arr_plane.sums(point_nr));
+
+        if (std::abs(std::abs(tls_line.direction().dot(ref_line.direction())) - 1) < epsilon && std::abs(tls_line.errSquared() - ref_line.errSquared()) < epsilon &&
+            std::abs(std::abs(tls_plane.normal().dot(ref_plane.normal())) - 1) < epsilon && std::abs(tls_plane.errSquared() - ref_plane.errSquared()) < epsilon &&
+            std::abs(rtl::ApproximationTlsLine3D<Element, Compute, EigenSolver>::getErrorSquared(arr_line.sums(point_nr)) - ref_line.errSquared()) < epsilon &&
+            std::abs(rtl::ApproximationTlsPlane3D<Element, Compute, EigenSolver>::getErrorSquared(arr_plane.sums(point_nr)) - ref_plane.errSquared()) < epsilon)
+        {
+            auto line_bounds = rtl::ApproximationTlsLine3D<Element, Compute, EigenSolver>::getErrorSquaredBounds(arr_line.sums(point_nr));
+            auto plane_bounds = rtl::ApproximationTlsPlane3D<Element, Compute, EigenSolver>::getErrorSquaredBounds(arr_plane.sums(point_nr));
+            if (line_bounds.first <= ref_line.errSquared() + epsilon && ref_line.errSquared() <= line_bounds.second + epsilon &&
+                plane_bounds.first <= ref_plane.errSquared() + epsilon && ref_plane.errSquared() <= plane_bounds.second + epsilon)
+                continue;
+            std::cout<<"\tline bounds: "<<line_bounds.first<<", "<<line_bounds.second<<"\tplane bounds: "<<plane_bounds.first<<", "<<plane_bounds.second<<std::endl;
+        }
+
+        failed++;
+        std::cout<<"\tline: "<<tls_line.direction().x()<<", "<<tls_line.direction().y()<<", "<<tls_line.direction().z()<<"\terr: "<<tls_line.errSquared()<<std::endl;
+        std::cout<<"\tref:  "<<ref_line.direction().x()<<", "<<ref_line.direction().y()<<", "<<ref_line.direction().z()<<"\terr: "<<ref_line.errSquared()<<std::endl;
+        std::cout<<"\tplane: "<<tls_plane.normal().x()<<", "<<tls_plane.normal().y()<<", "<<tls_plane.normal().z()<<"\terr: "<<tls_plane.errSquared()<<std::endl;
+        std::cout<<"\tref:   "<<ref_plane.normal().x()<<", "<<ref_plane.normal().y()<<", "<<ref_plane.normal().z()<<"\terr: "<<ref_plane.errSquared()<<std::endl;
+    }
+    std::cout<<"\tFailed: "<<failed<<" of "<<repeat<<std::endl;
+}
+
+template<typename Element, typename Compute>
+struct ApproximationTlsLine3DNoBounds : public rtl::ApproximationTlsLine3D<Element, Compute>
+{
+    static void getErrorSquaredBounds() = delete;
+};
+
+void extractorErrorBounds(size_t point_nr, float sigma)
+{
+    std::cout<<"\nChain extraction pruned by error bounds:"<<std::endl;
+    auto pts = genCrown((int)point_nr, 7, 4, 2);
+    std::default_random_engine generator(11);
+    std::normal_distribution<float> noise(0, sigma / 2);
+    for (auto &p : pts)
+        p += rtl::Vector3f(noise(generator), noise(generator), noise(generator));
+    rtl::PrecArray3D<float, double> array;
+    array.precompute(pts);
+
+    rtl::ExtractorChainFast<rtl::PrecArray3D<float, double>, rtl::ApproximationTlsLine3D<float, double>> pruning;
+    rtl::ExtractorChainFast<rtl::PrecArray3D<float, double>, ApproximationTlsLine3DNoBounds<float, double>> plain;
+    pruning.setSigma(sigma);
+    plain.setSigma(sigma);
+    std::vector<rtl::ApproximationTlsLine3D<float, double>> appr_pruning;
+    std::vector<ApproximationTlsLine3DNoBounds<float, double>> appr_plain;
+    std::vector<std::pair<size_t, size_t>> ind_pruning, ind_plain;
+    rtl::VectorizationStats stats_pruning, stats_plain;
+    pruning(array, appr_pruning, ind_pruning, &stats_pruning);
+    plain(array, appr_plain, ind_plain, &stats_plain);
+
+    std::cout<<"\tPrimitives: "<<ind_pruning.size()<<", fits: "<<stats_pruning.fits<<" + "<<stats_pruning.pruned<<" pruned (without bounds: "<<stats_plain.fits<<")"<<std::endl;
+    std::cout<<"\tSame result: "<<(ind_pruning == ind_plain && stats_plain.pruned == 0 ? "OK" : "FAILED")<<std::endl;
+}
+
+template<typename Element, typename Compute>
+struct ApproximationTlsLine2DNoBatch : public rtl::ApproximationTlsLine2D<Element, Compute>
+{
+    static void getTotalErrorSquared() = delete;
+};
+
+void tlsLine2DBatch(size_t point_nr, size_t range_nr, float sigma)
+{
+    std::cout<<"\nBatch TLS fitting of "<<range_nr<<" ranges of "<<point_nr<<" points:"<<std::endl;
+    auto pts = genSpikes((int)point_nr, 5, 4, 8);
+    std::default_random_engine generator(23);
+    std::normal_distribution<float> noise(0, sigma);
+    for (auto &p : pts)
+        p += rtl::Vector2f(noise(generator), noise(generator));
+    rtl::PrecArray2D<float, double> array;
+    array.precompute(pts);
+
+    std::vector<size_t> breakpoints;
+    for (size_t i = 1; i < range_nr; i++)
+        breakpoints.push_back(i * point_nr / range_nr);
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (size_t i = 0; i < range_nr; i++)
+        ranges.emplace_back(i == 0 ? 0 : breakpoints[i - 1], i == range_nr - 1 ? point_nr : breakpoints[i]);
+
+    using Appr = rtl::ApproximationTlsLine2D<float, double>;
+    Appr::Batch batch;
+    Appr::fit(array, ranges, batch);
+    bool same = batch.size() == range_nr;
+    float total = 0;
+    for (size_t i = 0; i < range_nr && same; i++)
+    {
+        Appr single(array.sums(ranges[i].first, ranges[i].second));
+        total += single.errSquared();
+        same = std::abs(batch[i].errSquared() - single.errSquared()) < 1e-5f && std::abs(batch[i].c() - single.c()) < 1e-4f &&
+               std::abs(batch[i].direction().dot(single.direction()) - 1) < 1e-5f;
+    }
+    float batch_total = Appr::getTotalErrorSquared(array, 0, breakpoints, point_nr);
+    std::cout<<"\tBatch equal to single fits: "<<(same ? "OK" : "FAILED")<<std::endl;
+    std::cout<<"\tTotal error: "<<batch_total<<" (single fits: "<<total<<") "<<(std::abs(batch_total - total) < 1e-4f * (1 + total) ? "OK" : "FAILED")<<std::endl;
+
+    size_t repeat = 1000;
+    float sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repeat; r++)
+        for (const auto &range : ranges)
+            sink += Appr::getErrorSquared(array.sums(range.first, range.second));
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repeat; r++)
+        sink += Appr::getTotalErrorSquared(array, 0, breakpoints, point_nr);
+    auto t2 = std::chrono::steady_clock::now();
+    std::cout<<"\tTotal error evaluation: "<<std::chrono::duration<double, std::micro>(t1 - t0).count() / repeat<<" us one by one, "
+             <<std::chrono::duration<double, std::micro>(t2 - t1).count() / repeat<<" us batched"<<(sink > 0 ? "" : " ")<<std::endl;
+
+    rtl::ExtractorChainFast<rtl::PrecArray2D<float, double>, Appr> extractor;
+    extractor.setSigma(sigma * 3);
+    std::vector<Appr> appr_batch;
+    std::vector<std::pair<size_t, size_t>> ind_batch;
+    extractor(array, appr_batch, ind_batch);
+    std::vector<ApproximationTlsLine2DNoBatch<float, double>> appr_plain(ind_batch.size());
+    for (size_t i = 0; i < ind_batch.size(); i++)
+        appr_plain[i](array.sums(ind_batch[i].first, ind_batch[i].second));
+    auto ind_plain = ind_batch;
+    rtl::OptimizerTotalError<rtl::PrecArray2D<float, double>, Appr> opt_batch;
+    rtl::OptimizerTotalError<rtl::PrecArray2D<float, double>, ApproximationTlsLine2DNoBatch<float, double>> opt_plain;
+    opt_batch({}, array, appr_batch, ind_batch);
+    opt_plain({}, array, appr_plain, ind_plain);
+    std::cout<<"\tOptimizer with batch evaluation: "<<(ind_batch == ind_plain ? "OK" : "FAILED")<<std::endl;
+}
+
+template <typename Element, typename Compute>
+void tlsPrecomputedArrayAppend(size_t point_nr, size_t chunk_size, Compute epsilon)
+{
+    std::cout<<"\nPrecomputed array built by appending chunks of "<<chunk_size<<" points:"<<std::endl;
+    auto pts = genSpikes(point_nr, 5, 4, 8);
+    std::vector<rtl::Vector2D<Element>> vec(pts.begin(), pts.end());
+
+    rtl::PrecArray2D<Element, Compute> arr_whole, arr_chunks;
+    arr_whole.precompute(vec);
+    for (size_t i = 0; i < vec.size(); i += chunk_size)
+        arr_chunks.append(std::vector<rtl::Vector2D<Element>>(vec.begin() + i, vec.begin() + std::min(i + chunk_size, vec.size())));
+
+    size_t err_cnt = 0;
+    if (arr_whole.size() != arr_chunks.size())
+        err_cnt++;
+    else
+        for (size_t i = 0; i < arr_whole.size(); i++)
+            if ((arr_whole.array.row(i) - arr_chunks.array.row(i)).abs().maxCoeff() > epsilon)
+                err_cnt++;
+    std::cout<<"\tMismatched rows: "<<err_cnt<<std::endl;
+}
+
+template <typename Element, typename Compute>
+void compensatedPrecomputation(size_t point_nr, Element offset)
+{
+    std::cout<<"\nPrecomputed sums of "<<point_nr<<" points with offset "<<offset<<", compute type "<<typeid(Compute).name()<<":"<<std::endl;
+    std::vector<rtl::Vector2D<Element>> pts;
+    pts.reserve(point_nr);
+    for (size_t i = 0; i < point_nr; i++)
+        pts.emplace_back(offset + (Element)i / point_nr, offset + std::sin((Element)i));
+
+    rtl::PrecArray2D<Element, Compute> arr_plain, arr_kahan;
+    rtl::PrecArray2D<Element, long double> arr_ref;
+    arr_kahan.setCompensatedSummation(true);
+    arr_plain.precompute(pts);
+    arr_kahan.precompute(pts);
+    arr_ref.precompute(pts);
+
+    long double err_plain = 0, err_kahan = 0;
+    for (size_t i = 0; i < arr_ref.size(); i++)
+    {
+        err_plain = std::max(err_plain, (arr_plain.array.row(i).template cast<long double>() - arr_ref.array.row(i)).abs().maxCoeff());
+        err_kahan = std::max(err_kahan, (arr_kahan.array.row(i).template cast<long double>() - arr_ref.array.row(i)).abs().maxCoeff());
+    }
+    std::cout<<"\tMax. error plain: "<<(double)err_plain<<", compensated: "<<(double)err_kahan<<std::endl;
+}
+
+void centeredBlocksPrecision(size_t point_nr, float offset, size_t block_size)
+{
+    std::cout<<"\nFloat compute with centered blocks of "<<block_size<<" points, offset "<<offset<<":"<<std::endl;
+    std::vector<rtl::Vector2f> pts;
+    pts.reserve(point_nr);
+    for (size_t i = 0; i < point_nr; i++)
+        pts.emplace_back(offset + 10.0f * std::cos(i * 2e-5f), offset + 10.0f * std::sin(i * 2e-5f));
+
+    rtl::PrecArray2D<float, float> arr_plain, arr_blocks;
+    rtl::PrecArray2D<float, long double> arr_ref;
+    arr_blocks.setCenteredBlocks(block_size);
+    arr_plain.precompute(pts);
+    arr_blocks.precompute(pts);
+    arr_ref.precompute(pts);
+
+    auto dir_error = [](const auto &l, const auto &ref) {
+        return std::min((l.direction() - ref.direction()).length(), (l.direction() + ref.direction()).length());
+    };
+    float err_plain = 0, err_blocks = 0;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<size_t> beg_dist(0, point_nr - 1), len_dist(5, 2000);
+    for (size_t t = 0; t < 1000; t++)
+    {
+        size_t beg = beg_dist(gen), end = std::min(point_nr, beg + len_dist(gen));
+        if (end - beg < 5)
+            continue;
+        rtl::ApproximationTlsLine2D<float, long double> ref(arr_ref.sums(beg, end));
+        err_plain = std::max(err_plain, dir_error(rtl::ApproximationTlsLine2D<float, float>(arr_plain.sums(beg, end)), ref));
+        err_blocks = std::max(err_blocks, dir_error(rtl::ApproximationTlsLine2D<float, float>(arr_blocks.sums(beg, end)), ref));
+    }
+    std::cout<<"\tMax. direction error plain: "<<err_plain<<", centered blocks: "<<err_blocks<<std::endl;
+}
+
+void incrementalExtraction(size_t point_nr, float sigma)
+{
+    std::cout<<"\nIncremental extraction of "<<point_nr<<" points with sigma "<<sigma<<":"<<std::endl;
+    auto pts = genSpikes(point_nr, 5, 4, 8);
+
+    rtl::ExtractorChainIncremental<rtl::ApproximationTlsLine2D<float, double>> extractor;
+    extractor.setSigma(sigma);
+    std::vector<rtl::ApproximationTlsLine2D<float, double>> lines;
+    std::vector<std::pair<size_t, size_t>> indices;
+    extractor(pts, lines, indices);
+
+    float max_err = 0.0f;
+    for (const auto &ind : indices)
+    {
+        rtl::PrecSums2D<double> ps;
+        ps.setZero();
+        for (size_t i = ind.first; i < ind.second; i++)
+            ps += rtl::PrecSums2D<double>(pts[i].cast<double>());
+        max_err = std::max(max_err, rtl::ApproximationTlsLine2D<float, double>::getErrorSquared(ps));
+    }
+    std::cout<<"\tSegments: "<<lines.size()<<", max. error: "<<std::sqrt(max_err)<<(max_err < sigma * sigma ? " (OK)" : " (FAILED)")<<std::endl;
+}
+
+void parallelDouglasPeucker(size_t point_nr, size_t threads)
+{
+    std::cout<<"\nDouglas-Peucker simplification of "<<point_nr<<" points by "<<threads<<" threads:"<<std::endl;
+    auto pts = genSpikes(point_nr, 5, 4, 8);
+    std::mt19937 gen(11);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    for (auto &p : pts)
+        p += rtl::Vector2f(noise(gen), noise(gen));
+
+    rtl::VectorizerDouglasPeuckerND<2, float> dp_seq(0.03f);
+    rtl::VectorizerDouglasPeuckerND<2, float, rtl::ThreadExecutor> dp_par(0.03f, rtl::ThreadExecutor(threads));
+    dp_par.setParallelCutoff(256);
+    std::vector<rtl::LineSegment2f> out_seq, out_par;
+    dp_seq(pts, out_seq);
+    dp_par(pts, out_par);
+
+    bool same = out_seq.size() == out_par.size();
+    for (size_t i = 0; same && i < out_seq.size(); i++)
+        same = out_seq[i].beg() == out_par[i].beg() && out_seq[i].end() == out_par[i].end();
+    std::cout<<"\tSequential segments: "<<out_seq.size()<<", parallel segments: "<<out_par.size()<<(same ? " (identical)" : " (DIFFERENT)")<<std::endl;
+}
+
+void quadtreePlanes(size_t rows, size_t cols)
+{
+    std::cout<<"\nQuadtree plane extraction from "<<rows<<"x"<<cols<<" depth image of a room corner:"<<std::endl;
+    // Camera in origin looking along x axis, floor z = -1, front wall x = 4, side wall y = 1.
+    std::mt19937 gen(5);
+    std::normal_distribution<float> noise(0.0f, 0.003f);
+    std::uniform_real_distribution<float> hole(0.0f, 1.0f);
+    std::vector<rtl::Vector3f> pts;
+    pts.reserve(rows * cols);
+    for (size_t r = 0; r < rows; r++)
+        for (size_t c = 0; c < cols; c++)
+        {
+            rtl::Vector3f ray(1.0f, ((float)c - cols / 2.0f) / cols, (rows / 2.0f - (float)r) / cols);
+            float t = 4.0f / ray.x();
+            if (ray.z() < 0.0f)
+                t = std::min(t, -1.0f / ray.z());
+            if (ray.y() > 0.0f)
+                t = std::min(t, 1.0f / ray.y());
+            if (hole(gen) < 0.05f)
+                pts.emplace_back(NAN, NAN, NAN);
+            else
+                pts.push_back(ray * (t + noise(gen)));
+        }
+
+    rtl::VectorizerQuadtreePlanes3D<float, double> vec;
+    vec.setSigma(0.01f);
+    vec.setMinPoints(rows * cols / 50);
+    vec.setStatsEnabled(true);
+    vec(pts, rows, cols);
+    for (size_t i = 0; i < vec.approximations().size(); i++)
+    {
+        const auto &pl = vec.approximations()[i];
+        std::cout<<"\tnormal: "<<pl.normal().x()<<", "<<pl.normal().y()<<", "<<pl.normal().z()<<"\td: "<<pl.d()<<"\tpoints: "
+                 <<std::count(vec.labels().begin(), vec.labels().end(), i)<<"\toutline: "<<vec.polygons()[i].points().size()<<std::endl;
+    }
+    std::cout<<"\tPlanes: "<<vec.approximations().size()<<(vec.approximations().size() == 3 ? " (OK)" : " (FAILED)")<<std::endl;
+    std::cout<<"\tStats: "<<vec.stats().fits<<" fits, "<<vec.stats().merges<<" merges"<<std::endl;
+}
+
+void streamingVectorization(size_t point_nr, size_t chunk_size)
+{
+    std::cout<<"\nStreaming FTLS vectorization in chunks of "<<chunk_size<<" points:"<<std::endl;
+    auto pts = genSpikes(point_nr, 5, 4, 8);
+
+    rtl::VectorizerFTLSPolyline2D<float, double> vec_whole, vec_stream;
+    vec_whole.setSigma(0.03f);
+    vec_whole.setDelta(3.0f);
+    vec_stream.setSigma(0.03f);
+    vec_stream.setDelta(3.0f);
+
+    vec_whole(pts);
+    for (size_t i = 0; i < pts.size(); i += chunk_size)
+        vec_stream.append(std::vector<rtl::Vector2f>(pts.begin() + i, pts.begin() + std::min(i + chunk_size, pts.size())));
+
+    std::cout<<"\tWhole cloud segments: "<<vec_whole.lineSegments().size()<<std::endl;
+    std::cout<<"\tStreamed cloud segments: "<<vec_stream.lineSegments().size()<<std::endl;
+    std::cout<<"\tStreamed points: "<<vec_stream.points().size()<<" of "<<pts.size()<<std::endl;
+}
+
+void parallelContinuity(size_t point_nr, size_t threads)
+{
+    std::cout<<"\nRed-black continuity optimization with "<<threads<<" threads:"<<std::endl;
+    auto pts = genSpikes(point_nr, 40, 4, 8);
+    rtl::PrecArray2D<float, double> array;
+    array.precompute(pts);
+    rtl::ExtractorChainFast<rtl::PrecArray2D<float, double>, rtl::ApproximationTlsLine2D<float, double>> extractor;
+    extractor.setSigma(0.03f);
+    std::vector<rtl::ApproximationTlsLine2D<float, double>> lines_seq, lines_par;
+    std::vector<std::pair<size_t, size_t>> ind_seq, ind_par;
+    extractor(array, lines_seq, ind_seq);
+    lines_par = lines_seq;
+    ind_par = ind_seq;
+
+    rtl::OptimizerContinuity2D<rtl::PrecArray2D<float, double>, rtl::ApproximationTlsLine2D<float, double>> seq;
+    rtl::OptimizerContinuity2D<rtl::PrecArray2D<float, double>, rtl::ApproximationTlsLine2D<float, double>, rtl::ThreadExecutor> par{rtl::ThreadExecutor(threads)};
+    const float delta = 1.0f;
+    seq.setDelta(delta);
+    par.setDelta(delta);
+    rtl::VectorizationStats stats_seq, stats_par;
+    bool success_seq = seq(pts, array, lines_seq, ind_seq, &stats_seq);
+    bool success_par = par(pts, array, lines_par, ind_par, &stats_par);
+
+    // all break points of the result have to be continuous and the ranges have to cover the cloud
+    size_t err_cnt = ind_par.front().first != 0 || ind_par.back().second != pts.size();
+    for (size_t i = 1; i < lines_par.size(); i++)
+    {
+        rtl::Vector2f crossing;
+        if (ind_par[i - 1].second != ind_par[i].first || !rtl::ApproximationTlsLine2D<float, double>::getCrossing(lines_par[i - 1], lines_par[i], crossing) ||
+            rtl::Vector2f::distanceSquared(crossing, (pts[ind_par[i - 1].second - 1] + pts[ind_par[i - 1].second]) / 2) > delta * delta)
+            err_cnt++;
+    }
+    std::cout<<"\tSequential success: "<<success_seq<<", splits: "<<stats_seq.splits<<", lines: "<<lines_seq.size()<<std::endl;
+    std::cout<<"\tRed-black success: "<<success_par<<", splits: "<<stats_par.splits<<", lines: "<<lines_par.size()<<", discontinuities: "<<err_cnt<<std::endl;
+
+    // already optimized head is not touched in the incremental mode
+    auto lines_inc = lines_seq;
+    auto ind_inc = ind_seq;
+    rtl::VectorizationStats stats_inc;
+    seq(pts, array, lines_inc, ind_inc, lines_inc.size(), &stats_inc);
+    std::cout<<"\tIncremental re-run splits: "<<(stats_inc.splits == 0 && ind_inc == ind_seq ? "OK" : "FAILED")<<std::endl;
+}
+
+void vectorizationStats(size_t point_nr)
+{
+    std::cout<<"\nPer-stage statistics of AFTLS vectorization of "<<point_nr<<" points:"<<std::endl;
+    auto pts = genSpikes(point_nr, 5, 4, 8);
+
+    rtl::VectorizerAFTLSPolyline2D<float, double> vec;
+    vec.setSigma(0.03f);
+    vec.setDelta(3.0f);
+    vec.setStatsEnabled(true);
+    vec(pts);
+    const auto &st = vec.stats();
+    std::cout<<"\tPoints: "<<st.points<<", fits: "<<st.fits<<", extracted: "<<st.extracted<<", optimizer iterations: "<<st.optimizer_iterations
+             <<", splits: "<<st.splits<<std::endl;
+    bool consistent = st.points == pts.size() && st.fits >= st.extracted && st.extracted + st.splits == vec.approximations().size();
+    std::cout<<"\tConsistency with the output: "<<(consistent ? "OK" : "FAILED")<<std::endl;
+
+    vec.setStatsEnabled(false);
+    vec(pts);
+    std::cout<<"\tReset when disabled: "<<(vec.stats().points == 0 && vec.stats().fits == 0 ? "OK" : "FAILED")<<std::endl;
+}
+
+void sharedVectorizerWorkspaces(size_t scan_nr, size_t point_nr, size_t threads)
+{
+    std::cout<<"\nShared AFTLS vectorizer with "<<threads<<" per-thread workspaces:"<<std::endl;
+    std::vector<std::vector<rtl::Vector2f>> scans;
+    for (size_t i = 0; i < scan_nr; i++)
+        scans.push_back(genSpikes(point_nr / (1 + i % 4), 3 + i % 5, 4, 8));
+
+    using Vectorizer = rtl::VectorizerAFTLSPolyline2D<float, double>;
+    Vectorizer vec;
+    vec.setSigma(0.03f);
+    vec.setDelta(3.0f);
+    vec.setStatsEnabled(true);
+    const Vectorizer &shared = vec;
+
+    std::vector<Vectorizer::Workspace> workspaces(threads);
+    std::vector<std::vector<rtl::LineSegment2f>> results(scan_nr);
+    std::vector<size_t> fits(scan_nr);
+    rtl::ThreadExecutor executor(threads);
+    executor(0, threads, [&](size_t t_begin, size_t t_end) {
+        for (size_t t = t_begin; t < t_end; t++)
+        {
+            auto &ws = workspaces[t];
+            for (size_t i = t; i < scan_nr; i += threads)
+            {
+                shared(scans[i], ws);
+                results[i] = ws.lineSegments();
+                fits[i] = ws.stats().fits;
+            }
+        }
+    });
+
+    size_t err_cnt = 0;
+    for (size_t i = 0; i < scan_nr; i++)
+    {
+        vec(scans[i]);
+        if (vec.lineSegments().size() != results[i].size() || vec.stats().fits != fits[i])
+        {
+            err_cnt++;
+            continue;
+        }
+        for (size_t j = 0; j < results[i].size(); j++)
+            if (rtl::Vector2f::distance(vec.lineSegments()[j].beg(), results[i][j].beg()) > 1e-5f)
+                err_cnt++;
+    }
+    std::cout<<"\tResults equal to the internal workspace: "<<(err_cnt == 0 ? "OK" : "FAILED")<<std::endl;
+
+    // streams of a single vectorizer kept apart in their workspaces
+    rtl::VectorizerFTLSPolyline2D<float, double> stream_vec, reference;
+    stream_vec.setSigma(0.03f);
+    stream_vec.setDelta(3.0f);
+    reference = stream_vec;
+    decltype(stream_vec)::Workspace ws1, ws2;
+    const auto &stream = scans[0];
+    for (size_t k = 0; k < stream.size(); k += 64)
+    {
+        rtl::Span<const rtl::Vector2f> chunk(stream.data() + k, std::min<size_t>(64, stream.size() - k));
+        stream_vec.append(chunk, ws1);
+        stream_vec.append(chunk, ws2);
+        reference.append(chunk);
+    }
+    bool streams_ok = ws1.lineSegments().size() == reference.lineSegments().size() && ws2.indices() == reference.indices() && ws1.points().size() == stream.size();
+    std::cout<<"\tIndependent streams: "<<(streams_ok ? "OK" : "FAILED")<<std::endl;
+}
+
+void batchVectorization(size_t scan_nr, size_t point_nr)
+{
+    std::cout<<"\nBatch FTLS vectorization of "<<scan_nr<<" scans:"<<std::endl;
+    std::vector<std::vector<rtl::Vector2f>> scans;
+    for (size_t i = 0; i < scan_nr; i++)
+        scans.push_back(genSpikes(point_nr / (1 + i % 8), 5, 4, 8));
+
+    rtl::VectorizerFTLSPolyline2D<float, double> prototype;
+    prototype.setSigma(0.03f);
+    prototype.setDelta(3.0f);
+    rtl::VectorizerBatch<rtl::VectorizerFTLSPolyline2D<float, double>, rtl::ThreadExecutor> batch(prototype, rtl::ThreadExecutor(4));
+    batch.setMaxSize(point_nr);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    bool success = batch(scans);
+    auto duration_batch = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+
+    size_t err_cnt = 0;
+    auto vec_single = prototype;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < scans.size(); i++)
+    {
+        vec_single(scans[i]);
+        auto segments = vec_single.lineSegments();
+        if (segments.size() != batch.segmentOffset(i + 1) - batch.segmentOffset(i))
+        {
+            err_cnt++;
+            continue;
+        }
+        for (size_t j = 0; j < segments.size(); j++)
+            if (rtl::Vector2f::distance(segments[j].beg(), batch.segments()[batch.segmentOffset(i) + j].beg()) > 1e-5f ||
+                vec_single.indices()[j] != batch.indices()[batch.segmentOffset(i) + j])
+                err_cnt++;
+    }
+    auto duration_single = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+
+    std::cout<<"\tSuccess: "<<success<<", segments: "<<batch.segments().size()<<", mismatches: "<<err_cnt<<std::endl;
+    std::cout<<"\tBatch: "<<duration_batch.count()<<" us, single instance: "<<duration_single.count()<<" us"<<std::endl;
+
+    // the same scans as ranges of a single buffer
+    std::vector<rtl::Vector2f> buffer;
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (const auto &scan : scans)
+    {
+        ranges.emplace_back(buffer.size(), buffer.size() + scan.size());
+        buffer.insert(buffer.end(), scan.begin(), scan.end());
+    }
+    auto segments = batch.segments();
+    success = batch(buffer, ranges);
+    err_cnt = segments.size() != batch.segments().size();
+    for (size_t i = 0; i < segments.size() && i < batch.segments().size(); i++)
+        if (rtl::Vector2f::distance(segments[i].end(), batch.segments()[i].end()) > 1e-5f)
+            err_cnt++;
+    std::cout<<"\tSingle buffer success: "<<success<<", mismatches: "<<err_cnt<<std::endl;
+
+    // the same buffer delimited by offsets
+    std::vector<size_t> offsets{0};
+    for (const auto &r : ranges)
+        offsets.push_back(r.second);
+    success = batch(buffer, offsets);
+    err_cnt = segments.size() != batch.segments().size();
+    for (size_t i = 0; i < segments.size() && i < batch.segments().size(); i++)
+        if (rtl::Vector2f::distance(segments[i].end(), batch.segments()[i].end()) > 1e-5f)
+            err_cnt++;
+    std::cout<<"\tOffsets success: "<<success<<", mismatches: "<<err_cnt<<std::endl;
+}
+
+void ringVectorization(size_t ring_nr, size_t ring_width)
+{
+    std::cout<<"\nRing batch FTLS vectorization of "<<ring_nr<<" rings:"<<std::endl;
+    std::vector<rtl::Vector3f> scan;
+    for (size_t i = 0; i < ring_nr; i++)
+    {
+        auto ring = genCrown((int)ring_width, 2 + (int)(i % 4), 4.0f + 0.1f * (float)i, 1.0f + 0.2f * (float)i);
+        scan.insert(scan.end(), ring.begin(), ring.end());
+    }
+
+    rtl::VectorizerFTLSProjections3D<float, double> prototype;
+    prototype.setSigma(0.03f);
+    rtl::VectorizerBatch<rtl::VectorizerFTLSProjections3D<float, double>, rtl::ThreadExecutor> batch(prototype, rtl::ThreadExecutor(4));
+    batch.setMaxSize(ring_width);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    bool success = batch(scan, ring_nr);
+    auto duration_batch = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+
+    size_t err_cnt = batch.inputIndices().size() != batch.segments().size();
+    auto vec_single = prototype;
+    for (size_t i = 0; i < ring_nr; i++)
+    {
+        vec_single(rtl::Span<const rtl::Vector3f>(scan).subspan(i * ring_width, ring_width));
+        const auto &segments = vec_single.lineSegments();
+        if (segments.size() != batch.segmentOffset(i + 1) - batch.segmentOffset(i))
+        {
+            err_cnt++;
+            continue;
+        }
+        for (size_t j = 0; j < segments.size(); j++)
+            if (rtl::Vector3f::distance(segments[j].end(), batch.segments()[batch.segmentOffset(i) + j].end()) > 1e-5f ||
+                batch.inputIndices()[batch.segmentOffset(i) + j] != i)
+                err_cnt++;
+    }
+
+    std::cout<<"\tSuccess: "<<success<<", segments: "<<batch.segments().size()<<", mismatches: "<<err_cnt<<", time: "<<duration_batch.count()<<" us"<<std::endl;
+
+    bool thrown = false;
+    try
+    {
+        batch(rtl::Span<const rtl::Vector3f>(scan).subspan(1, scan.size() - 1), ring_nr);
+    }
+    catch (std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    std::cout<<"\tIndivisible scan rejected: "<<(thrown ? "OK" : "FAILED")<<std::endl;
+}
+
 int main()
 {
     /*genHemicycle(pts, 200, 8);
@@ -806,6 +1388,23 @@ int main()
 
     tlsPrecomputedArray<float, double >();
     tlsLine2D<float, double>(repeat, 100, errf);
+    tls3DEigenSolver<float, double, rtl::EigenSolverDirect3D>(100, 100, errf);
+    tls3DEigenSolver<float, double, rtl::EigenSolverTrigonometric3D>(100, 100, errf);
+    tlsPrecomputedArrayAppend<float, double>(1000, 64, 1e-6);
+    streamingVectorization(1000, 64);
+    vectorizationStats(1000);
+    parallelContinuity(10000, 4);
+    incrementalExtraction(10000, 0.03f);
+    parallelDouglasPeucker(100000, 4);
+    quadtreePlanes(240, 320);
+    compensatedPrecomputation<float, float>(100000, 100.0f);
+    compensatedPrecomputation<float, double>(100000, 100.0f);
+    centeredBlocksPrecision(100000, 100.0f, 256);
+    batchVectorization(64, 1000);
+    sharedVectorizerWorkspaces(32, 2000, 4);
+    ringVectorization(32, 1024);
+    extractorErrorBounds(10000, 0.05f);
+    tlsLine2DBatch(10000, 64, 0.01f);
 
     std::cout<<"\nClocks per second: " << CLOCKS_PER_SEC << std::endl;
     std::cout<<"\nHigh res clocks per second: " << std::chrono::high_resolution_clock::period::den/std::chrono::high_resolution_clock::period::num<<std::endl;
@@ -0,0 +1,145 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <random>
+#include <rtl/Core.h>
+#include <rtl/Transformation.h>
+
+// Calibration constants folded at compile time: camera -> imu -> base_link.
+constexpr rtl::StaticRigidTf3d camera_to_imu(0.01, -0.02, 1.5707963267948966, rtl::StaticVectorND<3, double>(0.05, 0.0, 0.02));
+constexpr rtl::StaticRigidTf3d imu_to_base(0.3, rtl::StaticVectorND<3, double>(0.0, 0.0, 1.0), rtl::StaticVectorND<3, double>(0.2, -0.1, 0.4));
+constexpr rtl::StaticTfChain camera_to_base(camera_to_imu, imu_to_base);
+constexpr auto camera_to_base_folded = camera_to_imu.transformed(imu_to_base);
+
+static_assert(camera_to_base.squash() == camera_to_base_folded);
+static_assert(rtl::StaticRigidTf2d(0.5, 1.0, 2.0).transformed(rtl::StaticRigidTf2d(0.5, 1.0, 2.0).inverted()).trVec().lengthSquared() < 1e-28);
+static_assert(rtl::StaticQuaternion<double>::fromAngleAxis(1.0, rtl::StaticVectorND<3, double>(0.0, 0.0, 2.0)).normSquared() - 1.0 < 1e-15);
+static_assert(rtl::StaticMatrix<2, 3, double>(1, 2, 3, 4, 5, 6) * rtl::StaticVectorND<3, double>(1, 0, -1) == rtl::StaticVectorND<2, double>(-2, -2));
+static_assert(rtl::StaticMatrix<2, 2, int>(1, 2, 3, 4).transposed() * rtl::StaticMatrix<2, 2, int>::identity() == rtl::StaticMatrix<2, 2, int>(1, 3, 2, 4));
+
+// A table of rotations built at compile time.
+template<size_t n>
+constexpr auto rotationTable()
+{
+    struct Table { rtl::StaticRigidTf2f tfs[n]; } table{};
+    for (size_t i = 0; i < n; i++)
+        table.tfs[i] = rtl::StaticRigidTf2f(2.0f * 3.14159265f * (float) i / (float) n, 0.0f, 0.0f);
+    return table;
+}
+constexpr auto rotation_table = rotationTable<64>();
+
+template<typename T, int rows, int cols>
+void expectMatrixNear(const rtl::StaticMatrix<rows, cols, T> &sm, const typename rtl::Matrix<rows, cols, T>::EigenType &em, T tolerance)
+{
+    for (int r = 0; r < rows; r++)
+        for (int c = 0; c < cols; c++)
+            EXPECT_NEAR(sm(r, c), em(r, c), tolerance);
+}
+
+TEST(t_static_rigid_tf, constexpr_trigonometry)
+{
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> angle(-100.0, 100.0), val(-1e3, 1e3);
+    for (size_t i = 0; i < 10000; i++)
+    {
+        double a = angle(gen), s = 0, c = 0;
+        rtl::TrigConstexpr::sincos(a, s, c);
+        EXPECT_NEAR(s, std::sin(a), 1e-14);
+        EXPECT_NEAR(c, std::cos(a), 1e-14);
+        double y = val(gen), x = val(gen);
+        EXPECT_NEAR(rtl::TrigConstexpr::atan2(y, x), std::atan2(y, x), 1e-15);
+        EXPECT_DOUBLE_EQ(rtl::TrigConstexpr::sqrt(std::abs(y)), std::sqrt(std::abs(y)));
+    }
+    EXPECT_EQ(rtl::TrigConstexpr::atan2(0.0, 0.0), 0.0);
+    EXPECT_EQ(rtl::TrigConstexpr::sqrt(0.0), 0.0);
+    EXPECT_TRUE(std::isnan(rtl::TrigConstexpr::sqrt(-1.0)));
+}
+
+TEST(t_static_rigid_tf, quaternion_conventions)
+{
+    constexpr auto q = rtl::StaticQuaternion<double>::fromRPY(0.3, -0.7, 2.1);
+    rtl::Quaternion<double> rq(0.3, -0.7, 2.1);
+    EXPECT_NEAR(q.w(), rq.w(), 1e-14);
+    EXPECT_NEAR(q.x(), rq.x(), 1e-14);
+    EXPECT_NEAR(q.y(), rq.y(), 1e-14);
+    EXPECT_NEAR(q.z(), rq.z(), 1e-14);
+    expectMatrixNear(q.rotMat(), rq.rotMat().data(), 1e-14);
+
+    constexpr auto q_back = rtl::StaticQuaternion<double>::fromRotMat(q.rotMat());
+    EXPECT_NEAR(std::abs(q_back.w() * q.w() + q_back.x() * q.x() + q_back.y() * q.y() + q_back.z() * q.z()), 1.0, 1e-14);
+
+    constexpr rtl::StaticVectorND<3, double> v(1.0, -2.0, 0.5);
+    auto rv = (rq.rotMat().data() * v.toVectorND().data()).eval();
+    for (int i = 0; i < 3; i++)
+        EXPECT_NEAR(q(v)[i], rv(i), 1e-14);
+}
+
+TEST(t_static_rigid_tf, runtime_equivalence)
+{
+    rtl::RigidTf3d r_camera_to_imu(rtl::Quaternion<double>(0.01, -0.02, 1.5707963267948966), rtl::Vector3d(0.05, 0.0, 0.02));
+    rtl::RigidTf3d r_imu_to_base(0.3, rtl::Vector3d(0.0, 0.0, 1.0), rtl::Vector3d(0.2, -0.1, 0.4));
+    rtl::RigidTf3d r_camera_to_base = r_camera_to_imu.transformed(r_imu_to_base);
+    rtl::RigidTf3d converted = camera_to_base.squash().toRigidTf();
+
+    expectMatrixNear(camera_to_base_folded.rotMat(), r_camera_to_base.rotMat().data(), 1e-14);
+    expectMatrixNear(camera_to_base_folded.rotMat(), converted.rotMat().data(), 1e-14);
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_NEAR(camera_to_base_folded.trVec()[i], r_camera_to_base.trVec()[i], 1e-14);
+        EXPECT_NEAR(converted.trVec()[i], r_camera_to_base.trVec()[i], 1e-14);
+    }
+
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<double> val(-10.0, 10.0);
+    for (size_t i = 0; i < 100; i++)
+    {
+        rtl::Vector3d p(val(gen), val(gen), val(gen));
+        auto expected = r_camera_to_base(p), by_chain = camera_to_base(p), inverse = camera_to_base_folded.inverted()(by_chain);
+        for (int k = 0; k < 3; k++)
+        {
+            EXPECT_NEAR(by_chain[k], expected[k], 1e-12);
+            EXPECT_NEAR(inverse[k], p[k], 1e-12);
+        }
+    }
+
+    rtl::RigidTf2f r2(0.7f, 1.0f, -2.0f);
+    rtl::RigidTf2f c2 = rtl::StaticRigidTf2f(0.7f, 1.0f, -2.0f).toRigidTf();
+    EXPECT_NEAR(c2.rotAngle(), r2.rotAngle(), 1e-6f);
+    EXPECT_NEAR(c2.trVecX(), r2.trVecX(), 1e-6f);
+    EXPECT_NEAR(c2.trVecY(), r2.trVecY(), 1e-6f);
+    EXPECT_NEAR(rtl::StaticRigidTf2f(0.7f, 1.0f, -2.0f).rotAngle(), 0.7f, 1e-6f);
+}
+
+TEST(t_static_rigid_tf, compile_time_table)
+{
+    for (size_t i = 0; i < 64; i++)
+    {
+        rtl::RigidTf2f reference(2.0f * 3.14159265f * (float) i / 64.0f, 0.0f, 0.0f);
+        EXPECT_NEAR(rotation_table.tfs[i].rotMat()(0, 0), reference.rotCos(), 1e-6f);
+        EXPECT_NEAR(rotation_table.tfs[i].rotMat()(1, 0), reference.rotSin(), 1e-6f);
+    }
+}
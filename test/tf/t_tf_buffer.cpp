@@ -0,0 +1,126 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <rtl/Transformation.h>
+#include <rtl/Test.h>
+
+#include <string>
+#include <vector>
+
+#include "tf_test/tf_comparison.h"
+
+
+TEST(t_tf_buffer, ring_and_order) {
+    rtl::TfBuffer<rtl::Translation2d> buffer;
+    ASSERT_EQ(buffer.insert(0.0, rtl::Translation2d(0, 0)), false);
+
+    buffer.setCapacity(4);
+    for (size_t i = 0; i < 6; i++)
+        ASSERT_EQ(buffer.insert((double)i, rtl::Translation2d((double)i, 0)), true);
+    ASSERT_EQ(buffer.size(), 4);
+    ASSERT_EQ(buffer.oldestTime(), 2.0);
+    ASSERT_EQ(buffer.newestTime(), 5.0);
+
+    // out-of-order insertion, replacement of an existing time stamp and rejection of too old entries
+    ASSERT_EQ(buffer.insert(3.5, rtl::Translation2d(3.5, 1)), true);
+    ASSERT_EQ(buffer.oldestTime(), 3.0);
+    ASSERT_EQ(buffer.insert(4.0, rtl::Translation2d(4, 1)), true);
+    ASSERT_EQ(buffer.insert(1.0, rtl::Translation2d(1, 0)), false);
+    ASSERT_EQ(buffer.size(), 4);
+    std::vector<double> times{3.0, 3.5, 4.0, 5.0};
+    for (size_t i = 0; i < buffer.size(); i++)
+        ASSERT_EQ(buffer[i].first, times[i]);
+    ASSERT_EQ(buffer[2].second.trVec(), rtl::Vector2d(4, 1));
+
+    buffer.setCapacity(2);
+    ASSERT_EQ(buffer.size(), 2);
+    ASSERT_EQ(buffer.oldestTime(), 4.0);
+
+    buffer.clear();
+    ASSERT_EQ(buffer.empty(), true);
+    ASSERT_THROW((void)buffer.newestTime(), std::out_of_range);
+}
+
+
+TEST(t_tf_buffer, interpolation) {
+    rtl::TfBuffer<rtl::Translation3d> tr_buffer(10);
+    tr_buffer.insert(1.0, rtl::Translation3d(0, 0, 0));
+    tr_buffer.insert(3.0, rtl::Translation3d(2, 4, -2));
+    ASSERT_EQ(tr_buffer.at(2.0).trVec(), rtl::Vector3d(1, 2, -1));
+    ASSERT_EQ(tr_buffer.at(3.0).trVec(), rtl::Vector3d(2, 4, -2));
+    ASSERT_EQ(tr_buffer.covers(0.5), false);
+    ASSERT_THROW(tr_buffer.at(3.5), std::out_of_range);
+
+    rtl::TfBuffer<rtl::Rotation2d> rot2_buffer(10);
+    rot2_buffer.insert(0.0, rtl::Rotation2d(3.0));
+    rot2_buffer.insert(1.0, rtl::Rotation2d(-3.0));     // shorter arc goes through pi
+    ASSERT_NEAR(std::abs(rot2_buffer.at(0.5).rotAngle()), rtl::C_PId, rtl::test::type<double>::allowedError());
+
+    rtl::TfBuffer<rtl::RigidTf3d> rigid_buffer(10);
+    auto axis = rtl::Vector3d(1, 1, 0);
+    rigid_buffer.insert(0.0, rtl::RigidTf3d(rtl::Rotation3d(0.2, axis), rtl::Translation3d(1, 0, 0)));
+    rigid_buffer.insert(2.0, rtl::RigidTf3d(rtl::Rotation3d(1.0, axis), rtl::Translation3d(3, 0, 0)));
+    auto mid = rigid_buffer.at(0.5);
+    ASSERT_EQ(CompareTfsEqual(mid, rtl::RigidTf3d(rtl::Rotation3d(0.4, axis), rtl::Translation3d(1.5, 0, 0))), true);
+}
+
+
+TEST(t_tf_buffer, tree_time_queries) {
+    rtl::TfTree<std::string, rtl::RigidTf2d> tree("map");
+    tree.insert("odom", rtl::RigidTf2d(0.0, 1.0, 0.0), "map");
+    tree.insert("base", rtl::RigidTf2d::identity(), "odom");
+    tree.insert("lidar", rtl::RigidTf2d(0.0, 0.5, 0.0), "base");
+    tree.at("base").tfBuffer().setCapacity(100);
+
+    for (size_t i = 0; i <= 10; i++)
+        ASSERT_EQ(tree.update("base", 0.1 * (double)i, rtl::RigidTf2d(0.1 * (double)i, (double)i, 0.0)), true);
+    ASSERT_EQ(tree.update("missing", 0.0, rtl::RigidTf2d::identity()), false);
+    ASSERT_EQ(CompareTfsEqual(tree.at("base").tf(), rtl::RigidTf2d(1.0, 10.0, 0.0)), true);
+
+    // the current transformation is used for edges without history
+    auto expected = rtl::RigidTf2d(0.0, 0.5, 0.0).inverted().transformed(rtl::RigidTf2d(0.25, 2.5, 0.0).inverted()).transformed(rtl::RigidTf2d(0.0, 1.0, 0.0).inverted());
+    ASSERT_EQ(CompareTfsEqual(tree.tf("lidar", "map", 0.25).squash(), expected), true);
+
+    std::vector<double> times{0.0, 0.25, 0.55, 1.0};
+    auto batch = tree.tfSquashed("map", "lidar", times);
+    ASSERT_EQ(batch.size(), times.size());
+    for (size_t i = 0; i < times.size(); i++)
+        ASSERT_EQ(CompareTfsEqual(batch[i], tree.tf("map", "lidar", times[i]).squash()), true);
+    ASSERT_THROW(tree.tf("map", "lidar", 1.5), std::out_of_range);
+
+    auto copy = tree;
+    ASSERT_EQ(copy.at("base").tfBuffer().size(), 11);
+    ASSERT_EQ(CompareTfsEqual(copy.tf("map", "lidar", 0.55).squash(), batch[2]), true);
+}
+
+
+int main(int argc, char **argv){
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
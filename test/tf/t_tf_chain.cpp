@@ -117,6 +117,135 @@ TEST(t_tf_tree, list_and_tfs) {
 }
 
 
+template<int N, typename dtype, typename T>
+struct TestCollapse {
+    static void testFunction() {
+
+        auto generator = rtl::test::Random::uniformCallable<double>(-1.0, 1.0);
+
+        auto tf1 = rtl::RigidTfND<N, dtype>::random(generator);
+        auto tf2 = rtl::RigidTfND<N, dtype>::random(generator);
+        auto tf3 = rtl::RigidTfND<N, dtype>::random(generator);
+        auto identity = rtl::RigidTfND<N, dtype>::identity();
+
+        auto chain = rtl::TfChain<rtl::RigidTfND<N, dtype>>{std::list<rtl::RigidTfND<N, dtype>>{tf1, tf2, tf3}};
+        auto collapsed = chain.collapse();
+        ASSERT_EQ(chain.size(), 3);
+        ASSERT_EQ(collapsed.size(), 1);
+        ASSERT_EQ(CompareTfsEqual(collapsed(identity), chain(identity)), true);
+        ASSERT_EQ(chain.collapse().collapse().size(), 1);
+        ASSERT_EQ((rtl::TfChain<rtl::RigidTfND<N, dtype>>{}.collapse().empty()), true);
+
+        using GenTf = rtl::GeneralTf<rtl::RigidTfND<N, dtype>, rtl::TranslationND<N, dtype>, rtl::RotationND<N, dtype>>;
+        auto tr1 = rtl::TranslationND<N, dtype>::random(generator);
+        auto tr2 = rtl::TranslationND<N, dtype>::random(generator);
+        auto rot = rtl::RotationND<N, dtype>::random(generator);
+        auto gen_chain = rtl::TfChain<GenTf>{std::list<GenTf>{tr1, tr2, rot, rot}};
+        auto gen_collapsed = gen_chain.collapse();
+        ASSERT_EQ(gen_chain.size(), 4);
+        ASSERT_EQ(gen_collapsed.size(), 1);
+
+        auto vec = rtl::VectorND<N, dtype>::random(generator);
+        auto v_chain = (rtl::VectorND<N, dtype>)gen_chain(vec);
+        auto v_collapsed = (rtl::VectorND<N, dtype>)gen_collapsed(vec);
+        ASSERT_LT((rtl::VectorND<N, dtype>::distance(v_chain, v_collapsed)), (rtl::test::type<rtl::VectorND<N, dtype>>::allowedError()));
+    }
+};
+
+
+TEST(t_tf_tree, collapse) {
+    [[maybe_unused]]auto collapseTest = rtl::test::RangeTypesTypes<TestCollapse, RANGE_AND_DTYPES>::with<TYPES>{};
+}
+
+
+template<int N, typename dtype, typename T>
+struct TestStaticChain {
+    static void testFunction() {
+
+        auto generator = rtl::test::Random::uniformCallable<double>(-1.0, 1.0);
+
+        auto tr = rtl::TranslationND<N, dtype>::random(generator);
+        auto rot = rtl::RotationND<N, dtype>::random(generator);
+        auto tf = rtl::RigidTfND<N, dtype>::random(generator);
+
+        rtl::StaticTfChain chain(tr, rot, tf, tr);
+        static_assert(std::is_same_v<typename decltype(chain)::SquashedType, rtl::RigidTfND<N, dtype>>);
+        static_assert(decltype(chain)::size() == 4);
+
+        using GenTf = rtl::GeneralTf<rtl::RigidTfND<N, dtype>, rtl::TranslationND<N, dtype>, rtl::RotationND<N, dtype>>;
+        auto dynamic = rtl::TfChain<GenTf>{std::list<GenTf>{tr, rot, tf, tr}};
+        auto vec = rtl::VectorND<N, dtype>::random(generator);
+        auto v_dynamic = (rtl::VectorND<N, dtype>)dynamic(vec);
+        ASSERT_LT((rtl::VectorND<N, dtype>::distance(chain(vec), v_dynamic)), (rtl::test::type<rtl::VectorND<N, dtype>>::allowedError()));
+
+        auto rot2 = rtl::RotationND<N, dtype>::random(generator);
+        chain.template set<1>(rot2);
+        auto expected = tr.transformed(rot2).transformed(tf).transformed(tr);
+        ASSERT_EQ(CompareTfsEqual(chain.squash(), expected), true);
+        ASSERT_EQ(CompareRotsEqual(chain.template get<1>(), rot2), true);
+
+        rtl::StaticTfChain single(rot);
+        static_assert(std::is_same_v<typename decltype(single)::SquashedType, rtl::RotationND<N, dtype>>);
+    }
+};
+
+
+TEST(t_tf_tree, static_chain) {
+    [[maybe_unused]]auto staticTest = rtl::test::RangeTypesTypes<TestStaticChain, RANGE_AND_DTYPES>::with<TYPES>{};
+}
+
+
+template<int N, typename dtype, typename T>
+struct TestApplyTo {
+    static void testFunction() {
+
+        auto generator = rtl::test::Random::uniformCallable<double>(-1.0, 1.0);
+        auto tr = rtl::TranslationND<N, dtype>::random(generator);
+        auto rot = rtl::RotationND<N, dtype>::random(generator);
+        auto tf = rtl::RigidTfND<N, dtype>::random(generator);
+
+        using GenTf = rtl::GeneralTf<rtl::RigidTfND<N, dtype>, rtl::TranslationND<N, dtype>, rtl::RotationND<N, dtype>>;
+        auto chain = rtl::TfChain<GenTf>{std::list<GenTf>{tr, rot, tf, tr}};
+        auto regular = rtl::TfChain<rtl::RigidTfND<N, dtype>>{std::list<rtl::RigidTfND<N, dtype>>{tf, tf.inverted(), tf}};
+
+        std::vector<rtl::VectorND<N, dtype>> vecs, vecs_regular;
+        std::vector<rtl::LineSegmentND<N, dtype>> segs;
+        for (size_t i = 0; i < 2500; i++)   // spans several blocks processed by applyTo()
+        {
+            vecs.push_back(rtl::VectorND<N, dtype>::random(generator));
+            segs.push_back(rtl::LineSegmentND<N, dtype>::random(generator));
+        }
+        auto vecs_ref = vecs;
+        auto segs_ref = segs;
+        vecs_regular = vecs;
+
+        chain.applyTo(rtl::Span<rtl::VectorND<N, dtype>>(vecs));
+        chain.applyTo(rtl::Span<rtl::LineSegmentND<N, dtype>>(segs));
+        regular.applyTo(rtl::Span<rtl::VectorND<N, dtype>>(vecs_regular));
+        for (size_t i = 0; i < vecs.size(); i++)
+        {
+            auto v_ref = (rtl::VectorND<N, dtype>)chain(vecs_ref[i]);
+            ASSERT_LT((rtl::VectorND<N, dtype>::distance(vecs[i], v_ref)), (rtl::test::type<rtl::VectorND<N, dtype>>::allowedError()));
+            ASSERT_LT((rtl::VectorND<N, dtype>::distance(vecs_regular[i], regular(vecs_ref[i]))), (rtl::test::type<rtl::VectorND<N, dtype>>::allowedError()));
+            auto s_ref = (rtl::LineSegmentND<N, dtype>)chain(segs_ref[i]);
+            ASSERT_LT((rtl::VectorND<N, dtype>::distance(segs[i].beg(), s_ref.beg())), (rtl::test::type<rtl::VectorND<N, dtype>>::allowedError()));
+            ASSERT_LT((rtl::VectorND<N, dtype>::distance(segs[i].end(), s_ref.end())), (rtl::test::type<rtl::VectorND<N, dtype>>::allowedError()));
+        }
+
+        auto single = vecs_ref.front();
+        chain.applyTo(single);
+        ASSERT_LT((rtl::VectorND<N, dtype>::distance(single, vecs.front())), (rtl::test::type<rtl::VectorND<N, dtype>>::allowedError()));
+
+        ASSERT_THROW(rtl::TfChain<GenTf>{}.applyTo(single), std::out_of_range);
+    }
+};
+
+
+TEST(t_tf_tree, apply_to) {
+    [[maybe_unused]]auto applyTest = rtl::test::RangeTypesTypes<TestApplyTo, RANGE_AND_DTYPES>::with<TYPES>{};
+}
+
+
 int main(int argc, char **argv){
 
     testing::InitGoogleTest(&argc, argv);
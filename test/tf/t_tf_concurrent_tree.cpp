@@ -0,0 +1,134 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2021 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <rtl/Transformation.h>
+#include <rtl/Test.h>
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+
+#include "tf_test/tf_comparison.h"
+
+
+TEST(t_tf_concurrent_tree, deep_copy) {
+    auto generator = rtl::test::Random::uniformCallable<double>(-1.0, 1.0);
+    std::vector<rtl::RigidTf3d> tfs;
+    for (size_t i = 0; i < 4; i++)
+        tfs.push_back(rtl::RigidTf3d::random(generator));
+
+    auto original = std::make_unique<rtl::TfTree<std::string, rtl::RigidTf3d>>("root");
+    original->insert("a", tfs[0], "root");
+    original->insert("b", tfs[1], "a");
+    original->insert("c", tfs[2], "root");
+    original->insert("d", tfs[3], "c");
+    auto expected = original->tf("b", "d").squash();
+
+    rtl::TfTree<std::string, rtl::RigidTf3d> copy(*original), assigned("other");
+    assigned = *original;
+    original.reset();
+
+    ASSERT_EQ(copy.size(), 5);
+    ASSERT_EQ(assigned.size(), 5);
+    ASSERT_EQ(copy.at("b").parent(), &copy.at("a"));
+    ASSERT_EQ(assigned.at("d").parent(), &assigned.at("c"));
+    ASSERT_EQ(CompareTfsEqual(copy.tf("b", "d").squash(), expected), true);
+    ASSERT_EQ(CompareTfsEqual(assigned.tfSquashed("b", "d"), expected), true);
+}
+
+
+TEST(t_tf_concurrent_tree, single_thread_api) {
+    rtl::ConcurrentTfTree<std::string, rtl::Translation2d> tree("root");
+    ASSERT_EQ(tree.size(), 1);
+    ASSERT_EQ(tree.insert("a", rtl::Translation2d(1, 2), "root"), true);
+    ASSERT_EQ(tree.insert("b", rtl::Translation2d(3, 4), "a"), true);
+    ASSERT_EQ(tree.insert("c", rtl::Translation2d(1, 1), "missing"), false);
+    ASSERT_EQ(tree.contains("b"), true);
+
+    auto old_snapshot = tree.snapshot();
+    ASSERT_EQ(tree.setTf("a", rtl::Translation2d(-1, 0)), true);
+    ASSERT_EQ(tree.setTf("missing", rtl::Translation2d(-1, 0)), false);
+
+    ASSERT_EQ(old_snapshot->tfSquashed("root", "b").trVec(), rtl::Vector2d(4, 6));
+    ASSERT_EQ(tree.tfSquashed("root", "b").trVec(), rtl::Vector2d(2, 4));
+    ASSERT_EQ(tree.tf("b", "root").squash().trVec(), rtl::Vector2d(-2, -4));
+
+    ASSERT_EQ(tree.erase("a"), true);
+    ASSERT_EQ(tree.size(), 1);
+    ASSERT_EQ(old_snapshot->size(), 3);
+}
+
+
+TEST(t_tf_concurrent_tree, readers_and_writer) {
+    // The writer keeps the "root" -> "b" transformation at identity by moving "a" and compensating in "b" within a single update.
+    rtl::ConcurrentTfTree<std::string, rtl::Translation2d> tree("root");
+    tree.insert("a", rtl::Translation2d(0, 0), "root");
+    tree.insert("b", rtl::Translation2d(0, 0), "a");
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> inconsistent{0}, reads{0};
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < 4; r++)
+        readers.emplace_back([&]()
+                             {
+                                 while (!stop.load())
+                                 {
+                                     auto snap = tree.snapshot();
+                                     auto a = snap->tfSquashed("root", "a").trVec();
+                                     auto b = snap->tfSquashed("root", "b").trVec();
+                                     if (b != rtl::Vector2d::zeros() || snap->at("b").tf().trVec() != -a)
+                                         inconsistent++;
+                                     reads++;
+                                 }
+                             });
+
+    for (size_t i = 1; i <= 2000; i++)
+        tree.modify([i](auto &t)
+                    {
+                        t.at("a").tf() = rtl::Translation2d((double)i, 0);
+                        t.at("b").tf() = rtl::Translation2d(-(double)i, 0);
+                    });
+    // the writer may finish before any reader gets scheduled
+    while (reads.load() == 0)
+        std::this_thread::yield();
+    stop = true;
+    for (auto &t : readers)
+        t.join();
+
+    ASSERT_EQ(inconsistent.load(), 0);
+    ASSERT_GT(reads.load(), 0);
+    ASSERT_EQ(tree.tfSquashed("root", "a").trVec(), rtl::Vector2d(2000, 0));
+}
+
+
+int main(int argc, char **argv){
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,145 @@
+// This file is part of the Robotic Template Library (RTL), a C++
+// template library for usage in robotic research and applications
+// under the MIT licence:
+//
+// Copyright 2020 Brno University of Technology
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Contact person: Ales Jelinek <Ales.Jelinek@ceitec.vutbr.cz>
+
+#include <gtest/gtest.h>
+#include <rtl/Transformation.h>
+#include <rtl/Test.h>
+
+#include <vector>
+#include <set>
+#include <sstream>
+#include "tf_test/tf_comparison.h"
+#include "rtl/io/StdLib.h"
+
+using Tf = rtl::RigidTfND<3, double>;
+
+//! Builds the same random tree of \p n nodes with integer keys in both TfTree and FlatTfTree.
+static void buildTrees(rtl::TfTree<int, Tf> &tree, rtl::FlatTfTree<int, Tf> &flat, int n)
+{
+    auto gen = rtl::test::Random::uniformCallable<double>(-1.0, 1.0);
+    for (int key = 1; key < n; key++)
+    {
+        int parent = rtl::test::Random::uniformValue(0, key - 1);
+        auto tf = Tf::random(gen);
+        ASSERT_TRUE(tree.insert(key, tf, parent));
+        ASSERT_TRUE(flat.insert(key, tf, parent));
+    }
+}
+
+TEST(t_tf_flat_tree, structure)
+{
+    rtl::TfTree<int, Tf> tree(0);
+    rtl::FlatTfTree<int, Tf> flat(0);
+    buildTrees(tree, flat, 200);
+    ASSERT_EQ(flat.size(), tree.size());
+    ASSERT_FALSE(flat.insert(5, Tf::identity(), 0));
+    ASSERT_FALSE(flat.insert(1000, Tf::identity(), 999));
+
+    for (int key = 0; key < 200; key++)
+    {
+        auto h = flat.handle(key);
+        ASSERT_EQ(flat.key(h), key);
+        ASSERT_EQ(flat.depth(h), tree.at(key).depth());
+        std::set<int> children, flat_children;
+        for (auto c : tree.at(key).children())
+            children.insert(c->key());
+        for (auto c : flat.children(h))
+            flat_children.insert(flat.key(c));
+        ASSERT_EQ(children, flat_children);
+    }
+
+    auto tree_erase = tree;
+    auto flat_erase = flat;
+    ASSERT_FALSE(flat_erase.erase(0));
+    ASSERT_TRUE(flat_erase.erase(7));
+    ASSERT_FALSE(flat_erase.erase(7));
+    tree_erase.erase(7);
+    ASSERT_EQ(flat_erase.size(), tree_erase.size());
+    ASSERT_EQ(flat.size(), tree.size());
+    for (int key = 0; key < 200; key++)
+    {
+        ASSERT_EQ(flat_erase.contains(key), tree_erase.contains(key));
+        if (flat_erase.contains(key) && key != 0)
+        {
+            ASSERT_EQ(flat_erase.key(flat_erase.parent(flat_erase.handle(key))), tree_erase.at(key).parent()->key());
+        }
+    }
+
+    flat_erase.clear();
+    ASSERT_EQ(flat_erase.size(), 1);
+    ASSERT_TRUE(flat_erase.contains(0));
+    ASSERT_TRUE(flat_erase.children(flat_erase.root()).empty());
+
+    std::stringstream ss;
+    ss << flat;
+    ASSERT_EQ(std::count(std::istreambuf_iterator<char>(ss), std::istreambuf_iterator<char>(), '\n'), 200);
+}
+
+TEST(t_tf_flat_tree, transformations)
+{
+    rtl::TfTree<int, Tf> tree(0);
+    rtl::FlatTfTree<int, Tf> flat(0);
+    buildTrees(tree, flat, 200);
+
+    for (int i = 0; i < 100; i++)
+    {
+        int from = rtl::test::Random::uniformValue(0, 199), to = rtl::test::Random::uniformValue(0, 199);
+        ASSERT_EQ(flat.tf(from, to).size(), tree.tf(from, to).size());
+        ASSERT_TRUE((CompareTfsEqual<3, double>(flat.tf(from, to).squash(), tree.tf(from, to).squash())));
+        ASSERT_TRUE((CompareTfsEqual<3, double>(flat.tfSquashed(from, to), tree.tfSquashed(from, to))));
+    }
+
+    auto tf = Tf::random(rtl::test::Random::uniformCallable<double>(-1.0, 1.0));
+    flat.at(3) = tf;
+    tree.at(3).tf() = tf;
+    for (int key = 0; key < 200; key++)
+        ASSERT_TRUE((CompareTfsEqual<3, double>(flat.tfSquashed(0, key), tree.tfSquashed(0, key))));
+
+    flat.tfBuffer(5).setCapacity(4);
+    tree.at(5).tfBuffer().setCapacity(4);
+    for (int t = 0; t < 4; t++)
+    {
+        auto tf_t = Tf::random(rtl::test::Random::uniformCallable<double>(-1.0, 1.0));
+        ASSERT_TRUE(flat.update(5, t, tf_t));
+        ASSERT_TRUE(tree.update(5, t, tf_t));
+    }
+    ASSERT_FALSE(flat.update(1000, 0.0, tf));
+    std::vector<double> times{0.5, 1.0, 2.5};
+    auto flat_batch = flat.tfSquashed(0, 5, times);
+    auto tree_batch = tree.tfSquashed(0, 5, times);
+    for (size_t i = 0; i < times.size(); i++)
+    {
+        ASSERT_TRUE((CompareTfsEqual<3, double>(flat.tf(0, 5, times[i]).squash(), tree.tf(0, 5, times[i]).squash())));
+        ASSERT_TRUE((CompareTfsEqual<3, double>(flat_batch[i], tree_batch[i])));
+    }
+    ASSERT_TRUE((CompareTfsEqual<3, double>(flat.tfSquashed(0, 5), tree.tfSquashed(0, 5))));
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -349,6 +349,39 @@ TEST(general_tf, transform) {
 }
 
 
+template <typename ...Tfs>
+struct TestApplyTo
+{
+    static void testFunction()
+    {
+        auto generator = rtl::test::Random::uniformCallable<double>(-1.0, 1.0);
+
+        std::vector<rtl::Vector3d> vecs;
+        for (size_t i = 0 ; i < 100 ; i++)
+            vecs.push_back(rtl::Vector3d::random(generator));
+        auto vecs_ref = vecs;
+
+        rtl::GeneralTf<Tfs...> gtf(rtl::RigidTfND<3, double>::random(generator));
+        gtf.applyTo(rtl::Span<rtl::Vector3d>(vecs));
+        for (size_t i = 0 ; i < vecs.size() ; i++)
+            ASSERT_LT(rtl::Vector3d::distance(vecs[i], (rtl::Vector3d)gtf(vecs_ref[i])), rtl::test::type<rtl::Vector3d>::allowedError());
+
+        auto seg = rtl::LineSegment3d::random(generator);
+        auto seg_ref = (rtl::LineSegment3d)gtf(seg);
+        gtf.applyTo(seg);
+        ASSERT_LT(rtl::Vector3d::distance(seg.beg(), seg_ref.beg()), rtl::test::type<rtl::Vector3d>::allowedError());
+
+        gtf = rtl::Rotation2D<float>::random(generator);
+        ASSERT_THROW(gtf.applyTo(rtl::Span<rtl::Vector3d>(vecs)), std::bad_variant_access);
+    }
+};
+
+TEST(general_tf, apply_to) {
+
+    TestApplyTo<ALL_TYPES>::testFunction();
+}
+
+
 
 int main(int argc, char **argv){
 
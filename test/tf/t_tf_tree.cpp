@@ -29,6 +29,9 @@
 #include <rtl/Test.h>
 
 #include <vector>
+#include <tuple>
+#include <memory_resource>
+#include <random>
 #include <typeinfo>
 #include <iostream>
 #include <chrono>
@@ -407,6 +410,43 @@ TEST(t_tf_tree, tree_tf_from_to) {
 }
 
 
+template<int N, typename dtype, typename T>
+struct TestTfSquashed {
+    static void testFunction() {
+        auto keyGen = KeysGenerator<T>{keyN};
+        auto keys = keyGen.generateKyes();
+
+        auto generator = rtl::test::Random::uniformCallable<double>(-1.0, 1.0);
+        rtl::TfTree<T, rtl::RigidTfND<N, dtype>> tree(origin);
+
+        tree.insert(key_1, rtl::RigidTfND<N, dtype>::random(generator), origin);
+        tree.insert(key_2, rtl::RigidTfND<N, dtype>::random(generator), origin);
+        tree.insert(key_3, rtl::RigidTfND<N, dtype>::random(generator), key_1);
+        tree.insert(key_4, rtl::RigidTfND<N, dtype>::random(generator), key_3);
+        tree.insert(key_5, rtl::RigidTfND<N, dtype>::random(generator), key_2);
+
+        ASSERT_EQ(CompareTfsEqual(tree.root().rootTf(), rtl::RigidTfND<N, dtype>::identity()), true);
+        ASSERT_EQ(CompareTfsEqual(tree.at(key_4).rootTf(), tree.tf(origin, key_4).squash()), true);
+        ASSERT_EQ(CompareTfsEqual(tree.tfSquashed(key_4, key_5), tree.tf(key_4, key_5).squash()), true);
+        ASSERT_EQ(CompareTfsEqual(tree.tfSquashed(key_5, key_3), tree.tf(key_5, key_3).squash()), true);
+
+        // modification of an ancestor must invalidate cached transformations of the whole subtree
+        tree[key_1].tf() = rtl::RigidTfND<N, dtype>::random(generator);
+        ASSERT_EQ(CompareTfsEqual(tree.at(key_4).rootTf(), tree.tf(origin, key_4).squash()), true);
+        ASSERT_EQ(CompareTfsEqual(tree.tfSquashed(key_4, key_5), tree.tf(key_4, key_5).squash()), true);
+
+        tree[key_5].tf() = rtl::RigidTfND<N, dtype>::random(generator);
+        tree[key_3].tf() = rtl::RigidTfND<N, dtype>::random(generator);
+        ASSERT_EQ(CompareTfsEqual(tree.tfSquashed(key_4, key_5), tree.tf(key_4, key_5).squash()), true);
+        ASSERT_EQ(CompareTfsEqual(tree.tfSquashed(key_3, key_3), rtl::RigidTfND<N, dtype>::identity()), true);
+    }
+};
+
+TEST(t_tf_tree, tree_tf_squashed) {
+    [[maybe_unused]]auto tfSquashedTest = rtl::test::RangeTypesTypes<TestTfSquashed, RANGE_AND_DTYPES>::with<TYPES>{};
+}
+
+
 template<int N, typename dtype, typename T>
 struct APITest {
     static void testFunction() {
@@ -541,6 +581,187 @@ TEST(t_tf_tree, str_cmp_vs_stc_hash) {
 }
 
 
+TEST(t_tf_tree, pmr_allocator) {
+    using Tf = rtl::RigidTfND<3, double>;
+    std::array<std::byte, 1 << 16> arena;
+    std::pmr::monotonic_buffer_resource frame(arena.data(), arena.size(), std::pmr::null_memory_resource());
+
+    rtl::pmr::TfTree<int, Tf> tree(0, &frame);
+    EXPECT_EQ(tree.get_allocator().resource(), &frame);
+    auto generator = rtl::test::Random::uniformCallable<double>(-1.0, 1.0);
+    for (int i = 1; i < 50; i++)
+        ASSERT_TRUE(tree.insert(i, Tf::random(generator), (i - 1) / 2));
+    ASSERT_EQ(tree.size(), 50);
+    ASSERT_EQ(tree.at(7).parent()->key(), 3);
+    ASSERT_EQ(tree.at(1).children().size(), 2);
+
+    rtl::pmr::TfTree<int, Tf> copy(tree);
+    EXPECT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+    ASSERT_EQ(copy.size(), tree.size());
+    EXPECT_TRUE((CompareTfsEqual<3, double>(copy.tfSquashed(49, 20), tree.tfSquashed(49, 20))));
+
+    rtl::pmr::TfTree<int, Tf> other(0, &frame);
+    other = std::move(tree);
+    ASSERT_EQ(other.size(), 50);
+    ASSERT_TRUE(tree.empty());
+    EXPECT_TRUE((CompareTfsEqual<3, double>(copy.tfSquashed(49, 20), other.tfSquashed(49, 20))));
+    EXPECT_EQ(other.at(1).children().size(), 2);
+
+    rtl::pmr::TfTree<int, Tf> foreign(0);
+    foreign = std::move(other);     // different resources, the nodes are copied
+    ASSERT_EQ(foreign.size(), 50);
+    ASSERT_EQ(other.size(), 50);
+    EXPECT_EQ(foreign.get_allocator().resource(), std::pmr::get_default_resource());
+    EXPECT_TRUE((CompareTfsEqual<3, double>(copy.tfSquashed(49, 20), foreign.tfSquashed(49, 20))));
+
+    tree = rtl::pmr::TfTree<int, Tf>(0, &frame);
+    tree.erase(0);
+    tree.clear();
+    ASSERT_EQ(tree.size(), 1);
+}
+
+TEST(t_tf_tree, move_and_swap) {
+    using Tf = rtl::RigidTfND<3, double>;
+    auto generator = rtl::test::Random::uniformCallable<double>(-1.0, 1.0);
+    rtl::TfTree<int, Tf> front(0), back(100);
+    for (int i = 1; i < 64; i++)
+    {
+        ASSERT_TRUE(front.insert(i, Tf::random(generator), (i - 1) / 2));
+        ASSERT_TRUE(back.insert(100 + i, Tf::random(generator), 100 + (i - 1) / 2));
+    }
+    auto reference = front.tfSquashed(63, 40);
+    const auto *node = &front.at(31);
+    const auto *parent = node->parent();
+
+    // moving and swapping keeps the nodes in place
+    rtl::TfTree<int, Tf> moved(std::move(front));
+    ASSERT_TRUE(front.empty());
+    ASSERT_EQ(moved.size(), 64);
+    ASSERT_EQ(&moved.at(31), node);
+    ASSERT_EQ(moved.at(31).parent(), parent);
+    EXPECT_TRUE((CompareTfsEqual<3, double>(moved.tfSquashed(63, 40), reference)));
+
+    swap(moved, back);
+    ASSERT_EQ(&back.at(31), node);
+    ASSERT_EQ(back.root().key(), 0);
+    ASSERT_EQ(moved.root().key(), 100);
+    ASSERT_FALSE(moved.contains(31));
+    EXPECT_TRUE((CompareTfsEqual<3, double>(back.tfSquashed(63, 40), reference)));
+
+    // moved-from tree is usable after assignment
+    front = std::move(back);
+    ASSERT_TRUE(back.empty());
+    ASSERT_EQ(&front.at(31), node);
+    back = rtl::TfTree<int, Tf>(0);
+    ASSERT_EQ(back.size(), 1);
+    front.clear();
+    ASSERT_EQ(front.size(), 1);
+}
+
+TEST(t_tf_tree, common_ancestor) {
+    using Tf = rtl::RigidTfND<3, double>;
+    using Node = rtl::TfTree<int, Tf>::NodeType;
+    auto generator = rtl::test::Random::uniformCallable<double>(-1.0, 1.0);
+    std::mt19937 rng(42);
+    rtl::TfTree<int, Tf> tree(0);
+    for (int i = 1; i < 200; i++)      // a deep spine with random branches
+        tree.insert(i, Tf::random(generator), i - 1);
+    for (int i = 200; i < 600; i++)
+        tree.insert(i, Tf::random(generator), std::uniform_int_distribution<int>(0, i - 1)(rng));
+
+    auto naive = [](const Node *n1, const Node *n2) {
+        while (n1->depth() > n2->depth()) n1 = n1->parent();
+        while (n2->depth() > n1->depth()) n2 = n2->parent();
+        while (n1 != n2) { n1 = n1->parent(); n2 = n2->parent(); }
+        return n1;
+    };
+    std::uniform_int_distribution<int> key(0, 599);
+    for (size_t i = 0; i < 1000; i++)
+    {
+        const Node *n1 = &tree.at(key(rng)), *n2 = &tree.at(key(rng));
+        ASSERT_EQ(Node::commonAncestor(n1, n2), naive(n1, n2));
+    }
+    ASSERT_EQ(tree.at(199).ancestor(199), &tree.root());
+    ASSERT_EQ(tree.at(150).ancestor(37)->key(), 113);
+
+    Node other_root(0);
+    ASSERT_EQ(Node::commonAncestor(&tree.at(5), &other_root), nullptr);
+
+    std::vector<int> targets{0, 199, 150, 42, 599, 300, 199, 450};
+    auto chains = tree.tf(199, targets);
+    ASSERT_EQ(chains.size(), targets.size());
+    for (size_t i = 0; i < targets.size(); i++)
+    {
+        auto single = tree.tf(199, targets[i]);
+        ASSERT_EQ(chains[i].size(), single.size());
+        if (!single.empty())
+        {
+            EXPECT_TRUE((CompareTfsEqual<3, double>(chains[i].squash(), single.squash())));
+        }
+    }
+}
+
+TEST(t_tf_tree, batch_insert_update) {
+    using Tf = rtl::RigidTfND<3, double>;
+    auto generator = rtl::test::Random::uniformCallable<double>(-1.0, 1.0);
+    std::mt19937 rng(7);
+
+    std::vector<std::tuple<int, Tf, int>> entries;
+    for (int i = 1; i < 50; i++)        // a chain followed by random branches, parents always precede children
+        entries.emplace_back(i, Tf::random(generator), i - 1);
+    for (int i = 50; i < 300; i++)
+        entries.emplace_back(i, Tf::random(generator), std::uniform_int_distribution<int>(0, i - 1)(rng));
+    entries.emplace_back(400, Tf::identity(), 500);    // unknown parent
+    entries.emplace_back(10, Tf::identity(), 0);       // existing key
+
+    rtl::TfTree<int, Tf> batch(0), single(0);
+    ASSERT_EQ(batch.insert(entries), 299);
+    for (const auto &[key, tf, parent] : entries)
+        single.insert(key, tf, parent);
+    ASSERT_EQ(batch.size(), single.size());
+    for (int i = 1; i < 300; i++)
+    {
+        ASSERT_EQ(batch.at(i).parent()->key(), single.at(i).parent()->key());
+        ASSERT_EQ(batch.at(i).depth(), single.at(i).depth());
+        EXPECT_TRUE((CompareTfsEqual<3, double>(batch.at(i).tf(), single.at(i).tf())));
+    }
+
+    ASSERT_EQ(batch.handle(1000), nullptr);
+    std::vector<rtl::TfTree<int, Tf>::NodeType*> handles;
+    std::vector<Tf> tfs;
+    for (int k : {3, 120, 2, 299, 60, 1})      // overlapping subtrees in both orders
+    {
+        handles.push_back(batch.handle(k));
+        ASSERT_EQ(handles.back(), &batch.at(k));
+        tfs.push_back(Tf::random(generator));
+    }
+    for (int i = 0; i < 300; i++)       // fill the caches
+        [[maybe_unused]] auto &r = batch.at(i).rootTf();
+    batch.update(handles, tfs);
+    for (size_t i = 0; i < handles.size(); i++)
+        single.at(handles[i]->key()).tf() = tfs[i];
+    for (int i = 0; i < 300; i++)
+    {
+        EXPECT_TRUE((CompareTfsEqual<3, double>(batch.at(i).rootTf(), single.at(i).rootTf())));
+        if (i != 0)
+        {
+            EXPECT_TRUE((CompareTfsEqual<3, double>(batch.at(i).tfInverted(), single.at(i).tfInverted())));
+        }
+    }
+    EXPECT_TRUE((CompareTfsEqual<3, double>(batch.tfSquashed(299, 120), single.tfSquashed(299, 120))));
+
+    for (auto h : handles)
+        h->tfBuffer().setCapacity(4);
+    batch.update(handles, 2.0, tfs);
+    batch.update(handles, 1.0, std::vector<Tf>(handles.size(), Tf::identity()));     // older records do not change the current transformations
+    for (size_t i = 0; i < handles.size(); i++)
+    {
+        ASSERT_EQ(handles[i]->tfBuffer().size(), 2);
+        EXPECT_TRUE((CompareTfsEqual<3, double>(handles[i]->tf(), tfs[i])));
+    }
+    ASSERT_THROW(batch.update(handles, std::vector<Tf>(1)), std::invalid_argument);
+}
+
 int main(int argc, char **argv){
 
     testing::InitGoogleTest(&argc, argv);
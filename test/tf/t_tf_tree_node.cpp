@@ -176,6 +176,16 @@ struct TestTf {
 
         ASSERT_EQ(CompareTfsEqual(tf12, node2.tf()), true);
         ASSERT_EQ(CompareTfsEqual(tf23, node3.tf()), true);
+
+        ASSERT_EQ(CompareTfsEqual(tf23.inverted(), node3.tfInverted()), true);
+        ASSERT_EQ(&node3.tfInverted(), &node3.tfInverted());
+        ASSERT_EQ(CompareTfsEqual(node3.rootTf().inverted(), node3.rootTfInverted()), true);
+
+        auto tf23_new = rtl::RigidTfND<N, dtype>::random(generator);
+        node3.tf() = tf23_new;
+        ASSERT_EQ(CompareTfsEqual(tf23_new.inverted(), node3.tfInverted()), true);
+        node2.tf() = tf23;
+        ASSERT_EQ(CompareTfsEqual(tf23.transformed(tf23_new).inverted(), node3.rootTfInverted()), true);
     }
 };
 